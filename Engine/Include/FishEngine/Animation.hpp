@@ -15,6 +15,11 @@ namespace FishEngine
 		virtual void Start() override;
 		virtual void Update() override;
 
+		virtual UpdatePhase updatePhase() const override { return UpdatePhase::Animation; }
+
+		// only writes the local transforms of its own skeleton
+		virtual bool isUpdateThreadSafe() const override { return true; }
+
 		// the default animation
 		//Meta(NonSerializable)
 		AnimationClipPtr m_clip;
@@ -31,5 +36,15 @@ namespace FishEngine
 
 		Meta(NonSerializable)
 		std::map<std::string, TransformPtr> m_skeleton;
+
+		// bone of each curve of m_clip, resolved in Start (null if not found).
+		Meta(NonSerializable)
+		std::vector<TransformPtr> m_positionBones;
+
+		Meta(NonSerializable)
+		std::vector<TransformPtr> m_rotationBones;
+
+		Meta(NonSerializable)
+		std::vector<TransformPtr> m_scaleBones;
 	};
 }
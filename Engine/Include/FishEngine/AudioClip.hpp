@@ -25,6 +25,12 @@ namespace FishEngine
 
 		void Cleanup();
 
+		// A clip of lengthSamples silent samples per channel, filled by SetData (AudioClip.Create, not streamed).
+		static AudioClipPtr Create(std::string const & name, int lengthSamples, int channels, int frequency);
+
+		// Writes interleaved samples into the clip, from offsetSamples (per channel). Returns false if they do not fit.
+		bool SetData(float const * data, int sampleCount, int offsetSamples);
+
 		// The length of the audio clip in seconds. (Read Only)
 		float length() const { return m_length; }
 
@@ -76,6 +82,7 @@ namespace FishEngine
 	private:
 		friend class FishEditor::AudioImporter;
 		friend class AudioSource;
+		friend class AudioSystem;
 
 		// The length of the audio clip in seconds.
 		float	m_length	= 0;
@@ -3,6 +3,7 @@
 #include "Behaviour.hpp"
 #include "AudioVelocityUpdateMode.hpp"
 #include "Mathf.hpp"
+#include "Vector3.hpp"
 
 namespace FishEngine
 {
@@ -11,15 +12,23 @@ namespace FishEngine
 	public:
 		DefineComponent(AudioListener);
 
+		AudioListener() = default;
+		~AudioListener();
+
 		// Controls the game sound volume (0.0 to 1.0).
 		float volume() const { return m_volume; }
 		void setVolume(float value) { m_volume = Mathf::Clamp01( value ); }
 
 		bool pause() const { return m_pause; }
+		void setPause(bool value) { m_pause = value; }
 
 		AudioVelocityUpdateMode velocityUpdateMode() const { return m_velocityUpdateMode; }
 
+		virtual void Start() override;
+
 	private:
+		friend class AudioSystem;
+
 		// Controls the game sound volume (0.0 to 1.0).
 		float m_volume = 1.0f;
 
@@ -27,6 +36,10 @@ namespace FishEngine
 		bool m_pause = false;
 
 		// This lets you set whether the Audio Listener should be updated in the fixed or dynamic update.
-		AudioVelocityUpdateMode m_velocityUpdateMode;
+		AudioVelocityUpdateMode m_velocityUpdateMode = AudioVelocityUpdateMode::Auto;
+
+		// world position last pushed to FMOD.
+		Meta(NonSerializable)
+		Vector3 m_lastPosition;
 	};
 }
\ No newline at end of file
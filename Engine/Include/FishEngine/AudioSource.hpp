@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Behaviour.hpp"
+#include "Vector3.hpp"
+
+namespace FMOD
+{
+	class Channel;
+}
 
 namespace FishEngine
 {
@@ -8,10 +14,33 @@ namespace FishEngine
 	{
 	public:
 		DefineComponent(AudioSource);
+
+		AudioSource() = default;
+		~AudioSource();
 		
+		// The volume of the audio source (0.0 to 1.0).
 		float volume() const { return m_volume; }
+		void setVolume(float value);
 
+		// The pitch of the audio source.
 		float pitch() const { return m_pitch; }
+		void setPitch(float value);
+
+		// Sets how much this AudioSource is affected by 3D spatialisation calculations (attenuation, doppler etc). 0.0 makes the sound full 2D, 1.0 makes it full 3D.
+		float spatialBlend() const { return m_spatialBlend; }
+		void setSpatialBlend(float value);
+
+		// Sets the priority of the AudioSource (0 = most important, 256 = least important).
+		int priority() const { return m_priority; }
+		void setPriority(int value);
+
+		// Within the Min distance the AudioSource will cease to grow louder in volume.
+		float minDistance() const { return m_minDistance; }
+		void setMinDistance(float value);
+
+		// (Logarithmic rolloff) MaxDistance is the distance a sound stops attenuating at.
+		float maxDistance() const { return m_maxDistance; }
+		void setMaxDistance(float value);
 
 		float time() const { return m_time; }
 
@@ -49,6 +78,10 @@ namespace FishEngine
 
 	private:
 		friend class FishEditor::Inspector;
+		friend class AudioSystem;
+
+		// apply volume, pitch, priority and 3d settings to the playing channel.
+		void ApplyChannelSettings();
 
 		// The volume of the audio source (0.0 to 1.0).
 		float m_volume = 1.0f;
@@ -72,7 +105,7 @@ namespace FishEngine
 		bool m_isPlaying = false;
 
 		// True if all sounds played by the AudioSource (main sound started by Play() or playOnAwake as well as one-shots) are culled by the audio system.
-		bool m_isVirtual;
+		bool m_isVirtual = false;
 
 		// Is the audio clip looping?
 		bool m_loop = false;
@@ -100,5 +133,19 @@ namespace FishEngine
 		float m_minDistance = 1.0f;
 		float m_maxDistance = 500.0f;
 		//AudioRolloffMode m_rolloffMode
+
+		Meta(NonSerializable)
+		FMOD::Channel * m_channel = nullptr;
+
+		// world position last pushed to FMOD.
+		Meta(NonSerializable)
+		Vector3 m_lastPosition;
+
+		// the source is too far away to be heard, and its 3D attributes are not updated.
+		Meta(NonSerializable)
+		bool m_culled = false;
+
+		Meta(NonSerializable)
+		bool m_registered = false;
 	};
 }
\ No newline at end of file
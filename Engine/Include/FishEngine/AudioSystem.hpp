@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ReflectClass.hpp"
+#include "Vector3.hpp"
 
 namespace FishEngine
 {
@@ -17,6 +18,40 @@ namespace FishEngine
 		static void Update();
 		static void Stop();
 
+		// Number of voices that are actually mixed. Quieter or lower priority voices become virtual.
+		// Must be set before Init().
+		static int maxRealVoices() { return s_maxRealVoices; }
+		static void setMaxRealVoices(int value) { s_maxRealVoices = value; }
+
+		// Total number of voices (real + virtual) that can be playing at the same time.
+		// Must be set before Init().
+		static int maxVirtualVoices() { return s_maxVirtualVoices; }
+		static void setMaxVirtualVoices(int value) { s_maxVirtualVoices = value; }
+
+		// Use FMOD's non-realtime no-sound output, e.g. for tests and headless runs.
+		// Must be set before Init().
+		static bool noSoundOutput() { return s_noSoundOutput; }
+		static void setNoSoundOutput(bool value) { s_noSoundOutput = value; }
+
+		// Sources whose estimated volume at the listener is below this value are culled:
+		// their 3D attributes are not updated and their voice goes virtual.
+		static float audibilityThreshold() { return s_audibilityThreshold; }
+		static void setAudibilityThreshold(float value) { s_audibilityThreshold = value; }
+
+		// Upper bound of the volume of a 3D sound at the listener (inverse tapered rolloff is silent beyond maxDistance).
+		static float EstimateAudibility(Vector3 const & sourcePosition,
+										Vector3 const & listenerPosition,
+										float volume,
+										float minDistance,
+										float maxDistance);
+
+		// Number of sources registered / culled in the last Update (for profiling).
+		static int sourceCount();
+		static int culledSourceCount() { return s_culledSourceCount; }
+
+		// Number of PlayClipAtPoint voices of the pool still playing (for profiling).
+		static int oneShotVoiceCount();
+
 	private:
 		AudioSystem();
 		~AudioSystem();
@@ -25,5 +60,24 @@ namespace FishEngine
 		AudioSystem(const AudioSystem &) = delete;
 		AudioSystem(AudioSystem &&) = delete;
 		AudioSystem & operator=(AudioSystem const &) = delete;
+
+		friend class AudioSource;
+		friend class AudioListener;
+
+		static void RegisterSource(AudioSource * source);
+		static void UnregisterSource(AudioSource * source);
+		static void RegisterListener(AudioListener * listener);
+		static void UnregisterListener(AudioListener * listener);
+
+		// play clip as a pooled one-shot 3D voice.
+		static void PlayOneShotAtPoint(AudioClipPtr const & clip, Vector3 const & position, float volume);
+
+		static Vector3 listenerPosition();
+
+		static int		s_maxRealVoices;
+		static int		s_maxVirtualVoices;
+		static bool		s_noSoundOutput;
+		static float	s_audibilityThreshold;
+		static int		s_culledSourceCount;
 	};
-}
\ No newline at end of file
+}
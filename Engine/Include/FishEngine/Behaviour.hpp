@@ -17,7 +17,7 @@ namespace FishEngine
 
 		// Enabled Behaviours are Updated, disabled Behaviours are not.
 		bool enabled() const { return m_enabled; }
-		void setEnabled(bool value) { m_enabled = value; }
+		void setEnabled(bool value) { m_enabled = value; SetDirty(); }
 
 		// Has the Behaviour had enabled called.
 		bool isActiveAndEnabled() const;
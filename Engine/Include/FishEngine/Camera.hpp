@@ -49,12 +49,14 @@ namespace FishEngine
 		{
 			m_orthographic = value;
 			m_isDirty = true;
+			SetDirty();
 		}
 
 		void setAspect(float aspect)
 		{
 			m_aspect = aspect;
 			m_isDirty = true;
+			SetDirty();
 			m_isAspectSet = true;
 		}
 
@@ -62,6 +64,7 @@ namespace FishEngine
 		{
 			m_fieldOfView = fieldOfView;
 			m_isDirty = true;
+			SetDirty();
 		}
 
 		float nearClipPlane() const
@@ -73,6 +76,7 @@ namespace FishEngine
 		{
 			m_nearClipPlane = nearClipPlane;
 			m_isDirty = true;
+			SetDirty();
 		}
 
 		float farClipPlane() const
@@ -84,6 +88,7 @@ namespace FishEngine
 		{
 			m_farClipPlane = farClipPlane;
 			m_isDirty = true;
+			SetDirty();
 		}
 		
 		Frustum frustum() const
@@ -110,6 +115,11 @@ namespace FishEngine
 		void virtual OnDrawGizmos() override;
 		void virtual OnDrawGizmosSelected() override;
 
+		virtual void OnValidate() override
+		{
+			m_isDirty = true;
+		}
+
 		// TODO
 		// The first enabled camera tagged "MainCamera" (Read Only).
 		static CameraPtr main();
@@ -24,11 +24,12 @@ namespace FishEngine
 		virtual void Start() override;
 
 		inline bool enabled() const { return m_enabled; }
-		void setEnabled(bool enabled) { m_enabled = enabled; }
+		void setEnabled(bool enabled) { m_enabled = enabled; SetDirty(); }
 		
 	protected:
 		friend class FishEditor::Inspector;
 		friend class Rigidbody;
+		friend class GameObject;
 		Meta(NonSerializable)
 		
 		// The rigidbody the collider is attached to.
@@ -50,6 +51,9 @@ namespace FishEngine
 		physx::PxShape* physicsShape() { return m_physxShape; }
 		virtual void CreatePhysicsShape() = 0;
 		
+		// write the layer of the GameObject and its collision mask into the shape's filter data.
+		void UpdateFilterData();
+		
 		Meta(NonSerializable)
 		physx::PxShape* m_physxShape = nullptr;
 		//physx::PxRigidDynamic* m_physxRigidDynamic;
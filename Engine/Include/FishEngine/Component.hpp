@@ -3,6 +3,7 @@
 
 #include "Object.hpp"
 #include "ReflectClass.hpp"
+#include "UpdatePhase.hpp"
 
 namespace FishEngine
 {
@@ -22,6 +23,9 @@ namespace FishEngine
 		virtual void OnDrawGizmos() {}
 		virtual void OnDrawGizmosSelected() {}
 
+		// Called by the editor after it wrote serialized fields directly (e.g. undo), so that cached state can be refreshed.
+		virtual void OnValidate() {}
+
 		// The game object this component is attached to. A component is always attached to a game object.
 		GameObjectPtr gameObject() const { return m_gameObject.lock(); }
 
@@ -58,6 +62,13 @@ namespace FishEngine
 		virtual void Update() {}
 		virtual void OnDestroy() {}
 
+		// The phase of Scene::Update in which Update is called.
+		virtual UpdatePhase updatePhase() const { return UpdatePhase::Update; }
+
+		// Components whose Update only touches their own GameObject's subtree can return true,
+		// they are then updated in parallel with the other components of the same type.
+		virtual bool isUpdateThreadSafe() const { return false; }
+
 		//static PComponent CreateComponent(const std::string& componentClassName);
 
 	protected:
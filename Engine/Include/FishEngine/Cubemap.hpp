@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Texture.hpp"
+#include "Render/SphericalHarmonicsL2.hpp"
 #include <array>
 
 namespace FishEngine
@@ -8,6 +9,7 @@ namespace FishEngine
 	class FE_EXPORT Cubemap : public Texture
 	{
 		friend FishEditor::DDSImporter;
+		friend class EnvironmentFilter;
 		
 	public:
 
@@ -44,6 +46,19 @@ namespace FishEngine
 		{
 			return m_mipmapCount;
 		}
+
+		// Are the mips prefiltered for the GGX specular (roughness = mip / (mipmapCount - 1))?
+		// See EnvironmentFilter.
+		bool isPrefiltered() const
+		{
+			return m_prefiltered;
+		}
+
+		// Diffuse lighting of a prefiltered cubemap.
+		SphericalHarmonicsL2 const & irradiance() const
+		{
+			return m_irradiance;
+		}
 		
 	protected:
 		virtual void UploadToGPU() override;
@@ -57,5 +72,11 @@ namespace FishEngine
 		// face->mipmap
 		Meta(NonSerializable)
 		std::array<std::vector<std::vector<std::uint8_t>>, 6> m_pixels;
+
+		Meta(NonSerializable)
+		bool m_prefiltered = false;
+
+		Meta(NonSerializable)
+		SphericalHarmonicsL2 m_irradiance;
 	};
 }
@@ -0,0 +1,114 @@
+#ifndef DepthOnlyRenderer_hpp
+#define DepthOnlyRenderer_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "GLEnvironment.hpp"
+#include "Matrix4x4.hpp"
+#include "Mesh.hpp"
+
+#include <map>
+#include <vector>
+
+namespace FishEngine
+{
+	class GeometryPool;
+
+	// Depth only drawing of the shadow casters (Scene::RenderShadow): the casters are gathered, then drawn grouped by
+	// mesh with one instanced draw call per mesh, from the positions of the GeometryPools and an MVP only program
+	// (ShadowDepth) that sets no per draw uniform. Casters with an alpha tested material (render queue AlphaTest and a
+	// _MainTex) read the uv too and discard the pixels below the cutoff (ShadowDepthCutout); they are grouped by
+	// material.
+	//
+	// The object to world matrices of the instances are in one buffer, uploaded once per Draw: instance attributes
+	// read from the offset of the group (no base instance in GL 4.1).
+	// The vertices stay interleaved in the pools: the VAOs of this pass read the position, the normal and (cutout) the
+	// uv only. The vertices of the pools with normals are offset along them by the normal bias of the light, as by
+	// CascadedShadowMap; the pools without have a slope scaled polygon offset instead.
+	class FE_EXPORT Meta(NonSerializable) DepthOnlyRenderer
+	{
+	public:
+		// _Cutoff of the alpha tested casters.
+		static constexpr float Cutoff = 0.5f;
+
+		// Draw calls and program binds, since the start. Divide the difference by the frames for per frame numbers.
+		struct Statistics
+		{
+			uint64_t	drawCalls = 0;
+			uint64_t	cutoutDrawCalls = 0;	// included in drawCalls
+			uint64_t	instances = 0;			// the meshes drawn, static batches included
+			uint64_t	programBinds = 0;
+			uint64_t	rejected = 0;			// not in a pool: drawn by the caller
+		};
+
+		DepthOnlyRenderer() = default;
+		~DepthOnlyRenderer();
+
+		DepthOnlyRenderer(const DepthOnlyRenderer&) = delete;
+		void operator=(const DepthOnlyRenderer&) = delete;
+
+		// An instance of mesh, uploaded if not yet. materials: of the renderer, one per submesh; the submeshes with
+		// an alpha tested material are alpha tested, the mesh is drawn whole if none is.
+		// The meshes and the materials must live until Draw.
+		// Returns false if mesh is not in a GeometryPool (skinned, empty): the caller draws it. A mesh in the
+		// UploadQueue is not drawn, as by Mesh::Render.
+		bool Add(MeshPtr const & mesh, Matrix4x4 const & localToWorld, std::vector<MaterialPtr> const & materials);
+
+		// The ranges of mesh, its vertices in world space (static batches). Not alpha tested.
+		// Returns false as the Add above; a mesh in the UploadQueue is not drawn.
+		bool Add(MeshPtr const & mesh, std::vector<IndexRange> const & ranges);
+
+		// Draws the casters added, then forgets them. The render target, the viewport and the light
+		// (Pipeline::BindLight) are set by the caller.
+		// slopeBias: the factor of glPolygonOffset, for the meshes without normals (no normal offset).
+		void Draw(float slopeBias);
+
+		// The material is alpha tested in the shadow maps.
+		static bool IsCutout(MaterialPtr const & material);
+
+		static Statistics const & statistics()
+		{
+			return s_statistics;
+		}
+
+	private:
+		struct Instance
+		{
+			Material*		cutout;		// nullptr: opaque
+			Mesh*			mesh;
+			int				subMesh;	// -1: the whole mesh
+			uint32_t		index;		// in m_matrices
+		};
+
+		struct Batch
+		{
+			MeshPtr						mesh;
+			std::vector<IndexRange>		ranges;
+		};
+
+		// The VAOs of a pool for this pass.
+		struct PoolArrays
+		{
+			GLuint		positionVAO = 0;
+			GLuint		uvVAO = 0;		// position and uv, if the layout has uv
+			GLuint		vertexBuffer = 0;
+		};
+
+		// The VAO of pool, with the instance attributes at instance (in m_instanceBuffer).
+		void BindVertexArray(GeometryPool* pool, bool uv, uint32_t instance);
+
+		void Upload();
+
+		std::vector<Instance> m_instances;
+		std::vector<Batch> m_batches;
+		std::vector<float> m_matrices;		// the 3 first rows, per instance, in the order of Add
+
+		GLuint m_instanceBuffer = 0;
+		GLsizeiptr m_instanceBufferSize = 0;
+		std::map<GeometryPool*, PoolArrays> m_arrays;
+
+		static Statistics s_statistics;
+	};
+}
+
+#endif // DepthOnlyRenderer_hpp
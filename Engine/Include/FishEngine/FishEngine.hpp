@@ -139,6 +139,9 @@ namespace FishEngine
 
 	class AudioListener;
 	typedef std::shared_ptr<AudioListener> AudioListenerPtr;
+
+	class Impostor;
+	typedef std::shared_ptr<Impostor> ImpostorPtr;
 }
 
 // hack: inject FishEditor namespace
@@ -149,6 +152,7 @@ namespace FishEditor
 	class MainEditor;
 	class SceneViewEditor;
 	class AssetDatabase;
+	class ScriptManager;
 }
 
 class UIGameObjectHeader;
@@ -0,0 +1,71 @@
+#ifndef FrameRecorder_hpp
+#define FrameRecorder_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+
+namespace FishEngine
+{
+	// Records, per frame, the input events and delta time consumed by Scene::Update and PhysicsSystem into a
+	// compact binary log, and plays them back deterministically. The frame also seeds Random, for the scripts
+	// that draw from it: the engine's own update and the physics use no random numbers.
+	// Each frame also stores a hash of all transforms, so a replay (or a second recording)
+	// can tell the first frame where two runs differ.
+	//
+	// Game loop usage:
+	//     Input::Update(); /* poll window events */
+	//     if (!FrameRecorder::BeginFrame(dt)) break;
+	//     Scene::Update(); PhysicsSystem::FixedUpdate();
+	//     FrameRecorder::EndFrame();
+	class FE_EXPORT Meta(NonSerializable) FrameRecorder
+	{
+	public:
+		FrameRecorder() = delete;
+
+		static bool StartRecording(std::string const & path);
+		static bool StartReplay(std::string const & path);
+
+		// Stops recording or replaying and closes the log.
+		static void Stop();
+
+		static bool isRecording() { return s_mode == Mode::Recording; }
+		static bool isReplaying() { return s_mode == Mode::Replaying; }
+
+		// Sets Time::deltaTime for the new frame.
+		// Recording: captures this frame's input events, delta time and a fresh random seed.
+		// Replaying: ignores deltaTime and restores them from the log instead.
+		// Returns false when the replay reached the end of the log.
+		static bool BeginFrame(float deltaTime);
+
+		// Hashes the transform state, writes the frame (recording) or compares it with the log (replaying).
+		static void EndFrame();
+
+		// Index of the current frame since recording/replay started.
+		static int frameIndex() { return s_frameIndex; }
+
+		// First frame of the replay whose transform hash differs from the recording, -1 if none so far.
+		static int firstDivergentFrame() { return s_firstDivergentFrame; }
+
+		// Hash of the local position, rotation and scale of every transform in the scene, in hierarchy order.
+		static uint64_t HashTransforms();
+
+		// Compares the per-frame transform hashes of two logs.
+		// Returns the first frame that differs, or -1 if they are identical.
+		// Frames missing in the shorter log count as different.
+		static int FindFirstDivergence(std::string const & path1, std::string const & path2);
+
+	private:
+		enum class Mode
+		{
+			None,
+			Recording,
+			Replaying,
+		};
+
+		static Mode		s_mode;
+		static int		s_frameIndex;
+		static int		s_firstDivergentFrame;
+	};
+}
+
+#endif // FrameRecorder_hpp
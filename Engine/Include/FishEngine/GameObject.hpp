@@ -50,9 +50,23 @@ namespace FishEngine
 			return m_activeSelf;
 		}
 
+		// Is the GameObject static (does not move)? Static GameObjects are combined by StaticBatchingUtility.
+		bool isStatic() const
+		{
+			return m_isStatic;
+		}
+
+		void setIsStatic(bool value)
+		{
+			m_isStatic = value;
+			SetDirty();
+		}
+
 		// The layer the game object is in. A layer is in the range [0...31].
 		int layer() const { return m_layer; }
-		void setLayer(int layer) { m_layer = layer; }
+		void setLayer(int layer);
+
+		virtual void setName(const std::string& name) override;
 
 		
 		// The tag of this game object.
@@ -101,13 +115,11 @@ namespace FishEngine
 		void RemoveComponent(ComponentPtr component)
 		{
 			m_components.remove(component);
+			SetDirty();
 		}
 
 		// Activates/Deactivates the GameObject (activeSelf).
-		void SetActive(bool value)
-		{
-			m_activeSelf = value;
-		}
+		void SetActive(bool value);
 
 		/************************************************************************/
 		/*                    Static Functions                                  */
@@ -130,7 +142,8 @@ namespace FishEngine
 
 	protected:
 		void Start();
-		void Update();
+		// Calls Start on the components that have not been started yet.
+		void StartComponents();
 		void OnDrawGizmos();
 		void OnDrawGizmosSelected();
 
@@ -146,10 +159,12 @@ namespace FishEngine
 		friend class FishEditor::Inspector;
 		friend class FishEditor::EditorGUI;
 		friend class FishEditor::SceneViewEditor;
+		friend class FishEditor::ScriptManager;
 
 		std::list<ComponentPtr> m_components;
 
 		bool			m_activeSelf	= true;
+		bool			m_isStatic		= false;
 		int				m_layer			= 0;
 		int				m_tagIndex		= 0;		// index in TagManager
 		TransformPtr	m_transform;
@@ -272,6 +287,7 @@ inline bool FishEngine::GameObject::AddComponent(ComponentPtr component)
 	component->m_gameObject = m_transform->gameObject();
 	m_components.push_back(component);
 	component->Reset();
+	SetDirty();
 	return true;
 }
 
@@ -287,6 +303,7 @@ std::shared_ptr<T> FishEngine::GameObject::AddComponent()
 	auto component = MakeShared<T>();
 	component->m_gameObject = m_transform->gameObject();
 	m_components.push_back(component);
+	SetDirty();
 	return component;
 }
 
@@ -985,6 +985,7 @@ namespace FishEngine
 		archive << BaseClassWrapper<Object>(value);
 		archive << make_nvp("m_components", value.m_components); // std::list<ComponentPtr>
 		archive << make_nvp("m_activeSelf", value.m_activeSelf); // bool
+		archive << make_nvp("m_isStatic", value.m_isStatic); // bool
 		archive << make_nvp("m_layer", value.m_layer); // int
 		archive << make_nvp("m_tagIndex", value.m_tagIndex); // int
 		archive << make_nvp("m_transform", value.m_transform); // TransformPtr
@@ -996,6 +997,7 @@ namespace FishEngine
 		archive >> BaseClassWrapper<Object>(value);
 		archive >> make_nvp("m_components", value.m_components); // std::list<ComponentPtr>
 		archive >> make_nvp("m_activeSelf", value.m_activeSelf); // bool
+		archive >> make_nvp("m_isStatic", value.m_isStatic); // bool
 		archive >> make_nvp("m_layer", value.m_layer); // int
 		archive >> make_nvp("m_tagIndex", value.m_tagIndex); // int
 		archive >> make_nvp("m_transform", value.m_transform); // TransformPtr
@@ -0,0 +1,236 @@
+#ifndef GeometryPool_hpp
+#define GeometryPool_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "GLEnvironment.hpp"
+
+namespace FishEngine
+{
+	// Sub-allocation of a range [0, capacity) of units (vertices, indices) with a free list.
+	// The smallest free block large enough is used (best fit); freed blocks are merged with their free neighbours.
+	class FE_EXPORT Meta(NonSerializable) RangeAllocator
+	{
+	public:
+		static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+		explicit RangeAllocator(uint32_t capacity = 0);
+
+		// Returns the offset of the block, or InvalidOffset if no free block is large enough. size > 0.
+		uint32_t Allocate(uint32_t size);
+
+		// offset: returned by Allocate.
+		void Free(uint32_t offset);
+
+		// Adds [capacity(), capacity) to the free space, the allocations are kept.
+		void Grow(uint32_t capacity);
+
+		uint32_t capacity() const
+		{
+			return m_capacity;
+		}
+
+		// The total size of the allocations.
+		uint32_t used() const
+		{
+			return m_used;
+		}
+
+		uint32_t largestFreeBlock() const;
+
+		uint32_t freeBlockCount() const
+		{
+			return static_cast<uint32_t>(m_free.size());
+		}
+
+		// The free space outside the largest free block, unusable for a large allocation.
+		uint32_t fragmentedSize() const
+		{
+			return m_capacity - m_used - largestFreeBlock();
+		}
+
+		// offset -> size, sorted by offset.
+		std::map<uint32_t, uint32_t> const & allocations() const
+		{
+			return m_allocations;
+		}
+
+	private:
+		void AddFreeBlock(uint32_t offset, uint32_t size);
+		void RemoveFreeBlock(std::map<uint32_t, uint32_t>::iterator it);
+
+		uint32_t m_capacity = 0;
+		uint32_t m_used = 0;
+		std::map<uint32_t, uint32_t> m_free;				// offset -> size
+		std::multimap<uint32_t, uint32_t> m_freeBySize;		// size -> offset
+		std::map<uint32_t, uint32_t> m_allocations;			// offset -> size
+	};
+
+
+	// The geometry of the static meshes, shared: one interleaved vertex buffer, one index buffer and one VAO per
+	// vertex layout. A Mesh is a block of both buffers, drawn with its base vertex and its first index, so that
+	// drawing meshes of the same layout one after the other does not bind anything.
+	//
+	// The buffers grow by reallocation (copied on the GPU) when a mesh does not fit; they are compacted when too much
+	// of the free space is in holes after meshes are released. The handles of the blocks stay valid.
+	// Skinned meshes keep their own buffers (transform feedback).
+	class FE_EXPORT Meta(NonSerializable) GeometryPool
+	{
+	public:
+		// Vertex layout: the attributes besides the position.
+		static constexpr uint32_t NormalAttribute = 1;
+		static constexpr uint32_t UVAttribute = 2;
+		static constexpr uint32_t TangentAttribute = 4;
+		static constexpr uint32_t LayoutCount = 8;
+
+		static constexpr uint32_t InvalidHandle = UINT32_MAX;
+
+		// Initial capacities, in vertices and indices.
+		static constexpr uint32_t InitialVertexCapacity = 1 << 16;
+		static constexpr uint32_t InitialIndexCapacity = 1 << 18;
+
+		// The buffers are compacted when the free space outside the largest free block exceeds this part of them.
+		static constexpr float DefragmentThreshold = 0.25f;
+
+		struct Block
+		{
+			uint32_t	baseVertex = 0;
+			uint32_t	vertexCount = 0;	// 0: released
+			uint32_t	firstIndex = 0;
+			uint32_t	indexCount = 0;
+		};
+
+		// Binds and buffer copies, since the start. Divide the difference by the frames for per frame numbers.
+		struct Statistics
+		{
+			uint64_t	vertexArrayBinds = 0;
+			uint64_t	skippedVertexArrayBinds = 0;	// the VAO was already bound
+			uint64_t	bufferBinds = 0;				// uploads, read backs and reallocations of the pools
+			uint64_t	reallocations = 0;
+			uint64_t	defragmentations = 0;
+		};
+
+		GeometryPool(const GeometryPool&) = delete;
+		void operator=(const GeometryPool&) = delete;
+
+		// The pool of the layout, created on first use. Never destroyed: meshes can be released at exit.
+		static GeometryPool & Get(uint32_t layout);
+
+		// The attributes of mesh: those with one value per vertex.
+		static uint32_t LayoutOf(Mesh const & mesh);
+
+		// Size of one vertex of the layout, in bytes.
+		static uint32_t Stride(uint32_t layout);
+
+		// Writes the vertices of mesh interleaved as in the pool of layout (LayoutOf(mesh)): position, normal, uv,
+		// tangent. vertices: Stride(layout) bytes per vertex. No GL call, any thread.
+		static void Interleave(Mesh const & mesh, uint32_t layout, void* vertices);
+
+		// Copies the vertices and the triangles of mesh in the buffers.
+		// Returns InvalidHandle if mesh has no vertex or no triangle.
+		uint32_t Allocate(Mesh const & mesh);
+
+		// A block of vertexCount vertices and indexCount indices, its content undefined. Both > 0.
+		uint32_t Allocate(uint32_t vertexCount, uint32_t indexCount);
+
+		// Copies the interleaved vertices and the indices of the block from system memory.
+		void Write(uint32_t handle, const void* vertices, const void* indices);
+
+		// Copies the interleaved vertices and the indices of the block from buffer, at these offsets in bytes.
+		void Copy(uint32_t handle, GLuint buffer, GLintptr vertexOffset, GLintptr indexOffset);
+
+		void Free(uint32_t handle);
+
+		Block const & block(uint32_t handle) const
+		{
+			return m_blocks[handle];
+		}
+
+		// Copies the block back to the vertices, normals, uv, tangents and triangles of mesh.
+		void Read(uint32_t handle, Mesh & mesh) const;
+
+		// Binds the VAO of the pool.
+		void Bind()
+		{
+			BindVertexArray(m_VAO);
+		}
+
+		// Packs the blocks at the start of the buffers.
+		void Defragment();
+
+		uint32_t layout() const
+		{
+			return m_layout;
+		}
+
+		// Size of one vertex, in bytes.
+		uint32_t stride() const
+		{
+			return m_stride;
+		}
+
+		// The buffers change when the pool is reallocated or defragmented.
+		GLuint vertexBuffer() const
+		{
+			return m_vertexBuffer;
+		}
+
+		GLuint indexBuffer() const
+		{
+			return m_indexBuffer;
+		}
+
+		RangeAllocator const & vertexAllocator() const
+		{
+			return m_vertices;
+		}
+
+		RangeAllocator const & indexAllocator() const
+		{
+			return m_indices;
+		}
+
+		// glBindVertexArray, skipped if vao is bound already. All the VAOs of the engine are bound with it.
+		static void BindVertexArray(GLuint vao);
+
+		// Forgets the bound VAO: the GL state may have been changed outside of the engine (once per frame).
+		static void InvalidateBinding()
+		{
+			s_boundVertexArray = InvalidBinding;
+		}
+
+		static Statistics const & statistics()
+		{
+			return s_statistics;
+		}
+
+	private:
+		explicit GeometryPool(uint32_t layout);
+
+		// New buffers of these capacities, with the blocks packed at their start.
+		void Reallocate(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+		void SetupVertexArray();
+
+		bool Fragmented() const;
+
+		static constexpr GLuint InvalidBinding = UINT32_MAX;
+		static GLuint s_boundVertexArray;
+		static Statistics s_statistics;
+
+		uint32_t m_layout;
+		uint32_t m_stride;
+
+		GLuint m_VAO = 0;
+		GLuint m_vertexBuffer = 0;
+		GLuint m_indexBuffer = 0;
+
+		RangeAllocator m_vertices;
+		RangeAllocator m_indices;
+
+		std::vector<Block> m_blocks;
+		std::vector<uint32_t> m_freeHandles;
+	};
+}
+
+#endif // GeometryPool_hpp
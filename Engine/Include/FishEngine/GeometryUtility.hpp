@@ -0,0 +1,32 @@
+#ifndef GeometryUtility_hpp
+#define GeometryUtility_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "Matrix4x4.hpp"
+#include "Bounds.hpp"
+
+namespace FishEngine
+{
+	// Utility class for common geometric functions.
+	class FE_EXPORT Meta(NonSerializable) GeometryUtility
+	{
+	public:
+		GeometryUtility() = delete;
+
+		// Calculates the 6 planes of the frustum of worldToProjectionMatrix (e.g. projection * view):
+		// left, right, bottom, top, near, far.
+		// A plane is (normal, distance), the normal points inside: dot(normal, p) + distance >= 0 for the points inside.
+		static void CalculateFrustumPlanes(const Matrix4x4& worldToProjectionMatrix, Vector4 planes[6]);
+
+		// Returns true if bounds are inside the planes or intersect them.
+		// Conservative: a box outside the frustum but not completely behind one of the planes is kept.
+		static bool TestPlanesAABB(const Vector4 planes[6], const Bounds& bounds);
+
+		// Returns true if the sphere is inside the planes or intersects them. Same test as TestPlanesAABB, the normals
+		// of the planes do not need to be normalized (planes transformed to the local space of an object).
+		static bool TestPlanesSphere(const Vector4 planes[6], const Vector3& center, float radius);
+	};
+}
+
+#endif // GeometryUtility_hpp
@@ -3,9 +3,12 @@
 #include "FishEngine.hpp"
 #include "ReflectClass.hpp"
 
+#include <vector>
+
 namespace FishEngine
 {
 	//class RenderBuffer;
+	struct IndexRange;
 
 	class FE_EXPORT Meta(NonSerializable) Graphics
 	{
@@ -17,11 +20,24 @@ namespace FishEngine
 		static void DrawMesh(const MeshPtr& mesh, const Matrix4x4& matrix, const MaterialPtr& material);
 		static void DrawMesh(const MeshPtr& mesh, const MaterialPtr& material);
 		static void DrawMesh(const MeshPtr& mesh, const MaterialPtr& material, int subMeshIndex);
+
+		// Draws the ranges of the index buffer of mesh with one glMultiDrawElements.
+		static void DrawMesh(const MeshPtr& mesh, const MaterialPtr& material, std::vector<IndexRange> const & ranges);
+
+		// Draws instanceCount instances of vertexCount vertices (glDrawArraysInstanced) of the bound vertex array;
+		// the vertices are usually generated by the shader from gl_VertexID.
+		static void DrawProcedural(const MaterialPtr& material, unsigned int topology, int vertexCount, int instanceCount);
 		static void DrawTexture();
 
 		static void SetRenderTarget(RenderTexturePtr rt);
 
+		// Number of draw calls issued by DrawMesh and DrawProcedural since the start, a multi-draw counting as one.
+		static uint64_t drawCallCount() { return s_drawCallCount; }
+
 		//static RenderBuffer activeColorBuffer;
 		//static RenderBuffer activeDepthBuffer;
+
+	private:
+		static uint64_t s_drawCallCount;
 	};
 }
@@ -0,0 +1,125 @@
+#ifndef Impostor_hpp
+#define Impostor_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "ImpostorUtility.hpp"
+#include "GLEnvironment.hpp"
+#include "Quaternion.hpp"
+
+namespace FishEngine
+{
+	// The atlases of an object rendered from many directions (ImpostorBaker), drawn as one quad per instance far from
+	// the camera (Renderer::setImpostor). The quad faces the camera; its pixels blend the three frames closest to the
+	// view direction, reprojected on the ray of the pixel, and write the depth of the baked surface.
+	//
+	// The instances of the frame are gathered by the RenderSystem (AddInstance) and drawn at once (DrawInstances).
+	// An instance takes the position and the rotation of its Transform, and the largest of its scales.
+	class FE_EXPORT Meta(NonSerializable) Impostor
+	{
+	public:
+		Impostor() = default;
+		~Impostor();
+
+		Impostor(const Impostor&) = delete;
+		void operator=(const Impostor&) = delete;
+
+		ImpostorUtility::Layout const & layout() const
+		{
+			return m_layout;
+		}
+
+		// The bounding sphere of the object, in the local space of its renderer.
+		Vector3 const & center() const
+		{
+			return m_center;
+		}
+
+		float radius() const
+		{
+			return m_radius;
+		}
+
+		// RGB: albedo, A: coverage. The atlases are premultiplied by the coverage (their mips blend with the background).
+		ColorBufferPtr const & albedoAtlas() const
+		{
+			return m_albedo;
+		}
+
+		// RGB: normal in the local space of the renderer, * 0.5 + 0.5. A: coverage.
+		ColorBufferPtr const & normalAtlas() const
+		{
+			return m_normal;
+		}
+
+		// R: depth in the frame (see ImpostorUtility), G: coverage.
+		ColorBufferPtr const & depthAtlas() const
+		{
+			return m_depth;
+		}
+
+		MaterialPtr const & material() const
+		{
+			return m_material;
+		}
+
+		// The bounding sphere of the instance in world space.
+		void WorldBounds(Matrix4x4 const & localToWorld, Vector3 & center, float & radius) const;
+
+		void AddInstance(Vector3 const & center, float radius, Quaternion const & rotation);
+
+		uint32_t instanceCount() const
+		{
+			return static_cast<uint32_t>(m_instances.size());
+		}
+
+		// Draws the instances added since the last call with one draw call, and removes them.
+		void DrawInstances();
+
+	private:
+		friend class ImpostorBaker;
+
+		struct Instance
+		{
+			Vector3		center;		// world space
+			float		radius;
+			Quaternion	rotation;	// local to world
+		};
+
+		void CreateVertexArray();
+
+		ImpostorUtility::Layout	m_layout;
+		Vector3					m_center;
+		float					m_radius = 0;
+		ColorBufferPtr			m_albedo;
+		ColorBufferPtr			m_normal;
+		ColorBufferPtr			m_depth;
+		MaterialPtr				m_material;
+
+		std::vector<Instance>	m_instances;
+		GLuint					m_VAO = 0;
+		GLuint					m_instanceBuffer = 0;
+		uint32_t				m_instanceCapacity = 0;
+	};
+
+
+	// Renders the mesh of a MeshRenderer, with the albedo of its materials (Material::color and mainTexture), in the
+	// frames of an impostor. Alpha tested at 0.5: the holes of foliage are kept. Both faces are rendered.
+	// The impostors are cached: the renderers with the same mesh and materials share one.
+	class FE_EXPORT Meta(NonSerializable) ImpostorBaker
+	{
+	public:
+		ImpostorBaker() = delete;
+
+		// Returns nullptr if the renderer has no mesh (skinned meshes are not baked).
+		static ImpostorPtr Bake(RendererPtr const & renderer, ImpostorUtility::Layout const & layout = ImpostorUtility::Layout());
+
+		// Bakes the MeshRenderers of root and of its children, and draws them as their impostors beyond distance.
+		// Returns the number of renderers given an impostor.
+		static int BakeHierarchy(GameObjectPtr const & root, float distance, ImpostorUtility::Layout const & layout = ImpostorUtility::Layout());
+
+		static void ClearCache();
+	};
+}
+
+#endif // Impostor_hpp
@@ -0,0 +1,91 @@
+#ifndef ImpostorUtility_hpp
+#define ImpostorUtility_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Matrix4x4.hpp"
+
+namespace FishEngine
+{
+	// Octahedral impostors: an object is rendered from a grid of directions into the frames of an atlas. The
+	// directions are the vertices of a regular grid over the octahedral map of the sphere, or of the upper hemisphere
+	// (y >= 0) for objects only seen from above. A view direction falls in a cell of the grid and is drawn by blending
+	// the three frames of the triangle of the cell containing it.
+	//
+	// The object is rendered in a normalized space: its bounding sphere is the unit sphere. Frame (x, y) is rendered by
+	// an orthographic camera on the frame direction d, 2 units away from the center, looking at it, with near 1 and
+	// far 3: the plane of the frame goes through the center, a point of the plane at frameUV (u, v) is
+	// (2u - 1) * right + (2v - 1) * up (FrameBasis), and a depth z (in [0, 1]) is 2z - 1 units behind the plane.
+	//
+	// Shaders/Impostor.shader implements the same mapping, they must be changed together.
+	class FE_EXPORT Meta(NonSerializable) ImpostorUtility
+	{
+	public:
+		ImpostorUtility() = delete;
+
+		struct Layout
+		{
+			int		framesPerSide = 8;			// the atlas has framesPerSide x framesPerSide frames, >= 2
+			int		frameResolution = 128;		// in pixels
+			bool	hemisphere = true;
+
+			int atlasSize() const
+			{
+				return framesPerSide * frameResolution;
+			}
+
+			bool operator==(Layout const & rhs) const
+			{
+				return framesPerSide == rhs.framesPerSide && frameResolution == rhs.frameResolution && hemisphere == rhs.hemisphere;
+			}
+		};
+
+		// The frames to blend for a view direction, and their weights (summing to 1).
+		struct FrameBlend
+		{
+			int		x[3];
+			int		y[3];
+			float	weight[3];
+		};
+
+		// Unit direction -> [-1, 1]^2, y being the pole: the upper half is the inner diamond, the lower half is folded
+		// on the corners.
+		static Vector2 OctahedralEncode(Vector3 const & direction);
+		static Vector3 OctahedralDecode(Vector2 const & p);
+
+		// Direction with y >= 0 -> [-1, 1]^2: the upper half of the octahedron, rotated by 45 degrees to fill the square.
+		static Vector2 HemiOctahedralEncode(Vector3 const & direction);
+		static Vector3 HemiOctahedralDecode(Vector2 const & p);
+
+		// The direction of the frame, from the center of the object to the camera which rendered it. Unit length.
+		static Vector3 FrameDirection(Layout const & layout, int x, int y);
+
+		// The axes of the plane of a frame, as seen by its camera (Matrix4x4::LookAt).
+		static void FrameBasis(Vector3 const & direction, Vector3 & right, Vector3 & up);
+
+		// The camera of the frame, in the normalized space.
+		static Matrix4x4 FrameViewMatrix(Vector3 const & direction);
+		static Matrix4x4 FrameProjectionMatrix();
+
+		// The frames of the view direction (from the center of the object to the eye, unit length). In the hemisphere
+		// layout, the directions below the horizon use the frames of the horizon.
+		static FrameBlend BlendFrames(Layout const & layout, Vector3 const & direction);
+
+		// The point of the plane of the frame hit by the ray from eye through point (normalized space), in frameUV.
+		// Returns false if the ray is parallel to the plane.
+		static bool ProjectToFrame(Vector3 const & frameDirection, Vector3 const & eye, Vector3 const & point, Vector2 & frameUV);
+
+		// The point of the object (normalized space) at frameUV of the frame, with the depth read from the atlas.
+		static Vector3 FramePoint(Vector3 const & frameDirection, Vector2 const & frameUV, float depth);
+
+		// frameUV of frame (x, y) -> texture coordinates of the atlas.
+		static Vector2 AtlasUV(Layout const & layout, int x, int y, Vector2 const & frameUV);
+
+		// The pixel rectangle of the frame in the atlas: x, y, width, height (glViewport).
+		static void FrameViewport(Layout const & layout, int x, int y, int viewport[4]);
+	};
+}
+
+#endif // ImpostorUtility_hpp
@@ -2,12 +2,16 @@
 #define Input_hpp
 
 //#include "GLEnvironment.hpp"
+#include "Vector2.hpp"
 #include "Vector3.hpp"
 #include "Screen.hpp"
 //#include <glfw/glfw3.h>
 #include "ReflectClass.hpp"
 #include "KeyCode.hpp"
 
+#include <vector>
+#include <bitset>
+
 namespace FishEngine
 {
 	//enum class KeyCode {
@@ -56,6 +60,25 @@ namespace FishEngine
 
 	constexpr int keyCount = 512;
 
+	enum class InputEventType {
+		KeyDown,
+		KeyUp,
+		MouseButtonDown,
+		MouseButtonUp,
+		MouseMove,          // x, y: normalized mouse position; the delta too, until a MouseDelta is posted
+		MouseDelta,         // x, y: raw mouse movement in normalized units, not clamped by the window
+		Scroll,             // y: scroll wheel delta
+	};
+
+	struct InputEvent
+	{
+		InputEventType  type;
+		double          timestamp;  // seconds, see Input::Now()
+		int             code;       // KeyCode or mouse button
+		float           x;
+		float           y;
+	};
+
 	class FE_EXPORT Meta(NonSerializable) Input
 	{
 	public:
@@ -74,6 +97,35 @@ namespace FishEngine
 			return Vector3(m_mousePositionX, m_mousePositionX, 0);
 		}
 
+		// Accumulated mouse movement during this frame, in normalized screen units: the raw movement if the window
+		// posts MouseDelta events (GameApp, while the cursor is locked), else the movement of the mouse position.
+		static Vector2 mouseDelta()
+		{
+			return Vector2(m_mouseDeltaX, m_mouseDeltaY);
+		}
+
+		// All input events of this frame, in the order they happened.
+		// Latency-sensitive code can use the timestamps instead of the per-frame state.
+		static std::vector<InputEvent> const & frameEvents()
+		{
+			return m_frameEvents;
+		}
+
+		// Whether the cursor is hidden and held by the window (Unity's Cursor.lockState): the mouse then only moves
+		// mouseDelta, by the raw motion of the device where the platform reports it. Applied by GameApp every frame.
+		static bool cursorLocked()
+		{
+			return m_cursorLocked;
+		}
+
+		static void setCursorLocked(bool locked)
+		{
+			m_cursorLocked = locked;
+		}
+
+		// The clock used to timestamp input events, in seconds.
+		static double Now();
+
 		// Returns the value of the virtual axis identified by axisName.
 		static float GetAxis(Axis axis)
 		{
@@ -101,12 +153,21 @@ namespace FishEngine
 		// button values are 0 for left button, 1 for right button, 2 for the middle button.
 		static bool GetMouseButtonUp(int button);
 
-	private:
+		// Feeds an event into the queue, e.g. from a window callback or from a recorded event stream.
+		// Events must be posted in timestamp order: an event older than the last one of the frame takes its
+		// timestamp, so frameEvents stays sorted and replays the state it was derived in.
+		static void PostEvent(InputEvent const & event);
+
+		// Forgets every key, button and event. Called by the frame loop (GameApp) before the first frame.
 		static void Init();
+
+		// Ends the frame: the events of this frame are dropped and the next posted events start a new frame.
 		static void Update();
 
+	private:
 		static void UpdateAxis(Axis axis, float value);
 		static void UpdateMousePosition(float xpos, float ypos);
+		static void UpdateMouseDelta(float dx, float dy);
 		static void UpdateKeyState(KeyCode key, KeyState state);
 		static void UpdateKeyState(int key, KeyState state);
 		static void UpdateMouseButtonState(int button, MouseButtonState state);
@@ -118,13 +179,26 @@ namespace FishEngine
 		friend class FishEditor::SceneViewEditor;
 		friend class ::GLWidget;
 
-		static KeyState m_keyStates[keyCount];
+		// derived from the events: keys that are held now, and keys pressed / released during this frame.
+		static std::bitset<keyCount> m_keyHeld;
+		static std::bitset<keyCount> m_keyDownThisFrame;
+		static std::bitset<keyCount> m_keyUpThisFrame;
 
 		// button values are 0 for left button, 1 for right button, 2 for the middle button.
-		static MouseButtonState m_mouseButtonStates[3];
+		static std::bitset<3> m_mouseButtonHeld;
+		static std::bitset<3> m_mouseButtonDownThisFrame;
+		static std::bitset<3> m_mouseButtonUpThisFrame;
+
 		static float m_mousePositionX;  // normalized, (0, 1)
 		static float m_mousePositionY;  // normalized, (0, 1)
+		static bool m_mousePositionValid;   // a MouseMove was posted since Init: the next one has a delta
+		static float m_mouseDeltaX;
+		static float m_mouseDeltaY;
+		static bool m_rawMouseDelta;    // a MouseDelta was posted this frame: MouseMove only moves the position
+		static bool m_cursorLocked;
 		static float m_axis[(int)Axis::AxisCount];
+
+		static std::vector<InputEvent> m_frameEvents;
 	};
 }
 
@@ -1,13 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <deque>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "LogType.hpp"
 #include "../ReflectClass.hpp"
 
-class LogViewModel;
-
 namespace FishEngine
 {
 	struct LogData
@@ -19,6 +21,8 @@ namespace FishEngine
 		std::string functionName;
 	};
 
+	// Append-only store of every message logged through Debug.
+	// Log() may be called from any thread; views poll size() and Fetch() the new entries in batches.
 	class FE_EXPORT SimpleLogger
 	{
 	public:
@@ -33,14 +37,46 @@ namespace FishEngine
 
 		void Log(LogData && data)
 		{
-			m_data.emplace_back(data);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_data.push_back(std::move(data));
 		}
 
-	private:
-		friend class ::LogViewModel;
+		size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_data.size();
+		}
+
+		// Appends copies of the entries [first, first+maxCount) to out, returns the number of entries copied.
+		size_t Fetch(size_t first, size_t maxCount, std::vector<LogData> & out) const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (first >= m_data.size())
+				return 0;
+			size_t count = std::min(maxCount, m_data.size() - first);
+			out.insert(out.end(), m_data.begin() + first, m_data.begin() + first + count);
+			return count;
+		}
 
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_data.clear();
+			m_generation++;
+		}
+
+		// Incremented by Clear(), so that views know the indices they have seen are gone.
+		uint32_t generation() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_generation;
+		}
+
+	private:
 		SimpleLogger() = default;
 
-		std::deque<LogData> m_data;
+		mutable std::mutex	m_mutex;
+		std::deque<LogData>	m_data;
+		uint32_t			m_generation = 0;
 	};
 }
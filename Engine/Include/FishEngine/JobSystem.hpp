@@ -0,0 +1,27 @@
+#ifndef JobSystem_hpp
+#define JobSystem_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include <functional>
+
+namespace FishEngine
+{
+	// A fixed pool of worker threads for data-parallel loops.
+	class FE_EXPORT Meta(NonSerializable) JobSystem
+	{
+	public:
+		JobSystem() = delete;
+
+		// Number of threads that execute a ParallelFor, including the calling thread.
+		static int threadCount();
+
+		// Calls func(begin, end) for chunks of at most grainSize indices covering [0, count),
+		// on the worker threads and on the calling thread, and returns when all chunks are done.
+		// Chunks are processed in no particular order.
+		// A ParallelFor issued from inside a job runs serially on the calling worker.
+		static void ParallelFor(size_t count, size_t grainSize, std::function<void(size_t begin, size_t end)> const & func);
+	};
+}
+
+#endif // JobSystem_hpp
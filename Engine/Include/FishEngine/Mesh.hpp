@@ -19,6 +19,26 @@ namespace FishEditor
 
 namespace FishEngine
 {
+	class GeometryPool;
+
+	// A range of the index buffer of a Mesh, in indices.
+	struct IndexRange
+	{
+		uint32_t	start;
+		uint32_t	count;
+	};
+
+	// A small cluster of triangles of a Mesh (MeshletUtility), culled on its own.
+	struct Meshlet
+	{
+		IndexRange	indices;		// contiguous in the index buffer, inside one submesh
+		uint32_t	vertexCount;	// distinct vertices
+		Vector3		center;			// bounding sphere, in the local space of the mesh
+		float		radius;
+		Vector3		coneAxis;		// normal cone of the triangles, see MeshletUtility::IsBackfacing
+		float		coneCutoff;		// 1: no cone, the triangles face too many directions
+	};
+
 	class FE_EXPORT Mesh : public Object
 	{
 	public:
@@ -169,12 +189,64 @@ namespace FishEngine
 		// Returns the index buffer for the sub-Mesh.
 		// The layout of indices depends on the topology of a sub-Mesh. For example, for a triangular Mesh, each triangle results in three indices.
 		//const std::vector<uint32_t> & GetIndices(int submesh) const;
+
+		// Starting point inside the whole Mesh index buffer where the sub-Mesh index data begins.
+		uint32_t GetIndexStart(int submesh) const;
+
+		// Number of indices in the sub-Mesh.
+		uint32_t GetIndexCount(int submesh) const;
+
+		// Copies the vertices, normals, uv, tangents and triangles back from the GL buffers, if the Mesh was uploaded
+		// with markNoLogerReadable. For the processing done once at load time (static batching).
+		// Returns false if there is no data: not uploaded and empty, or skinned.
+		bool ReadBackMeshData();
+
+		// Number of levels of detail, LOD 0 being this mesh. The coarser levels are generated at import time
+		// (ModelImporter LOD settings).
+		int lodCount() const
+		{
+			return 1 + static_cast<int>(m_lods.size());
+		}
+
+		// The mesh of the LOD level, from 1 to lodCount()-1.
+		MeshPtr const & lod(int level) const
+		{
+			return m_lods[level-1];
+		}
+
+		// Largest distance between the surface of the LOD level and this mesh, in the local space of the mesh.
+		float lodError(int level) const
+		{
+			return level == 0 ? 0.0f : m_lodErrors[level-1];
+		}
+
+		// The coarsest level whose error is at most maxError.
+		int SelectLOD(float maxError) const;
+
+		// lods: LOD 1, 2..., errors: their lodError, increasing.
+		void SetLODs(std::vector<MeshPtr> lods, std::vector<float> errors);
+
+		// The clusters of triangles built at import time (MeshletUtility::Build), in the order of the index buffer.
+		// Empty if the mesh is drawn whole.
+		std::vector<Meshlet> const & meshlets() const
+		{
+			return m_meshlets;
+		}
+
+		// The meshlets of the submesh are meshlets()[meshletStart(subMesh)] to meshlets()[meshletStart(subMesh+1)-1].
+		uint32_t meshletStart(int subMesh) const
+		{
+			return m_meshletOffsets[subMesh];
+		}
 		
 	public:
 		void Clear();
 		
 		// -1: reander all submeshes
 		void Render(int subMeshIndex = -1);
+
+		// Renders the ranges of the index buffer in one call (glMultiDrawElements).
+		void Render(std::vector<IndexRange> const & ranges);
 		
 		void RenderSkinned();
 		
@@ -235,7 +307,11 @@ namespace FishEngine
 		friend class FishEditor::ModelImporter;
 		friend class FishEditor::FBXImporter;
 		friend class MeshRenderer;
+		friend class StaticBatchingUtility;
 		friend class SkinnedMeshRenderer;
+		friend class MeshletUtility;
+		friend class UploadQueue;
+		friend class DepthOnlyRenderer;
 		//friend class Model;
 
 		static std::map<PrimitiveType, MeshPtr> s_builtinMeshes;
@@ -247,6 +323,29 @@ namespace FishEngine
 
 		Bounds m_bounds;
 
+		Meta(NonSerializable)
+		std::vector<MeshPtr> m_lods;
+
+		Meta(NonSerializable)
+		std::vector<float> m_lodErrors;
+
+		Meta(NonSerializable)
+		std::vector<Meshlet> m_meshlets;
+
+		Meta(NonSerializable)
+		std::vector<uint32_t> m_meshletOffsets;	// first meshlet of each submesh, and meshlets.size()
+
+		// the static meshes are drawn from a GeometryPool, the skinned and empty ones from their own buffers
+		Meta(NonSerializable)
+		GeometryPool* m_pool = nullptr;
+
+		Meta(NonSerializable)
+		uint32_t m_poolBlock = 0;
+
+		// in the UploadQueue: not drawn until uploaded
+		Meta(NonSerializable)
+		bool m_uploadQueued = false;
+
 		Meta(NonSerializable)
 		GLuint m_VAO = 0;
 		
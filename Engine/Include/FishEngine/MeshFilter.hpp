@@ -22,6 +22,7 @@ namespace FishEngine
 
 		void SetMesh(MeshPtr mesh) {
 			m_mesh = mesh;
+			SetDirty();
 		}
 
 		//virtual void OnInspectorGUI() override;
@@ -0,0 +1,67 @@
+#ifndef MeshSimplifier_hpp
+#define MeshSimplifier_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "BoneWeight.hpp"
+
+#include <vector>
+
+namespace FishEngine
+{
+	// The vertices and triangles of a Mesh without its GL objects, it can be processed on any thread.
+	struct FE_EXPORT MeshGeometry
+	{
+		std::vector<Vector3>	vertices;
+		std::vector<Vector3>	normals;
+		std::vector<Vector2>	uv;
+		std::vector<Vector3>	tangents;
+		std::vector<BoneWeight>	boneWeights;			// empty if the mesh is not skinned
+		std::vector<uint32_t>	triangles;
+		std::vector<uint32_t>	subMeshIndexOffset;		// start of each submesh in triangles, in indices
+
+		uint32_t triangleCount() const
+		{
+			return static_cast<uint32_t>(triangles.size() / 3);
+		}
+
+		// mesh must be readable (not uploaded yet, or read back).
+		static MeshGeometry FromMesh(Mesh const & mesh);
+
+		// A new Mesh with this geometry, and the skinning data (bind poses, bone names) of source.
+		// Must be called on the main thread.
+		MeshPtr ToMesh(Mesh const & source) const;
+	};
+
+
+	// Level of detail generation by edge collapse, ordered by the quadric error metric (Garland and Heckbert,
+	// "Surface Simplification Using Quadric Error Metrics").
+	//
+	// The collapses are half-edge collapses: the remaining vertices keep their position, normal, uv and tangent. To keep
+	// the appearance of the mesh:
+	//  - the vertices split at the same position (uv seams, hard edges) collapse only along the seam;
+	//  - a vertex shared by several submeshes (materials) collapses only along the boundary between them, so do the
+	//    vertices of open borders;
+	//  - skinned vertices collapse only to vertices with similar bone weights (MaxBoneWeightDifference);
+	//  - a collapse flipping a triangle is rejected.
+	class FE_EXPORT Meta(NonSerializable) MeshSimplifier
+	{
+	public:
+		MeshSimplifier() = delete;
+
+		// Removes triangles until there are at most targetTriangleCount, or until no collapse is allowed.
+		// The submeshes of source are kept, in the same order.
+		static MeshGeometry Simplify(MeshGeometry const & source, uint32_t targetTriangleCount);
+
+		// Largest distance from the vertices of reference to the surface of simplified, and from the vertices of
+		// simplified to the surface of reference.
+		static float GeometricError(MeshGeometry const & reference, MeshGeometry const & simplified);
+
+		// Sum of the differences of the weights of each bone, from 0 (same weights) to 2 (no common bone).
+		static constexpr float MaxBoneWeightDifference = 0.5f;
+	};
+}
+
+#endif // MeshSimplifier_hpp
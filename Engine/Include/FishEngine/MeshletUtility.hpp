@@ -0,0 +1,58 @@
+#ifndef MeshletUtility_hpp
+#define MeshletUtility_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "Mesh.hpp"
+#include "Vector4.hpp"
+
+namespace FishEngine
+{
+	// Meshlets: the triangles of a large mesh are split into small clusters, each with a bounding sphere and a cone
+	// containing the normals of its triangles. The clusters outside the view frustum, or whose triangles all face away
+	// from the camera, are not drawn; the visible ones are drawn as ranges of the index buffer with one
+	// glMultiDrawElements (Graphics::DrawMesh with ranges).
+	class FE_EXPORT Meta(NonSerializable) MeshletUtility
+	{
+	public:
+		MeshletUtility() = delete;
+
+		static constexpr uint32_t MaxVertices = 64;
+		static constexpr uint32_t MaxTriangles = 124;
+
+		// Meshes with fewer triangles are drawn whole.
+		static constexpr uint32_t MinTriangleCount = 1024;
+
+		// The view, in the local space of a mesh.
+		struct View
+		{
+			Vector4		planes[6];		// frustum, not normalized
+			Vector3		eye;			// perspective: position of the camera
+			Vector3		direction;		// orthographic: forward of the camera, normalized
+			bool		orthographic = false;
+			bool		coneCulling = false;
+		};
+
+		// worldPlanes: GeometryUtility::CalculateFrustumPlanes.
+		// backfaceCulling: the material culls the back faces. The cones are tested only then, and if localToWorld keeps
+		// the angles and the winding (rotation, translation, uniform positive scale).
+		static View LocalView(const Vector4 worldPlanes[6], Camera const & camera, const Matrix4x4 & localToWorld, bool backfaceCulling);
+
+		// Sorts the triangles of each submesh of mesh by cluster, and sets its meshlets.
+		// mesh must not be uploaded yet. Skinned meshes (their bounds move) and small meshes are left as they are.
+		// Returns true if mesh has meshlets.
+		static bool Build(Mesh & mesh);
+
+		// Clusters triangles[range] in place: appends the meshlets, contiguous from range.start, to meshlets.
+		static void Build(std::vector<Vector3> const & vertices, std::vector<uint32_t> & triangles, IndexRange range, std::vector<Meshlet> & meshlets);
+
+		// True if all the triangles of the meshlet face away from the view. Conservative.
+		static bool IsBackfacing(Meshlet const & meshlet, View const & view);
+
+		// Appends the index ranges of the visible meshlets of [first, last), adjacent ones merged, to visible.
+		// Returns the number of triangles of these meshlets.
+		static uint32_t Cull(const Meshlet* first, const Meshlet* last, View const & view, std::vector<IndexRange> & visible);
+	};
+}
+
+#endif // MeshletUtility_hpp
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <map>
+#include <atomic>
 
 #include "FishEngine.hpp"
 #include "Macro.hpp"
@@ -50,7 +51,23 @@ namespace FishEngine
 		
 		// The name of the object.
 		virtual inline std::string name() const { return m_name; }
-		inline void setName(const std::string& name) { m_name = name; }
+		virtual void setName(const std::string& name) { m_name = name; }
+
+		// Incremented whenever the object is modified through its setters or the editor,
+		// so that views (e.g. the Inspector) can tell whether they need to refresh.
+		uint32_t dirtyCount() const { return m_dirtyCount.load(std::memory_order_relaxed); }
+
+		// Marks the object as modified. Safe from the parallel component updates (Scene::Update).
+		void SetDirty() const
+		{
+			m_dirtyCount.fetch_add(1, std::memory_order_relaxed);
+			s_totalDirtyCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Incremented by SetDirty on any object, and by the changes of the scene hierarchy (the GameObject created,
+		// destroyed, reparented is marked dirty): a view of the whole scene compares it instead of visiting every
+		// object. It never repeats.
+		static uint64_t totalDirtyCount() { return s_totalDirtyCount.load(std::memory_order_relaxed); }
 
 		// Should the object be hidden, saved with the scene or modifiable by the user ?
 		inline HideFlags hideFlags() const { return m_objectHideFlags; }
@@ -108,6 +125,12 @@ namespace FishEngine
 		Meta(NonSerializable)
 		int			m_instanceID = 0;
 
+		// mutable: bumped from const paths like Transform::MakeDirty; atomic: and from the jobs of ParallelFor
+		Meta(NonSerializable)
+		mutable std::atomic<uint32_t>	m_dirtyCount{ 0 };
+
+		static std::atomic<uint64_t>	s_totalDirtyCount;
+
 	public:	// TODO make it private
 		static std::multimap<int, ObjectPtr> s_classIDToObjects;
 
@@ -13,6 +13,7 @@
 #include <PxPhysicsAPI.h>
 
 #include "ReflectClass.hpp"
+#include <array>
 
 namespace FishEngine
 {
@@ -25,8 +26,41 @@ namespace FishEngine
 		static void Start();
 		static void FixedUpdate();
 		static void Clean();
+
+		// Makes the collision detection system ignore all collisions between any collider in layer1 and any collider in layer2.
+		static void IgnoreLayerCollision(int layer1, int layer2, bool ignore = true);
+
+		// Are collisions between layer1 and layer2 being ignored?
+		static bool GetIgnoreLayerCollision(int layer1, int layer2);
+
+		// Bitmask of the layers that colliders in layer collide with.
+		static uint32_t GetLayerCollisionMask(int layer);
+
+		// Simulation filter data for a shape in layer: word0 is the layer bit, word1 is the collision mask, word2 is the
+		// layer.
+		static physx::PxFilterData LayerFilterData(int layer);
+
+		// Collision filter shader that kills pairs whose layers are ignored by the layer collision matrix.
+		static physx::PxFilterFlags SimulationFilterShader(
+			physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
+			physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
+			physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize);
+
+		// Can shapes with these filter data collide? Shapes without filter data (word0 == 0) collide with everything.
+		static bool ShouldCollide(physx::PxFilterData const & filterData0, physx::PxFilterData const & filterData1)
+		{
+			if (filterData0.word0 == 0 || filterData1.word0 == 0)
+				return true;
+			return (filterData0.word0 & filterData1.word1) != 0 && (filterData1.word0 & filterData0.word1) != 0;
+		}
+
 	private:
-		
+		// layer collision matrix, like Unity's Physics settings.
+		// bit j of s_layerCollisionMatrix[i] is set if layer i collides with layer j.
+		static std::array<uint32_t, 32> s_layerCollisionMatrix;
+
+		// re-apply the collision matrix to all shapes in the scene.
+		static void RefreshFilterData();
 	};
 }
 
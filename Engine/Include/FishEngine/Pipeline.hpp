@@ -17,7 +17,14 @@ namespace FishEngine
 		static void Init();
 
 		static void BindCamera(const CameraPtr& camera);
-		static void BindLight(const LightPtr& light);
+		// A camera without a Camera component (offscreen rendering: impostor baking).
+		static void BindCamera(const Matrix4x4& projection, const Matrix4x4& view, float nearClipPlane, float farClipPlane);
+		// Saves the bound camera, bound again by PopCamera: a camera bound for offscreen rendering inside the frame of
+		// another one.
+		static void PushCamera();
+		static void PopCamera();
+		// camera: the camera the shadows are rendered for (shadow fade)
+		static void BindLight(const LightPtr& light, const CameraPtr& camera);
 
 		static void UpdatePerDrawUniforms(const Matrix4x4& modelMatrix);
 
@@ -57,6 +64,8 @@ namespace FishEngine
 		static constexpr unsigned int BonesUBOBindingPoint = 3;
 
 	private:
+		static void UploadPerCameraUniforms();
+
 		static unsigned int         s_perCameraUBO;
 		static unsigned int         s_perDrawUBO;
 		static unsigned int         s_lightingUBO;
@@ -69,6 +78,7 @@ namespace FishEngine
 		static RenderTargetPtr      s_currentRenderTarget;
 
 		static std::stack<RenderTargetPtr> s_renderTargetStack;
+		static std::stack<PerCameraUniforms> s_cameraStack;
 	};
 }
 
@@ -29,6 +29,28 @@ namespace FishEngine
 			return s_shadowDistance;
 		}
 
+		// The number of shadow cascades of the directional lights (1 to 4).
+		FE_EXPORT static int shadowCascades()
+		{
+			return m_shadowCascades;
+		}
+
+		FE_EXPORT static void setShadowCascades(int shadowCascades)
+		{
+			m_shadowCascades = shadowCascades < 1 ? 1 : (shadowCascades > 4 ? 4 : shadowCascades);
+		}
+
+		// The screen space error, in pixels, allowed when a coarser level of detail of a mesh is drawn.
+		FE_EXPORT static float lodErrorThreshold()
+		{
+			return s_lodErrorThreshold;
+		}
+
+		FE_EXPORT static void setLodErrorThreshold(float lodErrorThreshold)
+		{
+			s_lodErrorThreshold = lodErrorThreshold < 0 ? 0 : lodErrorThreshold;
+		}
+
 		static uint32_t CalculateShadowMapSize();
 
 	private:
@@ -48,5 +70,7 @@ namespace FishEngine
 
 		// Shadow Near Plane Offset	Offset shadow near plane to account for large triangles being distorted by shadow pancaking.
 		static float m_shadowNearPlaneOffset;
+
+		static float s_lodErrorThreshold;
 	};
 }
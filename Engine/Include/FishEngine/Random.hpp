@@ -0,0 +1,38 @@
+#ifndef Random_hpp
+#define Random_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include <random>
+
+namespace FishEngine
+{
+	// Class for generating random data.
+	// All engine code should draw random numbers from here, so that FrameRecorder can replay them.
+	class FE_EXPORT Meta(NonSerializable) Random
+	{
+	public:
+		Random() = delete;
+
+		// Initializes the random number generator state with a seed.
+		static void InitState(uint32_t seed);
+
+		// The seed passed to the last InitState call.
+		static uint32_t seed() { return s_seed; }
+
+		// Returns a random number between 0.0 [inclusive] and 1.0 [inclusive] (Read Only).
+		static float value();
+
+		// Returns a random float number between min [inclusive] and max [inclusive].
+		static float Range(float min, float max);
+
+		// Returns a random integer number between min [inclusive] and max [exclusive].
+		static int Range(int min, int max);
+
+	private:
+		static uint32_t		s_seed;
+		static std::mt19937	s_engine;
+	};
+}
+
+#endif // Random_hpp
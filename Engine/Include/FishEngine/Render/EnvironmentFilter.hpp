@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../FishEngine.hpp"
+#include "../ReflectClass.hpp"
+#include "../Vector3.hpp"
+#include "SphericalHarmonicsL2.hpp"
+
+#include <array>
+#include <vector>
+
+namespace FishEngine
+{
+	// RGB float cubemap in memory. Faces in CubemapFace order, texel (x, y) of a face is at x + y * size,
+	// y = 0 being the first row given to glTexImage2D.
+	struct FE_EXPORT CubemapImage
+	{
+		int										size = 0;
+		std::array<std::vector<Vector3>, 6>		faces;
+
+		void Resize(int size);
+
+		Vector3 & at(int face, int x, int y)
+		{
+			return faces[face][x + y * size];
+		}
+
+		Vector3 const & at(int face, int x, int y) const
+		{
+			return faces[face][x + y * size];
+		}
+
+		// Bilinear, clamped at the edges of the faces.
+		Vector3 Sample(const Vector3& direction) const;
+	};
+
+
+	// Image based lighting from an environment map, computed on the CPU (import time) on all the cores:
+	//  - specular: mip chain prefiltered with the GGX distribution, mip i for roughness MipRoughness(i),
+	//    looked up with the split sum approximation (EnvBRDF, PreIntegratedGF);
+	//  - diffuse: irradiance as spherical harmonics.
+	// Same conventions as the Monte Carlo reference in Ambient.inc (ImportanceSampleGGX: m = Roughness^2).
+	class FE_EXPORT Meta(NonSerializable) EnvironmentFilter
+	{
+	public:
+		EnvironmentFilter() = delete;
+
+		// Direction (normalized) through the point (x, y) of a face, in texels: (0.5, 0.5) is the center of the first texel.
+		static Vector3 TexelDirection(int face, int size, float x, float y);
+
+		// Solid angle covered by a texel.
+		static float TexelSolidAngle(int size, int x, int y);
+
+		// pixels: width x height, mapped like SkyBox-Panorama.shader.
+		static CubemapImage FromEquirectangular(const Vector3* pixels, int width, int height, int size);
+
+		// Number of mips of the prefiltered chain of a size x size cubemap, the last one is 4x4.
+		static int PrefilteredMipCount(int size);
+
+		// Roughness the mip is prefiltered for: 0 for mip 0 (the source), 1 for the last one.
+		static float MipRoughness(int mip, int mipCount);
+
+		// Filtered importance sampling (Krivanek and Colbert, "Real-time Shading with Filtered Importance Sampling"):
+		// sampleCount GGX samples per texel, read from the mip of the source matching their density.
+		// The size of source must be a power of two.
+		static std::vector<CubemapImage> PrefilterSpecular(const CubemapImage& source, int sampleCount = 256);
+
+		static SphericalHarmonicsL2 ProjectIrradiance(const CubemapImage& source);
+
+		// Replaces the pixels of cubemap with mips (RGBAFloat), uploaded again on next use.
+		// irradiance: the diffuse lighting if mips is a prefiltered chain, nullptr otherwise.
+		static void Apply(const std::vector<CubemapImage>& mips, const SphericalHarmonicsL2* irradiance, Cubemap& cubemap);
+	};
+}
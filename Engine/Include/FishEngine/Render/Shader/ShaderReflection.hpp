@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../../ShaderCompiler.hpp"
+
+namespace FishEngine
+{
+	// Interface of a GLSL stage (uniforms, uniform blocks, vertex inputs), read from its source without a GL context.
+	//
+	// The source goes through a GLSL preprocessor (#define, #if, #ifdef, ..., #line, #error), then the declarations
+	// at global scope are collected. Unlike glGetActiveUniform, unused uniforms are reported too.
+	class FE_EXPORT ShaderReflection
+	{
+	public:
+		struct Variable
+		{
+			std::string	name;
+			std::string	typeName;
+			GLenum		type = 0;		// 0 for structs
+			int			arraySize = 0;	// 0: not an array
+			int			location = -1;	// layout(location = ...), -1 if not set
+		};
+
+		struct Block
+		{
+			std::string				name;
+			std::vector<Variable>	members;
+		};
+
+		std::vector<Variable>			uniforms;
+		std::vector<Block>				blocks;
+		std::vector<Variable>			attributes;		// inputs of the vertex stage
+		std::vector<ShaderDiagnostic>	errors;			// #error, unterminated #if, bad #if expression
+
+		// source: the source of one stage (ShaderCompiler::StageSource)
+		static ShaderReflection Reflect(const std::string& source, ShaderType stage);
+
+		// Adds the uniforms and blocks of another stage of the same program.
+		void Merge(const ShaderReflection& other);
+
+		// One declaration per line, sorted.
+		std::string ToString() const;
+	};
+}
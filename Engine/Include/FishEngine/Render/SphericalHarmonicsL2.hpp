@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../Vector3.hpp"
+
+namespace FishEngine
+{
+	// Diffuse lighting of an environment, projected on the spherical harmonics of the bands 0 to 2 (9 coefficients).
+	//
+	// The coefficients are already convolved with the cosine lobe and divided by PI, and the constants of the basis
+	// are folded in: Evaluate(N) is irradiance(N) / PI, times the diffuse color it gives the radiance of a lambertian
+	// surface. Same layout as AmbientSH in ShaderVariables.inc.
+	struct SphericalHarmonicsL2
+	{
+		// terms: 1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2
+		Vector3 coefficients[9];
+
+		Vector3 Evaluate(const Vector3& n) const
+		{
+			auto const & c = coefficients;
+			return c[0]
+				+ c[1] * n.y + c[2] * n.z + c[3] * n.x
+				+ c[4] * (n.x * n.y) + c[5] * (n.y * n.z) + c[6] * (3.0f * n.z * n.z - 1.0f)
+				+ c[7] * (n.x * n.z) + c[8] * (n.x * n.x - n.y * n.y);
+		}
+	};
+}
@@ -5,6 +5,12 @@
 
 namespace FishEngine
 {
+	enum class RenderQuality
+	{
+		Full,		// QualitySettings::shadowCascades() cascades, filtered (PCF) shadows
+		Preview,	// one cascade, unfiltered shadows; for small views like the camera preview of the scene view
+	};
+
 	class FE_EXPORT Meta(NonSerializable) RenderSystem
 	{
 	public:
@@ -14,8 +20,13 @@ namespace FishEngine
 
 		static void Init();
 
+		// Renders Camera::main() to the current render target, at Screen size.
 		static void Render();
 
+		// Renders camera to the current render target, at width x height.
+		// Preview quality uses its own buffers (created on first use), the main buffers are left untouched.
+		static void Render(CameraPtr const & camera, RenderQuality quality, int width, int height);
+
 		static void Clean();
 
 		static void ResizeBufferSize(const int width, const int height);
@@ -52,6 +52,7 @@ namespace FishEngine
 				m_materials.push_back(material);
 			else
 				m_materials[0] = material;
+			SetDirty();
 		}
 
 		virtual Bounds localBounds() const = 0;
@@ -67,6 +68,7 @@ namespace FishEngine
 		void setEnabled(bool enabled)
 		{
 			m_enabled = enabled;
+			SetDirty();
 		}
 
 		//virtual void OnInspectorGUI() override;
@@ -80,21 +82,83 @@ namespace FishEngine
 		void setShadowCastingMode(ShadowCastingMode shadowCastingMode)
 		{
 			m_shadowCastingMode = shadowCastingMode;
+			SetDirty();
 		}
 		
+		bool receiveShadows() const
+		{
+			return m_receiveShadows;
+		}
+
 		void setReceiveShadows(bool value)
 		{
 			m_receiveShadows = value;
+			SetDirty();
+		}
+
+		// Has this renderer been statically batched with any other renderers?
+		// It is then drawn by its StaticBatch, not on its own.
+		bool isPartOfStaticBatch() const
+		{
+			return m_isPartOfStaticBatch;
+		}
+
+		// The level of detail of the mesh drawn in the last frame, chosen by the RenderSystem from the screen size of
+		// the mesh and QualitySettings::lodErrorThreshold. 0 is the mesh itself.
+		int activeLOD() const
+		{
+			return m_activeLOD;
+		}
+
+		// Beyond distance from the camera, the renderer is drawn as its impostor (ImpostorBaker) instead of its mesh,
+		// and casts the shadow of the coarsest level of detail of the mesh. Perspective cameras only.
+		void setImpostor(ImpostorPtr const & impostor, float distance)
+		{
+			m_impostor = impostor;
+			m_impostorDistance = distance;
+		}
+
+		ImpostorPtr const & impostor() const
+		{
+			return m_impostor;
+		}
+
+		float impostorDistance() const
+		{
+			return m_impostorDistance;
+		}
+
+		// Was the renderer drawn as its impostor in the last frame?
+		bool drawnAsImpostor() const
+		{
+			return m_drawnAsImpostor;
 		}
 
 	protected:
 		friend class FishEditor::Inspector;
 		friend class FishEditor::EditorGUI;
+		friend class StaticBatchingUtility;
+		friend class RenderSystem;
 		bool m_enabled = true;	// Makes the rendered 3D object visible if enabled.
 		std::vector<MaterialPtr> m_materials;
 
 		ShadowCastingMode	m_shadowCastingMode = ShadowCastingMode::On;
 		bool				m_receiveShadows = true;
+
+		Meta(NonSerializable)
+		bool				m_isPartOfStaticBatch = false;
+
+		Meta(NonSerializable)
+		int					m_activeLOD = 0;
+
+		Meta(NonSerializable)
+		ImpostorPtr			m_impostor;
+
+		Meta(NonSerializable)
+		float				m_impostorDistance = 0;
+
+		Meta(NonSerializable)
+		bool				m_drawnAsImpostor = false;
 	};
 }
 
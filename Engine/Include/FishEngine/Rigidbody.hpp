@@ -23,10 +23,14 @@ namespace FishEngine
 		virtual void Start() override;
 		virtual void Update() override;
 		virtual void OnDestroy() override;
+
+		// sync the simulation result before scripts run
+		virtual UpdatePhase updatePhase() const override { return UpdatePhase::EarlyUpdate; }
 	  
 		void setUseGravity(bool value)
 		{
 			m_useGravity = value;
+			SetDirty();
 		}
 		
 		bool useGravity() const
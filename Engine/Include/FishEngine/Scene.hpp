@@ -3,7 +3,9 @@
 
 #include "FishEngine.hpp"
 #include "Bounds.hpp"
+#include "UpdatePhase.hpp"
 #include <utility>
+#include <functional>
 
 namespace FishEngine
 {
@@ -116,6 +118,18 @@ namespace FishEngine
 
 #endif
 	
+	// Changes of the scene hierarchy reported to Scene's hierarchy listeners.
+	enum class HierarchyChange
+	{
+		Created,		// a GameObject was added to the scene
+		Destroyed,		// a GameObject and all its children are about to be removed from the scene
+		Reparented,		// Transform::SetParent, the GameObject is the last child of its new parent (or a root)
+		Renamed,
+		ActiveChanged,	// activeSelf changed
+	};
+
+	typedef std::function<void(HierarchyChange, GameObject*)> HierarchyListener;
+
 	class FE_EXPORT Scene
 	{
 	public:
@@ -128,10 +142,15 @@ namespace FishEngine
 
 		static void Init();
 		static void Start();
+
+		// Starts every new component, in hierarchy order, before the first component of the frame is updated
+		// (a component added during an update is started on the next frame); then updates the components phase
+		// by phase (UpdatePhase), the thread-safe batches on the JobSystem.
 		static void Update();
 		static void Clean();
 		
-		static void RenderShadow(LightPtr const& light);
+		// Renders the shadow map of light for camera, with cascadeCount cascades (at most 4).
+		static void RenderShadow(LightPtr const& light, CameraPtr const& camera, int cascadeCount = 4);
 		static void OnDrawGizmos();
 
 		static GameObjectPtr Find(const std::string& name);
@@ -157,10 +176,14 @@ namespace FishEngine
 			return m_gameObjects;
 		}
 
-		static void AddGameObject(GameObjectPtr const & go)
-		{
-			m_gameObjects.push_back(go);
-		}
+		static void AddGameObject(GameObjectPtr const & go);
+
+		// Listeners are called synchronously, on the thread that changed the hierarchy.
+		// Returns an id for RemoveHierarchyListener.
+		static int AddHierarchyListener(HierarchyListener const & listener);
+		static void RemoveHierarchyListener(int id);
+
+		static void NotifyHierarchyChanged(HierarchyChange change, GameObject* go);
 
 	private:
 		friend class RenderSystem;
@@ -172,9 +195,21 @@ namespace FishEngine
 		static std::vector<ComponentPtr>  m_componentsToBeDestroyed;
 		
 		static Bounds                   m_bounds;
+
+		static std::vector<std::pair<int, HierarchyListener>> s_hierarchyListeners;
+		static int                      s_nextHierarchyListenerID;
+		// > 0 while destroying a hierarchy, which is reported once for its root, and while naming a new GameObject
+		static int                      s_hierarchyNotificationBlock;
 		//static SceneOctree              m_octree;
 
+		// components of active GameObjects in each update phase, rebuilt every frame
+		static std::vector<Component*>  s_updatePhases[static_cast<int>(UpdatePhase::Count)];
+
 		static void UpdateBounds();
+
+		// Updates components of one phase in batches of the same type.
+		// Batches of thread-safe components are updated in parallel, the others serially on the calling thread.
+		static void UpdatePhaseComponents(UpdatePhase phase, std::vector<Component*> & components);
 	};
 }
 
@@ -122,10 +122,13 @@ namespace FishEngine
 		}
 
 		
+		// The archive may replace the reference; archives that can not resolve references leave it as is.
 		template<class T, std::enable_if_t<std::is_base_of<Object, T>::value, int> = 0>
 		InputArchive & operator >> (std::shared_ptr<T> & obj)
 		{
-			DeserializeObject(obj);
+			ObjectPtr value = obj;
+			DeserializeObject(value);
+			obj = std::dynamic_pointer_cast<T>(value);
 			return *this;
 		}
 		
@@ -133,7 +136,9 @@ namespace FishEngine
 		template<class T, std::enable_if_t<std::is_base_of<Object, T>::value, int> = 0>
 		InputArchive & operator >> (std::weak_ptr<T> & obj)
 		{
-			DeserializeWeakObject(obj);
+			std::weak_ptr<Object> value = obj.lock();
+			DeserializeWeakObject(value);
+			obj = std::dynamic_pointer_cast<T>(value.lock());
 			return *this;
 		}
 
@@ -152,7 +157,8 @@ namespace FishEngine
 		{ 
 			NameOfNVP(nvp.name);
 			MiddleOfNVP();
-			DeserializeObject(nvp.value);
+			ObjectPtr value = nvp.value;	// const, can not be replaced
+			DeserializeObject(value);
 			EndNVP();
 			return *this;
 		}
@@ -230,8 +236,8 @@ namespace FishEngine
 		//virtual void Serialize(const char* t) { m_istream >> t; }
 		//virtual void Serialize(std::nullptr_t const & t) { }
 
-		virtual void DeserializeObject(ObjectPtr const & obj) = 0;
-		virtual void DeserializeWeakObject(std::weak_ptr<Object> const & obj) = 0;
+		virtual void DeserializeObject(ObjectPtr & obj) = 0;
+		virtual void DeserializeWeakObject(std::weak_ptr<Object> & obj) = 0;
 		
 		//virtual std::size_t GetSizeTag() = 0;
 
@@ -125,7 +125,7 @@ namespace FishEngine
 		virtual void Deserialize(bool & t) override { Convert(CurrentNode(), t); }
 		virtual void Deserialize(std::string & t) override { Convert(CurrentNode(), t); }
 
-		virtual void DeserializeObject(FishEngine::ObjectPtr const & obj) override
+		virtual void DeserializeObject(FishEngine::ObjectPtr & obj) override
 		{
 			//obj->Deserialize(*this);
 			auto const & current = CurrentNode();
@@ -134,7 +134,7 @@ namespace FishEngine
 			LogWarning(Format("fileID %1%", fileID));
 		}
 
-		virtual void DeserializeWeakObject(std::weak_ptr<FishEngine::Object> const & obj) override
+		virtual void DeserializeWeakObject(std::weak_ptr<FishEngine::Object> & obj) override
 		{
 
 		}
@@ -85,6 +85,11 @@ namespace FishEngine
 			return m_deferred;
 		}
 
+		Cullface cullface() const
+		{
+			return m_cullface;
+		}
+
 		bool IsKeywordEnabled(ShaderKeyword keyword)
 		{
 			return (m_keywords & static_cast<ShaderKeywords>(keyword)) != 0;
@@ -98,6 +103,23 @@ namespace FishEngine
 
 		int renderQueue();
 
+		// Warm-up (ShaderWarmUp): the variant is compiled before it is first drawn.
+		// Starts compiling the variant without waiting for the driver. Returns false if it is compiled or started already, or if
+		// its source can not be preprocessed (logged).
+		bool StartCompileVariant(ShaderKeywords keywords);
+
+		// False while the driver compiles the started variant in the background (GL_KHR_parallel_shader_compile only).
+		bool IsVariantReady(ShaderKeywords keywords) const;
+
+		// Waits for the started variant and keeps it. Returns false if it does not compile, the errors are logged.
+		bool FinishCompileVariant(ShaderKeywords keywords);
+
+		// The variants compiled when they were first drawn, and the time the frames waited for them, since the start or
+		// the last ResetDrawTimeCompileStatistics.
+		static uint32_t drawTimeCompileCount();
+		static float drawTimeCompileMilliseconds();
+		static void ResetDrawTimeCompileStatistics();
+
 		bool IsValid();
 
 		static ShaderPtr Find(const std::string & name);
@@ -115,6 +137,9 @@ namespace FishEngine
 
 		void PrintErrorMessage(std::string const & errorMessage) noexcept;
 
+		// m_GLNativeProgram and m_uniforms for m_keywords, compiled if needed.
+		void SelectVariant();
+
 		// cache
 		Meta(NonSerializable)
 		unsigned int m_GLNativeProgram = 0;
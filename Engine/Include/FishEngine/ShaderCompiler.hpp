@@ -3,6 +3,7 @@
 #include "FishEngine.hpp"
 #include "Resources.hpp"
 #include "Macro.hpp"
+#include "ShaderProperty.hpp"
 #include "Render/Shader/ShaderBlendFactor.hpp"
 #include "Render/Shader/ShaderLabProperties.hpp"
 
@@ -28,6 +29,14 @@ namespace FishEngine
 		FileNotExist,
 	};
 
+	// A message of the GLSL compiler, located in the original shader files.
+	struct ShaderDiagnostic
+	{
+		Path		file;		// empty for the lines generated by the engine (#version, #define)
+		int			line = 0;
+		std::string	message;
+	};
+
 	class FE_EXPORT Meta(NonSerializable) ShaderCompiler
 	{
 	public:
@@ -65,19 +74,46 @@ namespace FishEngine
 			s_shaderIncludeDir = path;
 		}
 
+		// The GLSL source of one stage of a keyword variant of a preprocessed shader.
+		static std::string StageSource(
+			const std::string&  preprocessed,
+			ShaderType          stage,
+			ShaderKeywords      keywords);
+
+		// Every combination of the keywords a shader can be compiled with (ShaderKeyword::All).
+		static std::vector<ShaderKeywords> KeywordVariants();
+
+		// The macro StageSource defines for each keyword (ShaderKeyword::AmbientIBL: _AMBIENT_IBL).
+		static std::vector<std::pair<ShaderKeyword, std::string>> const & KeywordDefines();
+
+		// The preprocessed text keeps the lines of the files it comes from with "#line line file" directives,
+		// file being the index of the file (0: code generated by the engine).
+		static Path SourcePath(int fileIndex);
+
+		// Locates the messages of a GLSL compiler log ("ERROR: file:line: ..." or "file(line) : error ...")
+		// in the original files. Lines without a location are kept with an empty file.
+		static std::vector<ShaderDiagnostic> MapDiagnostics(const std::string& log);
+
 	private:
 
 		std::string PreprocessShaderFile(const Path& path);
 
+		// firstLine: line number of the first line of shaderText in the file fileIndex
 		std::string PreprocessImpl(
 			const std::string&  shaderText,
-			const Path&         localDir);
+			const Path&         localDir,
+			int                 fileIndex,
+			int                 firstLine);
 
 		std::string parseSubShader(
 			const std::string&  shaderText,
 			size_t&             cursor,
 			const std::string&  str,
-			const Path&         localDir);
+			const Path&         localDir,
+			int                 fileIndex,
+			int                 firstLine);
+
+		static int SourceIndex(const Path& path);
 
 		friend class FishEditor::EditorResources;
 		static Path s_shaderIncludeDir;
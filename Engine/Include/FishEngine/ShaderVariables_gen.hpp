@@ -79,6 +79,10 @@ struct LightingUniforms
 	vec4 fish_LightShadowBias;
 	//mat4 LightMatrix; // World-to-light matrix. Used to sample cookie & attenuation textures.
 	mat4 LightMatrix[4];
+
+	// prefiltered RenderSettings::ambientCubemap (EnvironmentFilter)
+	vec4 AmbientSH[9];				// irradiance / PI, .w not used, see SphericalHarmonicsL2
+	vec4 AmbientCubemapParams;		// x = mip count of AmbientCubemap, 0 if it is not prefiltered
 };
 
 
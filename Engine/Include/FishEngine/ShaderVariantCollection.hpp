@@ -0,0 +1,172 @@
+#ifndef ShaderVariantCollection_hpp
+#define ShaderVariantCollection_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "ShaderProperty.hpp"
+#include "Path.hpp"
+
+#include <set>
+
+namespace FishEngine
+{
+	// A keyword variant of a shader, the shader being known by its name.
+	struct ShaderVariant
+	{
+		std::string		shader;
+		ShaderKeywords	keywords;
+
+		bool operator<(ShaderVariant const & rhs) const
+		{
+			return shader < rhs.shader || (shader == rhs.shader && keywords < rhs.keywords);
+		}
+
+		bool operator==(ShaderVariant const & rhs) const
+		{
+			return shader == rhs.shader && keywords == rhs.keywords;
+		}
+	};
+
+	// A set of shader variants, to be compiled at load time (ShaderWarmUp) rather than when they are first drawn.
+	//
+	// The variants used during a play session are recorded (StartRecording) and merged into the collection of the
+	// project, the text file Assets/ShaderVariants.shadervariants: one variant per line, the name of the shader then
+	// the macros of its keywords (ShaderCompiler::KeywordDefines), separated by tabs.
+	class FE_EXPORT Meta(NonSerializable) ShaderVariantCollection
+	{
+	public:
+		bool Add(std::string const & shader, ShaderKeywords keywords)
+		{
+			return m_variants.insert({ shader, keywords }).second;
+		}
+
+		bool Contains(std::string const & shader, ShaderKeywords keywords) const
+		{
+			return m_variants.count({ shader, keywords }) > 0;
+		}
+
+		// Adds the variants of other. Returns the number of variants added.
+		uint32_t Merge(ShaderVariantCollection const & other);
+
+		void Clear()
+		{
+			m_variants.clear();
+		}
+
+		uint32_t size() const
+		{
+			return static_cast<uint32_t>(m_variants.size());
+		}
+
+		std::set<ShaderVariant> const & variants() const
+		{
+			return m_variants;
+		}
+
+		// Adds the variants of the text. Unknown keywords are skipped with a warning.
+		void Parse(std::string const & text);
+		std::string ToString() const;
+
+		// Load merges the variants of the file. Both return false if the file can not be opened.
+		bool Load(Path const & path);
+		bool Save(Path const & path) const;
+
+		// Assets/ShaderVariants.shadervariants
+		static Path ProjectCollectionPath();
+
+		// Every variant selected by a Shader (drawn, or made current by a keyword) is added to recorded().
+		static void StartRecording();
+		static void StopRecording();
+
+		static bool isRecording()
+		{
+			return s_recording;
+		}
+
+		static ShaderVariantCollection const & recorded()
+		{
+			return s_recorded;
+		}
+
+		// Called by Shader when it selects a variant.
+		static void Record(std::string const & shader, ShaderKeywords keywords)
+		{
+			if (s_recording && !shader.empty())
+				s_recorded.Add(shader, keywords);
+		}
+
+	private:
+		std::set<ShaderVariant> m_variants;
+
+		static bool s_recording;
+		static ShaderVariantCollection s_recorded;
+	};
+
+
+	// Compiles the variants of a collection that are not compiled yet, at load time behind a loading screen:
+	//     ShaderWarmUp warmUp(collection);
+	//     while (!warmUp.Update(8)) { /* draw the loading screen, warmUp.progress() */ }
+	// With GL_KHR_parallel_shader_compile (or ARB) all the variants are submitted at once and the driver compiles them
+	// on its threads; Update only collects the finished ones. Otherwise they are compiled one after the other, as
+	// many as fit in the time given to each Update, so that the loading screen keeps being drawn.
+	// The shaders are looked up by name among the loaded ones; the variants of the other shaders are skipped.
+	class FE_EXPORT Meta(NonSerializable) ShaderWarmUp
+	{
+	public:
+		explicit ShaderWarmUp(ShaderVariantCollection const & collection);
+
+		// Works for about maxMilliseconds (at least one variant without the extension). Returns true when done.
+		bool Update(float maxMilliseconds);
+
+		// Compiles everything left, blocking.
+		void Finish();
+
+		bool done() const
+		{
+			return m_finished == m_jobs.size();
+		}
+
+		float progress() const
+		{
+			return m_jobs.empty() ? 1.0f : static_cast<float>(m_finished) / m_jobs.size();
+		}
+
+		uint32_t variantCount() const
+		{
+			return static_cast<uint32_t>(m_jobs.size());
+		}
+
+		// Variants that do not compile.
+		uint32_t failedCount() const
+		{
+			return m_failed;
+		}
+
+		// Variants whose shader is not loaded.
+		uint32_t missingCount() const
+		{
+			return m_missing;
+		}
+
+		static bool parallelCompileSupported();
+
+	private:
+		struct Job
+		{
+			ShaderPtr		shader;
+			ShaderKeywords	keywords;
+			bool			finished = false;
+		};
+
+		void Finish(Job & job);
+
+		std::vector<Job>	m_jobs;
+		bool				m_parallel = false;
+		size_t				m_finished = 0;
+		size_t				m_next = 0;		// without the extension: the next job to compile
+		uint32_t			m_failed = 0;
+		uint32_t			m_missing = 0;
+	};
+}
+
+#endif // ShaderVariantCollection_hpp
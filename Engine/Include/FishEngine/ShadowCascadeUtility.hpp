@@ -0,0 +1,73 @@
+#ifndef ShadowCascadeUtility_hpp
+#define ShadowCascadeUtility_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "Bounds.hpp"
+#include "Vector2.hpp"
+#include "Matrix4x4.hpp"
+
+#include <vector>
+
+namespace FishEngine
+{
+	// Fitting of the cascades of a directional light to the scene (Scene::RenderShadow).
+	//
+	// The split distances divide the depth range where the camera sees shadow receivers, blending uniform and
+	// logarithmic splits. The shadow map of a cascade covers, in the plane of the light, the receivers inside its
+	// split of the view frustum rather than the whole split; its depth range goes from the casters in front of them
+	// to the farthest of them.
+	//
+	// Light space is the world rotated so that +z is the direction of the light, without translation: the
+	// rectangles of the cascades are snapped to texels in it, and their sizes are quantized, so that the shadow maps do
+	// not shimmer when the camera moves.
+	class FE_EXPORT Meta(NonSerializable) ShadowCascadeUtility
+	{
+	public:
+		ShadowCascadeUtility() = delete;
+
+		// 0: uniform splits, 1: logarithmic splits.
+		static constexpr float SplitLambda = 0.75f;
+
+		// The smallest depth range of a cascade, in world units.
+		static constexpr float MinDepthRange = 0.01f;
+
+		// The sizes of the cascades are rounded up to 2^(k/SizeStepsPerOctave).
+		static constexpr float SizeStepsPerOctave = 4;
+
+		struct Cascade
+		{
+			Matrix4x4	view;			// world to light
+			Matrix4x4	projection;
+			Vector2		min;			// the rectangle of the shadow map, light space
+			Vector2		max;
+			float		near = 0;		// the depth range of the shadow map, light space
+			float		far = 0;
+		};
+
+		// The cascades cover [near, far]: splits[0] = near, splits[cascadeCount] = far.
+		static void ComputeSplits(float near, float far, int cascadeCount, float lambda, float splits[5]);
+
+		// The light space of a light shining along direction (normalized).
+		static Matrix4x4 WorldToLight(Vector3 const & direction);
+
+		// The axis aligned box containing bounds transformed by matrix (affine).
+		static Bounds TransformBounds(Matrix4x4 const & matrix, Bounds const & bounds);
+
+		// The view space depth range of the bounds of the receivers (worldToCamera: the camera looks along +z),
+		// clamped to [near, far]. Returns false if there is no receiver in the range.
+		static bool VisibleDepthRange(Matrix4x4 const & worldToCamera, std::vector<Bounds> const & receivers,
+			float near, float far, float & minDepth, float & maxDepth);
+
+		// The side of the shadow map, rounded up to the next size step.
+		static float QuantizeSize(float size);
+
+		// Fits the cascade of a split of the view frustum.
+		// corners: the 8 corners of the split, world space. receivers, casters: bounds in light space.
+		// Without receiver in the split, the cascade covers the whole split.
+		static Cascade FitCascade(Matrix4x4 const & worldToLight, const Vector3 corners[8], std::vector<Bounds> const & receivers,
+			std::vector<Bounds> const & casters, int resolution);
+	};
+}
+
+#endif // ShadowCascadeUtility_hpp
@@ -17,6 +17,10 @@ namespace FishEngine
 
 		virtual void Update() override;
 
+		// the matrix palette is built from the final bone transforms
+		virtual UpdatePhase updatePhase() const override { return UpdatePhase::PreRender; }
+		virtual bool isUpdateThreadSafe() const override { return true; }
+
 		//virtual void PreRender() const override;
 		//virtual void Render() const override;
 
@@ -0,0 +1,66 @@
+#ifndef StaticBatchingUtility_hpp
+#define StaticBatchingUtility_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+#include "Bounds.hpp"
+#include "Mesh.hpp"
+
+namespace FishEngine
+{
+	// The triangles of one submesh of one renderer in a StaticBatch.
+	struct StaticBatchRange
+	{
+		RendererPtr		renderer;
+		IndexRange		indices;
+		Bounds			bounds;		// world space
+	};
+
+	// Geometry of static renderers sharing one material, merged in one Mesh in world space.
+	// The ranges of the renderers are kept: they are culled one by one, and the visible ones are drawn with one
+	// glMultiDrawElements.
+	struct FE_EXPORT StaticBatch
+	{
+		MaterialPtr						material;
+		MeshPtr							mesh;
+		std::vector<StaticBatchRange>	ranges;
+
+		// Draws the ranges of the enabled and active renderers with material.
+		// planes: frustum (GeometryUtility::CalculateFrustumPlanes), the ranges outside are skipped; nullptr: no culling.
+		// shadowCasters: only the ranges of the renderers casting shadows.
+		// The vertices are in world space: the per draw uniforms must be set with the identity matrix.
+		// Returns the number of ranges drawn, adjacent ranges counting as one.
+		int Draw(MaterialPtr const & material, const Vector4* planes, bool shadowCasters = false) const;
+
+		// The ranges Draw draws, adjacent ranges merged.
+		std::vector<IndexRange> VisibleRanges(const Vector4* planes, bool shadowCasters = false) const;
+	};
+
+	// Static batching: the MeshRenderers of the static GameObjects (GameObject::isStatic) are combined by material,
+	// so that the static scenery costs one draw call per material instead of one per renderer and material.
+	//
+	// Combine is done once, when the scene is loaded (entering play mode): the renderers must not move any more, and
+	// their materials are not looked up again. A batched renderer can still be disabled or deactivated.
+	// Not batched: transparent materials (they need sorting), negative scales (the winding and the tangent frame flip),
+	// skinned meshes.
+	class FE_EXPORT Meta(NonSerializable) StaticBatchingUtility
+	{
+	public:
+		StaticBatchingUtility() = delete;
+
+		// Combines the static GameObjects in the hierarchy of staticBatchRoot, nullptr: the whole scene.
+		static void Combine(GameObjectPtr const & staticBatchRoot = nullptr);
+
+		// Releases the batches, their renderers are drawn on their own again.
+		static void Clear();
+
+		static std::vector<StaticBatch> const & batches();
+
+		// Appends the triangles indices of source to destination (m_vertices, m_normals, m_uv, m_tangents,
+		// m_triangles), with only the vertices they use, transformed by localToWorld.
+		// Returns the range of the appended triangles in destination.m_triangles (renderer not set).
+		static StaticBatchRange Append(Mesh & destination, Mesh const & source, IndexRange indices, const Matrix4x4& localToWorld);
+	};
+}
+
+#endif // StaticBatchingUtility_hpp
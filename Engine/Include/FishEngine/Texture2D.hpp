@@ -14,6 +14,8 @@ namespace FishEngine
 
 		Texture2D(int width, int height, TextureFormat format, const uint8_t* data, int byteCount = -1);
 
+		virtual ~Texture2D();
+
 		// The format of the pixel data in the texture (Read Only).
 		TextureFormat format() const
 		{
@@ -36,10 +38,15 @@ namespace FishEngine
 
 		virtual void UploadToGPU() override;
 
+		// The GL texture, with its mipmaps, level 0 copied from pixels: system memory, or an offset in the bound
+		// pixel unpack buffer.
+		void CreateNativeTexture(const void* pixels);
+
 	protected:
 
 		friend class FishEditor::TextureImporter;
 		friend class FishEditor::DDSImporter;
+		friend class UploadQueue;
 
 		Meta(NonSerializable)
 		std::vector<std::uint8_t> m_data;
@@ -50,6 +57,10 @@ namespace FishEngine
 		// How many mipmap levels are in this texture (Read Only).
 		uint32_t m_mipmapCount;
 
+		// In the UploadQueue: drawn as whiteTexture() until uploaded.
+		Meta(NonSerializable)
+		bool m_uploadQueued = false;
+
 		
 	};
 }
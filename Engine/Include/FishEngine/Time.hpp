@@ -36,6 +36,7 @@ namespace FishEngine
 	private:
 		friend class RenderSystem;
 		friend class GameLoop;
+		friend class FrameRecorder;
 		friend class FishEditor::MainEditor;
 
 		static float m_deltaTime;
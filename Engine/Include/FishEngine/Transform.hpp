@@ -24,6 +24,11 @@ namespace FishEngine
 		Transform();
 
 		~Transform();
+
+		virtual void OnValidate() override
+		{
+			MakeDirty();
+		}
 		
 		// The position of the transform in world space.
 		Vector3 position() const
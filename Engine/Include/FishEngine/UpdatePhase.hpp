@@ -0,0 +1,17 @@
+#pragma once
+
+namespace FishEngine
+{
+	// The phases of Scene::Update, in execution order.
+	// In each phase components are updated in batches of the same type.
+	enum class UpdatePhase
+	{
+		EarlyUpdate,	// e.g. sync transforms from physics
+		Update,			// scripts
+		Animation,		// write bone transforms
+		LateUpdate,		// Script::LateUpdate
+		PreRender,		// e.g. skinning matrix palettes, reads final transforms
+
+		Count,
+	};
+}
@@ -0,0 +1,123 @@
+#ifndef UploadQueue_hpp
+#define UploadQueue_hpp
+
+#include "FishEngine.hpp"
+#include "ReflectClass.hpp"
+
+#include <deque>
+
+namespace FishEngine
+{
+	// Sub-allocation of a ring of bytes [0, capacity): blocks are allocated at the head one after the other, and
+	// released at the tail in the same order once the GPU has read them.
+	// A block is retired with the fence after the copy that reads it (0: read already); Release frees, from the tail,
+	// the retired blocks whose fence is passed. A block retired late holds back the blocks allocated after it.
+	class FE_EXPORT Meta(NonSerializable) StagingRing
+	{
+	public:
+		static constexpr uint32_t InvalidOffset = UINT32_MAX;
+
+		struct Allocation
+		{
+			uint32_t	offset = InvalidOffset;
+			uint64_t	id = 0;
+		};
+
+		explicit StagingRing(uint32_t capacity = 0);
+
+		// A block of size bytes at a multiple of alignment (power of 2). Blocks do not wrap: the end of the ring is
+		// skipped instead. offset is InvalidOffset if the free space is too small. size > 0.
+		Allocation Allocate(uint32_t size, uint32_t alignment);
+
+		// id: returned by Allocate. The block can be reused once fence is passed.
+		void Retire(uint64_t id, uint64_t fence);
+
+		// The fences up to completedFence are passed.
+		void Release(uint64_t completedFence);
+
+		uint32_t capacity() const
+		{
+			return m_capacity;
+		}
+
+		// The bytes of the blocks not released yet, skipped ends of the ring included.
+		uint32_t used() const
+		{
+			return m_used;
+		}
+
+		// The blocks not released yet.
+		uint32_t blockCount() const
+		{
+			return static_cast<uint32_t>(m_blocks.size());
+		}
+
+	private:
+		struct Block
+		{
+			uint32_t	start;		// the head before the allocation
+			uint32_t	size;		// from start, the skipped end of the ring and the alignment included
+			uint64_t	fence;
+			bool		retired;
+		};
+
+		uint32_t m_capacity = 0;
+		uint32_t m_head = 0;
+		uint32_t m_used = 0;
+		uint64_t m_firstId = 0;			// the id of m_blocks.front()
+		std::deque<Block> m_blocks;		// in the order of allocation
+	};
+
+
+	// Uploads of textures and static meshes spread over the frames, so that loading them does not stall a frame.
+	// Any thread copies the pixels of a texture, or the vertices of a mesh interleaved as in its GeometryPool, into a
+	// staging ring. Once per frame the main thread issues the GL copies from the ring, in order, up to a budget of
+	// bytes.
+	//
+	// With GL_ARB_buffer_storage (GL 4.4) the ring is a buffer mapped persistently: the textures are copied from it
+	// as a pixel unpack buffer and the meshes with glCopyBufferSubData, and its blocks are reused once the fence of
+	// the frame of their copy is passed. Without (GL 4.1, macOS) the ring is in system memory: the driver copies the
+	// data when the copy is issued, and its blocks are reused at once.
+	//
+	// Until its copy is issued a texture is drawn as Texture2D::whiteTexture() and a mesh is not drawn. Enqueue them
+	// before they are drawn: a texture or mesh drawn first is uploaded when drawn, as without the queue.
+	class FE_EXPORT Meta(NonSerializable) UploadQueue
+	{
+	public:
+		UploadQueue() = delete;
+
+		static constexpr uint32_t RingCapacity = 64 << 20;
+		static constexpr uint32_t DefaultBytesPerFrame = 4 << 20;
+		static constexpr uint32_t Alignment = 16;
+
+		// Main thread, with the GL context (RenderSystem::Init).
+		static void Init();
+
+		// Any thread. Returns false if the data is larger than the free space of the ring, or if the texture or mesh
+		// is uploaded or queued already; it is then uploaded when first drawn.
+		static bool Enqueue(Texture2DPtr const & texture);
+
+		// Static meshes only (GeometryPool); returns false for skinned meshes.
+		static bool Enqueue(MeshPtr const & mesh);
+
+		// Main thread, once per frame (RenderSystem::Render): reuses the blocks of the ring whose copies are done,
+		// then issues the copies of the queue, in order, until bytesPerFrame. The first one is issued even if larger.
+		static void Update();
+
+		// Main thread: issues all the copies of the queue.
+		static void Flush();
+
+		static uint32_t bytesPerFrame();
+		static void setBytesPerFrame(uint32_t bytes);
+
+		// The textures and meshes enqueued whose copies are not issued yet.
+		static uint32_t queuedCount();
+
+		static bool persistentMappingSupported();
+
+	private:
+		static void Issue(uint64_t maxBytes);
+	};
+}
+
+#endif // UploadQueue_hpp
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <FishEngine/ReflectClass.hpp>
+#include <string>
 
 struct GLFWwindow;
 
@@ -11,22 +12,54 @@ namespace FishEngine
 
 	public:
 		FE_EXPORT int Run();
+
+		// Run, with the options of the command line:
+		//   --record <path>   records the frames into path (FrameRecorder)
+		//   --replay <path>   replays the recording path without a window (RunReplay)
+		FE_EXPORT int Run(int argc, char* argv[]);
+
+		// Replays a FrameRecorder log without a window and checks it for divergence.
+		// Returns 0 if every frame matched the recording.
+		FE_EXPORT int RunReplay(std::string const & recordingPath);
 		FE_EXPORT virtual void Init() = 0;
 		FE_EXPORT virtual void Update() = 0;
 		//virtual void Render() = 0;
 
 	protected:
+		// The startup shared by Run and RunReplay, which must create the same scene: Init, the physics, Start, then
+		// Init again. A recording or a replay is started before: PhysicsSystem::Init makes the simulation
+		// deterministic only for them.
+		void StartScene();
+
+		// The simulation of one frame, without the rendering: Scene::Update and the physics, between the
+		// FrameRecorder::BeginFrame and EndFrame. Returns false at the end of a replay.
+		static bool SimulateFrame(float deltaTime);
+
+		// Hides and holds the cursor as Input::cursorLocked asks, before the events of the frame are polled.
+		static void ApplyCursorLock();
+
 		// GLFW callback
 		static void KeyCallBack(GLFWwindow* window, int key, int scancode, int action, int mods);
 		static void MouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
 		static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 		static void WindowSizeCallback(GLFWwindow* window, int width, int height);
-		//static void MouseCallback(GLFWwindow* window, double xpos, double ypos);
+		static void MouseCallback(GLFWwindow* window, double xpos, double ypos);
 		//static void CharacterCallback(GLFWwindow* window, unsigned int codepoint);
 
 	private:
+		// Compiles the variants of the shader variant collection of the project behind a progress bar.
+		static void WarmUpShaders();
+
+		// --record: the frames of Run are recorded into it, if not empty.
+		std::string m_recordingPath;
+
 		static GLFWwindow*     m_window;
 		static int      m_windowWidth;
 		static int      m_windowHeight;
+
+		// the last virtual position of the disabled cursor, in pixels (MouseCallback)
+		static double   m_cursorX;
+		static double   m_cursorY;
+		static bool     m_cursorValid;
 	};
 }
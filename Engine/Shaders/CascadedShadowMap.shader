@@ -78,6 +78,10 @@ struct VS_OUT {
 
 	void main()
 	{
+		// cascade not used (QualitySettings::shadowCascades, preview rendering)
+		if (CascadesSplitPlaneFar[gl_InvocationID] <= CascadesSplitPlaneNear[gl_InvocationID])
+			return;
+
 		for (int i = 0; i < gl_in.length(); ++i)
 		{
 		#ifdef SHOWMAP_NO_BIAS
@@ -38,6 +38,9 @@ struct V2F
 	in V2F v2f;
 	out float OutShadow;
 
+	// 1: PCF filtering, 0: one tap (preview quality)
+	uniform float ShadowPCF;
+
 
 	void main()
 	{
@@ -45,6 +48,6 @@ struct V2F
 		float SceneDepth = CalcSceneDepth(v2f.UV);
 		float z = dot(CameraVector, WorldSpaceCameraDir.xyz);
 		vec3 WorldPosition = CameraVector * (SceneDepth / z) + WorldSpaceCameraPos.xyz;
-		OutShadow = CalcShadowTerm(vec4(WorldPosition, 1), SceneDepth);
+		OutShadow = CalcShadowTerm(vec4(WorldPosition, 1), SceneDepth, ShadowPCF > 0.5);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+// Draws the instances of an impostor (Impostor::DrawInstances): one camera facing quad per instance, 4 vertices of a
+// triangle strip. The mapping of the frames is the one of ImpostorUtility, they must be changed together.
+
+@cull off
+
+struct V2F
+{
+	vec3 WorldPosition;
+};
+
+uniform float FramesPerSide = 8;
+uniform float FrameResolution = 128;
+uniform float Hemisphere = 1;
+
+vec2 SignNotZero(vec2 v)
+{
+	return vec2(v.x >= 0 ? 1.0 : -1.0, v.y >= 0 ? 1.0 : -1.0);
+}
+
+vec3 QuaternionRotate(vec4 q, vec3 v)
+{
+	return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// ImpostorUtility::FrameDirection
+vec3 FrameDirection(vec2 frame)
+{
+	vec2 p = frame * (2.0 / (FramesPerSide - 1)) - 1;
+	vec3 d;
+	if (Hemisphere > 0.5)
+	{
+		float x = 0.5 * (p.x + p.y);
+		float z = 0.5 * (p.x - p.y);
+		d = vec3(x, 1 - abs(x) - abs(z), z);
+	}
+	else
+	{
+		d = vec3(p.x, 1 - abs(p.x) - abs(p.y), p.y);
+		if (d.y < 0)
+			d.xz = (1 - abs(p.yx)) * SignNotZero(p);
+	}
+	return normalize(d);
+}
+
+@vertex
+{
+	#include <CG.inc>
+
+	layout (location = 0) in vec4 InstanceCenterRadius;	// world space
+	layout (location = 1) in vec4 InstanceRotation;
+
+	out V2F v2f;
+	flat out vec4 CenterRadius;
+	flat out vec4 Rotation;
+	flat out vec2 Frame0;
+	flat out vec2 Frame1;
+	flat out vec2 Frame2;
+	flat out vec3 Weights;
+
+	void main()
+	{
+		vec3 center = InstanceCenterRadius.xyz;
+		float radius = InstanceCenterRadius.w;
+		vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2 - 1;
+		vec3 position = center + (MATRIX_I_V[0].xyz * corner.x + MATRIX_I_V[1].xyz * corner.y) * radius;
+		v2f.WorldPosition = position;
+		gl_Position = MATRIX_VP * vec4(position, 1);
+		CenterRadius = InstanceCenterRadius;
+		Rotation = InstanceRotation;
+
+		// ImpostorUtility::BlendFrames, once per instance
+		vec3 eye = QuaternionRotate(vec4(-InstanceRotation.xyz, InstanceRotation.w), WorldSpaceCameraPos.xyz - center);
+		vec3 d = eye / (abs(eye.x) + abs(eye.y) + abs(eye.z));
+		vec2 p;
+		if (Hemisphere > 0.5)
+		{
+			d.y = max(d.y, 0);
+			if (d == vec3(0))
+				d.y = 1;
+			d /= abs(d.x) + abs(d.y) + abs(d.z);
+			p = vec2(d.x + d.z, d.x - d.z);
+		}
+		else
+		{
+			p = d.y >= 0 ? d.xz : (1 - abs(d.zx)) * SignNotZero(d.xz);
+		}
+		float last = FramesPerSide - 1;
+		vec2 g = clamp((p * 0.5 + 0.5) * last, 0, last);
+		vec2 c = min(floor(g), vec2(last - 1));
+		vec2 f = g - c;
+		Frame0 = c;
+		Frame1 = c + 1;
+		if (f.x >= f.y)
+		{
+			Frame2 = c + vec2(1, 0);
+			Weights = vec3(1 - f.x, f.y, f.x - f.y);
+		}
+		else
+		{
+			Frame2 = c + vec2(0, 1);
+			Weights = vec3(1 - f.y, f.x, f.y - f.x);
+		}
+	}
+}
+
+@fragment
+{
+	#include <CG.inc>
+
+	uniform sampler2D AlbedoAtlas;	// premultiplied by the coverage (a)
+	uniform sampler2D NormalAtlas;	// premultiplied by the coverage (a)
+	uniform sampler2D DepthAtlas;	// r: depth * coverage, g: coverage
+
+	in V2F v2f;
+	flat in vec4 CenterRadius;
+	flat in vec4 Rotation;
+	flat in vec2 Frame0;
+	flat in vec2 Frame1;
+	flat in vec2 Frame2;
+	flat in vec3 Weights;
+
+	out vec4 color;
+
+	// ImpostorUtility::FrameBasis
+	void FrameBasis(vec3 d, out vec3 right, out vec3 up)
+	{
+		vec3 forward = -d;
+		vec3 reference = abs(d.y) > 0.999 ? vec3(0, 0, 1) : vec3(0, 1, 0);
+		right = normalize(cross(reference, forward));
+		up = cross(forward, right);
+	}
+
+	// The texels of the frame on the ray from eye through point (normalized space), zero if the ray misses the frame.
+	// No branch around the fetches: the mip level comes from the derivatives of the atlas coordinates.
+	void SampleFrame(vec2 frame, vec3 eye, vec3 point, out vec4 albedo, out vec4 normal, out vec3 position)
+	{
+		vec3 d = FrameDirection(frame);
+		vec3 ray = point - eye;
+		float denominator = dot(ray, d);
+		float parallel = abs(denominator) < 1e-6 ? 1.0 : 0.0;
+		denominator = parallel > 0 ? 1e-6 : denominator;
+		vec3 hit = eye - ray * (dot(eye, d) / denominator);		// ImpostorUtility::ProjectToFrame
+		vec3 right, up;
+		FrameBasis(d, right, up);
+		vec2 uv = vec2(dot(hit, right), dot(hit, up)) * 0.5 + 0.5;
+		float inside = all(greaterThanEqual(uv, vec2(0))) && all(lessThanEqual(uv, vec2(1))) ? 1.0 - parallel : 0.0;
+
+		float margin = 0.5 / FrameResolution;		// ImpostorUtility::AtlasUV
+		vec2 atlasUV = (frame + clamp(uv, margin, 1 - margin)) / FramesPerSide;
+		albedo = texture(AlbedoAtlas, atlasUV) * inside;
+		normal = texture(NormalAtlas, atlasUV) * inside;
+		vec2 depth = texture(DepthAtlas, atlasUV).rg;
+		float z = depth.g > 0 ? depth.r / depth.g : 1;
+		position = right * (uv.x * 2 - 1) + up * (uv.y * 2 - 1) - d * (z * 2 - 1);	// ImpostorUtility::FramePoint
+	}
+
+	void main()
+	{
+		vec3 center = CenterRadius.xyz;
+		float radius = CenterRadius.w;
+		vec4 inverseRotation = vec4(-Rotation.xyz, Rotation.w);
+		vec3 eye = QuaternionRotate(inverseRotation, WorldSpaceCameraPos.xyz - center) / radius;
+		vec3 point = QuaternionRotate(inverseRotation, v2f.WorldPosition - center) / radius;
+
+		vec2 frames[3] = vec2[3](Frame0, Frame1, Frame2);
+		float weights[3] = float[3](Weights.x, Weights.y, Weights.z);
+		vec4 albedo = vec4(0);
+		vec4 normal = vec4(0);
+		vec3 position = vec3(0);
+		for (int i = 0; i < 3; ++i)
+		{
+			vec4 a, n;
+			vec3 p;
+			SampleFrame(frames[i], eye, point, a, n, p);
+			albedo += weights[i] * a;
+			normal += weights[i] * n;
+			position += weights[i] * a.a * p;
+		}
+		if (albedo.a < 0.5)
+			discard;
+
+		vec3 N = normalize(QuaternionRotate(Rotation, normal.rgb / normal.a * 2 - 1));
+		vec3 worldPosition = center + QuaternionRotate(Rotation, position / albedo.a * radius);
+		vec3 L = normalize(WorldSpaceLightDir(worldPosition));
+		color = vec4(albedo.rgb / albedo.a * LightColor.rgb * clamp(dot(N, L), 0, 1), 1);
+
+		// depth offset: the depth of the baked surface rather than of the quad
+		vec4 clip = MATRIX_VP * vec4(worldPosition, 1);
+		gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+	}
+}
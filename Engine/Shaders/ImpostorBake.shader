@@ -0,0 +1,50 @@
+// Renders a mesh in the frames of an impostor (ImpostorBaker). MATRIX_M maps the object to the normalized space of
+// the impostor, where the normals are the normals of the object (uniform scale).
+
+@cull off
+
+struct V2F
+{
+	vec3 normal;	// object space
+	vec2 uv;
+};
+
+@vertex
+{
+	#include <AppData.inc>
+
+	out V2F v2f;
+
+	void vs_main(AppData appdata)
+	{
+		gl_Position = MATRIX_MVP * appdata.position;
+		v2f.normal = appdata.normal;
+		v2f.uv = appdata.uv;
+	}
+}
+
+@fragment
+{
+	uniform sampler2D _MainTex;
+	uniform vec4 _Color = vec4(1, 1, 1, 1);
+
+	in V2F v2f;
+
+	layout (location = 0) out vec4 Albedo;
+	layout (location = 1) out vec4 Normal;
+	layout (location = 2) out vec4 Depth;
+
+	void main()
+	{
+		vec4 albedo = texture(_MainTex, v2f.uv) * _Color;
+		if (albedo.a < 0.5)
+			discard;
+		vec3 N = normalize(v2f.normal);
+		if (!gl_FrontFacing)
+			N = -N;
+		// alpha is the coverage: filtered with the background (0), the atlases are premultiplied
+		Albedo = vec4(albedo.rgb, 1);
+		Normal = vec4(N * 0.5 + 0.5, 1);
+		Depth = vec4(gl_FragCoord.z, 1, 0, 0);
+	}
+}
@@ -0,0 +1,45 @@
+// Opaque shadow casters drawn by DepthOnlyRenderer: positions and normals, instanced, no per draw uniform. Each
+// triangle is rendered in the cascades of the shadow map (layers), as with CascadedShadowMap.
+
+#include <ShadowDepthCommon.inc>
+
+@vertex
+{
+	layout (location = PositionIndex)		in vec3 InputPosition;
+	layout (location = NormalIndex)			in vec3 InputNormal;
+	layout (location = InstanceRow0Index)	in vec4 InstanceRow0;
+	layout (location = InstanceRow1Index)	in vec4 InstanceRow1;
+	layout (location = InstanceRow2Index)	in vec4 InstanceRow2;
+
+	void main()
+	{
+		vec4 worldPosition = ObjectToWorldPosition(InputPosition, InstanceRow0, InstanceRow1, InstanceRow2);
+		gl_Position = ShadowDepthNormalOffsetPosition(worldPosition, InputNormal, InstanceRow0, InstanceRow1, InstanceRow2);
+	}
+}
+
+@geometry
+{
+	layout(triangles, invocations = 4) in;
+	layout(triangle_strip, max_vertices = 3) out;
+
+	void main()
+	{
+		if (ShadowDepthCascadeUnused(gl_InvocationID))
+			return;
+		for (int i = 0; i < 3; ++i)
+		{
+			gl_Position = ShadowDepthClipPosition(gl_in[i].gl_Position, gl_InvocationID);
+			gl_Layer = gl_InvocationID;
+			EmitVertex();
+		}
+		EndPrimitive();
+	}
+}
+
+@fragment
+{
+	void main()
+	{
+	}
+}
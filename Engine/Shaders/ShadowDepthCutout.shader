@@ -0,0 +1,61 @@
+// Alpha tested shadow casters drawn by DepthOnlyRenderer: ShadowDepth with the uv, the pixels whose alpha
+// (_MainTex * _Color) is below _Cutoff are discarded.
+
+#include <ShadowDepthCommon.inc>
+
+@vertex
+{
+	layout (location = PositionIndex)		in vec3 InputPosition;
+	layout (location = NormalIndex)			in vec3 InputNormal;
+	layout (location = UVIndex)				in vec2 InputUV;
+	layout (location = InstanceRow0Index)	in vec4 InstanceRow0;
+	layout (location = InstanceRow1Index)	in vec4 InstanceRow1;
+	layout (location = InstanceRow2Index)	in vec4 InstanceRow2;
+
+	out vec2 VertexUV;
+
+	void main()
+	{
+		vec4 worldPosition = ObjectToWorldPosition(InputPosition, InstanceRow0, InstanceRow1, InstanceRow2);
+		gl_Position = ShadowDepthNormalOffsetPosition(worldPosition, InputNormal, InstanceRow0, InstanceRow1, InstanceRow2);
+		VertexUV = InputUV;
+	}
+}
+
+@geometry
+{
+	layout(triangles, invocations = 4) in;
+	layout(triangle_strip, max_vertices = 3) out;
+
+	in vec2 VertexUV[];
+	out vec2 UV;
+
+	void main()
+	{
+		if (ShadowDepthCascadeUnused(gl_InvocationID))
+			return;
+		for (int i = 0; i < 3; ++i)
+		{
+			gl_Position = ShadowDepthClipPosition(gl_in[i].gl_Position, gl_InvocationID);
+			gl_Layer = gl_InvocationID;
+			UV = VertexUV[i];
+			EmitVertex();
+		}
+		EndPrimitive();
+	}
+}
+
+@fragment
+{
+	uniform sampler2D _MainTex;
+	uniform vec4 _Color = vec4(1, 1, 1, 1);
+	uniform float _Cutoff = 0.5;
+
+	in vec2 UV;
+
+	void main()
+	{
+		if (texture(_MainTex, UV).a * _Color.a < _Cutoff)
+			discard;
+	}
+}
@@ -4,19 +4,17 @@ import sys
 compiler = r'../Binary/RelWithDebInfo/ShaderCompiler'
 #compiler = r'../Binary/Debug/ShaderCompiler'
 shader_dirs = ['.', './Editor']
-count = 0
 
-for d in shader_dirs:
-	for fn in os.listdir(d):
-		print(fn)
-		ext = fn.split('.')[-1]
+# all the shaders are checked by one offline (no GL context) run, in parallel
+# glslangValidator must be in PATH, or pass --glslang <path> (--reflect-only skips the compilation)
+cmd = '{} --offline --include {} --output {} {}'.format(
+	compiler,
+	os.path.abspath('include'),
+	os.path.abspath('../build/ShaderReflection'),
+	' '.join(os.path.abspath(d) for d in shader_dirs))
+print(cmd)
+if os.system(cmd) != 0:
+	print("Compile ERROR")
+	sys.exit(1)
 
-		if ext in ['surf', 'shader']:
-			cmd = compiler + ' ' + os.path.abspath(os.path.join(d, fn))
-			print(cmd)
-			if os.system(cmd) != 0:
-				print("Compile ERROR: ", fn)
-				sys.exit()
-			count += 1
-
-print("Done. {} shaders compiled.".format(count))
\ No newline at end of file
+print("Done.")
@@ -15,6 +15,8 @@
 #include "AudioImporter.hpp"
 
 #include "AssetArchive.hpp"
+#include "MainEditor.hpp"
+#include "SearchIndex.hpp"
 #include "SceneArchive.hpp"
 
 #include <boost/uuid/uuid_generators.hpp>
@@ -44,6 +46,7 @@ namespace FishEditor
 		AssetOutputArchive archive(fout);
 		archive.SerializeAssetImporter(*this);
 		Reimport();
+		MainEditor::RepaintSceneView();
 	}
 
 	template<class AssetImporterType>
@@ -192,6 +195,7 @@ namespace FishEditor
 		{
 			s_importerGUIDToObject[ret->GetGUID()] = ret->asset();
 			s_pathToImpoter[path] = ret;
+			SearchIndex::AddAsset(ret->asset(), path);
 		}
 
 		if (ret != nullptr && ret->m_assetTimeStamp == 0)	// if the .meta file is newly created
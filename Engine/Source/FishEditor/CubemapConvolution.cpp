@@ -0,0 +1,106 @@
+#include "CubemapConvolution.hpp"
+#include "AssetImporter.hpp"
+
+#include <FishEngine/Application.hpp>
+#include <FishEngine/Cubemap.hpp>
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/Timer.hpp>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace FishEngine;
+
+namespace
+{
+	// bump when the output of EnvironmentFilter changes
+	constexpr uint32_t CacheVersion = 1;
+
+	struct CacheHeader
+	{
+		char		magic[4] = { 'F', 'C', 'C', 'V' };
+		uint32_t	version = CacheVersion;
+		int64_t		sourceTime = 0;
+		int32_t		sourceSize = 0;
+		int32_t		sampleCount = 0;
+		int32_t		mipCount = 0;
+
+		bool operator==(CacheHeader const & rhs) const
+		{
+			return std::equal(magic, magic + 4, rhs.magic) && version == rhs.version && sourceTime == rhs.sourceTime
+				&& sourceSize == rhs.sourceSize && sampleCount == rhs.sampleCount && mipCount == rhs.mipCount;
+		}
+	};
+
+	Path CachePath(FishEditor::AssetImporter const & importer)
+	{
+		return Application::dataPath().parent_path() / "Library" / "CubemapConvolution" / (ToString(importer.GetGUID()) + ".bin");
+	}
+
+	bool LoadCache(Path const & path, CacheHeader const & expected, std::vector<CubemapImage>& mips, SphericalHarmonicsL2& irradiance)
+	{
+		std::ifstream fin(path.string(), std::ios::binary);
+		if (!fin)
+			return false;
+		CacheHeader header;
+		fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!fin || !(header == expected))
+			return false;
+		fin.read(reinterpret_cast<char*>(irradiance.coefficients), sizeof(irradiance.coefficients));
+		mips.resize(header.mipCount);
+		int size = header.sourceSize;
+		for (auto & mip : mips)
+		{
+			mip.Resize(size);
+			for (auto & face : mip.faces)
+				fin.read(reinterpret_cast<char*>(face.data()), face.size() * sizeof(Vector3));
+			size /= 2;
+		}
+		return static_cast<bool>(fin);
+	}
+
+	void SaveCache(Path const & path, CacheHeader const & header, std::vector<CubemapImage> const & mips, SphericalHarmonicsL2 const & irradiance)
+	{
+		boost::system::error_code ec;
+		boost::filesystem::create_directories(path.parent_path(), ec);
+		std::ofstream fout(path.string(), std::ios::binary);
+		if (!fout)
+		{
+			LogWarning("Can not write the cubemap convolution cache: " + path.string());
+			return;
+		}
+		fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		fout.write(reinterpret_cast<const char*>(irradiance.coefficients), sizeof(irradiance.coefficients));
+		for (auto const & mip : mips)
+			for (auto const & face : mip.faces)
+				fout.write(reinterpret_cast<const char*>(face.data()), face.size() * sizeof(Vector3));
+	}
+}
+
+
+namespace FishEditor
+{
+	void CubemapConvolution::Specular(AssetImporter const & importer, CubemapImage const & source, Cubemap & cubemap)
+	{
+		boost::system::error_code ec;
+		CacheHeader header;
+		header.sourceTime = static_cast<int64_t>(boost::filesystem::last_write_time(importer.assetPath(), ec));
+		header.sourceSize = source.size;
+		header.sampleCount = SampleCount;
+		header.mipCount = EnvironmentFilter::PrefilteredMipCount(source.size);
+
+		auto path = CachePath(importer);
+		std::vector<CubemapImage> mips;
+		SphericalHarmonicsL2 irradiance;
+		if (ec || !LoadCache(path, header, mips, irradiance))
+		{
+			Timer t("Cubemap convolution: " + importer.assetPath().string());
+			mips = EnvironmentFilter::PrefilterSpecular(source, SampleCount);
+			irradiance = EnvironmentFilter::ProjectIrradiance(source);
+			if (!ec)
+				SaveCache(path, header, mips, irradiance);
+			t.StopAndPrint();
+		}
+		EnvironmentFilter::Apply(mips, &irradiance, cubemap);
+	}
+}
@@ -0,0 +1,27 @@
+#ifndef CubemapConvolution_hpp
+#define CubemapConvolution_hpp
+
+#include "FishEditor.hpp"
+#include <FishEngine/ReflectClass.hpp>
+#include <FishEngine/Render/EnvironmentFilter.hpp>
+
+namespace FishEditor
+{
+	// Convolution of the cubemaps imported with TextureImporterCubemapConvolution::Specular.
+	//
+	// Prefiltering takes a few seconds for a large cubemap, so the result is kept in the Library folder of the project
+	// (Library/CubemapConvolution/<guid>.bin) and computed again only when the source file, its size or the settings
+	// of the filter change.
+	class Meta(NonSerializable) CubemapConvolution
+	{
+	public:
+		CubemapConvolution() = delete;
+
+		// Replaces the pixels of cubemap with the convolution of source (the image of the asset of importer).
+		static void Specular(AssetImporter const & importer, FishEngine::CubemapImage const & source, FishEngine::Cubemap & cubemap);
+
+		static constexpr int SampleCount = 256;
+	};
+}
+
+#endif // CubemapConvolution_hpp
@@ -17,6 +17,7 @@
 #include <FishEngine/Cubemap.hpp>
 
 #include "AssetDataBase.hpp"
+#include "CubemapConvolution.hpp"
 
 #include <QIcon>
 #include <QImage>
@@ -151,6 +152,37 @@ FishEngine::TexturePtr FishEditor::DDSImporter::Load()
 			}
 		}
 		
+		if (m_cubemapConvolution == TextureImporterCubemapConvolution::Specular)
+		{
+			if ((format == TextureFormat::RGBAHalf || format == TextureFormat::RGBAFloat) && Mathf::IsPowerOfTwo(width))
+			{
+				CubemapImage source;
+				source.Resize(width);
+				for (int face = 0; face < 6; ++face)
+				{
+					auto & dst = source.faces[face];
+					for (size_t i = 0; i < dst.size(); ++i)
+					{
+						if (format == TextureFormat::RGBAHalf)
+						{
+							auto src = (glm::detail::hdata *)gli_texture.data(0, face, 0) + i * 4;
+							dst[i].Set(glm::detail::toFloat32(src[0]), glm::detail::toFloat32(src[1]), glm::detail::toFloat32(src[2]));
+						}
+						else
+						{
+							auto src = (float *)gli_texture.data(0, face, 0) + i * 4;
+							dst[i].Set(src[0], src[1], src[2]);
+						}
+					}
+				}
+				CubemapConvolution::Specular(*this, source, *texCube);
+			}
+			else
+			{
+				LogWarning("Cubemap convolution needs a power of two RGBAHalf or RGBAFloat cubemap: " + path);
+			}
+		}
+		
 		ret = texCube;
 		
 		QImage::Format qformat;
@@ -184,6 +216,33 @@ FishEngine::TexturePtr FishEditor::DDSImporter::Load()
 	return ret;
 }
 
+
+void FishEditor::DDSImporter::Reimport()
+{
+	auto cubemap = As<Cubemap>(AssetImporter::s_importerGUIDToObject[this->m_guid]->mainObject());
+	auto loaded = As<Cubemap>(Load());
+	if (cubemap == nullptr || loaded == nullptr)
+	{
+		LogWarning("Only cubemaps can be reimported: " + m_assetPath.string());
+		return;
+	}
+	
+	// keep the object, it is referenced by the materials and the RenderSettings
+	cubemap->m_width = loaded->m_width;
+	cubemap->m_height = loaded->m_height;
+	cubemap->m_format = loaded->m_format;
+	cubemap->m_mipmapCount = loaded->m_mipmapCount;
+	cubemap->m_pixels = std::move(loaded->m_pixels);
+	cubemap->m_prefiltered = loaded->m_prefiltered;
+	cubemap->m_irradiance = loaded->m_irradiance;
+	if (cubemap->m_GLNativeTexture != 0)
+	{
+		glDeleteTextures(1, &cubemap->m_GLNativeTexture);
+		cubemap->m_GLNativeTexture = 0;
+	}
+	cubemap->m_uploaded = false;
+}
+
 #if 0
 
 // https://github.com/g-truc/gli/blob/master/manual.md
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AssetImporter.hpp"
+#include "TextureImporterProperties.hpp"
 
 namespace FishEditor
 {
@@ -13,5 +14,22 @@ namespace FishEditor
 		DDSImporter() = default;
 
 		FishEngine::TexturePtr Load();
+
+		// Convolution of a cubemap, for image based lighting (see CubemapConvolution).
+		TextureImporterCubemapConvolution cubemapConvolution() const
+		{
+			return m_cubemapConvolution;
+		}
+
+		void setCubemapConvolution(const TextureImporterCubemapConvolution cubemapConvolution)
+		{
+			m_cubemapConvolution = cubemapConvolution;
+		}
+
+	protected:
+		virtual void Reimport() override;
+
+	private:
+		TextureImporterCubemapConvolution m_cubemapConvolution = TextureImporterCubemapConvolution::None;
 	};
-}
\ No newline at end of file
+}
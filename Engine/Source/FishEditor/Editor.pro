@@ -55,6 +55,8 @@ SOURCES += \
     UI/FloatLineEdit.cpp \
     UI/GLWidget.cpp \
     UI/HierarchyTreeView.cpp \
+    UI/HierarchyModel.cpp \
+    UI/LogViewModel.cpp \
     UI/InspectorWidget.cpp \
     UI/MainWindow.cpp \
     UI/ObjectListModel.cpp \
@@ -90,6 +92,11 @@ SOURCES += \
     SceneViewEditor.cpp \
     Selection.cpp \
     TextureImporter.cpp \
+    CubemapConvolution.cpp \
+    MeshLODGenerator.cpp \
+    Undo.cpp \
+    PropertyArchive.cpp \
+    SearchIndex.cpp \
     UI/OpenProjectDialog.cpp \
     UI/ProjectListView.cpp \
     UI/LogView.cpp
@@ -106,6 +113,7 @@ HEADERS += \
     generate/Enum_ShadingMode.hpp \
     generate/Enum_TextureImporterAlphaSource.hpp \
     generate/Enum_TextureImporterCompression.hpp \
+    generate/Enum_TextureImporterCubemapConvolution.hpp \
     generate/Enum_TextureImporterGenerateCubemap.hpp \
     generate/Enum_TextureImporterMipFilter.hpp \
     generate/Enum_TextureImporterNPOTScale.hpp \
@@ -119,6 +127,8 @@ HEADERS += \
     UI/FloatLineEdit.hpp \
     UI/GLWidget.hpp \
     UI/HierarchyTreeView.hpp \
+    UI/HierarchyModel.hpp \
+    UI/LogViewModel.hpp \
     UI/InspectorWidget.hpp \
     UI/MainWindow.hpp \
     UI/ObjectListModel.hpp \
@@ -159,7 +169,12 @@ HEADERS += \
     ProjectSettings.hpp \
     SceneViewEditor.hpp \
     Selection.hpp \
+    Undo.hpp \
+    PropertyArchive.hpp \
+    SearchIndex.hpp \
     TextureImporter.hpp \
+    CubemapConvolution.hpp \
+    MeshLODGenerator.hpp \
     TextureImporterProperties.hpp \
     UI/OpenProjectDialog.hpp \
     UI/ProjectListView.hpp \
@@ -43,6 +43,8 @@ QTreeWidgetItem*	EditorGUI::s_currentItem;
 QTreeWidgetItem*	EditorGUI::s_currentGroupHeaderItem;
 int					EditorGUI::s_currentGroupHeaderItemChildIndex;
 bool				EditorGUI::s_expectNewGroup;
+bool				EditorGUI::s_changed = false;
+std::stack<bool>	EditorGUI::s_changedStack;
 
 
 template<class T, class... Args>
@@ -171,6 +173,34 @@ void EditorGUI::EndComponent()
 	PopGroup();
 }
 
+void EditorGUI::SkipGroup()
+{
+	// keep the visible child items, PopGroup hides the items after s_currentGroupHeaderItemChildIndex
+	int rowCount = s_currentGroupHeaderItem->childCount();
+	int i = s_currentGroupHeaderItemChildIndex;
+	while (i < rowCount && !s_currentGroupHeaderItem->child(i)->isHidden())
+	{
+		i++;
+	}
+	s_currentGroupHeaderItemChildIndex = i;
+	s_expectNewGroup = false;
+}
+
+void EditorGUI::BeginChangeCheck()
+{
+	s_changedStack.push(s_changed);
+	s_changed = false;
+}
+
+bool EditorGUI::EndChangeCheck()
+{
+	bool changed = s_changed;
+	// a change inside also counts as a change of the enclosing check
+	s_changed = s_changedStack.top() || changed;
+	s_changedStack.pop();
+	return changed;
+}
+
 bool EditorGUI::BeginMaterial(std::string const & materialName)
 {
 	auto header = CheckNextWidget<UIMaterialHeader>(materialName);
@@ -195,7 +225,7 @@ bool EditorGUI::Button(const std::string &text)
 bool EditorGUI::Toggle(const std::string & label, bool *value)
 {
 	UIBool * toggle = CheckNextWidget<UIBool>(label, *value);
-	return toggle->CheckUpdate(label, *value);
+	return Changed(toggle->CheckUpdate(label, *value));
 
 }
 
@@ -210,7 +240,7 @@ bool EditorGUI::ColorField(const std::string &label, Color *color)
 		color->r = qcolor.red()   * inv_255;
 		color->g = qcolor.green() * inv_255;
 		color->b = qcolor.blue()  * inv_255;
-		return true;
+		return Changed(true);
 	}
 	return false;
 }
@@ -218,13 +248,13 @@ bool EditorGUI::ColorField(const std::string &label, Color *color)
 bool EditorGUI::EnumPopup(const std::string &label, int *index, const char * const *enumStringArray, int arraySize)
 {
 	UIComboBox * combo = CheckNextWidget<UIComboBox>(label, *index, enumStringArray, arraySize);
-	return combo->CheckUpdate(label, *index, enumStringArray, arraySize);
+	return Changed(combo->CheckUpdate(label, *index, enumStringArray, arraySize));
 }
 
 bool EditorGUI::FloatField(const std::string &label, float * v)
 {
 	UIFloat * float_row = CheckNextWidget<UIFloat>(label, *v);
-	return float_row->CheckUpdate(label, *v);
+	return Changed(float_row->CheckUpdate(label, *v));
 }
 
 bool EditorGUI::FloatField(const std::string &label, float v)
@@ -236,21 +266,21 @@ bool EditorGUI::FloatField(const std::string &label, float v)
 bool EditorGUI::Slider(const std::string &label, float *value, float leftValue, float rightValue)
 {
 	UISlider * slider = CheckNextWidget<UISlider>(label, *value, leftValue, rightValue);
-	return slider->CheckUpdate(label, *value);
+	return Changed(slider->CheckUpdate(label, *value));
 }
 
 
 bool EditorGUI::Vector3Field(const std::string &label, Vector3 *v)
 {
 	UIFloat3 * float3 = CheckNextWidget<UIFloat3>(label, v->x, v->y, v->z);
-	return float3->CheckUpdate(label, v->x, v->y, v->z);
+	return Changed(float3->CheckUpdate(label, v->x, v->y, v->z));
 }
 
 
 bool EditorGUI::Vector4Field(std::string const & label, FishEngine::Vector4 * v)
 {
 	UIFloat4 * float4 = CheckNextWidget<UIFloat4>(label, v->x, v->y, v->z, v->w);
-	return float4->CheckUpdate(label, v->x, v->y, v->z, v->w);
+	return Changed(float4->CheckUpdate(label, v->x, v->y, v->z, v->w));
 }
 
 
@@ -299,7 +329,7 @@ bool EditorGUI::TextureField(std::string const & label, FishEngine::TexturePtr &
 			//LogError(Format("Select Texture %s", obj->name().c_str()));
 		});
 	}
-	return changed;
+	return Changed(changed);
 }
 
 void EditorGUI::PushGroup()
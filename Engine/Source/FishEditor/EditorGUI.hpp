@@ -33,6 +33,15 @@ namespace FishEditor
 		static bool BeginComponent(std::string const & componentTypeName, bool enabled, UIHeaderState * outState);
 		static void EndComponent();
 
+		// Skips the fields of the current component or material, leaving its widgets as they are.
+		// Used instead of drawing a group whose target has not changed.
+		static void SkipGroup();
+
+		// As Unity's EditorGUI.BeginChangeCheck/EndChangeCheck:
+		// EndChangeCheck returns true if the user modified any field since the matching BeginChangeCheck.
+		static void BeginChangeCheck();
+		static bool EndChangeCheck();
+
 		static bool BeginMaterial(std::string const & materialName);
 		static void EndMaterial();
 
@@ -67,6 +76,7 @@ namespace FishEditor
 			{
 				obj = FishEngine::As<T>(ret);
 				changed = true;
+				s_changed = true;
 			}
 			return changed;
 		}
@@ -87,6 +97,16 @@ namespace FishEditor
 		static int							s_currentGroupHeaderItemChildIndex;
 		static bool							s_expectNewGroup;
 
+		static bool							s_changed;
+		static std::stack<bool>				s_changedStack;
+
+		// records a field modified by the user for EndChangeCheck
+		static bool Changed(bool changed)
+		{
+			s_changed = s_changed || changed;
+			return changed;
+		}
+
 		static void PushGroup();
 		static void PopGroup();
 
@@ -14,8 +14,10 @@
 #include <FishEngine/Texture.hpp>
 #include <FishEngine/Texture2D.hpp>
 #include <FishEngine/Application.hpp>
+#include <FishEngine/MeshletUtility.hpp>
 
 #include "AssetDataBase.hpp"
+#include "MeshLODGenerator.hpp"
 #include "FBXImporter/RawMesh.hpp"
 
 //#include <Animation/AnimationUtility.hpp>
@@ -1012,6 +1014,17 @@ PrefabPtr FishEditor::FBXImporter::Load(FishEngine::Path const & path)
 		}
 	}
 
+	// before the meshes are uploaded, LOD 0 is still readable
+	MeshLODGenerator::Generate(*this, m_model.m_meshes);
+
+	// clusters for the culling, the triangles are sorted by cluster before the upload
+	for (auto & mesh : m_model.m_meshes)
+	{
+		MeshletUtility::Build(*mesh);
+		for (int level = 1; level < mesh->lodCount(); ++level)
+			MeshletUtility::Build(*mesh->lod(level));
+	}
+
 	//std::deque<TransformPtr> transforms;
 	//transforms.push_back(m_model.m_rootNode->transform());
 	//while (!transforms.empty())
@@ -15,12 +15,12 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+
 using namespace FishEngine;
 
 namespace FishEditor
 {
-	std::map<std::string, FileInfo*> FileInfo::s_nameToNode;
-
 	bool FileInfo::Create()
 	{
 		if (m_fileExists || !m_isDirectory)
@@ -40,14 +40,8 @@ namespace FishEditor
 
 	void FileInfo::RemoveChild(FileInfo* fileInfo)
 	{
-		if (fileInfo->isDir())
-		{
-			std::remove(m_dirChildren.begin(), m_dirChildren.end(), fileInfo);
-		}
-		else
-		{
-			std::remove(m_fileChildren.begin(), m_fileChildren.end(), fileInfo);
-		}
+		auto & children = fileInfo->isDir() ? m_dirChildren : m_fileChildren;
+		children.erase(std::remove(children.begin(), children.end(), fileInfo), children.end());
 	}
 
 	FileInfo * FileInfo::s_assetRoot = nullptr;
@@ -151,17 +145,6 @@ namespace FishEditor
 		}
 	}
 
-	FileInfo* FileInfo::fileInfo(const std::string &path)
-	{
-		FishEngine::Path p = path;
-		auto const & it = s_nameToNode.find(p.make_preferred().string());
-		if (it == FileInfo::s_nameToNode.end())
-		{
-			abort();
-		}
-		return it->second;
-	}
-
 	void FileInfo::UpdateThumbnailImpl(FileInfo* node)
 	{
 		if (node->m_isDirectory)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <array>
 #include <FishEngine/Resources.hpp>
 #include <FishEngine/ReflectClass.hpp>
@@ -16,6 +17,8 @@ namespace FishEditor
 	{
 	public:
 		FileInfo() = default;
+		// Deletes the children, and forgets the path of this directory (find).
+		~FileInfo();
 		//FileNode(FileNode &&) = default;
 		FileInfo(FileInfo const &) = delete;
 		FileInfo & operator=(FileInfo const &) = delete;
@@ -80,11 +83,34 @@ namespace FishEditor
 		static void SetAssetRootPath(Path const & path);
 		static FileInfo* assetRoot() { return s_assetRoot; }
 		static FileInfo* fileInfo(std::string const & path);
+		// nullptr if the path is not a known directory
+		static FileInfo* find(std::string const & path);
 		static void UpdateThumbnail();
 
 		// delete the file
 		bool DeleteFile();
 
+		// An item of a directory listing.
+		struct Entry
+		{
+			Path	path;
+			bool	isDirectory;
+		};
+
+		// Lists the files and sub directories of dir on disk, without .meta files.
+		// Does not touch the tree, so it may be called from any thread.
+		static std::vector<Entry> ScanDirectory(Path const & dir);
+
+		// Adds the entries that are not children yet and removes the children that are not in entries.
+		// The order of the existing children is kept. Returns true if anything changed.
+		// removed: receives the removed children, detached, for the caller to delete once nothing shows them (the
+		// rows of the project view); deleted here if null.
+		bool UpdateChildren(std::vector<Entry> const & entries,
+			std::vector<std::unique_ptr<FileInfo>> * removed = nullptr);
+
+		// Have the children of this directory been listed? False for directories found by UpdateChildren.
+		bool listed() const { return m_listed; }
+
 	private:
 		friend class ::ProjectViewFileModel;
 		void BuildNodeTree(const Path & path, std::vector<Path> & modelPaths);
@@ -101,6 +127,7 @@ namespace FishEditor
 		//std::vector<std::uint8_t> m_thumbnail;
 
 		bool m_fileExists = true; // this value is false when file not created
+		bool m_listed = true;
 		bool Create();
 
 		// simply remove from children, do NOT delete real file
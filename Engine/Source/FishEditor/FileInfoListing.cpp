@@ -0,0 +1,122 @@
+#include "FileInfo.hpp"
+
+#include <algorithm>
+
+// The directory listing part of FileInfo. It uses neither Qt nor the asset database, so it builds on its own
+// (FileInfoTest).
+
+namespace FishEditor
+{
+	std::map<std::string, FileInfo*> FileInfo::s_nameToNode;
+
+	FileInfo::~FileInfo()
+	{
+		for (auto child : m_dirChildren)
+			delete child;
+		for (auto child : m_fileChildren)
+			delete child;
+		if (m_isDirectory)
+		{
+			// a node of the same path may have replaced it
+			auto it = s_nameToNode.find(boost::filesystem::absolute(m_path).make_preferred().string());
+			if (it != s_nameToNode.end() && it->second == this)
+				s_nameToNode.erase(it);
+		}
+	}
+
+	FileInfo* FileInfo::fileInfo(const std::string &path)
+	{
+		auto node = find(path);
+		if (node == nullptr)
+		{
+			abort();
+		}
+		return node;
+	}
+
+	FileInfo* FileInfo::find(const std::string &path)
+	{
+		FishEngine::Path p = path;
+		auto const & it = s_nameToNode.find(p.make_preferred().string());
+		if (it == FileInfo::s_nameToNode.end())
+		{
+			return nullptr;
+		}
+		return it->second;
+	}
+
+	std::vector<FileInfo::Entry> FileInfo::ScanDirectory(Path const & dir)
+	{
+		std::vector<Entry> entries;
+		boost::system::error_code error;
+		for (boost::filesystem::directory_iterator it(dir, error), end; !error && it != end; it.increment(error))
+		{
+			const Path & p = it->path();
+			if (p.extension() == ".DS_Store" || p.extension() == ".meta")
+			{
+				continue;
+			}
+			entries.push_back({ p, boost::filesystem::is_directory(it->status()) });
+		}
+		return entries;
+	}
+
+	bool FileInfo::UpdateChildren(std::vector<Entry> const & entries, std::vector<std::unique_ptr<FileInfo>> * removed)
+	{
+		std::vector<std::unique_ptr<FileInfo>> detached;
+		if (removed == nullptr)
+			removed = &detached;
+
+		std::map<std::string, bool> onDisk;
+		for (auto const & e : entries)
+		{
+			onDisk.emplace(e.path.filename().string(), e.isDirectory);
+		}
+
+		m_listed = true;
+		bool changed = false;
+		auto removeMissing = [&onDisk, &changed, removed](std::vector<FileInfo*> & children, bool isDirectory)
+		{
+			auto end = std::remove_if(children.begin(), children.end(), [&](FileInfo* child) {
+				auto it = onDisk.find(child->fileName());
+				// not created yet (e.g. a new folder being named)
+				bool keep = !child->m_fileExists || (it != onDisk.end() && it->second == isDirectory);
+				if (it != onDisk.end() && keep)
+					onDisk.erase(it);
+				if (!keep)
+				{
+					child->m_fileExists = false;
+					child->m_parent = nullptr;
+					removed->emplace_back(child);
+				}
+				return !keep;
+			});
+			changed = changed || end != children.end();
+			children.erase(end, children.end());
+		};
+		removeMissing(m_dirChildren, true);
+		removeMissing(m_fileChildren, false);
+
+		// what is left in onDisk is new
+		for (auto const & e : onDisk)
+		{
+			auto fileNode = new FileInfo();
+			fileNode->m_path = m_path / e.first;
+			fileNode->m_parent = this;
+			fileNode->m_isDirectory = e.second;
+			if (e.second)
+			{
+				s_nameToNode[boost::filesystem::absolute(fileNode->m_path).make_preferred().string()] = fileNode;
+				// the content of the new directory is listed when it is opened
+				fileNode->m_listed = false;
+				m_dirChildren.push_back(fileNode);
+			}
+			else
+			{
+				m_fileChildren.push_back(fileNode);
+			}
+			changed = true;
+		}
+		return changed;
+	}
+}
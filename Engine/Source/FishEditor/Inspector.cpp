@@ -1,5 +1,7 @@
 #include "Inspector.hpp"
 
+#include <map>
+
 #include <QLayout>
 #include <QMenu>
 #include <QTreeWidget>
@@ -35,6 +37,8 @@
 #include <FishEngine/AudioListener.hpp>
 
 #include "EditorGUI.hpp"
+#include "Undo.hpp"
+#include "MainEditor.hpp"
 //#include "private/EditorGUI_p.hpp"
 
 #include <FishEngine/ReflectEnum.hpp>
@@ -64,6 +68,67 @@ std::weak_ptr<FishEngine::Component> FishEditor::Inspector::s_targetComponent;
 
 ComponentPtr componentToBeDestroyed;
 
+namespace
+{
+	// what the inspector showed on its last refresh
+	std::weak_ptr<Object>	s_lastTarget;
+	uint32_t				s_lastTargetDirtyCount = 0;
+	std::vector<int>		s_lastSections;		// instance IDs of the components and materials, in order
+	std::map<int, uint32_t>	s_sectionDirtyCounts;	// dirtyCount of each section when it was last drawn
+
+	bool					s_repaintRequested = true;
+	bool					s_userInput = false;	// the next Bind ends the gesture of the user's edit
+	bool					s_redrawAll = true;	// the current Bind redraws every section
+
+	bool IsSectionDirty(ObjectPtr const & object)
+	{
+		auto it = s_sectionDirtyCounts.find(object->GetInstanceID());
+		return it == s_sectionDirtyCounts.end() || it->second != object->dirtyCount();
+	}
+}
+
+void Inspector::SetInsectorWidget(InspectorWidget* widget)
+{
+	s_inspectorWidget = widget;
+}
+
+void Inspector::Repaint()
+{
+	s_repaintRequested = true;
+	s_userInput = true;
+}
+
+void Inspector::RepaintSection(int section, bool userInput)
+{
+	if (section >= static_cast<int>(s_lastSections.size()))
+	{
+		Repaint();
+		return;
+	}
+	s_sectionDirtyCounts.erase(s_lastSections[section]);
+	s_userInput = s_userInput || userInput;
+}
+
+template<class T>
+void Inspector::OnInspectorGUIIfDirty(std::shared_ptr<T> const & target)
+{
+	if (!s_redrawAll && !IsSectionDirty(target))
+	{
+		EditorGUI::SkipGroup();
+		return;
+	}
+	// the widgets write into target while they are drawn
+	Undo::RecordObject(target, "Modify " + target->ClassName());
+	EditorGUI::BeginChangeCheck();
+	OnInspectorGUI<T>(target);
+	if (EditorGUI::EndChangeCheck())
+	{
+		target->SetDirty();
+		MainEditor::RepaintSceneView();
+	}
+	s_sectionDirtyCounts[target->GetInstanceID()] = target->dirtyCount();
+}
+
 template<>
 void Inspector::OnInspectorGUI(std::shared_ptr<Transform> const & t)
 {
@@ -355,6 +420,52 @@ void Inspector::Bind(const GameObjectPtr & go)
 			s_inspectorWidget->setHidden(false);
 	}
 	EditorGUI::s_treeWidget = s_inspectorWidget->m_treeWidget;
+
+	auto renderer = go->GetComponent<Renderer>();
+	std::vector<int> sections;
+	sections.reserve(go->m_components.size() + 2);
+	sections.push_back(go->transform()->GetInstanceID());
+	for (auto const & comp : go->m_components)
+	{
+		sections.push_back(comp->GetInstanceID());
+	}
+	if (renderer != nullptr)
+	{
+		for (auto const & material : renderer->m_materials)
+		{
+			sections.push_back(material->GetInstanceID());
+		}
+	}
+
+	// The widgets are reused by position, so anything that changes the layout redraws everything.
+	s_redrawAll = s_repaintRequested || s_lastTarget.lock() != go || s_lastSections != sections;
+	if (!s_redrawAll)
+	{
+		bool dirty = go->dirtyCount() != s_lastTargetDirtyCount || IsSectionDirty(go->transform());
+		for (auto const & comp : go->m_components)
+		{
+			dirty = dirty || IsSectionDirty(comp);
+		}
+		if (renderer != nullptr)
+		{
+			for (auto const & material : renderer->m_materials)
+			{
+				dirty = dirty || IsSectionDirty(material);
+			}
+		}
+		if (!dirty)
+			return;
+	}
+	else
+	{
+		s_sectionDirtyCounts.clear();
+	}
+	bool userInput = s_userInput;
+	s_repaintRequested = false;
+	s_userInput = false;
+	s_lastTarget = go;
+	s_lastSections = std::move(sections);
+
 	s_inspectorWidget->Bind(go);
 
 	EditorGUI::Begin();
@@ -369,7 +480,6 @@ void Inspector::Bind(const GameObjectPtr & go)
 
 	//UIHeaderState state;    // ignore state
 	// material
-	auto renderer = go->GetComponent<Renderer>();
 	if ( renderer != nullptr )
 	{
 		for (auto const & material : renderer->m_materials)
@@ -377,7 +487,7 @@ void Inspector::Bind(const GameObjectPtr & go)
 			assert(material != nullptr);
 			if ( EditorGUI::BeginMaterial( material->name() ))
 			{
-				Inspector::OnInspectorGUI<Material>(material);
+				OnInspectorGUIIfDirty<Material>(material);
 			}
 			EditorGUI::EndMaterial();
 		}
@@ -385,7 +495,7 @@ void Inspector::Bind(const GameObjectPtr & go)
 
 	if (componentToBeDestroyed != nullptr)
 	{
-		Object::DestroyImmediate(componentToBeDestroyed);
+		Undo::DestroyObjectImmediate(componentToBeDestroyed);
 		componentToBeDestroyed = nullptr;
 	}
 
@@ -394,10 +504,16 @@ void Inspector::Bind(const GameObjectPtr & go)
 		//Debug::Log("clicked");
 		//auto name = s_inspectorWidget->ShowAddComponentMenu();
 		auto const & name = ShowAddComponentMenu();
-		AddComponentToGameObject(name, go);
+		auto component = AddComponentToGameObject(name, go);
+		Undo::RegisterCreatedObjectUndo(component, "Add " + name);
 	}
 
 	EditorGUI::End();
+	s_lastTargetDirtyCount = go->dirtyCount();
+
+	// a redraw that is not caused by the user (e.g. a gizmo drag) must not cut the gesture in progress
+	if (userInput)
+		Undo::FlushGesture();
 }
 
 void Inspector::Bind(FishEngine::ObjectPtr const & object)
@@ -410,8 +526,18 @@ void Inspector::Bind(FishEngine::ObjectPtr const & object)
 	if (object->ClassID() == ClassID<GameObject>())
 	{
 		Bind(std::dynamic_pointer_cast<GameObject>(object));
+		return;
 	}
-	else if (object->ClassID() == ClassID<TextureImporter>())
+
+	// asset inspectors have no sections, they are refreshed as a whole
+	if (!s_repaintRequested && s_lastTarget.lock() == object && object->dirtyCount() == s_lastTargetDirtyCount)
+		return;
+	s_repaintRequested = false;
+	s_userInput = false;
+	s_lastTarget = object;
+	s_lastTargetDirtyCount = object->dirtyCount();
+
+	if (object->ClassID() == ClassID<TextureImporter>())
 	{
 		Bind(std::dynamic_pointer_cast<TextureImporter>(object));
 	}
@@ -554,11 +680,12 @@ void Inspector::BeginComponentImpl(FishEngine::ComponentPtr const & component)
 	bool expanded = EditorGUI::BeginComponent( component->ClassName(), enabled, &state );
 	if ( expanded )
 	{
-		OnInspectorGUI<T>(p);
+		OnInspectorGUIIfDirty<T>(p);
 	}
 	EditorGUI::EndComponent();
 	if (state == UIHeaderState::enabledChanged)
 	{
+		Undo::RecordObject(p, "Modify " + p->ClassName());
 		p->setEnabled(!enabled);
 	}
 	else if (state == UIHeaderState::menuButtonClicked)
@@ -581,7 +708,7 @@ void Inspector::BeginComponentImpl(FishEngine::ComponentPtr const & component)
 	UIHeaderState state;
 	if ( EditorGUI::BeginComponent( T::StaticClassName(), &state ) )
 	{
-		OnInspectorGUI<T>(std::static_pointer_cast<T>(component));
+		OnInspectorGUIIfDirty<T>(std::static_pointer_cast<T>(component));
 	}
 	EditorGUI::EndComponent();
 
@@ -35,21 +35,34 @@ namespace FishEditor
 
 		static void HideAll();
 
+		// Redraws every section on the next Bind, e.g. after user input in the inspector.
+		// Otherwise Bind only redraws the sections whose object's dirtyCount changed.
+		static void Repaint();
+
+		// Redraws the section at index section (Transform, the components, then the materials, as drawn) on the next
+		// Bind, e.g. for the input to its widgets. userInput: the next Bind ends the user's edit gesture (Undo).
+		static void RepaintSection(int section, bool userInput);
+
 		template<class T>
 		static void OnInspectorGUI(std::shared_ptr<T> const & component);
 
 		static std::string ShowAddComponentMenu();
 		static QAction* ShowComponentMenu();
 
+		// The widget Bind draws into (the MainWindow's).
+		static void SetInsectorWidget(InspectorWidget* widget);
+
 	private:
 		friend class ::MainWindow;
 
-		static void SetInsectorWidget(InspectorWidget* widget);
-
 		static InspectorWidget* s_inspectorWidget;
 
 		static std::weak_ptr<FishEngine::Component> s_targetComponent;
 
+		// draws the fields of a component or material if it changed since it was last drawn, skips them otherwise
+		template<class T>
+		static void OnInspectorGUIIfDirty(std::shared_ptr<T> const & target);
+
 		
 
 	public:
@@ -2,6 +2,7 @@
 
 #include <iostream>
 //#include <boost/dll/import.hpp>
+#include <random>
 #include <boost/lexical_cast.hpp>
 #include <QDir>
 #include <QCoreApplication>
@@ -27,16 +28,25 @@
 #include <FishEngine/AnimationClip.hpp>
 #include <FishEngine/Time.hpp>
 #include <FishEngine/AudioSystem.hpp>
+#include <FishEngine/FrameRecorder.hpp>
 #include <FishEngine/AudioSource.hpp>
 #include <FishEngine/AudioClip.hpp>
 #include <FishEngine/CapsuleCollider.hpp>
 #include <FishEngine/Rigidbody.hpp>
+#include <FishEngine/StaticBatchingUtility.hpp>
+#include <FishEngine/ShaderVariantCollection.hpp>
+#include <FishEngine/Timer.hpp>
+#include <FishEngine/Impostor.hpp>
+#include <FishEngine/Transform.hpp>
 
 #include "SceneViewEditor.hpp"
 #include "Selection.hpp"
+#include "Undo.hpp"
+#include "SearchIndex.hpp"
 #include "EditorGUI.hpp"
 #include "SceneViewEditor.hpp"
 #include "AssetDataBase.hpp"
+#include "DDSImporter.hpp"
 #include "EditorResources.hpp"
 #include "ScriptManager.hpp"
 #include "SceneArchive.hpp"
@@ -137,6 +147,12 @@ namespace FishEditor
 //		ApplyMateril1("mesh1", "vase_plant", "vase_plant_mask");
 //		ApplyMateril1("mesh20", "chain_texture", "chain_texture_mask");
 		
+		// the building does not move: batched by material in play mode
+		for (auto & t : sponza_go->GetComponentsInChildren<Transform>(true))
+		{
+			t->gameObject()->setIsStatic(true);
+		}
+		
 		auto transform = Camera::main()->gameObject()->transform();
 		transform->setPosition(5, 8, 0);
 		transform->setLocalEulerAngles(30, -90, 0);
@@ -602,9 +618,14 @@ namespace FishEditor
 	{
 		auto envmap = AssetDatabase::LoadAssetAtPath2<Texture>("Assets/uffizi_cross.dds");
 		assert(envmap != nullptr);
-		auto filtered_envmap = AssetDatabase::LoadAssetAtPath2<Texture>("Assets/uffizi_cross_128_filtered.dds");
-		assert(filtered_envmap != nullptr);
-		RenderSettings::setAmbientCubemap(filtered_envmap);
+		// prefiltered at import (GGX mips + SH irradiance), mip 0 is the source: also the skybox
+		auto importer = As<DDSImporter>(AssetImporter::GetAtPath(Application::dataPath().parent_path() / "Assets/uffizi_cross.dds"));
+		if (importer->cubemapConvolution() != TextureImporterCubemapConvolution::Specular)
+		{
+			importer->setCubemapConvolution(TextureImporterCubemapConvolution::Specular);
+			importer->SaveAndReimport();
+		}
+		RenderSettings::setAmbientCubemap(envmap);
 		auto skybox = Material::InstantiateBuiltinMaterial("SkyboxCubed");
 		skybox->SetTexture("_Tex", envmap);
 		skybox->SetVector4("_Tint", Vector4::one);
@@ -790,6 +811,49 @@ namespace FishEditor
 	}
 	
 
+	// 3600 trees in a 300 m square, the distant ones drawn as impostors. A tree is a cone: an impostor takes the
+	// largest scale of its renderer, the trees are scaled uniformly.
+	void InitializeScene_Forest()
+	{
+		auto ground = GameObject::CreatePrimitive(PrimitiveType::Plane);
+		ground->transform()->setLocalScale(32, 1, 32);
+
+		auto leaves = Material::InstantiateBuiltinMaterial("PBR");
+		leaves->SetVector3("BaseColor", Vector3(0.13f, 0.32f, 0.12f));
+		leaves->SetFloat("Roughness", 0.9f);
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> jitter(-2, 2);
+		std::uniform_real_distribution<float> size(1.5f, 2.5f);
+		auto forest = Scene::CreateGameObject("Forest");
+		for (int z = 0; z < 60; ++z)
+		{
+			for (int x = 0; x < 60; ++x)
+			{
+				auto tree = GameObject::CreatePrimitive(PrimitiveType::Cone);
+				tree->setName("Tree");
+				tree->GetComponent<MeshRenderer>()->SetMaterial(leaves);
+				tree->transform()->SetParent(forest->transform());
+				// the base of the cone is at y = -1
+				float scale = size(random);
+				tree->transform()->setLocalPosition(x * 5 - 150 + jitter(random), scale, z * 5 - 150 + jitter(random));
+				tree->transform()->setLocalScale(scale);
+			}
+		}
+
+		// one impostor, shared by all the trees
+		ImpostorBaker::BakeHierarchy(forest, 40);
+
+		auto transform = Camera::main()->gameObject()->transform();
+		transform->setPosition(0, 12, -160);
+		transform->setLocalEulerAngles(10, 0, 0);
+
+		transform = Camera::mainGameCamera()->gameObject()->transform();
+		transform->setPosition(0, 12, -160);
+		transform->setLocalEulerAngles(10, 0, 0);
+	}
+	
+
 	void DefaultScene()
 	{
 //	    auto camera = Camera::Create();
@@ -822,7 +886,10 @@ namespace FishEditor
 	//bool MainEditor::m_inPlayMode = false;
 
 	Action MainEditor::OnInitialized;
+	Action MainEditor::OnRepaintRequested;
+	Action MainEditor::OnFrameDrawn;
 	std::unique_ptr<SceneViewEditor>  MainEditor::m_mainSceneViewEditor;
+	RepaintScheduler MainEditor::s_sceneViewRepaint([]() { OnRepaintRequested(); });
 
 	void MainEditor::Init()
 	{
@@ -833,6 +900,7 @@ namespace FishEditor
 		RenderSystem::Init();
 
 		ModelImporter::Init();
+		SearchIndex::Init();
 
 		m_mainSceneViewEditor->Init();
 		DefaultScene();
@@ -878,13 +946,47 @@ namespace FishEditor
 		{
 			InitializeScene_StandardAssets();
 		}
+		else if (projectName == "Forest")
+		{
+			InitializeScene_Forest();
+		}
 
 		glClearColor(1.0f, 0.0f, 0.0f, 1);
+
+		// what the scene view shows changed
+		Selection::selectionChanged += RepaintSceneView;
+		Undo::undoRedoPerformed += RepaintSceneView;
+		Scene::AddHierarchyListener([](HierarchyChange, GameObject*) {
+			RepaintSceneView();
+		});
+
 		OnInitialized();
 	}
 
+	void MainEditor::RepaintSceneView()
+	{
+		s_sceneViewRepaint.Request();
+	}
+
+	void MainEditor::BeginContinuousRepaint()
+	{
+		s_sceneViewRepaint.BeginContinuous();
+	}
+
+	void MainEditor::EndContinuousRepaint()
+	{
+		s_sceneViewRepaint.EndContinuous();
+	}
+
+	bool MainEditor::continuousRepaint()
+	{
+		return s_sceneViewRepaint.continuous() || Application::isPlaying();
+	}
+
 	void MainEditor::Run()
 	{
+		s_sceneViewRepaint.BeginFrame();
+
 		GLint framebuffer; // qt's framebuffer
 		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
 		
@@ -898,9 +1000,12 @@ namespace FishEditor
 			auto elapse = now - time;
 			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapse).count();
 			time = now;
-			Time::m_deltaTime = ms / 1000.0f;
-			Scene::Update();
-			PhysicsSystem::FixedUpdate();
+			if (FrameRecorder::BeginFrame(ms / 1000.0f))
+			{
+				Scene::Update();
+				PhysicsSystem::FixedUpdate();
+				FrameRecorder::EndFrame();
+			}
 			AudioSystem::Update();
 		}
 		else
@@ -920,6 +1025,8 @@ namespace FishEditor
 		//Debug::Log("paintGL");
 
 		Input::Update();
+		s_sceneViewRepaint.EndFrame();
+		OnFrameDrawn();
 	}
 
 	void MainEditor::Play()
@@ -937,7 +1044,21 @@ namespace FishEditor
 		Camera::setMainCamera(nullptr);
 		//Camera::m_mainCamera = nullptr;
 		Time::m_time = 0;
+		StaticBatchingUtility::Combine();
+
+		// the variants recorded in the previous sessions are compiled now rather than when they are first drawn
+		ShaderVariantCollection variants;
+		if (variants.Load(ShaderVariantCollection::ProjectCollectionPath()))
+		{
+			Timer t("Shader warm-up");
+			ShaderWarmUp warmUp(variants);
+			warmUp.Finish();
+			t.StopAndPrint();
+		}
+		ShaderVariantCollection::StartRecording();
+
 		Scene::Start();
+		RepaintSceneView();
 	}
 
 	void MainEditor::Stop()
@@ -947,7 +1068,19 @@ namespace FishEditor
 		//Camera::m_mainCamera = EditorGUI::m_mainSceneViewEditor->camera();
 		Camera::setMainCamera(m_mainSceneViewEditor->camera());
 		PhysicsSystem::Clean();
+		StaticBatchingUtility::Clear();
 		AudioSystem::Stop();
+		FrameRecorder::Stop();
+
+		ShaderVariantCollection::StopRecording();
+		ShaderVariantCollection variants;
+		auto path = ShaderVariantCollection::ProjectCollectionPath();
+		variants.Load(path);
+		auto added = variants.Merge(ShaderVariantCollection::recorded());
+		if (added > 0 && variants.Save(path))
+			LogInfo(Format("%1% shader variants added to %2% (%3% in total)", added, path.string(), variants.size()));
+
+		RepaintSceneView();
 	}
 
 	void MainEditor::Resize(int width, int height)
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "FishEditor.hpp"
+#include "RepaintScheduler.hpp"
 #include <FishEngine/ReflectClass.hpp>
 
 namespace FishEditor
@@ -26,9 +27,33 @@ namespace FishEditor
 
 		static void NewScene();
 
+		// The scene view is redrawn on demand: anything that changes what it shows (camera, selection, edits,
+		// reimported assets) asks for a repaint. The requests made until the next repaint are coalesced
+		// into one; the ones made while the scene view is being drawn are already part of that frame.
+		static void RepaintSceneView();
+
+		// While a continuous repaint is active (animated previews), the scene view is redrawn every frame.
+		// Begin and End must be paired; they nest.
+		static void BeginContinuousRepaint();
+		static void EndContinuousRepaint();
+
+		// Has the scene view to be redrawn again after this frame? (play mode or continuous repaint)
+		static bool continuousRepaint();
+
+		// Number of times the scene view was drawn, for profiling.
+		static uint64_t repaintCount() { return s_sceneViewRepaint.frameCount(); }
+
 		static Action OnInitialized;
 
+		// Called once for a batch of RepaintSceneView, the scene view widget schedules a repaint.
+		static Action OnRepaintRequested;
+
+		// Called after each frame of the scene view: the views of what the frame may have changed refresh
+		// (the Inspector compares the dirty counts of its objects).
+		static Action OnFrameDrawn;
+
 	private:
+		static RepaintScheduler	s_sceneViewRepaint;
 
 	public:
 		static std::unique_ptr<SceneViewEditor>  m_mainSceneViewEditor;
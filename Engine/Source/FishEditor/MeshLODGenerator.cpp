@@ -0,0 +1,245 @@
+#include "MeshLODGenerator.hpp"
+#include "ModelImporter.hpp"
+
+#include <FishEngine/Application.hpp>
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/JobSystem.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshSimplifier.hpp>
+#include <FishEngine/Timer.hpp>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace FishEngine;
+
+namespace
+{
+	// bump when the output of MeshSimplifier changes
+	constexpr uint32_t CacheVersion = 2;
+
+	constexpr int MaxLevelCount = 8;
+
+	struct CacheHeader
+	{
+		char		magic[4] = { 'F', 'L', 'O', 'D' };
+		uint32_t	version = CacheVersion;
+		int64_t		sourceTime = 0;
+		float		globalScale = 1;
+		int32_t		importNormals = 0;
+		int32_t		importTangents = 0;
+		int32_t		meshCount = 0;
+		int32_t		ratioCount = 0;
+		float		ratios[MaxLevelCount] = {};
+
+		bool operator==(CacheHeader const & rhs) const
+		{
+			return std::equal(magic, magic + 4, rhs.magic) && version == rhs.version && sourceTime == rhs.sourceTime
+				&& globalScale == rhs.globalScale && importNormals == rhs.importNormals && importTangents == rhs.importTangents
+				&& meshCount == rhs.meshCount && ratioCount == rhs.ratioCount && std::equal(ratios, ratios + MaxLevelCount, rhs.ratios);
+		}
+	};
+
+	// The LODs of one mesh.
+	struct MeshLODs
+	{
+		uint32_t					sourceVertexCount = 0;
+		uint32_t					sourceTriangleCount = 0;
+		std::vector<MeshGeometry>	levels;		// from LOD 1
+		std::vector<float>			errors;
+	};
+
+	Path CachePath(FishEditor::AssetImporter const & importer)
+	{
+		return Application::dataPath().parent_path() / "Library" / "MeshLOD" / (ToString(importer.GetGUID()) + ".bin");
+	}
+
+	template<typename T>
+	void Write(std::ofstream & fout, std::vector<T> const & v)
+	{
+		uint32_t size = static_cast<uint32_t>(v.size());
+		fout.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		fout.write(reinterpret_cast<const char*>(v.data()), size * sizeof(T));
+	}
+
+	template<typename T>
+	void Read(std::ifstream & fin, std::vector<T> & v)
+	{
+		uint32_t size = 0;
+		fin.read(reinterpret_cast<char*>(&size), sizeof(size));
+		if (!fin)
+			return;
+		v.resize(size);
+		fin.read(reinterpret_cast<char*>(v.data()), size * sizeof(T));
+	}
+
+	bool LoadCache(Path const & path, CacheHeader const & expected, std::vector<MeshLODs> & lods)
+	{
+		std::ifstream fin(path.string(), std::ios::binary);
+		if (!fin)
+			return false;
+		CacheHeader header;
+		fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!fin || !(header == expected))
+			return false;
+		lods.resize(header.meshCount);
+		for (auto & m : lods)
+		{
+			uint32_t levelCount = 0;
+			fin.read(reinterpret_cast<char*>(&m.sourceVertexCount), sizeof(m.sourceVertexCount));
+			fin.read(reinterpret_cast<char*>(&m.sourceTriangleCount), sizeof(m.sourceTriangleCount));
+			fin.read(reinterpret_cast<char*>(&levelCount), sizeof(levelCount));
+			if (!fin || levelCount > MaxLevelCount)
+				return false;
+			m.levels.resize(levelCount);
+			Read(fin, m.errors);
+			for (auto & g : m.levels)
+			{
+				Read(fin, g.vertices);
+				Read(fin, g.normals);
+				Read(fin, g.uv);
+				Read(fin, g.tangents);
+				Read(fin, g.boneWeights);
+				Read(fin, g.triangles);
+				Read(fin, g.subMeshIndexOffset);
+			}
+			if (m.errors.size() != levelCount)
+				return false;
+		}
+		return static_cast<bool>(fin);
+	}
+
+	void SaveCache(Path const & path, CacheHeader const & header, std::vector<MeshLODs> const & lods)
+	{
+		boost::system::error_code ec;
+		boost::filesystem::create_directories(path.parent_path(), ec);
+		std::ofstream fout(path.string(), std::ios::binary);
+		if (!fout)
+		{
+			LogWarning("Can not write the mesh LOD cache: " + path.string());
+			return;
+		}
+		fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (auto const & m : lods)
+		{
+			uint32_t levelCount = static_cast<uint32_t>(m.levels.size());
+			fout.write(reinterpret_cast<const char*>(&m.sourceVertexCount), sizeof(m.sourceVertexCount));
+			fout.write(reinterpret_cast<const char*>(&m.sourceTriangleCount), sizeof(m.sourceTriangleCount));
+			fout.write(reinterpret_cast<const char*>(&levelCount), sizeof(levelCount));
+			Write(fout, m.errors);
+			for (auto const & g : m.levels)
+			{
+				Write(fout, g.vertices);
+				Write(fout, g.normals);
+				Write(fout, g.uv);
+				Write(fout, g.tangents);
+				Write(fout, g.boneWeights);
+				Write(fout, g.triangles);
+				Write(fout, g.subMeshIndexOffset);
+			}
+		}
+	}
+
+	MeshLODs Simplify(MeshGeometry const & source, std::vector<float> const & ratios)
+	{
+		MeshLODs result;
+		result.sourceVertexCount = static_cast<uint32_t>(source.vertices.size());
+		result.sourceTriangleCount = source.triangleCount();
+		result.levels.reserve(ratios.size());	// previous points into it
+		MeshGeometry const * previous = &source;
+		float error = 0;
+		for (float ratio : ratios)
+		{
+			if (ratio <= 0)
+				break;
+			auto target = static_cast<uint32_t>(ratio * source.triangleCount());
+			if (target >= previous->triangleCount())
+				continue;
+			auto level = MeshSimplifier::Simplify(*previous, target);
+			auto count = level.triangleCount();
+			if (count == 0 || count > (1.0f - FishEditor::MeshLODGenerator::MinReduction) * previous->triangleCount())
+				break;
+			// measured against the source, the errors of the successive simplifications do not add up
+			error = std::max(error, MeshSimplifier::GeometricError(source, level));
+			result.errors.push_back(error);
+			result.levels.push_back(std::move(level));
+			previous = &result.levels.back();
+		}
+		return result;
+	}
+}
+
+
+namespace FishEditor
+{
+	constexpr float MeshLODGenerator::MinReduction;
+
+	void MeshLODGenerator::Generate(ModelImporter const & importer, std::vector<MeshPtr> const & meshes)
+	{
+		auto const & ratios = importer.m_lodTargetRatios;
+		if (ratios.empty() || meshes.empty())
+			return;
+		if (ratios.size() > MaxLevelCount)
+			LogWarning(Format("Mesh LOD: only the first %1% levels are generated", MaxLevelCount));
+
+		boost::system::error_code ec;
+		CacheHeader header;
+		header.sourceTime = static_cast<int64_t>(boost::filesystem::last_write_time(importer.assetPath(), ec));
+		header.globalScale = importer.m_globalScale;
+		header.importNormals = static_cast<int32_t>(importer.m_importNormals);
+		header.importTangents = static_cast<int32_t>(importer.m_importTangents);
+		header.meshCount = static_cast<int32_t>(meshes.size());
+		header.ratioCount = static_cast<int32_t>(std::min<size_t>(ratios.size(), MaxLevelCount));
+		std::copy(ratios.begin(), ratios.begin() + header.ratioCount, header.ratios);
+		std::vector<float> levelRatios(header.ratios, header.ratios + header.ratioCount);
+
+		auto path = CachePath(importer);
+		std::vector<MeshLODs> lods;
+		bool cached = !ec && LoadCache(path, header, lods);
+		for (size_t i = 0; cached && i < meshes.size(); ++i)
+		{
+			cached = lods[i].sourceVertexCount == meshes[i]->m_vertices.size()
+				&& lods[i].sourceTriangleCount == meshes[i]->m_triangles.size() / 3;
+		}
+
+		if (!cached)
+		{
+			Timer t("Mesh LOD: " + importer.assetPath().string());
+			std::vector<MeshGeometry> sources;
+			sources.reserve(meshes.size());
+			for (auto const & mesh : meshes)
+				sources.push_back(MeshGeometry::FromMesh(*mesh));
+
+			lods.clear();
+			lods.resize(meshes.size());
+			JobSystem::ParallelFor(sources.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+					lods[i] = Simplify(sources[i], levelRatios);
+			});
+
+			if (!ec)
+				SaveCache(path, header, lods);
+			t.StopAndPrint();
+		}
+
+		// the Mesh objects are created here, on the main thread
+		for (size_t i = 0; i < meshes.size(); ++i)
+		{
+			auto & mesh = meshes[i];
+			std::vector<MeshPtr> levels;
+			std::string report;
+			for (size_t level = 0; level < lods[i].levels.size(); ++level)
+			{
+				auto const & geometry = lods[i].levels[level];
+				auto lod = geometry.ToMesh(*mesh);
+				lod->setName(Format("%1%_LOD%2%", mesh->name(), level + 1));
+				levels.push_back(lod);
+				report += Format(" %1% (error %2%)", geometry.triangleCount(), lods[i].errors[level]);
+			}
+			if (!levels.empty())
+				LogInfo(Format("%1%: %2% triangles, LODs:%3%", mesh->name(), mesh->m_triangles.size() / 3, report));
+			mesh->SetLODs(std::move(levels), std::move(lods[i].errors));
+		}
+	}
+}
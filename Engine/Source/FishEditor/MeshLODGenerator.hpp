@@ -0,0 +1,30 @@
+#ifndef MeshLODGenerator_hpp
+#define MeshLODGenerator_hpp
+
+#include "FishEditor.hpp"
+#include <FishEngine/ReflectClass.hpp>
+
+namespace FishEditor
+{
+	class ModelImporter;
+
+	// Levels of detail of the meshes of a model, for ModelImporter::lodTargetRatios().
+	//
+	// Level i keeps about lodTargetRatios()[i-1] of the triangles of the mesh, it is simplified from level i-1 by
+	// MeshSimplifier; its error is measured against the mesh itself. The meshes are simplified in parallel on the
+	// JobSystem, and the result is kept in the Library folder of the project (Library/MeshLOD/<guid>.bin) until the
+	// source file or the import settings change.
+	class Meta(NonSerializable) MeshLODGenerator
+	{
+	public:
+		MeshLODGenerator() = delete;
+
+		// meshes: imported from the asset of importer, not uploaded yet. Must be called on the main thread.
+		static void Generate(ModelImporter const & importer, std::vector<FishEngine::MeshPtr> const & meshes);
+
+		// A level removing less than this fraction of the triangles of the previous one ends the chain.
+		static constexpr float MinReduction = 0.1f;
+	};
+}
+
+#endif // MeshLODGenerator_hpp
@@ -693,6 +693,7 @@ namespace FishEditor
 		m_importNormals = rhs.m_importNormals;
 		m_importTangents = rhs.m_importTangents;
 		m_materialSearch = rhs.m_materialSearch;
+		m_lodTargetRatios = rhs.m_lodTargetRatios;
 		return *this;
 	}
 	
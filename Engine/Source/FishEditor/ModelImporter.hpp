@@ -179,6 +179,17 @@ namespace FishEditor
 			m_importTangents = importTangents;
 		}
 
+		// Triangle ratio of each generated level of detail of the meshes (LOD 1, 2...), relative to the mesh.
+		std::vector<float> const & lodTargetRatios() const
+		{
+			return m_lodTargetRatios;
+		}
+
+		void setLodTargetRatios( std::vector<float> const & lodTargetRatios )
+		{
+			m_lodTargetRatios = lodTargetRatios;
+		}
+
 	protected:
 
 		Meta(NonSerializable)
@@ -191,6 +202,7 @@ namespace FishEditor
 		friend class Inspector;
 		friend class MainEditor;
 		friend class ::ModelImporterInspector;
+		friend class MeshLODGenerator;
 
 		static void Init();
 
@@ -211,6 +223,9 @@ namespace FishEditor
 		// Existing material search setting.
 		ModelImporterMaterialSearch m_materialSearch;
 
+		// Levels of detail generated for the meshes (MeshLODGenerator), none if empty.
+		std::vector<float> m_lodTargetRatios;
+
 		// remove dummy nodes
 		Meta(NonSerializable)
 		std::map<std::string, std::map<std::string, FishEngine::Matrix4x4>> m_nodeTransformations;
@@ -0,0 +1,352 @@
+#include "PropertyArchive.hpp"
+
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Component.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Serialization/Archive.hpp>
+
+#include <cstring>
+#include <sstream>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace
+{
+	/*
+	 * Flattens an object into one binary blob per top-level field:
+	 *     numbers:     raw bytes
+	 *     strings:     uint32 size, bytes
+	 *     containers:  uint32 size, items
+	 *     references:  int32, -1 for null, an index in PropertyValue::references,
+	 *                  or -2-ordinal for an object of the subtree being serialized
+	 * Field names and nested structure are implied by the order of Serialize and Deserialize, which are generated in pairs.
+	 */
+	class PropertyWriter : public OutputArchive
+	{
+	public:
+		PropertyWriter(PropertyValues & values, LocalOrdinals const * local = nullptr)
+			: m_values(values), m_local(local)
+		{
+		}
+
+		virtual void BeginMap(std::size_t mapSize) override
+		{
+			Write(static_cast<uint32_t>(mapSize));
+		}
+
+		virtual void BeginSequence(std::size_t sequenceSize) override
+		{
+			Write(static_cast<uint32_t>(sequenceSize));
+		}
+
+	protected:
+		virtual void Serialize(short t) override				{ Write(t); }
+		virtual void Serialize(unsigned short t) override		{ Write(t); }
+		virtual void Serialize(int t) override					{ Write(t); }
+		virtual void Serialize(unsigned int t) override			{ Write(t); }
+		virtual void Serialize(long t) override					{ Write(t); }
+		virtual void Serialize(unsigned long t) override		{ Write(t); }
+		virtual void Serialize(long long t) override			{ Write(t); }
+		virtual void Serialize(unsigned long long t) override	{ Write(t); }
+		virtual void Serialize(float t) override				{ Write(t); }
+		virtual void Serialize(double t) override				{ Write(t); }
+		virtual void Serialize(bool t) override					{ Write(t); }
+
+		virtual void Serialize(std::string const & t) override
+		{
+			Write(static_cast<uint32_t>(t.size()));
+			if (m_current != nullptr)
+				m_current->data.append(t);
+		}
+
+		virtual void Serialize(const char* t) override
+		{
+			Serialize(std::string(t));
+		}
+
+		virtual void Serialize(std::nullptr_t const &) override
+		{
+			Write<int32_t>(-1);
+		}
+
+		virtual void SerializeObject(ObjectPtr const & obj) override
+		{
+			WriteReference(obj);
+		}
+
+		virtual void SerializeWeakObject(std::weak_ptr<Object> const & obj) override
+		{
+			WriteReference(obj.lock());
+		}
+
+		virtual void SerializeNameOfNVP(const char* name) override
+		{
+			if (m_depth++ == 0)
+			{
+				m_values.emplace_back();
+				m_current = &m_values.back();
+				m_current->name = name;
+			}
+		}
+
+		virtual void MiddleOfNVP() override
+		{
+		}
+
+		virtual void EndNVP() override
+		{
+			if (--m_depth == 0)
+				m_current = nullptr;
+		}
+
+	private:
+		template<typename T>
+		void Write(T const & value)
+		{
+			// values outside of a name-value pair have nowhere to go
+			if (m_current != nullptr)
+				m_current->data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		void WriteReference(ObjectPtr const & obj)
+		{
+			if (obj == nullptr || m_current == nullptr)
+			{
+				Write<int32_t>(-1);
+				return;
+			}
+			if (m_local != nullptr)
+			{
+				auto it = m_local->find(obj->GetInstanceID());
+				if (it != m_local->end())
+				{
+					Write<int32_t>(-2 - it->second);
+					return;
+				}
+			}
+			Write(static_cast<int32_t>(m_current->references.size()));
+			m_current->references.push_back(obj);
+		}
+
+		PropertyValues &		m_values;
+		LocalOrdinals const *	m_local;
+		PropertyValue *			m_current = nullptr;
+		int						m_depth = 0;
+	};
+
+
+	// Writes PropertyValues back into an object through its Deserialize function.
+	class PropertyReader : public InputArchive
+	{
+	public:
+		// Every top-level field of the object must be in values.
+		PropertyReader(std::unordered_map<std::string, PropertyValue const *> const & values, LocalObjects const * local = nullptr)
+			: InputArchive(m_unused), m_values(values), m_local(local)
+		{
+		}
+
+		bool failed() const { return m_failed; }
+
+		// top-level fields whose data was too short or too long for them
+		std::vector<std::string> const & mismatched() const { return m_mismatched; }
+
+		virtual void BeginClass() override {}
+		virtual void EndClass() override {}
+
+	protected:
+		virtual void Deserialize(short & t) override				{ Read(t); }
+		virtual void Deserialize(unsigned short & t) override		{ Read(t); }
+		virtual void Deserialize(int & t) override					{ Read(t); }
+		virtual void Deserialize(unsigned int & t) override			{ Read(t); }
+		virtual void Deserialize(long & t) override					{ Read(t); }
+		virtual void Deserialize(unsigned long & t) override		{ Read(t); }
+		virtual void Deserialize(long long & t) override			{ Read(t); }
+		virtual void Deserialize(unsigned long long & t) override	{ Read(t); }
+		virtual void Deserialize(float & t) override				{ Read(t); }
+		virtual void Deserialize(double & t) override				{ Read(t); }
+		virtual void Deserialize(bool & t) override					{ Read(t); }
+
+		virtual void Deserialize(std::string & t) override
+		{
+			uint32_t size = 0;
+			if (!Read(size))
+				return;
+			if (m_end - m_cursor < size)
+			{
+				m_failed = true;
+				return;
+			}
+			t.assign(m_cursor, size);
+			m_cursor += size;
+		}
+
+		virtual void DeserializeObject(ObjectPtr & obj) override
+		{
+			ReadReference(obj);
+		}
+
+		virtual void DeserializeWeakObject(std::weak_ptr<Object> & obj) override
+		{
+			ObjectPtr p;
+			if (ReadReference(p))
+				obj = p;
+		}
+
+		virtual std::size_t BeginMap() override
+		{
+			uint32_t size = 0;
+			Read(size);
+			return size;
+		}
+
+		virtual void BeforeMapKey() override {}
+		virtual void AfterMapKey() override {}
+		virtual void AfterMapValue() override {}
+		virtual void EndMap() override {}
+
+		virtual std::size_t BeginSequence() override
+		{
+			uint32_t size = 0;
+			Read(size);
+			return size;
+		}
+
+		virtual void BeforeASequenceItem() override {}
+		virtual void AfterASequenceItem() override {}
+		virtual void EndSequence() override {}
+
+		virtual void NameOfNVP(const char* name) override
+		{
+			if (m_depth++ != 0)
+				return;
+			m_fieldFailed = false;
+			auto it = m_values.find(name);
+			if (it == m_values.end())
+			{
+				m_failed = true;
+				m_current = nullptr;
+				m_cursor = m_end = nullptr;
+				return;
+			}
+			m_current = it->second;
+			m_cursor = m_current->data.data();
+			m_end = m_cursor + m_current->data.size();
+		}
+
+		virtual void MiddleOfNVP() override {}
+
+		virtual void EndNVP() override
+		{
+			if (--m_depth == 0 && m_current != nullptr && (m_fieldFailed || m_cursor != m_end))
+				m_mismatched.push_back(m_current->name);
+		}
+
+	private:
+		template<typename T>
+		bool Read(T & value)
+		{
+			if (m_cursor == nullptr || m_end - m_cursor < static_cast<ptrdiff_t>(sizeof(T)))
+			{
+				m_failed = true;
+				m_fieldFailed = true;
+				return false;
+			}
+			std::memcpy(&value, m_cursor, sizeof(T));
+			m_cursor += sizeof(T);
+			return true;
+		}
+
+		bool ReadReference(ObjectPtr & obj)
+		{
+			int32_t index = 0;
+			if (!Read(index))
+				return false;
+			if (index == -1)
+			{
+				obj = nullptr;
+			}
+			else if (index >= 0 && index < static_cast<int32_t>(m_current->references.size()))
+			{
+				obj = m_current->references[index];
+			}
+			else if (index <= -2 && m_local != nullptr && -2 - index < static_cast<int32_t>(m_local->size()))
+			{
+				obj = (*m_local)[-2 - index];
+			}
+			else
+			{
+				m_failed = true;
+				m_fieldFailed = true;
+				return false;
+			}
+			return true;
+		}
+
+		std::istringstream		m_unused;	// InputArchive wants a stream; only referenced, never read
+		std::unordered_map<std::string, PropertyValue const *> const & m_values;
+		LocalObjects const *	m_local;
+		PropertyValue const *	m_current = nullptr;
+		const char *			m_cursor = nullptr;
+		const char *			m_end = nullptr;
+		int						m_depth = 0;
+		bool					m_failed = false;
+		bool					m_fieldFailed = false;
+		std::vector<std::string>	m_mismatched;
+	};
+}
+
+namespace FishEditor
+{
+	PropertyValues CaptureProperties(Object const & object, LocalOrdinals const * local)
+	{
+		PropertyValues values;
+		PropertyWriter writer(values, local);
+		object.Serialize(writer);
+		return values;
+	}
+
+	bool ApplyProperties(Object & object, PropertyValues const & changed, LocalObjects const * local, std::vector<std::string> * mismatched)
+	{
+		auto current = CaptureProperties(object);
+		std::unordered_map<std::string, PropertyValue const *> values;
+		for (auto const & p : current)
+			values[p.name] = &p;
+		for (auto const & p : changed)
+			values[p.name] = &p;
+
+		PropertyReader reader(values, local);
+		object.Deserialize(reader);
+		if (mismatched != nullptr)
+			*mismatched = reader.mismatched();
+
+		object.SetDirty();
+		auto component = dynamic_cast<Component*>(&object);
+		if (component != nullptr)
+		{
+			component->OnValidate();
+		}
+		auto go = dynamic_cast<GameObject*>(&object);
+		if (go != nullptr)
+		{
+			// the fields were written directly, tell the hierarchy views
+			for (auto const & p : changed)
+			{
+				if (p.name == "m_name")
+					Scene::NotifyHierarchyChanged(HierarchyChange::Renamed, go);
+				else if (p.name == "m_activeSelf")
+					Scene::NotifyHierarchyChanged(HierarchyChange::ActiveChanged, go);
+			}
+		}
+		return !reader.failed();
+	}
+
+	size_t MemorySize(PropertyValues const & values)
+	{
+		size_t size = 0;
+		for (auto const & v : values)
+			size += v.memorySize();
+		return size;
+	}
+}
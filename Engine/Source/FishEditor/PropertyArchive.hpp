@@ -0,0 +1,51 @@
+#ifndef PropertyArchive_hpp
+#define PropertyArchive_hpp
+
+#include "FishEditor.hpp"
+
+#include <unordered_map>
+
+namespace FishEditor
+{
+	// A top-level serialized field of an object, e.g. "m_localPosition".
+	struct PropertyValue
+	{
+		std::string				name;
+		std::string				data;			// binary, see PropertyArchive.cpp
+		std::vector<FishEngine::ObjectPtr>	references;		// objects referenced by data
+
+		size_t memorySize() const
+		{
+			return sizeof(*this) + name.size() + data.size() + references.size() * sizeof(FishEngine::ObjectPtr);
+		}
+
+		bool operator==(PropertyValue const & rhs) const
+		{
+			return name == rhs.name && data == rhs.data && references == rhs.references;
+		}
+	};
+
+	typedef std::vector<PropertyValue> PropertyValues;
+
+	// Objects of a serialized subtree, referenced by their index (ordinal) instead of a pointer.
+	typedef std::unordered_map<int, int> LocalOrdinals;	// instanceID -> ordinal
+	typedef std::vector<FishEngine::ObjectPtr> LocalObjects;		// ordinal -> object
+
+	// The top-level fields of the object, as written by its Serialize function.
+	// Objects in local are referenced by their ordinal, the others are kept in PropertyValue::references.
+	PropertyValues CaptureProperties(FishEngine::Object const & object, LocalOrdinals const * local = nullptr);
+
+	// Writes the given properties into the object through its Deserialize function, its other fields keep
+	// their current value. Returns false if a property could not be read back.
+	// mismatched (optional) receives the names of the properties whose data does not fit the field
+	// (the type of the field changed since they were captured).
+	bool ApplyProperties(
+		FishEngine::Object & object,
+		PropertyValues const & changed,
+		LocalObjects const * local = nullptr,
+		std::vector<std::string> * mismatched = nullptr);
+
+	size_t MemorySize(PropertyValues const & values);
+}
+
+#endif // PropertyArchive_hpp
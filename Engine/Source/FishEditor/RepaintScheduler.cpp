@@ -0,0 +1,38 @@
+#include "RepaintScheduler.hpp"
+
+#include <cassert>
+
+namespace FishEditor
+{
+	void RepaintScheduler::Request()
+	{
+		if (m_pending)
+			return;
+		m_pending = true;
+		m_onRequested();
+	}
+
+	void RepaintScheduler::BeginFrame()
+	{
+		// requests made while drawing are already taken into account by this frame
+		m_pending = true;
+		m_frameCount++;
+	}
+
+	void RepaintScheduler::EndFrame()
+	{
+		m_pending = false;
+	}
+
+	void RepaintScheduler::BeginContinuous()
+	{
+		if (m_continuousCount++ == 0)
+			Request();
+	}
+
+	void RepaintScheduler::EndContinuous()
+	{
+		assert(m_continuousCount > 0);
+		m_continuousCount--;
+	}
+}
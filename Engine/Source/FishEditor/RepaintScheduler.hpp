@@ -0,0 +1,44 @@
+#ifndef RepaintScheduler_hpp
+#define RepaintScheduler_hpp
+
+#include "FishEditor.hpp"
+#include <FishEngine/ReflectClass.hpp>
+
+namespace FishEditor
+{
+	// Repaint requests of a view that is redrawn on demand (MainEditor::RepaintSceneView).
+	// The requests made until the next frame are coalesced into one call of the callback; the ones made while a
+	// frame is being drawn (between BeginFrame and EndFrame) are already part of that frame and are dropped.
+	class Meta(NonSerializable) RepaintScheduler
+	{
+	public:
+		// onRequested: schedules a frame (QWidget::update).
+		explicit RepaintScheduler(Action::Actor const & onRequested)
+			: m_onRequested(onRequested)
+		{
+		}
+
+		void Request();
+
+		void BeginFrame();
+		void EndFrame();
+
+		// While a continuous repaint is active (animated previews), the view is redrawn every frame.
+		// Begin and End must be paired; they nest.
+		void BeginContinuous();
+		void EndContinuous();
+
+		bool continuous() const { return m_continuousCount > 0; }
+
+		// Number of frames drawn, for profiling.
+		uint64_t frameCount() const { return m_frameCount; }
+
+	private:
+		Action::Actor	m_onRequested;
+		bool			m_pending = false;
+		int				m_continuousCount = 0;
+		uint64_t		m_frameCount = 0;
+	};
+}
+
+#endif // RepaintScheduler_hpp
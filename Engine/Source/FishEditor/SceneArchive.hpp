@@ -30,7 +30,7 @@ namespace FishEditor
 		void RecursiveLoad(YAML::Node const & node);
 		
 		
-		//virtual void DeserializeObject(FishEngine::ObjectPtr const & obj) override
+		//virtual void DeserializeObject(FishEngine::ObjectPtr & obj) override
 		//{
 		//	abort();
 		//}
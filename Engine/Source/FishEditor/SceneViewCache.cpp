@@ -0,0 +1,94 @@
+#include "SceneViewCache.hpp"
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/SkinnedMeshRenderer.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <deque>
+
+using namespace FishEngine;
+
+namespace
+{
+	// dirtyCount of a GameObject and its components. The Transform is not one of the Components(): moves do not
+	// count, the children are followed through the hierarchy notifications.
+	uint32_t OutlineSourceVersion(GameObjectPtr const & go)
+	{
+		uint32_t version = go->dirtyCount();
+		for (auto const & c : go->Components())
+			version += c->dirtyCount();
+		return version;
+	}
+}
+
+namespace FishEditor
+{
+	uint64_t SceneContentVersion()
+	{
+		return Object::totalDirtyCount();
+	}
+
+	bool OutlineDrawList::Update(std::list<std::weak_ptr<Transform>> const & selection)
+	{
+		if (!m_dirty)
+		{
+			// components added or removed, meshes assigned
+			for (auto const & s : m_sources)
+			{
+				auto go = s.first.lock();
+				if (go == nullptr || OutlineSourceVersion(go) != s.second)
+				{
+					m_dirty = true;
+					break;
+				}
+			}
+			if (!m_dirty)
+				return false;
+		}
+
+		m_items.clear();
+		m_sources.clear();
+		std::deque<GameObjectPtr> selections;
+		for (auto const & t : selection)
+		{
+			auto transform = t.lock();
+			if (transform != nullptr)
+				selections.push_back(transform->gameObject());
+		}
+		while (!selections.empty())
+		{
+			auto go = selections.front();
+			selections.pop_front();
+			if (go == nullptr)
+			{
+				continue;
+			}
+			m_sources.emplace_back(go, OutlineSourceVersion(go));
+			for (auto& c : go->transform()->children())
+			{
+				selections.push_back(c->gameObject());
+			}
+			MeshPtr mesh;
+			auto meshFilter = go->GetComponent<MeshFilter>();
+			if (meshFilter != nullptr)
+			{
+				mesh = meshFilter->mesh();
+			}
+			else
+			{
+				auto skinnedMeshRenderer = go->GetComponent<SkinnedMeshRenderer>();
+				if (skinnedMeshRenderer != nullptr)
+				{
+					mesh = skinnedMeshRenderer->sharedMesh();
+				}
+			}
+			if (mesh != nullptr)
+			{
+				m_items.push_back({ go->transform(), mesh });
+			}
+		}
+		m_dirty = false;
+		return true;
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef SceneViewCache_hpp
+#define SceneViewCache_hpp
+
+#include "FishEditor.hpp"
+#include <FishEngine/ReflectClass.hpp>
+
+namespace FishEditor
+{
+	// Changes whenever something rendered by a camera may have changed: the GameObjects of the scene, their
+	// transforms and components are marked dirty when they are modified (Inspector, Undo, scripts), materials too.
+	// The camera preview of the scene view is re-rendered only when it changes. Object::totalDirtyCount: it costs
+	// nothing per frame, whatever the size of the scene.
+	uint64_t SceneContentVersion();
+
+	// The meshes of the selected objects and their children, drawn into the selection outline.
+	// Kept between frames: rebuilt when invalidated (selection or hierarchy changed), or when a component of an
+	// object it was built from was added, removed or modified (a mesh assigned). The transforms are read when
+	// drawing.
+	class Meta(NonSerializable) OutlineDrawList
+	{
+	public:
+		struct Item
+		{
+			std::weak_ptr<FishEngine::Transform>	transform;
+			FishEngine::MeshPtr						mesh;
+		};
+
+		void Invalidate() { m_dirty = true; }
+
+		// Returns true if the list was rebuilt.
+		bool Update(std::list<std::weak_ptr<FishEngine::Transform>> const & selection);
+
+		std::vector<Item> const & items() const { return m_items; }
+
+	private:
+		std::vector<Item>	m_items;
+		// the GameObjects m_items was built from, and their version
+		std::vector<std::pair<std::weak_ptr<FishEngine::GameObject>, uint32_t>>	m_sources;
+		bool				m_dirty = true;
+	};
+}
+
+#endif // SceneViewCache_hpp
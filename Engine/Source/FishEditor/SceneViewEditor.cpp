@@ -19,11 +19,13 @@
 #include <FishEngine/CameraController.hpp>
 #include <FishEngine/Graphics.hpp>
 #include <FishEngine/RenderTarget.hpp>
-#include <FishEngine/Command.hpp>
 #include <FishEngine/RenderBuffer.hpp>
 #include <FishEngine/Light.hpp>
+#include <FishEngine/Application.hpp>
 
 #include "Selection.hpp"
+#include "SceneViewCache.hpp"
+#include "Undo.hpp"
 #include "EditorResources.hpp"
 #include "ModelImporter.hpp"
 //#include "FishEditorWindow.hpp"
@@ -39,6 +41,8 @@ namespace FishEditor
 	MeshPtr coneMesh = nullptr;
 	SimpleMeshPtr gridMesh = nullptr;
 
+	constexpr float cameraPreviewScale = 0.25f;
+
 	void SceneViewEditor::Init()
 	{
 		Input::Init();
@@ -90,6 +94,23 @@ namespace FishEditor
 		m_selectionOutlineColorBuffer2->setWrapMode(TextureWrapMode::Clamp);
 		m_selectionOutlineRT2->SetColorBufferOnly(m_selectionOutlineColorBuffer2);
 
+		const int previewWidth = static_cast<int>(m_size.x * cameraPreviewScale);
+		const int previewHeight = static_cast<int>(m_size.y * cameraPreviewScale);
+		m_cameraPreviewColorBuffer = ColorBuffer::Create(previewWidth, previewHeight);
+		m_cameraPreviewColorBuffer->setName("CameraPreviewColor");
+		m_cameraPreviewDepthBuffer = DepthBuffer::Create(previewWidth, previewHeight);
+		m_cameraPreviewDepthBuffer->setName("CameraPreviewDepth");
+		m_cameraPreviewRT = std::make_shared<RenderTarget>();
+		m_cameraPreviewRT->Set(m_cameraPreviewColorBuffer, m_cameraPreviewDepthBuffer);
+
+		// the outline is drawn from a cached list of meshes
+		Selection::selectionChanged += [this]() {
+			m_outlineDrawList.Invalidate();
+		};
+		Scene::AddHierarchyListener([this](HierarchyChange, GameObject*) {
+			m_outlineDrawList.Invalidate();
+		});
+
 		constexpr int rows = 10;
 		constexpr int vertex_count = (rows * 2 + 1) * 2 * 2;
 		float grid_vertex[vertex_count * 3];
@@ -164,71 +185,9 @@ namespace FishEditor
 		/************************************************************************/
 		/* Selection                                                            */
 		/************************************************************************/
-		auto selection = Selection::transforms();
-		if (m_highlightSelections && !selection.empty())
+		if (m_highlightSelections && !Selection::transforms().empty())
 		{
-			Pipeline::PushRenderTarget(m_selectionOutlineRT);
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-			auto material = Material::builtinMaterial("SolidColor");
-			material->SetVector4("Color", Vector4(1, 0, 1, 1));
-
-			std::list<GameObjectPtr> selections;
-			for (auto const & t : selection)
-			{
-				selections.push_back(t.lock()->gameObject());
-			}
-
-			while (!selections.empty())
-			{
-				auto go = selections.front();
-				selections.pop_front();
-				if (go == nullptr)
-				{
-					continue;
-				}
-				auto& children = go->transform()->children();
-				for (auto& c : children)
-				{
-					selections.push_back(c->gameObject());
-				}
-				MeshPtr mesh;
-				auto meshFilter = go->GetComponent<MeshFilter>();
-				if (meshFilter != nullptr)
-				{
-					mesh = meshFilter->mesh();
-				}
-				else
-				{
-					auto skinnedMeshRenderer = go->GetComponent<SkinnedMeshRenderer>();
-					if (skinnedMeshRenderer != nullptr)
-					{
-						mesh = skinnedMeshRenderer->sharedMesh();
-					}
-				}
-				if (mesh != nullptr)
-				{
-					auto model = go->transform()->localToWorldMatrix() * Matrix4x4::Scale(1.001f, 1.001f, 1.001f);
-					Graphics::DrawMesh(mesh, model, material);
-				}
-			}
-
-			Pipeline::PopRenderTarget();
-
-			// draw outline
-			Pipeline::PushRenderTarget(m_selectionOutlineRT2);
-			glClear(GL_COLOR_BUFFER_BIT);
-			auto selection_outline_mtl = Material::builtinMaterial("PostProcessSelectionOutline");
-			auto quad = Mesh::builtinMesh(PrimitiveType::ScreenAlignedQuad);
-			selection_outline_mtl->SetTexture("StencilTexture", m_selectionOutlineDepthBuffer);
-			selection_outline_mtl->SetTexture("ColorTexture", m_colorBuffer);
-			selection_outline_mtl->SetTexture("DepthTexture", RenderSystem::m_mainDepthBuffer);
-			Graphics::DrawMesh(quad, selection_outline_mtl);
-			Pipeline::PopRenderTarget();
-
-			m_selectionOutlineRT2->AttachForRead();
-			auto w = m_colorBuffer->width();
-			auto h = m_colorBuffer->height();
-			glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			DrawSelectionOutline();
 		}
 
 		if (m_isWireFrameMode)
@@ -254,33 +213,11 @@ namespace FishEditor
 		/************************************************************************/
 		/* Camera Preview                                                       */
 		/************************************************************************/
-		//glClear(GL_DEPTH_BUFFER_BIT);
-		//auto selectedGO = Selection::selectedGameObjectInHierarchy();
-#if 0
-		auto camera_preview = selectedGO == nullptr ? nullptr : selectedGO->GetComponent<Camera>();
-		if (camera_preview != nullptr)
-		{
-			const int w = Screen::width();
-			const int h = Screen::height();
-			//auto v = camera_preview->viewport();
-			const int preview_width = static_cast<int>(w * 0.25f);
-			const int preview_height = static_cast<int>(h * 0.25f);
-			constexpr int padding = 20;
-			const int preview_pos_x = w - preview_width - padding;
-			const int preview_pos_y = padding;
-			glViewport(preview_pos_x, preview_pos_y, preview_width, preview_height);
-			auto main_camera = Camera::main();
-			Screen::m_width = static_cast<int>(w*0.25f);
-			Screen::m_height = static_cast<int>(h*0.25f);
-			Camera::m_mainCamera = camera_preview;
-
-			Pipeline::BindCamera(camera_preview);
-			RenderSystem::Render();
-			Camera::m_mainCamera = main_camera;
-			Screen::m_width = w;
-			Screen::m_height = h;
-		}
-#endif
+		auto cameraPreview = selectedGO == nullptr ? nullptr : selectedGO->GetComponent<Camera>();
+		if (cameraPreview != nullptr && cameraPreview != m_camera)
+		{
+			DrawCameraPreview(cameraPreview);
+		}
 
 		glClear(GL_DEPTH_BUFFER_BIT);
 		DrawSceneGizmo();
@@ -319,6 +256,77 @@ namespace FishEditor
 		Pipeline::PopRenderTarget();
 	}
 
+	void SceneViewEditor::DrawSelectionOutline()
+	{
+		m_outlineDrawList.Update(Selection::transforms());
+
+		Pipeline::PushRenderTarget(m_selectionOutlineRT);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		auto material = Material::builtinMaterial("SolidColor");
+		material->SetVector4("Color", Vector4(1, 0, 1, 1));
+
+		// same material for all the meshes: bind it once
+		auto shader = material->shader();
+		shader->Use();
+		shader->PreRender();
+		material->BindProperties();
+		shader->CheckStatus();
+		const auto scale = Matrix4x4::Scale(1.001f, 1.001f, 1.001f);
+		for (auto const & item : m_outlineDrawList.items())
+		{
+			auto transform = item.transform.lock();
+			if (transform == nullptr)
+				continue;
+			Pipeline::UpdatePerDrawUniforms(transform->localToWorldMatrix() * scale);
+			item.mesh->Render();
+		}
+		shader->PostRender();
+
+		Pipeline::PopRenderTarget();
+
+		// draw outline
+		Pipeline::PushRenderTarget(m_selectionOutlineRT2);
+		glClear(GL_COLOR_BUFFER_BIT);
+		auto selection_outline_mtl = Material::builtinMaterial("PostProcessSelectionOutline");
+		auto quad = Mesh::builtinMesh(PrimitiveType::ScreenAlignedQuad);
+		selection_outline_mtl->SetTexture("StencilTexture", m_selectionOutlineDepthBuffer);
+		selection_outline_mtl->SetTexture("ColorTexture", m_colorBuffer);
+		selection_outline_mtl->SetTexture("DepthTexture", RenderSystem::m_mainDepthBuffer);
+		Graphics::DrawMesh(quad, selection_outline_mtl);
+		Pipeline::PopRenderTarget();
+
+		m_selectionOutlineRT2->AttachForRead();
+		auto w = m_colorBuffer->width();
+		auto h = m_colorBuffer->height();
+		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+
+	void SceneViewEditor::DrawCameraPreview(CameraPtr const & camera)
+	{
+		const int previewWidth = m_cameraPreviewColorBuffer->width();
+		const int previewHeight = m_cameraPreviewColorBuffer->height();
+
+		// re-rendered only when the camera or the scene changed; in play mode every frame changes
+		auto version = SceneContentVersion();
+		if (Application::isPlaying() || camera->GetInstanceID() != m_cameraPreviewID || version != m_cameraPreviewVersion)
+		{
+			Pipeline::PushRenderTarget(m_cameraPreviewRT);
+			glViewport(0, 0, previewWidth, previewHeight);
+			RenderSystem::Render(camera, RenderQuality::Preview, previewWidth, previewHeight);
+			Pipeline::PopRenderTarget();
+			glViewport(0, 0, m_size.x, m_size.y);
+			Pipeline::BindCamera(m_camera);
+			m_cameraPreviewID = camera->GetInstanceID();
+			m_cameraPreviewVersion = version;
+		}
+
+		constexpr int padding = 20;
+		const int x = m_size.x - previewWidth - padding;
+		const int y = padding;
+		m_cameraPreviewRT->AttachForRead();
+		glBlitFramebuffer(0, 0, previewWidth, previewHeight, x, y, x + previewWidth, y + previewHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
+
 	float MiddleElement(float t[3])
 	{
 		float tmid = t[0];
@@ -483,9 +491,6 @@ namespace FishEditor
 
 		auto& axis_selected = axis[m_selectedAxis];
 
-		static std::function<void(void)> undo_function;
-		static std::function<void(void)> redo_function;
-
 		// handle mouse movement event
 		if (Input::GetMouseButtonDown(0))   // start
 		{
@@ -494,11 +499,10 @@ namespace FishEditor
 			Ray ray = Camera::main()->ScreenPointToRay(Input::mousePosition());
 			float t = solve(center, axis_selected, camera_pos, ray.direction);
 			lastMousePosition = ray.GetPoint(t);
-			const auto position = selectedGO->transform()->position();
-			undo_function = [selectedGO, position]() {
-				LogWarning("Undo translation");
-				selectedGO->transform()->setPosition(position);
-			};
+			for (auto & t : Selection::transforms())
+			{
+				Undo::RecordObject(t.lock(), "Move");
+			}
 		}
 		else if (Input::GetMouseButton(0))       // moving
 		{
@@ -522,12 +526,7 @@ namespace FishEditor
 		else if (Input::GetMouseButtonUp(0))    // end
 		{
 			m_mouseEventHandled = false;
-			const auto position = selectedGO->transform()->position();
-			redo_function = [selectedGO, position]() {
-				LogWarning("Redo translation");
-				selectedGO->transform()->setPosition(position);
-			};
-			//CommandManager::AddCommand(std::make_pair(undo_function, redo_function));
+			Undo::FlushGesture();
 		}
 	}
 
@@ -558,9 +557,6 @@ namespace FishEditor
 			axis[1] = Vector3::up;      // +y
 			axis[2] = Vector3::forward; // +z
 		}
-		
-		static std::function<void(void)> undo_function;
-		static std::function<void(void)> redo_function;
 
 		// check if any axis is selected by mouse
 		if (Input::GetMouseButtonDown(0))
@@ -581,13 +577,7 @@ namespace FishEditor
 						lastFromDir = Vector3::Cross(axis[i], Vector3::Cross(dir, axis[i]));
 						lastFromDir.Normalize();
 						lastRotation = selectedGO->transform()->localRotation();
-						
-						const auto rotation = selectedGO->transform()->rotation();
-						undo_function = [selectedGO, rotation]() {
-							LogWarning("Undo rotation");
-							selectedGO->transform()->setRotation(rotation);
-						};
-
+						Undo::RecordObject(selectedGO->transform(), "Rotate");
 					}
 				}
 			}
@@ -639,12 +629,7 @@ namespace FishEditor
 		else if (Input::GetMouseButtonUp(0)) // end
 		{
 			m_mouseEventHandled = false;
-			const auto rotation = selectedGO->transform()->rotation();
-			redo_function = [selectedGO, rotation]() {
-				LogWarning("Redo rotation");
-				selectedGO->transform()->setRotation(rotation);
-			};
-			CommandManager::AddCommand(std::make_pair(undo_function, redo_function));
+			Undo::FlushGesture();
 		}
 	}
 
@@ -763,9 +748,6 @@ namespace FishEditor
 
 		auto& axis_selected = axis[m_selectedAxis];
 
-		//static std::function<void(void)> undo_function;
-		//static std::function<void(void)> redo_function;
-
 		static float t_old = 0;
 		static float scale_old = 1;
 
@@ -780,11 +762,7 @@ namespace FishEditor
 			t_old = solve(camera_pos, ray.direction, center, axis_selected);
 			lastMousePosition = center + axis_selected * t_old;
 			scale_old =  selectedGO->transform()->localScale()[m_selectedAxis];
-//            const auto position = selectedGO->transform()->position();
-//            undo_function = [selectedGO, position]() {
-//                Debug::LogWarning("Undo translation");
-//                selectedGO->transform()->setPosition(position);
-//            };
+			Undo::RecordObject(selectedGO->transform(), "Scale");
 			//Debug::LogWarning("t_old = %f", t_old);
 		}
 		else if (Input::GetMouseButton(0))       // moving
@@ -809,12 +787,7 @@ namespace FishEditor
 		{
 			m_mouseEventHandled = false;
 			axis_scale = 1.0f;
-//            const auto position = selectedGO->transform()->position();
-//            redo_function = [selectedGO, position]() {
-//                Debug::LogWarning("Redo translation");
-//                selectedGO->transform()->setPosition(position);
-//            };
-			//CommandManager::AddCommand(std::make_pair(undo_function, redo_function));
+			Undo::FlushGesture();
 		}
 	}
 
@@ -957,6 +930,9 @@ namespace FishEditor
 		m_depthBuffer->Resize(width, height);
 		m_selectionOutlineDepthBuffer->Resize(width, height);
 		m_selectionOutlineColorBuffer2->Resize(width, height);
+		m_cameraPreviewColorBuffer->Resize(static_cast<int>(width * cameraPreviewScale), static_cast<int>(height * cameraPreviewScale));
+		m_cameraPreviewDepthBuffer->Resize(static_cast<int>(width * cameraPreviewScale), static_cast<int>(height * cameraPreviewScale));
+		m_cameraPreviewID = 0;
 		RenderSystem::ResizeBufferSize(width, height);
 		Camera::OnWindowSizeChanged(width, height);
 		Light::ResizeShadowMaps();
@@ -6,6 +6,7 @@
 #include <FishEngine/IntVector.hpp>
 #include <FishEngine/Input.hpp>
 #include <FishEngine/ReflectClass.hpp>
+#include "SceneViewCache.hpp"
 
 namespace FishEditor
 {
@@ -52,6 +53,11 @@ namespace FishEditor
 		FishEngine::RenderTargetPtr     m_selectionOutlineRT2;
 		FishEngine::ColorBufferPtr      m_selectionOutlineColorBuffer2;
 
+		// preview of the selected camera, at 1/4 of the scene view size
+		FishEngine::RenderTargetPtr     m_cameraPreviewRT;
+		FishEngine::ColorBufferPtr      m_cameraPreviewColorBuffer;
+		FishEngine::DepthBufferPtr      m_cameraPreviewDepthBuffer;
+
 		void Init();
 
 		void Update();
@@ -156,6 +162,15 @@ namespace FishEditor
 		void DrawRotateGizmo();
 		void DrawScaleGizmo();
 		void DrawSceneGizmo();
+
+		void DrawSelectionOutline();
+		void DrawCameraPreview(FishEngine::CameraPtr const & camera);
+
+		OutlineDrawList		m_outlineDrawList;
+
+		// what m_cameraPreviewRT shows
+		int			m_cameraPreviewID		= 0;
+		uint64_t	m_cameraPreviewVersion	= 0;
 	};
 
 	typedef std::shared_ptr<SceneViewEditor> SceneViewEditorPtr;
@@ -1,5 +1,7 @@
 #include "ScriptManager.hpp"
 #include <memory>
+#include <algorithm>
+#include <unordered_map>
 
 #ifdef _DEBUG
 #undef _DEBUG
@@ -8,12 +10,18 @@
 #else
 #include <Python.h>
 #endif
-#include <boost/dll/import.hpp>
+#include <boost/dll/shared_library.hpp>
 
 #include <FishEngine/Application.hpp>
 #include <FishEngine/Debug.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Script.hpp>
 
 #include "EditorApplication.hpp"
+#include "MainEditor.hpp"
+#include "PropertyArchive.hpp"
+#include "Undo.hpp"
 
 // TODO: CMAKE_INTDIR not defined in makefile
 #ifndef CMAKE_INTDIR
@@ -23,110 +31,303 @@
 using namespace FishEngine;
 using namespace FishEditor;
 
-struct ScriptManagerImpl
+// One loaded copy of the script library.
+struct ScriptLibrary
 {
-	Path sharedLibPath;
+	Path	path;		// the copy, removed when unloaded
+	boost::dll::shared_library library;
+	Script* (*create)(const char*) = nullptr;
+	void (*destroy)(Script*) = nullptr;
 
-	boost::dll::detail::library_function<Script*(const char*)> createFunc;
-	boost::dll::detail::library_function<void(Script *)> deleteFunc;
+	explicit ScriptLibrary(Path const & path)
+		: path(path), library(path)
+	{
+		create = &library.get<Script*(const char*)>("CreateCustomScript");
+		destroy = &library.get<void(Script*)>("DestroyCustomScript");
+	}
 
-	ScriptManagerImpl(Path const & path)
-		: sharedLibPath(path),
-		createFunc(boost::dll::import<Script*(const char*)>(path, "CreateCustomScript")),
-		deleteFunc(boost::dll::import<void(Script*)>(path, "DestroyCustomScript"))
+	~ScriptLibrary()
 	{
+		library.unload();
+		boost::system::error_code ec;
+		boost::filesystem::remove(path, ec);
 	}
 };
 
 
-ScriptManager::ScriptManager()
+namespace
 {
-	BuildScriptsInProject();
-	auto project_name = Application::dataPath().parent_path().stem().string();
+	Path BuiltLibraryPath()
+	{
+		auto project_name = Application::dataPath().parent_path().stem().string();
 #if FISHENGINE_PLATFORM_WINDOWS
-	auto path = Format("../build/%1%/%2%.dll", CMAKE_INTDIR, project_name);
+		auto path = Format("../build/%1%/%2%.dll", CMAKE_INTDIR, project_name);
 #else
-	auto path = Format("../build/%1%/lib%2%.dylib", CMAKE_INTDIR, project_name);
+		auto path = Format("../build/%1%/lib%2%.dylib", CMAKE_INTDIR, project_name);
 #endif
-	auto sharedLibPath = Application::dataPath() / path;
-	if (!boost::filesystem::exists(sharedLibPath))
+		return Application::dataPath() / path;
+	}
+
+	bool IsScriptSource(Path const & path)
 	{
-		LogError(sharedLibPath.string() + " not found");
-		abort();
-		//return;
+		auto ext = path.extension();
+		return ext == ".hpp" || ext == ".h" || ext == ".cpp";
 	}
-	m_impl = new ScriptManagerImpl(sharedLibPath);
+}
+
+
+ScriptManager * ScriptManager::s_instance = nullptr;
+ScriptManager::BuildFunction ScriptManager::s_buildFunction;
+
+ScriptManager::ScriptManager()
+{
+	s_instance = this;
+	BuildScriptsInProject();
+	UpdateSourceTimes();
+	m_library = LoadScriptLibrary();
 }
 
 ScriptManager::~ScriptManager()
 {
-	delete m_impl;
+	if (m_pythonInitialized)
+		Py_Finalize();
+	s_instance = nullptr;
 }
 
 ScriptPtr ScriptManager::CreateScript(std::string const & name)
 {
-	auto s = std::shared_ptr<Script>(m_impl->createFunc(name.c_str()), [this](auto s) {
-		LogInfo("Delete from dll");
-		m_impl->deleteFunc(s);
+	if (m_library == nullptr)
+	{
+		LogError("ScriptManager::CreateScript, the scripts are not loaded");
+		return nullptr;
+	}
+	auto script = m_library->create(name.c_str());
+	if (script == nullptr)
+		return nullptr;
+	// The instance keeps its library loaded. The deleter lives as long as the weak_ptrs of m_scripts:
+	// it lets the library go itself, so that the library is unloaded with its last instance.
+	auto library = m_library;
+	auto s = std::shared_ptr<Script>(script, [library](Script* s) mutable {
+		library->destroy(s);
+		library.reset();
 	});
+	m_scripts.remove_if([](std::weak_ptr<Script> const & w) { return w.expired(); });
 	m_scripts.push_back(s);
 	return s;
 }
 
-void FishEditor::ScriptManager::BuildScriptsInProject()
+std::shared_ptr<ScriptLibrary> ScriptManager::LoadScriptLibrary()
 {
-#if FISHENGINE_PLATFORM_APPLE
-	auto python_lib_paths = {
-		L"/Users/yushroom/Downloads/Python-3.6.1/Lib",	// sys lib
-		L"/Users/yushroom/.pyenv/versions/3.6.1/lib/python3.6/site-packages", // mako
-		L"/Users/yushroom/program/FishEngine/Script/Editor", // editor
-		L"/Users/yushroom/Downloads/Python-3.6.1/debug/build/lib.macosx-10.12-x86_64-3.6-pydebug" // sys lib
-	};
-	std::wstring path;
-	for (auto & p : python_lib_paths)
+	auto builtPath = BuiltLibraryPath();
+	if (!boost::filesystem::exists(builtPath))
 	{
-		path += p;
-		path += L":";
+		LogError(builtPath.string() + " not found");
+		return nullptr;
 	}
-#else
-	auto python_lib_paths = {
-		LR"(D:\program\github\FishEngine\Engine\Binary\Debug\Tools\Python36\Lib)",	// sys lib
-		LR"(D:\program\github\FishEngine\Engine\Binary\Debug\Tools\Python36\DLLs)",
-		LR"(D:\program\github\FishEngine\Engine\Binary\Debug\Scripts)",
-		LR"(D:\program\github\FishEngine\Tools\Python36\Lib\site-packages)", // mako
-	};
-	std::wstring path;
-	for (auto & p : python_lib_paths)
+
+	// The build overwrites the library while it is loaded (locked on Windows), and loading the same path
+	// twice returns the library already loaded: load a copy with a new name.
+	m_libraryVersion++;
+	auto dir = builtPath.parent_path() / "HotReload";
+	auto path = dir / Format("%1%.%2%%3%", builtPath.stem().string(), m_libraryVersion, builtPath.extension().string());
+	try
+	{
+		boost::filesystem::create_directories(dir);
+		boost::filesystem::remove(path);	// left by a previous session
+		boost::filesystem::copy_file(builtPath, path);
+		return std::make_shared<ScriptLibrary>(path);
+	}
+	catch (std::exception const & e)
+	{
+		LogError(Format("Can not load %1%: %2%", path.string(), e.what()));
+		return nullptr;
+	}
+}
+
+bool ScriptManager::UpdateSourceTimes()
+{
+	std::map<Path, std::time_t> times;
+	boost::system::error_code ec;
+	for (boost::filesystem::recursive_directory_iterator it(Application::dataPath(), ec), end; it != end; it.increment(ec))
 	{
-		path += p;
-		path += L";";
+		auto const & path = it->path();
+		if (boost::filesystem::is_regular_file(path, ec) && IsScriptSource(path))
+			times[path] = boost::filesystem::last_write_time(path, ec);
 	}
+	if (times == m_sourceTimes)
+		return false;
+	m_sourceTimes.swap(times);
+	return true;
+}
+
+void ScriptManager::ReloadIfChanged()
+{
+	if (UpdateSourceTimes())
+		Reload();
+}
+
+void ScriptManager::Reload()
+{
+	if (!BuildScriptsInProject())
+	{
+		LogError("Scripts: build failed, the loaded scripts are kept");
+		return;
+	}
+	auto library = LoadScriptLibrary();
+	if (library == nullptr)
+		return;
+	m_library = library;
+
+	std::list<std::weak_ptr<Script>> scripts;
+	scripts.swap(m_scripts);
+
+	// old instance -> new instance
+	std::unordered_map<Object*, ObjectPtr> replaced;
+	for (auto const & weak : scripts)
+	{
+		auto script = weak.lock();
+		if (script == nullptr)
+			continue;
+		auto className = script->ClassName();
+		auto go = script->gameObject();
+		auto values = CaptureProperties(*script);
+
+		auto newScript = CreateScript(className);
+		if (newScript == nullptr)
+		{
+			LogWarning(Format("Scripts: %1% no longer exists, it is removed", className));
+			if (go != nullptr)
+				go->RemoveComponent(script);
+			continue;
+		}
+		std::vector<std::string> mismatched;
+		ApplyProperties(*newScript, values, nullptr, &mismatched);
+		if (!mismatched.empty())
+		{
+			// the type of these fields changed, they get their default value: start over without them
+			for (auto const & name : mismatched)
+				LogWarning(Format("Scripts: the type of %1%::%2% changed, it is reset", className, name));
+			values.erase(std::remove_if(values.begin(), values.end(), [&mismatched](PropertyValue const & v) {
+				return std::find(mismatched.begin(), mismatched.end(), v.name) != mismatched.end();
+			}), values.end());
+			newScript = CreateScript(className);
+			ApplyProperties(*newScript, values);
+		}
+
+		if (go != nullptr)
+		{
+			std::replace(go->m_components.begin(), go->m_components.end(), ComponentPtr(script), ComponentPtr(newScript));
+			go->SetDirty();
+		}
+		replaced[script.get()] = newScript;
+	}
+
+	// other objects referencing the old instances (scripts, mostly)
+	if (!replaced.empty())
+	{
+		for (auto const & go : Scene::GameObjects())
+		{
+			for (auto const & c : go->Components())
+			{
+				PropertyValues changed;
+				for (auto & v : CaptureProperties(*c))
+				{
+					bool hit = false;
+					for (auto & r : v.references)
+					{
+						auto it = replaced.find(r.get());
+						if (it != replaced.end())
+						{
+							r = it->second;
+							hit = true;
+						}
+					}
+					if (hit)
+						changed.push_back(std::move(v));
+				}
+				if (!changed.empty())
+					ApplyProperties(*c, changed);
+			}
+		}
+	}
+
+	// the history refers to the old instances
+	Undo::ClearAll();
+	MainEditor::RepaintSceneView();
+	LogInfo(Format("Scripts reloaded (%1% instances)", replaced.size()));
+}
+
+bool FishEditor::ScriptManager::BuildScriptsInProject()
+{
+	if (s_buildFunction)
+		return s_buildFunction(BuiltLibraryPath());
+
+	if (!m_pythonInitialized)
+	{
+#if FISHENGINE_PLATFORM_APPLE
+		auto python_lib_paths = {
+			L"/Users/yushroom/Downloads/Python-3.6.1/Lib",	// sys lib
+			L"/Users/yushroom/.pyenv/versions/3.6.1/lib/python3.6/site-packages", // mako
+			L"/Users/yushroom/program/FishEngine/Script/Editor", // editor
+			L"/Users/yushroom/Downloads/Python-3.6.1/debug/build/lib.macosx-10.12-x86_64-3.6-pydebug" // sys lib
+		};
+		std::wstring path;
+		for (auto & p : python_lib_paths)
+		{
+			path += p;
+			path += L":";
+		}
+#else
+		auto python_lib_paths = {
+			LR"(D:\program\github\FishEngine\Engine\Binary\Debug\Tools\Python36\Lib)",	// sys lib
+			LR"(D:\program\github\FishEngine\Engine\Binary\Debug\Tools\Python36\DLLs)",
+			LR"(D:\program\github\FishEngine\Engine\Binary\Debug\Scripts)",
+			LR"(D:\program\github\FishEngine\Tools\Python36\Lib\site-packages)", // mako
+		};
+		std::wstring path;
+		for (auto & p : python_lib_paths)
+		{
+			path += p;
+			path += L";";
+		}
 #endif
-	Py_SetPath(path.c_str());
-	Py_Initialize();
-	PyRun_SimpleString("import os\nfrom mako.template import Template\nprint('Hello Python')\n");
+		// the interpreter is kept for the next builds (reload)
+		Py_SetPath(path.c_str());
+		Py_Initialize();
+		PyRun_SimpleString("import os\nfrom mako.template import Template\nprint('Hello Python')\n");
+		m_pythonInitialized = true;
+	}
+
 	auto pName = PyUnicode_DecodeFSDefault("BuildProject");
 	auto pModule = PyImport_Import(pName);
-	assert(pModule != nullptr);
+	Py_CLEAR(pName);
+	if (pModule == nullptr)
+	{
+		LogError("Scripts: can not import BuildProject");
+		return false;
+	}
 	auto pFunc = PyObject_GetAttrString(pModule, "buildProject");
 	if (!pFunc || !PyCallable_Check(pFunc))
-		abort();
+	{
+		LogError("Scripts: BuildProject.buildProject not found");
+		Py_XDECREF(pFunc);
+		Py_CLEAR(pModule);
+		return false;
+	}
 	auto buildPath = Application::dataPath().parent_path();
 	auto pBuildPath = PyUnicode_DecodeFSDefault(buildPath.string().c_str());
 	auto pBuildType = PyUnicode_DecodeFSDefault(CMAKE_INTDIR);
 	auto cmakePath = EditorApplication::applicationPath() / "Tools/cmake/bin/cmake";
 	auto pCmakePath = PyUnicode_DecodeFSDefault(cmakePath.string().c_str());
 	auto pArgs = PyTuple_New(3);
-	PyTuple_SetItem(pArgs, 0, pBuildPath);
+	PyTuple_SetItem(pArgs, 0, pBuildPath);	// steals the references
 	PyTuple_SetItem(pArgs, 1, pBuildType);
 	PyTuple_SetItem(pArgs, 2, pCmakePath);
-	PyObject_CallObject(pFunc, pArgs);
-//	Py_CLEAR(pCmakePath);
-//	Py_CLEAR(pBuildType);
-//	Py_CLEAR(pBuildPath);
-//	Py_CLEAR(pArgs);
-//	Py_CLEAR(pFunc);
-//	Py_CLEAR(pModule);
-//	Py_CLEAR(pName);
-	Py_Finalize();
+	auto pResult = PyObject_CallObject(pFunc, pArgs);
+	bool succeeded = pResult != nullptr && PyLong_Check(pResult) && PyLong_AsLong(pResult) == 0;
+	Py_XDECREF(pResult);
+	Py_CLEAR(pArgs);
+	Py_CLEAR(pFunc);
+	Py_CLEAR(pModule);
+	return succeeded;
 }
@@ -1,12 +1,23 @@
 #pragma once
 
 #include <FishEngine/ReflectClass.hpp>
+#include <FishEngine/Path.hpp>
 #include "FishEditor.hpp"
 
-struct ScriptManagerImpl;
+#include <ctime>
+#include <functional>
+
+struct ScriptLibrary;
 
 namespace FishEditor
 {
+	// Builds the scripts of the project (the .hpp and .cpp files in Assets) into a shared library,
+	// and creates the script instances from it.
+	//
+	// Scripts are reloaded without restarting the editor: the library is rebuilt (only the changed
+	// translation units are recompiled) and a copy of it is loaded next to the current one. Every live script
+	// is then replaced by an instance of its new class, which gets the serialized fields of the old one.
+	// A library is unloaded when its last instance is destroyed.
 	class Meta(NonSerializable) ScriptManager
 	{
 	public:
@@ -16,12 +27,29 @@ namespace FishEditor
 			return manager;
 		}
 
-		void BuildScriptsInProject();
+		// Has GetInstance been called? (projects without scripts never build them)
+		static bool hasInstance() { return s_instance != nullptr; }
+
+		// Replaces the build of the scripts (BuildProject.py, through Python and CMake), e.g. in the tests.
+		// build writes the library to the given path and returns false if it failed. Set it before GetInstance.
+		typedef std::function<bool(FishEngine::Path const & library)> BuildFunction;
+		static void SetBuildFunction(BuildFunction build) { s_buildFunction = std::move(build); }
 
+		// Returns false if the build failed.
+		bool BuildScriptsInProject();
+
+		// Rebuilds the scripts and swaps the live instances for instances of the new library.
+		// If the build fails, the current scripts are kept.
 		void Reload();
 
+		// Reloads if a script source was modified, added or removed since the last build.
+		void ReloadIfChanged();
+
 		FishEngine::ScriptPtr CreateScript(std::string const & name);
 
+		// Number of times the script library was loaded.
+		int libraryVersion() const { return m_libraryVersion; }
+
 	private:
 		ScriptManager();
 		~ScriptManager();
@@ -30,7 +58,18 @@ namespace FishEditor
 		ScriptManager(ScriptManager &&) = delete;
 		ScriptManager& operator=(ScriptManager const &) = delete;
 
-		ScriptManagerImpl *		m_impl = nullptr;
-		std::list<FishEngine::ScriptPtr>	m_scripts;
+		std::shared_ptr<ScriptLibrary> LoadScriptLibrary();
+
+		// Updates m_sourceTimes, returns true if they changed.
+		bool UpdateSourceTimes();
+
+		static ScriptManager *	s_instance;
+		static BuildFunction	s_buildFunction;
+
+		std::shared_ptr<ScriptLibrary>			m_library;
+		int										m_libraryVersion = 0;
+		std::list<std::weak_ptr<FishEngine::Script>>	m_scripts;
+		std::map<FishEngine::Path, std::time_t>	m_sourceTimes;
+		bool									m_pythonInitialized = false;
 	};
 }
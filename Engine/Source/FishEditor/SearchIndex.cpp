@@ -0,0 +1,499 @@
+#include "SearchIndex.hpp"
+#include "Asset.hpp"
+
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Component.hpp>
+#include <FishEngine/Application.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <unordered_map>
+
+using namespace FishEngine;
+
+namespace
+{
+	struct Entry
+	{
+		std::weak_ptr<Object>	object;
+		int						instanceID = 0;
+		int						classID = 0;
+		bool					alive = false;
+		bool					isSceneObject = false;
+		std::string				displayName;	// for word starts (camelCase)
+		std::string				name;			// lower case
+		std::string				path;			// lower case, relative to the Assets folder; empty for scene objects
+		std::vector<uint32_t>	trigrams;		// distinct trigrams of name and path
+		std::multimap<std::string, uint32_t>::iterator byName;
+	};
+
+	std::vector<Entry>									s_entries;
+	std::vector<uint32_t>								s_freeEntries;
+	size_t												s_entryCount = 0;
+	std::unordered_map<uint32_t, std::vector<uint32_t>>	s_trigrams;
+	std::multimap<std::string, uint32_t>				s_byName;
+	std::unordered_map<int, uint32_t>					s_byInstanceID;
+	std::map<Path, std::vector<uint32_t>>				s_byAssetPath;
+	// lower case class name -> class id, of the classes met so far (for "t:")
+	std::unordered_map<std::string, int>				s_classIDs;
+
+	inline char Lower(char c)
+	{
+		return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+
+	std::string ToLower(std::string s)
+	{
+		std::transform(s.begin(), s.end(), s.begin(), Lower);
+		return s;
+	}
+
+	// s must be lower case
+	inline uint32_t Trigram(std::string const & s, size_t i)
+	{
+		return (static_cast<unsigned char>(s[i]) << 16) | (static_cast<unsigned char>(s[i+1]) << 8) | static_cast<unsigned char>(s[i+2]);
+	}
+
+	void AddTrigrams(std::string const & s, std::vector<uint32_t> & trigrams)
+	{
+		for (size_t i = 0; i + 3 <= s.size(); ++i)
+			trigrams.push_back(Trigram(s, i));
+	}
+
+	inline bool StartsWith(std::string const & s, std::string const & prefix)
+	{
+		return s.compare(0, prefix.size(), prefix) == 0;
+	}
+
+	bool IsWordStart(std::string const & s, size_t pos)
+	{
+		if (pos == 0)
+			return true;
+		unsigned char prev = s[pos-1];
+		unsigned char c = s[pos];
+		return !std::isalnum(prev) || (std::isupper(c) && std::islower(prev));
+	}
+
+	void LearnClass(Object const & object)
+	{
+		s_classIDs.emplace(ToLower(object.ClassName()), object.ClassID());
+	}
+
+	uint32_t AddEntry(ObjectPtr const & object, std::string const & path, bool isSceneObject)
+	{
+		uint32_t id;
+		if (!s_freeEntries.empty())
+		{
+			id = s_freeEntries.back();
+			s_freeEntries.pop_back();
+		}
+		else
+		{
+			id = static_cast<uint32_t>(s_entries.size());
+			s_entries.emplace_back();
+		}
+		s_entryCount++;
+
+		auto & e = s_entries[id];
+		e.object = object;
+		e.instanceID = object->GetInstanceID();
+		e.classID = object->ClassID();
+		e.alive = true;
+		e.isSceneObject = isSceneObject;
+		e.displayName = object->name();
+		e.name = ToLower(e.displayName);
+		e.path = ToLower(path);
+		e.trigrams.clear();
+		AddTrigrams(e.name, e.trigrams);
+		AddTrigrams(e.path, e.trigrams);
+		std::sort(e.trigrams.begin(), e.trigrams.end());
+		e.trigrams.erase(std::unique(e.trigrams.begin(), e.trigrams.end()), e.trigrams.end());
+		for (auto t : e.trigrams)
+			s_trigrams[t].push_back(id);
+		e.byName = s_byName.emplace(e.name, id);
+		s_byInstanceID[e.instanceID] = id;
+		LearnClass(*object);
+		return id;
+	}
+
+	void RemoveEntry(uint32_t id)
+	{
+		auto & e = s_entries[id];
+		if (!e.alive)
+			return;
+		for (auto t : e.trigrams)
+		{
+			auto it = s_trigrams.find(t);
+			auto & ids = it->second;
+			ids.erase(std::find(ids.begin(), ids.end(), id));
+			if (ids.empty())
+				s_trigrams.erase(it);
+		}
+		s_byName.erase(e.byName);
+		auto it = s_byInstanceID.find(e.instanceID);
+		if (it != s_byInstanceID.end() && it->second == id)
+			s_byInstanceID.erase(it);
+		e.object.reset();
+		e.alive = false;
+		s_freeEntries.push_back(id);
+		s_entryCount--;
+	}
+
+	// RemoveEntry for many entries, which expire at once (scene closed, assets unloaded): each posting list
+	// touched is filtered once instead of once per entry.
+	void RemoveEntries(std::vector<uint32_t> const & ids)
+	{
+		if (ids.size() == 1)
+		{
+			RemoveEntry(ids[0]);
+			return;
+		}
+		std::vector<uint32_t> touched;
+		std::vector<uint32_t> removed;
+		for (auto id : ids)
+		{
+			auto & e = s_entries[id];
+			if (!e.alive)
+				continue;
+			touched.insert(touched.end(), e.trigrams.begin(), e.trigrams.end());
+			s_byName.erase(e.byName);
+			auto it = s_byInstanceID.find(e.instanceID);
+			if (it != s_byInstanceID.end() && it->second == id)
+				s_byInstanceID.erase(it);
+			e.object.reset();
+			e.alive = false;
+			removed.push_back(id);
+		}
+		std::sort(touched.begin(), touched.end());
+		touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+		for (auto t : touched)
+		{
+			auto it = s_trigrams.find(t);
+			auto & list = it->second;
+			list.erase(std::remove_if(list.begin(), list.end(), [](uint32_t id) { return !s_entries[id].alive; }), list.end());
+			if (list.empty())
+				s_trigrams.erase(it);
+		}
+		// reusable once out of the posting lists
+		s_freeEntries.insert(s_freeEntries.end(), removed.begin(), removed.end());
+		s_entryCount -= removed.size();
+	}
+
+	void AddGameObject(GameObject * go)
+	{
+		auto t = go->transform();
+		if (t == nullptr)
+			return;
+		auto ptr = t->gameObject();
+		if (ptr == nullptr)
+			return;
+		auto it = s_byInstanceID.find(go->GetInstanceID());
+		if (it != s_byInstanceID.end())
+			RemoveEntry(it->second);
+		AddEntry(ptr, std::string(), true);
+	}
+
+	void RemoveGameObject(GameObject * go)
+	{
+		auto it = s_byInstanceID.find(go->GetInstanceID());
+		if (it != s_byInstanceID.end())
+			RemoveEntry(it->second);
+		auto t = go->transform();
+		if (t == nullptr)
+			return;
+		for (auto const & child : t->children())
+		{
+			auto g = child->gameObject();
+			if (g != nullptr)
+				RemoveGameObject(g.get());
+		}
+	}
+
+	// Score of one term (lower case) against an entry, 0 if it does not match.
+	int ScoreTerm(Entry const & e, std::string const & term)
+	{
+		if (e.name == term)
+			return 1000;
+		if (StartsWith(e.name, term))
+			return 800;
+		if (term.size() < 3)
+			return 0;
+
+		auto pos = e.name.find(term);
+		if (pos != std::string::npos)
+		{
+			for (auto p = pos; p != std::string::npos; p = e.name.find(term, p + 1))
+			{
+				if (IsWordStart(e.displayName, p))
+					return 600;
+			}
+			return 400;
+		}
+		if (e.path.find(term) != std::string::npos)
+			return 200;
+
+		// typo: at least half of the trigrams of the term are in the name
+		int count = static_cast<int>(term.size()) - 2;
+		int hits = 0;
+		for (size_t i = 0; i + 3 <= term.size(); ++i)
+		{
+			if (e.name.find(term.c_str() + i, 0, 3) != std::string::npos)
+				hits++;
+		}
+		if (hits * 2 >= count)
+			return 100 * hits / count;
+		return 0;
+	}
+
+	// Entries that may match the term: see ScoreTerm.
+	void Candidates(std::string const & term, std::vector<uint32_t> & candidates)
+	{
+		if (term.size() < 3)
+		{
+			for (auto it = s_byName.lower_bound(term); it != s_byName.end() && StartsWith(it->first, term); ++it)
+				candidates.push_back(it->second);
+			return;
+		}
+
+		int count = static_cast<int>(term.size()) - 2;
+		std::unordered_map<uint32_t, int> hits;
+		for (size_t i = 0; i + 3 <= term.size(); ++i)
+		{
+			auto it = s_trigrams.find(Trigram(term, i));
+			if (it == s_trigrams.end())
+				continue;
+			for (auto id : it->second)
+				hits[id]++;
+		}
+		for (auto const & h : hits)
+		{
+			if (h.second * 2 >= count)
+				candidates.push_back(h.first);
+		}
+	}
+
+	struct Query
+	{
+		std::vector<std::string>	terms;			// lower case
+		std::vector<std::string>	typeNames;		// lower case
+	};
+
+	Query ParseQuery(std::string const & text)
+	{
+		Query q;
+		size_t i = 0;
+		while (i < text.size())
+		{
+			if (std::isspace(static_cast<unsigned char>(text[i])))
+			{
+				i++;
+				continue;
+			}
+			std::string word;
+			if (text[i] == '"')
+			{
+				auto end = text.find('"', i + 1);
+				if (end == std::string::npos)
+					end = text.size();
+				word = text.substr(i + 1, end - i - 1);
+				i = end + 1;
+			}
+			else
+			{
+				auto end = i;
+				while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end])))
+					end++;
+				word = text.substr(i, end - i);
+				i = end;
+			}
+			word = ToLower(word);
+			if (word.size() > 2 && StartsWith(word, "t:"))
+				q.typeNames.push_back(word.substr(2));
+			else if (!word.empty())
+				q.terms.push_back(word);
+		}
+		return q;
+	}
+
+	// Class ids named in the query. A class may only be known once one of its objects is indexed, and
+	// components are added to GameObjects after they are created: look at the scene when a name is unknown.
+	std::vector<int> ResolveTypes(std::vector<std::string> const & typeNames)
+	{
+		std::vector<int> ids;
+		bool sceneScanned = false;
+		for (auto const & name : typeNames)
+		{
+			auto it = s_classIDs.find(name);
+			if (it == s_classIDs.end() && !sceneScanned)
+			{
+				for (auto const & go : Scene::GameObjects())
+				{
+					LearnClass(*go->transform());
+					for (auto const & c : go->Components())
+						LearnClass(*c);
+				}
+				sceneScanned = true;
+				it = s_classIDs.find(name);
+			}
+			if (it != s_classIDs.end())
+				ids.push_back(it->second);
+			else
+				ids.push_back(FishEditor::SearchIndex::AnyClass);	// matches nothing
+		}
+		return ids;
+	}
+
+	bool IsOfClass(Entry const & e, Object const & object, int classID)
+	{
+		if (IsDerivedFrom(e.classID, classID))
+			return true;
+		if (!e.isSceneObject)
+			return false;
+		auto const & go = static_cast<GameObject const &>(object);
+		if (IsDerivedFrom(ClassID<Transform>(), classID))
+			return true;
+		for (auto const & c : go.Components())
+		{
+			if (IsDerivedFrom(c->ClassID(), classID))
+				return true;
+		}
+		return false;
+	}
+}
+
+namespace FishEditor
+{
+	constexpr int		SearchIndex::AnyClass;
+	constexpr size_t	SearchIndex::DefaultLimit;
+
+	void SearchIndex::Init()
+	{
+		for (auto const & go : Scene::GameObjects())
+			AddGameObject(go.get());
+
+		Scene::AddHierarchyListener([](HierarchyChange change, GameObject* go) {
+			switch (change)
+			{
+			case HierarchyChange::Created:
+			case HierarchyChange::Renamed:
+				AddGameObject(go);
+				break;
+			case HierarchyChange::Destroyed:
+				RemoveGameObject(go);
+				break;
+			default: ;
+			}
+		});
+	}
+
+	void SearchIndex::AddAsset(AssetPtr const & asset, Path const & path)
+	{
+		auto relative = path.generic_string();
+		auto assets = Application::dataPath().generic_string();
+		if (StartsWith(relative, assets))
+			relative = relative.substr(assets.size());
+
+		auto & ids = s_byAssetPath[path];
+		auto lowerPath = ToLower(relative);
+		for (auto id : ids)
+		{
+			// the entry may have expired and been reused
+			auto const & e = s_entries[id];
+			if (e.alive && !e.isSceneObject && e.path == lowerPath)
+				RemoveEntry(id);
+		}
+		ids.clear();
+
+		for (auto const & object : asset->m_assetObjects)
+			ids.push_back(AddEntry(object, relative, false));
+	}
+
+	std::vector<SearchIndex::Result> SearchIndex::Search(std::string const & text, int classID, size_t limit)
+	{
+		std::vector<Result> results;
+		auto query = ParseQuery(text);
+		auto types = ResolveTypes(query.typeNames);
+		if (std::find(types.begin(), types.end(), AnyClass) != types.end())
+			return results;
+
+		std::vector<uint32_t> candidates;
+		if (query.terms.empty())
+		{
+			for (uint32_t id = 0; id < s_entries.size(); ++id)
+			{
+				if (s_entries[id].alive)
+					candidates.push_back(id);
+			}
+		}
+		else
+		{
+			// the longest term is the most selective
+			auto longest = std::max_element(query.terms.begin(), query.terms.end(),
+				[](std::string const & a, std::string const & b) { return a.size() < b.size(); });
+			Candidates(*longest, candidates);
+		}
+
+		// objects destroyed without a notification (scene closed, asset unloaded)
+		std::vector<uint32_t> expired;
+		for (auto id : candidates)
+		{
+			auto const & e = s_entries[id];
+			if (classID != AnyClass && !IsDerivedFrom(e.classID, classID))
+				continue;
+
+			int score = 0;
+			for (auto const & term : query.terms)
+			{
+				int s = ScoreTerm(e, term);
+				if (s == 0)
+				{
+					score = 0;
+					break;
+				}
+				score += s;
+			}
+			if (score == 0 && !query.terms.empty())
+				continue;
+
+			auto object = e.object.lock();
+			if (object == nullptr)
+			{
+				expired.push_back(id);
+				continue;
+			}
+			bool ofTypes = std::all_of(types.begin(), types.end(), [&](int t) { return IsOfClass(e, *object, t); });
+			if (ofTypes)
+				results.push_back(Result{object, score, e.isSceneObject});
+		}
+		RemoveEntries(expired);
+
+		// best score, then shortest name
+		auto better = [](Result const & a, Result const & b) {
+			if (a.score != b.score)
+				return a.score > b.score;
+			auto const & na = a.object->name();
+			auto const & nb = b.object->name();
+			if (na.size() != nb.size())
+				return na.size() < nb.size();
+			return na < nb;
+		};
+		if (results.size() > limit)
+		{
+			std::partial_sort(results.begin(), results.begin() + limit, results.end(), better);
+			results.resize(limit);
+		}
+		else
+		{
+			std::sort(results.begin(), results.end(), better);
+		}
+		return results;
+	}
+
+	size_t SearchIndex::entryCount()
+	{
+		return s_entryCount;
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef SearchIndex_hpp
+#define SearchIndex_hpp
+
+#include "FishEditor.hpp"
+#include <FishEngine/ReflectClass.hpp>
+#include <FishEngine/Path.hpp>
+
+namespace FishEditor
+{
+	// Search over the imported assets (name, path and type) and the GameObjects of the scene (name and
+	// component types), for the object pickers and the search fields of the editor.
+	//
+	// The index is kept up to date as assets are imported and GameObjects are created, renamed and destroyed,
+	// so a query only visits the entries that can match it:
+	// - terms of three characters or more go through a trigram index, which also finds names with a typo;
+	// - shorter terms only match the beginning of names, through a sorted list of names.
+	//
+	// Query syntax: space separated terms, all of which must match, e.g. "rock diff t:Texture".
+	// "t:Type" keeps the objects of this class or a derived one (GameObjects: having such a component).
+	// Quotes group several words into one term: "\"main camera\"".
+	// Results are ranked exact name > name prefix > word prefix > substring > path > fuzzy.
+	class Meta(NonSerializable) SearchIndex
+	{
+	public:
+		SearchIndex() = delete;
+
+		struct Result
+		{
+			FishEngine::ObjectPtr	object;
+			int						score;
+			bool					isSceneObject;
+		};
+
+		// Indexes the GameObjects of the scene and listens to its changes.
+		static void Init();
+
+		// Indexes the objects of an asset, replacing the ones previously indexed for this path (reimport).
+		static void AddAsset(AssetPtr const & asset, FishEngine::Path const & path);
+
+		// classID: only the objects of this class or a derived one are returned (AnyClass: no restriction).
+		// At most limit results are returned, best first.
+		static std::vector<Result> Search(
+			std::string const & query,
+			int classID = AnyClass,
+			size_t limit = DefaultLimit);
+
+		// Number of indexed objects.
+		static size_t entryCount();
+
+		static constexpr int	AnyClass = -1;
+		static constexpr size_t	DefaultLimit = 500;
+	};
+}
+
+#endif // SearchIndex_hpp
@@ -33,7 +33,10 @@ namespace FishEditor
 
 		static void setActiveObject(ObjectPtr const & obj)
 		{
+			if (s_activeObject.lock() == obj)
+				return;
 			s_activeObject = obj;
+			activeObjectChanged();
 		}
 
 		// Returns the instanceID of the actual object selection. Includes prefabs, non-modifyable objects.
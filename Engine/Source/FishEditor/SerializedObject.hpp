@@ -47,7 +47,8 @@ namespace FishEditor
 		
 		SerializedPropertyPtr FindProperty(std::string const & propertyPath);
 		
-		bool ApplyModifiedProperties() { return true; };
+		// the views of the target (Inspector) compare its dirty count
+		bool ApplyModifiedProperties() { m_targetObject->SetDirty(); return true; };
 		bool ApplyModifiedPropertiesWithoutUndo();
 		void CopyFromSerializedProperty(SerializedPropertyPtr prop);
 
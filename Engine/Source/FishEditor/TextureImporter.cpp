@@ -7,8 +7,10 @@
 #include <FishEngine/Common.hpp>
 #include <FishEngine/Mathf.hpp>
 #include <FishEngine/Texture2D.hpp>
+#include <FishEngine/Cubemap.hpp>
 
 #include "AssetDataBase.hpp"
+#include "CubemapConvolution.hpp"
 
 #include <QImage>
 
@@ -115,6 +117,7 @@ namespace FishEditor
 		m_sRGBTexture = rhs.m_sRGBTexture;
 		m_isReadable = rhs.m_isReadable;
 		m_mipmapEnabled = rhs.m_mipmapEnabled;
+		m_cubemapConvolution = rhs.m_cubemapConvolution;
 		return *this;
 	}
 	
@@ -178,15 +181,13 @@ namespace FishEditor
 	}
 #endif
 	
-	void TextureImporter::ImportTo(FishEngine::Texture2DPtr & texture)
+	static FIBITMAP* LoadFreeImage(Path const & path)
 	{
 		auto fm_instance = FreeImagePlugin::instance();
 		FREE_IMAGE_FORMAT fif = FIF_UNKNOWN;
 		FIBITMAP *dib = nullptr;
-		uint8_t * bits = nullptr;
-		unsigned int width = 0, height = 0;
 #if FISHENGINE_PLATFORM_WINDOWS
-		auto filename = m_assetPath.wstring().c_str();
+		auto filename = path.wstring().c_str();
 		fif = FreeImage_GetFileTypeU(filename);
 		if (fif == FIF_UNKNOWN)
 		{
@@ -205,7 +206,7 @@ namespace FishEditor
 			abort();
 		}
 #else
-		auto filename = m_assetPath.c_str();
+		auto filename = path.c_str();
 		fif = FreeImage_GetFileType(filename);
 		if (fif == FIF_UNKNOWN)
 		{
@@ -224,6 +225,14 @@ namespace FishEditor
 			abort();
 		}
 #endif
+		return dib;
+	}
+
+	void TextureImporter::ImportTo(FishEngine::Texture2DPtr & texture)
+	{
+		FIBITMAP *dib = LoadFreeImage(m_assetPath);
+		uint8_t * bits = nullptr;
+		unsigned int width = 0, height = 0;
 			
 		//retrieve the image data
 		bits = FreeImage_GetBits(dib);
@@ -397,11 +406,79 @@ namespace FishEditor
 		FreeImage_Unload(dib);
 	}
 
+	void TextureImporter::ImportTo(FishEngine::Cubemap & cubemap)
+	{
+		// equirectangular (latitude-longitude) image, HDR or not
+		FIBITMAP *dib = LoadFreeImage(m_assetPath);
+		auto rgbf = FreeImage_ConvertToRGBF(dib);
+		if (rgbf == nullptr)
+		{
+			abort();
+		}
+		int width = FreeImage_GetWidth(rgbf);
+		int height = FreeImage_GetHeight(rgbf);
+		std::vector<Vector3> pixels(width * height);
+		for (int y = 0; y < height; ++y)
+		{
+			auto line = reinterpret_cast<FIRGBF*>(FreeImage_GetScanLine(rgbf, y));
+			for (int x = 0; x < width; ++x)
+			{
+				pixels[x + y * width].Set(line[x].red, line[x].green, line[x].blue);
+			}
+		}
+		FreeImage_Unload(rgbf);
+
+		// a face covers 90 degrees, a quarter of the width
+		int size = static_cast<int>(Mathf::Clamp<uint32_t>(Mathf::NextPowerOfTwo(width / 4), 16, 1024));
+		auto image = EnvironmentFilter::FromEquirectangular(pixels.data(), width, height, size);
+		if (m_cubemapConvolution == TextureImporterCubemapConvolution::Specular)
+		{
+			CubemapConvolution::Specular(*this, image, cubemap);
+		}
+		else
+		{
+			EnvironmentFilter::Apply({ image }, nullptr, cubemap);
+		}
+
+		// get icon
+		auto ldr = FreeImage_ToneMapping(dib, FITMO_DRAGO03);
+		auto thumbnail = FreeImage_MakeThumbnail(ldr, 64);
+		FreeImage_FlipVertical(thumbnail);	// flip for Qt
+#if FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_BGR
+		SwapRedBlue32(thumbnail);
+#endif
+		int thumbnailWidth = FreeImage_GetWidth(thumbnail);
+		int thumbnailHeight = FreeImage_GetHeight(thumbnail);
+		auto qimage = QImage(thumbnailWidth, thumbnailHeight, QImage::Format_RGB888);
+		for (int y = 0; y < thumbnailHeight; ++y)
+		{
+			auto line = FreeImage_GetScanLine(thumbnail, y);
+			std::copy(line, line + thumbnailWidth * 3, qimage.scanLine(y));
+		}
+		AssetDatabase::s_cacheIcons[m_assetPath] = QIcon(QPixmap::fromImage(std::move(qimage)));
+
+		// clean
+		FreeImage_Unload(thumbnail);
+		FreeImage_Unload(ldr);
+		FreeImage_Unload(dib);
+	}
+
 	FishEngine::TexturePtr TextureImporter::Import(Path const & path)
 	{
 		m_assetPath = path;
-		auto texture = MakeShared<Texture2D>();
-		this->ImportTo(texture);
+		TexturePtr texture;
+		if (m_textureShape == TextureImporterShape::TextureCube)
+		{
+			auto cubemap = MakeShared<Cubemap>(1, TextureFormat::RGBAFloat, true);
+			this->ImportTo(*cubemap);
+			texture = cubemap;
+		}
+		else
+		{
+			auto texture2d = MakeShared<Texture2D>();
+			this->ImportTo(texture2d);
+			texture = texture2d;
+		}
 		m_asset->Add(texture);
 		return texture;
 	}
@@ -409,6 +486,13 @@ namespace FishEditor
 	void TextureImporter::Reimport()
 	{
 		auto texture = AssetImporter::s_importerGUIDToObject[this->m_guid]->mainObject();
+		auto cubemap = std::dynamic_pointer_cast<Cubemap>(texture);
+		if (cubemap != nullptr)
+		{
+			// the shape can not change in place
+			ImportTo(*cubemap);
+			return;
+		}
 		auto texture2d = std::dynamic_pointer_cast<Texture2D>(texture);
 		ImportTo(texture2d);
 	}
@@ -60,6 +60,17 @@ namespace FishEditor
 		{
 			m_textureShape = textureShape;
 		}
+
+		// Convolution of a TextureCube, imported from an equirectangular image (see CubemapConvolution).
+		TextureImporterCubemapConvolution cubemapConvolution() const
+		{
+			return m_cubemapConvolution;
+		}
+
+		void setCubemapConvolution(const TextureImporterCubemapConvolution cubemapConvolution)
+		{
+			m_cubemapConvolution = cubemapConvolution;
+		}
 		
 		// Filtering mode of the texture.
 		FishEngine::FilterMode filterMode() const
@@ -115,6 +126,8 @@ namespace FishEditor
 		
 	protected:
 		void ImportTo(FishEngine::Texture2DPtr & texture);
+
+		void ImportTo(FishEngine::Cubemap & cubemap);
 		
 		virtual void Reimport() override;
 		
@@ -161,6 +174,9 @@ namespace FishEditor
 		// Shape of imported texture.
 		TextureImporterShape m_textureShape = TextureImporterShape::Texture2D;
 
+		// Convolution of a TextureCube, for image based lighting.
+		TextureImporterCubemapConvolution m_cubemapConvolution = TextureImporterCubemapConvolution::None;
+
 		TextureSettings m_textureSettings;
 
 		// Is texture storing color data?
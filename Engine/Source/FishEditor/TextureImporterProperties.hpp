@@ -21,6 +21,13 @@ namespace FishEditor
 		TextureCube,
 	};
 
+	// Convolution of a cubemap, for image based lighting.
+	enum class TextureImporterCubemapConvolution
+	{
+		None,		// Import the cubemap as is.
+		Specular,	// Prefilter the mips with the GGX distribution and compute the diffuse irradiance (spherical harmonics).
+	};
+
 	enum class TextureImporterCompression
 	{
 		Uncompressed,
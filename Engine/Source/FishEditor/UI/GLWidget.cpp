@@ -5,6 +5,8 @@
 #include <QApplication>
 #include <QDesktopWidget>
 
+#include <algorithm>
+
 #include <FishEngine/Debug.hpp>
 #include <FishEngine/Screen.hpp>
 #include <FishEngine/Input.hpp>
@@ -22,6 +24,8 @@ GLWidget::GLWidget(QWidget *parent)
 	: QOpenGLWidget(parent)
 {
 	setFocusPolicy(Qt::FocusPolicy::ClickFocus);
+	// hovering highlights gizmos
+	setMouseTracking(true);
 	//LogInfo("GLWidget::ctor");
 	//Init();
 	//auto filter = new EventFilter;
@@ -40,19 +44,19 @@ void GLWidget::initializeGL()
 	RenderSystem::InitializeGL();
 
 	Screen::set(width(), height());
+	// QWidget::update coalesces the requests of an event-loop turn into one paint event
+	MainEditor::OnRepaintRequested += [this]() { update(); };
 	MainEditor::Init();
 
-	auto timer = new QTimer(this);
-	connect(timer, SIGNAL(timeout()), this, SLOT(update()));
-	timer->start(1000 / 30.0f);
+	m_frameTimer = new QTimer(this);
+	m_frameTimer->setInterval(1000 / 30);
+	connect(m_frameTimer, SIGNAL(timeout()), this, SLOT(update()));
 }
 
 void GLWidget::paintGL()
 {
-	MainEditor::Run();
-	
-	Input::Update();
-
+	// The frames are drawn on demand, maybe long after the previous one: the cursor is sampled now, for this frame.
+	// The input events since the previous frame are consumed by Run, which ends the frame's input (Input::Update).
 	auto globalCursorPos = QCursor::pos();
 	auto localCursorPos = mapFromGlobal(globalCursorPos);
 	// top-left -> bottom-left
@@ -60,6 +64,19 @@ void GLWidget::paintGL()
 	float y =  1.0f - localCursorPos.y() * Screen::pixelsPerPoint() / static_cast<float>(Screen::height());
 	//Debug::Log("x = %lf, y = %lf", x, y);
 	Input::UpdateMousePosition(x, y);
+
+	MainEditor::Run();
+
+	UpdateFrameTimer();
+}
+
+void GLWidget::UpdateFrameTimer()
+{
+	bool continuous = MainEditor::continuousRepaint() || m_heldButtons > 0;
+	if (continuous && !m_frameTimer->isActive())
+		m_frameTimer->start();
+	else if (!continuous && m_frameTimer->isActive())
+		m_frameTimer->stop();
 }
 
 
@@ -73,14 +90,23 @@ void GLWidget::resizeGL(int width, int height)
 	//m_mainSceneViewEditor->Resize(width*ratio, height*ratio);
 }
 
-//void GLWidget::mouseMoveEvent(QMouseEvent *event)
-//{
-//    auto p = event->localPos();
-//    float x = p.x() / Screen::width();
-//    float y = -p.y() / Screen::height();
-//    //Debug::Log("x : %f, y: %f", x, y);
-//    Input::UpdateMousePosition(x, y);
-//}
+void GLWidget::mouseMoveEvent(QMouseEvent *)
+{
+	// the position itself is read in paintGL
+	MainEditor::RepaintSceneView();
+}
+
+void GLWidget::leaveEvent(QEvent *)
+{
+	MainEditor::RepaintSceneView();
+}
+
+void GLWidget::focusOutEvent(QFocusEvent *event)
+{
+	// the release events will go to another widget
+	m_heldButtons = 0;
+	QOpenGLWidget::focusOutEvent(event);
+}
 
 void GLWidget::mousePressEvent(QMouseEvent *event)
 {
@@ -99,6 +125,8 @@ void GLWidget::mousePressEvent(QMouseEvent *event)
 	}
 	//Debug::LogWarning("mouse down: %d", button);
 	Input::UpdateMouseButtonState(button, MouseButtonState::Down);
+	m_heldButtons++;
+	MainEditor::RepaintSceneView();
 }
 
 void GLWidget::mouseReleaseEvent(QMouseEvent *event)
@@ -118,6 +146,8 @@ void GLWidget::mouseReleaseEvent(QMouseEvent *event)
 	}
 	//Debug::LogWarning("mouse up: %d", button);
 	Input::UpdateMouseButtonState(button, MouseButtonState::Up);
+	m_heldButtons = std::max(0, m_heldButtons - 1);
+	MainEditor::RepaintSceneView();
 }
 
 
@@ -126,6 +156,7 @@ void GLWidget::wheelEvent(QWheelEvent *event)
 	auto delta = 5.0f * event->angleDelta().y() / QWheelEvent::DefaultDeltasPerStep;
 	//Debug::LogWarning("mouse scroll: %lf", delta);
 	Input::UpdateAxis(Axis::MouseScrollWheel, delta);
+	MainEditor::RepaintSceneView();
 }
 
 //std::map<Qt::Key, FishEngine::KeyCode> keyMapping = {
@@ -181,6 +212,9 @@ int KeyCodeFromQKeyEvent(QKeyEvent * event)
 void GLWidget::keyPressEvent(QKeyEvent * event)
 {
 	//FishEngine::Debug::LogWarning("Press");
+	if (!event->isAutoRepeat())
+		m_heldButtons++;
+	MainEditor::RepaintSceneView();
 	int key = KeyCodeFromQKeyEvent( event );
 	Input::UpdateKeyState(key, KeyState::Down);
 	int modifiers = event->modifiers();
@@ -208,6 +242,9 @@ void GLWidget::keyPressEvent(QKeyEvent * event)
 void GLWidget::keyReleaseEvent(QKeyEvent * event)
 {
 	//FishEngine::Debug::LogWarning("Release");
+	if (!event->isAutoRepeat())
+		m_heldButtons = std::max(0, m_heldButtons - 1);
+	MainEditor::RepaintSceneView();
 	int key = KeyCodeFromQKeyEvent(event);
 	Input::UpdateKeyState(key, KeyState::Up);
 	int modifiers = event->modifiers();
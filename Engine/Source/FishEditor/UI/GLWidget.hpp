@@ -4,6 +4,8 @@
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
 
+class QTimer;
+
 
 namespace FishEditor
 {
@@ -24,13 +26,23 @@ protected:
 	void paintGL() override;
 	void resizeGL(int width, int height) override;
 
-	//void mouseMoveEvent(QMouseEvent *event) override;
+	void mouseMoveEvent(QMouseEvent *event) override;
 	void mousePressEvent(QMouseEvent *event) override;
 	void mouseReleaseEvent(QMouseEvent *event) override;
 	void wheelEvent(QWheelEvent *event) override;
+	void leaveEvent(QEvent *event) override;
 
 	void keyPressEvent(QKeyEvent *event) override;
 	void keyReleaseEvent(QKeyEvent *event) override;
+	void focusOutEvent(QFocusEvent *event) override;
+
+private:
+	// Redraws every frame while something is animated or a button/key is held (camera navigation, gizmo drags),
+	// stops when the scene view is idle.
+	void UpdateFrameTimer();
+
+	QTimer *	m_frameTimer = nullptr;
+	int			m_heldButtons = 0;	// mouse buttons and keys pressed in this widget
 };
 
 #endif // GLWIDGET_H
@@ -0,0 +1,409 @@
+#include "HierarchyModel.hpp"
+
+#include <QBrush>
+
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Debug.hpp>
+#include "../Undo.hpp"
+
+using namespace FishEngine;
+
+HierarchyModel::HierarchyModel(QObject *parent)
+	: QAbstractItemModel(parent)
+{
+	m_listenerID = Scene::AddHierarchyListener([this](HierarchyChange change, GameObject* go) {
+		OnHierarchyChanged(change, go);
+	});
+}
+
+HierarchyModel::~HierarchyModel()
+{
+	Scene::RemoveHierarchyListener(m_listenerID);
+}
+
+QModelIndex HierarchyModel::index(int row, int column, const QModelIndex &parent) const
+{
+	auto node = NodeOf(parent);
+	if (column != 0 || row < 0 || row >= static_cast<int>(node->children.size()))
+		return QModelIndex();
+	return createIndex(row, column, node->children[row].get());
+}
+
+QModelIndex HierarchyModel::parent(const QModelIndex &child) const
+{
+	if (!child.isValid())
+		return QModelIndex();
+	auto node = NodeOf(child);
+	return IndexOf(node->parent);
+}
+
+int HierarchyModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.column() > 0)
+		return 0;
+	return static_cast<int>(NodeOf(parent)->children.size());
+}
+
+int HierarchyModel::columnCount(const QModelIndex &) const
+{
+	return 1;
+}
+
+bool HierarchyModel::hasChildren(const QModelIndex &parent) const
+{
+	auto node = NodeOf(parent);
+	if (node->fetched)
+		return !node->children.empty();
+	if (node == &m_root)
+		return !Scene::GameObjects().empty();
+	auto t = node->transform.lock();
+	return t != nullptr && t->childCount() > 0;
+}
+
+bool HierarchyModel::canFetchMore(const QModelIndex &parent) const
+{
+	return !NodeOf(parent)->fetched && hasChildren(parent);
+}
+
+void HierarchyModel::fetchMore(const QModelIndex &parent)
+{
+	auto node = NodeOf(parent);
+	if (node->fetched)
+		return;
+
+	std::vector<TransformPtr> children;
+	if (node == &m_root)
+	{
+		for (auto const & go : Scene::GameObjects())
+		{
+			auto t = go->transform();
+			if (t->parent() == nullptr)
+				children.push_back(t);
+		}
+	}
+	else
+	{
+		auto t = node->transform.lock();
+		if (t != nullptr)
+			children.assign(t->children().begin(), t->children().end());
+	}
+
+	node->fetched = true;
+	if (children.empty())
+		return;
+
+	beginInsertRows(parent, 0, static_cast<int>(children.size()) - 1);
+	node->children.reserve(children.size());
+	for (auto const & t : children)
+	{
+		auto child = std::make_unique<Node>();
+		child->transform = t;
+		child->gameObject = t->gameObject().get();
+		child->parent = node;
+		child->row = static_cast<int>(node->children.size());
+		m_nodes[child->gameObject] = child.get();
+		node->children.push_back(std::move(child));
+	}
+	endInsertRows();
+}
+
+QVariant HierarchyModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid())
+		return QVariant();
+	auto t = NodeOf(index)->transform.lock();
+	if (t == nullptr)
+		return QVariant();
+
+	if (role == Qt::DisplayRole || role == Qt::EditRole)
+	{
+		return QString::fromStdString(t->gameObject()->name());
+	}
+	else if (role == Qt::ForegroundRole)
+	{
+		if (!t->gameObject()->activeInHierarchy())
+			return QBrush(Qt::gray);
+	}
+	return QVariant();
+}
+
+bool HierarchyModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+	if (!index.isValid() || role != Qt::EditRole)
+		return false;
+	auto t = NodeOf(index)->transform.lock();
+	if (t == nullptr)
+		return false;
+	// dataChanged is emitted by the Renamed notification
+	auto go = t->gameObject();
+	FishEditor::Undo::RecordObject(go, "Rename");
+	go->setName(value.toString().toStdString());
+	FishEditor::Undo::FlushGesture();
+	return true;
+}
+
+Qt::ItemFlags HierarchyModel::flags(const QModelIndex &index) const
+{
+	auto defaultFlags = QAbstractItemModel::flags(index);
+	if (index.isValid())
+		return Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled | defaultFlags;
+	return Qt::ItemIsDropEnabled | defaultFlags;
+}
+
+TransformPtr HierarchyModel::transform(const QModelIndex &index) const
+{
+	if (!index.isValid())
+		return nullptr;
+	return NodeOf(index)->transform.lock();
+}
+
+QModelIndex HierarchyModel::FetchIndex(TransformPtr const & transform)
+{
+	if (transform == nullptr)
+		return QModelIndex();
+
+	std::vector<TransformPtr> path;	// transform, parent, ..., root
+	for (auto t = transform; t != nullptr; t = t->parent())
+	{
+		path.push_back(t);
+	}
+
+	fetchMore(QModelIndex());
+	QModelIndex index;
+	for (auto it = path.rbegin(); it != path.rend(); ++it)
+	{
+		if (index.isValid())
+			fetchMore(index);
+		auto node = FindNode((*it)->gameObject().get());
+		if (node == nullptr)
+			return QModelIndex();
+		index = IndexOf(node);
+	}
+	return index;
+}
+
+void HierarchyModel::OnHierarchyChanged(HierarchyChange change, GameObject* go)
+{
+	switch (change)
+	{
+	case HierarchyChange::Created:
+		OnCreated(go);
+		break;
+	case HierarchyChange::Destroyed:
+		OnDestroyed(go);
+		break;
+	case HierarchyChange::Reparented:
+		OnReparented(go);
+		break;
+	case HierarchyChange::Renamed:
+		OnDataChanged(go, false);
+		break;
+	case HierarchyChange::ActiveChanged:
+		// activeInHierarchy of all children changed too
+		OnDataChanged(go, true);
+		break;
+	}
+}
+
+void HierarchyModel::OnCreated(GameObject* go)
+{
+	if (FindNode(go) != nullptr)
+		return;
+	auto t = go->transform();
+	if (t->parent() != nullptr)
+	{
+		OnReparented(go);
+		return;
+	}
+	if (m_root.fetched)
+	{
+		InsertNode(&m_root, RootRow(go), t);
+	}
+}
+
+void HierarchyModel::OnDestroyed(GameObject* go)
+{
+	auto node = FindNode(go);
+	// not in the model: a child of a node that has not been fetched
+	if (node == nullptr)
+		return;
+	RemoveNode(node);
+}
+
+void HierarchyModel::OnReparented(GameObject* go)
+{
+	auto t = go->transform();
+	auto newParent = t->parent();
+	auto node = FindNode(go);
+
+	// where the node goes, nullptr if it is not visible in the model
+	Node* destination = nullptr;
+	int destinationRow = 0;
+	if (newParent == nullptr)
+	{
+		// only GameObjects of the scene are shown as roots
+		int row = RootRow(go);
+		if (m_root.fetched && row >= 0)
+		{
+			destination = &m_root;
+			destinationRow = row;
+		}
+	}
+	else
+	{
+		auto parentNode = FindNode(newParent->gameObject().get());
+		if (parentNode != nullptr && parentNode->fetched)
+		{
+			destination = parentNode;
+			destinationRow = static_cast<int>(parentNode->children.size());
+		}
+		else if (parentNode != nullptr)
+		{
+			// The new parent is visible but its children were never fetched (it may have had none, and no expand arrow).
+			// Fetch it now; that adds this GameObject too.
+			if (node != nullptr)
+				RemoveNode(node);
+			fetchMore(IndexOf(parentNode));
+			return;
+		}
+	}
+
+	// a move keeps the selection and expansion of the subtree; Qt refuses the moves that would not change the
+	// rows, or move them into themselves: removed and inserted again then
+	bool moving = false;
+	if (node != nullptr && destination != nullptr)
+	{
+		moving = beginMoveRows(IndexOf(node->parent), node->row, node->row, IndexOf(destination), destinationRow);
+		if (!moving)
+		{
+			RemoveNode(node);
+			node = nullptr;
+		}
+	}
+
+	if (moving)
+	{
+		auto detached = DetachNode(node);
+		detached->parent = destination;
+		destination->children.insert(destination->children.begin() + destinationRow, std::move(detached));
+		Renumber(destination, destinationRow);
+		endMoveRows();
+	}
+	else if (node != nullptr)
+	{
+		RemoveNode(node);
+	}
+	else if (destination != nullptr)
+	{
+		InsertNode(destination, destinationRow, t);
+	}
+}
+
+void HierarchyModel::OnDataChanged(GameObject* go, bool recursive)
+{
+	auto node = FindNode(go);
+	if (node == nullptr)
+		return;
+	auto index = IndexOf(node);
+	emit dataChanged(index, index);
+	if (recursive)
+		EmitDataChangedForChildren(node);
+}
+
+void HierarchyModel::EmitDataChangedForChildren(Node* node)
+{
+	if (node->children.empty())
+		return;
+	auto parentIndex = IndexOf(node);
+	emit dataChanged(index(0, 0, parentIndex), index(static_cast<int>(node->children.size()) - 1, 0, parentIndex));
+	for (auto & child : node->children)
+	{
+		EmitDataChangedForChildren(child.get());
+	}
+}
+
+HierarchyModel::Node* HierarchyModel::FindNode(GameObject* go) const
+{
+	auto it = m_nodes.find(go);
+	if (it == m_nodes.end())
+		return nullptr;
+	return it->second;
+}
+
+QModelIndex HierarchyModel::IndexOf(Node* node) const
+{
+	if (node == nullptr || node == &m_root)
+		return QModelIndex();
+	return createIndex(node->row, 0, node);
+}
+
+HierarchyModel::Node* HierarchyModel::NodeOf(const QModelIndex &index) const
+{
+	if (!index.isValid())
+		return const_cast<Node*>(&m_root);
+	return static_cast<Node*>(index.internalPointer());
+}
+
+int HierarchyModel::RootRow(GameObject* go) const
+{
+	int row = 0;
+	for (auto const & g : Scene::GameObjects())
+	{
+		if (g.get() == go)
+			return row;
+		// roots that are not in the model yet (e.g. created in this notification) are not counted
+		if (g->transform()->parent() == nullptr && FindNode(g.get()) != nullptr)
+			row++;
+	}
+	return -1;
+}
+
+void HierarchyModel::InsertNode(Node* parent, int row, TransformPtr const & transform)
+{
+	beginInsertRows(IndexOf(parent), row, row);
+	auto node = std::make_unique<Node>();
+	node->transform = transform;
+	node->gameObject = transform->gameObject().get();
+	node->parent = parent;
+	m_nodes[node->gameObject] = node.get();
+	parent->children.insert(parent->children.begin() + row, std::move(node));
+	Renumber(parent, row);
+	endInsertRows();
+}
+
+void HierarchyModel::RemoveNode(Node* node)
+{
+	beginRemoveRows(IndexOf(node->parent), node->row, node->row);
+	auto detached = DetachNode(node);
+	Forget(detached.get());
+	endRemoveRows();
+}
+
+std::unique_ptr<HierarchyModel::Node> HierarchyModel::DetachNode(Node* node)
+{
+	auto parent = node->parent;
+	int row = node->row;
+	auto detached = std::move(parent->children[row]);
+	parent->children.erase(parent->children.begin() + row);
+	Renumber(parent, row);
+	detached->parent = nullptr;
+	return detached;
+}
+
+void HierarchyModel::Forget(Node* node)
+{
+	m_nodes.erase(node->gameObject);
+	for (auto & child : node->children)
+	{
+		Forget(child.get());
+	}
+}
+
+void HierarchyModel::Renumber(Node* parent, int first)
+{
+	for (int i = first; i < static_cast<int>(parent->children.size()); ++i)
+	{
+		parent->children[i]->row = i;
+	}
+}
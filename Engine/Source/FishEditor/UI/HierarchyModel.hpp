@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QAbstractItemModel>
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include <FishEngine/Scene.hpp>
+
+namespace FishEngine
+{
+	class Transform;
+	class GameObject;
+}
+
+// Item model of the scene hierarchy.
+// Children are created lazily (fetchMore) when their parent is first expanded, and the model is kept
+// in sync by Scene's hierarchy notifications, so nothing is rebuilt or polled.
+class HierarchyModel : public QAbstractItemModel
+{
+	Q_OBJECT
+public:
+	explicit HierarchyModel(QObject *parent = nullptr);
+	~HierarchyModel();
+
+	virtual QModelIndex		index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+	virtual QModelIndex		parent(const QModelIndex &child) const override;
+	virtual int				rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	virtual int				columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	virtual bool			hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+	virtual bool			canFetchMore(const QModelIndex &parent) const override;
+	virtual void			fetchMore(const QModelIndex &parent) override;
+	virtual QVariant		data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	virtual bool			setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+	virtual Qt::ItemFlags	flags(const QModelIndex &index) const override;
+
+	virtual Qt::DropActions supportedDropActions() const override
+	{
+		return Qt::MoveAction;
+	}
+
+	std::shared_ptr<FishEngine::Transform> transform(const QModelIndex &index) const;
+
+	// Index of the transform, fetching its ancestors if they have not been fetched yet.
+	// Returns an invalid index if the transform is not in the scene.
+	QModelIndex FetchIndex(std::shared_ptr<FishEngine::Transform> const & transform);
+
+private:
+	struct Node
+	{
+		std::weak_ptr<FishEngine::Transform>	transform;
+		FishEngine::GameObject*					gameObject = nullptr;	// key in m_nodes
+		Node*									parent = nullptr;
+		int										row = 0;			// index in parent->children
+		bool									fetched = false;	// children are populated
+		std::vector<std::unique_ptr<Node>>		children;
+	};
+
+	void OnHierarchyChanged(FishEngine::HierarchyChange change, FishEngine::GameObject* go);
+	void OnCreated(FishEngine::GameObject* go);
+	void OnDestroyed(FishEngine::GameObject* go);
+	void OnReparented(FishEngine::GameObject* go);
+	void OnDataChanged(FishEngine::GameObject* go, bool recursive);
+
+	Node* FindNode(FishEngine::GameObject* go) const;
+	QModelIndex IndexOf(Node* node) const;
+	Node* NodeOf(const QModelIndex &index) const;
+
+	// row of a root GameObject in Scene::GameObjects() order, counting roots only
+	int RootRow(FishEngine::GameObject* go) const;
+
+	void InsertNode(Node* parent, int row, std::shared_ptr<FishEngine::Transform> const & transform);
+	void RemoveNode(Node* node);
+	std::unique_ptr<Node> DetachNode(Node* node);
+	void Forget(Node* node);
+	void Renumber(Node* parent, int first);
+	void EmitDataChangedForChildren(Node* node);
+
+	Node m_root;
+	std::unordered_map<FishEngine::GameObject*, Node*> m_nodes;
+	int m_listenerID = -1;
+};
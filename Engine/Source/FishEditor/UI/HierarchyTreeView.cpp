@@ -1,12 +1,12 @@
 #include "HierarchyTreeView.hpp"
+#include "HierarchyModel.hpp"
 
-#include <QStandardItemModel>
-#include <QTimer>
 #include <QMenu>
 
 #include <FishEngine/Transform.hpp>
 #include <FishEngine/GameObject.hpp>
 #include "../Selection.hpp"
+#include "../Undo.hpp"
 #include <FishEngine/Scene.hpp>
 #include <FishEngine/Camera.hpp>
 
@@ -15,22 +15,18 @@
 #include "UIDebug.hpp"
 
 #include <QDropEvent>
-#include <QStandardItemModel>
-
-#include "../Selection.hpp"
 
 #include <FishEngine/Debug.hpp>
 using namespace FishEngine;
 using namespace FishEditor;
 
-Q_DECLARE_METATYPE(std::weak_ptr<FishEngine::Transform>)
-
 void CreateEmpty()
 {
 	auto const & selections = Selection::transforms();
 	if (selections.empty())
 	{
 		auto go = Scene::CreateGameObject("GameObject");
+		Undo::RegisterCreatedObjectUndo(go, "Create GameObject");
 		//Selection::transforms().clear();
 		//Selection::transforms().push_back(go->transform());
 		Selection::setTransforms({go->transform()});
@@ -43,10 +39,12 @@ void CreateEmpty()
 		{
 			auto go = Scene::CreateGameObject("GameObject");
 			go->transform()->SetParent(t.lock());
+			Undo::RegisterCreatedObjectUndo(go, "Create GameObject");
 			selections.push_back(go->transform());
 		}
 		Selection::setTransforms(selections);
 	}
+	Undo::FlushGesture();
 }
 
 void CreatePrimitive(PrimitiveType type)
@@ -55,6 +53,7 @@ void CreatePrimitive(PrimitiveType type)
 	if (selections.empty())
 	{
 		auto go = GameObject::CreatePrimitive(type);
+		Undo::RegisterCreatedObjectUndo(go, "Create " + go->name());
 		Selection::setTransforms({go->transform()});
 	}
 	else
@@ -65,17 +64,19 @@ void CreatePrimitive(PrimitiveType type)
 		{
 			auto go = GameObject::CreatePrimitive(type);
 			go->transform()->SetParent(t.lock());
+			Undo::RegisterCreatedObjectUndo(go, "Create " + go->name());
 			selections.push_back(go->transform());
 		}
 		Selection::setTransforms(selections);
 	}
+	Undo::FlushGesture();
 }
 
 
 HierarchyTreeView::HierarchyTreeView(QWidget *parent)
 	: QTreeView(parent)
 {
-	m_hierarchyModel = new QStandardItemModel();
+	m_hierarchyModel = new HierarchyModel(this);
 
 	QAction * action;
 	m_menu = new QMenu(this);
@@ -93,18 +94,26 @@ HierarchyTreeView::HierarchyTreeView(QWidget *parent)
 		for (auto const & t : Selection::transforms())
 		{
 			auto go = Object::Instantiate(t.lock()->gameObject());
+			Undo::RegisterCreatedObjectUndo(go, "Duplicate");
 			duplicatedTransforms.push_back(go->transform());
 		}
+		Undo::FlushGesture();
 		Selection::setTransforms(duplicatedTransforms);
 	});
 	//action->setEnabled(false);
 	m_deleteAction = m_menu->addAction("Delete");
 	connect(m_deleteAction, &QAction::triggered, [](){
-		for (auto const & t : Selection::transforms())
+		// copy: removing the rows changes the selection of the view, and with it Selection::transforms()
+		auto transforms = Selection::transforms();
+		for (auto const & t : transforms)
 		{
-			Object::DestroyImmediate(t.lock()->gameObject());
+			// already gone with a selected ancestor
+			if (t.expired())
+				continue;
+			Undo::DestroyObjectImmediate(t.lock()->gameObject());
 			//assert(t.expired());
 		}
+		Undo::FlushGesture();
 		//Selection::transforms().clear();
 		Selection::setTransforms({});
 	});
@@ -172,13 +181,15 @@ HierarchyTreeView::HierarchyTreeView(QWidget *parent)
 
 	setContextMenuPolicy(Qt::CustomContextMenu);
 	connect(this, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(ShowContexMenu(const QPoint&)));
+	setUniformRowHeights(true);
 	setModel(m_hierarchyModel);
 	//auto selectionModel = selectionModel();
 	connect(selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), this, SLOT(OnHierarchyViewSelectionChanged(QItemSelection,QItemSelection)));
 
-	auto timer = new QTimer(this);
-	connect(timer, SIGNAL(timeout()), this, SLOT(UpdateHierarchyModel()));
-	timer->start(1000 / 10.0f); // 10 fps
+	// the model follows the scene by itself, only the selection from other views has to be synced
+	Selection::selectionChanged += [this]() {
+		SyncSelection();
+	};
 }
 
 HierarchyTreeView::~HierarchyTreeView()
@@ -194,38 +205,29 @@ QSize HierarchyTreeView::sizeHint() const
 void HierarchyTreeView::dragEnterEvent(QDragEnterEvent *event)
 {
 	LogInfo("HierarchyTreeView::dragEnterEvent");
-	m_inDragDropMode = true;
 	QTreeView::dragEnterEvent(event);
 }
 
 void HierarchyTreeView::dropEvent(QDropEvent *event)
 {
 	LogInfo("HierarchyTreeView::dropEvent");
-	m_inDragDropMode = false;
 	const QModelIndex & index = indexAt(event->pos());
 
-	if (!index.isValid()) // set null parent
-	{
-		LogInfo("HierarchyTreeView::dropEvent, invalid");
-
-		for (auto const & t : Selection::transforms())
-		{
-			t.lock()->SetParent(nullptr);
-		}
-
-		event->setDropAction(Qt::IgnoreAction);
-		return;
-	}
-
-	auto to_item = m_hierarchyModel->itemFromIndex(index);
-	auto new_parent = to_item->data().value<std::weak_ptr<FishEngine::Transform>>().lock();
-
-	for (auto const & t : Selection::transforms())
+	// set null parent if dropped on empty space
+	auto new_parent = m_hierarchyModel->transform(index);
+	auto transforms = Selection::transforms();
+	for (auto const & t : transforms)
 	{
-		t.lock()->SetParent(new_parent);
+		Undo::SetTransformParent(t.lock(), new_parent, "Parent");
 	}
-
-	QTreeView::dropEvent(event);
+	Undo::FlushGesture();
+
+	// the model has already been updated by the reparent notifications, the items must not be moved again by Qt
+	event->setDropAction(Qt::IgnoreAction);
+	event->accept();
+	stopAutoScroll();
+	setState(NoState);
+	viewport()->update();
 }
 
 
@@ -244,145 +246,48 @@ void HierarchyTreeView::OnHierarchyViewSelectionChanged(QItemSelection const & ,
 	//auto const & selections = current.indexes();
 	if (selections.empty())
 	{
+		m_blockSignal = true;
 		FishEditor::Selection::setTransforms({});
+		m_blockSignal = false;
 	}
 	else
 	{
 		std::list<std::weak_ptr<FishEngine::Transform>> selected_transform;
 		for (auto const & index : selections)
 		{
-			auto item = m_hierarchyModel->itemFromIndex(index);
-			auto transform_ptr = item->data().value<std::weak_ptr<FishEngine::Transform>>();
-			selected_transform.push_back(transform_ptr);
+			selected_transform.push_back(m_hierarchyModel->transform(index));
 		}
+		m_blockSignal = true;
 		Selection::setTransforms(selected_transform);
+		m_blockSignal = false;
 		//Debug::LogError("OnHierarchyViewSelectionChanged[end] %d", Selection::transforms().size());
 	}
 }
 
 
-QStandardItem* CreateHierarchyItem(TransformPtr const & transform)
+void HierarchyTreeView::SyncSelection()
 {
-	QStandardItem* item = new QStandardItem(QString(transform->gameObject()->name().c_str()));
-	QVariant v;
-	std::weak_ptr<FishEngine::Transform> pt = transform;
-	v.setValue(pt);
-	item->setData(v);
-	for (auto const & child : transform->children())
-	{
-		if (child != nullptr)
-		{
-			item->appendRow(CreateHierarchyItem(child));
-		}
-		else
-		{
-			abort();
-		}
-	}
-	return item;
-}
-
-QStandardItem* HierarchyTreeView::UpdateHierarchyItem(QStandardItem * item, TransformPtr const & transform)
-{
-	if (item == nullptr)    // new
-	{
-		return CreateHierarchyItem(transform);
-	}
-
-	auto transform_in_data = item->data().value<std::weak_ptr<FishEngine::Transform>>();
-	if (transform_in_data.lock() != transform)
-	{
-		item->setText(QString(transform->gameObject()->name().c_str()));
-		QVariant v;
-		std::weak_ptr<FishEngine::Transform> pt = transform;
-		v.setValue(pt);
-		item->setData(v);
-	}
-	else
-	{
-		auto display_name = item->text();
-		QString name = transform->gameObject()->name().c_str();
-		if (display_name != name)
-		{
-			item->setText(name);
-		}
-	}
-
-	int row = 0;
-	for (auto const & child_transform : transform->children())
-	{
-		if (child_transform != nullptr)
-		{
-			auto child_item = item->child(row);
-			if (child_item == nullptr)
-			{
-				auto new_item = UpdateHierarchyItem(nullptr, child_transform);
-				item->setChild(row, 0, new_item);
-			}
-			else
-			{
-				UpdateHierarchyItem(child_item, child_transform);
-			}
-		}
-		else
-		{
-			abort();
-		}
-		row ++;
-	}
-	int redundantRows = item->rowCount() - row;
-	if (redundantRows > 0)
-	{
-		item->removeRows(row, redundantRows);
-	}
-	if (Selection::Contains(transform))
-	{
-		selectionModel()->select(item->index(), QItemSelectionModel::Select);
-	}
-	return item;
-}
-
-void HierarchyTreeView::UpdateHierarchyModel()
-{
-	if (m_inDragDropMode)
+	if (m_blockSignal)
 		return;
-	//LOG;
-	//Debug::LogError("Here %d", Selection::transforms().size());
-	//auto count = m_hierarchyModel->rowCount();
-	//ui->hierarchyTreeView->selectionModel()->blockSignals(true);
 	m_blockSignal = true;
-	selectionModel()->clearSelection();
-
-	int row = 0;
-	for (auto go : Scene::GameObjects())
+	QItemSelection selection;
+	QModelIndex last;
+	for (auto const & t : Selection::transforms())
 	{
-		auto transform = go->transform();
-		if (transform->parent() != nullptr)
-		{
+		// fetches the parents of objects that were never shown
+		auto index = m_hierarchyModel->FetchIndex(t.lock());
+		if (!index.isValid())
 			continue;
-		}
-		auto item = m_hierarchyModel->item(row);
-		if (item == nullptr)
-		{
-			//m_hierarchyModel->appendRow(UpdateHierarchyItem(nullptr, transform));
-			auto new_item = UpdateHierarchyItem(nullptr, transform);
-			m_hierarchyModel->setItem(row, new_item);
-		}
-		else
+		for (auto p = index.parent(); p.isValid(); p = p.parent())
 		{
-			UpdateHierarchyItem(item, transform);
+			expand(p);
 		}
-		row++;
-		//ui->hierarchyTreeView->selectionModel()->sele
-	}
-
-	int redundantRows = m_hierarchyModel->rowCount() - row;
-	if (redundantRows > 0)
-	{
-		m_hierarchyModel->removeRows(row, redundantRows);
+		selection.select(index, index);
+		last = index;
 	}
-	//ui->hierarchyTreeView->update();
-	//ui->hierarchyTreeView->selectionModel()->blockSignals(false);
+	selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+	if (last.isValid())
+		scrollTo(last);
 	m_blockSignal = false;
 }
 
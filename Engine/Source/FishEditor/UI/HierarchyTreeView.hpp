@@ -9,9 +9,8 @@ namespace FishEngine
 	class Transform;
 }
 
-class QStandardItemModel;
-class QStandardItem;
 class QItemSelection;
+class HierarchyModel;
 
 class HierarchyTreeView : public QTreeView
 {
@@ -28,14 +27,12 @@ public:
 private slots:
 	//void UpdateHierarchyView();
 	void OnHierarchyViewSelectionChanged(QItemSelection const &,QItemSelection const &);
-	void UpdateHierarchyModel();
 
 	void ShowContexMenu(const QPoint&);
 
 private:
 
 	bool m_blockSignal = false;
-	bool m_inDragDropMode = false;
 
 	QMenu * m_menu;
 	
@@ -44,12 +41,12 @@ private:
 	//QAction * m_createSphereAction;
 	//QAction * m_createCameraAction;
 
-	//QStandardItem* UpdateHierarchyItem(std::shared_ptr<FishEngine::Transform> const & transform);
-	QStandardItemModel * m_hierarchyModel;
+	HierarchyModel * m_hierarchyModel;
 
 	//void CreatePrimitive(PrimitiveType type);
 
-	QStandardItem* UpdateHierarchyItem(QStandardItem * item, std::shared_ptr<FishEngine::Transform> const & transform);
+	// selects the items of Selection::transforms(), e.g. after picking in the scene view
+	void SyncSelection();
 
 	virtual void dragEnterEvent(QDragEnterEvent *event) override;
 	virtual void dropEvent(QDropEvent *event) override;
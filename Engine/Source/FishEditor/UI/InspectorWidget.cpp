@@ -6,6 +6,8 @@
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QTreeWidget>
+#include <QMouseEvent>
+#include <QChildEvent>
 
 #include <FishEngine/Debug.hpp>
 
@@ -19,6 +21,7 @@
 #include "../ModelImporter.hpp"
 #include "../Selection.hpp"
 #include "../Inspector.hpp"
+#include "../MainEditor.hpp"
 
 InspectorWidget::InspectorWidget(QWidget *parent) 
 	: QWidget(parent)
@@ -55,9 +58,87 @@ InspectorWidget::InspectorWidget(QWidget *parent)
 
 	rootLayout->addWidget(m_treeWidget);
 	
-	auto timer = new QTimer(this);
-	connect(timer, &QTimer::timeout, this, &InspectorWidget::Update);
-	timer->start(1000 / 10.0f); // 10 fps
+	// No polling: the shown objects are checked after what may change them, a frame of the scene view (edits,
+	// play mode, undo) or a new selection, and the sections are redrawn only if their dirtyCount changed.
+	FishEditor::MainEditor::OnFrameDrawn += [this]() { RequestUpdate(); };
+	FishEditor::Selection::selectionChanged += [this]() { RequestUpdate(); };
+	FishEditor::Selection::activeObjectChanged += [this]() { RequestUpdate(); };
+
+	WatchInput(this);
+}
+
+void InspectorWidget::RequestUpdate()
+{
+	if (m_updatePending)
+		return;
+	m_updatePending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_updatePending = false;
+		Update();
+	});
+}
+
+void InspectorWidget::WatchInput(QObject* object)
+{
+	object->installEventFilter(this);
+	for (auto child : object->children())
+	{
+		WatchInput(child);
+	}
+}
+
+int InspectorWidget::SectionOf(QWidget* widget) const
+{
+	auto viewport = m_treeWidget->viewport();
+	if (!viewport->isAncestorOf(widget))
+		return -1;
+	auto item = m_treeWidget->itemAt(widget->mapTo(viewport, QPoint(0, 0)));
+	if (item == nullptr)
+		return -1;
+	while (item->parent() != nullptr)
+	{
+		item = item->parent();
+	}
+	return m_treeWidget->indexOfTopLevelItem(item);
+}
+
+bool InspectorWidget::eventFilter(QObject *watched, QEvent *event)
+{
+	// The widgets hand user edits over when they are drawn: the section of the widget is redrawn after the widget
+	// handled the input, the whole inspector if the widget is in no section (the headers, Add Component).
+	bool userInput = false;
+	switch (event->type())
+	{
+	case QEvent::ChildAdded:
+		// the widgets of the sections are created as they are first drawn
+		WatchInput(static_cast<QChildEvent*>(event)->child());
+		return false;
+	case QEvent::MouseButtonPress:
+	case QEvent::MouseButtonRelease:
+	case QEvent::KeyPress:
+	case QEvent::Wheel:
+	case QEvent::FocusOut:
+		userInput = true;
+		break;
+	case QEvent::MouseMove:
+		// a drag (e.g. a slider) edits live, within the gesture of its press
+		if (static_cast<QMouseEvent*>(event)->buttons() == Qt::NoButton)
+			return false;
+		break;
+	default:
+		return false;
+	}
+
+	auto widget = qobject_cast<QWidget*>(watched);
+	if (widget == nullptr)
+		return false;
+	int section = SectionOf(widget);
+	if (section >= 0)
+		FishEditor::Inspector::RepaintSection(section, userInput);
+	else
+		FishEditor::Inspector::Repaint();
+	RequestUpdate();
+	return false;
 }
 
 InspectorWidget::~InspectorWidget()
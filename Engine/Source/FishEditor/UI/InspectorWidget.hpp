@@ -47,12 +47,24 @@ public:
 	
 	void HideAll();
 
+	// Refreshes the inspector on the next turn of the event loop; the requests made until then are coalesced.
+	void RequestUpdate();
+
+protected:
+	virtual bool eventFilter(QObject *watched, QEvent *event) override;
+
 signals:
 
 private:
 	void Update();
 	//std::string ShowAddComponentMenu();
 
+	// Filters the input of object and of its descendants, and of the children they get later.
+	void WatchInput(QObject* object);
+
+	// Index of the section (top level item of the tree) that contains widget, -1 if it is in none.
+	int SectionOf(QWidget* widget) const;
+
 	friend class FishEditor::Inspector;
 	QTreeWidget         * m_treeWidget;
 	UIGameObjectHeader  * m_gameObjectHeader;
@@ -62,6 +74,7 @@ private:
 	ModelImporterInspector * m_modelImporterInspector;
 
 	std::shared_ptr<FishEngine::Object> m_target;
+	bool m_updatePending = false;
 
 	//QMenu               * m_menu;
 };
@@ -8,7 +8,6 @@ class LogView;
 }
 
 class LogViewModel;
-class LogViewFilterModel;
 
 class LogView : public QDialog
 {
@@ -22,7 +21,6 @@ private:
 	Ui::LogView *ui;
 	
 	LogViewModel * m_model = nullptr;
-	LogViewFilterModel * m_filterModel = nullptr;
 };
 
 #endif // LOGVIEW_HPP
@@ -0,0 +1,321 @@
+#include "LogViewModel.hpp"
+
+#include <QIcon>
+#include <QTimer>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <limits>
+
+using namespace FishEngine;
+
+namespace
+{
+	constexpr int LogTypeCount = static_cast<int>(LogType::Exception) + 1;
+
+	// ms between two batches of row insertions
+	constexpr int FlushInterval = 100;
+
+	inline unsigned char Lower(char c)
+	{
+		return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+
+	inline uint32_t Trigram(std::string const & s, size_t i)
+	{
+		return (Lower(s[i]) << 16) | (Lower(s[i+1]) << 8) | Lower(s[i+2]);
+	}
+
+	// lowerNeedle must be lower case
+	bool ContainsNoCase(std::string const & haystack, std::string const & lowerNeedle)
+	{
+		auto it = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+			[](char a, char b) { return Lower(a) == static_cast<unsigned char>(b); });
+		return it != haystack.end();
+	}
+}
+
+
+LogViewModel::LogViewModel(QObject *parent)
+	: QAbstractTableModel(parent),
+	m_messageIDs(LogTypeCount),
+	m_entriesOfType(LogTypeCount),
+	m_messagesOfType(LogTypeCount)
+{
+	m_generation = SimpleLogger::GetInstance().generation();
+	auto timer = new QTimer(this);
+	connect(timer, &QTimer::timeout, this, &LogViewModel::Flush);
+	timer->start(FlushInterval);
+}
+
+int LogViewModel::rowCount(const QModelIndex &parent) const
+{
+	if (parent.isValid())
+		return 0;
+	return static_cast<int>(m_rows.size());
+}
+
+int LogViewModel::columnCount(const QModelIndex &parent) const
+{
+	if (parent.isValid())
+		return 0;
+	return ColumnCount;
+}
+
+QVariant LogViewModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= static_cast<int>(m_rows.size()))
+		return QVariant();
+
+	auto const & m = MessageAt(index.row());
+	static QIcon info_icon(":/Resources/console_info.png");
+	static QIcon warn_icon(":/Resources/console_warn.png");
+	static QIcon error_icon(":/Resources/console_error.png");
+
+	if (index.column() == CountColumn)
+	{
+		if (role == Qt::DisplayRole && m_collapsed)
+			return m.count;
+		if (role == Qt::TextAlignmentRole)
+			return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+		return QVariant();
+	}
+
+	switch (role)
+	{
+	case Qt::DisplayRole:
+		if (m.display.isNull())
+			m.display = QString::fromStdString(*m.text);
+		return m.display;
+	case Qt::DecorationRole:
+		switch (m.type)
+		{
+		case LogType::Log:
+			return info_icon;
+		case LogType::Warning:
+			return warn_icon;
+		case LogType::Error:
+			return error_icon;
+		default: ;
+		}
+		break;
+	}
+	return QVariant();
+}
+
+void LogViewModel::SetTypeEnabled(LogType type, bool enabled)
+{
+	int mask = m_typeMask;
+	if (enabled)
+		mask |= 1 << static_cast<int>(type);
+	else
+		mask &= ~(1 << static_cast<int>(type));
+	if (mask == m_typeMask)
+		return;
+	m_typeMask = mask;
+	RebuildRows();
+}
+
+void LogViewModel::SetCollapsed(bool collapsed)
+{
+	if (collapsed == m_collapsed)
+		return;
+	m_collapsed = collapsed;
+	RebuildRows();
+}
+
+void LogViewModel::SetSearchText(QString const & text)
+{
+	auto search = text.toLower().toStdString();
+	if (search == m_search)
+		return;
+	m_search = search;
+	UpdateSearchHits();
+	RebuildRows();
+}
+
+void LogViewModel::Clear()
+{
+	SimpleLogger::GetInstance().Clear();
+	Flush();
+}
+
+void LogViewModel::Flush()
+{
+	auto & logger = SimpleLogger::GetInstance();
+	if (logger.generation() != m_generation)
+	{
+		ResetStore();
+		m_generation = logger.generation();
+	}
+
+	m_pending.clear();
+	if (logger.Fetch(m_fetched, std::numeric_limits<size_t>::max(), m_pending) == 0)
+		return;
+	m_fetched += m_pending.size();
+
+	std::vector<uint32_t> newRows;
+	// collapse mode: range of the existing rows whose count changed
+	uint32_t firstCounted = std::numeric_limits<uint32_t>::max();
+	uint32_t lastCounted = 0;
+	uint32_t firstNewMessage = static_cast<uint32_t>(m_messages.size());
+
+	for (auto & d : m_pending)
+	{
+		auto entry = static_cast<uint32_t>(m_entries.size());
+		auto id = AddMessage(d);
+		m_entries.push_back(id);
+		m_entriesOfType[static_cast<int>(d.type)].push_back(entry);
+		auto & m = m_messages[id];
+		m.count++;
+
+		if (!Visible(id))
+			continue;
+		if (!m_collapsed)
+		{
+			newRows.push_back(entry);
+		}
+		else if (m.count == 1)
+		{
+			newRows.push_back(id);
+		}
+		else if (id < firstNewMessage)
+		{
+			firstCounted = std::min(firstCounted, id);
+			lastCounted = std::max(lastCounted, id);
+		}
+	}
+	m_pending.clear();
+
+	if (firstCounted <= lastCounted)
+	{
+		auto first = std::lower_bound(m_rows.begin(), m_rows.end(), firstCounted) - m_rows.begin();
+		auto last = std::lower_bound(m_rows.begin(), m_rows.end(), lastCounted) - m_rows.begin();
+		emit dataChanged(index(static_cast<int>(first), CountColumn), index(static_cast<int>(last), CountColumn));
+	}
+
+	if (!newRows.empty())
+	{
+		int first = static_cast<int>(m_rows.size());
+		beginInsertRows(QModelIndex(), first, first + static_cast<int>(newRows.size()) - 1);
+		m_rows.insert(m_rows.end(), newRows.begin(), newRows.end());
+		endInsertRows();
+	}
+}
+
+uint32_t LogViewModel::AddMessage(LogData & data)
+{
+	int type = static_cast<int>(data.type);
+	auto & ids = m_messageIDs[type];
+	auto it = ids.find(data.message);
+	if (it != ids.end())
+		return it->second;
+
+	auto id = static_cast<uint32_t>(m_messages.size());
+	it = ids.emplace(std::move(data.message), id).first;
+	m_messages.push_back(Message{ &it->first, data.type });
+	m_messagesOfType[type].push_back(id);
+	IndexMessage(id);
+	m_searchHits.push_back(Matches(id));
+	return id;
+}
+
+void LogViewModel::IndexMessage(uint32_t id)
+{
+	auto const & text = *m_messages[id].text;
+	for (size_t i = 0; i + 3 <= text.size(); ++i)
+	{
+		auto & ids = m_trigrams[Trigram(text, i)];
+		// the trigram may occur more than once in this message
+		if (ids.empty() || ids.back() != id)
+			ids.push_back(id);
+	}
+}
+
+bool LogViewModel::Matches(uint32_t id) const
+{
+	return m_search.empty() || ContainsNoCase(*m_messages[id].text, m_search);
+}
+
+bool LogViewModel::Visible(uint32_t id) const
+{
+	return (m_typeMask & (1 << static_cast<int>(m_messages[id].type))) && m_searchHits[id];
+}
+
+LogViewModel::Message const & LogViewModel::MessageAt(int row) const
+{
+	auto i = m_rows[row];
+	return m_messages[m_collapsed ? i : m_entries[i]];
+}
+
+void LogViewModel::UpdateSearchHits()
+{
+	if (m_search.size() < 3)
+	{
+		// too short for the trigram index
+		for (uint32_t id = 0; id < m_messages.size(); ++id)
+			m_searchHits[id] = Matches(id);
+		return;
+	}
+
+	std::fill(m_searchHits.begin(), m_searchHits.end(), 0);
+
+	// every match contains all trigrams of the search text, verify the candidates of the rarest one
+	std::vector<uint32_t> const * candidates = nullptr;
+	for (size_t i = 0; i + 3 <= m_search.size(); ++i)
+	{
+		auto it = m_trigrams.find(Trigram(m_search, i));
+		if (it == m_trigrams.end())
+			return;
+		if (candidates == nullptr || it->second.size() < candidates->size())
+			candidates = &it->second;
+	}
+	for (auto id : *candidates)
+	{
+		m_searchHits[id] = Matches(id);
+	}
+}
+
+void LogViewModel::RebuildRows()
+{
+	beginResetModel();
+	m_rows.clear();
+	auto const & ofType = m_collapsed ? m_messagesOfType : m_entriesOfType;
+	std::vector<uint32_t> merged;
+	for (int t = 0; t < LogTypeCount; ++t)
+	{
+		if (!(m_typeMask & (1 << t)) || ofType[t].empty())
+			continue;
+		merged.clear();
+		merged.reserve(m_rows.size() + ofType[t].size());
+		std::merge(m_rows.begin(), m_rows.end(), ofType[t].begin(), ofType[t].end(), std::back_inserter(merged));
+		m_rows.swap(merged);
+	}
+	if (!m_search.empty())
+	{
+		auto end = std::remove_if(m_rows.begin(), m_rows.end(), [this](uint32_t i) {
+			return !m_searchHits[m_collapsed ? i : m_entries[i]];
+		});
+		m_rows.erase(end, m_rows.end());
+	}
+	endResetModel();
+}
+
+void LogViewModel::ResetStore()
+{
+	beginResetModel();
+	m_fetched = 0;
+	m_entries.clear();
+	m_messages.clear();
+	for (auto & ids : m_messageIDs)
+		ids.clear();
+	for (auto & rows : m_entriesOfType)
+		rows.clear();
+	for (auto & rows : m_messagesOfType)
+		rows.clear();
+	m_trigrams.clear();
+	m_searchHits.clear();
+	m_rows.clear();
+	endResetModel();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QString>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <FishEngine/Internal/SimpleLogger.hpp>
+
+// Item model of the console.
+// Messages are pulled from SimpleLogger on a timer and inserted as one batch of rows per tick.
+// Rows of each log type are kept as sorted index lists, so toggling a type, collapsing identical
+// messages or searching only merges integer lists and never touches the message text again.
+class LogViewModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Column
+	{
+		MessageColumn,
+		CountColumn,	// number of occurrences, collapse mode only
+		ColumnCount,
+	};
+
+	explicit LogViewModel(QObject *parent = nullptr);
+
+	virtual int			rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	virtual int			columnCount(const QModelIndex &parent = QModelIndex()) const override;
+	virtual QVariant	data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+	void SetTypeEnabled(FishEngine::LogType type, bool enabled);
+
+	// Shows identical messages (same type and text) as one row with the number of occurrences.
+	void SetCollapsed(bool collapsed);
+	bool collapsed() const { return m_collapsed; }
+
+	// Case-insensitive substring filter, empty to show all messages.
+	void SetSearchText(QString const & text);
+
+	// Clears SimpleLogger and the console.
+	void Clear();
+
+	// Inserts the messages logged since the last call as one batch of rows.
+	void Flush();
+
+private:
+	// a distinct (type, text) pair
+	struct Message
+	{
+		std::string const *		text;		// key in m_messageIDs
+		FishEngine::LogType		type;
+		uint32_t				count = 0;
+		mutable QString			display;	// converted on first display
+	};
+
+	uint32_t AddMessage(FishEngine::LogData & data);
+	void IndexMessage(uint32_t id);
+	bool Matches(uint32_t id) const;
+	bool Visible(uint32_t id) const;
+	Message const & MessageAt(int row) const;
+
+	void UpdateSearchHits();
+	void RebuildRows();
+	void ResetStore();
+
+	size_t							m_fetched = 0;		// number of SimpleLogger entries already in the model
+	uint32_t						m_generation = 0;	// SimpleLogger::generation() of m_fetched
+
+	std::vector<uint32_t>			m_entries;			// message id of every log entry
+	std::vector<Message>			m_messages;
+	std::vector<std::unordered_map<std::string, uint32_t>>	m_messageIDs;		// per type, text -> message id
+	std::vector<std::vector<uint32_t>>	m_entriesOfType;	// per type, sorted entry indices
+	std::vector<std::vector<uint32_t>>	m_messagesOfType;	// per type, sorted message ids
+
+	// trigram of lower case bytes -> ids of the messages containing it
+	std::unordered_map<uint32_t, std::vector<uint32_t>>	m_trigrams;
+	std::string						m_search;			// lower case
+	std::vector<char>				m_searchHits;		// per message
+
+	// visible rows, entry indices or message ids in collapse mode, sorted
+	std::vector<uint32_t>			m_rows;
+	int								m_typeMask = 0;
+	bool							m_collapsed = false;
+
+	std::vector<FishEngine::LogData>	m_pending;
+};
@@ -7,6 +7,7 @@
 #include <QDir>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QApplication>
 
 #include <FishEngine/FishEngine.hpp>
 #include <FishEngine/Debug.hpp>
@@ -29,6 +30,8 @@
 #include "FileInfo.hpp"
 #include "Selection.hpp"
 #include "EditorApplication.hpp"
+#include "Undo.hpp"
+#include "ScriptManager.hpp"
 
 #include <fstream>
 
@@ -54,7 +57,7 @@ MainWindow::MainWindow(QWidget *parent) :
 
 	ui->sceneView->setFocus();
 
-	FishEditor::Inspector::s_inspectorWidget = ui->inspectorWidget;
+	FishEditor::Inspector::SetInsectorWidget(ui->inspectorWidget);
 
 	connect(ui->actionNewScene, &QAction::triggered, this, &MainWindow::NewScene);
 
@@ -106,6 +109,7 @@ MainWindow::MainWindow(QWidget *parent) :
 			this->ui->actionCenterOrPivot->setText("Pivot");
 			FishEditor::MainEditor::m_mainSceneViewEditor->setTransformPivot(FishEditor::TransformPivot::Pivot);
 		}
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 
 	connect(ui->actionLocalOrGlobal, &QAction::triggered, [this]() {
@@ -121,6 +125,7 @@ MainWindow::MainWindow(QWidget *parent) :
 			this->ui->actionLocalOrGlobal->setText("Local");
 			FishEditor::MainEditor::m_mainSceneViewEditor->setTransformSpace(FishEditor::TransformSpace::Local);
 		}
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 
 	connect(ui->actionHand, &QAction::triggered, [this](){
@@ -130,6 +135,7 @@ MainWindow::MainWindow(QWidget *parent) :
 		this->ui->actionRotation->setChecked(false);
 		this->ui->actionScale->setChecked(false);
 		this->ui->actionHand->setChecked(true);
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 
 	connect(ui->actionTranslate, &QAction::triggered, [this](){
@@ -139,6 +145,7 @@ MainWindow::MainWindow(QWidget *parent) :
 		this->ui->actionRotation->setChecked(false);
 		this->ui->actionScale->setChecked(false);
 		this->ui->actionTranslate->setChecked(true);
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 
 	connect(ui->actionRotation, &QAction::triggered, [this](){
@@ -148,6 +155,7 @@ MainWindow::MainWindow(QWidget *parent) :
 		//this->ui->actionRotation->setChecked(false);
 		this->ui->actionScale->setChecked(false);
 		this->ui->actionRotation->setChecked(true);
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 
 	connect(ui->actionScale, &QAction::triggered, [this](){
@@ -157,11 +165,13 @@ MainWindow::MainWindow(QWidget *parent) :
 		this->ui->actionRotation->setChecked(false);
 		//this->ui->actionScale->setChecked(false);
 		this->ui->actionScale->setChecked(true);
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 
 	connect(ui->actionFrameSelected, &QAction::triggered, [](){
 		//FishEngine::Camera::main()->FrameSelected(FishEditor::Selection::activeGameObject());
 		FishEditor::MainEditor::m_mainSceneViewEditor->FrameSelected();
+		FishEditor::MainEditor::RepaintSceneView();
 	});
 	
 	connect(ui->sceneViewDrawModeButton, &QToolButton::clicked, this, &MainWindow::ShowSceneViewDrawModeMenu);
@@ -176,6 +186,20 @@ MainWindow::MainWindow(QWidget *parent) :
 			ui->hierarchyTreeView->m_duplicateAction,
 			&QAction::trigger);
 
+	connect(ui->actionUndo, &QAction::triggered, [](){
+		FishEditor::Undo::PerformUndo();
+	});
+
+	connect(ui->actionRedo, &QAction::triggered, [](){
+		FishEditor::Undo::PerformRedo();
+	});
+
+	// scripts edited in another application are reloaded when the editor gets the focus back
+	connect(qApp, &QGuiApplication::applicationStateChanged, [](Qt::ApplicationState state) {
+		if (state == Qt::ApplicationActive && FishEditor::ScriptManager::hasInstance() && !Application::isPlaying())
+			FishEditor::ScriptManager::GetInstance().ReloadIfChanged();
+	});
+
 //    FishEditor::MainEditor::OnInitialized += [this](){
 //        ui->projectView->SetRootPath(FishEngine::Application::dataPath());
 //    };
@@ -259,6 +283,8 @@ void MainWindow::OpenScene()
 	std::ifstream fin(path.toStdString());
 	FishEditor::SceneInputArchive archive(fin);
 	archive.LoadAll();
+	// the history refers to the objects of the previous scene
+	FishEditor::Undo::ClearAll();
 }
 
 void MainWindow::SaveSceneAs()
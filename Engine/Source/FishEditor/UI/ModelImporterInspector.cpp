@@ -53,6 +53,11 @@ ModelImporterInspector::ModelImporterInspector(QWidget *parent) : QWidget(parent
 	m_verticalLayout->addWidget(m_tangentsCombox);
 	m_materialSearchCombox = CreateCombox<decltype(ModelImporter::m_materialSearch)>("Material Search");
 	m_verticalLayout->addWidget(m_materialSearchCombox);
+	for (int i = 0; i < LODFieldCount; ++i)
+	{
+		m_lodRatioEdits[i] = new UIFloat("LOD " + std::to_string(i+1) + " Ratio", 0.0f, this);
+		m_verticalLayout->addWidget(m_lodRatioEdits[i]);
+	}
 	
 	m_revertApplyButtons = new UIRevertApplyButtons();
 	m_verticalLayout->addWidget(m_revertApplyButtons);
@@ -96,6 +101,21 @@ ModelImporterInspector::ModelImporterInspector(QWidget *parent) : QWidget(parent
 				m_cachedImporter->m_materialSearch = FishEngine::ToEnum<decltype(m_cachedImporter->m_materialSearch)>(index);
 				this->SetDirty(true);
 			});
+	
+	for (int i = 0; i < LODFieldCount; ++i)
+	{
+		connect(m_lodRatioEdits[i],
+				&UIFloat::ValueChanged,
+				[this, i](float value) {
+					auto & ratios = m_cachedImporter->m_lodTargetRatios;
+					if (ratios.size() <= static_cast<size_t>(i))
+						ratios.resize(i + 1, 0.0f);
+					ratios[i] = value;
+					while (!ratios.empty() && ratios.back() <= 0.0f)
+						ratios.pop_back();
+					this->SetDirty(true);
+				});
+	}
 
 	
 	connect(m_revertApplyButtons, &UIRevertApplyButtons::OnRevert, this, &ModelImporterInspector::Revert);
@@ -152,6 +172,9 @@ void ModelImporterInspector::Bind(std::shared_ptr<FishEditor::ModelImporter> con
 		m_tangentsCombox->SetValue(index);
 		index = FishEngine::EnumToIndex(m_cachedImporter->m_materialSearch);
 		m_materialSearchCombox->SetValue(index);
+		auto const & ratios = m_cachedImporter->m_lodTargetRatios;
+		for (int i = 0; i < LODFieldCount; ++i)
+			m_lodRatioEdits[i]->SetValue(static_cast<size_t>(i) < ratios.size() ? ratios[i] : 0.0f);
 	}
 }
 
@@ -51,6 +51,10 @@ private:
 	UIComboBox		* m_tangentsCombox;
 	UIComboBox		* m_materialSearchCombox;
 	
+	// triangle ratio of LOD 1, 2, 3; 0 ends the chain
+	static constexpr int LODFieldCount = 3;
+	UIFloat			* m_lodRatioEdits[LODFieldCount];
+	
 	bool m_isDirty = false;
 	
 	std::unique_ptr<FishEditor::ModelImporter> m_cachedImporter;
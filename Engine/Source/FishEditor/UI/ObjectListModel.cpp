@@ -2,6 +2,7 @@
 
 #include "../AssetImporter.hpp"
 #include "../AssetDataBase.hpp"
+#include "../SearchIndex.hpp"
 
 #include <FishEngine/Texture.hpp>
 #include <FishEngine/Debug.hpp>
@@ -17,17 +18,29 @@ ObjectListModel::ObjectListModel(QObject *parent)
 
 void ObjectListModel::SetObjectType(int classID)
 {
+	m_classID = classID;
+	Search();
+}
+
+void ObjectListModel::SetSearchText(QString const & text)
+{
+	auto search = text.toStdString();
+	if (search == m_search)
+		return;
+	m_search = search;
+	Search();
+}
+
+void ObjectListModel::Search()
+{
+	beginResetModel();
 	m_cachedObjects.clear();
-	for (auto const & pair : AssetImporter::s_importerGUIDToObject)
+	for (auto const & result : SearchIndex::Search(m_search, m_classID))
 	{
-		for (auto & obj : pair.second->m_assetObjects)
-		{
-			if (FishEngine::IsDerivedFrom(obj->ClassID(), classID))
-			{
-				m_cachedObjects.push_back(obj);
-			}
-		}
+		if (!result.isSceneObject)
+			m_cachedObjects.push_back(result.object);
 	}
+	endResetModel();
 }
 
 std::shared_ptr<Object> ObjectListModel::object(const QModelIndex &index) const
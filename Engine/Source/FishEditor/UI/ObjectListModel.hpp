@@ -2,6 +2,7 @@
 
 #include <QAbstractListModel>
 #include <memory>
+#include <string>
 
 namespace FishEngine
 {
@@ -13,13 +14,21 @@ class ObjectListModel : public QAbstractListModel
 public:
 	explicit ObjectListModel(QObject *parent = nullptr);
 
+	// Lists the assets of this class (or a derived one) that match the search text.
 	void SetObjectType(int classID);
+	void SetSearchText(QString const & text);
 
 	std::shared_ptr<FishEngine::Object> object(const QModelIndex &index) const;
 
 	virtual int rowCount(const QModelIndex & parent = QModelIndex()) const Q_DECL_OVERRIDE;
 	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const Q_DECL_OVERRIDE;
 
+private:
+	void Search();
+
+	int			m_classID = 0;
+	std::string	m_search;
+
 public:
 	std::vector<std::shared_ptr<FishEngine::Object>> m_cachedObjects;
 };
@@ -35,6 +35,9 @@ ProjectView::ProjectView(QWidget *parent) :
 //    tree->header()->hide();
 
 	m_fileModel = new ProjectViewFileModel(this);
+	m_fileModel->OnDirectoriesChanged = [this]() {
+		m_dirModel->Reset();
+	};
 	ui->listView->setFileModel(m_fileModel);
 	ui->listView->setModel(m_fileModel);
 	ui->listView->setUniformItemSizes(true);
@@ -52,10 +55,9 @@ ProjectView::ProjectView(QWidget *parent) :
 	OnIconSizeChanged(m_listViewIconSize);
 
 	auto const & rootPath = FishEngine::Application::dataPath();
-	SetRootPath(QString::fromStdString(rootPath.string()));
-	
 	m_assetsDirWatcher = new QFileSystemWatcher(this);
 	m_assetsDirWatcher->addPath(QString::fromStdString(rootPath.string()));
+	SetRootPath(QString::fromStdString(rootPath.string()));
 	
 	
 	connect(m_assetsDirWatcher,
@@ -125,9 +127,26 @@ void ProjectView::SetRootPath(const QString &path)
 {
 	if (path.isEmpty() || path.isNull())
 		return;
+	ShowDirectory(path);
+	//ui->dirTreeView->setCurrentIndex(dirModel->setRootPath(path));
+}
+
+void ProjectView::ShowDirectory(QString const & path)
+{
 	ui->listView->setRootIndex(m_fileModel->setRootPath(path));
 	ui->listView->selectionModel()->clearSelection();
-	//ui->dirTreeView->setCurrentIndex(dirModel->setRootPath(path));
+
+	auto root = m_assetsDirWatcher->directories().value(0);
+	if (!m_watchedDir.isEmpty())
+	{
+		m_assetsDirWatcher->removePath(m_watchedDir);
+		m_watchedDir.clear();
+	}
+	if (QDir::cleanPath(path) != QDir::cleanPath(root))
+	{
+		m_watchedDir = path;
+		m_assetsDirWatcher->addPath(path);
+	}
 }
 
 void ProjectView::OnDirTreeViewSelectionChanged(const QModelIndex &current, const QModelIndex &)
@@ -139,8 +158,7 @@ void ProjectView::OnDirTreeViewSelectionChanged(const QModelIndex &current, cons
 	auto path = QString::fromStdString(m_dirModel->fileInfo(current)->absoluteFilePath().string());
 	if (path.isEmpty() || path.isNull())
 		return;
-	ui->listView->setRootIndex(m_fileModel->setRootPath(path));
-	ui->listView->selectionModel()->clearSelection();
+	ShowDirectory(path);
 }
 
 
@@ -150,8 +168,7 @@ void ProjectView::OnListViewDoubleClicked(const QModelIndex &index)
 	if (info->isDir())
 	{
 		auto path = QString::fromStdString(info->absoluteFilePath().string());
-		ui->listView->setRootIndex(m_fileModel->setRootPath(path));
-		ui->listView->selectionModel()->clearSelection();
+		ShowDirectory(path);
 		ui->dirTreeView->setCurrentIndex(m_dirModel->setRootPath(info->path()));
 	}
 }
@@ -223,4 +240,5 @@ void ProjectView::OnFileChanged(QString const & path)
 void ProjectView::OnDirectoryChanged(QString const & path)
 {
 	LogInfo(path.toStdString());
+	m_fileModel->Rescan(path);
 }
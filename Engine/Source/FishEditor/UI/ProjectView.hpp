@@ -34,6 +34,9 @@ private:
 	void OnFileChanged(QString const & path);
 	void OnDirectoryChanged(QString const & path);
 
+	// Shows the folder in the list view and watches it for changes.
+	void ShowDirectory(QString const & path);
+
 private:
 	Ui::ProjectView         * ui;
 
@@ -41,6 +44,7 @@ private:
 	ProjectViewFileModel    * m_fileModel;
 	
 	QFileSystemWatcher		* m_assetsDirWatcher;
+	QString					m_watchedDir;	// the folder in the list view, if it is not the root
 
 	int m_listViewIconSize = 16;
 };
@@ -1,24 +1,45 @@
 #include "ProjectViewFileModel.hpp"
 
 #include <QIcon>
+#include <QTimer>
 #include <FishEngine/Debug.hpp>
 #include "AssetDataBase.hpp"
 
+#include <algorithm>
+#include <thread>
+
 using namespace FishEngine;
 using namespace FishEditor;
 
 
+namespace
+{
+	constexpr int		BatchSize = 1000;		// rows inserted per tick
+	constexpr int		BatchInterval = 15;		// ms
+	constexpr size_t	MaxSnapshots = 16;		// folders whose rows are kept
+
+	QIcon const & FolderIcon()
+	{
+		static QIcon icon(":/Resources/Assets/Folder@64.png");
+		return icon;
+	}
+}
+
+
 ProjectViewFileModel::ProjectViewFileModel(QObject *parent)
 	: QAbstractListModel(parent)
 {
+	m_timer = new QTimer(this);
+	m_timer->setInterval(BatchInterval);
+	connect(m_timer, &QTimer::timeout, this, &ProjectViewFileModel::OnTimer);
 }
 
 
-int ProjectViewFileModel::rowCount(const QModelIndex &) const
+int ProjectViewFileModel::rowCount(const QModelIndex & parent) const
 {
-	if (m_rootNode == nullptr)
+	if (parent.isValid())
 		return 0;
-	return static_cast<int>( m_rootNode->childCount() );
+	return m_rowCount;
 }
 
 
@@ -27,19 +48,26 @@ QVariant ProjectViewFileModel::data(const QModelIndex &index, int role) const
 	if ( !index.isValid() || index.model() != this )
 		return QVariant();
 	int row = index.row();
-	if ( row >= m_rootNode->childCount() || row < 0 )
+	if ( row >= m_rowCount || row < 0 )
 		return QVariant();
 
-	auto const & node = m_rootNode->childAt(index.row());
-	
+	// only asked for the rows in sight
+	auto const & r = (*m_rows)[row];
+	if (!r.resolved)
+	{
+		r.name = QString::fromStdString(r.info->stem());
+		r.icon = r.info->isDir() ? FolderIcon() : FishEditor::AssetDatabase::GetCacheIcon(r.info->absoluteFilePath());
+		r.resolved = true;
+	}
+
 	switch (role)
 	{
 	case Qt::EditRole:
 	case Qt::DisplayRole:
-		return QString::fromStdString(node->stem());
+		return r.name;
 		break;
 	case Qt::DecorationRole:
-		return FishEditor::AssetDatabase::GetCacheIcon(node->absoluteFilePath());
+		return r.icon;
 		break;
 	}
 
@@ -66,6 +94,8 @@ bool ProjectViewFileModel::setData(const QModelIndex &index, const QVariant &val
 	{
 		auto fi = this->fileInfo(index);
 		fi->Rename(value.toString().toStdString());
+		(*m_rows)[index.row()].resolved = false;
+		emit dataChanged(index, index);
 		return true;
 	}
 	
@@ -101,7 +131,12 @@ QString ProjectViewFileModel::rootPath() const
 QModelIndex ProjectViewFileModel::setRootPath(const QString &path)
 {
 	auto p = boost::filesystem::absolute(path.toStdString()).make_preferred().string();
-	m_rootNode = FileInfo::fileInfo(p);
+	auto node = FileInfo::fileInfo(p);
+	ShowRoot(node);
+	if (!node->listed())
+	{
+		StartScan(node);
+	}
 
 	//FishEngine::Debug::LogError("ProjectViewFileModel::setRootPath: %s", path.toStdString().c_str());
 	return QModelIndex();
@@ -110,6 +145,7 @@ QModelIndex ProjectViewFileModel::setRootPath(const QString &path)
 
 QModelIndex ProjectViewFileModel::AddItem(QString const & name, bool isDir)
 {
+	InsertAll();
 	int row = static_cast<int>(m_rootNode->subDirCount());
 	beginInsertRows(QModelIndex(), row, row);
 	if (!isDir)
@@ -119,6 +155,8 @@ QModelIndex ProjectViewFileModel::AddItem(QString const & name, bool isDir)
 	}
 	auto fileInfo = m_rootNode->CreateNewSubDir(name.toStdString());
 	fileInfo->m_isDirectory = true;
+	m_rows->insert(m_rows->begin() + row, Row{ fileInfo });
+	m_rowCount++;
 	endInsertRows();
 	return createIndex(row, 0, fileInfo);
 }
@@ -126,31 +164,224 @@ QModelIndex ProjectViewFileModel::AddItem(QString const & name, bool isDir)
 
 void ProjectViewFileModel::RemoveItem(int row)
 {
+	InsertAll();
 	beginRemoveRows(QModelIndex(), row, row);
-	auto node = m_rootNode->childAt(row);
-	node->DeleteFile();
+	// also removes it from m_rootNode
+	(*m_rows)[row].info->DeleteFile();
+	m_rows->erase(m_rows->begin() + row);
+	m_rowCount--;
+	endRemoveRows();
+}
+
+FileInfo *ProjectViewFileModel::fileInfo(const QModelIndex &index) const
+{
+	if (!index.isValid())
+	{
+		return m_rootNode;
+	}
+	return (*m_rows)[index.row()].info;
+}
 
-	if (node->isDir())
+
+void ProjectViewFileModel::Rescan(QString const & path)
+{
+	auto p = boost::filesystem::absolute(path.toStdString()).make_preferred().string();
+	auto node = FileInfo::find(p);
+	if (node != nullptr)
 	{
-		auto iter = m_rootNode->m_dirChildren.begin() + row;
-		m_rootNode->m_dirChildren.erase(iter);
+		StartScan(node);
 	}
-	else
+}
+
+
+ProjectViewFileModel::Rows & ProjectViewFileModel::RowsOf(FileInfo * node)
+{
+	m_recent.erase(std::remove(m_recent.begin(), m_recent.end(), node), m_recent.end());
+	m_recent.push_back(node);
+
+	auto it = m_snapshots.find(node);
+	if (it == m_snapshots.end())
 	{
-		auto iter = m_rootNode->m_fileChildren.begin() + (row - m_rootNode->subDirCount());
-		m_rootNode->m_fileChildren.erase(iter);
+		Rows rows;
+		rows.reserve(node->childCount());
+		for (int i = 0; i < static_cast<int>(node->childCount()); ++i)
+		{
+			rows.push_back(Row{ node->childAt(i) });
+		}
+		it = m_snapshots.emplace(node, std::move(rows)).first;
+
+		while (m_recent.size() > MaxSnapshots)
+		{
+			m_snapshots.erase(m_recent.front());
+			m_recent.erase(m_recent.begin());
+		}
 	}
+	return it->second;
+}
 
-	endRemoveRows();
+
+void ProjectViewFileModel::ShowRoot(FileInfo * node)
+{
+	beginResetModel();
+	m_rootNode = node;
+	m_rows = &RowsOf(node);
+	m_rowCount = 0;
+	endResetModel();
+	StartInsertion();
 }
 
-FileInfo *ProjectViewFileModel::fileInfo(const QModelIndex &index) const
+
+void ProjectViewFileModel::StartInsertion()
 {
-	if (!index.isValid())
+	// the first batch is there for the first paint, the rest follows on the timer
+	InsertBatch();
+	if (m_rowCount < static_cast<int>(m_rows->size()))
 	{
-		return m_rootNode;
+		m_timer->start();
+	}
+}
+
+
+void ProjectViewFileModel::Refresh(FileInfo * node, std::vector<std::unique_ptr<FileInfo>> & removed)
+{
+	auto isRemoved = [&removed](FileInfo * n) {
+		for (; n != nullptr; n = n->parent())
+		{
+			for (auto const & r : removed)
+			{
+				if (r.get() == n)
+					return true;
+			}
+		}
+		return false;
+	};
+
+	// the view lets go of the old rows before they, and the nodes they point to, are freed
+	bool showsRoot = node == m_rootNode || isRemoved(m_rootNode);
+	if (showsRoot)
+		beginResetModel();
+
+	for (auto it = m_snapshots.begin(); it != m_snapshots.end(); )
+	{
+		if (it->first == node || isRemoved(it->first))
+		{
+			m_recent.erase(std::remove(m_recent.begin(), m_recent.end(), it->first), m_recent.end());
+			it = m_snapshots.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+	m_scans.erase(std::remove_if(m_scans.begin(), m_scans.end(), [&isRemoved](std::shared_ptr<Scan> const & s) {
+		return isRemoved(s->node);
+	}), m_scans.end());
+
+	if (showsRoot)
+	{
+		// a deleted folder was shown: the folder that contained it is
+		m_rootNode = node;
+		m_rows = &RowsOf(node);
+		m_rowCount = 0;
+	}
+	removed.clear();
+	if (showsRoot)
+	{
+		endResetModel();
+		StartInsertion();
+	}
+}
+
+
+void ProjectViewFileModel::StartScan(FileInfo * node)
+{
+	for (auto const & s : m_scans)
+	{
+		if (s->node == node)
+		{
+			// the listing may have been made before the change
+			s->again = true;
+			return;
+		}
+	}
+
+	auto scan = std::make_shared<Scan>();
+	scan->node = node;
+	scan->path = node->path();
+	m_scans.push_back(scan);
+	std::thread([scan]() {
+		scan->entries = FileInfo::ScanDirectory(scan->path);
+		scan->done = true;
+	}).detach();
+	m_timer->start();
+}
+
+
+void ProjectViewFileModel::OnTimer()
+{
+	InsertBatch();
+
+	bool dirsChanged = false;
+	auto scans = m_scans;
+	for (auto const & s : scans)
+	{
+		if (!s->done)
+			continue;
+		auto it = std::find(m_scans.begin(), m_scans.end(), s);
+		// its folder was deleted by a scan of this turn
+		if (it == m_scans.end())
+			continue;
+		m_scans.erase(it);
+
+		auto node = s->node;
+		auto dirs = node->m_dirChildren;
+		std::vector<std::unique_ptr<FileInfo>> removed;
+		if (node->UpdateChildren(s->entries, &removed))
+		{
+			dirsChanged = dirsChanged || dirs != node->m_dirChildren;
+			Refresh(node, removed);
+		}
+		if (s->again)
+		{
+			StartScan(node);
+		}
+	}
+
+	if (dirsChanged && OnDirectoriesChanged)
+	{
+		OnDirectoriesChanged();
+	}
+
+	if (m_scans.empty() && (m_rows == nullptr || m_rowCount == static_cast<int>(m_rows->size())))
+	{
+		m_timer->stop();
 	}
-	return m_rootNode->childAt(index.row());
+}
+
+
+void ProjectViewFileModel::InsertBatch()
+{
+	if (m_rows == nullptr)
+		return;
+	int count = std::min(BatchSize, static_cast<int>(m_rows->size()) - m_rowCount);
+	if (count <= 0)
+		return;
+	beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + count - 1);
+	m_rowCount += count;
+	endInsertRows();
+}
+
+
+void ProjectViewFileModel::InsertAll()
+{
+	if (m_rows == nullptr)
+		return;
+	int count = static_cast<int>(m_rows->size()) - m_rowCount;
+	if (count <= 0)
+		return;
+	beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + count - 1);
+	m_rowCount += count;
+	endInsertRows();
 }
 
 
@@ -2,9 +2,22 @@
 
 #include <QAbstractItemModel>
 #include <QAbstractListModel>
+#include <QIcon>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include "FileInfo.hpp"
 
+class QTimer;
+
+// Item model of the files in the current folder of the project view.
+// Rows are inserted in batches on a timer, so that opening a folder with thousands of files paints at once.
+// Names and icons are resolved when a row is first displayed, i.e. only for the visible rows, and kept per folder.
+// Folders that changed on disk are listed again on a background thread and merged into the FileInfo tree.
 class ProjectViewFileModel : public QAbstractListModel
 {
 public:
@@ -24,12 +37,53 @@ public:
 
 	FishEditor::FileInfo * fileInfo(const QModelIndex &index) const;
 
-Q_SIGNALS:
-	void DirRemoved();
-	void DirAdded();
+	// The folder changed on disk (file system watcher), lists it again in the background.
+	void Rescan(QString const & path);
+
+	// Called when a rescan changed the sub folders of a folder.
+	std::function<void()> OnDirectoriesChanged;
 
 private:
+	struct Row
+	{
+		FishEditor::FileInfo *	info;
+		mutable bool			resolved = false;
+		mutable QString			name;
+		mutable QIcon			icon;
+	};
+	typedef std::vector<Row> Rows;
+
+	struct Scan
+	{
+		FishEditor::FileInfo *	node;
+		FishEngine::Path		path;
+		std::vector<FishEditor::FileInfo::Entry> entries;	// written by the scanning thread
+		std::atomic<bool>		done { false };
+		bool					again = false;	// changed again while scanning
+	};
+
+	Rows & RowsOf(FishEditor::FileInfo * node);
+	void ShowRoot(FishEditor::FileInfo * node);
+	void StartInsertion();
+	// The children of node were listed again: its rows are rebuilt, and removed, its former children, deleted with
+	// the rows, snapshots and scans that refer to them.
+	void Refresh(FishEditor::FileInfo * node, std::vector<std::unique_ptr<FishEditor::FileInfo>> & removed);
+	void StartScan(FishEditor::FileInfo * node);
+	void OnTimer();
+	void InsertBatch();
+	void InsertAll();
+
 	FishEditor::FileInfo * m_rootNode = nullptr;
+
+	// rows of the folders opened recently, m_rows points into it; dropped when the folder is listed again
+	std::map<FishEditor::FileInfo*, Rows>	m_snapshots;
+	std::vector<FishEditor::FileInfo*>		m_recent;		// keys of m_snapshots, least recent first
+	Rows *									m_rows = nullptr;
+	int										m_rowCount = 0;	// rows of *m_rows inserted in the view
+
+	// shared with the scanning threads, which are detached: the model does not wait for them
+	std::vector<std::shared_ptr<Scan>>		m_scans;
+	QTimer *								m_timer;
 };
 
 class ProjectViewDirModel : public QAbstractItemModel
@@ -70,4 +124,11 @@ public:
 
 	QModelIndex setRootPath(const Path &path);
 	FishEditor::FileInfo * fileInfo(const QModelIndex &index) const;
+
+	// The sub folders of some folder changed.
+	void Reset()
+	{
+		beginResetModel();
+		endResetModel();
+	}
 };
@@ -17,6 +17,7 @@ SelectObjectDialog::SelectObjectDialog(QWidget *parent) :
 	ui->iconSizeSlider->setValue(m_listViewIconSize);
 	OnIconSizeChanged(m_listViewIconSize);
 	connect(ui->iconSizeSlider, &QSlider::valueChanged, this, &SelectObjectDialog::OnIconSizeChanged);
+	connect(ui->lineEdit, &QLineEdit::textChanged, m_model, &ObjectListModel::SetSearchText);
 	connect(ui->listView->selectionModel(), &QItemSelectionModel::currentChanged, this, &SelectObjectDialog::OnListViewSelectionChanged);
 }
 
@@ -28,6 +29,7 @@ SelectObjectDialog::~SelectObjectDialog()
 void SelectObjectDialog::ShowWithCallback(int classID, const Callback &callback)
 {
 	m_callback = callback;
+	ui->lineEdit->clear();
 	m_model->SetObjectType(classID);
 	this->exec();
 }
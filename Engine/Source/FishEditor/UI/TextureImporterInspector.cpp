@@ -15,6 +15,7 @@
 #include "../AssetDataBase.hpp"
 #include "generate/Enum_TextureImporterType.hpp"
 #include "generate/Enum_TextureImporterShape.hpp"
+#include "generate/Enum_TextureImporterCubemapConvolution.hpp"
 #include <FishEngine/Generated/Enum_FilterMode.hpp>
 #include <FishEngine/Generated/Enum_TextureWrapMode.hpp>
 
@@ -52,6 +53,8 @@ TextureImporterInspector::TextureImporterInspector(QWidget *parent) :
 	m_verticalLayout->addWidget(m_typeCombox);
 	m_shapeCombox = CreateCombox<TextureImporterShape>("Texture Shape");
 	m_verticalLayout->addWidget(m_shapeCombox);
+	m_convolutionCombox = CreateCombox<TextureImporterCubemapConvolution>("Convolution Type");
+	m_verticalLayout->addWidget(m_convolutionCombox);
 	m_readWriteToggle = new UIBool("Read/Write Enabled", true);
 	m_verticalLayout->addWidget(m_readWriteToggle);
 	m_mipmapToggle = new UIBool("Generate Mip Maps", true);
@@ -98,6 +101,13 @@ TextureImporterInspector::TextureImporterInspector(QWidget *parent) :
 				this->SetDirty(true);
 			});
 	
+	connect(m_convolutionCombox,
+			&UIComboBox::OnValueChanged,
+			[this](int index) {
+				m_cachedImporter->m_cubemapConvolution = FishEngine::ToEnum<decltype(m_cachedImporter->m_cubemapConvolution)>(index);
+				this->SetDirty(true);
+			});
+	
 	connect(m_filterModeCombox,
 			&UIComboBox::OnValueChanged,
 			[this](int index) {
@@ -167,6 +177,8 @@ void TextureImporterInspector::Bind(std::shared_ptr<FishEditor::TextureImporter>
 		m_typeCombox->SetValue(index);
 		index = FishEngine::EnumToIndex(m_cachedImporter->m_textureShape);
 		m_shapeCombox->SetValue(index);
+		index = FishEngine::EnumToIndex(m_cachedImporter->m_cubemapConvolution);
+		m_convolutionCombox->SetValue(index);
 		index = FishEngine::EnumToIndex(m_cachedImporter->filterMode());
 		m_filterModeCombox->SetValue(index);
 		index = FishEngine::EnumToIndex(m_cachedImporter->wrapMode());
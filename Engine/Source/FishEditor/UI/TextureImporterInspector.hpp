@@ -50,6 +50,7 @@ private:
 	UIFloat			* m_heightEdit;
 	UIComboBox		* m_typeCombox;
 	UIComboBox		* m_shapeCombox;
+	UIComboBox		* m_convolutionCombox;
 	UIBool			* m_readWriteToggle;
 	UIBool			* m_mipmapToggle;
 	UIComboBox		* m_filterModeCombox;
@@ -30,6 +30,11 @@ UIGameObjectHeader::UIGameObjectHeader(QWidget *parent) :
 			this,
 			&UIGameObjectHeader::OnActiveCheckBoxChanged);
 	
+	connect(ui->staticCheckBox,
+			&QCheckBox::toggled,
+			this,
+			&UIGameObjectHeader::OnStaticCheckBoxChanged);
+	
 	connect(ui->nameEdit,
 			&QLineEdit::editingFinished,
 			this,
@@ -51,6 +56,7 @@ void UIGameObjectHeader::Bind(std::shared_ptr<FishEngine::GameObject> go)
 		//go->setTag();
 		go->m_tagIndex = m_tagIndex;
 		go->SetActive(m_isActive);
+		go->setIsStatic(m_isStatic);
 		m_changed = false;
 		return;
 	}
@@ -64,6 +70,15 @@ void UIGameObjectHeader::Bind(std::shared_ptr<FishEngine::GameObject> go)
 		ui->activeCheckBox->blockSignals(false);
 	}
 
+	if (m_isStatic != go->isStatic())
+	{
+		m_isStatic = go->isStatic();
+		LOG;
+		ui->staticCheckBox->blockSignals(true);
+		ui->staticCheckBox->setChecked(m_isStatic);
+		ui->staticCheckBox->blockSignals(false);
+	}
+
 	if (m_name != go->name())
 	{
 		m_name = go->name();
@@ -146,6 +161,13 @@ void UIGameObjectHeader::OnActiveCheckBoxChanged(bool active)
 	m_changed = true;
 }
 
+void UIGameObjectHeader::OnStaticCheckBoxChanged(bool isStatic)
+{
+	m_isStatic = isStatic;
+	LOG;
+	m_changed = true;
+}
+
 void UIGameObjectHeader::OnLayerChanged(int index)
 {
 	m_layerIndex = index;
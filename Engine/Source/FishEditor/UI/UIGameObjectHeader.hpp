@@ -26,6 +26,7 @@ private:
 
 	void OnNameChanged();
 	void OnActiveCheckBoxChanged(bool);
+	void OnStaticCheckBoxChanged(bool);
 	void OnLayerChanged(int);
 	void OnTagChanged(int);
 
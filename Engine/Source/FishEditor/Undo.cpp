@@ -0,0 +1,860 @@
+#include "Undo.hpp"
+#include "PropertyArchive.hpp"
+
+#include <FishEngine/Application.hpp>
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Component.hpp>
+#include <FishEngine/Component_gen.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Serialization/Archive.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace FishEditor
+{
+	bool	Undo::s_isProcessing = false;
+	Action	Undo::undoRedoPerformed;
+}
+
+namespace
+{
+	// entries closer in time than this that change the same properties are merged
+	constexpr double MergeInterval = 1.0;	// seconds
+
+	// Properties that describe the hierarchy rather than a value. They are changed through dedicated
+	// operations (SetParent, AddComponent, ...), never by writing the fields back.
+	bool IsStructural(std::string const & name)
+	{
+		return name == "m_gameObject" || name == "m_transform" || name == "m_components" ||
+			name == "m_parent" || name == "m_children";
+	}
+
+	double Now()
+	{
+		static const auto start = std::chrono::steady_clock::now();
+		auto elapse = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration_cast<std::chrono::duration<double>>(elapse).count();
+	}
+
+	void Apply(Object & object, PropertyValues const & changed, LocalObjects const * local = nullptr)
+	{
+		if (!ApplyProperties(object, changed, local))
+		{
+			LogError("Undo: can not restore " + object.ClassName() + " " + object.name());
+		}
+	}
+
+
+	// instance IDs of destroyed objects -> the objects recreated in their place (by undo)
+	std::unordered_map<int, std::pair<int, std::weak_ptr<Object>>> s_replacedBy;
+
+	// A weak reference that survives the object being destroyed and recreated by undo/redo.
+	struct ObjectHandle
+	{
+		ObjectHandle() = default;
+
+		ObjectHandle(ObjectPtr const & object)
+			: object(object), instanceID(object == nullptr ? 0 : object->GetInstanceID())
+		{
+		}
+
+		template<class T = Object>
+		std::shared_ptr<T> Resolve() const
+		{
+			if (instanceID == 0)
+				return nullptr;
+			int id = instanceID;
+			auto weak = object;
+			for (auto it = s_replacedBy.find(id); it != s_replacedBy.end(); it = s_replacedBy.find(id))
+			{
+				id = it->second.first;
+				weak = it->second.second;
+			}
+			return std::dynamic_pointer_cast<T>(weak.lock());
+		}
+
+		std::weak_ptr<Object>	object;
+		int						instanceID = 0;
+	};
+
+	void Replace(int instanceID, ObjectPtr const & object)
+	{
+		if (instanceID != 0 && object != nullptr)
+			s_replacedBy[instanceID] = { object->GetInstanceID(), object };
+	}
+
+
+	class Operation
+	{
+	public:
+		virtual ~Operation() = default;
+		virtual void Undo() = 0;
+		virtual void Redo() = 0;
+		virtual size_t memorySize() const = 0;
+
+		// Can a later operation be merged into this one? Only if it is about the same properties.
+		virtual bool CanMerge(Operation const & /*later*/) const { return false; }
+
+		// Merges a later operation into this one, see CanMerge.
+		virtual void Merge(Operation & /*later*/) {}
+
+		// Does undoing this operation change nothing?
+		virtual bool empty() const { return false; }
+	};
+
+
+	class PropertyDiff : public Operation
+	{
+	public:
+		PropertyDiff(ObjectPtr const & target, PropertyValues && oldValues, PropertyValues && newValues)
+			: m_target(target), m_oldValues(std::move(oldValues)), m_newValues(std::move(newValues))
+		{
+		}
+
+		virtual void Undo() override
+		{
+			auto target = m_target.Resolve();
+			if (target != nullptr)
+				Apply(*target, m_oldValues);
+		}
+
+		virtual void Redo() override
+		{
+			auto target = m_target.Resolve();
+			if (target != nullptr)
+				Apply(*target, m_newValues);
+		}
+
+		virtual size_t memorySize() const override
+		{
+			return sizeof(*this) + MemorySize(m_oldValues) + MemorySize(m_newValues);
+		}
+
+		virtual bool CanMerge(Operation const & later) const override
+		{
+			auto diff = dynamic_cast<PropertyDiff const *>(&later);
+			if (diff == nullptr || diff->m_target.instanceID != m_target.instanceID ||
+				diff->m_newValues.size() != m_newValues.size())
+				return false;
+			for (size_t i = 0; i < m_newValues.size(); ++i)
+			{
+				if (diff->m_newValues[i].name != m_newValues[i].name)
+					return false;
+			}
+			return true;
+		}
+
+		virtual void Merge(Operation & later) override
+		{
+			m_newValues = std::move(static_cast<PropertyDiff&>(later).m_newValues);
+		}
+
+		virtual bool empty() const override
+		{
+			return m_oldValues == m_newValues;
+		}
+
+	private:
+		ObjectHandle	m_target;
+		PropertyValues	m_oldValues;
+		PropertyValues	m_newValues;
+	};
+
+
+	class Reparent : public Operation
+	{
+	public:
+		Reparent(TransformPtr const & transform, TransformPtr const & oldParent, TransformPtr const & newParent, bool worldPositionStays)
+			: m_transform(transform), m_oldParent(oldParent), m_newParent(newParent), m_worldPositionStays(worldPositionStays)
+		{
+		}
+
+		virtual void Undo() override
+		{
+			SetParent(m_oldParent);
+		}
+
+		virtual void Redo() override
+		{
+			SetParent(m_newParent);
+		}
+
+		virtual size_t memorySize() const override
+		{
+			return sizeof(*this);
+		}
+
+	private:
+		void SetParent(ObjectHandle const & parent)
+		{
+			auto t = m_transform.Resolve<Transform>();
+			if (t != nullptr)
+				t->SetParent(parent.Resolve<Transform>(), m_worldPositionStays);
+		}
+
+		ObjectHandle	m_transform;
+		ObjectHandle	m_oldParent;
+		ObjectHandle	m_newParent;
+		bool			m_worldPositionStays;
+	};
+
+
+	/*
+	 * A GameObject with its components and children, serialized while it does not exist.
+	 * layout, GameObjects in preorder:
+	 *     int32 parent (index of the GameObject record, -1 for the root)
+	 *     object: GameObject, Transform
+	 *     uint16 component count, for each: string class name, object
+	 * object: int32 instanceID, uint16 property count, for each:
+	 *     uint16 name (index in m_names), string data, uint16 reference count, uint32 indices in m_references
+	 */
+	class Subtree
+	{
+	public:
+		void Capture(GameObjectPtr const & root)
+		{
+			Clear();
+			m_parent = ObjectHandle(root->transform()->parent());
+			m_root = ObjectHandle(root);
+
+			// ordinals: per GameObject in preorder, the GameObject, its Transform and its components
+			std::vector<GameObjectPtr> gameObjects;
+			LocalOrdinals ordinals;
+			std::deque<GameObjectPtr> stack = { root };
+			while (!stack.empty())
+			{
+				auto go = stack.front();
+				stack.pop_front();
+				gameObjects.push_back(go);
+				ordinals.emplace(go->GetInstanceID(), static_cast<int>(ordinals.size()));
+				ordinals.emplace(go->transform()->GetInstanceID(), static_cast<int>(ordinals.size()));
+				for (auto const & c : go->Components())
+					ordinals.emplace(c->GetInstanceID(), static_cast<int>(ordinals.size()));
+				auto const & children = go->transform()->children();
+				// children first, in order (preorder)
+				for (auto it = children.rbegin(); it != children.rend(); ++it)
+					stack.push_front((*it)->gameObject());
+			}
+
+			std::unordered_map<int, int> records;	// GameObject instanceID -> index of its record
+			for (auto const & go : gameObjects)
+			{
+				auto parent = go->transform()->parent();
+				int parentRecord = -1;
+				if (go != root)
+					parentRecord = records[parent->gameObject()->GetInstanceID()];
+				int record = static_cast<int>(records.size());
+				records[go->GetInstanceID()] = record;
+				Write<int32_t>(parentRecord);
+				WriteObject(*go, ordinals);
+				WriteObject(*go->transform(), ordinals);
+
+				auto const & components = go->Components();	// without the transform
+				Write(static_cast<uint16_t>(components.size()));
+				for (auto const & c : components)
+				{
+					WriteString(c->ClassName());
+					WriteObject(*c, ordinals);
+				}
+			}
+		}
+
+		// Recreates the GameObjects, returns the root.
+		GameObjectPtr Restore()
+		{
+			m_cursor = 0;
+			LocalObjects objects;
+			std::vector<GameObjectPtr> gameObjects;
+			std::vector<std::pair<ObjectPtr, PropertyValues>> values;
+			auto rootParent = m_parent.Resolve<Transform>();
+
+			while (m_cursor < m_data.size())
+			{
+				auto parentRecord = Read<int32_t>();
+				auto go = Scene::CreateGameObject("");
+				auto parent = parentRecord < 0 ? rootParent : gameObjects[parentRecord]->transform();
+				go->transform()->SetParent(parent, false);
+				gameObjects.push_back(go);
+				ReadObject(go, objects, values);
+				ReadObject(go->transform(), objects, values);
+
+				auto componentCount = Read<uint16_t>();
+				for (uint16_t i = 0; i < componentCount; ++i)
+				{
+					auto className = ReadString();
+					auto c = AddComponentToGameObject(className, go);
+					if (c == nullptr)
+						LogWarning("Undo: can not recreate " + className);
+					ReadObject(c, objects, values);
+				}
+			}
+
+			// after everything exists, so that references inside the subtree resolve
+			for (auto const & v : values)
+			{
+				if (v.first != nullptr)
+					Apply(*v.first, v.second, &objects);
+			}
+			return gameObjects.empty() ? nullptr : gameObjects.front();
+		}
+
+		void Clear()
+		{
+			m_data.clear();
+			m_data.shrink_to_fit();
+			m_names.clear();
+			m_references.clear();
+		}
+
+		ObjectHandle const & root() const { return m_root; }
+
+		size_t memorySize() const
+		{
+			size_t size = sizeof(*this) + m_data.size() + m_references.size() * sizeof(ObjectPtr);
+			for (auto const & n : m_names)
+				size += sizeof(n) + n.size();
+			return size;
+		}
+
+	private:
+		template<typename T>
+		void Write(T const & value)
+		{
+			m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		void WriteString(std::string const & s)
+		{
+			Write(static_cast<uint32_t>(s.size()));
+			m_data.append(s);
+		}
+
+		void WriteObject(Object const & object, LocalOrdinals const & ordinals)
+		{
+			Write(static_cast<int32_t>(object.GetInstanceID()));
+			auto values = CaptureProperties(object, &ordinals);
+			uint16_t count = 0;
+			for (auto const & v : values)
+			{
+				if (!IsStructural(v.name))
+					count++;
+			}
+			Write(count);
+			for (auto const & v : values)
+			{
+				if (IsStructural(v.name))
+					continue;
+				Write(NameIndex(v.name));
+				WriteString(v.data);
+				Write(static_cast<uint16_t>(v.references.size()));
+				for (auto const & r : v.references)
+				{
+					Write(static_cast<uint32_t>(m_references.size()));
+					m_references.push_back(r);
+				}
+			}
+		}
+
+		template<typename T>
+		T Read()
+		{
+			T value;
+			std::memcpy(&value, m_data.data() + m_cursor, sizeof(T));
+			m_cursor += sizeof(T);
+			return value;
+		}
+
+		std::string ReadString()
+		{
+			auto size = Read<uint32_t>();
+			auto s = m_data.substr(m_cursor, size);
+			m_cursor += size;
+			return s;
+		}
+
+		void ReadObject(ObjectPtr const & object, LocalObjects & objects, std::vector<std::pair<ObjectPtr, PropertyValues>> & values)
+		{
+			auto instanceID = Read<int32_t>();
+			Replace(instanceID, object);
+			objects.push_back(object);
+
+			PropertyValues properties(Read<uint16_t>());
+			for (auto & p : properties)
+			{
+				p.name = m_names[Read<uint16_t>()];
+				p.data = ReadString();
+				p.references.resize(Read<uint16_t>());
+				for (auto & r : p.references)
+					r = m_references[Read<uint32_t>()];
+			}
+			values.emplace_back(object, std::move(properties));
+		}
+
+		uint16_t NameIndex(std::string const & name)
+		{
+			for (size_t i = 0; i < m_names.size(); ++i)
+			{
+				if (m_names[i] == name)
+					return static_cast<uint16_t>(i);
+			}
+			m_names.push_back(name);
+			return static_cast<uint16_t>(m_names.size() - 1);
+		}
+
+		ObjectHandle				m_parent;
+		ObjectHandle				m_root;
+		std::string					m_data;
+		std::vector<std::string>	m_names;
+		std::vector<ObjectPtr>		m_references;	// objects outside of the subtree (assets, mostly)
+		size_t						m_cursor = 0;
+	};
+
+
+	// Creation or destruction of a GameObject subtree; undo and redo both flip its existence.
+	class GameObjectLifetime : public Operation
+	{
+	public:
+		// alive: the GameObject exists now (it was created), otherwise it was captured and destroyed
+		GameObjectLifetime(GameObjectPtr const & root, bool alive)
+			: m_root(root), m_alive(alive)
+		{
+			if (!alive)
+				Destroy();
+		}
+
+		virtual void Undo() override { Toggle(); }
+		virtual void Redo() override { Toggle(); }
+
+		virtual size_t memorySize() const override
+		{
+			return sizeof(*this) + m_subtree.memorySize();
+		}
+
+	private:
+		void Toggle()
+		{
+			if (m_alive)
+			{
+				Destroy();
+			}
+			else
+			{
+				auto root = m_subtree.Restore();
+				m_subtree.Clear();
+				m_root = ObjectHandle(root);
+				m_alive = true;
+			}
+		}
+
+		void Destroy()
+		{
+			auto root = m_root.Resolve<GameObject>();
+			if (root == nullptr)
+				return;
+			m_subtree.Capture(root);
+			Object::DestroyImmediate(root);
+			m_alive = false;
+		}
+
+		ObjectHandle	m_root;
+		Subtree			m_subtree;
+		bool			m_alive;
+	};
+
+
+	// Creation or destruction of a component.
+	class ComponentLifetime : public Operation
+	{
+	public:
+		ComponentLifetime(ComponentPtr const & component, bool alive)
+			: m_component(component), m_gameObject(component->gameObject()), m_className(component->ClassName()), m_alive(alive)
+		{
+			if (!alive)
+				Destroy();
+		}
+
+		virtual void Undo() override { Toggle(); }
+		virtual void Redo() override { Toggle(); }
+
+		virtual size_t memorySize() const override
+		{
+			return sizeof(*this) + m_className.size() + MemorySize(m_values);
+		}
+
+	private:
+		void Toggle()
+		{
+			if (m_alive)
+			{
+				Destroy();
+				return;
+			}
+			auto go = m_gameObject.Resolve<GameObject>();
+			if (go == nullptr)
+				return;
+			auto c = AddComponentToGameObject(m_className, go);
+			if (c == nullptr)
+				return;
+			Replace(m_component.instanceID, c);
+			Apply(*c, m_values);
+			m_values.clear();
+			m_alive = true;
+		}
+
+		void Destroy()
+		{
+			auto c = m_component.Resolve<Component>();
+			if (c == nullptr)
+				return;
+			m_values.clear();
+			for (auto & v : CaptureProperties(*c))
+			{
+				if (!IsStructural(v.name))
+					m_values.push_back(std::move(v));
+			}
+			Object::DestroyImmediate(c);
+			m_alive = false;
+		}
+
+		ObjectHandle	m_component;
+		ObjectHandle	m_gameObject;
+		std::string		m_className;
+		PropertyValues	m_values;
+		bool			m_alive;
+	};
+
+
+	struct Entry
+	{
+		std::string								name;
+		std::vector<std::unique_ptr<Operation>>	operations;
+		double									time = 0;
+		size_t									memorySize = 0;
+
+		void UpdateMemorySize()
+		{
+			memorySize = sizeof(*this) + name.size();
+			for (auto const & op : operations)
+				memorySize += op->memorySize();
+		}
+	};
+
+	size_t				s_memoryBudget = 32 * 1024 * 1024;
+	size_t				s_memoryUsage = 0;	// of s_entries
+
+	// the history: [0, s_current) can be undone, [s_current, size) can be redone
+	std::deque<Entry>	s_entries;
+	size_t				s_current = 0;
+
+	// the group being recorded
+	Entry												s_group;
+	std::vector<std::pair<ObjectHandle, PropertyValues>>	s_recorded;	// snapshots taken by RecordObject
+	std::unordered_set<int>								s_recordedIDs;
+
+	bool IsRecording()
+	{
+		return !Undo::isProcessing() && !Application::isPlaying();
+	}
+
+	// Turns the snapshots of the group into PropertyDiffs.
+	void CommitRecordedObjects()
+	{
+		for (auto & r : s_recorded)
+		{
+			auto object = r.first.Resolve();
+			if (object == nullptr)
+				continue;
+			auto current = CaptureProperties(*object);
+			PropertyValues oldValues, newValues;
+			auto & snapshot = r.second;
+			for (size_t i = 0; i < current.size() && i < snapshot.size(); ++i)
+			{
+				if (IsStructural(current[i].name) || current[i] == snapshot[i])
+					continue;
+				oldValues.push_back(std::move(snapshot[i]));
+				newValues.push_back(std::move(current[i]));
+			}
+			if (!newValues.empty())
+				s_group.operations.push_back(std::make_unique<PropertyDiff>(object, std::move(oldValues), std::move(newValues)));
+		}
+		s_recorded.clear();
+		s_recordedIDs.clear();
+	}
+
+	void SetGroupName(std::string const & name)
+	{
+		if (s_group.name.empty())
+			s_group.name = name;
+	}
+
+	void AddOperation(std::unique_ptr<Operation> && op, std::string const & name)
+	{
+		SetGroupName(name);
+		s_group.operations.push_back(std::move(op));
+	}
+
+	void EraseEntries(size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; ++i)
+			s_memoryUsage -= s_entries[i].memorySize;
+		s_entries.erase(s_entries.begin() + first, s_entries.begin() + last);
+	}
+
+	// Merges the group into the last entry if both change the same properties of the same objects.
+	bool MergeIntoLastEntry(Entry & group)
+	{
+		if (s_current == 0 || s_current != s_entries.size())
+			return false;
+		auto & last = s_entries.back();
+		if (last.name != group.name || group.time - last.time > MergeInterval ||
+			last.operations.size() != group.operations.size())
+			return false;
+		// check all first, Merge moves the values
+		for (size_t i = 0; i < group.operations.size(); ++i)
+		{
+			if (!last.operations[i]->CanMerge(*group.operations[i]))
+				return false;
+		}
+		for (size_t i = 0; i < group.operations.size(); ++i)
+			last.operations[i]->Merge(*group.operations[i]);
+		last.time = group.time;
+		s_memoryUsage -= last.memorySize;
+
+		bool empty = true;
+		for (auto const & op : last.operations)
+			empty = empty && op->empty();
+		if (empty)
+		{
+			// e.g. a value dragged back to where it started
+			s_entries.pop_back();
+			s_current--;
+		}
+		else
+		{
+			last.UpdateMemorySize();
+			s_memoryUsage += last.memorySize;
+		}
+		return true;
+	}
+
+	void EnforceMemoryBudget()
+	{
+		// the oldest undo entries go first, then, everything undone, the redo entries furthest from the current state;
+		// one entry is always kept
+		while (s_memoryUsage > s_memoryBudget && s_entries.size() > 1)
+		{
+			if (s_current > 0)
+			{
+				EraseEntries(0, 1);
+				s_current--;
+			}
+			else
+			{
+				EraseEntries(s_entries.size() - 1, s_entries.size());
+			}
+		}
+	}
+}
+
+
+void FishEditor::Undo::RecordObject(ObjectPtr const & object, std::string const & name)
+{
+	if (object == nullptr || !IsRecording())
+		return;
+	if (!s_recordedIDs.insert(object->GetInstanceID()).second)
+		return;
+	SetGroupName(name);
+	s_recorded.emplace_back(ObjectHandle(object), CaptureProperties(*object));
+}
+
+
+void FishEditor::Undo::SetTransformParent(TransformPtr const & transform, TransformPtr const & newParent, std::string const & name, bool worldPositionStays)
+{
+	auto oldParent = transform->parent();
+	transform->SetParent(newParent, worldPositionStays);
+	if (!IsRecording() || transform->parent() == oldParent)	// SetParent refuses cycles
+		return;
+	CommitRecordedObjects();
+	AddOperation(std::make_unique<Reparent>(transform, oldParent, newParent, worldPositionStays), name);
+}
+
+
+void FishEditor::Undo::RegisterCreatedObjectUndo(GameObjectPtr const & gameObject, std::string const & name)
+{
+	if (!IsRecording())
+		return;
+	CommitRecordedObjects();
+	AddOperation(std::make_unique<GameObjectLifetime>(gameObject, true), name);
+}
+
+
+void FishEditor::Undo::RegisterCreatedObjectUndo(ComponentPtr const & component, std::string const & name)
+{
+	if (component == nullptr || !IsRecording())
+		return;
+	CommitRecordedObjects();
+	AddOperation(std::make_unique<ComponentLifetime>(component, true), name);
+}
+
+
+void FishEditor::Undo::DestroyObjectImmediate(GameObjectPtr const & gameObject)
+{
+	if (!IsRecording())
+	{
+		Object::DestroyImmediate(gameObject);
+		return;
+	}
+	CommitRecordedObjects();
+	AddOperation(std::make_unique<GameObjectLifetime>(gameObject, false), "Delete " + gameObject->name());
+}
+
+
+void FishEditor::Undo::DestroyObjectImmediate(ComponentPtr const & component)
+{
+	if (!IsRecording())
+	{
+		Object::DestroyImmediate(component);
+		return;
+	}
+	CommitRecordedObjects();
+	AddOperation(std::make_unique<ComponentLifetime>(component, false), "Remove " + component->ClassName());
+}
+
+
+void FishEditor::Undo::FlushGesture()
+{
+	CommitRecordedObjects();
+	if (s_group.operations.empty())
+	{
+		s_group.name.clear();
+		return;
+	}
+
+	Entry group = std::move(s_group);
+	s_group = Entry();
+	group.time = Now();
+	if (MergeIntoLastEntry(group))
+		return;
+
+	EraseEntries(s_current, s_entries.size());
+	group.UpdateMemorySize();
+	s_memoryUsage += group.memorySize;
+	s_entries.push_back(std::move(group));
+	s_current = s_entries.size();
+	EnforceMemoryBudget();
+}
+
+
+bool FishEditor::Undo::canUndo()
+{
+	return s_current > 0 || !s_group.operations.empty() || !s_recorded.empty();
+}
+
+
+bool FishEditor::Undo::canRedo()
+{
+	return s_current < s_entries.size();
+}
+
+
+void FishEditor::Undo::PerformUndo()
+{
+	FlushGesture();
+	if (s_current == 0)
+	{
+		LogWarning("no more command to undo");
+		return;
+	}
+	s_current--;
+	auto & entry = s_entries[s_current];
+	s_isProcessing = true;
+	for (auto it = entry.operations.rbegin(); it != entry.operations.rend(); ++it)
+		(*it)->Undo();
+	s_isProcessing = false;
+
+	// the size of the operations that keep destroyed objects changed
+	s_memoryUsage -= entry.memorySize;
+	entry.UpdateMemorySize();
+	s_memoryUsage += entry.memorySize;
+	undoRedoPerformed();
+}
+
+
+void FishEditor::Undo::PerformRedo()
+{
+	FlushGesture();
+	if (s_current == s_entries.size())
+	{
+		LogWarning("no more command to redo");
+		return;
+	}
+	auto & entry = s_entries[s_current];
+	s_current++;
+	s_isProcessing = true;
+	for (auto & op : entry.operations)
+		op->Redo();
+	s_isProcessing = false;
+
+	s_memoryUsage -= entry.memorySize;
+	entry.UpdateMemorySize();
+	s_memoryUsage += entry.memorySize;
+	undoRedoPerformed();
+}
+
+
+void FishEditor::Undo::ClearAll()
+{
+	s_entries.clear();
+	s_current = 0;
+	s_group = Entry();
+	s_recorded.clear();
+	s_recordedIDs.clear();
+	s_replacedBy.clear();
+	s_memoryUsage = 0;
+}
+
+
+size_t FishEditor::Undo::memoryBudget()
+{
+	return s_memoryBudget;
+}
+
+
+size_t FishEditor::Undo::memoryUsage()
+{
+	return s_memoryUsage;
+}
+
+
+void FishEditor::Undo::setMemoryBudget(size_t bytes)
+{
+	s_memoryBudget = bytes;
+	EnforceMemoryBudget();
+}
+
+
+size_t FishEditor::Undo::entryCount()
+{
+	return s_entries.size();
+}
+
+
+void FishEditor::Undo::LogHistory()
+{
+	LogInfo(Format("Undo history: %1% entries, %2% bytes (budget %3%)", s_entries.size(), s_memoryUsage, s_memoryBudget));
+	for (size_t i = 0; i < s_entries.size(); ++i)
+	{
+		auto const & e = s_entries[i];
+		LogInfo(Format("%1%%2%: %3% operations, %4% bytes", (i < s_current ? "  " : "* "), e.name, e.operations.size(), e.memorySize));
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef Undo_hpp
+#define Undo_hpp
+
+#include "FishEditor.hpp"
+#include <FishEngine/ReflectClass.hpp>
+
+namespace FishEditor
+{
+	// Undo/redo of the changes made in the editor.
+	//
+	// Objects are recorded with RecordObject before they are modified. When the current group is flushed,
+	// each recorded object is compared with its snapshot property by property (through its Serialize function),
+	// and only the properties that changed are kept, in a compact binary form.
+	// A group collects everything done during one user gesture (e.g. a gizmo drag from mouse down to mouse up).
+	// Groups that change the same properties of the same objects in quick succession (spin box steps, wheel
+	// scrolling, typing) are merged into one entry.
+	//
+	// Deleted GameObjects are serialized with their components and children, and recreated on undo.
+	// The history is bounded by memory, not by a number of entries.
+	class Meta(NonSerializable) Undo
+	{
+	public:
+		Undo() = delete;
+
+		// Records the state of the object before it is changed.
+		// Does nothing if the object is already recorded in the current group.
+		static void RecordObject(FishEngine::ObjectPtr const & object, std::string const & name);
+
+		// Sets the parent of the transform and records it.
+		static void SetTransformParent(
+			FishEngine::TransformPtr const & transform,
+			FishEngine::TransformPtr const & newParent,
+			std::string const & name,
+			bool worldPositionStays = true);
+
+		// Records a GameObject (with its children) or component that has just been created; undo destroys it.
+		static void RegisterCreatedObjectUndo(FishEngine::GameObjectPtr const & gameObject, std::string const & name);
+		static void RegisterCreatedObjectUndo(FishEngine::ComponentPtr const & component, std::string const & name);
+
+		// Destroys the GameObject (with its children) or component and records it; undo recreates it.
+		static void DestroyObjectImmediate(FishEngine::GameObjectPtr const & gameObject);
+		static void DestroyObjectImmediate(FishEngine::ComponentPtr const & component);
+
+		// Ends the current group. Call it when a user gesture is over.
+		static void FlushGesture();
+
+		static bool canUndo();
+		static bool canRedo();
+		static void PerformUndo();
+		static void PerformRedo();
+
+		// Is an undo or redo being performed? Changes made meanwhile are not recorded.
+		static bool isProcessing() { return s_isProcessing; }
+
+		static void ClearAll();
+
+		// When the history takes more memory than this, the oldest entries are dropped (the furthest redo entries when
+		// everything was undone).
+		static size_t memoryBudget();
+		static void setMemoryBudget(size_t bytes);
+
+		// Memory taken by the history, in bytes.
+		static size_t memoryUsage();
+
+		// Number of entries in the history, including the ones that can be redone.
+		static size_t entryCount();
+
+		// Logs the name and size of every entry in the history.
+		static void LogHistory();
+
+		// Called after an undo or redo was performed.
+		static Action undoRedoPerformed;
+
+	private:
+		static bool s_isProcessing;
+	};
+}
+
+#endif // Undo_hpp
@@ -67,6 +67,7 @@ namespace FishEditor
 	{
 		//archive.BeginClass();
 		FishEditor::AssetImporter::Serialize(archive);
+		archive << FishEngine::make_nvp("m_cubemapConvolution", m_cubemapConvolution); // FishEditor::TextureImporterCubemapConvolution
 		//archive.EndClass();
 	}
 
@@ -74,6 +75,7 @@ namespace FishEditor
 	{
 		//archive.BeginClass(2);
 		FishEditor::AssetImporter::Deserialize(archive);
+		archive >> FishEngine::make_nvp("m_cubemapConvolution", m_cubemapConvolution); // FishEditor::TextureImporterCubemapConvolution
 		//archive.EndClass();
 	}
 
@@ -225,6 +227,7 @@ namespace FishEditor
 		archive << FishEngine::make_nvp("m_importNormals", m_importNormals); // FishEditor::ModelImporterNormals
 		archive << FishEngine::make_nvp("m_importTangents", m_importTangents); // FishEditor::ModelImporterTangents
 		archive << FishEngine::make_nvp("m_materialSearch", m_materialSearch); // FishEditor::ModelImporterMaterialSearch
+		archive << FishEngine::make_nvp("m_lodTargetRatios", m_lodTargetRatios); // std::vector<float>
 		//archive.EndClass();
 	}
 
@@ -236,6 +239,7 @@ namespace FishEditor
 		archive >> FishEngine::make_nvp("m_importNormals", m_importNormals); // FishEditor::ModelImporterNormals
 		archive >> FishEngine::make_nvp("m_importTangents", m_importTangents); // FishEditor::ModelImporterTangents
 		archive >> FishEngine::make_nvp("m_materialSearch", m_materialSearch); // FishEditor::ModelImporterMaterialSearch
+		archive >> FishEngine::make_nvp("m_lodTargetRatios", m_lodTargetRatios); // std::vector<float>
 		//archive.EndClass();
 	}
 
@@ -297,6 +301,7 @@ namespace FishEditor
 		archive << FishEngine::make_nvp("m_generateCubemap", m_generateCubemap); // FishEditor::TextureImporterGenerateCubemap
 		archive << FishEngine::make_nvp("m_textureType", m_textureType); // FishEditor::TextureImporterType
 		archive << FishEngine::make_nvp("m_textureShape", m_textureShape); // FishEditor::TextureImporterShape
+		archive << FishEngine::make_nvp("m_cubemapConvolution", m_cubemapConvolution); // FishEditor::TextureImporterCubemapConvolution
 		archive << FishEngine::make_nvp("m_textureSettings", m_textureSettings); // FishEditor::TextureSettings
 		archive << FishEngine::make_nvp("m_sRGBTexture", m_sRGBTexture); // bool
 		archive << FishEngine::make_nvp("m_isReadable", m_isReadable); // bool
@@ -322,6 +327,7 @@ namespace FishEditor
 		archive >> FishEngine::make_nvp("m_generateCubemap", m_generateCubemap); // FishEditor::TextureImporterGenerateCubemap
 		archive >> FishEngine::make_nvp("m_textureType", m_textureType); // FishEditor::TextureImporterType
 		archive >> FishEngine::make_nvp("m_textureShape", m_textureShape); // FishEditor::TextureImporterShape
+		archive >> FishEngine::make_nvp("m_cubemapConvolution", m_cubemapConvolution); // FishEditor::TextureImporterCubemapConvolution
 		archive >> FishEngine::make_nvp("m_textureSettings", m_textureSettings); // FishEditor::TextureSettings
 		archive >> FishEngine::make_nvp("m_sRGBTexture", m_sRGBTexture); // bool
 		archive >> FishEngine::make_nvp("m_isReadable", m_isReadable); // bool
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <FishEngine/ReflectEnum.hpp>
+#include "../TextureImporterProperties.hpp"
+
+namespace FishEngine
+{
+
+
+/**************************************************
+* FishEditor::TextureImporterCubemapConvolution
+**************************************************/
+
+// enum count
+template<>
+constexpr int EnumCount<FishEditor::TextureImporterCubemapConvolution>() { return 2; }
+
+// string array
+static const char* TextureImporterCubemapConvolutionStrings[] =
+{
+    "None",
+	"Specular"
+};
+
+// cstring array
+template<>
+inline constexpr const char** EnumToCStringArray<FishEditor::TextureImporterCubemapConvolution>()
+{
+    return TextureImporterCubemapConvolutionStrings;
+}
+
+// index to enum
+template<>
+inline FishEditor::TextureImporterCubemapConvolution ToEnum<FishEditor::TextureImporterCubemapConvolution>(const int index)
+{
+    switch (index) {
+    case 0: return FishEditor::TextureImporterCubemapConvolution::None; break;
+	case 1: return FishEditor::TextureImporterCubemapConvolution::Specular; break;
+	
+    default: abort(); break;
+    }
+}
+
+// enum to index
+template<>
+inline int EnumToIndex<FishEditor::TextureImporterCubemapConvolution>(FishEditor::TextureImporterCubemapConvolution e)
+{
+    switch (e) {
+    case FishEditor::TextureImporterCubemapConvolution::None: return 0; break;
+	case FishEditor::TextureImporterCubemapConvolution::Specular: return 1; break;
+	
+    default: abort(); break;
+    }
+}
+
+// string to enum
+template<>
+inline FishEditor::TextureImporterCubemapConvolution ToEnum<FishEditor::TextureImporterCubemapConvolution>(const std::string& s)
+{
+    if (s == "None") return FishEditor::TextureImporterCubemapConvolution::None;
+	if (s == "Specular") return FishEditor::TextureImporterCubemapConvolution::Specular;
+	
+    abort();
+}
+
+
+} // namespace FishEngine
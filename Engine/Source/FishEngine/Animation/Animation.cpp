@@ -34,12 +34,25 @@ void GetSkeleton(
 	}
 }
 
+TransformPtr GetBone(std::string const & path, std::map<std::string, TransformPtr> const & skeleton);
+
 void Animation::Start()
 {
 	if (m_clip == nullptr)
 		return;
 	auto t = transform();
 	GetSkeleton(t, "", m_skeleton, m_clip->m_avatar->m_boneToIndex);
+
+	// resolve the bones once here, Update may run on a worker thread
+	m_positionBones.clear();
+	for (auto & curve : m_clip->m_positionCurve)
+		m_positionBones.push_back(GetBone(curve.path, m_skeleton));
+	m_rotationBones.clear();
+	for (auto & curve : m_clip->m_rotationCurves)
+		m_rotationBones.push_back(GetBone(curve.path, m_skeleton));
+	m_scaleBones.clear();
+	for (auto & curve : m_clip->m_scaleCurves)
+		m_scaleBones.push_back(GetBone(curve.path, m_skeleton));
 }
 
 TransformPtr GetBone(std::string const & path, std::map<std::string, TransformPtr> const & skeleton)
@@ -59,21 +72,21 @@ void Animation::Update()
 	if (m_clip == nullptr)
 		return;
 	m_localTimer += Time::deltaTime();
-	for (auto & curve : m_clip->m_positionCurve)
+	for (size_t i = 0; i < m_positionBones.size(); ++i)
 	{
-		auto t = GetBone(curve.path, m_skeleton);
+		auto const & t = m_positionBones[i];
 		if (t != nullptr)
 		{
-			auto v = curve.curve.Evaluate(m_localTimer, true);
+			auto v = m_clip->m_positionCurve[i].curve.Evaluate(m_localTimer, true);
 			t->setLocalPosition(v);
 		}
 	}
-	for (auto & curve : m_clip->m_rotationCurves)
+	for (size_t i = 0; i < m_rotationBones.size(); ++i)
 	{
-		auto t = GetBone(curve.path, m_skeleton);
+		auto const & t = m_rotationBones[i];
 		if (t != nullptr)
 		{
-			auto v = curve.curve.Evaluate(m_localTimer, true);
+			auto v = m_clip->m_rotationCurves[i].curve.Evaluate(m_localTimer, true);
 			v.NormalizeSelf();
 			t->setLocalRotation(v);
 		}
@@ -85,12 +98,12 @@ void Animation::Update()
 //		assert(!(isnan(v.x) || isnan(v.y) || isnan(v.z)));
 //		t->setLocalRotation(Quaternion::Euler(RotationOrder::XYZ, v));
 //	}
-	for (auto & curve : m_clip->m_scaleCurves)
+	for (size_t i = 0; i < m_scaleBones.size(); ++i)
 	{
-		auto t = GetBone(curve.path, m_skeleton);
+		auto const & t = m_scaleBones[i];
 		if (t != nullptr)
 		{
-			auto v = curve.curve.Evaluate(m_localTimer, true);
+			auto v = m_clip->m_scaleCurves[i].curve.Evaluate(m_localTimer, true);
 			t->setLocalScale(v);
 		}
 	}
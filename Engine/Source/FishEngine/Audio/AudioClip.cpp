@@ -1,6 +1,8 @@
 #include <FishEngine/AudioClip.hpp>
 #include <FishEngine/Internal/FMODPlugin.hpp>
 
+#include <cstring>
+
 FishEngine::AudioClip::AudioClip()
 {
 
@@ -20,3 +22,48 @@ void FishEngine::AudioClip::Cleanup()
 		m_fmodSound = nullptr;
 	}
 }
+
+FishEngine::AudioClipPtr FishEngine::AudioClip::Create(std::string const & name, int lengthSamples, int channels, int frequency)
+{
+	FMOD_CREATESOUNDEXINFO info;
+	memset(&info, 0, sizeof(info));
+	info.cbsize = sizeof(info);
+	info.length = static_cast<unsigned int>(lengthSamples * channels * sizeof(float));
+	info.numchannels = channels;
+	info.defaultfrequency = frequency;
+	info.format = FMOD_SOUND_FORMAT_PCMFLOAT;
+
+	FMOD::Sound * sound = nullptr;
+	auto result = FMODPlugin::GetInstance().system()->createSound(nullptr, FMOD_OPENUSER | FMOD_CREATESAMPLE, &info, &sound);
+	CheckFMODError(result);
+
+	auto clip = MakeShared<AudioClip>();
+	clip->setName(name);
+	clip->m_frequency = frequency;
+	clip->m_channels = channels;
+	clip->m_samples = lengthSamples;
+	clip->m_length = static_cast<float>(lengthSamples) / frequency;
+	clip->m_loadState = AudioDataLoadState::Loaded;
+	clip->m_fmodSound = sound;
+	return clip;
+}
+
+bool FishEngine::AudioClip::SetData(float const * data, int sampleCount, int offsetSamples)
+{
+	if (m_fmodSound == nullptr || offsetSamples < 0 || sampleCount < 0
+		|| offsetSamples * m_channels + sampleCount > m_samples * m_channels)
+		return false;
+	void * ptr1 = nullptr;
+	void * ptr2 = nullptr;
+	unsigned int length1 = 0;
+	unsigned int length2 = 0;
+	auto offset = static_cast<unsigned int>(offsetSamples * m_channels * sizeof(float));
+	auto length = static_cast<unsigned int>(sampleCount * sizeof(float));
+	if (m_fmodSound->lock(offset, length, &ptr1, &ptr2, &length1, &length2) != FMOD_OK)
+		return false;
+	memcpy(ptr1, data, length1);
+	if (ptr2 != nullptr)
+		memcpy(ptr2, reinterpret_cast<char const *>(data) + length1, length2);
+	m_fmodSound->unlock(ptr1, ptr2, length1, length2);
+	return true;
+}
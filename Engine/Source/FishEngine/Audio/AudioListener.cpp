@@ -1 +1,14 @@
-#include <FishEngine/AudioListener.hpp>
\ No newline at end of file
+#include <FishEngine/AudioListener.hpp>
+#include <FishEngine/AudioSystem.hpp>
+#include <FishEngine/Transform.hpp>
+
+FishEngine::AudioListener::~AudioListener()
+{
+	AudioSystem::UnregisterListener(this);
+}
+
+void FishEngine::AudioListener::Start()
+{
+	m_lastPosition = transform()->position();
+	AudioSystem::RegisterListener(this);
+}
@@ -4,15 +4,186 @@
 #include <FishEngine/Internal/FMODPlugin.hpp>
 #include <FishEngine/Transform.hpp>
 
+using namespace FishEngine;
+
+FishEngine::AudioSource::~AudioSource()
+{
+	if (m_channel != nullptr)
+	{
+		m_channel->stop();
+		m_channel = nullptr;
+	}
+	if (m_registered)
+	{
+		AudioSystem::UnregisterSource(this);
+	}
+}
+
+void FishEngine::AudioSource::setVolume(float value)
+{
+	m_volume = Mathf::Clamp01(value);
+	SetDirty();
+	ApplyChannelSettings();
+}
+
+void FishEngine::AudioSource::setPitch(float value)
+{
+	m_pitch = value;
+	SetDirty();
+	ApplyChannelSettings();
+}
+
+void FishEngine::AudioSource::setSpatialBlend(float value)
+{
+	m_spatialBlend = Mathf::Clamp01(value);
+	SetDirty();
+	ApplyChannelSettings();
+}
+
+void FishEngine::AudioSource::setPriority(int value)
+{
+	m_priority = Mathf::Clamp(value, 0, 256);
+	SetDirty();
+	ApplyChannelSettings();
+}
+
+void FishEngine::AudioSource::setMinDistance(float value)
+{
+	m_minDistance = value;
+	SetDirty();
+	ApplyChannelSettings();
+}
+
+void FishEngine::AudioSource::setMaxDistance(float value)
+{
+	m_maxDistance = value;
+	SetDirty();
+	ApplyChannelSettings();
+}
+
+bool FishEngine::AudioSource::isPlaying() const
+{
+	if (m_channel == nullptr)
+		return false;
+	bool playing = false;
+	// the handle is invalid once the channel has finished and been reused by FMOD
+	if (m_channel->isPlaying(&playing) != FMOD_OK)
+		return false;
+	return playing;
+}
+
+bool FishEngine::AudioSource::isVirtual() const
+{
+	if (m_channel == nullptr)
+		return false;
+	bool isVirtual = false;
+	if (m_channel->isVirtual(&isVirtual) != FMOD_OK)
+		return false;
+	return isVirtual || m_culled;
+}
+
+void FishEngine::AudioSource::Play(uint32_t delay /*= 0*/)
+{
+	if (m_clip == nullptr || m_clip->m_fmodSound == nullptr)
+	{
+		LogWarning("AudioSource::Play: no clip");
+		return;
+	}
+	Stop();
+	if (!m_registered)
+	{
+		AudioSystem::RegisterSource(this);
+	}
+
+	auto system = FMODPlugin::GetInstance().system();
+	auto result = system->playSound(m_clip->m_fmodSound, nullptr, true, &m_channel);
+	if (result != FMOD_OK)
+	{
+		m_channel = nullptr;
+		return;
+	}
+
+	m_channel->setMode((m_loop ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF) | FMOD_3D | FMOD_3D_WORLDRELATIVE | FMOD_3D_INVERSETAPEREDROLLOFF);
+	if (delay > 0)
+	{
+		// delay is in samples at 44.1kHz, as in Unity
+		unsigned long long dspclock = 0;
+		int rate = 0;
+		system->getSoftwareFormat(&rate, nullptr, nullptr);
+		m_channel->getDSPClock(nullptr, &dspclock);
+		m_channel->setDelay(dspclock + static_cast<unsigned long long>(delay) * rate / 44100, 0, false);
+	}
+
+	m_lastPosition = transform()->position();
+	FMOD_VECTOR pos = { m_lastPosition.x, m_lastPosition.y, m_lastPosition.z };
+	FMOD_VECTOR vel = { 0, 0, 0 };
+	m_channel->set3DAttributes(&pos, &vel);
+
+	// start culled sounds silent, AudioSystem::Update will bring them back when they become audible
+	auto audibility = AudioSystem::EstimateAudibility(m_lastPosition, AudioSystem::listenerPosition(), m_volume, m_minDistance, m_maxDistance);
+	m_culled = m_spatialBlend >= 1.0f && audibility < AudioSystem::audibilityThreshold();
+	ApplyChannelSettings();
+	m_channel->setPaused(false);
+}
+
+void FishEngine::AudioSource::PlayDelayed(float delay)
+{
+	Play(static_cast<uint32_t>(delay * 44100));
+}
+
+void FishEngine::AudioSource::Stop()
+{
+	if (m_channel != nullptr)
+	{
+		m_channel->stop();
+		m_channel = nullptr;
+	}
+	m_culled = false;
+}
+
+void FishEngine::AudioSource::Pause()
+{
+	if (m_channel != nullptr)
+		m_channel->setPaused(true);
+}
+
+void FishEngine::AudioSource::UnPause()
+{
+	if (m_channel != nullptr)
+		m_channel->setPaused(false);
+}
+
+void FishEngine::AudioSource::PlayOneShot(AudioClipPtr clip, float volumeScale /*= 1.0f*/)
+{
+	AudioSystem::PlayOneShotAtPoint(clip, transform()->position(), m_volume * volumeScale);
+}
+
 void FishEngine::AudioSource::PlayClipAtPoint(AudioClipPtr clip, Vector3 const & position, float volume /*= 1.0f*/)
 {
-	FMODPlugin::GetInstance().system()->playSound(clip->m_fmodSound, 0, false, nullptr);
+	AudioSystem::PlayOneShotAtPoint(clip, position, volume);
+}
+
+void FishEngine::AudioSource::ApplyChannelSettings()
+{
+	if (m_channel == nullptr)
+		return;
+	m_channel->setVolume(m_culled ? 0.0f : m_volume);
+	m_channel->setMute(m_mute);
+	m_channel->setPitch(m_pitch);
+	m_channel->setPriority(m_priority);
+	m_channel->set3DLevel(m_spatialBlend);
+	m_channel->set3DMinMaxDistance(m_minDistance, m_maxDistance);
+	m_channel->set3DDopplerLevel(m_dopplerLevel);
 }
 
 void FishEngine::AudioSource::Start()
 {
-	if (m_playOnAwake)
+	if (!m_registered)
+	{
+		AudioSystem::RegisterSource(this);
+	}
+	if (m_playOnAwake && m_clip != nullptr)
 	{
-		PlayClipAtPoint(m_clip, transform()->position(), m_volume);
+		Play();
 	}
 }
@@ -1,12 +1,308 @@
 #include <FishEngine/AudioSystem.hpp>
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/AudioListener.hpp>
+#include <FishEngine/AudioClip.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Time.hpp>
 #include <FishEngine/Internal/FMODPlugin.hpp>
 
+#include <algorithm>
+
+using namespace FishEngine;
+
+int		AudioSystem::s_maxRealVoices		= 32;
+int		AudioSystem::s_maxVirtualVoices		= 1024;
+bool	AudioSystem::s_noSoundOutput		= false;
+float	AudioSystem::s_audibilityThreshold	= 0.001f;
+int		AudioSystem::s_culledSourceCount	= 0;
+
+namespace
+{
+	// PlayClipAtPoint voices have no AudioSource, they are tracked in a fixed-size pool instead.
+	struct OneShotVoice
+	{
+		FMOD::Channel*	channel		= nullptr;
+		Vector3			position;
+		float			volume		= 0;
+	};
+
+	constexpr int MaxOneShotVoices = 64;
+
+	// same defaults as AudioSource
+	constexpr float OneShotMinDistance = 1.0f;
+	constexpr float OneShotMaxDistance = 500.0f;
+
+	std::vector<AudioSource*>		s_sources;
+	std::vector<AudioListener*>		s_listeners;
+	std::vector<OneShotVoice>		s_oneShotVoices(MaxOneShotVoices);
+
+	inline FMOD_VECTOR ToFMOD(Vector3 const & v)
+	{
+		return FMOD_VECTOR{ v.x, v.y, v.z };
+	}
+
+	bool IsChannelPlaying(FMOD::Channel* channel)
+	{
+		if (channel == nullptr)
+			return false;
+		bool playing = false;
+		if (channel->isPlaying(&playing) != FMOD_OK)
+			return false;
+		return playing;
+	}
+
+	AudioListener* ActiveListener()
+	{
+		for (auto listener : s_listeners)
+		{
+			if (listener->enabled())
+				return listener;
+		}
+		return nullptr;
+	}
+}
+
+
+void FishEngine::AudioSystem::Init()
+{
+	// create the FMOD system with the current settings
+	FMODPlugin::GetInstance();
+}
+
+
 void FishEngine::AudioSystem::Update()
 {
+	const float dt = Time::deltaTime();
+	const float invDt = dt > 0 ? 1.0f / dt : 0.0f;
+	auto system = FMODPlugin::GetInstance().system();
+
+	auto listener = ActiveListener();
+	Vector3 listenerPos = Vector3::zero;
+	if (listener != nullptr)
+	{
+		auto const & t = listener->transform();
+		listenerPos = t->position();
+		auto vel = (listenerPos - listener->m_lastPosition) * invDt;
+		listener->m_lastPosition = listenerPos;
+		auto pos = ToFMOD(listenerPos);
+		auto fmodVel = ToFMOD(vel);
+		auto forward = ToFMOD(t->forward());
+		auto up = ToFMOD(t->up());
+		system->set3DListenerAttributes(0, &pos, &fmodVel, &forward, &up);
+
+		FMOD::ChannelGroup* master = nullptr;
+		if (system->getMasterChannelGroup(&master) == FMOD_OK)
+		{
+			master->setVolume(listener->m_volume);
+			master->setPaused(listener->m_pause);
+		}
+	}
+
+	// Push 3D attributes of all moving, audible sources in one pass before FMOD's update.
+	// Inaudible sources are muted so that FMOD virtualizes them, and are not updated at all.
+	s_culledSourceCount = 0;
+	for (auto source : s_sources)
+	{
+		if (source->m_channel == nullptr)
+			continue;
+		if (!IsChannelPlaying(source->m_channel))
+		{
+			source->m_channel = nullptr;
+			source->m_culled = false;
+			continue;
+		}
+
+		auto position = source->transform()->position();
+		bool culled = false;
+		if (source->m_spatialBlend >= 1.0f)
+		{
+			auto audibility = EstimateAudibility(position, listenerPos, source->m_volume, source->m_minDistance, source->m_maxDistance);
+			culled = audibility < s_audibilityThreshold;
+		}
+
+		if (culled)
+		{
+			s_culledSourceCount++;
+			if (!source->m_culled)
+			{
+				source->m_culled = true;
+				source->m_channel->setVolume(0);
+			}
+			continue;
+		}
+
+		bool wasCulled = source->m_culled;
+		if (wasCulled)
+		{
+			source->m_culled = false;
+			source->m_channel->setVolume(source->m_volume);
+		}
+
+		if (wasCulled || position != source->m_lastPosition)
+		{
+			// no velocity (doppler) for a source that teleported back into range
+			auto vel = wasCulled ? Vector3::zero : (position - source->m_lastPosition) * invDt;
+			source->m_lastPosition = position;
+			auto pos = ToFMOD(position);
+			auto fmodVel = ToFMOD(vel);
+			source->m_channel->set3DAttributes(&pos, &fmodVel);
+		}
+	}
+
+	for (auto & voice : s_oneShotVoices)
+	{
+		if (voice.channel != nullptr && !IsChannelPlaying(voice.channel))
+		{
+			voice.channel = nullptr;
+		}
+	}
+
 	FMODPlugin::GetInstance().Update();
 }
 
+
 void FishEngine::AudioSystem::Stop()
 {
+	for (auto source : s_sources)
+	{
+		source->Stop();
+	}
+	for (auto & voice : s_oneShotVoices)
+	{
+		voice.channel = nullptr;
+	}
 	FMODPlugin::GetInstance().Stop();
 }
+
+
+float FishEngine::AudioSystem::EstimateAudibility(Vector3 const & sourcePosition,
+												  Vector3 const & listenerPosition,
+												  float volume,
+												  float minDistance,
+												  float maxDistance)
+{
+	float distance = Vector3::Distance(sourcePosition, listenerPosition);
+	if (distance >= maxDistance)
+		return 0.0f;
+	if (distance <= minDistance)
+		return volume;
+	// the tapered curve never exceeds the inverse curve
+	return volume * minDistance / distance;
+}
+
+
+int FishEngine::AudioSystem::sourceCount()
+{
+	return static_cast<int>(s_sources.size());
+}
+
+
+int FishEngine::AudioSystem::oneShotVoiceCount()
+{
+	return static_cast<int>(std::count_if(s_oneShotVoices.begin(), s_oneShotVoices.end(), [](OneShotVoice const & voice) {
+		return IsChannelPlaying(voice.channel);
+	}));
+}
+
+
+void FishEngine::AudioSystem::RegisterSource(AudioSource * source)
+{
+	s_sources.push_back(source);
+	source->m_registered = true;
+}
+
+
+void FishEngine::AudioSystem::UnregisterSource(AudioSource * source)
+{
+	auto it = std::find(s_sources.begin(), s_sources.end(), source);
+	if (it != s_sources.end())
+	{
+		// order of sources does not matter
+		*it = s_sources.back();
+		s_sources.pop_back();
+	}
+	source->m_registered = false;
+}
+
+
+void FishEngine::AudioSystem::RegisterListener(AudioListener * listener)
+{
+	if (std::find(s_listeners.begin(), s_listeners.end(), listener) == s_listeners.end())
+	{
+		if (!s_listeners.empty())
+		{
+			LogWarning("There are more than one AudioListener in the scene.");
+		}
+		s_listeners.push_back(listener);
+	}
+}
+
+
+void FishEngine::AudioSystem::UnregisterListener(AudioListener * listener)
+{
+	s_listeners.erase(std::remove(s_listeners.begin(), s_listeners.end(), listener), s_listeners.end());
+}
+
+
+Vector3 FishEngine::AudioSystem::listenerPosition()
+{
+	auto listener = ActiveListener();
+	if (listener == nullptr)
+		return Vector3::zero;
+	return listener->transform()->position();
+}
+
+
+void FishEngine::AudioSystem::PlayOneShotAtPoint(AudioClipPtr const & clip, Vector3 const & position, float volume)
+{
+	if (clip == nullptr || clip->m_fmodSound == nullptr)
+		return;
+
+	auto listenerPos = listenerPosition();
+	auto audibility = EstimateAudibility(position, listenerPos, volume, OneShotMinDistance, OneShotMaxDistance);
+
+	// do not even start a one-shot nobody can hear
+	if (audibility < s_audibilityThreshold)
+		return;
+
+	// reuse a finished voice, or steal the quietest one if it is quieter than the new sound
+	OneShotVoice* slot = nullptr;
+	float quietest = audibility;
+	for (auto & voice : s_oneShotVoices)
+	{
+		if (!IsChannelPlaying(voice.channel))
+		{
+			slot = &voice;
+			break;
+		}
+		auto a = EstimateAudibility(voice.position, listenerPos, voice.volume, OneShotMinDistance, OneShotMaxDistance);
+		if (a < quietest)
+		{
+			quietest = a;
+			slot = &voice;
+		}
+	}
+	if (slot == nullptr)
+		return;
+	if (IsChannelPlaying(slot->channel))
+		slot->channel->stop();
+
+	FMOD::Channel* channel = nullptr;
+	auto system = FMODPlugin::GetInstance().system();
+	if (system->playSound(clip->m_fmodSound, nullptr, true, &channel) != FMOD_OK)
+	{
+		slot->channel = nullptr;
+		return;
+	}
+	channel->setMode(FMOD_LOOP_OFF | FMOD_3D | FMOD_3D_WORLDRELATIVE | FMOD_3D_INVERSETAPEREDROLLOFF);
+	channel->set3DMinMaxDistance(OneShotMinDistance, OneShotMaxDistance);
+	auto pos = ToFMOD(position);
+	FMOD_VECTOR vel = { 0, 0, 0 };
+	channel->set3DAttributes(&pos, &vel);
+	channel->setVolume(volume);
+	channel->setPaused(false);
+
+	slot->channel = channel;
+	slot->position = position;
+	slot->volume = volume;
+}
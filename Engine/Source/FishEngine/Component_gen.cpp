@@ -13,6 +13,9 @@
 #include <FishEngine/Rigidbody.hpp>
 #include <FishEngine/Light.hpp>
 #include <FishEngine/CameraController.hpp>
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/AudioListener.hpp>
+#include <FishEngine/Animation.hpp>
 
 FishEngine::ComponentPtr FishEngine::
 AddComponentToGameObject(
@@ -37,6 +40,9 @@ AddComponentToGameObject(
 		return light;
 	}
 	CASE(CameraController)
+	CASE(AudioSource)
+	CASE(AudioListener)
+	CASE(Animation)
 #undef CASE
 	//Debug::LogError("UNKNOWN component type name: %s", componentClassName.c_str());
 	LogError("UNKNOWN component type name: " + componentClassName);
@@ -51,6 +51,36 @@ namespace FishEngine
 		return go;
 	}
 
+	void GameObject::setName(const std::string& name)
+	{
+		if (m_name == name)
+			return;
+		m_name = name;
+		SetDirty();
+		Scene::NotifyHierarchyChanged(HierarchyChange::Renamed, this);
+	}
+
+	void GameObject::SetActive(bool value)
+	{
+		if (m_activeSelf == value)
+			return;
+		m_activeSelf = value;
+		SetDirty();
+		Scene::NotifyHierarchyChanged(HierarchyChange::ActiveChanged, this);
+	}
+
+	void GameObject::setLayer(int layer)
+	{
+		if (m_layer == layer)
+			return;
+		m_layer = layer;
+		SetDirty();
+		for (auto & collider : GetComponents<Collider>())
+		{
+			collider->UpdateFilterData();
+		}
+	}
+
 	std::string const & GameObject::tag() const
 	{
 		return TagManager::IndexToTag(m_tagIndex);
@@ -89,10 +119,8 @@ namespace FishEngine
 		return Scene::Find(name);
 	}
 
-	void GameObject::Update()
+	void GameObject::StartComponents()
 	{
-		m_transform->Update();
-
 		for (auto& c : m_components)
 		{
 			if (!c->m_isStartFunctionCalled)
@@ -107,7 +135,6 @@ namespace FishEngine
 				c->Start();
 				c->m_isStartFunctionCalled = true;
 			}
-			c->Update();
 		}
 	}
 
@@ -173,6 +200,7 @@ namespace FishEngine
 			destGameObject->AddComponent(clonedComponent);
 		}
 		destGameObject->m_activeSelf = this->m_activeSelf; // bool
+		destGameObject->m_isStatic = this->m_isStatic; // bool
 		destGameObject->m_layer = this->m_layer; // int
 		destGameObject->m_tagIndex = this->m_tagIndex; // int
 		//cloneUtility.Clone(this->m_transform, ptr->m_transform); // TransformPtr
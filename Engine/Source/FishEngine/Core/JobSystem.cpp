@@ -0,0 +1,141 @@
+#include <FishEngine/JobSystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace FishEngine;
+
+namespace
+{
+	thread_local bool t_insideJob = false;
+
+	class WorkerPool
+	{
+	public:
+		WorkerPool()
+		{
+			int n = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+			n = std::max(n, 0);
+			for (int i = 0; i < n; ++i)
+			{
+				m_threads.emplace_back([this]() { WorkerLoop(); });
+			}
+		}
+
+		~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_quit = true;
+			}
+			m_wakeup.notify_all();
+			for (auto & t : m_threads)
+				t.join();
+		}
+
+		int threadCount() const
+		{
+			return static_cast<int>(m_threads.size()) + 1;
+		}
+
+		void Run(size_t count, size_t grainSize, std::function<void(size_t, size_t)> const & func)
+		{
+			// one loop at a time
+			std::lock_guard<std::mutex> runLock(m_runMutex);
+			m_func = &func;
+			m_count = count;
+			m_grainSize = grainSize;
+			m_next = 0;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_busyWorkers = static_cast<int>(m_threads.size());
+				++m_generation;
+			}
+			m_wakeup.notify_all();
+
+			Work();
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+			m_func = nullptr;
+		}
+
+	private:
+		void Work()
+		{
+			t_insideJob = true;
+			while (true)
+			{
+				size_t begin = m_next.fetch_add(m_grainSize);
+				if (begin >= m_count)
+					break;
+				(*m_func)(begin, std::min(begin + m_grainSize, m_count));
+			}
+			t_insideJob = false;
+		}
+
+		void WorkerLoop()
+		{
+			uint64_t seenGeneration = 0;
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_wakeup.wait(lock, [&]() { return m_quit || m_generation != seenGeneration; });
+					if (m_quit)
+						return;
+					seenGeneration = m_generation;
+				}
+				Work();
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (--m_busyWorkers == 0)
+						m_done.notify_one();
+				}
+			}
+		}
+
+		std::vector<std::thread>	m_threads;
+		std::mutex					m_runMutex;
+		std::mutex					m_mutex;
+		std::condition_variable		m_wakeup;
+		std::condition_variable		m_done;
+		uint64_t					m_generation = 0;
+		int							m_busyWorkers = 0;
+		bool						m_quit = false;
+
+		std::function<void(size_t, size_t)> const * m_func = nullptr;
+		size_t						m_count = 0;
+		size_t						m_grainSize = 1;
+		std::atomic<size_t>			m_next{ 0 };
+	};
+
+	WorkerPool & Pool()
+	{
+		static WorkerPool pool;
+		return pool;
+	}
+}
+
+
+int FishEngine::JobSystem::threadCount()
+{
+	return Pool().threadCount();
+}
+
+
+void FishEngine::JobSystem::ParallelFor(size_t count, size_t grainSize, std::function<void(size_t begin, size_t end)> const & func)
+{
+	if (count == 0)
+		return;
+	grainSize = std::max<size_t>(grainSize, 1);
+	if (t_insideJob || count <= grainSize || Pool().threadCount() == 1)
+	{
+		func(0, count);
+		return;
+	}
+	Pool().Run(count, grainSize, func);
+}
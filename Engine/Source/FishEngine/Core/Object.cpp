@@ -14,6 +14,7 @@ static std::multimap<int, ObjectPtr> s_classIDToObjects;
 namespace FishEngine
 {
 	std::multimap<int, ObjectPtr> Object::s_classIDToObjects;
+	std::atomic<uint64_t> Object::s_totalDirtyCount{ 0 };
 
 	GameObjectPtr Object::Instantiate(GameObjectPtr const & original)
 	{
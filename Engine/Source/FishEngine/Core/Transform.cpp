@@ -1,5 +1,6 @@
 #include <FishEngine/Transform.hpp>
 #include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
 #include <FishEngine/Debug.hpp>
 #include <FishEngine/Common.hpp>
 
@@ -221,11 +222,16 @@ namespace FishEngine
 			if (old_parent != nullptr)
 				mat = old_parent->localToWorldMatrix() * mat;
 			if (parent != nullptr)
-				mat = parent->worldToLocalMatrix() * localToWorldMatrix();
+				mat = parent->worldToLocalMatrix() * mat;
 			Matrix4x4::Decompose(mat, &m_localPosition, &m_localRotation, &m_localScale);
 		}
 		//UpdateMatrix();
 		MakeDirty();
+
+		// the Transform of a GameObject being destroyed has no GameObject any more
+		auto go = gameObject();
+		if (go != nullptr)
+			Scene::NotifyHierarchyChanged(HierarchyChange::Reparented, go.get());
 	}
 
 	//std::shared_ptr<Transform>
@@ -280,6 +286,7 @@ namespace FishEngine
 
 	void FishEngine::Transform::MakeDirty() const
 	{
+		SetDirty();
 		if (!m_isDirty)
 		{
 			for (auto& c : m_children)
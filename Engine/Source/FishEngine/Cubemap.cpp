@@ -15,6 +15,11 @@ void FishEngine::Cubemap::UploadToGPU()
 			format = GL_RGBA;
 			type = GL_HALF_FLOAT;
 			break;
+		case TextureFormat::RGBAFloat:
+			internal_format = GL_RGBA32F;
+			format = GL_RGBA;
+			type = GL_FLOAT;
+			break;
 		default:
 			abort();
 	}
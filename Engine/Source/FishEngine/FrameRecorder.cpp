@@ -0,0 +1,288 @@
+#include <FishEngine/FrameRecorder.hpp>
+#include <FishEngine/Input.hpp>
+#include <FishEngine/Time.hpp>
+#include <FishEngine/Random.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Debug.hpp>
+
+#include <fstream>
+#include <random>
+#include <cstring>
+
+namespace FishEngine
+{
+	FrameRecorder::Mode	FrameRecorder::s_mode = FrameRecorder::Mode::None;
+	int		FrameRecorder::s_frameIndex = 0;
+	int		FrameRecorder::s_firstDivergentFrame = -1;
+}
+
+using namespace FishEngine;
+
+namespace
+{
+	/*
+	 * log layout (little endian):
+	 *     header:  char[4] "FERC", uint32 version
+	 *     frame:   uint32 seed, float deltaTime, uint64 transformHash, uint32 eventCount, events
+	 *     event:   uint8 type, double timestamp, int16 code  (key and mouse button events)
+	 *              uint8 type, double timestamp, float x, float y  (mouse move / delta / scroll events)
+	 */
+	constexpr char		Magic[4] = { 'F', 'E', 'R', 'C' };
+	constexpr uint32_t	Version = 2;
+
+	struct RecordedFrame
+	{
+		uint32_t					seed = 0;
+		float						deltaTime = 0;
+		uint64_t					transformHash = 0;
+		std::vector<InputEvent>		events;
+	};
+
+	std::ofstream	s_output;
+	std::ifstream	s_input;
+	RecordedFrame	s_currentFrame;
+	std::mt19937	s_seedGenerator;
+
+	template<typename T>
+	void Write(std::ostream & os, T const & value)
+	{
+		os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	bool Read(std::istream & is, T & value)
+	{
+		is.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return is.good();
+	}
+
+	bool HasKeyCode(InputEventType type)
+	{
+		return type == InputEventType::KeyDown || type == InputEventType::KeyUp ||
+			type == InputEventType::MouseButtonDown || type == InputEventType::MouseButtonUp;
+	}
+
+	void WriteFrame(std::ostream & os, RecordedFrame const & frame)
+	{
+		Write(os, frame.seed);
+		Write(os, frame.deltaTime);
+		Write(os, frame.transformHash);
+		Write(os, static_cast<uint32_t>(frame.events.size()));
+		for (auto const & e : frame.events)
+		{
+			Write(os, static_cast<uint8_t>(e.type));
+			Write(os, e.timestamp);
+			if (HasKeyCode(e.type))
+			{
+				Write(os, static_cast<int16_t>(e.code));
+			}
+			else
+			{
+				Write(os, e.x);
+				Write(os, e.y);
+			}
+		}
+	}
+
+	bool ReadFrame(std::istream & is, RecordedFrame & frame)
+	{
+		uint32_t eventCount = 0;
+		if (!Read(is, frame.seed) || !Read(is, frame.deltaTime) ||
+			!Read(is, frame.transformHash) || !Read(is, eventCount))
+			return false;
+		// grown while reading: a truncated log must not allocate its count
+		frame.events.clear();
+		for (uint32_t i = 0; i < eventCount; ++i)
+		{
+			InputEvent e;
+			uint8_t type = 0;
+			if (!Read(is, type) || !Read(is, e.timestamp))
+				return false;
+			e.type = static_cast<InputEventType>(type);
+			e.code = 0;
+			e.x = e.y = 0;
+			if (HasKeyCode(e.type))
+			{
+				int16_t code = 0;
+				if (!Read(is, code))
+					return false;
+				e.code = code;
+			}
+			else if (!Read(is, e.x) || !Read(is, e.y))
+			{
+				return false;
+			}
+			frame.events.push_back(e);
+		}
+		return true;
+	}
+
+	bool ReadHeader(std::istream & is)
+	{
+		char magic[4];
+		uint32_t version = 0;
+		is.read(magic, 4);
+		if (!is.good() || std::memcmp(magic, Magic, 4) != 0 || !Read(is, version) || version != Version)
+			return false;
+		return true;
+	}
+
+	// FNV-1a
+	inline void HashBytes(uint64_t & hash, const void* data, size_t size)
+	{
+		auto p = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= p[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	void HashTransform(uint64_t & hash, TransformPtr const & t)
+	{
+		auto p = t->localPosition();
+		auto q = t->localRotation();
+		auto s = t->localScale();
+		float values[10] = { p.x, p.y, p.z, q.x, q.y, q.z, q.w, s.x, s.y, s.z };
+		HashBytes(hash, values, sizeof(values));
+		for (auto const & child : t->children())
+		{
+			HashTransform(hash, child);
+		}
+	}
+}
+
+
+bool FishEngine::FrameRecorder::StartRecording(std::string const & path)
+{
+	Stop();
+	s_output.open(path, std::ios::binary | std::ios::trunc);
+	if (!s_output.is_open())
+	{
+		LogError("FrameRecorder: can not open " + path);
+		return false;
+	}
+	s_output.write(Magic, 4);
+	Write(s_output, Version);
+	s_seedGenerator.seed(std::random_device{}());
+	s_mode = Mode::Recording;
+	s_frameIndex = 0;
+	s_firstDivergentFrame = -1;
+	return true;
+}
+
+
+bool FishEngine::FrameRecorder::StartReplay(std::string const & path)
+{
+	Stop();
+	s_input.open(path, std::ios::binary);
+	if (!s_input.is_open() || !ReadHeader(s_input))
+	{
+		LogError("FrameRecorder: invalid recording " + path);
+		s_input.close();
+		return false;
+	}
+	s_mode = Mode::Replaying;
+	s_frameIndex = 0;
+	s_firstDivergentFrame = -1;
+	return true;
+}
+
+
+void FishEngine::FrameRecorder::Stop()
+{
+	if (s_output.is_open())
+		s_output.close();
+	if (s_input.is_open())
+		s_input.close();
+	s_mode = Mode::None;
+}
+
+
+bool FishEngine::FrameRecorder::BeginFrame(float deltaTime)
+{
+	if (s_mode == Mode::Recording)
+	{
+		s_currentFrame.seed = s_seedGenerator();
+		s_currentFrame.deltaTime = deltaTime;
+		s_currentFrame.events = Input::frameEvents();
+		Random::InitState(s_currentFrame.seed);
+	}
+	else if (s_mode == Mode::Replaying)
+	{
+		if (!ReadFrame(s_input, s_currentFrame))
+		{
+			Stop();
+			return false;
+		}
+		deltaTime = s_currentFrame.deltaTime;
+		Random::InitState(s_currentFrame.seed);
+		for (auto const & e : s_currentFrame.events)
+		{
+			Input::PostEvent(e);
+		}
+	}
+
+	Time::m_deltaTime = deltaTime;
+	Time::m_time += deltaTime;
+	return true;
+}
+
+
+void FishEngine::FrameRecorder::EndFrame()
+{
+	if (s_mode == Mode::None)
+		return;
+
+	auto hash = HashTransforms();
+	if (s_mode == Mode::Recording)
+	{
+		s_currentFrame.transformHash = hash;
+		WriteFrame(s_output, s_currentFrame);
+	}
+	else if (hash != s_currentFrame.transformHash && s_firstDivergentFrame < 0)
+	{
+		s_firstDivergentFrame = s_frameIndex;
+		LogWarning(Format("FrameRecorder: replay diverged from the recording at frame %1%", s_frameIndex));
+	}
+	s_frameIndex++;
+}
+
+
+uint64_t FishEngine::FrameRecorder::HashTransforms()
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (auto const & go : Scene::GameObjects())
+	{
+		auto const & t = go->transform();
+		// children are hashed by their root
+		if (t->parent() == nullptr)
+			HashTransform(hash, t);
+	}
+	return hash;
+}
+
+
+int FishEngine::FrameRecorder::FindFirstDivergence(std::string const & path1, std::string const & path2)
+{
+	std::ifstream log1(path1, std::ios::binary);
+	std::ifstream log2(path2, std::ios::binary);
+	if (!ReadHeader(log1) || !ReadHeader(log2))
+	{
+		LogError("FrameRecorder: invalid recording");
+		return 0;
+	}
+
+	RecordedFrame frame1, frame2;
+	for (int frame = 0; ; ++frame)
+	{
+		bool ok1 = ReadFrame(log1, frame1);
+		bool ok2 = ReadFrame(log2, frame2);
+		if (!ok1 && !ok2)
+			return -1;
+		if (ok1 != ok2 || frame1.transformHash != frame2.transformHash)
+			return frame;
+	}
+}
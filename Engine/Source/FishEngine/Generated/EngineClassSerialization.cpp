@@ -1431,6 +1431,7 @@ namespace FishEngine
 		FishEngine::Object::Serialize(archive);
 		archive << FishEngine::make_nvp("m_components", m_components); // std::list<ComponentPtr>
 		archive << FishEngine::make_nvp("m_activeSelf", m_activeSelf); // bool
+		archive << FishEngine::make_nvp("m_isStatic", m_isStatic); // bool
 		archive << FishEngine::make_nvp("m_layer", m_layer); // int
 		archive << FishEngine::make_nvp("m_tagIndex", m_tagIndex); // int
 		archive << FishEngine::make_nvp("m_transform", m_transform); // TransformPtr
@@ -1443,6 +1444,7 @@ namespace FishEngine
 		FishEngine::Object::Deserialize(archive);
 		archive >> FishEngine::make_nvp("m_components", m_components); // std::list<ComponentPtr>
 		archive >> FishEngine::make_nvp("m_activeSelf", m_activeSelf); // bool
+		archive >> FishEngine::make_nvp("m_isStatic", m_isStatic); // bool
 		archive >> FishEngine::make_nvp("m_layer", m_layer); // int
 		archive >> FishEngine::make_nvp("m_tagIndex", m_tagIndex); // int
 		archive >> FishEngine::make_nvp("m_transform", m_transform); // TransformPtr
@@ -2,6 +2,7 @@
 #include <FishEngine/Shader.hpp>
 #include <FishEngine/Camera.hpp>
 #include <FishEngine/Mesh.hpp>
+#include <FishEngine/GeometryPool.hpp>
 #include <FishEngine/Pipeline.hpp>
 #include <FishEngine/Texture.hpp>
 #include <FishEngine/Transform.hpp>
@@ -217,7 +218,7 @@ DrawHalfWireSphere(
 		float* e = euler_angles + i*3;
 		m.SetTRS(center, Quaternion::Euler(Vector3(e)), Vector3::one * radius);
 		shader->BindUniformMat4("MATRIX_MVP", p * v * m * modelMatrix);
-		glBindVertexArray(s_circleMesh->m_VAO);
+		GeometryPool::BindVertexArray(s_circleMesh->m_VAO);
 		GLsizei count = static_cast<GLsizei>(s_circleMesh->m_positionBuffer.size()/3);
 		if (i == 1) {
 			glDrawArrays(GL_LINE_LOOP, 0, count);
@@ -226,7 +227,7 @@ DrawHalfWireSphere(
 			glDrawArrays(GL_LINE_STRIP, 0, count);
 		}
 		
-		glBindVertexArray(0);
+		GeometryPool::BindVertexArray(0);
 	}
 
 }
@@ -300,11 +301,11 @@ DrawHalfCircle(
 	//m.SetTRS(center, Quaternion::FromToRotation(Vector3::up, dir1), Vector3(radius, radius, radius));
 	shader->BindUniformMat4("MATRIX_MVP", p * v * m);
 	shader->BindUniformVec4("_Color", s_color);
-	glBindVertexArray(s_circleMesh->m_VAO);
+	GeometryPool::BindVertexArray(s_circleMesh->m_VAO);
 	GLsizei count = static_cast<GLsizei>(s_circleMesh->m_positionBuffer.size() / 3);
 	count = count / 2 + 1;
 	glDrawArrays(GL_LINE_STRIP, 0, count);
-	glBindVertexArray(0);
+	GeometryPool::BindVertexArray(0);
 }
 
 
@@ -0,0 +1,155 @@
+#include <FishEngine/ImpostorUtility.hpp>
+#include <FishEngine/Mathf.hpp>
+
+#include <algorithm>
+
+namespace FishEngine
+{
+	Vector2 ImpostorUtility::OctahedralEncode(Vector3 const & direction)
+	{
+		auto d = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+		if (d.y >= 0)
+			return Vector2(d.x, d.z);
+		return Vector2((1 - std::abs(d.z)) * Mathf::Sign(d.x), (1 - std::abs(d.x)) * Mathf::Sign(d.z));
+	}
+
+	Vector3 ImpostorUtility::OctahedralDecode(Vector2 const & p)
+	{
+		Vector3 d(p.x, 1 - std::abs(p.x) - std::abs(p.y), p.y);
+		if (d.y < 0)
+		{
+			d.x = (1 - std::abs(p.y)) * Mathf::Sign(p.x);
+			d.z = (1 - std::abs(p.x)) * Mathf::Sign(p.y);
+		}
+		return d.normalized();
+	}
+
+	Vector2 ImpostorUtility::HemiOctahedralEncode(Vector3 const & direction)
+	{
+		auto d = direction / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+		return Vector2(d.x + d.z, d.x - d.z);
+	}
+
+	Vector3 ImpostorUtility::HemiOctahedralDecode(Vector2 const & p)
+	{
+		float x = 0.5f * (p.x + p.y);
+		float z = 0.5f * (p.x - p.y);
+		return Vector3(x, 1 - std::abs(x) - std::abs(z), z).normalized();
+	}
+
+	Vector3 ImpostorUtility::FrameDirection(Layout const & layout, int x, int y)
+	{
+		const float scale = 2.0f / (layout.framesPerSide - 1);
+		Vector2 p(x * scale - 1, y * scale - 1);
+		return layout.hemisphere ? HemiOctahedralDecode(p) : OctahedralDecode(p);
+	}
+
+	void ImpostorUtility::FrameBasis(Vector3 const & direction, Vector3 & right, Vector3 & up)
+	{
+		// the camera looks at the center, along -direction; at the poles the up vector of the camera is +z
+		auto forward = -direction;
+		auto reference = std::abs(direction.y) > 0.999f ? Vector3::forward : Vector3::up;
+		right = Vector3::Normalize(Vector3::Cross(reference, forward));
+		up = Vector3::Cross(forward, right);
+	}
+
+	Matrix4x4 ImpostorUtility::FrameViewMatrix(Vector3 const & direction)
+	{
+		Vector3 right, up;
+		FrameBasis(direction, right, up);
+		return Matrix4x4::LookAt(direction * 2.0f, Vector3::zero, up);
+	}
+
+	Matrix4x4 ImpostorUtility::FrameProjectionMatrix()
+	{
+		return Matrix4x4::Ortho(-1, 1, -1, 1, 1, 3);
+	}
+
+	ImpostorUtility::FrameBlend ImpostorUtility::BlendFrames(Layout const & layout, Vector3 const & direction)
+	{
+		Vector2 p;
+		if (layout.hemisphere)
+		{
+			auto d = direction;
+			d.y = std::max(d.y, 0.0f);
+			if (d.x == 0 && d.y == 0 && d.z == 0)
+				d.y = 1;
+			p = HemiOctahedralEncode(d);
+		}
+		else
+		{
+			p = OctahedralEncode(direction);
+		}
+
+		// grid coordinates: the frames are at the integers, 0 to framesPerSide-1
+		const int last = layout.framesPerSide - 1;
+		float gx = Mathf::Clamp((p.x * 0.5f + 0.5f) * last, 0.0f, static_cast<float>(last));
+		float gy = Mathf::Clamp((p.y * 0.5f + 0.5f) * last, 0.0f, static_cast<float>(last));
+		int cx = std::min(static_cast<int>(gx), last - 1);
+		int cy = std::min(static_cast<int>(gy), last - 1);
+		float fx = gx - cx;
+		float fy = gy - cy;
+
+		// the cell is split along its diagonal: the frames of the corner (cx, cy), of the opposite corner and of the
+		// corner on the side of the diagonal the direction is, weighted by the barycentric coordinates
+		FrameBlend blend;
+		blend.x[0] = cx;
+		blend.y[0] = cy;
+		blend.x[1] = cx + 1;
+		blend.y[1] = cy + 1;
+		if (fx >= fy)
+		{
+			blend.x[2] = cx + 1;
+			blend.y[2] = cy;
+			blend.weight[0] = 1 - fx;
+			blend.weight[1] = fy;
+			blend.weight[2] = fx - fy;
+		}
+		else
+		{
+			blend.x[2] = cx;
+			blend.y[2] = cy + 1;
+			blend.weight[0] = 1 - fy;
+			blend.weight[1] = fx;
+			blend.weight[2] = fy - fx;
+		}
+		return blend;
+	}
+
+	bool ImpostorUtility::ProjectToFrame(Vector3 const & frameDirection, Vector3 const & eye, Vector3 const & point, Vector2 & frameUV)
+	{
+		auto ray = point - eye;
+		float denominator = Vector3::Dot(ray, frameDirection);
+		if (std::abs(denominator) < 1e-6f)
+			return false;
+		auto hit = eye - ray * (Vector3::Dot(eye, frameDirection) / denominator);
+		Vector3 right, up;
+		FrameBasis(frameDirection, right, up);
+		frameUV = Vector2(Vector3::Dot(hit, right) * 0.5f + 0.5f, Vector3::Dot(hit, up) * 0.5f + 0.5f);
+		return true;
+	}
+
+	Vector3 ImpostorUtility::FramePoint(Vector3 const & frameDirection, Vector2 const & frameUV, float depth)
+	{
+		Vector3 right, up;
+		FrameBasis(frameDirection, right, up);
+		return right * (frameUV.x * 2 - 1) + up * (frameUV.y * 2 - 1) - frameDirection * (depth * 2 - 1);
+	}
+
+	Vector2 ImpostorUtility::AtlasUV(Layout const & layout, int x, int y, Vector2 const & frameUV)
+	{
+		// half a texel inside the frame, so that the bilinear filter does not read the next one
+		const float margin = 0.5f / layout.frameResolution;
+		float u = Mathf::Clamp(frameUV.x, margin, 1 - margin);
+		float v = Mathf::Clamp(frameUV.y, margin, 1 - margin);
+		return Vector2((x + u) / layout.framesPerSide, (y + v) / layout.framesPerSide);
+	}
+
+	void ImpostorUtility::FrameViewport(Layout const & layout, int x, int y, int viewport[4])
+	{
+		viewport[0] = x * layout.frameResolution;
+		viewport[1] = y * layout.frameResolution;
+		viewport[2] = layout.frameResolution;
+		viewport[3] = layout.frameResolution;
+	}
+}
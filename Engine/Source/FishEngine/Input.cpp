@@ -2,47 +2,83 @@
 #include <FishEngine/Debug.hpp>
 
 #include <cassert>
+#include <chrono>
 
 namespace FishEngine
 {
-	KeyState Input::m_keyStates[keyCount] = { KeyState::None };
-	MouseButtonState Input::m_mouseButtonStates[3] = { MouseButtonState::None };
+	std::bitset<keyCount> Input::m_keyHeld;
+	std::bitset<keyCount> Input::m_keyDownThisFrame;
+	std::bitset<keyCount> Input::m_keyUpThisFrame;
+	std::bitset<3> Input::m_mouseButtonHeld;
+	std::bitset<3> Input::m_mouseButtonDownThisFrame;
+	std::bitset<3> Input::m_mouseButtonUpThisFrame;
 
 	float Input::m_mousePositionX = 0;
 	float Input::m_mousePositionY = 0;
+	bool Input::m_mousePositionValid = false;
+	float Input::m_mouseDeltaX = 0;
+	float Input::m_mouseDeltaY = 0;
+	bool Input::m_rawMouseDelta = false;
+	bool Input::m_cursorLocked = false;
 	float Input::m_axis[(int)Axis::AxisCount] = { 0.0f };
 
+	std::vector<InputEvent> Input::m_frameEvents;
+
 	void Input::Init()
 	{
-		for (auto& s : m_keyStates)
-			s = KeyState::None;
-		for (auto& b : m_mouseButtonStates)
-			b = MouseButtonState::None;
+		m_keyHeld.reset();
+		m_keyDownThisFrame.reset();
+		m_keyUpThisFrame.reset();
+		m_mouseButtonHeld.reset();
+		m_mouseButtonDownThisFrame.reset();
+		m_mouseButtonUpThisFrame.reset();
+		m_mousePositionX = m_mousePositionY = 0;
+		m_mousePositionValid = false;
+		m_mouseDeltaX = m_mouseDeltaY = 0;
+		m_rawMouseDelta = false;
+		m_frameEvents.clear();
 
 		for (auto& a : m_axis) {
 			a = 0.f;
 		}
 	}
 
+	double Input::Now()
+	{
+		static const auto start = std::chrono::steady_clock::now();
+		auto elapse = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration_cast<std::chrono::duration<double>>(elapse).count();
+	}
+
 	bool Input::GetKey(KeyCode key)
 	{
-		return m_keyStates[(int)key] == KeyState::Held;
+		int k = static_cast<int>(key);
+		if (k < 0 || k >= keyCount)
+			return false;
+		// a key pressed and released within one frame still counts as held for that frame
+		return m_keyHeld[k] || m_keyDownThisFrame[k];
 	}
 
 	bool Input::GetKeyDown(KeyCode key)
 	{
-		return m_keyStates[(int)key] == KeyState::Down;
+		int k = static_cast<int>(key);
+		if (k < 0 || k >= keyCount)
+			return false;
+		return m_keyDownThisFrame[k];
 	}
 
 	bool Input::GetKeyUp(KeyCode key)
 	{
-		return m_keyStates[(int)key] == KeyState::Up;
+		int k = static_cast<int>(key);
+		if (k < 0 || k >= keyCount)
+			return false;
+		return m_keyUpThisFrame[k];
 	}
 
 	bool Input::GetMouseButton(int button)
 	{
-		if (button >= 0 && button <= 3) {
-			return m_mouseButtonStates[button] == MouseButtonState::Held;
+		if (button >= 0 && button < 3) {
+			return m_mouseButtonHeld[button] || m_mouseButtonDownThisFrame[button];
 		}
 		else {
 			LogWarning(Format("invalid mouse button id: %1%", button));
@@ -52,8 +88,8 @@ namespace FishEngine
 
 	bool Input::GetMouseButtonDown(int button)
 	{
-		if (button >= 0 && button <= 3) {
-			return m_mouseButtonStates[button] == MouseButtonState::Down;
+		if (button >= 0 && button < 3) {
+			return m_mouseButtonDownThisFrame[button];
 		}
 		else {
 			LogWarning(Format("invalid mouse button id: %1%", button));
@@ -63,8 +99,8 @@ namespace FishEngine
 
 	bool Input::GetMouseButtonUp(int button)
 	{
-		if (button >= 0 && button <= 3) {
-			return m_mouseButtonStates[button] == MouseButtonState::Up;
+		if (button >= 0 && button < 3) {
+			return m_mouseButtonUpThisFrame[button];
 		}
 		else {
 			LogWarning(Format("invalid mouse button id: %1%", button));
@@ -72,21 +108,87 @@ namespace FishEngine
 		}
 	}
 
-	void Input::Update()
+	void Input::PostEvent(InputEvent const & e)
 	{
-		for (auto& s : m_keyStates) {
-			if (s == KeyState::Down)
-				s = KeyState::Held;
-			if (s == KeyState::Up)
-				s = KeyState::None;
+		InputEvent event = e;
+		if (!m_frameEvents.empty() && event.timestamp < m_frameEvents.back().timestamp)
+			event.timestamp = m_frameEvents.back().timestamp;
+
+		switch (event.type)
+		{
+		case InputEventType::KeyDown:
+			if (event.code < 0 || event.code >= keyCount)
+				return;
+			// ignore key repeat
+			if (m_keyHeld[event.code])
+				return;
+			m_keyHeld[event.code] = true;
+			m_keyDownThisFrame[event.code] = true;
+			break;
+		case InputEventType::KeyUp:
+			if (event.code < 0 || event.code >= keyCount)
+				return;
+			m_keyHeld[event.code] = false;
+			m_keyUpThisFrame[event.code] = true;
+			break;
+		case InputEventType::MouseButtonDown:
+			if (event.code < 0 || event.code >= 3)
+				return;
+			m_mouseButtonHeld[event.code] = true;
+			m_mouseButtonDownThisFrame[event.code] = true;
+			break;
+		case InputEventType::MouseButtonUp:
+			if (event.code < 0 || event.code >= 3)
+				return;
+			m_mouseButtonHeld[event.code] = false;
+			m_mouseButtonUpThisFrame[event.code] = true;
+			break;
+		case InputEventType::MouseMove:
+			// the raw deltas are not clamped by the window: the position is only the fallback.
+			// The first position has no previous one to move from.
+			if (!m_rawMouseDelta && m_mousePositionValid)
+			{
+				m_mouseDeltaX += event.x - m_mousePositionX;
+				m_mouseDeltaY += event.y - m_mousePositionY;
+				m_axis[(int)Axis::MouseX] = m_mouseDeltaX;
+				m_axis[(int)Axis::MouseY] = m_mouseDeltaY;
+			}
+			m_mousePositionX = event.x;
+			m_mousePositionY = event.y;
+			m_mousePositionValid = true;
+			break;
+		case InputEventType::MouseDelta:
+			// the device moved, not the position (a locked cursor): the next position starts again
+			m_rawMouseDelta = true;
+			m_mousePositionValid = false;
+			m_mouseDeltaX += event.x;
+			m_mouseDeltaY += event.y;
+			m_axis[(int)Axis::MouseX] = m_mouseDeltaX;
+			m_axis[(int)Axis::MouseY] = m_mouseDeltaY;
+			break;
+		case InputEventType::Scroll:
+			m_axis[(int)Axis::MouseScrollWheel] += event.y;
+			break;
 		}
+		m_frameEvents.push_back(event);
+	}
 
-		for (auto& b : m_mouseButtonStates) {
-			if (b == MouseButtonState::Down)
-				b = MouseButtonState::Held;
-			else if (b == MouseButtonState::Up)
-				b = MouseButtonState::None;
+	void Input::Update()
+	{
+		// only the keys touched by this frame's events need to be reset
+		for (auto const & e : m_frameEvents)
+		{
+			if (e.type == InputEventType::KeyDown || e.type == InputEventType::KeyUp)
+			{
+				m_keyDownThisFrame[e.code] = false;
+				m_keyUpThisFrame[e.code] = false;
+			}
 		}
+		m_mouseButtonDownThisFrame.reset();
+		m_mouseButtonUpThisFrame.reset();
+		m_mouseDeltaX = m_mouseDeltaY = 0;
+		m_rawMouseDelta = false;
+		m_frameEvents.clear();
 
 		for (auto& a : m_axis) {
 			a = 0.f;
@@ -96,21 +198,32 @@ namespace FishEngine
 
 	void Input::UpdateAxis(Axis axis, float value)
 	{
-		m_axis[(int)axis] = value;
+		if (axis == Axis::MouseScrollWheel)
+			PostEvent(InputEvent{ InputEventType::Scroll, Now(), 0, 0, value });
+		else
+			m_axis[(int)axis] = value;
 	}
 
 	void Input::UpdateMousePosition(float xpos, float ypos)
 	{
-		m_axis[(int)Axis::MouseX] = xpos - m_mousePositionX;
-		m_axis[(int)Axis::MouseY] = ypos - m_mousePositionY;
-		m_mousePositionX = xpos;
-		m_mousePositionY = ypos;
+		if (xpos == m_mousePositionX && ypos == m_mousePositionY)
+			return;
+		PostEvent(InputEvent{ InputEventType::MouseMove, Now(), 0, xpos, ypos });
+	}
+
+	void Input::UpdateMouseDelta(float dx, float dy)
+	{
+		if (dx == 0 && dy == 0)
+			return;
+		PostEvent(InputEvent{ InputEventType::MouseDelta, Now(), 0, dx, dy });
 	}
 
 	void Input::UpdateKeyState(int key, KeyState state)
 	{
-		if (key >= 0 && key < keyCount)
-			m_keyStates[key] = state;
+		if (state == KeyState::Down)
+			PostEvent(InputEvent{ InputEventType::KeyDown, Now(), key, 0, 0 });
+		else if (state == KeyState::Up)
+			PostEvent(InputEvent{ InputEventType::KeyUp, Now(), key, 0, 0 });
 	}
 
 	void Input::UpdateKeyState(KeyCode key, KeyState state)
@@ -121,7 +234,9 @@ namespace FishEngine
 
 	void Input::UpdateMouseButtonState(int button, MouseButtonState state)
 	{
-		if (button >= 0 && button <= 3)
-			m_mouseButtonStates[button] = state;
+		if (state == MouseButtonState::Down)
+			PostEvent(InputEvent{ InputEventType::MouseButtonDown, Now(), button, 0, 0 });
+		else if (state == MouseButtonState::Up)
+			PostEvent(InputEvent{ InputEventType::MouseButtonUp, Now(), button, 0, 0 });
 	}
 }
@@ -6,11 +6,10 @@
 #include <FishEngine/Debug.hpp>
 #include <FishEngine/StringFormat.hpp>
 #include <FishEngine/AudioClip.hpp>
+#include <FishEngine/AudioSystem.hpp>
 
 using namespace FishEngine;
 
-constexpr int maxChannel = 32;
-
 void FMODPlugin::Update()
 {
 	GetInstance().m_system->update();
@@ -18,6 +17,7 @@ void FMODPlugin::Update()
 
 void FMODPlugin::Stop()
 {
+	const int maxChannel = AudioSystem::maxVirtualVoices();
 	for (int i = 0; i < maxChannel; ++i)
 	{
 		FMOD::Channel* pChannel = nullptr;
@@ -34,7 +34,23 @@ FMODPlugin::FMODPlugin()
 	result = FMOD::System_Create(&m_system);
 	CheckFMODError(result);
 
-	result = m_system->init(maxChannel, FMOD_INIT_NORMAL, 0);
+	if (AudioSystem::noSoundOutput())
+	{
+		result = m_system->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT);
+		CheckFMODError(result);
+	}
+
+	// voices beyond the real voice limit, and voices quieter than the threshold, become virtual
+	result = m_system->setSoftwareChannels(AudioSystem::maxRealVoices());
+	CheckFMODError(result);
+	FMOD_ADVANCEDSETTINGS settings;
+	memset(&settings, 0, sizeof(settings));
+	settings.cbSize = sizeof(settings);
+	settings.vol0virtualvol = AudioSystem::audibilityThreshold();
+	result = m_system->setAdvancedSettings(&settings);
+	CheckFMODError(result);
+
+	result = m_system->init(AudioSystem::maxVirtualVoices(), FMOD_INIT_NORMAL | FMOD_INIT_VOL0_BECOMES_VIRTUAL, 0);
 	CheckFMODError(result);
 }
 
@@ -0,0 +1,52 @@
+#include <FishEngine/GeometryUtility.hpp>
+
+namespace FishEngine
+{
+	void GeometryUtility::CalculateFrustumPlanes(const Matrix4x4& worldToProjectionMatrix, Vector4 planes[6])
+	{
+		// Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+		// OpenGL clip space: -w <= x, y, z <= w
+		auto const & m = worldToProjectionMatrix;
+		planes[0] = m[3] + m[0];	// left
+		planes[1] = m[3] - m[0];	// right
+		planes[2] = m[3] + m[1];	// bottom
+		planes[3] = m[3] - m[1];	// top
+		planes[4] = m[3] + m[2];	// near
+		planes[5] = m[3] - m[2];	// far
+		for (int i = 0; i < 6; ++i)
+		{
+			auto & p = planes[i];
+			float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+			if (length > 0)
+				p *= 1.0f / length;
+		}
+	}
+
+	bool GeometryUtility::TestPlanesAABB(const Vector4 planes[6], const Bounds& bounds)
+	{
+		auto c = bounds.center();
+		auto e = bounds.extents();
+		for (int i = 0; i < 6; ++i)
+		{
+			auto const & p = planes[i];
+			// distance of the center, and projected radius of the box on the normal
+			float d = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+			float r = std::abs(p.x) * e.x + std::abs(p.y) * e.y + std::abs(p.z) * e.z;
+			if (d + r < 0)
+				return false;
+		}
+		return true;
+	}
+
+	bool GeometryUtility::TestPlanesSphere(const Vector4 planes[6], const Vector3& center, float radius)
+	{
+		for (int i = 0; i < 6; ++i)
+		{
+			auto const & p = planes[i];
+			float d = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+			if (d < 0 && d * d > radius * radius * (p.x * p.x + p.y * p.y + p.z * p.z))
+				return false;
+		}
+		return true;
+	}
+}
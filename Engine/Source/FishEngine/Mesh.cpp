@@ -7,6 +7,7 @@
 
 #include <FishEngine/Shader.hpp>
 #include <FishEngine/Debug.hpp>
+#include <FishEngine/GeometryPool.hpp>
 #include <FishEngine/Common.hpp>
 #include <FishEngine/ShaderVariables_gen.hpp>
 #include <FishEngine/Generated/Enum_PrimitiveType.hpp>
@@ -57,6 +58,13 @@ namespace FishEngine
 
 	Mesh::~Mesh()
 	{
+		if (m_pool != nullptr)
+			m_pool->Free(m_poolBlock);
+		// never uploaded (built on the CPU, drawn from a pool): there may be no GL context
+		if (m_VAO == 0)
+			return;
+		// the name may be reused by the next glGenVertexArrays, which BindVertexArray would then skip
+		GeometryPool::InvalidateBinding();
 		glDeleteVertexArrays(1, &m_VAO);
 		glDeleteBuffers(1, &m_positionVBO);
 		glDeleteBuffers(1, &m_normalVBO);
@@ -89,10 +97,18 @@ namespace FishEngine
 
 	void Mesh::UploadMeshData(bool markNoLogerReadable /*= true*/)
 	{
-		if (m_uploaded)
+		if (m_uploaded || m_uploadQueued)
 			return;
-		GenerateBuffer();
-		BindBuffer();
+		if (!m_skinned && !m_vertices.empty() && !m_triangles.empty())
+		{
+			m_pool = &GeometryPool::Get(GeometryPool::LayoutOf(*this));
+			m_poolBlock = m_pool->Allocate(*this);
+		}
+		else
+		{
+			GenerateBuffer();
+			BindBuffer();
+		}
 		glCheckError();
 
 		//m_vertexCount = static_cast<uint32_t>(m_vertices.size());
@@ -134,6 +150,7 @@ namespace FishEngine
 		// VAO
 		assert(m_VAO == 0);
 		glGenVertexArrays(1, &m_VAO);
+		GeometryPool::BindVertexArray(m_VAO);
 		
 		// index VBO
 		glGenBuffers(1, &m_indexVBO);
@@ -207,7 +224,7 @@ namespace FishEngine
 		if (m_skinned)
 		{
 			// Transform feedback input
-			glBindVertexArray(m_animationInputVAO);
+			GeometryPool::BindVertexArray(m_animationInputVAO);
 			
 			// position
 			glBindBuffer(GL_ARRAY_BUFFER, m_positionVBO);
@@ -235,7 +252,7 @@ namespace FishEngine
 			glEnableVertexAttribArray(BoneWeightIndex);
 			
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			glBindVertexArray(0);
+			GeometryPool::BindVertexArray(0);
 			
 			glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, m_TFBO);
 			glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_animationOutputPositionVBO);
@@ -244,7 +261,7 @@ namespace FishEngine
 			glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
 		}
 		
-		glBindVertexArray(m_VAO);
+		GeometryPool::BindVertexArray(m_VAO);
 		
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexVBO);
 		
@@ -290,7 +307,7 @@ namespace FishEngine
 		
 		glBindBuffer(GL_ARRAY_BUFFER, 0); // Note that this is allowed, the call to glVertexAttribPointer registered VBO as the currently bound vertex buffer object so afterwards we can safely unbind
 		
-		glBindVertexArray(0); // Unbind VAO (it's always a good thing to unbind any buffer/array to prevent strange bugs), remember: do NOT unbind the EBO, keep it bound to this VAO
+		GeometryPool::BindVertexArray(0); // Unbind VAO (it's always a good thing to unbind any buffer/array to prevent strange bugs), remember: do NOT unbind the EBO, keep it bound to this VAO
 	}
 
 	void Mesh::Render( int subMeshIndex /* = -1*/)
@@ -299,9 +316,23 @@ namespace FishEngine
 		if (!m_uploaded)
 		{
 			UploadMeshData();
+			if (!m_uploaded)
+				return;
 		}
 		
-		glBindVertexArray(m_VAO);
+		// the VAO stays bound: the next mesh of the same pool does not bind it again
+		GLint baseVertex = 0;
+		uint32_t firstIndex = 0;
+		if (m_pool != nullptr)
+		{
+			m_pool->Bind();
+			baseVertex = static_cast<GLint>(m_pool->block(m_poolBlock).baseVertex);
+			firstIndex = m_pool->block(m_poolBlock).firstIndex;
+		}
+		else
+		{
+			GeometryPool::BindVertexArray(m_VAO);
+		}
 			
 		if (subMeshIndex < 0 && subMeshIndex != -1)
 		{
@@ -316,25 +347,112 @@ namespace FishEngine
 			
 		if (subMeshIndex == -1 || m_subMeshCount == 1)
 		{
-			glDrawElements(GL_TRIANGLES, m_triangleCount * 3, GL_UNSIGNED_INT, 0);
+			GLvoid * offset = (GLvoid *)( firstIndex * sizeof(GLuint) );
+			glDrawElementsBaseVertex(GL_TRIANGLES, m_triangleCount * 3, GL_UNSIGNED_INT, offset, baseVertex);
 		}
 		else
 		{
-			GLvoid * offset = (GLvoid *)( m_subMeshIndexOffset[subMeshIndex] * sizeof(GLuint) );
-			int index_count = 0;
-			if (subMeshIndex == m_subMeshCount-1) // the last one
-			{
-				index_count = m_triangleCount * 3 - m_subMeshIndexOffset[m_subMeshCount-1];
-				//index_count = 0;
-			}
-			else
-			{
-				index_count = m_subMeshIndexOffset[subMeshIndex+1] - m_subMeshIndexOffset[subMeshIndex];
-			}
-			glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, offset);
+			GLvoid * offset = (GLvoid *)( (firstIndex + GetIndexStart(subMeshIndex)) * sizeof(GLuint) );
+			glDrawElementsBaseVertex(GL_TRIANGLES, GetIndexCount(subMeshIndex), GL_UNSIGNED_INT, offset, baseVertex);
+		}
+	}
+	
+	void Mesh::Render(std::vector<IndexRange> const & ranges)
+	{
+		if (ranges.empty())
+			return;
+		if (!m_uploaded)
+		{
+			UploadMeshData();
+			if (!m_uploaded)
+				return;
+		}
+		
+		GLint baseVertex = 0;
+		uint32_t firstIndex = 0;
+		if (m_pool != nullptr)
+		{
+			m_pool->Bind();
+			baseVertex = static_cast<GLint>(m_pool->block(m_poolBlock).baseVertex);
+			firstIndex = m_pool->block(m_poolBlock).firstIndex;
+		}
+		else
+		{
+			GeometryPool::BindVertexArray(m_VAO);
+		}
+		
+		std::vector<GLsizei> counts(ranges.size());
+		std::vector<const GLvoid*> offsets(ranges.size());
+		std::vector<GLint> baseVertices(ranges.size(), baseVertex);
+		for (size_t i = 0; i < ranges.size(); ++i)
+		{
+			counts[i] = static_cast<GLsizei>(ranges[i].count);
+			offsets[i] = (const GLvoid *)( (firstIndex + ranges[i].start) * sizeof(GLuint) );
+		}
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), static_cast<GLsizei>(ranges.size()), baseVertices.data());
+	}
+	
+	uint32_t Mesh::GetIndexStart(int submesh) const
+	{
+		if (m_subMeshCount == 1)
+			return 0;
+		return m_subMeshIndexOffset[submesh];
+	}
+	
+	uint32_t Mesh::GetIndexCount(int submesh) const
+	{
+		if (m_subMeshCount == 1)
+			return m_triangleCount * 3;
+		if (submesh == m_subMeshCount-1) // the last one
+			return m_triangleCount * 3 - m_subMeshIndexOffset[submesh];
+		return m_subMeshIndexOffset[submesh+1] - m_subMeshIndexOffset[submesh];
+	}
+	
+	bool Mesh::ReadBackMeshData()
+	{
+		if (!m_vertices.empty())
+			return true;
+		if (!m_uploaded || m_skinned)
+			return false;
+		if (m_pool != nullptr)
+		{
+			m_pool->Read(m_poolBlock, *this);
+			return !m_vertices.empty();
 		}
 		
-		glBindVertexArray(0);
+		// GL_COPY_READ_BUFFER: does not change the element buffer of the bound VAO
+		auto readBack = [](GLuint buffer, auto & data)
+		{
+			GLint size = 0;
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+			glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+			data.resize(size / sizeof(data[0]));
+			if (size > 0)
+				glGetBufferSubData(GL_COPY_READ_BUFFER, 0, data.size() * sizeof(data[0]), data.data());
+		};
+		readBack(m_positionVBO, m_vertices);
+		readBack(m_normalVBO, m_normals);
+		readBack(m_uvVBO, m_uv);
+		readBack(m_tangentVBO, m_tangents);
+		readBack(m_indexVBO, m_triangles);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glCheckError();
+		return !m_vertices.empty();
+	}
+	
+	int Mesh::SelectLOD(float maxError) const
+	{
+		int level = 0;
+		while (level < static_cast<int>(m_lodErrors.size()) && m_lodErrors[level] <= maxError)
+			level++;
+		return level;
+	}
+	
+	void Mesh::SetLODs(std::vector<MeshPtr> lods, std::vector<float> errors)
+	{
+		assert(lods.size() == errors.size());
+		m_lods = std::move(lods);
+		m_lodErrors = std::move(errors);
 	}
 	
 	void Mesh::RenderSkinned()
@@ -342,11 +460,13 @@ namespace FishEngine
 		if (!m_uploaded)
 		{
 			UploadMeshData();
+			if (!m_uploaded)
+				return;
 		}
 		
 		glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, m_TFBO);
 		glEnable(GL_RASTERIZER_DISCARD);
-		glBindVertexArray(m_animationInputVAO);
+		GeometryPool::BindVertexArray(m_animationInputVAO);
 		//glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, m_animationOutputPositionVBO);
 		//glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_animationOutputPositionVBO);
 		glBeginTransformFeedback(GL_POINTS);
@@ -354,7 +474,7 @@ namespace FishEngine
 		glEndTransformFeedback();
 		//glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
 		//glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
-		glBindVertexArray(0);
+		GeometryPool::BindVertexArray(0);
 		glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
 		glDisable(GL_RASTERIZER_DISCARD);
 		glCheckError();
@@ -467,7 +587,7 @@ namespace FishEngine
 		m_drawMode(drawMode)
 	{
 		glGenVertexArrays(1, &m_VAO);
-		glBindVertexArray(m_VAO);
+		GeometryPool::BindVertexArray(m_VAO);
 		glGenBuffers(1, &m_VBO);
 		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
 		glBufferData(GL_ARRAY_BUFFER, m_positionBuffer.size() * sizeof(GLfloat), m_positionBuffer.data(), GL_DYNAMIC_DRAW);
@@ -486,16 +606,16 @@ namespace FishEngine
 
 	void SimpleMesh::Render() const
 	{
-		glBindVertexArray(m_VAO);
+		GeometryPool::BindVertexArray(m_VAO);
 		glDrawArrays(m_drawMode, 0, static_cast<GLsizei>(m_positionBuffer.size() / 3));
-		glBindVertexArray(0);
+		GeometryPool::BindVertexArray(0);
 	}
 
 	void DynamicMesh::Render(const float* positionBuffer, uint32_t vertexCount, GLenum drawMode)
 	{
 		if (m_VAO == 0)
 			glGenVertexArrays(1, &m_VAO);
-		glBindVertexArray(m_VAO);
+		GeometryPool::BindVertexArray(m_VAO);
 		if (m_VBO == 0)
 			glGenBuffers(1, &m_VBO);
 		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
@@ -503,6 +623,6 @@ namespace FishEngine
 		glVertexAttribPointer(PositionIndex, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
 		glEnableVertexAttribArray(PositionIndex);
 		glDrawArrays(m_drawMode, 0, vertexCount);
-		glBindVertexArray(0);
+		GeometryPool::BindVertexArray(0);
 	}
 }
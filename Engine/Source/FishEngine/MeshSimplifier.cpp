@@ -0,0 +1,736 @@
+#include <FishEngine/MeshSimplifier.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/Mathf.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+namespace FishEngine
+{
+	MeshGeometry MeshGeometry::FromMesh(Mesh const & mesh)
+	{
+		MeshGeometry g;
+		g.vertices = mesh.m_vertices;
+		g.normals = mesh.m_normals;
+		g.uv = mesh.m_uv;
+		g.tangents = mesh.m_tangents;
+		if (mesh.m_skinned)
+			g.boneWeights = mesh.m_boneWeights;
+		g.triangles = mesh.m_triangles;
+		if (mesh.m_subMeshCount > 1)
+			g.subMeshIndexOffset = mesh.m_subMeshIndexOffset;
+		else
+			g.subMeshIndexOffset.push_back(0);
+		return g;
+	}
+
+	MeshPtr MeshGeometry::ToMesh(Mesh const & source) const
+	{
+		auto v = vertices;
+		auto n = normals;
+		auto u = uv;
+		auto t = tangents;
+		auto i = triangles;
+		auto mesh = MakeShared<Mesh>(std::move(v), std::move(n), std::move(u), std::move(t), std::move(i));
+		if (subMeshIndexOffset.size() > 1)
+		{
+			mesh->m_subMeshCount = static_cast<int>(subMeshIndexOffset.size());
+			mesh->m_subMeshIndexOffset = subMeshIndexOffset;
+		}
+		if (source.m_skinned)
+		{
+			mesh->m_skinned = true;
+			mesh->m_boneWeights = boneWeights;
+			mesh->m_bindposes = source.m_bindposes;
+			mesh->m_boneNames = source.m_boneNames;
+		}
+		return mesh;
+	}
+}
+
+
+namespace
+{
+	using namespace FishEngine;
+
+	// Symmetric 4x4 matrix of the quadric error: sum of the squared distances to a set of planes.
+	struct Quadric
+	{
+		// xx xy xz xw yy yz yw zz zw ww
+		double q[10] = {};
+
+		// plane n.p + d = 0, n normalized
+		static Quadric Plane(Vector3 const & n, float d, double weight)
+		{
+			Quadric r;
+			const double a = n.x, b = n.y, c = n.z, w = d;
+			r.q[0] = a*a*weight; r.q[1] = a*b*weight; r.q[2] = a*c*weight; r.q[3] = a*w*weight;
+			r.q[4] = b*b*weight; r.q[5] = b*c*weight; r.q[6] = b*w*weight;
+			r.q[7] = c*c*weight; r.q[8] = c*w*weight;
+			r.q[9] = w*w*weight;
+			return r;
+		}
+
+		void operator+=(Quadric const & rhs)
+		{
+			for (int i = 0; i < 10; ++i)
+				q[i] += rhs.q[i];
+		}
+
+		double Evaluate(Vector3 const & p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			return q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x
+				+ q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y
+				+ q[7]*z*z + 2*q[8]*z
+				+ q[9];
+		}
+	};
+
+	// the constraint planes of the borders and seams weigh more than the faces
+	constexpr double BoundaryWeight = 10.0;
+
+	// a collapse rotating the normal of a triangle by more than ~75 degrees is rejected
+	constexpr float MinNormalCos = 0.25f;
+
+	struct PositionHash
+	{
+		size_t operator()(Vector3 const & p) const
+		{
+			// + 0: -0 and 0 are the same position
+			float xyz[3] = { p.x + 0.0f, p.y + 0.0f, p.z + 0.0f };
+			uint32_t h[3];
+			std::memcpy(h, xyz, sizeof(h));
+			return (h[0] * 73856093u) ^ (h[1] * 19349663u) ^ (h[2] * 83492791u);
+		}
+	};
+
+	struct PositionEqual
+	{
+		bool operator()(Vector3 const & a, Vector3 const & b) const
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+	};
+
+	struct Collapse
+	{
+		double		cost;
+		uint32_t	from;
+		uint32_t	to;
+		uint32_t	fromVersion;
+		uint32_t	toVersion;
+
+		bool operator>(Collapse const & rhs) const
+		{
+			return cost > rhs.cost;
+		}
+	};
+
+	float BoneWeightDifference(BoneWeight const & a, BoneWeight const & b)
+	{
+		float difference = 0;
+		for (int i = 0; i < MaxBoneForEachVertex; ++i)
+		{
+			if (a.weight[i] <= 0)	// unused slot, bone 0
+				continue;
+			float wb = 0;
+			for (int j = 0; j < MaxBoneForEachVertex; ++j)
+			{
+				if (b.weight[j] > 0 && b.boneIndex[j] == a.boneIndex[i])
+					wb += b.weight[j];
+			}
+			difference += std::abs(a.weight[i] - wb);
+		}
+		for (int j = 0; j < MaxBoneForEachVertex; ++j)
+		{
+			bool inA = false;
+			for (int i = 0; i < MaxBoneForEachVertex; ++i)
+			{
+				if (a.weight[i] > 0 && a.boneIndex[i] == b.boneIndex[j])
+					inA = true;
+			}
+			if (!inA)
+				difference += b.weight[j];
+		}
+		return difference;
+	}
+
+
+	// The vertices are welded by position into points, the collapses move a point onto another one.
+	// Each triangle corner keeps its vertex (wedge), remapped to a wedge of the target point by the collapse.
+	class Simplifier
+	{
+	public:
+		explicit Simplifier(MeshGeometry const & source) : m_source(source)
+		{
+			const uint32_t vertexCount = static_cast<uint32_t>(source.vertices.size());
+			m_pointOf.resize(vertexCount);
+			std::unordered_map<Vector3, uint32_t, PositionHash, PositionEqual> points;
+			points.reserve(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; ++v)
+			{
+				auto it = points.emplace(source.vertices[v], static_cast<uint32_t>(m_positions.size()));
+				if (it.second)
+					m_positions.push_back(source.vertices[v]);
+				m_pointOf[v] = it.first->second;
+			}
+			const uint32_t pointCount = static_cast<uint32_t>(m_positions.size());
+			m_pointTriangles.resize(pointCount);
+			m_quadrics.resize(pointCount);
+			m_version.resize(pointCount, 0);
+			m_removed.resize(pointCount, false);
+
+			auto const & offsets = source.subMeshIndexOffset;
+			const uint32_t triangleCount = source.triangleCount();
+			m_corners = source.triangles;
+			m_subMesh.resize(triangleCount, 0);
+			m_triangleRemoved.resize(triangleCount, false);
+			for (size_t s = 1; s < offsets.size(); ++s)
+			{
+				for (uint32_t i = offsets[s] / 3; i < triangleCount; ++i)
+					m_subMesh[i] = static_cast<int>(s);
+			}
+
+			m_liveTriangles = 0;
+			for (uint32_t t = 0; t < triangleCount; ++t)
+			{
+				uint32_t a = Point(t, 0), b = Point(t, 1), c = Point(t, 2);
+				if (a == b || b == c || c == a)
+				{
+					// degenerated, no area
+					m_triangleRemoved[t] = true;
+					continue;
+				}
+				m_liveTriangles++;
+				for (int k = 0; k < 3; ++k)
+					m_pointTriangles[Point(t, k)].push_back(t);
+
+				auto normal = Vector3::Cross(m_positions[b] - m_positions[a], m_positions[c] - m_positions[a]);
+				float length = normal.magnitude();
+				if (length <= 0)
+					continue;
+				normal = normal * (1.0f / length);
+				auto plane = Quadric::Plane(normal, -Vector3::Dot(normal, m_positions[a]), 0.5 * length);
+				m_quadrics[a] += plane;
+				m_quadrics[b] += plane;
+				m_quadrics[c] += plane;
+			}
+
+			AddBoundaryQuadrics();
+		}
+
+		void Run(uint32_t targetTriangleCount)
+		{
+			// the collapses rejected by a constraint may become valid after the collapses around them: a few passes
+			for (int pass = 0; pass < 8 && m_liveTriangles > targetTriangleCount; ++pass)
+			{
+				for (uint32_t p = 0; p < m_positions.size(); ++p)
+				{
+					if (!m_removed[p])
+						PushCollapses(p);
+				}
+				int collapseCount = 0;
+				while (!m_queue.empty() && m_liveTriangles > targetTriangleCount)
+				{
+					auto c = m_queue.top();
+					m_queue.pop();
+					if (m_removed[c.from] || m_removed[c.to] || m_version[c.from] != c.fromVersion || m_version[c.to] != c.toVersion)
+						continue;
+					if (!CanCollapse(c.from, c.to))
+						continue;
+					Apply(c.from, c.to);
+					collapseCount++;
+				}
+				m_queue = decltype(m_queue)();
+				if (collapseCount == 0)
+					break;
+			}
+		}
+
+		MeshGeometry Result() const
+		{
+			MeshGeometry g;
+			const bool hasNormals = !m_source.normals.empty();
+			const bool hasUV = !m_source.uv.empty();
+			const bool hasTangents = !m_source.tangents.empty();
+			const bool skinned = !m_source.boneWeights.empty();
+			std::vector<uint32_t> remap(m_source.vertices.size(), UINT32_MAX);
+			const uint32_t triangleCount = m_source.triangleCount();
+			const int subMeshCount = static_cast<int>(m_source.subMeshIndexOffset.size());
+			for (int s = 0; s < subMeshCount; ++s)
+			{
+				g.subMeshIndexOffset.push_back(static_cast<uint32_t>(g.triangles.size()));
+				for (uint32_t t = 0; t < triangleCount; ++t)
+				{
+					if (m_triangleRemoved[t] || m_subMesh[t] != s)
+						continue;
+					for (int k = 0; k < 3; ++k)
+					{
+						uint32_t v = m_corners[t * 3 + k];
+						if (remap[v] == UINT32_MAX)
+						{
+							remap[v] = static_cast<uint32_t>(g.vertices.size());
+							g.vertices.push_back(m_source.vertices[v]);
+							if (hasNormals)
+								g.normals.push_back(m_source.normals[v]);
+							if (hasUV)
+								g.uv.push_back(m_source.uv[v]);
+							if (hasTangents)
+								g.tangents.push_back(m_source.tangents[v]);
+							if (skinned)
+								g.boneWeights.push_back(m_source.boneWeights[v]);
+						}
+						g.triangles.push_back(remap[v]);
+					}
+				}
+			}
+			return g;
+		}
+
+	private:
+
+		uint32_t Point(uint32_t triangle, int corner) const
+		{
+			return m_pointOf[m_corners[triangle * 3 + corner]];
+		}
+
+		int CornerOf(uint32_t triangle, uint32_t point) const
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				if (Point(triangle, k) == point)
+					return k;
+			}
+			return -1;
+		}
+
+		// Borders, seams and boundaries of submeshes: plane through the edge, perpendicular to the triangle.
+		void AddBoundaryQuadrics()
+		{
+			struct EdgeInfo
+			{
+				uint32_t	triangle;
+				uint32_t	wedges[2];	// at the smaller and the larger point
+				int			count;
+				bool		boundary;
+			};
+			std::unordered_map<uint64_t, EdgeInfo> edges;
+			const uint32_t triangleCount = m_source.triangleCount();
+			for (uint32_t t = 0; t < triangleCount; ++t)
+			{
+				if (m_triangleRemoved[t])
+					continue;
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t w0 = m_corners[t * 3 + k], w1 = m_corners[t * 3 + (k + 1) % 3];
+					uint32_t p0 = m_pointOf[w0], p1 = m_pointOf[w1];
+					if (p0 > p1)
+					{
+						std::swap(p0, p1);
+						std::swap(w0, w1);
+					}
+					uint64_t key = (uint64_t(p0) << 32) | p1;
+					auto it = edges.find(key);
+					if (it == edges.end())
+					{
+						edges[key] = { t, { w0, w1 }, 1, false };
+						continue;
+					}
+					auto & e = it->second;
+					e.count++;
+					if (e.wedges[0] != w0 || e.wedges[1] != w1 || m_subMesh[e.triangle] != m_subMesh[t])
+						e.boundary = true;
+				}
+			}
+
+			for (auto const & item : edges)
+			{
+				auto const & e = item.second;
+				if (e.count == 2 && !e.boundary)
+					continue;
+				uint32_t p0 = static_cast<uint32_t>(item.first >> 32), p1 = static_cast<uint32_t>(item.first & 0xffffffff);
+				uint32_t t = e.triangle;
+				auto a = m_positions[Point(t, 0)], b = m_positions[Point(t, 1)], c = m_positions[Point(t, 2)];
+				auto faceNormal = Vector3::Cross(b - a, c - a);
+				auto edge = m_positions[p1] - m_positions[p0];
+				auto normal = Vector3::Cross(edge, faceNormal);
+				float length = normal.magnitude();
+				if (length <= 0)
+					continue;
+				normal = normal * (1.0f / length);
+				auto plane = Quadric::Plane(normal, -Vector3::Dot(normal, m_positions[p0]), BoundaryWeight * edge.sqrMagnitude());
+				m_quadrics[p0] += plane;
+				m_quadrics[p1] += plane;
+			}
+		}
+
+		void PushCollapses(uint32_t p)
+		{
+			for (auto t : m_pointTriangles[p])
+			{
+				if (m_triangleRemoved[t])
+					continue;
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t q = Point(t, k);
+					if (q == p)
+						continue;
+					Quadric sum = m_quadrics[p];
+					sum += m_quadrics[q];
+					m_queue.push({ sum.Evaluate(m_positions[q]), p, q, m_version[p], m_version[q] });
+				}
+			}
+		}
+
+		bool CanCollapse(uint32_t u, uint32_t v)
+		{
+			auto const & positions = m_positions;
+			m_edgeTriangles.clear();
+			m_wedgeMap.clear();
+			m_edgeSubMeshes.clear();
+			m_neighbors.clear();
+			m_opposite.clear();
+
+			for (auto t : m_pointTriangles[u])
+			{
+				if (m_triangleRemoved[t])
+					continue;
+				int ku = CornerOf(t, u);
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t w = Point(t, k);
+					if (w == u)
+						continue;
+					auto it = std::find_if(m_neighbors.begin(), m_neighbors.end(), [w](std::pair<uint32_t, int> const & n) { return n.first == w; });
+					if (it == m_neighbors.end())
+						m_neighbors.emplace_back(w, 1);
+					else
+						it->second++;
+				}
+				int kv = CornerOf(t, v);
+				if (kv < 0)
+					continue;
+				m_edgeTriangles.push_back(t);
+				m_opposite.push_back(Point(t, 3 - ku - kv));
+				uint32_t wu = m_corners[t * 3 + ku], wv = m_corners[t * 3 + kv];
+				auto it = std::find_if(m_wedgeMap.begin(), m_wedgeMap.end(), [wu](std::pair<uint32_t, uint32_t> const & m) { return m.first == wu; });
+				if (it == m_wedgeMap.end())
+					m_wedgeMap.emplace_back(wu, wv);
+				else if (it->second != wv)
+					return false;	// a wedge of u would have to go to two wedges of v
+				if (std::find(m_edgeSubMeshes.begin(), m_edgeSubMeshes.end(), m_subMesh[t]) == m_edgeSubMeshes.end())
+					m_edgeSubMeshes.push_back(m_subMesh[t]);
+			}
+			if (m_edgeTriangles.empty())
+				return false;
+
+			// borders and non-manifold edges
+			bool border = false;
+			int edgeCount = 0;
+			for (auto const & n : m_neighbors)
+			{
+				if (n.second > 2)
+					return false;
+				if (n.second == 1)
+					border = true;
+				if (n.first == v)
+					edgeCount = n.second;
+			}
+			if (border && edgeCount != 1)
+				return false;
+
+			// link condition: the neighbors shared by u and v are the opposite vertices of the edge, no fold
+			for (auto t : m_pointTriangles[v])
+			{
+				if (m_triangleRemoved[t])
+					continue;
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t w = Point(t, k);
+					if (w == u || w == v)
+						continue;
+					bool sharedNeighbor = std::find_if(m_neighbors.begin(), m_neighbors.end(), [w](std::pair<uint32_t, int> const & n) { return n.first == w; }) != m_neighbors.end();
+					if (sharedNeighbor && std::find(m_opposite.begin(), m_opposite.end(), w) == m_opposite.end())
+						return false;
+				}
+			}
+
+			// seams and submeshes: every triangle of u must find its wedge and material on the edge
+			for (auto t : m_pointTriangles[u])
+			{
+				if (m_triangleRemoved[t])
+					continue;
+				uint32_t wu = m_corners[t * 3 + CornerOf(t, u)];
+				if (std::find_if(m_wedgeMap.begin(), m_wedgeMap.end(), [wu](std::pair<uint32_t, uint32_t> const & m) { return m.first == wu; }) == m_wedgeMap.end())
+					return false;
+				if (std::find(m_edgeSubMeshes.begin(), m_edgeSubMeshes.end(), m_subMesh[t]) == m_edgeSubMeshes.end())
+					return false;
+			}
+
+			if (!m_source.boneWeights.empty())
+			{
+				for (auto const & m : m_wedgeMap)
+				{
+					if (BoneWeightDifference(m_source.boneWeights[m.first], m_source.boneWeights[m.second]) > MeshSimplifier::MaxBoneWeightDifference)
+						return false;
+				}
+			}
+
+			// flipped triangles
+			for (auto t : m_pointTriangles[u])
+			{
+				if (m_triangleRemoved[t] || CornerOf(t, v) >= 0)
+					continue;
+				Vector3 p[3], q[3];
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t w = Point(t, k);
+					p[k] = positions[w];
+					q[k] = w == u ? positions[v] : positions[w];
+				}
+				auto n0 = Vector3::Cross(p[1] - p[0], p[2] - p[0]);
+				auto n1 = Vector3::Cross(q[1] - q[0], q[2] - q[0]);
+				if (Vector3::Dot(n0, n1) <= MinNormalCos * n0.magnitude() * n1.magnitude())
+					return false;
+			}
+			return true;
+		}
+
+		void Apply(uint32_t u, uint32_t v)
+		{
+			for (auto t : m_pointTriangles[u])
+			{
+				if (m_triangleRemoved[t])
+					continue;
+				if (CornerOf(t, v) >= 0)
+				{
+					m_triangleRemoved[t] = true;
+					m_liveTriangles--;
+					continue;
+				}
+				auto & wu = m_corners[t * 3 + CornerOf(t, u)];
+				for (auto const & m : m_wedgeMap)
+				{
+					if (m.first == wu)
+					{
+						wu = m.second;
+						break;
+					}
+				}
+				m_pointTriangles[v].push_back(t);
+			}
+			m_pointTriangles[u].clear();
+			m_pointTriangles[u].shrink_to_fit();
+			auto & triangles = m_pointTriangles[v];
+			triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [this](uint32_t t) { return m_triangleRemoved[t]; }), triangles.end());
+
+			m_quadrics[v] += m_quadrics[u];
+			m_removed[u] = true;
+			m_version[v]++;
+
+			// the costs of the edges of v changed
+			PushCollapses(v);
+			for (auto t : m_pointTriangles[v])
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t w = Point(t, k);
+					if (w == v)
+						continue;
+					Quadric sum = m_quadrics[w];
+					sum += m_quadrics[v];
+					m_queue.push({ sum.Evaluate(m_positions[v]), w, v, m_version[w], m_version[v] });
+				}
+			}
+		}
+
+		MeshGeometry const &				m_source;
+		std::vector<uint32_t>				m_pointOf;			// vertex -> point
+		std::vector<Vector3>				m_positions;		// of the points
+		std::vector<std::vector<uint32_t>>	m_pointTriangles;
+		std::vector<Quadric>				m_quadrics;
+		std::vector<uint32_t>				m_version;			// incremented when the collapses of the point change
+		std::vector<bool>					m_removed;
+
+		std::vector<uint32_t>				m_corners;			// triangles, vertex of each corner
+		std::vector<int>					m_subMesh;
+		std::vector<bool>					m_triangleRemoved;
+		uint32_t							m_liveTriangles = 0;
+
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_queue;
+
+		// CanCollapse, read by Apply
+		std::vector<uint32_t>						m_edgeTriangles;
+		std::vector<std::pair<uint32_t, uint32_t>>	m_wedgeMap;			// wedge of u -> wedge of v
+		std::vector<int>							m_edgeSubMeshes;
+		std::vector<std::pair<uint32_t, int>>		m_neighbors;		// point, number of triangles of the edge
+		std::vector<uint32_t>						m_opposite;
+	};
+
+
+	// Real-Time Collision Detection, 5.1.5
+	Vector3 ClosestPointOnTriangle(Vector3 const & p, Vector3 const & a, Vector3 const & b, Vector3 const & c)
+	{
+		auto ab = b - a, ac = c - a, ap = p - a;
+		float d1 = Vector3::Dot(ab, ap), d2 = Vector3::Dot(ac, ap);
+		if (d1 <= 0 && d2 <= 0)
+			return a;
+		auto bp = p - b;
+		float d3 = Vector3::Dot(ab, bp), d4 = Vector3::Dot(ac, bp);
+		if (d3 >= 0 && d4 <= d3)
+			return b;
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0 && d1 >= 0 && d3 <= 0)
+			return a + ab * (d1 / (d1 - d3));
+		auto cp = p - c;
+		float d5 = Vector3::Dot(ab, cp), d6 = Vector3::Dot(ac, cp);
+		if (d6 >= 0 && d5 <= d6)
+			return c;
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0 && d2 >= 0 && d6 <= 0)
+			return a + ac * (d2 / (d2 - d6));
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+		float denom = 1.0f / (va + vb + vc);
+		return a + ab * (vb * denom) + ac * (vc * denom);
+	}
+
+
+	// Largest distance from the vertices of the triangles of from to the surface of to.
+	float MaxVertexDistance(MeshGeometry const & from, MeshGeometry const & to)
+	{
+		// uniform grid of the triangles of to
+		Vector3 bmin = from.vertices[0], bmax = from.vertices[0];
+		for (auto const & p : from.vertices)
+		{
+			bmin = Vector3::Min(bmin, p);
+			bmax = Vector3::Max(bmax, p);
+		}
+		for (auto const & p : to.vertices)
+		{
+			bmin = Vector3::Min(bmin, p);
+			bmax = Vector3::Max(bmax, p);
+		}
+		auto extents = bmax - bmin;
+		float maxExtent = std::max(extents.x, std::max(extents.y, extents.z));
+		if (maxExtent <= 0)
+			return 0;
+		// cells about twice the size of the triangles, at most a few cells per triangle
+		const uint32_t triangleCount = to.triangleCount();
+		double area = 0;
+		for (uint32_t t = 0; t < triangleCount; ++t)
+		{
+			auto const & a = to.vertices[to.triangles[t * 3]];
+			auto const & b = to.vertices[to.triangles[t * 3 + 1]];
+			auto const & c = to.vertices[to.triangles[t * 3 + 2]];
+			area += 0.5 * Vector3::Cross(b - a, c - a).magnitude();
+		}
+		float cellSize = std::max(2.0f * static_cast<float>(std::sqrt(area / triangleCount)), maxExtent / 256);
+		int dims[3];
+		const size_t maxCellCount = std::max<size_t>(4096, 8 * triangleCount);
+		while (true)
+		{
+			for (int i = 0; i < 3; ++i)
+				dims[i] = std::min(256, std::max(1, static_cast<int>(std::ceil(extents[i] / cellSize))));
+			if (size_t(dims[0]) * dims[1] * dims[2] <= maxCellCount)
+				break;
+			cellSize *= 1.25f;
+		}
+		auto cellOf = [&](Vector3 const & p, int axis)
+		{
+			int c = static_cast<int>((p[axis] - bmin[axis]) / cellSize);
+			return std::min(dims[axis] - 1, std::max(0, c));
+		};
+		std::vector<std::vector<uint32_t>> cells(dims[0] * dims[1] * dims[2]);
+		for (uint32_t t = 0; t < triangleCount; ++t)
+		{
+			auto const & a = to.vertices[to.triangles[t * 3]];
+			auto const & b = to.vertices[to.triangles[t * 3 + 1]];
+			auto const & c = to.vertices[to.triangles[t * 3 + 2]];
+			auto tmin = Vector3::Min(a, Vector3::Min(b, c));
+			auto tmax = Vector3::Max(a, Vector3::Max(b, c));
+			for (int z = cellOf(tmin, 2); z <= cellOf(tmax, 2); ++z)
+				for (int y = cellOf(tmin, 1); y <= cellOf(tmax, 1); ++y)
+					for (int x = cellOf(tmin, 0); x <= cellOf(tmax, 0); ++x)
+						cells[(z * dims[1] + y) * dims[0] + x].push_back(t);
+		}
+		const int maxRing = std::max(dims[0], std::max(dims[1], dims[2]));
+
+		float maxDistance2 = 0;
+		std::vector<bool> used(from.vertices.size(), false);
+		for (auto i : from.triangles)
+			used[i] = true;
+		for (size_t i = 0; i < from.vertices.size(); ++i)
+		{
+			if (!used[i])
+				continue;
+			auto const & p = from.vertices[i];
+			int c[3] = { cellOf(p, 0), cellOf(p, 1), cellOf(p, 2) };
+			float best2 = Mathf::Infinity;
+			// rings of cells around p, until the closest triangle is closer than the next ring
+			for (int r = 0; r <= maxRing; ++r)
+			{
+				for (int z = std::max(0, c[2] - r); z <= std::min(dims[2] - 1, c[2] + r); ++z)
+				{
+					for (int y = std::max(0, c[1] - r); y <= std::min(dims[1] - 1, c[1] + r); ++y)
+					{
+						for (int x = std::max(0, c[0] - r); x <= std::min(dims[0] - 1, c[0] + r); ++x)
+						{
+							if (std::max(std::abs(x - c[0]), std::max(std::abs(y - c[1]), std::abs(z - c[2]))) != r)
+								continue;
+							for (auto t : cells[(z * dims[1] + y) * dims[0] + x])
+							{
+								auto q = ClosestPointOnTriangle(p,
+									to.vertices[to.triangles[t * 3]],
+									to.vertices[to.triangles[t * 3 + 1]],
+									to.vertices[to.triangles[t * 3 + 2]]);
+								best2 = std::min(best2, Vector3::DistanceSquared(p, q));
+							}
+						}
+					}
+				}
+				// distance from p to the cells not searched yet, none beyond the sides of the grid
+				float reach = Mathf::Infinity;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					if (c[axis] - r > 0)
+						reach = std::min(reach, p[axis] - (bmin[axis] + (c[axis] - r) * cellSize));
+					if (c[axis] + r < dims[axis] - 1)
+						reach = std::min(reach, bmin[axis] + (c[axis] + r + 1) * cellSize - p[axis]);
+				}
+				if (best2 <= reach * reach)
+					break;
+			}
+			maxDistance2 = std::max(maxDistance2, best2);
+		}
+		return std::sqrt(maxDistance2);
+	}
+}
+
+
+namespace FishEngine
+{
+	constexpr float MeshSimplifier::MaxBoneWeightDifference;
+
+	MeshGeometry MeshSimplifier::Simplify(MeshGeometry const & source, uint32_t targetTriangleCount)
+	{
+		Simplifier simplifier(source);
+		simplifier.Run(targetTriangleCount);
+		return simplifier.Result();
+	}
+
+
+	float MeshSimplifier::GeometricError(MeshGeometry const & reference, MeshGeometry const & simplified)
+	{
+		if (reference.triangles.empty() || simplified.triangles.empty())
+			return 0;
+		// both ways: a hole closed by the simplification is far from the reference vertices, a part of the
+		// reference removed (or pulled away) is far from the simplified vertices
+		return std::max(MaxVertexDistance(reference, simplified), MaxVertexDistance(simplified, reference));
+	}
+}
@@ -0,0 +1,280 @@
+#include <FishEngine/MeshletUtility.hpp>
+#include <FishEngine/Camera.hpp>
+#include <FishEngine/GeometryUtility.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <algorithm>
+
+namespace FishEngine
+{
+	constexpr uint32_t MeshletUtility::MaxVertices;
+	constexpr uint32_t MeshletUtility::MaxTriangles;
+	constexpr uint32_t MeshletUtility::MinTriangleCount;
+
+	MeshletUtility::View MeshletUtility::LocalView(const Vector4 worldPlanes[6], Camera const & camera, const Matrix4x4 & localToWorld, bool backfaceCulling)
+	{
+		View view;
+		// dot(plane, localToWorld * p) = dot(transpose(localToWorld) * plane, p)
+		auto transposed = localToWorld.transpose();
+		for (int i = 0; i < 6; ++i)
+			view.planes[i] = transposed * worldPlanes[i];
+
+		auto worldToLocal = localToWorld.inverse();
+		view.orthographic = camera.orghographic();
+		view.eye = worldToLocal.MultiplyPoint(camera.transform()->position());
+		view.direction = worldToLocal.MultiplyVector(camera.transform()->forward()).normalized();
+
+		// the cones are in the local space, they are valid in world space for a similarity keeping the winding
+		Vector3 axes[3];
+		for (int i = 0; i < 3; ++i)
+			axes[i] = localToWorld.GetColumn(i);
+		float scale = axes[0].magnitude();
+		constexpr float tolerance = 1e-3f;
+		bool similarity = scale > 0;
+		for (int i = 0; i < 3 && similarity; ++i)
+		{
+			similarity = std::abs(axes[i].magnitude() - scale) <= tolerance * scale
+				&& std::abs(Vector3::Dot(axes[i], axes[(i + 1) % 3])) <= tolerance * scale * scale;
+		}
+		view.coneCulling = backfaceCulling && similarity && localToWorld.determinant() > 0;
+		return view;
+	}
+
+
+	bool MeshletUtility::Build(Mesh & mesh)
+	{
+		if (mesh.m_uploaded || mesh.m_skinned || mesh.m_triangles.size() / 3 < MinTriangleCount)
+			return false;
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> offsets;
+		for (int s = 0; s < mesh.m_subMeshCount; ++s)
+		{
+			offsets.push_back(static_cast<uint32_t>(meshlets.size()));
+			Build(mesh.m_vertices, mesh.m_triangles, { mesh.GetIndexStart(s), mesh.GetIndexCount(s) }, meshlets);
+		}
+		offsets.push_back(static_cast<uint32_t>(meshlets.size()));
+
+		// the cones are around cross(p1 - p0, p2 - p0); if the normals of the mesh point the other way, so do the front faces
+		if (mesh.m_normals.size() == mesh.m_vertices.size())
+		{
+			double agreement = 0;
+			auto const & v = mesh.m_vertices;
+			auto const & n = mesh.m_normals;
+			auto const & t = mesh.m_triangles;
+			for (size_t i = 0; i + 2 < t.size(); i += 3)
+			{
+				auto face = Vector3::Cross(v[t[i+1]] - v[t[i]], v[t[i+2]] - v[t[i]]);
+				agreement += Vector3::Dot(face, n[t[i]] + n[t[i+1]] + n[t[i+2]]);
+			}
+			if (agreement < 0)
+			{
+				for (auto & m : meshlets)
+					m.coneAxis = -m.coneAxis;
+			}
+		}
+		mesh.m_meshlets = std::move(meshlets);
+		mesh.m_meshletOffsets = std::move(offsets);
+		return true;
+	}
+
+
+	// Greedy clustering: a meshlet grows by the triangle sharing the most vertices with it, the closest one to its
+	// center on ties, among the triangles adjacent to it; it is full at MaxVertices or MaxTriangles. The next meshlet
+	// starts next to the previous one, or at the first triangle left.
+	void MeshletUtility::Build(std::vector<Vector3> const & vertices, std::vector<uint32_t> & triangles, IndexRange range, std::vector<Meshlet> & meshlets)
+	{
+		const uint32_t triangleCount = range.count / 3;
+		if (triangleCount == 0)
+			return;
+		const uint32_t* source = triangles.data() + range.start;
+
+		// vertex -> triangles, with the vertices renumbered from 0 in the range
+		std::vector<uint32_t> local(vertices.size(), UINT32_MAX);
+		std::vector<uint32_t> corners(range.count);
+		uint32_t localCount = 0;
+		for (uint32_t i = 0; i < range.count; ++i)
+		{
+			auto & l = local[source[i]];
+			if (l == UINT32_MAX)
+				l = localCount++;
+			corners[i] = l;
+		}
+		std::vector<uint32_t> adjacencyOffsets(localCount + 1, 0);
+		for (auto c : corners)
+			adjacencyOffsets[c + 1]++;
+		for (uint32_t v = 0; v < localCount; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		std::vector<uint32_t> adjacency(range.count);
+		{
+			auto fill = adjacencyOffsets;
+			for (uint32_t i = 0; i < range.count; ++i)
+				adjacency[fill[corners[i]]++] = i / 3;
+		}
+
+		std::vector<Vector3> centroids(triangleCount);
+		for (uint32_t t = 0; t < triangleCount; ++t)
+			centroids[t] = (vertices[source[t * 3]] + vertices[source[t * 3 + 1]] + vertices[source[t * 3 + 2]]) / 3.0f;
+
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> candidateStamp(triangleCount, UINT32_MAX);
+		std::vector<uint32_t> vertexStamp(localCount, UINT32_MAX);
+		std::vector<uint32_t> order;
+		order.reserve(triangleCount);
+		std::vector<uint32_t> candidates;
+		std::vector<uint32_t> meshletVertices;
+		uint32_t cursor = 0;
+
+		for (uint32_t id = 0; order.size() < triangleCount; ++id)
+		{
+			uint32_t seed = UINT32_MAX;
+			for (auto c : candidates)
+			{
+				if (!emitted[c])
+				{
+					seed = c;
+					break;
+				}
+			}
+			if (seed == UINT32_MAX)
+			{
+				while (emitted[cursor])
+					cursor++;
+				seed = cursor;
+			}
+			candidates.clear();
+			meshletVertices.clear();
+			const uint32_t first = static_cast<uint32_t>(order.size());
+			Vector3 centroidSum = Vector3::zero;
+
+			auto add = [&](uint32_t t)
+			{
+				emitted[t] = true;
+				order.push_back(t);
+				centroidSum += centroids[t];
+				for (int k = 0; k < 3; ++k)
+				{
+					uint32_t v = corners[t * 3 + k];
+					if (vertexStamp[v] == id)
+						continue;
+					vertexStamp[v] = id;
+					meshletVertices.push_back(source[t * 3 + k]);
+					for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+					{
+						uint32_t u = adjacency[a];
+						if (!emitted[u] && candidateStamp[u] != id)
+						{
+							candidateStamp[u] = id;
+							candidates.push_back(u);
+						}
+					}
+				}
+			};
+
+			add(seed);
+			while (order.size() - first < MaxTriangles)
+			{
+				auto center = centroidSum / static_cast<float>(order.size() - first);
+				uint32_t best = UINT32_MAX;
+				int bestNewVertices = 4;
+				float bestDistance = 0;
+				size_t live = 0;
+				for (auto c : candidates)
+				{
+					if (emitted[c])
+						continue;
+					candidates[live++] = c;
+					int newVertices = 0;
+					for (int k = 0; k < 3; ++k)
+						newVertices += vertexStamp[corners[c * 3 + k]] != id;
+					if (meshletVertices.size() + newVertices > MaxVertices)
+						continue;
+					float distance = Vector3::SqrMagnitude(centroids[c] - center);
+					if (newVertices < bestNewVertices || (newVertices == bestNewVertices && distance < bestDistance))
+					{
+						best = c;
+						bestNewVertices = newVertices;
+						bestDistance = distance;
+					}
+				}
+				candidates.resize(live);
+				if (best == UINT32_MAX)
+					break;
+				add(best);
+			}
+
+			// bounds: sphere around the box of the vertices, cone around the normals of the triangles
+			Meshlet m;
+			m.indices = { range.start + first * 3, static_cast<uint32_t>(order.size() - first) * 3 };
+			m.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+			Bounds box;
+			for (auto v : meshletVertices)
+				box.Encapsulate(vertices[v]);
+			m.center = box.center();
+			float radius2 = 0;
+			for (auto v : meshletVertices)
+				radius2 = std::max(radius2, Vector3::SqrMagnitude(vertices[v] - m.center));
+			m.radius = std::sqrt(radius2);
+
+			std::vector<Vector3> normals;
+			normals.reserve(order.size() - first);
+			Vector3 axis = Vector3::zero;
+			for (size_t i = first; i < order.size(); ++i)
+			{
+				auto t = order[i];
+				auto const & p0 = vertices[source[t * 3]];
+				auto n = Vector3::Cross(vertices[source[t * 3 + 1]] - p0, vertices[source[t * 3 + 2]] - p0);
+				float length = n.magnitude();
+				if (length <= 0)
+					continue;	// degenerate, never rasterized
+				normals.push_back(n / length);
+				axis += normals.back();
+			}
+			float axisLength = axis.magnitude();
+			m.coneAxis = axisLength > 0 ? axis / axisLength : Vector3::zero;
+			float minDot = axisLength > 0 ? 1.0f : -1.0f;
+			for (auto const & n : normals)
+				minDot = std::min(minDot, Vector3::Dot(n, m.coneAxis));
+			// the normals are within acos(minDot) of the axis: the meshlet is backfacing when the view direction is
+			// within 90 - acos(minDot) degrees of the axis, cos(90 - acos(minDot)) = sqrt(1 - minDot^2)
+			m.coneCutoff = minDot <= 0 ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+			meshlets.push_back(m);
+		}
+
+		std::vector<uint32_t> sorted(range.count);
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			for (int k = 0; k < 3; ++k)
+				sorted[i * 3 + k] = source[order[i] * 3 + k];
+		}
+		std::copy(sorted.begin(), sorted.end(), triangles.begin() + range.start);
+	}
+
+
+	bool MeshletUtility::IsBackfacing(Meshlet const & meshlet, View const & view)
+	{
+		if (!view.coneCulling || meshlet.coneCutoff >= 1.0f)
+			return false;
+		if (view.orthographic)
+			return Vector3::Dot(view.direction, meshlet.coneAxis) >= meshlet.coneCutoff;
+		// the cone test with the direction to every point of the bounding sphere (Zeux, meshoptimizer)
+		auto d = meshlet.center - view.eye;
+		return Vector3::Dot(d, meshlet.coneAxis) >= meshlet.coneCutoff * d.magnitude() + meshlet.radius;
+	}
+
+
+	uint32_t MeshletUtility::Cull(const Meshlet* first, const Meshlet* last, View const & view, std::vector<IndexRange> & visible)
+	{
+		uint32_t triangleCount = 0;
+		for (auto m = first; m != last; ++m)
+		{
+			if (!GeometryUtility::TestPlanesSphere(view.planes, m->center, m->radius) || IsBackfacing(*m, view))
+				continue;
+			triangleCount += m->indices.count / 3;
+			if (!visible.empty() && visible.back().start + visible.back().count == m->indices.start)
+				visible.back().count += m->indices.count;
+			else
+				visible.push_back(m->indices);
+		}
+		return triangleCount;
+	}
+}
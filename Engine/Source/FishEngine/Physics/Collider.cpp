@@ -15,6 +15,7 @@ namespace FishEngine
 	{
 		//m_physxShape = gPhysics->createShape(PxSphereGeometry(m_radius), *gMaterial);
 		CreatePhysicsShape();
+		UpdateFilterData();
 		auto rigidbody = gameObject()->GetComponent<Rigidbody>();
 		if (rigidbody == nullptr)
 		{
@@ -29,4 +30,14 @@ namespace FishEngine
 //            rigidbody->Initialize(m_physxShape);
 //        }
 	}
+	
+	void Collider::UpdateFilterData()
+	{
+		if (m_physxShape == nullptr)
+			return;
+		m_physxShape->setSimulationFilterData(PhysicsSystem::LayerFilterData(gameObject()->layer()));
+		auto actor = m_physxShape->getActor();
+		if (actor != nullptr)
+			gScene->resetFiltering(*actor);
+	}
 }
@@ -1,6 +1,7 @@
 #include <FishEngine/PhysicsSystem.hpp>
 #include <FishEngine/Transform.hpp>
 #include <FishEngine/Debug.hpp>
+#include <FishEngine/FrameRecorder.hpp>
 //#include <SnippetCommon/SnippetPrint.h>
 //#include <SnippetCommon/SnippetPVD.h>
 //#include <SnippetUtils/SnippetUtils.h>
@@ -53,6 +54,13 @@ PxPvd * gPvd = NULL;
 
 #define PVD_HOST "localhost"
 
+std::array<uint32_t, 32> FishEngine::PhysicsSystem::s_layerCollisionMatrix = []()
+{
+	std::array<uint32_t, 32> matrix;
+	matrix.fill(0xffffffffu);
+	return matrix;
+}();
+
 void FishEngine::PhysicsSystem::Init()
 {
 	static PxDefaultAllocator		gAllocator;
@@ -86,8 +94,13 @@ void FishEngine::PhysicsSystem::Init()
 	sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
 	gDispatcher = PxDefaultCpuDispatcherCreate(2);
 	sceneDesc.cpuDispatcher	= gDispatcher;
-	sceneDesc.filterShader	= PxDefaultSimulationFilterShader;
+	sceneDesc.filterShader	= FishEngine::PhysicsSystem::SimulationFilterShader;
 	//sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVETRANSFORMS;
+	if (FrameRecorder::isRecording() || FrameRecorder::isReplaying())
+	{
+		// replays must not depend on the order actors were inserted into the broadphase
+		sceneDesc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+	}
 	gScene = gPhysics->createScene(sceneDesc);
 	
 	gMaterial = gPhysics->createMaterial(0.5f, 0.5f, 0.6f);
@@ -102,6 +115,7 @@ void FishEngine::PhysicsSystem::FixedUpdate()
 void FishEngine::PhysicsSystem::Clean()
 {
 	gScene->release();
+	gScene = nullptr;	// RefreshFilterData
 	gDispatcher->release();
 	//PxProfileZoneManager* profileZoneManager = gPhysics->getProfileZoneManager();
 //	if(gConnection != NULL)
@@ -114,3 +128,96 @@ void FishEngine::PhysicsSystem::Clean()
 	
 	LogInfo("Clean up PhysX.");
 }
+
+
+void FishEngine::PhysicsSystem::IgnoreLayerCollision(int layer1, int layer2, bool ignore)
+{
+	if (layer1 < 0 || layer1 > 31 || layer2 < 0 || layer2 > 31)
+	{
+		LogError(Format("PhysicsSystem::IgnoreLayerCollision: invalid layer(%d, %d)", layer1, layer2));
+		return;
+	}
+	const uint32_t bit1 = 1u << layer1;
+	const uint32_t bit2 = 1u << layer2;
+	if (ignore)
+	{
+		s_layerCollisionMatrix[layer1] &= ~bit2;
+		s_layerCollisionMatrix[layer2] &= ~bit1;
+	}
+	else
+	{
+		s_layerCollisionMatrix[layer1] |= bit2;
+		s_layerCollisionMatrix[layer2] |= bit1;
+	}
+	RefreshFilterData();
+}
+
+bool FishEngine::PhysicsSystem::GetIgnoreLayerCollision(int layer1, int layer2)
+{
+	if (layer1 < 0 || layer1 > 31 || layer2 < 0 || layer2 > 31)
+		return false;
+	return (s_layerCollisionMatrix[layer1] & (1u << layer2)) == 0;
+}
+
+uint32_t FishEngine::PhysicsSystem::GetLayerCollisionMask(int layer)
+{
+	if (layer < 0 || layer > 31)
+		return 0xffffffffu;
+	return s_layerCollisionMatrix[layer];
+}
+
+PxFilterData FishEngine::PhysicsSystem::LayerFilterData(int layer)
+{
+	PxFilterData data;
+	if (layer >= 0 && layer <= 31)
+	{
+		data.word0 = 1u << layer;
+		data.word1 = s_layerCollisionMatrix[layer];
+		data.word2 = static_cast<PxU32>(layer);
+	}
+	return data;
+}
+
+PxFilterFlags FishEngine::PhysicsSystem::SimulationFilterShader(
+	PxFilterObjectAttributes attributes0, PxFilterData filterData0,
+	PxFilterObjectAttributes attributes1, PxFilterData filterData1,
+	PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize)
+{
+	// called by the broadphase for every new pair, so the ignored pairs never reach narrowphase
+	if (!ShouldCollide(filterData0, filterData1))
+		return PxFilterFlag::eKILL;
+
+	if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1))
+	{
+		pairFlags = PxPairFlag::eTRIGGER_DEFAULT;
+		return PxFilterFlag::eDEFAULT;
+	}
+	pairFlags = PxPairFlag::eCONTACT_DEFAULT;
+	return PxFilterFlag::eDEFAULT;
+}
+
+void FishEngine::PhysicsSystem::RefreshFilterData()
+{
+	if (gScene == nullptr)
+		return;
+	
+	const auto types = PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC;
+	std::vector<PxActor*> actors(gScene->getNbActors(types));
+	gScene->getActors(types, actors.data(), static_cast<PxU32>(actors.size()));
+	std::vector<PxShape*> shapes;
+	for (auto actor : actors)
+	{
+		auto rigidActor = static_cast<PxRigidActor*>(actor);
+		shapes.resize(rigidActor->getNbShapes());
+		rigidActor->getShapes(shapes.data(), static_cast<PxU32>(shapes.size()));
+		for (auto shape : shapes)
+		{
+			auto data = shape->getSimulationFilterData();
+			if (data.word0 == 0)
+				continue;
+			shape->setSimulationFilterData(LayerFilterData(static_cast<int>(data.word2)));
+		}
+		// existing pairs have been filtered with the old matrix
+		gScene->resetFiltering(*actor);
+	}
+}
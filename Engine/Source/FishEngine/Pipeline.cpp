@@ -11,6 +11,8 @@
 #include <FishEngine/RenderTexture.hpp>
 #include <FishEngine/RenderTarget.hpp>
 #include <FishEngine/QualitySettings.hpp>
+#include <FishEngine/RenderSettings.hpp>
+#include <FishEngine/Cubemap.hpp>
 
 namespace FishEngine
 {
@@ -22,6 +24,7 @@ namespace FishEngine
 	std::stack<RenderTargetPtr> Pipeline::s_renderTargetStack;
 
 	PerCameraUniforms   Pipeline::s_perCameraUniforms;
+	std::stack<PerCameraUniforms> Pipeline::s_cameraStack;
 
 	unsigned int        Pipeline::s_perCameraUBO = 0;
 	unsigned int        Pipeline::s_perDrawUBO = 0;
@@ -39,26 +42,27 @@ namespace FishEngine
 
 	void Pipeline::BindCamera(const CameraPtr& camera)
 	{
-		auto const & proj = camera->projectionMatrix();
-		auto const & view = camera->worldToCameraMatrix();
+		BindCamera(camera->projectionMatrix(), camera->worldToCameraMatrix(), camera->nearClipPlane(), camera->farClipPlane());
+	}
+
+	void Pipeline::BindCamera(const Matrix4x4& proj, const Matrix4x4& view, float near, float far)
+	{
 		s_perCameraUniforms.MATRIX_P = proj;
 		s_perCameraUniforms.MATRIX_V = view;
 		s_perCameraUniforms.MATRIX_I_V = view.inverse();
 		s_perCameraUniforms.MATRIX_VP = proj * view;
 
-		s_perCameraUniforms.WorldSpaceCameraPos = Vector4(camera->transform()->position(), 1);
-		s_perCameraUniforms.WorldSpaceCameraDir = Vector4(camera->transform()->forward(), 0);
+		auto const & cameraToWorld = s_perCameraUniforms.MATRIX_I_V;
+		s_perCameraUniforms.WorldSpaceCameraPos = Vector4(cameraToWorld.MultiplyPoint(Vector3::zero), 1);
+		s_perCameraUniforms.WorldSpaceCameraDir = Vector4(cameraToWorld.MultiplyVector(Vector3::forward).normalized(), 0);
 
 		float t = Time::time();
 		s_perCameraUniforms.Time = Vector4(t / 20.f, t, t*2.f, t*3.f);
 
-		float far = camera->farClipPlane();
-		float near = camera->nearClipPlane();
-
 		s_perCameraUniforms.ProjectionParams.x = 1.0f;
-		s_perCameraUniforms.ProjectionParams.y = camera->nearClipPlane();
-		s_perCameraUniforms.ProjectionParams.z = camera->farClipPlane();
-		s_perCameraUniforms.ProjectionParams.w = 1.0f / camera->farClipPlane();
+		s_perCameraUniforms.ProjectionParams.y = near;
+		s_perCameraUniforms.ProjectionParams.z = far;
+		s_perCameraUniforms.ProjectionParams.w = 1.0f / far;
 
 		s_perCameraUniforms.ScreenParams.x = static_cast<float>(Screen::width());
 		s_perCameraUniforms.ScreenParams.y = static_cast<float>(Screen::height());
@@ -70,6 +74,24 @@ namespace FishEngine
 		s_perCameraUniforms.ZBufferParams.z = s_perCameraUniforms.ZBufferParams.x / far;
 		s_perCameraUniforms.ZBufferParams.w = s_perCameraUniforms.ZBufferParams.y / far;
 
+		UploadPerCameraUniforms();
+	}
+
+	void Pipeline::PushCamera()
+	{
+		s_cameraStack.push(s_perCameraUniforms);
+	}
+
+	void Pipeline::PopCamera()
+	{
+		assert(!s_cameraStack.empty());
+		s_perCameraUniforms = s_cameraStack.top();
+		s_cameraStack.pop();
+		UploadPerCameraUniforms();
+	}
+
+	void Pipeline::UploadPerCameraUniforms()
+	{
 		glBindBuffer(GL_UNIFORM_BUFFER, s_perCameraUBO);
 		//auto size = sizeof(perFrameUniformData);
 		glBufferData(GL_UNIFORM_BUFFER, sizeof(s_perCameraUniforms), (void*)&s_perCameraUniforms, GL_DYNAMIC_DRAW);
@@ -119,7 +141,7 @@ namespace FishEngine
 		return outLightShadowData;
 	}
 
-	void Pipeline::BindLight(const LightPtr& light)
+	void Pipeline::BindLight(const LightPtr& light, const CameraPtr& camera)
 	{
 		s_lightingUniforms.LightColor = light->m_color;
 		s_lightingUniforms.WorldSpaceLightPos = Vector4(-light->transform()->forward(), 0);
@@ -127,7 +149,7 @@ namespace FishEngine
 		s_lightingUniforms.CascadesFar = light->m_cascadesFar;
 		s_lightingUniforms.CascadesSplitPlaneNear = light->m_cascadesSplitPlaneNear;
 		s_lightingUniforms.CascadesSplitPlaneFar = light->m_cascadesSplitPlaneFar;
-		s_lightingUniforms._LightShadowData = CalculateShadowFade(Camera::main(), light->m_shadowStrength);
+		s_lightingUniforms._LightShadowData = CalculateShadowFade(camera, light->m_shadowStrength);
 		s_lightingUniforms.fish_LightShadowBias.x = light->m_shadowBias;
 		s_lightingUniforms.fish_LightShadowBias.y = 1;
 		s_lightingUniforms.fish_LightShadowBias.z = light->m_shadowNormalBias;
@@ -139,6 +161,18 @@ namespace FishEngine
 			s_lightingUniforms.LightMatrix[i] = s_lightingUniforms.LightMatrix[i].transpose();
 		}
 
+		auto ambient = As<Cubemap>(RenderSettings::ambientCubemap());
+		if (ambient != nullptr && ambient->isPrefiltered())
+		{
+			for (int i = 0; i < 9; ++i)
+				s_lightingUniforms.AmbientSH[i] = Vector4(ambient->irradiance().coefficients[i], 0);
+			s_lightingUniforms.AmbientCubemapParams = Vector4(static_cast<float>(ambient->mipmapCount()), 0, 0, 0);
+		}
+		else
+		{
+			s_lightingUniforms.AmbientCubemapParams = Vector4(0, 0, 0, 0);
+		}
+
 		glBindBuffer(GL_UNIFORM_BUFFER, s_lightingUBO);
 		//auto size = sizeof(perFrameUniformData);
 		glBufferData(GL_UNIFORM_BUFFER, sizeof(s_lightingUniforms), (void*)&s_lightingUniforms, GL_DYNAMIC_DRAW);
@@ -35,6 +35,8 @@ namespace FishEngine
 
 	float QualitySettings::m_shadowNearPlaneOffset = 2.0f;
 
+	float QualitySettings::s_lodErrorThreshold = 1.0f;
+
 }
 
 
@@ -0,0 +1,30 @@
+#include <FishEngine/Random.hpp>
+
+namespace FishEngine
+{
+	uint32_t		Random::s_seed = 5489u;
+	std::mt19937	Random::s_engine(5489u);
+
+	void Random::InitState(uint32_t seed)
+	{
+		s_seed = seed;
+		s_engine.seed(seed);
+	}
+
+	float Random::value()
+	{
+		return std::uniform_real_distribution<float>(0.0f, 1.0f)(s_engine);
+	}
+
+	float Random::Range(float min, float max)
+	{
+		return std::uniform_real_distribution<float>(min, max)(s_engine);
+	}
+
+	int Random::Range(int min, int max)
+	{
+		if (max <= min)
+			return min;
+		return std::uniform_int_distribution<int>(min, max - 1)(s_engine);
+	}
+}
@@ -0,0 +1,318 @@
+#include <FishEngine/DepthOnlyRenderer.hpp>
+#include <FishEngine/GeometryPool.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderVariables_gen.hpp>
+#include <FishEngine/Render/RenderQueue.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace FishEngine
+{
+	constexpr float DepthOnlyRenderer::Cutoff;
+
+	DepthOnlyRenderer::Statistics DepthOnlyRenderer::s_statistics;
+
+	namespace
+	{
+		// InstanceRow0Index, InstanceRow1Index, InstanceRow2Index of ShadowDepthCommon.inc
+		constexpr GLuint InstanceRowIndex = 6;
+
+		constexpr uint32_t FloatsPerInstance = 12;
+	}
+
+	DepthOnlyRenderer::~DepthOnlyRenderer()
+	{
+		if (!m_arrays.empty())
+			GeometryPool::InvalidateBinding();
+		for (auto & pair : m_arrays)
+		{
+			glDeleteVertexArrays(1, &pair.second.positionVAO);
+			if (pair.second.uvVAO != 0)
+				glDeleteVertexArrays(1, &pair.second.uvVAO);
+		}
+		if (m_instanceBuffer != 0)
+			glDeleteBuffers(1, &m_instanceBuffer);
+	}
+
+	bool DepthOnlyRenderer::IsCutout(MaterialPtr const & material)
+	{
+		if (material == nullptr || material->mainTexture() == nullptr)
+			return false;
+		int queue = material->renderQueue();
+		return queue >= static_cast<int>(Rendering::RenderQueue::AlphaTest)
+			&& queue < static_cast<int>(Rendering::RenderQueue::Transparent);
+	}
+
+	bool DepthOnlyRenderer::Add(MeshPtr const & mesh, Matrix4x4 const & localToWorld, std::vector<MaterialPtr> const & materials)
+	{
+		if (mesh == nullptr)
+			return false;
+		if (!mesh->m_uploaded && !mesh->m_uploadQueued)
+			mesh->UploadMeshData();
+		if (!mesh->m_uploaded || mesh->m_pool == nullptr)
+		{
+			// queued meshes are not drawn yet (UploadQueue)
+			if (!mesh->m_uploadQueued)
+				s_statistics.rejected++;
+			return mesh->m_uploadQueued;
+		}
+
+		auto index = static_cast<uint32_t>(m_matrices.size() / FloatsPerInstance);
+		for (int row = 0; row < 3; ++row)
+			m_matrices.insert(m_matrices.end(), localToWorld.m[row], localToWorld.m[row] + 4);
+
+		int subMeshCount = static_cast<int>(mesh->subMeshCount());
+		bool uv = (mesh->m_pool->layout() & GeometryPool::UVAttribute) != 0;
+		bool cutout = false;
+		for (int i = 0; uv && i < subMeshCount && i < static_cast<int>(materials.size()); ++i)
+			cutout = cutout || IsCutout(materials[i]);
+		if (!cutout)
+		{
+			m_instances.push_back({ nullptr, mesh.get(), -1, index });
+			return true;
+		}
+		for (int i = 0; i < subMeshCount; ++i)
+		{
+			Material* material = nullptr;
+			if (i < static_cast<int>(materials.size()) && IsCutout(materials[i]))
+				material = materials[i].get();
+			m_instances.push_back({ material, mesh.get(), i, index });
+		}
+		return true;
+	}
+
+	bool DepthOnlyRenderer::Add(MeshPtr const & mesh, std::vector<IndexRange> const & ranges)
+	{
+		if (mesh == nullptr)
+			return false;
+		if (!mesh->m_uploaded && !mesh->m_uploadQueued)
+			mesh->UploadMeshData();
+		if (!mesh->m_uploaded || mesh->m_pool == nullptr)
+		{
+			// queued meshes are not drawn yet (UploadQueue)
+			if (!mesh->m_uploadQueued)
+				s_statistics.rejected++;
+			return mesh->m_uploadQueued;
+		}
+		if (!ranges.empty())
+			m_batches.push_back({ mesh, ranges });
+		return true;
+	}
+
+	void DepthOnlyRenderer::Upload()
+	{
+		// identity first (static batches), then the instances in the order of the groups
+		std::vector<float> data((1 + m_instances.size()) * FloatsPerInstance);
+		auto identity = Matrix4x4::identity;
+		std::memcpy(data.data(), identity.m, FloatsPerInstance * sizeof(float));
+		for (size_t i = 0; i < m_instances.size(); ++i)
+		{
+			std::memcpy(&data[(1 + i) * FloatsPerInstance], &m_matrices[m_instances[i].index * FloatsPerInstance],
+				FloatsPerInstance * sizeof(float));
+		}
+
+		if (m_instanceBuffer == 0)
+			glGenBuffers(1, &m_instanceBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+		auto size = static_cast<GLsizeiptr>(data.size() * sizeof(float));
+		if (size > m_instanceBufferSize)
+			m_instanceBufferSize = std::max(size, m_instanceBufferSize * 2);
+		// orphaned: the draws of the previous frame may still read it
+		glBufferData(GL_ARRAY_BUFFER, m_instanceBufferSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glCheckError();
+	}
+
+	void DepthOnlyRenderer::BindVertexArray(GeometryPool* pool, bool uv, uint32_t instance)
+	{
+		auto & arrays = m_arrays[pool];
+		if (arrays.vertexBuffer != pool->vertexBuffer())
+		{
+			// new, or the pool was reallocated
+			if (arrays.positionVAO == 0)
+			{
+				glGenVertexArrays(1, &arrays.positionVAO);
+				if ((pool->layout() & GeometryPool::UVAttribute) != 0)
+					glGenVertexArrays(1, &arrays.uvVAO);
+			}
+			for (GLuint vao : { arrays.positionVAO, arrays.uvVAO })
+			{
+				if (vao == 0)
+					continue;
+				GeometryPool::BindVertexArray(vao);
+				glBindBuffer(GL_ARRAY_BUFFER, pool->vertexBuffer());
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool->indexBuffer());
+				glVertexAttribPointer(PositionIndex, 3, GL_FLOAT, GL_FALSE, pool->stride(), nullptr);
+				glEnableVertexAttribArray(PositionIndex);
+				if ((pool->layout() & GeometryPool::NormalAttribute) != 0)
+				{
+					// the normal offset
+					glVertexAttribPointer(NormalIndex, 3, GL_FLOAT, GL_FALSE, pool->stride(), (GLvoid*)(3 * sizeof(GLfloat)));
+					glEnableVertexAttribArray(NormalIndex);
+				}
+				if (vao == arrays.uvVAO)
+				{
+					// after the position and the normal
+					uintptr_t offset = ((pool->layout() & GeometryPool::NormalAttribute) != 0 ? 6 : 3) * sizeof(GLfloat);
+					glVertexAttribPointer(UVIndex, 2, GL_FLOAT, GL_FALSE, pool->stride(), (GLvoid*)offset);
+					glEnableVertexAttribArray(UVIndex);
+				}
+				for (GLuint row = 0; row < 3; ++row)
+				{
+					glEnableVertexAttribArray(InstanceRowIndex + row);
+					glVertexAttribDivisor(InstanceRowIndex + row, 1);
+				}
+			}
+			arrays.vertexBuffer = pool->vertexBuffer();
+		}
+
+		GeometryPool::BindVertexArray(uv ? arrays.uvVAO : arrays.positionVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+		for (GLuint row = 0; row < 3; ++row)
+		{
+			uintptr_t offset = (instance * FloatsPerInstance + row * 4) * sizeof(GLfloat);
+			glVertexAttribPointer(InstanceRowIndex + row, 4, GL_FLOAT, GL_FALSE, FloatsPerInstance * sizeof(GLfloat), (GLvoid*)offset);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void DepthOnlyRenderer::Draw(float slopeBias)
+	{
+		if (m_instances.empty() && m_batches.empty())
+			return;
+
+		// opaque first, then by material, pool and mesh: the instances of a mesh are consecutive
+		std::sort(m_instances.begin(), m_instances.end(), [](Instance const & a, Instance const & b)
+		{
+			return std::make_tuple(a.cutout, a.mesh->m_pool, a.mesh, a.subMesh, a.index)
+				< std::make_tuple(b.cutout, b.mesh->m_pool, b.mesh, b.subMesh, b.index);
+		});
+		Upload();
+
+		// the linear bias is in the shaders, and the normal offset for the pools with normals; the others have a slope
+		// scaled polygon offset instead
+		glPolygonOffset(slopeBias, 0);
+		Shader* program = nullptr;
+		int normalOffset = -1;		// of program, -1: not set
+		auto setNormalOffset = [&program, &normalOffset](GeometryPool* pool)
+		{
+			int normals = (pool->layout() & GeometryPool::NormalAttribute) != 0 ? 1 : 0;
+			if (normals == normalOffset)
+				return;
+			program->BindUniformVec4("ShadowDepthNormalOffset", Vector4(static_cast<float>(normals), 0, 0, 0));
+			if (normals != 0)
+				glDisable(GL_POLYGON_OFFSET_FILL);
+			else
+				glEnable(GL_POLYGON_OFFSET_FILL);
+			normalOffset = normals;
+		};
+
+		// the instances [begin, end) of one mesh, at 1 + begin in the instance buffer
+		auto drawGroup = [this, &setNormalOffset](size_t begin, size_t end)
+		{
+			auto const & first = m_instances[begin];
+			auto mesh = first.mesh;
+			auto pool = mesh->m_pool;
+			setNormalOffset(pool);
+			auto const & block = pool->block(mesh->m_poolBlock);
+			uint32_t start = first.subMesh < 0 ? 0 : mesh->GetIndexStart(first.subMesh);
+			uint32_t count = first.subMesh < 0 ? mesh->m_triangleCount * 3 : mesh->GetIndexCount(first.subMesh);
+			BindVertexArray(pool, first.cutout != nullptr, static_cast<uint32_t>(1 + begin));
+			GLvoid* offset = (GLvoid*)((block.firstIndex + start) * sizeof(GLuint));
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, offset,
+				static_cast<GLsizei>(end - begin), static_cast<GLint>(block.baseVertex));
+			s_statistics.drawCalls++;
+			s_statistics.instances += end - begin;
+			if (first.cutout != nullptr)
+				s_statistics.cutoutDrawCalls++;
+		};
+		auto groupEnd = [this](size_t begin)
+		{
+			auto const & first = m_instances[begin];
+			size_t end = begin + 1;
+			while (end < m_instances.size() && m_instances[end].cutout == first.cutout
+				&& m_instances[end].mesh == first.mesh && m_instances[end].subMesh == first.subMesh)
+				end++;
+			return end;
+		};
+
+		auto shader = Shader::FindBuiltin("ShadowDepth");
+		shader->Use();
+		shader->PreRender();
+		program = shader.get();
+		setNormalOffset(m_instances.empty() ? m_batches.front().mesh->m_pool : m_instances.front().mesh->m_pool);
+		shader->CheckStatus();
+		s_statistics.programBinds++;
+
+		size_t i = 0;
+		while (i < m_instances.size() && m_instances[i].cutout == nullptr)
+		{
+			auto end = groupEnd(i);
+			drawGroup(i, end);
+			i = end;
+		}
+
+		// identity: the ranges of the batches are in world space
+		for (auto const & batch : m_batches)
+		{
+			auto pool = batch.mesh->m_pool;
+			auto const & block = pool->block(batch.mesh->m_poolBlock);
+			auto const & ranges = batch.ranges;
+			std::vector<GLsizei> counts(ranges.size());
+			std::vector<const GLvoid*> offsets(ranges.size());
+			std::vector<GLint> baseVertices(ranges.size(), static_cast<GLint>(block.baseVertex));
+			for (size_t r = 0; r < ranges.size(); ++r)
+			{
+				counts[r] = static_cast<GLsizei>(ranges[r].count);
+				offsets[r] = (const GLvoid*)((block.firstIndex + ranges[r].start) * sizeof(GLuint));
+			}
+			setNormalOffset(pool);
+			BindVertexArray(pool, false, 0);
+			glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(),
+				static_cast<GLsizei>(ranges.size()), baseVertices.data());
+			s_statistics.drawCalls++;
+			s_statistics.instances++;
+		}
+		shader->PostRender();
+
+		if (i < m_instances.size())
+		{
+			auto material = Material::builtinMaterial("ShadowDepthCutout");
+			shader = material->shader();
+			shader->Use();
+			shader->PreRender();
+			program = shader.get();
+			normalOffset = -1;
+			setNormalOffset(m_instances[i].mesh->m_pool);
+			s_statistics.programBinds++;
+			while (i < m_instances.size())
+			{
+				// one material: its texture and its alpha, then all its instances
+				auto source = m_instances[i].cutout;
+				material->setMainTexture(source->mainTexture());
+				material->setColor(source->color());
+				material->SetFloat("_Cutoff", Cutoff);
+				material->BindProperties();
+				shader->CheckStatus();
+				while (i < m_instances.size() && m_instances[i].cutout == source)
+				{
+					auto end = groupEnd(i);
+					drawGroup(i, end);
+					i = end;
+				}
+			}
+			shader->PostRender();
+		}
+
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		glCheckError();
+
+		m_instances.clear();
+		m_batches.clear();
+		m_matrices.clear();
+	}
+}
@@ -0,0 +1,401 @@
+#include <FishEngine/Render/EnvironmentFilter.hpp>
+
+#include <FishEngine/Cubemap.hpp>
+#include <FishEngine/Mathf.hpp>
+#include <FishEngine/GLEnvironment.hpp>
+#include <FishEngine/JobSystem.hpp>
+
+#include <cmath>
+
+using namespace FishEngine;
+
+namespace
+{
+	// Calls fn(i) for i in [0, count), on the threads of the JobSystem, one index per chunk.
+	template<class Function>
+	void ParallelFor(int count, Function fn)
+	{
+		JobSystem::ParallelFor(static_cast<size_t>(count), 1, [&fn](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				fn(static_cast<int>(i));
+		});
+	}
+
+	uint32_t ReverseBits(uint32_t Bits)
+	{
+		Bits = (Bits << 16) | (Bits >> 16);
+		Bits = ((Bits & 0x00ff00ff) << 8) | ((Bits & 0xff00ff00) >> 8);
+		Bits = ((Bits & 0x0f0f0f0f) << 4) | ((Bits & 0xf0f0f0f0) >> 4);
+		Bits = ((Bits & 0x33333333) << 2) | ((Bits & 0xcccccccc) >> 2);
+		Bits = ((Bits & 0x55555555) << 1) | ((Bits & 0xaaaaaaaa) >> 1);
+		return Bits;
+	}
+
+	// face and texel coordinates (in [0, 1]) of a direction, see the table of glTexImage2D
+	void DirectionToFace(const Vector3& d, int & face, float & u, float & v)
+	{
+		float ax = std::fabs(d.x), ay = std::fabs(d.y), az = std::fabs(d.z);
+		float sc, tc, ma;
+		if (ax >= ay && ax >= az)
+		{
+			face = d.x > 0 ? 0 : 1;
+			sc = d.x > 0 ? -d.z : d.z;
+			tc = -d.y;
+			ma = ax;
+		}
+		else if (ay >= az)
+		{
+			face = d.y > 0 ? 2 : 3;
+			sc = d.x;
+			tc = d.y > 0 ? d.z : -d.z;
+			ma = ay;
+		}
+		else
+		{
+			face = d.z > 0 ? 4 : 5;
+			sc = d.z > 0 ? d.x : -d.x;
+			tc = -d.y;
+			ma = az;
+		}
+		u = 0.5f * (sc / ma + 1.0f);
+		v = 0.5f * (tc / ma + 1.0f);
+	}
+
+	// mip i + 1 is the 2x2 box filter of mip i
+	std::vector<CubemapImage> BuildMipChain(const CubemapImage& source)
+	{
+		std::vector<CubemapImage> chain;
+		chain.push_back(source);
+		while (chain.back().size > 1)
+		{
+			auto const & src = chain.back();
+			CubemapImage dst;
+			dst.Resize(src.size / 2);
+			for (int face = 0; face < 6; ++face)
+			{
+				for (int y = 0; y < dst.size; ++y)
+				{
+					for (int x = 0; x < dst.size; ++x)
+					{
+						dst.at(face, x, y) = (src.at(face, 2 * x, 2 * y) + src.at(face, 2 * x + 1, 2 * y)
+							+ src.at(face, 2 * x, 2 * y + 1) + src.at(face, 2 * x + 1, 2 * y + 1)) * 0.25f;
+					}
+				}
+			}
+			chain.push_back(std::move(dst));
+		}
+		return chain;
+	}
+
+	Vector3 SampleLevel(const std::vector<CubemapImage>& chain, const Vector3& direction, float level)
+	{
+		level = Mathf::Clamp(level, 0.0f, static_cast<float>(chain.size() - 1));
+		int level0 = static_cast<int>(level);
+		int level1 = Mathf::Min(level0 + 1, static_cast<int>(chain.size() - 1));
+		float t = level - level0;
+		auto c0 = chain[level0].Sample(direction);
+		if (t <= 0 || level0 == level1)
+			return c0;
+		return c0 * (1.0f - t) + chain[level1].Sample(direction) * t;
+	}
+
+	float AreaElement(float x, float y)
+	{
+		return std::atan2(x * y, std::sqrt(x * x + y * y + 1.0f));
+	}
+}
+
+
+void CubemapImage::Resize(int size)
+{
+	this->size = size;
+	for (auto & face : faces)
+		face.assign(size * size, Vector3::zero);
+}
+
+Vector3 CubemapImage::Sample(const Vector3& direction) const
+{
+	int face;
+	float u, v;
+	DirectionToFace(direction, face, u, v);
+	float x = Mathf::Clamp(u * size - 0.5f, 0.0f, size - 1.0f);
+	float y = Mathf::Clamp(v * size - 0.5f, 0.0f, size - 1.0f);
+	int x0 = static_cast<int>(x);
+	int y0 = static_cast<int>(y);
+	int x1 = Mathf::Min(x0 + 1, size - 1);
+	int y1 = Mathf::Min(y0 + 1, size - 1);
+	float tx = x - x0;
+	float ty = y - y0;
+	auto c0 = at(face, x0, y0) * (1.0f - tx) + at(face, x1, y0) * tx;
+	auto c1 = at(face, x0, y1) * (1.0f - tx) + at(face, x1, y1) * tx;
+	return c0 * (1.0f - ty) + c1 * ty;
+}
+
+
+Vector3 EnvironmentFilter::TexelDirection(int face, int size, float x, float y)
+{
+	float s = 2.0f * x / size - 1.0f;
+	float t = 2.0f * y / size - 1.0f;
+	Vector3 d;
+	switch (face)
+	{
+	case 0: d = Vector3(1, -t, -s); break;
+	case 1: d = Vector3(-1, -t, s); break;
+	case 2: d = Vector3(s, 1, t); break;
+	case 3: d = Vector3(s, -1, -t); break;
+	case 4: d = Vector3(s, -t, 1); break;
+	default: d = Vector3(-s, -t, -1); break;
+	}
+	return d.normalized();
+}
+
+float EnvironmentFilter::TexelSolidAngle(int size, int x, int y)
+{
+	// projected area of the texel on the unit sphere
+	float inv = 1.0f / size;
+	float x0 = 2.0f * x * inv - 1.0f;
+	float y0 = 2.0f * y * inv - 1.0f;
+	float x1 = x0 + 2.0f * inv;
+	float y1 = y0 + 2.0f * inv;
+	return AreaElement(x0, y0) - AreaElement(x0, y1) - AreaElement(x1, y0) + AreaElement(x1, y1);
+}
+
+CubemapImage EnvironmentFilter::FromEquirectangular(const Vector3* pixels, int width, int height, int size)
+{
+	CubemapImage image;
+	image.Resize(size);
+	// supersampled 2x2, the panorama has more texels than the faces near the poles
+	ParallelFor(6 * size, [&](int job)
+	{
+		int face = job / size;
+		int y = job % size;
+		for (int x = 0; x < size; ++x)
+		{
+			Vector3 sum = Vector3::zero;
+			for (int sy = 0; sy < 2; ++sy)
+			{
+				for (int sx = 0; sx < 2; ++sx)
+				{
+					auto d = TexelDirection(face, size, x + 0.25f + 0.5f * sx, y + 0.25f + 0.5f * sy);
+					// SkyBox-Panorama.shader: uv = (atan(x, -z) / 2PI + 0.5, acos(y) / PI)
+					float u = Mathf::Atan2(d.x, -d.z) * (0.5f / Mathf::PI) + 0.5f;
+					float v = Mathf::Acos(Mathf::Clamp(d.y, -1.0f, 1.0f)) / Mathf::PI;
+					float px = u * width - 0.5f;
+					float py = Mathf::Clamp(v * height - 0.5f, 0.0f, height - 1.0f);
+					int x0 = static_cast<int>(std::floor(px));
+					int y0 = static_cast<int>(py);
+					float tx = px - x0;
+					float ty = py - y0;
+					int y1 = Mathf::Min(y0 + 1, height - 1);
+					// wraps horizontally
+					int x1 = (x0 + 1 + width) % width;
+					x0 = (x0 + width) % width;
+					auto c0 = pixels[x0 + y0 * width] * (1.0f - tx) + pixels[x1 + y0 * width] * tx;
+					auto c1 = pixels[x0 + y1 * width] * (1.0f - tx) + pixels[x1 + y1 * width] * tx;
+					sum += c0 * (1.0f - ty) + c1 * ty;
+				}
+			}
+			image.at(face, x, y) = sum * 0.25f;
+		}
+	});
+	return image;
+}
+
+int EnvironmentFilter::PrefilteredMipCount(int size)
+{
+	int count = 1;
+	while ((size >> count) >= 4)
+		count++;
+	return count;
+}
+
+float EnvironmentFilter::MipRoughness(int mip, int mipCount)
+{
+	if (mipCount <= 1)
+		return 0;
+	return static_cast<float>(mip) / (mipCount - 1);
+}
+
+std::vector<CubemapImage> EnvironmentFilter::PrefilterSpecular(const CubemapImage& source, int sampleCount)
+{
+	auto chain = BuildMipChain(source);
+	const int mipCount = PrefilteredMipCount(source.size);
+	// solid angle of a texel of the source
+	const float texelSolidAngle = 4.0f * Mathf::PI / (6.0f * source.size * source.size);
+
+	std::vector<CubemapImage> mips(mipCount);
+	mips[0] = source;	// roughness 0: mirror
+
+	struct Sample
+	{
+		Vector3 L;		// tangent space, N = V = (0, 0, 1)
+		float	NoL;
+		float	level;	// in chain
+	};
+
+	for (int mip = 1; mip < mipCount; ++mip)
+	{
+		const float Roughness = MipRoughness(mip, mipCount);
+		const float m = Roughness * Roughness;
+		const float m2 = m * m;
+
+		// the same samples for all the texels: N = V = R
+		std::vector<Sample> samples;
+		for (int i = 0; i < sampleCount; ++i)
+		{
+			float E1 = static_cast<float>(i) / sampleCount;
+			float E2 = static_cast<float>(static_cast<double>(ReverseBits(i)) / static_cast<double>(0x100000000LL));
+			float Phi = 2.0f * Mathf::PI * E1;
+			float CosTheta = Mathf::Sqrt((1.0f - E2) / (1.0f + (m2 - 1.0f) * E2));
+			float SinTheta = Mathf::Sqrt(1.0f - CosTheta * CosTheta);
+			Vector3 H(SinTheta * std::cos(Phi), SinTheta * std::sin(Phi), CosTheta);
+			float NoH = CosTheta;
+			Vector3 L = 2.0f * NoH * H - Vector3(0, 0, 1);
+			float NoL = L.z;
+			if (NoL <= 0)
+				continue;
+			// pdf = D * NoH / (4 * VoH) = D / 4
+			float d = (NoH * m2 - NoH) * NoH + 1.0f;
+			float D = m2 / (Mathf::PI * d * d);
+			float pdf = D * 0.25f;
+			float sampleSolidAngle = 1.0f / (sampleCount * pdf + 1e-6f);
+			float level = Mathf::Max(0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f);
+			samples.push_back({ L, NoL, level });
+		}
+
+		auto & image = mips[mip];
+		image.Resize(Mathf::Max(source.size >> mip, 1));
+		const int size = image.size;
+		ParallelFor(6 * size, [&](int job)
+		{
+			int face = job / size;
+			int y = job % size;
+			for (int x = 0; x < size; ++x)
+			{
+				Vector3 N = TexelDirection(face, size, x + 0.5f, y + 0.5f);
+				// TangentToWorld in MonteCarlo.inc
+				Vector3 UpVector = std::fabs(N.z) < 0.999f ? Vector3(0, 0, 1) : Vector3(1, 0, 0);
+				Vector3 TangentX = Vector3::Cross(UpVector, N).normalized();
+				Vector3 TangentY = Vector3::Cross(N, TangentX);
+
+				Vector3 sum = Vector3::zero;
+				float weight = 0;
+				for (auto const & s : samples)
+				{
+					Vector3 L = TangentX * s.L.x + TangentY * s.L.y + N * s.L.z;
+					sum += SampleLevel(chain, L, s.level) * s.NoL;
+					weight += s.NoL;
+				}
+				image.at(face, x, y) = weight > 0 ? sum / weight : Vector3::zero;
+			}
+		});
+	}
+	return mips;
+}
+
+SphericalHarmonicsL2 EnvironmentFilter::ProjectIrradiance(const CubemapImage& source)
+{
+	// A 2x2 box filter keeps the integral, and SH of band 2 are smooth: 64x64 is plenty.
+	const CubemapImage* image = &source;
+	std::vector<CubemapImage> chain;
+	if (source.size > 64)
+	{
+		chain = BuildMipChain(source);
+		for (auto const & level : chain)
+		{
+			if (level.size <= 64)
+			{
+				image = &level;
+				break;
+			}
+		}
+	}
+	const int size = image->size;
+
+	// one row per job, summed afterwards
+	std::vector<std::array<Vector3, 9>> rows(6 * size);
+	ParallelFor(6 * size, [&](int job)
+	{
+		int face = job / size;
+		int y = job % size;
+		auto & L = rows[job];
+		L.fill(Vector3::zero);
+		for (int x = 0; x < size; ++x)
+		{
+			Vector3 n = TexelDirection(face, size, x + 0.5f, y + 0.5f);
+			Vector3 c = image->at(face, x, y) * TexelSolidAngle(size, x, y);
+			L[0] += c;
+			L[1] += c * n.y;
+			L[2] += c * n.z;
+			L[3] += c * n.x;
+			L[4] += c * (n.x * n.y);
+			L[5] += c * (n.y * n.z);
+			L[6] += c * (3.0f * n.z * n.z - 1.0f);
+			L[7] += c * (n.x * n.z);
+			L[8] += c * (n.x * n.x - n.y * n.y);
+		}
+	});
+
+	std::array<Vector3, 9> L;
+	L.fill(Vector3::zero);
+	for (auto const & row : rows)
+	{
+		for (int i = 0; i < 9; ++i)
+			L[i] += row[i];
+	}
+
+	// Ramamoorthi and Hanrahan, "An Efficient Representation for Irradiance Environment Maps":
+	// E = sum(A_l * L_lm * Y_lm), A_0 = PI, A_1 = 2PI/3, A_2 = PI/4.
+	// L accumulated the polynomials only: each term gets Y_lm's constant twice (projection and evaluation),
+	// and A_l / PI.
+	const float k0 = 0.282095f, k1 = 0.488603f, k2 = 1.092548f, k20 = 0.315392f, k22 = 0.546274f;
+	const float a0 = 1.0f, a1 = 2.0f / 3.0f, a2 = 0.25f;
+	const float scale[9] = {
+		a0 * k0 * k0,
+		a1 * k1 * k1, a1 * k1 * k1, a1 * k1 * k1,
+		a2 * k2 * k2, a2 * k2 * k2, a2 * k20 * k20, a2 * k2 * k2, a2 * k22 * k22,
+	};
+	SphericalHarmonicsL2 sh;
+	for (int i = 0; i < 9; ++i)
+		sh.coefficients[i] = L[i] * scale[i];
+	return sh;
+}
+
+void EnvironmentFilter::Apply(const std::vector<CubemapImage>& mips, const SphericalHarmonicsL2* irradiance, Cubemap& cubemap)
+{
+	cubemap.m_width = mips[0].size;
+	cubemap.m_height = mips[0].size;
+	cubemap.m_format = TextureFormat::RGBAFloat;
+	cubemap.m_mipmapCount = static_cast<uint32_t>(mips.size());
+	for (int face = 0; face < 6; ++face)
+	{
+		auto & levels = cubemap.m_pixels[face];
+		levels.resize(mips.size());
+		for (size_t level = 0; level < mips.size(); ++level)
+		{
+			auto const & src = mips[level].faces[face];
+			auto & dst = levels[level];
+			dst.resize(src.size() * 4 * sizeof(float));
+			auto p = reinterpret_cast<float*>(dst.data());
+			for (auto const & c : src)
+			{
+				*p++ = c.x;
+				*p++ = c.y;
+				*p++ = c.z;
+				*p++ = 1.0f;
+			}
+		}
+	}
+	cubemap.m_prefiltered = irradiance != nullptr;
+	if (irradiance != nullptr)
+		cubemap.m_irradiance = *irradiance;
+
+	// uploaded again on next use
+	if (cubemap.m_GLNativeTexture != 0)
+	{
+		glDeleteTextures(1, &cubemap.m_GLNativeTexture);
+		cubemap.m_GLNativeTexture = 0;
+	}
+	cubemap.m_uploaded = false;
+}
@@ -0,0 +1,439 @@
+#include <FishEngine/GeometryPool.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/ShaderVariables_gen.hpp>
+
+#include <algorithm>
+
+namespace FishEngine
+{
+	constexpr uint32_t RangeAllocator::InvalidOffset;
+
+	RangeAllocator::RangeAllocator(uint32_t capacity)
+	{
+		Grow(capacity);
+	}
+
+	uint32_t RangeAllocator::Allocate(uint32_t size)
+	{
+		assert(size > 0);
+		auto best = m_freeBySize.lower_bound(size);
+		if (best == m_freeBySize.end())
+			return InvalidOffset;
+		uint32_t offset = best->second;
+		uint32_t blockSize = best->first;
+		RemoveFreeBlock(m_free.find(offset));
+		if (blockSize > size)
+			AddFreeBlock(offset + size, blockSize - size);
+		m_allocations.emplace(offset, size);
+		m_used += size;
+		return offset;
+	}
+
+	void RangeAllocator::Free(uint32_t offset)
+	{
+		auto it = m_allocations.find(offset);
+		assert(it != m_allocations.end());
+		uint32_t size = it->second;
+		m_allocations.erase(it);
+		m_used -= size;
+
+		// merge with the free neighbours
+		auto next = m_free.lower_bound(offset);
+		if (next != m_free.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				offset = previous->first;
+				size += previous->second;
+				RemoveFreeBlock(previous);
+			}
+		}
+		if (next != m_free.end() && offset + size == next->first)
+		{
+			size += next->second;
+			RemoveFreeBlock(next);
+		}
+		AddFreeBlock(offset, size);
+	}
+
+	void RangeAllocator::Grow(uint32_t capacity)
+	{
+		if (capacity <= m_capacity)
+			return;
+		uint32_t offset = m_capacity;
+		uint32_t size = capacity - m_capacity;
+		m_capacity = capacity;
+		if (!m_free.empty())
+		{
+			auto last = std::prev(m_free.end());
+			if (last->first + last->second == offset)
+			{
+				offset = last->first;
+				size += last->second;
+				RemoveFreeBlock(last);
+			}
+		}
+		AddFreeBlock(offset, size);
+	}
+
+	uint32_t RangeAllocator::largestFreeBlock() const
+	{
+		return m_freeBySize.empty() ? 0 : std::prev(m_freeBySize.end())->first;
+	}
+
+	void RangeAllocator::AddFreeBlock(uint32_t offset, uint32_t size)
+	{
+		m_free.emplace(offset, size);
+		m_freeBySize.emplace(size, offset);
+	}
+
+	void RangeAllocator::RemoveFreeBlock(std::map<uint32_t, uint32_t>::iterator it)
+	{
+		auto range = m_freeBySize.equal_range(it->second);
+		for (auto s = range.first; s != range.second; ++s)
+		{
+			if (s->second == it->first)
+			{
+				m_freeBySize.erase(s);
+				break;
+			}
+		}
+		m_free.erase(it);
+	}
+
+
+	constexpr uint32_t GeometryPool::NormalAttribute;
+	constexpr uint32_t GeometryPool::UVAttribute;
+	constexpr uint32_t GeometryPool::TangentAttribute;
+	constexpr uint32_t GeometryPool::LayoutCount;
+	constexpr uint32_t GeometryPool::InvalidHandle;
+	constexpr uint32_t GeometryPool::InitialVertexCapacity;
+	constexpr uint32_t GeometryPool::InitialIndexCapacity;
+	constexpr float GeometryPool::DefragmentThreshold;
+	constexpr GLuint GeometryPool::InvalidBinding;
+
+	GLuint GeometryPool::s_boundVertexArray = GeometryPool::InvalidBinding;
+	GeometryPool::Statistics GeometryPool::s_statistics;
+
+	namespace
+	{
+		uint32_t NextCapacity(uint32_t capacity, uint32_t required)
+		{
+			while (capacity < required)
+				capacity *= 2;
+			return capacity;
+		}
+	}
+
+	GeometryPool & GeometryPool::Get(uint32_t layout)
+	{
+		assert(layout < LayoutCount);
+		static GeometryPool* pools[LayoutCount] = {};
+		if (pools[layout] == nullptr)
+			pools[layout] = new GeometryPool(layout);
+		return *pools[layout];
+	}
+
+	uint32_t GeometryPool::LayoutOf(Mesh const & mesh)
+	{
+		auto n = mesh.m_vertices.size();
+		uint32_t layout = 0;
+		if (mesh.m_normals.size() == n)
+			layout |= NormalAttribute;
+		if (mesh.m_uv.size() == n)
+			layout |= UVAttribute;
+		if (mesh.m_tangents.size() == n)
+			layout |= TangentAttribute;
+		return layout;
+	}
+
+	GeometryPool::GeometryPool(uint32_t layout)
+		: m_layout(layout), m_stride(Stride(layout))
+	{
+		glGenVertexArrays(1, &m_VAO);
+		Reallocate(InitialVertexCapacity, InitialIndexCapacity);
+	}
+
+	uint32_t GeometryPool::Stride(uint32_t layout)
+	{
+		uint32_t stride = 3;
+		if (layout & NormalAttribute)
+			stride += 3;
+		if (layout & UVAttribute)
+			stride += 2;
+		if (layout & TangentAttribute)
+			stride += 3;
+		return stride * sizeof(GLfloat);
+	}
+
+	void GeometryPool::Interleave(Mesh const & mesh, uint32_t layout, void* vertices)
+	{
+		auto out = static_cast<GLfloat*>(vertices);
+		for (size_t i = 0; i < mesh.m_vertices.size(); ++i)
+		{
+			auto const & p = mesh.m_vertices[i];
+			*out++ = p.x; *out++ = p.y; *out++ = p.z;
+			if (layout & NormalAttribute)
+			{
+				auto const & n = mesh.m_normals[i];
+				*out++ = n.x; *out++ = n.y; *out++ = n.z;
+			}
+			if (layout & UVAttribute)
+			{
+				auto const & uv = mesh.m_uv[i];
+				*out++ = uv.x; *out++ = uv.y;
+			}
+			if (layout & TangentAttribute)
+			{
+				auto const & t = mesh.m_tangents[i];
+				*out++ = t.x; *out++ = t.y; *out++ = t.z;
+			}
+		}
+	}
+
+	uint32_t GeometryPool::Allocate(Mesh const & mesh)
+	{
+		auto vertexCount = static_cast<uint32_t>(mesh.m_vertices.size());
+		auto indexCount = static_cast<uint32_t>(mesh.m_triangles.size());
+		if (vertexCount == 0 || indexCount == 0)
+			return InvalidHandle;
+		assert(LayoutOf(mesh) == m_layout);
+
+		auto handle = Allocate(vertexCount, indexCount);
+		std::vector<uint8_t> vertices(vertexCount * m_stride);
+		Interleave(mesh, m_layout, vertices.data());
+		Write(handle, vertices.data(), mesh.m_triangles.data());
+		return handle;
+	}
+
+	uint32_t GeometryPool::Allocate(uint32_t vertexCount, uint32_t indexCount)
+	{
+		auto baseVertex = m_vertices.Allocate(vertexCount);
+		auto firstIndex = m_indices.Allocate(indexCount);
+		if (baseVertex == RangeAllocator::InvalidOffset || firstIndex == RangeAllocator::InvalidOffset)
+		{
+			if (baseVertex != RangeAllocator::InvalidOffset)
+				m_vertices.Free(baseVertex);
+			if (firstIndex != RangeAllocator::InvalidOffset)
+				m_indices.Free(firstIndex);
+			// packed, the free space is one block: grow only if it is too small
+			Reallocate(NextCapacity(m_vertices.capacity(), m_vertices.used() + vertexCount),
+				NextCapacity(m_indices.capacity(), m_indices.used() + indexCount));
+			LogInfo(Format("GeometryPool %1%: %2%/%3% vertices, %4%/%5% indices", m_layout,
+				m_vertices.used() + vertexCount, m_vertices.capacity(), m_indices.used() + indexCount, m_indices.capacity()));
+			baseVertex = m_vertices.Allocate(vertexCount);
+			firstIndex = m_indices.Allocate(indexCount);
+		}
+
+		uint32_t handle;
+		if (m_freeHandles.empty())
+		{
+			handle = static_cast<uint32_t>(m_blocks.size());
+			m_blocks.emplace_back();
+		}
+		else
+		{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}
+		auto & b = m_blocks[handle];
+		b.baseVertex = baseVertex;
+		b.vertexCount = vertexCount;
+		b.firstIndex = firstIndex;
+		b.indexCount = indexCount;
+		return handle;
+	}
+
+	void GeometryPool::Write(uint32_t handle, const void* vertices, const void* indices)
+	{
+		auto const & b = m_blocks[handle];
+		// GL_COPY_WRITE_BUFFER: does not change the element buffer of the bound VAO
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(b.baseVertex) * m_stride, GLsizeiptr(b.vertexCount) * m_stride, vertices);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(b.firstIndex) * sizeof(GLuint), GLsizeiptr(b.indexCount) * sizeof(GLuint), indices);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		s_statistics.bufferBinds += 3;
+		glCheckError();
+	}
+
+	void GeometryPool::Copy(uint32_t handle, GLuint buffer, GLintptr vertexOffset, GLintptr indexOffset)
+	{
+		auto const & b = m_blocks[handle];
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, vertexOffset, GLintptr(b.baseVertex) * m_stride,
+			GLsizeiptr(b.vertexCount) * m_stride);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, indexOffset, GLintptr(b.firstIndex) * sizeof(GLuint),
+			GLsizeiptr(b.indexCount) * sizeof(GLuint));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		s_statistics.bufferBinds += 5;
+		glCheckError();
+	}
+
+	void GeometryPool::Free(uint32_t handle)
+	{
+		auto & b = m_blocks[handle];
+		assert(b.vertexCount > 0);
+		m_vertices.Free(b.baseVertex);
+		m_indices.Free(b.firstIndex);
+		b = Block();
+		m_freeHandles.push_back(handle);
+		if (Fragmented())
+			Defragment();
+	}
+
+	void GeometryPool::Read(uint32_t handle, Mesh & mesh) const
+	{
+		auto const & b = m_blocks[handle];
+		std::vector<GLfloat> vertices(b.vertexCount * m_stride / sizeof(GLfloat));
+		mesh.m_triangles.resize(b.indexCount);
+		glBindBuffer(GL_COPY_READ_BUFFER, m_vertexBuffer);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, GLintptr(b.baseVertex) * m_stride, GLsizeiptr(b.vertexCount) * m_stride, vertices.data());
+		glBindBuffer(GL_COPY_READ_BUFFER, m_indexBuffer);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, GLintptr(b.firstIndex) * sizeof(GLuint), GLsizeiptr(b.indexCount) * sizeof(GLuint), mesh.m_triangles.data());
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		s_statistics.bufferBinds += 3;
+		glCheckError();
+
+		mesh.m_vertices.resize(b.vertexCount);
+		mesh.m_normals.resize(m_layout & NormalAttribute ? b.vertexCount : 0);
+		mesh.m_uv.resize(m_layout & UVAttribute ? b.vertexCount : 0);
+		mesh.m_tangents.resize(m_layout & TangentAttribute ? b.vertexCount : 0);
+		auto in = vertices.cbegin();
+		for (uint32_t i = 0; i < b.vertexCount; ++i)
+		{
+			auto & p = mesh.m_vertices[i];
+			p.x = *in++; p.y = *in++; p.z = *in++;
+			if (m_layout & NormalAttribute)
+			{
+				auto & n = mesh.m_normals[i];
+				n.x = *in++; n.y = *in++; n.z = *in++;
+			}
+			if (m_layout & UVAttribute)
+			{
+				auto & uv = mesh.m_uv[i];
+				uv.x = *in++; uv.y = *in++;
+			}
+			if (m_layout & TangentAttribute)
+			{
+				auto & t = mesh.m_tangents[i];
+				t.x = *in++; t.y = *in++; t.z = *in++;
+			}
+		}
+	}
+
+	void GeometryPool::Defragment()
+	{
+		Reallocate(m_vertices.capacity(), m_indices.capacity());
+		s_statistics.defragmentations++;
+	}
+
+	bool GeometryPool::Fragmented() const
+	{
+		return m_vertices.fragmentedSize() > DefragmentThreshold * m_vertices.capacity()
+			|| m_indices.fragmentedSize() > DefragmentThreshold * m_indices.capacity();
+	}
+
+	void GeometryPool::Reallocate(uint32_t vertexCapacity, uint32_t indexCapacity)
+	{
+		GLuint buffers[2];
+		glGenBuffers(2, buffers);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[0]);
+		glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(vertexCapacity) * m_stride, nullptr, GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[1]);
+		glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(indexCapacity) * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+		s_statistics.bufferBinds += 2;
+
+		RangeAllocator vertices(vertexCapacity);
+		RangeAllocator indices(indexCapacity);
+		std::vector<Block*> blocks;
+		for (auto & b : m_blocks)
+		{
+			if (b.vertexCount > 0)
+				blocks.push_back(&b);
+		}
+		if (!blocks.empty())
+		{
+			// in the order of the vertices: the meshes loaded together stay together
+			std::sort(blocks.begin(), blocks.end(), [](Block* a, Block* b) { return a->baseVertex < b->baseVertex; });
+			glBindBuffer(GL_COPY_READ_BUFFER, m_vertexBuffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[0]);
+			for (auto b : blocks)
+			{
+				auto baseVertex = vertices.Allocate(b->vertexCount);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GLintptr(b->baseVertex) * m_stride,
+					GLintptr(baseVertex) * m_stride, GLsizeiptr(b->vertexCount) * m_stride);
+				b->baseVertex = baseVertex;
+			}
+			glBindBuffer(GL_COPY_READ_BUFFER, m_indexBuffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[1]);
+			for (auto b : blocks)
+			{
+				auto firstIndex = indices.Allocate(b->indexCount);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GLintptr(b->firstIndex) * sizeof(GLuint),
+					GLintptr(firstIndex) * sizeof(GLuint), GLsizeiptr(b->indexCount) * sizeof(GLuint));
+				b->firstIndex = firstIndex;
+			}
+			s_statistics.bufferBinds += 4;
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		if (m_vertexBuffer != 0)
+		{
+			glDeleteBuffers(1, &m_vertexBuffer);
+			glDeleteBuffers(1, &m_indexBuffer);
+			s_statistics.reallocations++;
+		}
+		m_vertexBuffer = buffers[0];
+		m_indexBuffer = buffers[1];
+		m_vertices = std::move(vertices);
+		m_indices = std::move(indices);
+		SetupVertexArray();
+		glCheckError();
+	}
+
+	void GeometryPool::SetupVertexArray()
+	{
+		BindVertexArray(m_VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+		s_statistics.bufferBinds += 2;
+
+		auto attribute = [this](GLuint index, bool enabled, GLint size, uintptr_t & offset)
+		{
+			if (!enabled)
+			{
+				glDisableVertexAttribArray(index);
+				return;
+			}
+			glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, m_stride, (GLvoid*)offset);
+			glEnableVertexAttribArray(index);
+			offset += size * sizeof(GLfloat);
+		};
+		uintptr_t offset = 0;
+		attribute(PositionIndex, true, 3, offset);
+		attribute(NormalIndex, (m_layout & NormalAttribute) != 0, 3, offset);
+		attribute(UVIndex, (m_layout & UVAttribute) != 0, 2, offset);
+		attribute(TangentIndex, (m_layout & TangentAttribute) != 0, 3, offset);
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);	// the element buffer stays bound to the VAO
+	}
+
+	void GeometryPool::BindVertexArray(GLuint vao)
+	{
+		if (vao == s_boundVertexArray)
+		{
+			s_statistics.skippedVertexArrayBinds++;
+			return;
+		}
+		glBindVertexArray(vao);
+		s_boundVertexArray = vao;
+		s_statistics.vertexArrayBinds++;
+	}
+}
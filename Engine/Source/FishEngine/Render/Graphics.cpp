@@ -7,8 +7,36 @@
 #include <FishEngine/RenderSettings.hpp>
 #include <FishEngine/RenderSystem.hpp>
 
+namespace
+{
+	using namespace FishEngine;
+
+	ShaderPtr BindMaterial(const MaterialPtr& material)
+	{
+		auto shader = material->shader();
+		if (shader->HasUniform("AmbientCubemap"))
+		{
+			//shader->BindTexture("AmbientCubemap", RenderSettings::ambientCubemap());
+			material->SetTexture("AmbientCubemap", RenderSettings::ambientCubemap());
+		}
+		if (shader->HasUniform("PreIntegratedGF"))
+		{
+			//shader->BindTexture("PreIntegratedGF", RenderSettings::preintegratedGF());
+			material->SetTexture("PreIntegratedGF", RenderSettings::preintegratedGF());
+		}
+
+		shader->Use();
+		shader->PreRender();
+		material->BindProperties();
+		shader->CheckStatus();
+		return shader;
+	}
+}
+
 namespace FishEngine
 {
+	uint64_t Graphics::s_drawCallCount = 0;
+
 	void Graphics::DrawMesh(const MeshPtr& mesh, const Matrix4x4& matrix, const MaterialPtr& material)
 	{
 		Pipeline::UpdatePerDrawUniforms(matrix);
@@ -41,25 +69,27 @@ namespace FishEngine
 		//	//material->DisableKeyword(ShaderKeyword::SkinnedAnimation);
 		//}
 		
-		auto shader = material->shader();
-		if (shader->HasUniform("AmbientCubemap"))
-		{
-			//shader->BindTexture("AmbientCubemap", RenderSettings::ambientCubemap());
-			material->SetTexture("AmbientCubemap", RenderSettings::ambientCubemap());
-		}
-		if (shader->HasUniform("PreIntegratedGF"))
-		{
-			//shader->BindTexture("PreIntegratedGF", RenderSettings::preintegratedGF());
-			material->SetTexture("PreIntegratedGF", RenderSettings::preintegratedGF());
-		}
-
-		
-		shader->Use();
-		shader->PreRender();
-		material->BindProperties();
-		shader->CheckStatus();
+		auto shader = BindMaterial(material);
 		mesh->Render(subMeshIndex);
 		shader->PostRender();
+		s_drawCallCount++;
+	}
+
+	void Graphics::DrawMesh(const MeshPtr& mesh, const MaterialPtr& material, std::vector<IndexRange> const & ranges)
+	{
+		auto shader = BindMaterial(material);
+		mesh->Render(ranges);
+		shader->PostRender();
+		s_drawCallCount++;
 	}
-}
 
+	void Graphics::DrawProcedural(const MaterialPtr& material, unsigned int topology, int vertexCount, int instanceCount)
+	{
+		if (instanceCount <= 0)
+			return;
+		auto shader = BindMaterial(material);
+		glDrawArraysInstanced(topology, 0, vertexCount, instanceCount);
+		shader->PostRender();
+		s_drawCallCount++;
+	}
+}
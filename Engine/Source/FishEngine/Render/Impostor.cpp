@@ -0,0 +1,229 @@
+#include <FishEngine/Impostor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/Pipeline.hpp>
+#include <FishEngine/Graphics.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/MeshRenderer.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/RenderTarget.hpp>
+#include <FishEngine/RenderBuffer.hpp>
+#include <FishEngine/GeometryPool.hpp>
+#include <FishEngine/Bounds.hpp>
+
+namespace FishEngine
+{
+	static_assert(sizeof(Vector3) + sizeof(float) + sizeof(Quaternion) == 32, "Impostor::Instance is uploaded as 2 vec4");
+
+	namespace
+	{
+		struct CacheEntry
+		{
+			MeshPtr						mesh;
+			std::vector<MaterialPtr>	materials;
+			ImpostorUtility::Layout		layout;
+			ImpostorPtr					impostor;
+		};
+
+		std::vector<CacheEntry> s_cache;
+	}
+
+	Impostor::~Impostor()
+	{
+		if (m_instanceBuffer != 0)
+			glDeleteBuffers(1, &m_instanceBuffer);
+		if (m_VAO != 0)
+		{
+			GeometryPool::InvalidateBinding();
+			glDeleteVertexArrays(1, &m_VAO);
+		}
+	}
+
+	void Impostor::WorldBounds(Matrix4x4 const & localToWorld, Vector3 & center, float & radius) const
+	{
+		center = localToWorld.MultiplyPoint(m_center);
+		float scale = std::max({ localToWorld.MultiplyVector(Vector3::right).magnitude(),
+			localToWorld.MultiplyVector(Vector3::up).magnitude(),
+			localToWorld.MultiplyVector(Vector3::forward).magnitude() });
+		radius = m_radius * scale;
+	}
+
+	void Impostor::AddInstance(Vector3 const & center, float radius, Quaternion const & rotation)
+	{
+		m_instances.push_back({ center, radius, rotation });
+	}
+
+	void Impostor::CreateVertexArray()
+	{
+		glGenVertexArrays(1, &m_VAO);
+		glGenBuffers(1, &m_instanceBuffer);
+		GeometryPool::BindVertexArray(m_VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+		// location 0: center, radius; location 1: rotation
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid*)0);
+		glVertexAttribDivisor(0, 1);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid*)offsetof(Instance, rotation));
+		glVertexAttribDivisor(1, 1);
+		glCheckError();
+	}
+
+	void Impostor::DrawInstances()
+	{
+		if (m_instances.empty())
+			return;
+		if (m_VAO == 0)
+			CreateVertexArray();
+		GeometryPool::BindVertexArray(m_VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+		auto count = static_cast<uint32_t>(m_instances.size());
+		if (count > m_instanceCapacity)
+		{
+			m_instanceCapacity = std::max(count, m_instanceCapacity * 2);
+			glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_instanceCapacity) * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(count) * sizeof(Instance), m_instances.data());
+		glCheckError();
+
+		Pipeline::UpdatePerDrawUniforms(Matrix4x4::identity);
+		Graphics::DrawProcedural(m_material, GL_TRIANGLE_STRIP, 4, count);
+		m_instances.clear();
+	}
+
+
+	ImpostorPtr ImpostorBaker::Bake(RendererPtr const & renderer, ImpostorUtility::Layout const & layout)
+	{
+		if (renderer->ClassID() != ClassID<MeshRenderer>())
+			return nullptr;
+		auto meshFilter = renderer->gameObject()->GetComponent<MeshFilter>();
+		if (meshFilter == nullptr || meshFilter->mesh() == nullptr)
+			return nullptr;
+		auto const & mesh = meshFilter->mesh();
+		auto const & materials = renderer->materials();
+
+		for (auto const & entry : s_cache)
+		{
+			if (entry.mesh == mesh && entry.materials == materials && entry.layout == layout)
+				return entry.impostor;
+		}
+
+		auto impostor = std::make_shared<Impostor>();
+		impostor->m_layout = layout;
+		auto bounds = mesh->bounds();
+		impostor->m_center = bounds.center();
+		impostor->m_radius = bounds.extents().magnitude();
+		if (impostor->m_radius <= 0)
+			return nullptr;
+
+		const int size = layout.atlasSize();
+		impostor->m_albedo = ColorBuffer::Create(size, size, TextureFormat::RGBA32);
+		impostor->m_normal = ColorBuffer::Create(size, size, TextureFormat::RGBA32);
+		impostor->m_depth = ColorBuffer::Create(size, size, TextureFormat::RGFloat);
+		auto depthBuffer = DepthBuffer::Create(size, size);
+		auto renderTarget = std::make_shared<RenderTarget>();
+		renderTarget->Set(impostor->m_albedo, impostor->m_normal, impostor->m_depth, depthBuffer);
+
+		// the materials of the object, as an albedo
+		std::vector<MaterialPtr> bakeMaterials;
+		for (auto const & material : materials)
+		{
+			if (material == nullptr)
+			{
+				bakeMaterials.push_back(nullptr);
+				continue;
+			}
+			auto bakeMaterial = Material::InstantiateBuiltinMaterial("ImpostorBake");
+			auto texture = material->mainTexture();
+			bakeMaterial->setMainTexture(texture != nullptr ? texture : Texture2D::whiteTexture());
+			bakeMaterial->setColor(material->color());
+			bakeMaterials.push_back(bakeMaterial);
+		}
+
+		// the caller may be rendering for a camera: its viewport and uniforms are bound again after the frames
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		Pipeline::PushCamera();
+		Pipeline::PushRenderTarget(renderTarget);
+		glViewport(0, 0, size, size);
+		float transparent[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		glClearBufferfv(GL_COLOR, 0, transparent);
+		glClearBufferfv(GL_COLOR, 1, transparent);
+		glClearBufferfv(GL_COLOR, 2, transparent);
+		glClearBufferfv(GL_DEPTH, 0, white);
+
+		// the bounding sphere of the object -> the unit sphere
+		const float scale = 1.0f / impostor->m_radius;
+		auto model = Matrix4x4::TRS(-impostor->m_center * scale, Quaternion::identity, Vector3::one * scale);
+		auto projection = ImpostorUtility::FrameProjectionMatrix();
+		for (int y = 0; y < layout.framesPerSide; ++y)
+		{
+			for (int x = 0; x < layout.framesPerSide; ++x)
+			{
+				int frameViewport[4];
+				ImpostorUtility::FrameViewport(layout, x, y, frameViewport);
+				glViewport(frameViewport[0], frameViewport[1], frameViewport[2], frameViewport[3]);
+				auto direction = ImpostorUtility::FrameDirection(layout, x, y);
+				Pipeline::BindCamera(projection, ImpostorUtility::FrameViewMatrix(direction), 1, 3);
+				Pipeline::UpdatePerDrawUniforms(model);
+				for (int i = 0; i < static_cast<int>(bakeMaterials.size()); ++i)
+				{
+					if (bakeMaterials[i] != nullptr)
+						Graphics::DrawMesh(mesh, bakeMaterials[i], i);
+				}
+			}
+		}
+
+		Pipeline::PopRenderTarget();
+		Pipeline::PopCamera();
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+		for (auto const & atlas : { impostor->m_albedo, impostor->m_normal, impostor->m_depth })
+		{
+			glBindTexture(GL_TEXTURE_2D, atlas->GetNativeTexturePtr());
+			glGenerateMipmap(GL_TEXTURE_2D);
+			atlas->setFilterMode(FilterMode::Trilinear);
+			atlas->setWrapMode(TextureWrapMode::Clamp);
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glCheckError();
+
+		auto material = Material::InstantiateBuiltinMaterial("Impostor");
+		material->SetTexture("AlbedoAtlas", impostor->m_albedo);
+		material->SetTexture("NormalAtlas", impostor->m_normal);
+		material->SetTexture("DepthAtlas", impostor->m_depth);
+		material->SetFloat("FramesPerSide", static_cast<float>(layout.framesPerSide));
+		material->SetFloat("FrameResolution", static_cast<float>(layout.frameResolution));
+		material->SetFloat("Hemisphere", layout.hemisphere ? 1.0f : 0.0f);
+		impostor->m_material = material;
+
+		LogInfo(Format("Impostor baked: %1%, %2%x%2% frames of %3% pixels", mesh->name(), layout.framesPerSide, layout.frameResolution));
+		s_cache.push_back({ mesh, materials, layout, impostor });
+		return impostor;
+	}
+
+	int ImpostorBaker::BakeHierarchy(GameObjectPtr const & root, float distance, ImpostorUtility::Layout const & layout)
+	{
+		int count = 0;
+		for (auto const & renderer : root->GetComponentsInChildren<MeshRenderer>(true))
+		{
+			auto impostor = Bake(renderer, layout);
+			if (impostor == nullptr)
+				continue;
+			renderer->setImpostor(impostor, distance);
+			count++;
+		}
+		return count;
+	}
+
+	void ImpostorBaker::ClearCache()
+	{
+		s_cache.clear();
+	}
+}
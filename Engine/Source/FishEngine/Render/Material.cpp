@@ -73,6 +73,7 @@ namespace FishEngine
 		if (shader == nullptr)
 			abort();
 		m_shader = shader;
+		SetDirty();
 		m_uniforms.floats.clear();
 		m_uniforms.vec2s.clear();
 		m_uniforms.vec3s.clear();
@@ -167,6 +168,7 @@ namespace FishEngine
 //		Debug::LogWarning("Uniform %s[float] not found.", name.c_str());
 		
 		m_uniforms.floats[name] = value;
+		SetDirty();
 	}
 
 
@@ -179,6 +181,7 @@ namespace FishEngine
 //		}
 //		Debug::LogWarning("Uniform %s[vec2] not found.", name.c_str());
 		m_uniforms.vec2s[name] = value;
+		SetDirty();
 	}
 
 	void Material::SetVector3(const std::string& name, const Vector3& value)
@@ -190,6 +193,7 @@ namespace FishEngine
 //		}
 //		Debug::LogWarning("Uniform %s[vec3] not found.", name.c_str());
 		m_uniforms.vec3s[name] = value;
+		SetDirty();
 	}
 
 
@@ -202,6 +206,7 @@ namespace FishEngine
 //		}
 //		Debug::LogWarning("Uniform %s[vec4] not found.", name.c_str());
 		m_uniforms.vec4s[name] = value;
+		SetDirty();
 	}
 
 
@@ -217,6 +222,7 @@ namespace FishEngine
 //		}
 //		Debug::LogWarning("Uniform %s[texture] not found.", name.c_str());
 		m_textures[name] = texture;
+		SetDirty();
 	}
 
 
@@ -230,6 +236,26 @@ namespace FishEngine
 		SetVector4("_Color", Vector4(color.r, color.g, color.b, color.a));
 	}
 
+	Color Material::color() const
+	{
+		auto const & vec4s = m_uniforms.vec4s;
+		auto it = vec4s.find("_Color");
+		if (it != vec4s.end())
+			return Color(it->second.x, it->second.y, it->second.z, it->second.w);
+		// PBR
+		auto const & vec3s = m_uniforms.vec3s;
+		auto it3 = vec3s.find("BaseColor");
+		if (it3 != vec3s.end())
+			return Color(it3->second.x, it3->second.y, it3->second.z, 1);
+		return Color::white;
+	}
+
+	TexturePtr Material::mainTexture() const
+	{
+		auto it = m_textures.find("_MainTex");
+		return it == m_textures.end() ? nullptr : it->second;
+	}
+
 	FishEngine::MaterialPtr Material::builtinMaterial(const std::string& name)
 	{
 		auto it = s_builtinMaterialInstance.find(name);
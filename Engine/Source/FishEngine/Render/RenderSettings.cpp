@@ -112,6 +112,7 @@ namespace FishEngine
 	{
 		m_skybox = skybox;
 		m_skybox->DisableKeyword(ShaderKeyword::All);
+		m_skybox->SetDirty();	// another skybox: the views of the scene are redrawn
 	}
 
 	TexturePtr RenderSettings::preintegratedGF()
@@ -19,6 +19,16 @@
 #include <FishEngine/RenderTarget.hpp>
 #include <FishEngine/Timer.hpp>
 #include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/QualitySettings.hpp>
+#include <FishEngine/StaticBatchingUtility.hpp>
+#include <FishEngine/GeometryUtility.hpp>
+#include <FishEngine/MeshletUtility.hpp>
+#include <FishEngine/GeometryPool.hpp>
+#include <FishEngine/JobSystem.hpp>
+#include <FishEngine/Mathf.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Impostor.hpp>
+#include <FishEngine/UploadQueue.hpp>
 
 using namespace FishEngine;
 
@@ -30,6 +40,11 @@ struct RenderObject
 	MeshPtr			mesh;
 	int				subMeshID = -1;
 
+	// mesh with meshlets: only the ranges of the visible ones are drawn
+	bool						meshletCulled = false;
+	MeshletUtility::View		view;
+	std::vector<IndexRange>		ranges;
+
 	RenderObject(int renderQueue, RendererPtr renderer, MaterialPtr material, MeshPtr mesh, int subMeshID = -1)
 		: renderQueue(renderQueue), renderer(renderer), material(material), mesh(mesh), subMeshID(subMeshID)
 	{
@@ -37,6 +52,126 @@ struct RenderObject
 	}
 };
 
+namespace
+{
+	using namespace FishEngine;
+
+	// The buffers of one resolution.
+	struct RenderBuffers
+	{
+		ColorBufferPtr   GBuffer[3];
+		DepthBufferPtr   depthBuffer;
+		RenderTargetPtr  deferredRenderTarget;
+		ColorBufferPtr   screenShadowMap;
+		RenderTargetPtr  screenShadowMapRenderTarget;
+		ColorBufferPtr   colorBuffer;
+		RenderTargetPtr  renderTarget;
+		RenderTargetPtr  colorOnlyRenderTarget;
+	};
+
+	void CreateBuffers(RenderBuffers & b, const int w, const int h, std::string const & prefix)
+	{
+		b.depthBuffer = DepthBuffer::Create(w, h);
+		b.depthBuffer->setName(prefix + "DepthBuffer");
+		for (int i = 0; i < 3; ++i)
+		{
+			b.GBuffer[i] = ColorBuffer::Create(w, h);
+			b.GBuffer[i]->setName(prefix + "GBuffer-RT" + boost::lexical_cast<std::string>(i));
+		}
+		b.deferredRenderTarget = std::make_shared<RenderTarget>();
+		b.deferredRenderTarget->Set(b.GBuffer[0], b.GBuffer[1], b.GBuffer[2], b.depthBuffer);
+
+		b.screenShadowMap = ColorBuffer::Create(w, h, TextureFormat::R8);
+		b.screenShadowMap->setName(prefix + "ScreenShadowMap");
+		b.screenShadowMapRenderTarget = std::make_shared<RenderTarget>();
+		b.screenShadowMapRenderTarget->SetColorBufferOnly(b.screenShadowMap);
+
+		b.colorBuffer = ColorBuffer::Create(w, h);
+		b.colorBuffer->setName(prefix + "ColorBuffer");
+		b.renderTarget = std::make_shared<RenderTarget>();
+		b.renderTarget->Set(b.colorBuffer, b.depthBuffer);
+
+		b.colorOnlyRenderTarget = std::make_shared<RenderTarget>();
+		b.colorOnlyRenderTarget->SetColorBufferOnly(b.colorBuffer);
+	}
+
+	void ResizeBuffers(RenderBuffers & b, const int w, const int h)
+	{
+		b.depthBuffer->Resize(w, h);
+		b.colorBuffer->Resize(w, h);
+		for (auto& gb : b.GBuffer)
+			gb->Resize(w, h);
+		b.screenShadowMap->Resize(w, h);
+	}
+
+	RenderBuffers s_previewBuffers;	// RenderQuality::Preview
+
+	// The coarsest level of detail of the mesh whose error covers at most QualitySettings::lodErrorThreshold() pixels
+	// in a view of the given height, measured at the point of the bounds of the renderer closest to the camera.
+	int SelectLOD(Mesh const & mesh, Renderer const & renderer, Camera const & camera, const int height)
+	{
+		if (mesh.lodCount() == 1)
+			return 0;
+		float pixelSize;	// in world space
+		if (camera.orghographic())
+		{
+			pixelSize = 2.0f * camera.orthographicSize() / height;
+		}
+		else
+		{
+			auto bounds = renderer.bounds();
+			float distance = Vector3::Distance(camera.transform()->position(), bounds.center()) - bounds.extents().magnitude();
+			distance = std::max(distance, camera.nearClipPlane());
+			pixelSize = 2.0f * std::tan(0.5f * camera.fieldOfView() * Mathf::Deg2Rad) * distance / height;
+		}
+		auto scale = renderer.transform()->lossyScale();
+		float maxScale = std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+		if (maxScale <= 0)
+			return 0;
+		return mesh.SelectLOD(QualitySettings::lodErrorThreshold() * pixelSize / maxScale);
+	}
+
+	// Culling a meshlet takes a few tens of nanoseconds, below this count the jobs would cost more than they save.
+	constexpr size_t ParallelMeshletCount = 4096;
+
+	// Computes the ranges of the visible meshlets of the render objects (their view is set), on the JobSystem when
+	// there are many meshlets.
+	void CullMeshlets(std::vector<RenderObject*> const & objects)
+	{
+		auto cull = [](RenderObject & ro)
+		{
+			auto const & meshlets = ro.mesh->meshlets();
+			auto first = meshlets.data() + ro.mesh->meshletStart(ro.subMeshID);
+			auto last = meshlets.data() + ro.mesh->meshletStart(ro.subMeshID + 1);
+			MeshletUtility::Cull(first, last, ro.view, ro.ranges);
+		};
+
+		size_t meshletCount = 0;
+		for (auto ro : objects)
+			meshletCount += ro->mesh->meshletStart(ro->subMeshID + 1) - ro->mesh->meshletStart(ro->subMeshID);
+		if (meshletCount < ParallelMeshletCount)
+		{
+			for (auto ro : objects)
+				cull(*ro);
+			return;
+		}
+
+		JobSystem::ParallelFor(objects.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				cull(*objects[i]);
+		});
+	}
+
+	void DrawRenderObject(RenderObject const & ro)
+	{
+		if (!ro.meshletCulled)
+			Graphics::DrawMesh(ro.mesh, ro.material, ro.subMeshID);
+		else if (!ro.ranges.empty())
+			Graphics::DrawMesh(ro.mesh, ro.material, ro.ranges);
+	}
+}
+
 namespace FishEngine
 {
 	//FishEngine::GBuffer RenderSystem::m_GBuffer;
@@ -81,6 +216,7 @@ namespace FishEngine
 		//Mesh::Init();
 		Gizmos::Init();
 		Scene::Init();
+		UploadQueue::Init();
 		glFrontFace(GL_CW);
 		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 		glEnable(GL_DEPTH_TEST);
@@ -91,28 +227,17 @@ namespace FishEngine
 		const int w = Screen::width();
 		const int h = Screen::height();
 
-		m_mainDepthBuffer = DepthBuffer::Create(w, h);
-		m_mainDepthBuffer->setName("MainDepthBuffer");
+		RenderBuffers b;
+		CreateBuffers(b, w, h, "Main");
 		for (int i = 0; i < 3; ++i)
-		{
-			m_GBuffer[i] = ColorBuffer::Create(w, h);
-			m_GBuffer[i]->setName("GBuffer-RT" + boost::lexical_cast<std::string>(i));
-		}
-		m_deferredRenderTarget = std::make_shared<RenderTarget>();
-		m_deferredRenderTarget->Set(m_GBuffer[0], m_GBuffer[1], m_GBuffer[2], m_mainDepthBuffer);
-
-		m_screenShadowMap = ColorBuffer::Create(w, h, TextureFormat::R8);
-		m_screenShadowMap->setName("ScreenShadowMap");
-		m_screenShadowMapRenderTarget = std::make_shared<RenderTarget>();
-		m_screenShadowMapRenderTarget->SetColorBufferOnly(m_screenShadowMap);
-
-		m_mainColorBuffer = ColorBuffer::Create(w, h);
-		m_mainColorBuffer->setName("MainColorBuffer");
-		m_mainRenderTarget = std::make_shared<RenderTarget>();
-		m_mainRenderTarget->Set(m_mainColorBuffer, m_mainDepthBuffer);
-
-		m_colorOnlyRenderTarget = std::make_shared<RenderTarget>();
-		m_colorOnlyRenderTarget->SetColorBufferOnly(m_mainColorBuffer);
+			m_GBuffer[i] = b.GBuffer[i];
+		m_mainDepthBuffer = b.depthBuffer;
+		m_deferredRenderTarget = b.deferredRenderTarget;
+		m_screenShadowMap = b.screenShadowMap;
+		m_screenShadowMapRenderTarget = b.screenShadowMapRenderTarget;
+		m_mainColorBuffer = b.colorBuffer;
+		m_mainRenderTarget = b.renderTarget;
+		m_colorOnlyRenderTarget = b.colorOnlyRenderTarget;
 
 		//m_blurredScreenShadowMap = ColorBuffer::Create(w, h, TextureFormat::R8);
 		//m_blurredScreenShadowMap->setFilterMode(FilterMode::Bilinear);
@@ -124,6 +249,40 @@ namespace FishEngine
 
 	void RenderSystem::Render()
 	{
+		// once per frame
+		UploadQueue::Update();
+		Render(Camera::main(), RenderQuality::Full, Screen::width(), Screen::height());
+	}
+
+	void RenderSystem::Render(CameraPtr const & camera, RenderQuality quality, const int w, const int h)
+	{
+		RenderBuffers main;
+		RenderBuffers * buffers = &main;
+		if (quality == RenderQuality::Preview)
+		{
+			if (s_previewBuffers.depthBuffer == nullptr)
+				CreateBuffers(s_previewBuffers, w, h, "Preview");
+			else if (s_previewBuffers.depthBuffer->width() != w || s_previewBuffers.depthBuffer->height() != h)
+				ResizeBuffers(s_previewBuffers, w, h);
+			buffers = &s_previewBuffers;
+		}
+		else
+		{
+			for (int i = 0; i < 3; ++i)
+				main.GBuffer[i] = m_GBuffer[i];
+			main.depthBuffer = m_mainDepthBuffer;
+			main.deferredRenderTarget = m_deferredRenderTarget;
+			main.screenShadowMap = m_screenShadowMap;
+			main.screenShadowMapRenderTarget = m_screenShadowMapRenderTarget;
+			main.colorBuffer = m_mainColorBuffer;
+			main.renderTarget = m_mainRenderTarget;
+			main.colorOnlyRenderTarget = m_colorOnlyRenderTarget;
+		}
+		auto const & b = *buffers;
+
+		// the VAOs may have been changed outside of the engine since the last frame
+		GeometryPool::InvalidateBinding();
+
 		glCheckError();
 		float white[] = { 1.0f, 1.0f, 1.0f, 1.0f };
 		float black[] = { 0.0f, 0.0f, 0.0f, 1.0f };
@@ -131,7 +290,6 @@ namespace FishEngine
 		glClearBufferfv(GL_COLOR, 0, error_color);
 		glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-		auto camera = Camera::main();
 		Pipeline::BindCamera(camera);
 
 		/************************************************************************/
@@ -147,8 +305,14 @@ namespace FishEngine
 
 		std::deque<SkinnedMeshRendererPtr> skinnedMeshRenderers;	// for animation
 
+		// impostors with instances this frame
+		std::vector<Impostor*> impostors;
+
 		bool deferred_enabled = false;
 
+		Vector4 frustumPlanes[6];
+		GeometryUtility::CalculateFrustumPlanes(camera->projectionMatrix() * camera->worldToCameraMatrix(), frustumPlanes);
+
 		std::deque<GameObjectPtr> todo;
 		for (auto& go : Scene::m_gameObjects)
 		{
@@ -166,7 +330,7 @@ namespace FishEngine
 			if (!go->activeInHierarchy())
 				continue;
 			RendererPtr renderer = go->GetComponent<Renderer>();
-			if (renderer == nullptr || !renderer->enabled())
+			if (renderer == nullptr || !renderer->enabled() || renderer->isPartOfStaticBatch())
 				continue;
 
 			MeshPtr mesh;
@@ -187,6 +351,32 @@ namespace FishEngine
 			if (mesh == nullptr)
 				continue;
 
+			auto const & impostor = renderer->m_impostor;
+			renderer->m_drawnAsImpostor = false;
+			if (impostor != nullptr && !camera->orghographic())
+			{
+				auto transform = renderer->transform();
+				Vector3 center;
+				float radius;
+				impostor->WorldBounds(transform->localToWorldMatrix(), center, radius);
+				if (Vector3::Distance(camera->transform()->position(), center) > renderer->m_impostorDistance)
+				{
+					renderer->m_drawnAsImpostor = true;
+					renderer->m_activeLOD = mesh->lodCount() - 1;	// for the shadows
+					if (GeometryUtility::TestPlanesSphere(frustumPlanes, center, radius))
+					{
+						if (impostor->instanceCount() == 0)
+							impostors.push_back(impostor.get());
+						impostor->AddInstance(center, radius, transform->rotation());
+					}
+					continue;
+				}
+			}
+
+			renderer->m_activeLOD = SelectLOD(*mesh, *renderer, *camera, h);
+			if (renderer->m_activeLOD > 0)
+				mesh = mesh->lod(renderer->m_activeLOD);
+
 			auto & materials = renderer->materials();
 			for (int i = 0; i < materials.size(); ++i)
 			{
@@ -224,14 +414,44 @@ namespace FishEngine
 		}
 		skinnedMeshRenderers.clear();
 
+		// static batches, culled by range
+		std::deque<const StaticBatch*> deferredStaticBatches;
+		std::deque<const StaticBatch*> forwardStaticBatches;
+		for (auto & batch : StaticBatchingUtility::batches())
+		{
+			if (batch.material->shader()->IsDeferred())
+			{
+				deferred_enabled = true;
+				deferredStaticBatches.push_back(&batch);
+			}
+			else
+			{
+				forwardStaticBatches.push_back(&batch);
+			}
+		}
+		// meshlets: the clusters outside the frustum or facing away are not drawn
+		std::vector<RenderObject*> clustered;
+		for (auto queue : { &deferredRenderQueue, &forwardRenderQueueGeometry, &forwardRenderQueueTransparent })
+		{
+			for (auto & ro : *queue)
+			{
+				if (ro.mesh->meshlets().empty() || ro.subMeshID >= static_cast<int>(ro.mesh->subMeshCount()))
+					continue;
+				ro.meshletCulled = true;
+				ro.view = MeshletUtility::LocalView(frustumPlanes, *camera, ro.renderer->transform()->localToWorldMatrix(),
+					ro.material->shader()->cullface() == Cullface::Back);
+				clustered.push_back(&ro);
+			}
+		}
+		CullMeshlets(clustered);
+
 
 		/************************************************************************/
 		/* Shadow                                                               */
 		/************************************************************************/
-		Scene::RenderShadow(Light::mainLight());
-		auto v = Camera::main()->viewport();
-		const int w = Screen::width();
-		const int h = Screen::height();
+		const int cascades = quality == RenderQuality::Full ? QualitySettings::shadowCascades() : 1;
+		Scene::RenderShadow(Light::mainLight(), camera, cascades);
+		auto v = camera->viewport();
 		glViewport(GLint(v.x*w), GLint(v.y*h), GLsizei(v.z*w), GLsizei(v.w*h));
 
 
@@ -241,7 +461,7 @@ namespace FishEngine
 
 		// 1 color buffer
 		// depth buffer
-		Pipeline::PushRenderTarget(m_mainRenderTarget);
+		Pipeline::PushRenderTarget(b.renderTarget);
 		glClearBufferfv(GL_COLOR, 0, error_color);
 		glClearBufferfv(GL_DEPTH, 0, white);
 
@@ -252,7 +472,7 @@ namespace FishEngine
 		{
 			// 3 color buffer: G-BUffer
 			// depth buffer
-			Pipeline::PushRenderTarget(m_deferredRenderTarget);
+			Pipeline::PushRenderTarget(b.deferredRenderTarget);
 			glClearBufferfv(GL_COLOR, 0, black);
 			glClearBufferfv(GL_COLOR, 1, error_color);
 			glClearBufferfv(GL_COLOR, 2, error_color);
@@ -263,20 +483,26 @@ namespace FishEngine
 				//ro.renderer->PreRender();
 				auto model = ro.renderer->transform()->localToWorldMatrix();
 				Pipeline::UpdatePerDrawUniforms(model);
-				Graphics::DrawMesh(ro.mesh, ro.material, ro.subMeshID);
+				DrawRenderObject(ro);
+			}
+
+			Pipeline::UpdatePerDrawUniforms(Matrix4x4::identity);
+			for (auto batch : deferredStaticBatches)
+			{
+				batch->Draw(batch->material, frustumPlanes);
 			}
 
 			Pipeline::PopRenderTarget();
 
-			Pipeline::PushRenderTarget(m_colorOnlyRenderTarget);
+			Pipeline::PushRenderTarget(b.colorOnlyRenderTarget);
 			glDepthFunc(GL_ALWAYS);
 			glDepthMask(GL_FALSE);
 			auto quad = Mesh::builtinMesh(PrimitiveType::ScreenAlignedQuad);
 			auto mtl = Material::builtinMaterial("Deferred");
-			mtl->SetTexture("DBufferATexture", m_GBuffer[0]);
-			mtl->SetTexture("DBufferBTexture", m_GBuffer[1]);
-			mtl->SetTexture("DBufferCTexture", m_GBuffer[2]);
-			mtl->SetTexture("SceneDepthTexture", m_mainDepthBuffer);
+			mtl->SetTexture("DBufferATexture", b.GBuffer[0]);
+			mtl->SetTexture("DBufferBTexture", b.GBuffer[1]);
+			mtl->SetTexture("DBufferCTexture", b.GBuffer[2]);
+			mtl->SetTexture("SceneDepthTexture", b.depthBuffer);
 			Graphics::DrawMesh(quad, mtl);
 			glDepthMask(GL_TRUE);
 			glDepthFunc(GL_LESS);
@@ -291,7 +517,19 @@ namespace FishEngine
 			//ro.renderer->PreRender();
 			auto model = ro.renderer->transform()->localToWorldMatrix();
 			Pipeline::UpdatePerDrawUniforms(model);
-			Graphics::DrawMesh(ro.mesh, ro.material, ro.subMeshID);
+			DrawRenderObject(ro);
+		}
+
+		Pipeline::UpdatePerDrawUniforms(Matrix4x4::identity);
+		for (auto batch : forwardStaticBatches)
+		{
+			batch->Draw(batch->material, frustumPlanes);
+		}
+
+		// opaque, in the depth buffer for the screen space shadows
+		for (auto impostor : impostors)
+		{
+			impostor->DrawInstances();
 		}
 
 		Pipeline::PopRenderTarget(); // m_mainRenderTarget
@@ -302,7 +540,7 @@ namespace FishEngine
 		/************************************************************************/
 		// 1 color buffer
 		// no depth buffer
-		Pipeline::PushRenderTarget(m_screenShadowMapRenderTarget);
+		Pipeline::PushRenderTarget(b.screenShadowMapRenderTarget);
 		{
 			glDepthFunc(GL_ALWAYS);
 			glDepthMask(GL_FALSE);
@@ -323,7 +561,8 @@ namespace FishEngine
 			float shadowMapSize = static_cast<float>( shadowMap->width() );
 			float shadowMapTexelSize = 1.0f / shadowMapSize;
 			mtl->SetVector4("_ShadowMapTexture_TexelSize", Vector4(shadowMapTexelSize, shadowMapTexelSize, shadowMapSize, shadowMapSize));
-			mtl->SetTexture("SceneDepthTexture", m_mainDepthBuffer);
+			mtl->SetTexture("SceneDepthTexture", b.depthBuffer);
+			mtl->SetFloat("ShadowPCF", quality == RenderQuality::Full ? 1.0f : 0.0f);
 			Graphics::DrawMesh(quad, mtl);
 			glDepthMask(GL_TRUE);
 			glDepthFunc(GL_LESS);
@@ -337,14 +576,14 @@ namespace FishEngine
 		//glClearBufferfv(GL_COLOR, 0, black);
 		auto quad = Mesh::builtinMesh(PrimitiveType::ScreenAlignedQuad);
 		auto mtl = Material::builtinMaterial("PostProcessShadow");
-		mtl->setMainTexture(m_mainColorBuffer);
-		mtl->SetTexture("ScreenShadow", m_screenShadowMap);
+		mtl->setMainTexture(b.colorBuffer);
+		mtl->SetTexture("ScreenShadow", b.screenShadowMap);
 		Graphics::DrawMesh(quad, mtl);
 		//Pipeline::PopRenderTarget();
 		glDepthMask(GL_TRUE);
 		glDepthFunc(GL_LESS);
 #else
-		m_mainRenderTarget->AttachForRead();
+		b.renderTarget->AttachForRead();
 		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 #endif
 
@@ -352,7 +591,7 @@ namespace FishEngine
 		//m_mainRenderTarget->Attach();
 		//auto w = m_mainDepthBuffer->width();
 		//auto h = m_mainDepthBuffer->height();
-		m_mainRenderTarget->AttachForRead();
+		b.renderTarget->AttachForRead();
 		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 		//m_mainRenderTarget->Detach();
 		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
@@ -361,7 +600,7 @@ namespace FishEngine
 		/* Skybox                                                               */
 		/************************************************************************/
 		Matrix4x4 model;
-		model.SetTRS(Camera::main()->transform()->position(), Quaternion::identity, Vector3::one * 2000);
+		model.SetTRS(camera->transform()->position(), Quaternion::identity, Vector3::one * 2000);
 		//Matrix4x4 model = Matrix4x4::Scale(1000);
 		Graphics::DrawMesh(Mesh::builtinMesh(PrimitiveType::Sphere), model, RenderSettings::skybox());
 
@@ -374,7 +613,7 @@ namespace FishEngine
 			//ro.renderer->PreRender();
 			auto model = ro.renderer->transform()->localToWorldMatrix();
 			Pipeline::UpdatePerDrawUniforms(model);
-			Graphics::DrawMesh(ro.mesh, ro.material, ro.subMeshID);
+			DrawRenderObject(ro);
 		}
 
 #if 0
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <set>
 #include <regex>
+#include <chrono>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -15,6 +16,8 @@
 #include <FishEngine/Debug.hpp>
 #include <FishEngine/Pipeline.hpp>
 #include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/ShaderVariantCollection.hpp>
+#include <FishEngine/Render/Shader/ShaderReflection.hpp>
 
 //#include EnumHeader(CullFace)
 #include <FishEngine/Generated/Enum_Cullface.hpp>
@@ -24,8 +27,10 @@
 using namespace std;
 using namespace FishEngine;
 
+// The status is not checked here but after the link (FinishLinkProgram): the driver can compile in the background
+// in the meantime (GL_KHR_parallel_shader_compile).
 GLuint
-CompileShader(
+StartCompileShader(
 	GLenum             shader_type,
 	const std::string& shader_str)
 {
@@ -34,26 +39,17 @@ CompileShader(
 	assert(shader > 0);
 	glShaderSource(shader, 1, &shader_c_str, NULL);
 	glCompileShader(shader);
-	GLint success = GL_FALSE;
-	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		GLint infoLogLength = 0;
-		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
-		std::vector<char> infoLog(infoLogLength + 1);
-		glGetShaderInfoLog(shader, infoLogLength, NULL, infoLog.data());
-		throw std::runtime_error(infoLog.data());
-	}
 	return shader;
 };
 
 
 GLuint
-LinkShader(GLuint vs,
+StartLinkProgram(GLuint vs,
 	GLuint tcs,
 	GLuint tes,
 	GLuint gs,
-	GLuint fs)
+	GLuint fs,
+	bool transformFeedback)
 {
 	glCheckError();
 	GLuint program = glCreateProgram();
@@ -65,77 +61,61 @@ LinkShader(GLuint vs,
 		if (tcs != 0) glAttachShader(program, tcs);
 		glAttachShader(program, tes);
 	}
-	glLinkProgram(program);
-	GLint success;
-	glGetProgramiv(program, GL_LINK_STATUS, &success);
-	if (!success)
+	if (transformFeedback)
 	{
-		GLint infoLogLength = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-		std::vector<char> infoLog(infoLogLength + 1);
-		glGetProgramInfoLog(program, infoLogLength, NULL, infoLog.data());
-		throw std::runtime_error(infoLog.data());
-	}
-
-	glDetachShader(program, vs);
-	glDetachShader(program, fs);
-	if (gs != 0) {
-		glDetachShader(program, gs);
+		const char* const varyings[] = {"OutputPosition", "OutputNormal", "OutputTangent"};
+		glTransformFeedbackVaryings(program, 3, varyings, GL_SEPARATE_ATTRIBS);
 	}
-	if (tes != 0) {
-		if (tcs != 0) glDetachShader(program, tcs);
-		glDetachShader(program, tes);
-	}
-
+	glLinkProgram(program);
 	glCheckError();
 	return program;
 }
 
-GLuint
-LinkShader_tf(GLuint vs,
-		   GLuint tcs,
-		   GLuint tes,
-		   GLuint gs,
-		   GLuint fs)
+// Waits for the compilation and the link. Throws the log of the compiler, or of the linker, if they failed.
+// The shaders are detached and deleted in any case.
+void
+FinishLinkProgram(GLuint program, std::initializer_list<GLuint> shaders)
 {
-	glCheckError();
-	GLuint program = glCreateProgram();
-	glAttachShader(program, vs);
-	glAttachShader(program, fs);
-	if (gs != 0)
-		glAttachShader(program, gs);
-	if (tes != 0) {
-		if (tcs != 0) glAttachShader(program, tcs);
-		glAttachShader(program, tes);
-	}
-	const char* const varyings[] = {"OutputPosition", "OutputNormal", "OutputTangent"};
-	glCheckError();
-	glTransformFeedbackVaryings(program, 3, varyings, GL_SEPARATE_ATTRIBS);
-	glCheckError();
-	glLinkProgram(program);
-	GLint success;
+	GLint success = GL_FALSE;
 	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	std::string error;
 	if (!success)
 	{
-		GLint infoLogLength = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-		std::vector<char> infoLog(infoLogLength + 1);
-		glGetProgramInfoLog(program, infoLogLength, NULL, infoLog.data());
-		throw std::runtime_error(infoLog.data());
-	}
-	
-	glDetachShader(program, vs);
-	glDetachShader(program, fs);
-	if (gs != 0) {
-		glDetachShader(program, gs);
+		for (auto shader : shaders)
+		{
+			if (shader == 0)
+				continue;
+			GLint compiled = GL_FALSE;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+			if (compiled)
+				continue;
+			GLint infoLogLength = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+			std::vector<char> infoLog(infoLogLength + 1);
+			glGetShaderInfoLog(shader, infoLogLength, NULL, infoLog.data());
+			error = infoLog.data();
+			break;
+		}
+		if (error.empty())
+		{
+			GLint infoLogLength = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+			std::vector<char> infoLog(infoLogLength + 1);
+			glGetProgramInfoLog(program, infoLogLength, NULL, infoLog.data());
+			error = infoLog.data();
+		}
 	}
-	if (tes != 0) {
-		if (tcs != 0) glDetachShader(program, tcs);
-		glDetachShader(program, tes);
+
+	for (auto shader : shaders)
+	{
+		if (shader == 0)
+			continue;
+		glDetachShader(program, shader);
+		glDeleteShader(shader);
 	}
-	
 	glCheckError();
-	return program;
+	if (!success)
+		throw std::runtime_error(error);
 }
 
 std::string AddLineNumber(const std::string& str)
@@ -194,6 +174,15 @@ bool UniformIsTexture(GLenum type)
 
 namespace FishEngine
 {
+	namespace
+	{
+		// GL_COMPLETION_STATUS_KHR, GL_COMPLETION_STATUS_ARB
+		constexpr GLenum CompletionStatus = 0x91B1;
+
+		uint32_t	s_drawTimeCompileCount = 0;
+		float		s_drawTimeCompileMilliseconds = 0;
+	}
+
 	class ShaderImpl
 	{
 	public:
@@ -206,6 +195,13 @@ namespace FishEngine
 			{
 				glDeleteProgram(e.second);
 			}
+			for (auto& e : m_pendingPrograms)
+			{
+				glDeleteProgram(e.second.program);
+				glDeleteShader(e.second.vs);
+				glDeleteShader(e.second.gs);
+				glDeleteShader(e.second.fs);
+			}
 		}
 
 		void set(const std::string& shaderText)
@@ -213,31 +209,56 @@ namespace FishEngine
 			m_shaderTextRaw = shaderText;
 		}
 
-		GLuint CompileAndLink(ShaderKeywords keywords)
+		// A variant being compiled: the shaders and the program are created, the driver may not be done with them.
+		struct PendingProgram
 		{
-			//Debug::LogWarning("CompileAndLink %s", m_filePath.c_str());
-			auto vs = Compile(ShaderType::VertexShader, keywords);
+			GLuint vs = 0;
 			GLuint gs = 0;
+			GLuint fs = 0;
+			GLuint program = 0;
+		};
+
+		PendingProgram StartCompileAndLink(ShaderKeywords keywords)
+		{
+			PendingProgram p;
+			p.vs = Compile(ShaderType::VertexShader, keywords);
 			if (m_hasGeometryShader)
-				gs = Compile(ShaderType::GeometryShader, keywords);
-			auto fs = Compile(ShaderType::FragmentShader, keywords);
-			//auto glsl_program = LinkShader(vs, 0, 0, gs, fs);
-			GLuint glsl_program = LinkShader(vs, 0, 0, gs, fs);
-			if (m_transformFeedback)
+				p.gs = Compile(ShaderType::GeometryShader, keywords);
+			p.fs = Compile(ShaderType::FragmentShader, keywords);
+			p.program = StartLinkProgram(p.vs, 0, 0, p.gs, p.fs, m_transformFeedback);
+			return p;
+		}
+
+		GLuint FinishCompileAndLink(ShaderKeywords keywords, PendingProgram const & p)
+		{
+			try
 			{
-				glsl_program = LinkShader_tf(vs, 0, 0, gs, fs);
+				FinishLinkProgram(p.program, { p.vs, p.gs, p.fs });
 			}
-			else
+			catch (...)
 			{
-				glsl_program = LinkShader(vs, 0, 0, gs, fs);
+				glDeleteProgram(p.program);
+				throw;
 			}
-			m_keywordToGLPrograms[keywords] = glsl_program;
-			GetAllUniforms(glsl_program);
-			glDeleteShader(vs);
-			glDeleteShader(fs);
-			if (gs != 0) glDeleteShader(gs);
+			m_keywordToGLPrograms[keywords] = p.program;
+			GetAllUniforms(p.program, keywords);
 			glCheckError();
-			return glsl_program;
+			return p.program;
+		}
+
+		GLuint CompileAndLink(ShaderKeywords keywords)
+		{
+			//Debug::LogWarning("CompileAndLink %s", m_filePath.c_str());
+			return FinishCompileAndLink(keywords, StartCompileAndLink(keywords));
+		}
+
+		// Started by the warm-up: finished here if it is drawn before the warm-up is done.
+		GLuint FinishPending(ShaderKeywords keywords)
+		{
+			auto it = m_pendingPrograms.find(keywords);
+			auto p = it->second;
+			m_pendingPrograms.erase(it);
+			return FinishCompileAndLink(keywords, p);
 		}
 
 		GLuint glslProgram(ShaderKeywords keywords, std::vector<UniformInfo>& uniforms)
@@ -250,7 +271,14 @@ namespace FishEngine
 			}
 			else
 			{
-				program = CompileAndLink(keywords);
+				// the variant was not warmed up: this frame waits for the driver
+				auto start = std::chrono::high_resolution_clock::now();
+				if (m_pendingPrograms.count(keywords) > 0)
+					program = FinishPending(keywords);
+				else
+					program = CompileAndLink(keywords);
+				s_drawTimeCompileCount++;
+				s_drawTimeCompileMilliseconds += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 			}
 			uniforms = m_GLProgramToUniforms[program];
 			return program;
@@ -264,12 +292,12 @@ namespace FishEngine
 		bool m_transformFeedback = false;
 		
 		bool m_hasGeometryShader = false;
-		uint32_t m_lineCount;   // for error message
 
 	//private:
 		//std::string                         m_filePath;
 		std::string                         m_shaderTextRaw;
 		std::map<ShaderKeywords, GLuint>    m_keywordToGLPrograms;
+		std::map<ShaderKeywords, PendingProgram>	m_pendingPrograms;
 		std::map<GLuint, std::vector<UniformInfo>>
 			m_GLProgramToUniforms;
 		int m_renderQueue = -1;
@@ -277,47 +305,15 @@ namespace FishEngine
 
 		GLuint Compile(ShaderType type, ShaderKeywords keywords)
 		{
-			std::string text = "#version 410 core\n";
-			m_lineCount = 1;
-
-			auto add_macro_definition = [&text, this](const string& d)
-			{
-				text += "#define " + d + "\n";
-				this->m_lineCount++;
-			};
-
 			GLenum t = GL_VERTEX_SHADER;
-
-			if (type == ShaderType::VertexShader)
-			{
-				add_macro_definition("VERTEX_SHADER");
-			}
-			else if (type == ShaderType::FragmentShader)
-			{
-				add_macro_definition("FRAGMENT_SHADER");
+			if (type == ShaderType::FragmentShader)
 				t = GL_FRAGMENT_SHADER;
-			}
 			else if (type == ShaderType::GeometryShader)
-			{
 				t = GL_GEOMETRY_SHADER;
-				add_macro_definition("GEOMETRY_SHADER");
-			}
-
-//			if (keywords & static_cast<ShaderKeywords>(ShaderKeyword::SkinnedAnimation))
-//			{
-//				add_macro_definition("_SKINNED");
-//			}
-			if (keywords & static_cast<ShaderKeywords>(ShaderKeyword::AmbientIBL))
-			{
-				add_macro_definition("_AMBIENT_IBL");
-			}
-
-			text += m_shaderTextRaw;
-
-			return CompileShader(t, text);
+			return StartCompileShader(t, ShaderCompiler::StageSource(m_shaderTextRaw, type, keywords));
 		}
 
-		void GetAllUniforms(GLuint program) noexcept
+		void GetAllUniforms(GLuint program, ShaderKeywords keywords) noexcept
 		{
 			std::vector<UniformInfo> uniforms;
 			GLuint blockID = glGetUniformBlockIndex(program, "PerCameraUniforms");
@@ -362,38 +358,42 @@ namespace FishEngine
 				assert(blockSize == sizeof(Bones));
 			}
 
-			GLint count;
-			GLint size; // size of the variable
-			GLenum type; // type of the variable (float, vec3 or mat4, etc)
-			const GLsizei bufSize = 32; // maximum name length
-			GLchar name[bufSize]; // variable name in GLSL
-			GLsizei length; // name length
-
-			glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+			// The uniforms are the ones declared in the stages (the offline reflection, see ShaderCompiler --offline),
+			// the driver only gives their locations; the ones it dropped as unused have none. Structs are skipped:
+			// a material only sets numbers, vectors, matrices and textures.
+			ShaderReflection reflection;
+			reflection.Merge(ShaderReflection::Reflect(
+				ShaderCompiler::StageSource(m_shaderTextRaw, ShaderType::VertexShader, keywords), ShaderType::VertexShader));
+			reflection.Merge(ShaderReflection::Reflect(
+				ShaderCompiler::StageSource(m_shaderTextRaw, ShaderType::FragmentShader, keywords), ShaderType::FragmentShader));
+			if (m_hasGeometryShader)
+			{
+				reflection.Merge(ShaderReflection::Reflect(
+					ShaderCompiler::StageSource(m_shaderTextRaw, ShaderType::GeometryShader, keywords), ShaderType::GeometryShader));
+			}
 
 			int texture_count = 0;
-			for (int i = 0; i < count; i++)
-			{
-				glGetActiveUniform(program, (GLuint)i, bufSize, &length, &size, &type, name);
-				GLint loc = glGetUniformLocation(program, name);
-				if (loc != GL_INVALID_INDEX)
+			for (auto const & v : reflection.uniforms)
+			{
+				if (v.type == 0)
+					continue;
+				GLint loc = glGetUniformLocation(program, v.name.c_str());
+				if (loc < 0)
+					continue;
+				UniformInfo u;
+				u.type = v.type;
+				u.name = v.name;
+				u.location = loc;
+				if (UniformIsTexture(v.type))
 				{
-					//Debug::Log("Uniform #%d Type: %s Name: %s Loc: %d", i, GLenumToString(type), name, loc);
-					UniformInfo u;
-					u.type = type;
-					u.name = name;
-					u.location = loc;
-					if (UniformIsTexture(type))
-					{
-						u.textureBindPoint = texture_count;
-						texture_count++;
-					}
-					else {
-						u.textureBindPoint = -1;
-					}
-					u.binded = false;
-					uniforms.emplace_back(u);
+					u.textureBindPoint = texture_count;
+					texture_count++;
+				}
+				else {
+					u.textureBindPoint = -1;
 				}
+				u.binded = false;
+				uniforms.emplace_back(u);
 			}
 			m_GLProgramToUniforms[program] = uniforms;
 		}
@@ -438,6 +438,10 @@ namespace FishEngine
 			m_ZWrite = GetValueOrDefault<string, string>(settings, "zwrite", "on") == "on";
 			//m_blend = GetValueOrDefault<string, string>(settings, "blend", "off") == "on";
 			m_deferred = GetValueOrDefault<string, string>(settings, "deferred", "off") == "on";
+			// @queue alphatest: cutout, alpha tested in the shadow maps (DepthOnlyRenderer)
+			auto queue = GetValueOrDefault<string, string>(settings, "queue", "");
+			if (queue == "alphatest")
+				m_impl->m_renderQueue = static_cast<int>(Rendering::RenderQueue::AlphaTest);
 			m_blend = compiler.m_blendEnabled;
 			m_blendFactorCount = compiler.m_blendFactorCount;
 			for (int i = 0; i < m_blendFactorCount; ++i)
@@ -460,59 +464,35 @@ namespace FishEngine
 
 	void Shader::PrintErrorMessage(std::string const & errorMessage) noexcept
 	{
-		LogError(errorMessage);
-
-		std::vector<std::string> lines;
-		boost::split(lines, errorMessage, boost::is_any_of("\n"));
-		for (auto & line : lines)
-		{
-#if FISHENGINE_PLATFORM_WINDOWS
-			auto begin = line.find_first_of('(');
-			auto end = line.find_first_of(')');
-#else
-			auto begin = line.find_first_of(':');
-			begin = line.find_first_of(':', begin + 1);
-			auto end = line.find_first_of(':', begin + 1);
-#endif
-			uint32_t line_number = 0;
-			try
-			{
-				line_number = boost::lexical_cast<uint32_t>(line.substr(begin + 1, end - begin - 1));
-			}
-			catch(exception const &)
+		// the messages are located in the original files through the #line directives of the preprocessed text
+		std::map<Path, std::vector<std::string>> files;
+		for (auto const & d : ShaderCompiler::MapDiagnostics(errorMessage))
+		{
+			if (d.file.empty())
 			{
+				LogError(d.message);
 				continue;
 			}
-			//cout << line_number << endl;
-			uint32_t start_line = m_impl->m_lineCount;
-			auto& text = m_impl->shaderTextRaw();
-
-			string::size_type cursor = 0;
+			LogError(Format("%1%(%2%): %3%", d.file.string(), d.line, d.message));
 
-			int first = line_number - start_line - 5;
-			if (first < 0)
-				first = 0;
-
-			for (int i = 0; i < first - 1; ++i)
+			auto it = files.find(d.file);
+			if (it == files.end())
 			{
-				cursor = text.find_first_of('\n', cursor) + 1;
+				std::vector<std::string> lines;
+				std::ifstream fin(d.file.string());
+				for (std::string line; std::getline(fin, line); )
+					lines.push_back(line);
+				it = files.emplace(d.file, std::move(lines)).first;
 			}
-
-			int total = static_cast<int>(std::count(text.begin(), text.end(), '\n') + 1);
-			int last = static_cast<int>(line_number - start_line + 5);
-			if (last >= total)
-				last = total - 1;
-
+			auto const & lines = it->second;
+			int first = std::max(1, d.line - 5);
+			int last = std::min(static_cast<int>(lines.size()), d.line + 5);
 			std::ostringstream context_lines;
-			for (int i = first; i < last; ++i)
+			for (int i = first; i <= last; ++i)
 			{
-				auto new_cursor = text.find_first_of('\n', cursor);
-				context_lines << '#' << i + start_line << '\t' << text.substr(cursor, new_cursor - cursor) << '\n';
-				cursor = new_cursor + 1;
+				context_lines << (i == d.line ? '>' : '#') << i << '\t' << lines[i - 1] << '\n';
 			}
-			LogError(line);
 			LogInfo(context_lines.str());
-			cout << endl;
 		}
 	}
 
@@ -525,8 +505,7 @@ namespace FishEngine
 		if (m_GLNativeProgram == 0)
 		{
 			try {
-				m_impl->CompileAndLink(m_keywords);
-				m_GLNativeProgram = m_impl->glslProgram(m_keywords, m_uniforms);
+				SelectVariant();
 			}
 			catch (const std::exception & e)
 			{
@@ -809,15 +788,79 @@ namespace FishEngine
 	void Shader::EnableLocalKeywords(ShaderKeywords keyword)
 	{
 		m_keywords |= keyword;
-		m_GLNativeProgram = m_impl->glslProgram(m_keywords, m_uniforms);
+		SelectVariant();
 	}
 
 	void Shader::DisableLocalKeywords(ShaderKeywords keyword)
 	{
 		m_keywords &= ~keyword;
+		SelectVariant();
+	}
+
+	void Shader::SelectVariant()
+	{
+		ShaderVariantCollection::Record(m_name, m_keywords);
 		m_GLNativeProgram = m_impl->glslProgram(m_keywords, m_uniforms);
 	}
 
+	bool Shader::StartCompileVariant(ShaderKeywords keywords)
+	{
+		if (m_impl->m_keywordToGLPrograms.count(keywords) > 0 || m_impl->m_pendingPrograms.count(keywords) > 0)
+			return false;
+		try
+		{
+			m_impl->m_pendingPrograms[keywords] = m_impl->StartCompileAndLink(keywords);
+		}
+		catch (const std::exception & e)
+		{
+			PrintErrorMessage(e.what());
+			return false;
+		}
+		return true;
+	}
+
+	bool Shader::IsVariantReady(ShaderKeywords keywords) const
+	{
+		auto it = m_impl->m_pendingPrograms.find(keywords);
+		if (it == m_impl->m_pendingPrograms.end())
+			return true;
+		GLint completed = GL_TRUE;
+		glGetProgramiv(it->second.program, CompletionStatus, &completed);
+		return completed == GL_TRUE;
+	}
+
+	bool Shader::FinishCompileVariant(ShaderKeywords keywords)
+	{
+		if (m_impl->m_pendingPrograms.count(keywords) == 0)
+			return m_impl->m_keywordToGLPrograms.count(keywords) > 0;
+		try
+		{
+			m_impl->FinishPending(keywords);
+		}
+		catch (const std::exception & e)
+		{
+			PrintErrorMessage(e.what());
+			return false;
+		}
+		return true;
+	}
+
+	uint32_t Shader::drawTimeCompileCount()
+	{
+		return s_drawTimeCompileCount;
+	}
+
+	float Shader::drawTimeCompileMilliseconds()
+	{
+		return s_drawTimeCompileMilliseconds;
+	}
+
+	void Shader::ResetDrawTimeCompileStatistics()
+	{
+		s_drawTimeCompileCount = 0;
+		s_drawTimeCompileMilliseconds = 0;
+	}
+
 	int Shader::renderQueue()
 	{
 		if (m_impl->m_renderQueue < 0)
@@ -842,26 +885,33 @@ namespace FishEngine
 	void Shader::Init(std::string const & rootDir)
 	{
 		Path root_dir = rootDir;
+		std::vector<std::pair<std::string, Path>> files;
 		for (auto& n : { "PBR", "PBR-Reference", "Diffuse", "DebugCSM", "Texture", "Transparent" })
 		{
-			m_builtinShaders[n] = Shader::CreateFromFile(root_dir / (string(n) + ".surf"));
-			m_builtinShaders[n]->setName(n);
+			files.emplace_back(n, root_dir / (string(n) + ".surf"));
 		}
 
 		for (auto& n : { "ScreenTexture", "Deferred", "CascadedShadowMap",
 			"DisplayCSM", "DrawQuad", "GatherScreenSpaceShadow", "SolidColor",
-			"PostProcessShadow", "PostProcessGaussianBlur", "PostProcessSelectionOutline", "Internal-GPUSkinning" })
+			"PostProcessShadow", "PostProcessGaussianBlur", "PostProcessSelectionOutline", "Internal-GPUSkinning",
+			"Impostor", "ImpostorBake", "ShadowDepth", "ShadowDepthCutout" })
 		{
-			m_builtinShaders[n] = Shader::CreateFromFile(root_dir / (string(n) + ".shader"));
-			m_builtinShaders[n]->setName(n);
+			files.emplace_back(n, root_dir / (string(n) + ".shader"));
 		}
 
-		m_builtinShaders["SkyboxCubed"] = Shader::CreateFromFile(root_dir / "Skybox-Cubed.shader");
-		m_builtinShaders["SkyboxProcedural"] = Shader::CreateFromFile(root_dir / "Skybox-Procedural.shader");
-		m_builtinShaders["SolidColor-Internal"] = Shader::CreateFromFile(root_dir / "Editor/SolidColor.shader");
-		m_builtinShaders["SkyboxProcedural"]->setName("SkyboxProcedural");
-		m_builtinShaders["SkyboxCubed"]->setName("SkyboxCubed");
-		m_builtinShaders["SolidColor-Internal"]->setName("SolidColor-Internal");
+		files.emplace_back("SkyboxCubed", root_dir / "Skybox-Cubed.shader");
+		files.emplace_back("SkyboxProcedural", root_dir / "Skybox-Procedural.shader");
+		files.emplace_back("SolidColor-Internal", root_dir / "Editor/SolidColor.shader");
+
+		// a missing or broken file (logged) leaves its builtin shader out: the other ones still load
+		for (auto const & f : files)
+		{
+			auto shader = Shader::CreateFromFile(f.second);
+			if (shader == nullptr)
+				continue;
+			shader->setName(f.first);
+			m_builtinShaders[f.first] = shader;
+		}
 	}
 
 }
@@ -2,6 +2,10 @@
 
 #include <iostream>
 #include <cctype>
+#include <algorithm>
+#include <sstream>
+#include <mutex>
+#include <regex>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -243,6 +247,29 @@ public:
 	}
 };
 
+// line number of cursor in text, whose first line is firstLine
+int lineAt(const std::string& text, size_t cursor, int firstLine)
+{
+	cursor = std::min(cursor, text.size());
+	return firstLine + static_cast<int>(std::count(text.begin(), text.begin() + cursor, '\n'));
+}
+
+// the next line of parsed is line of the file fileIndex
+void appendLineDirective(std::string& parsed, int line, int fileIndex)
+{
+	if (!parsed.empty() && parsed.back() != '\n')
+		parsed += '\n';
+	parsed += "#line " + std::to_string(line) + " " + std::to_string(fileIndex) + "\n";
+}
+
+namespace
+{
+	// index in the #line directives -> file. Shaders are preprocessed by several threads in the offline compiler.
+	std::mutex				s_sourcesMutex;
+	std::vector<Path>		s_sources = { Path() };	// 0: generated by the engine
+	std::map<Path, int>		s_sourceIndices;
+}
+
 enum class ShaderLabPropertyType
 {
 	Float,
@@ -264,17 +291,23 @@ namespace FishEngine
 
 	std::string ShaderCompiler::PreprocessShaderFile(const Path& path)
 	{
+		const int fileIndex = SourceIndex(path);
+		const std::string lineDirective = "#line 1 " + std::to_string(fileIndex) + "\n";
 		if (path.extension() == ".inc")
 		{
 			std::string full_path = boost::filesystem::absolute(path).string();
-			auto it = s_cachedHeaders.find(full_path);
-			if (it != s_cachedHeaders.end())
 			{
-				return it->second;
+				std::lock_guard<std::mutex> lock(s_sourcesMutex);
+				auto it = s_cachedHeaders.find(full_path);
+				if (it != s_cachedHeaders.end())
+				{
+					return it->second;
+				}
 			}
 			//Debug::LogWarning("Open header %s", path.string().c_str());
 			const std::string& shaderText = ReadFile(path);
-			auto parsed = PreprocessImpl(shaderText, m_path.parent_path());
+			auto parsed = lineDirective + PreprocessImpl(shaderText, m_path.parent_path(), fileIndex, 1);
+			std::lock_guard<std::mutex> lock(s_sourcesMutex);
 			s_cachedHeaders[full_path] = parsed;
 			return parsed;
 		}
@@ -282,11 +315,105 @@ namespace FishEngine
 		auto shaderText = ReadFile(path);
 		if (path.extension() == ".surf")
 		{
-			shaderText = "#include <SurfaceShaderCommon.inc>\n#ifdef SURFACE_SHADER\n" +
-				shaderText + "\n#endif\n";
+			auto prologue = PreprocessImpl("#include <SurfaceShaderCommon.inc>\n#ifdef SURFACE_SHADER\n", m_path.parent_path(), 0, 1);
+			appendLineDirective(prologue, 1, fileIndex);
+			return prologue + PreprocessImpl(shaderText, m_path.parent_path(), fileIndex, 1) + "\n#endif\n";
 		}
 
-		return PreprocessImpl(shaderText, m_path.parent_path());
+		return lineDirective + PreprocessImpl(shaderText, m_path.parent_path(), fileIndex, 1);
+	}
+
+	int ShaderCompiler::SourceIndex(const Path& path)
+	{
+		auto full_path = boost::filesystem::absolute(path);
+		std::lock_guard<std::mutex> lock(s_sourcesMutex);
+		auto it = s_sourceIndices.find(full_path);
+		if (it != s_sourceIndices.end())
+			return it->second;
+		int index = static_cast<int>(s_sources.size());
+		s_sources.push_back(full_path);
+		s_sourceIndices[full_path] = index;
+		return index;
+	}
+
+	Path ShaderCompiler::SourcePath(int fileIndex)
+	{
+		std::lock_guard<std::mutex> lock(s_sourcesMutex);
+		if (fileIndex <= 0 || fileIndex >= static_cast<int>(s_sources.size()))
+			return Path();
+		return s_sources[fileIndex];
+	}
+
+	std::string ShaderCompiler::StageSource(const std::string& preprocessed, ShaderType stage, ShaderKeywords keywords)
+	{
+		std::string text = "#version 410 core\n";
+		if (stage == ShaderType::VertexShader)
+			text += "#define VERTEX_SHADER\n";
+		else if (stage == ShaderType::FragmentShader)
+			text += "#define FRAGMENT_SHADER\n";
+		else
+			text += "#define GEOMETRY_SHADER\n";
+		for (auto const & k : KeywordDefines())
+		{
+			if (keywords & static_cast<ShaderKeywords>(k.first))
+				text += "#define " + k.second + "\n";
+		}
+		return text + preprocessed;
+	}
+
+	std::vector<std::pair<ShaderKeyword, std::string>> const & ShaderCompiler::KeywordDefines()
+	{
+		static const std::vector<std::pair<ShaderKeyword, std::string>> defines = {
+			{ ShaderKeyword::AmbientIBL, "_AMBIENT_IBL" },
+		};
+		return defines;
+	}
+
+	std::vector<ShaderKeywords> ShaderCompiler::KeywordVariants()
+	{
+		// every subset of the bits of ShaderKeyword::All
+		const auto all = static_cast<ShaderKeywords>(ShaderKeyword::All);
+		std::vector<ShaderKeywords> variants;
+		ShaderKeywords subset = 0;
+		do
+		{
+			variants.push_back(subset);
+			subset = (subset - all) & all;
+		} while (subset != 0);
+		return variants;
+	}
+
+	std::vector<ShaderDiagnostic> ShaderCompiler::MapDiagnostics(const std::string& log)
+	{
+		// glslang, Mesa, AMD: "ERROR: 2:14: ...", "0:14(5): error: ..."
+		// NVIDIA: "2(14) : error C0000: ..."
+		static const std::regex colonFormat(R"(^\s*(?:(?:ERROR|WARNING):\s*)?(\d+):(\d+)(?:\(\d+\))?:\s*(.*)$)");
+		static const std::regex parenFormat(R"(^\s*(\d+)\((\d+)\)\s*:\s*(.*)$)");
+
+		std::vector<ShaderDiagnostic> diagnostics;
+		std::istringstream sin(log);
+		std::string line;
+		while (std::getline(sin, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+			if (boost::trim_copy(line).empty())
+				continue;
+			ShaderDiagnostic d;
+			std::smatch m;
+			if (std::regex_match(line, m, colonFormat) || std::regex_match(line, m, parenFormat))
+			{
+				d.file = SourcePath(std::stoi(m[1].str()));
+				d.line = std::stoi(m[2].str());
+				d.message = m[3].str();
+			}
+			else
+			{
+				d.message = line;
+			}
+			diagnostics.push_back(std::move(d));
+		}
+		return diagnostics;
 	}
 	
 	ShaderBlendFactor ParseShaderBlendFactor(std::string const & str)
@@ -335,7 +462,7 @@ namespace FishEngine
 		throw ShaderCompileError(ShaderCompileStage::Preprocessor, 0, ShaderCompileErrorType::UnknownType);
 	}
 
-	std::string ShaderCompiler::PreprocessImpl(const std::string& shaderText, const Path& localDir)
+	std::string ShaderCompiler::PreprocessImpl(const std::string& shaderText, const Path& localDir, int fileIndex, int firstLine)
 	{
 		std::string parsed;
 		parsed.reserve(shaderText.size());
@@ -381,6 +508,7 @@ namespace FishEngine
 				string parsed_header_text = PreprocessShaderFile(header_path);
 				//out_parsedShaderText += shaderText.substr(begin_of_this_tok, begin-begin_of_this_tok);
 				parsed += parsed_header_text + "\n";
+				appendLineDirective(parsed, lineAt(shaderText, cursor, firstLine), fileIndex);
 			}
 			else if (tok == "uniform")
 			{
@@ -429,20 +557,21 @@ namespace FishEngine
 						tokenizer.ExpectEndOfFile();
 						m_savedProperties.AddProperty(name, displayName, type, defaultValue);
 					}
+					appendLineDirective(parsed, lineAt(shaderText, cursor, firstLine), fileIndex);
 				}
 				else if (tok == "@vertex")
 				{
-					parsed += parseSubShader(shaderText, cursor, "VERTEX_SHADER", localDir);
+					parsed += parseSubShader(shaderText, cursor, "VERTEX_SHADER", localDir, fileIndex, firstLine);
 				}
 				else if (tok == "@geometry")
 				{
 					LogInfo("Geometry shader enabled");
 					m_hasGeometryShader = true;
-					parsed += parseSubShader(shaderText, cursor, "GEOMETRY_SHADER", localDir);
+					parsed += parseSubShader(shaderText, cursor, "GEOMETRY_SHADER", localDir, fileIndex, firstLine);
 				}
 				else if (tok == "@fragment")
 				{
-					parsed += parseSubShader(shaderText, cursor, "FRAGMENT_SHADER", localDir);
+					parsed += parseSubShader(shaderText, cursor, "FRAGMENT_SHADER", localDir, fileIndex, firstLine);
 				}
 				else    // keyword
 				{
@@ -514,19 +643,29 @@ namespace FishEngine
 		return parsed;
 	}
 
-	std::string ShaderCompiler::parseSubShader(const std::string& shaderText, size_t& cursor, const std::string& str, const Path& localDir)
+	std::string ShaderCompiler::parseSubShader(const std::string& shaderText, size_t& cursor, const std::string& str, const Path& localDir, int fileIndex, int firstLine)
 	{
 		std::string out_parsedShaderText;
 		ignoreSpace(shaderText, cursor);
 		expect(shaderText, cursor, "{");
 		//cout << "vertex begin"  << endl;
+		// "#ifdef" takes the place of '{', the body keeps its lines
+		out_parsedShaderText += '\n';
+		appendLineDirective(out_parsedShaderText, lineAt(shaderText, cursor, firstLine), fileIndex);
 		out_parsedShaderText += "#ifdef " + str;
 		size_t right = findPair(shaderText, cursor);
+		if (right == npos)
+		{
+			throw ShaderCompileError(ShaderCompileStage::Preprocessor, 0, ShaderCompileErrorType::InvalidSyntax);
+		}
 		//std::cout << shaderText.substr(begin, right - begin) << std::endl;
-		string parsed = PreprocessImpl(shaderText.substr(cursor, right - cursor), localDir);
+		string parsed = PreprocessImpl(shaderText.substr(cursor, right - cursor), localDir, fileIndex, lineAt(shaderText, cursor, firstLine));
 		out_parsedShaderText += parsed;
+		if (!out_parsedShaderText.empty() && out_parsedShaderText.back() != '\n')
+			out_parsedShaderText += '\n';
 		out_parsedShaderText += "#endif /*" + str + "*/\n";
 		cursor = right + 1;
+		appendLineDirective(out_parsedShaderText, lineAt(shaderText, cursor, firstLine), fileIndex);
 		return out_parsedShaderText;
 	}
 
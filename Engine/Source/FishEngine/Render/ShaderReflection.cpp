@@ -0,0 +1,845 @@
+#include <FishEngine/Render/Shader/ShaderReflection.hpp>
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <boost/algorithm/string.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	bool IsIdentifierStart(char c)
+	{
+		return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+	}
+
+	bool IsIdentifierChar(char c)
+	{
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+	}
+
+	// Comments are replaced by a space, keeping their newlines.
+	std::string StripComments(const std::string& text)
+	{
+		std::string out;
+		out.reserve(text.size());
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			if (text[i] == '/' && i + 1 < text.size() && text[i + 1] == '/')
+			{
+				while (i < text.size() && text[i] != '\n')
+					++i;
+				out += ' ';
+				if (i < text.size())
+					out += '\n';
+			}
+			else if (text[i] == '/' && i + 1 < text.size() && text[i + 1] == '*')
+			{
+				out += ' ';
+				for (i += 2; i < text.size() && !(text[i] == '*' && i + 1 < text.size() && text[i + 1] == '/'); ++i)
+				{
+					if (text[i] == '\n')
+						out += '\n';
+				}
+				++i;
+			}
+			else
+			{
+				out += text[i];
+			}
+		}
+		return out;
+	}
+
+	struct Macro
+	{
+		bool						functionLike = false;
+		std::vector<std::string>	params;
+		std::string					body;
+	};
+
+	// Integer expressions of #if. Identifiers left after the macro expansion are 0.
+	class ExpressionParser
+	{
+	public:
+		explicit ExpressionParser(const std::string& text) : m_text(text) { }
+
+		bool Evaluate(long long& value)
+		{
+			value = Or();
+			SkipSpace();
+			return m_ok && m_cursor == m_text.size();
+		}
+
+		long long Or()
+		{
+			auto v = And();
+			while (Accept("||")) { auto r = And(); v = v || r; }
+			return v;
+		}
+
+		long long And()
+		{
+			auto v = BitOr();
+			while (Accept("&&")) { auto r = BitOr(); v = v && r; }
+			return v;
+		}
+
+		long long BitOr()
+		{
+			auto v = BitXor();
+			while (!Peek("||") && Accept("|")) v |= BitXor();
+			return v;
+		}
+
+		long long BitXor()
+		{
+			auto v = BitAnd();
+			while (Accept("^")) v ^= BitAnd();
+			return v;
+		}
+
+		long long BitAnd()
+		{
+			auto v = Equality();
+			while (!Peek("&&") && Accept("&")) v &= Equality();
+			return v;
+		}
+
+		long long Equality()
+		{
+			auto v = Relational();
+			for (;;)
+			{
+				if (Accept("==")) v = (v == Relational());
+				else if (Accept("!=")) v = (v != Relational());
+				else return v;
+			}
+		}
+
+		long long Relational()
+		{
+			auto v = Shift();
+			for (;;)
+			{
+				if (Accept("<=")) v = (v <= Shift());
+				else if (Accept(">=")) v = (v >= Shift());
+				else if (!Peek("<<") && Accept("<")) v = (v < Shift());
+				else if (!Peek(">>") && Accept(">")) v = (v > Shift());
+				else return v;
+			}
+		}
+
+		long long Shift()
+		{
+			auto v = Additive();
+			for (;;)
+			{
+				if (Accept("<<")) v <<= Additive();
+				else if (Accept(">>")) v >>= Additive();
+				else return v;
+			}
+		}
+
+		long long Additive()
+		{
+			auto v = Multiplicative();
+			for (;;)
+			{
+				if (Accept("+")) v += Multiplicative();
+				else if (Accept("-")) v -= Multiplicative();
+				else return v;
+			}
+		}
+
+		long long Multiplicative()
+		{
+			auto v = Unary();
+			for (;;)
+			{
+				if (Accept("*")) v *= Unary();
+				else if (Accept("/") || Accept("%"))
+				{
+					bool division = m_text[m_cursor - 1] == '/';
+					auto r = Unary();
+					if (r == 0) { m_ok = false; return 0; }
+					v = division ? v / r : v % r;
+				}
+				else return v;
+			}
+		}
+
+		long long Unary()
+		{
+			if (Accept("!")) return !Unary();
+			if (Accept("-")) return -Unary();
+			if (Accept("+")) return Unary();
+			if (Accept("~")) return ~Unary();
+			return Primary();
+		}
+
+		long long Primary()
+		{
+			SkipSpace();
+			if (Accept("("))
+			{
+				auto v = Or();
+				if (!Accept(")"))
+					m_ok = false;
+				return v;
+			}
+			if (m_cursor < m_text.size() && std::isdigit(static_cast<unsigned char>(m_text[m_cursor])))
+			{
+				size_t end = 0;
+				long long v = 0;
+				try
+				{
+					v = std::stoll(m_text.substr(m_cursor), &end, 0);
+				}
+				catch (const std::exception&)
+				{
+					m_ok = false;
+					return 0;
+				}
+				m_cursor += end;
+				while (m_cursor < m_text.size() && (m_text[m_cursor] == 'u' || m_text[m_cursor] == 'U'))
+					m_cursor++;
+				return v;
+			}
+			if (m_cursor < m_text.size() && IsIdentifierStart(m_text[m_cursor]))
+			{
+				while (m_cursor < m_text.size() && IsIdentifierChar(m_text[m_cursor]))
+					m_cursor++;
+				return 0;
+			}
+			m_ok = false;
+			return 0;
+		}
+
+	private:
+		void SkipSpace()
+		{
+			while (m_cursor < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_cursor])))
+				m_cursor++;
+		}
+
+		bool Peek(const char* op)
+		{
+			SkipSpace();
+			return m_text.compare(m_cursor, std::strlen(op), op) == 0;
+		}
+
+		bool Accept(const char* op)
+		{
+			if (!Peek(op))
+				return false;
+			m_cursor += std::strlen(op);
+			return true;
+		}
+
+		const std::string&	m_text;
+		size_t				m_cursor = 0;
+		bool				m_ok = true;
+	};
+
+	class Preprocessor
+	{
+	public:
+		std::vector<ShaderDiagnostic>	errors;
+
+		Preprocessor()
+		{
+			m_macros["__VERSION__"].body = "410";
+			m_macros["GL_core_profile"].body = "1";
+		}
+
+		// The active lines of source, with the macros expanded.
+		std::string Run(const std::string& source)
+		{
+			std::vector<std::string> lines;
+			boost::split(lines, StripComments(source), boost::is_any_of("\n"));
+
+			struct Conditional
+			{
+				bool	parentActive;
+				bool	active;
+				bool	taken;		// a branch was active
+			};
+			std::vector<Conditional> conditionals;
+			auto active = [&conditionals]() { return conditionals.empty() || conditionals.back().active; };
+
+			std::string out;
+			m_fileIndex = 0;
+			m_line = 1;
+			for (size_t i = 0; i < lines.size(); ++i)
+			{
+				auto line = lines[i];
+				int consumed = 1;
+				while (!line.empty() && line.back() == '\\' && i + 1 < lines.size())
+				{
+					line.pop_back();
+					line += lines[++i];
+					consumed++;
+				}
+				int lineNumber = m_line;
+				m_line += consumed;
+
+				auto trimmed = boost::trim_copy(line);
+				if (trimmed.empty() || trimmed[0] != '#')
+				{
+					if (active())
+					{
+						std::set<std::string> disabled;
+						out += Expand(line, disabled, 0);
+					}
+					out += '\n';
+					continue;
+				}
+				out += '\n';
+
+				size_t cursor = 1;
+				while (cursor < trimmed.size() && std::isspace(static_cast<unsigned char>(trimmed[cursor])))
+					cursor++;
+				auto nameBegin = cursor;
+				while (cursor < trimmed.size() && IsIdentifierChar(trimmed[cursor]))
+					cursor++;
+				auto directive = trimmed.substr(nameBegin, cursor - nameBegin);
+				auto argument = boost::trim_copy(trimmed.substr(cursor));
+
+				if (directive == "if" || directive == "ifdef" || directive == "ifndef")
+				{
+					bool value = false;
+					if (active())
+					{
+						if (directive == "if")
+							value = Condition(argument, lineNumber);
+						else
+							value = (m_macros.count(FirstIdentifier(argument)) != 0) == (directive == "ifdef");
+					}
+					conditionals.push_back({ active(), value, value });
+				}
+				else if (directive == "elif" || directive == "else")
+				{
+					if (conditionals.empty())
+					{
+						Error(lineNumber, "#" + directive + " without #if");
+						continue;
+					}
+					auto & c = conditionals.back();
+					bool value = c.parentActive && !c.taken && (directive == "else" || Condition(argument, lineNumber));
+					c.active = value;
+					c.taken = c.taken || value;
+				}
+				else if (directive == "endif")
+				{
+					if (conditionals.empty())
+						Error(lineNumber, "#endif without #if");
+					else
+						conditionals.pop_back();
+				}
+				else if (!active())
+				{
+					continue;
+				}
+				else if (directive == "define")
+				{
+					Define(argument);
+				}
+				else if (directive == "undef")
+				{
+					m_macros.erase(FirstIdentifier(argument));
+				}
+				else if (directive == "line")
+				{
+					// the next line is line (GLSL 330+)
+					std::istringstream sin(argument);
+					int line = 0, file = m_fileIndex;
+					if (sin >> line)
+					{
+						sin >> file;
+						m_line = line;
+						m_fileIndex = file;
+					}
+				}
+				else if (directive == "error")
+				{
+					Error(lineNumber, "#error " + argument);
+				}
+				// #version, #extension, #pragma: nothing to do
+			}
+			if (!conditionals.empty())
+				Error(m_line - 1, "unterminated #if");
+			return out;
+		}
+
+	private:
+		std::map<std::string, Macro>	m_macros;
+		int								m_fileIndex = 0;
+		int								m_line = 1;
+
+		static std::string FirstIdentifier(const std::string& text)
+		{
+			size_t begin = 0;
+			while (begin < text.size() && !IsIdentifierStart(text[begin]))
+				begin++;
+			size_t end = begin;
+			while (end < text.size() && IsIdentifierChar(text[end]))
+				end++;
+			return text.substr(begin, end - begin);
+		}
+
+		void Error(int line, const std::string& message)
+		{
+			ShaderDiagnostic d;
+			d.file = ShaderCompiler::SourcePath(m_fileIndex);
+			d.line = line;
+			d.message = message;
+			errors.push_back(std::move(d));
+		}
+
+		void Define(const std::string& argument)
+		{
+			size_t cursor = 0;
+			while (cursor < argument.size() && IsIdentifierChar(argument[cursor]))
+				cursor++;
+			auto name = argument.substr(0, cursor);
+			Macro macro;
+			if (cursor < argument.size() && argument[cursor] == '(')
+			{
+				macro.functionLike = true;
+				auto end = argument.find(')', cursor);
+				if (end == std::string::npos)
+					end = argument.size();
+				auto params = argument.substr(cursor + 1, end - cursor - 1);
+				boost::split(macro.params, params, boost::is_any_of(","));
+				for (auto & p : macro.params)
+					boost::trim(p);
+				if (macro.params.size() == 1 && macro.params[0].empty())
+					macro.params.clear();
+				cursor = std::min(end + 1, argument.size());
+			}
+			macro.body = boost::trim_copy(argument.substr(cursor));
+			m_macros[name] = std::move(macro);
+		}
+
+		bool Condition(const std::string& expression, int line)
+		{
+			// "defined X" and "defined(X)" are resolved before the macro expansion
+			std::string text;
+			for (size_t i = 0; i < expression.size(); )
+			{
+				if (IsIdentifierStart(expression[i]))
+				{
+					auto begin = i;
+					while (i < expression.size() && IsIdentifierChar(expression[i]))
+						i++;
+					auto word = expression.substr(begin, i - begin);
+					if (word != "defined")
+					{
+						text += word;
+						continue;
+					}
+					while (i < expression.size() && (std::isspace(static_cast<unsigned char>(expression[i])) || expression[i] == '('))
+						i++;
+					begin = i;
+					while (i < expression.size() && IsIdentifierChar(expression[i]))
+						i++;
+					text += m_macros.count(expression.substr(begin, i - begin)) ? " 1 " : " 0 ";
+					while (i < expression.size() && (std::isspace(static_cast<unsigned char>(expression[i])) || expression[i] == ')'))
+						i++;
+				}
+				else
+				{
+					text += expression[i++];
+				}
+			}
+			std::set<std::string> disabled;
+			text = Expand(text, disabled, 0);
+			long long value = 0;
+			if (!ExpressionParser(text).Evaluate(value))
+			{
+				Error(line, "invalid #if expression: " + expression);
+				return false;
+			}
+			return value != 0;
+		}
+
+		std::string Expand(const std::string& text, std::set<std::string>& disabled, int depth)
+		{
+			if (depth > 32)
+				return text;
+			std::string out;
+			out.reserve(text.size());
+			size_t i = 0;
+			while (i < text.size())
+			{
+				char c = text[i];
+				if (std::isdigit(static_cast<unsigned char>(c)))
+				{
+					// 1.0f, 0x1F: not identifiers
+					auto begin = i;
+					while (i < text.size() && (IsIdentifierChar(text[i]) || text[i] == '.'))
+						i++;
+					out += text.substr(begin, i - begin);
+					continue;
+				}
+				if (!IsIdentifierStart(c))
+				{
+					out += c;
+					i++;
+					continue;
+				}
+
+				auto begin = i;
+				while (i < text.size() && IsIdentifierChar(text[i]))
+					i++;
+				auto name = text.substr(begin, i - begin);
+				auto it = m_macros.find(name);
+				if (it == m_macros.end() || disabled.count(name))
+				{
+					out += name;
+					continue;
+				}
+				const auto & macro = it->second;
+				if (!macro.functionLike)
+				{
+					disabled.insert(name);
+					out += Expand(macro.body, disabled, depth + 1);
+					disabled.erase(name);
+					continue;
+				}
+
+				auto k = i;
+				while (k < text.size() && std::isspace(static_cast<unsigned char>(text[k])))
+					k++;
+				if (k >= text.size() || text[k] != '(')
+				{
+					out += name;
+					continue;
+				}
+				std::vector<std::string> args(1);
+				int level = 0;
+				size_t end = k + 1;
+				for (; end < text.size(); ++end)
+				{
+					char a = text[end];
+					if (a == '(')
+						level++;
+					else if (a == ')' && level-- == 0)
+						break;
+					else if (a == ',' && level == 0)
+					{
+						args.emplace_back();
+						continue;
+					}
+					args.back() += a;
+				}
+				if (end >= text.size())
+				{
+					out += name;
+					continue;
+				}
+				for (auto & a : args)
+					a = boost::trim_copy(Expand(a, disabled, depth + 1));
+
+				std::string body;
+				const auto & b = macro.body;
+				for (size_t j = 0; j < b.size(); )
+				{
+					if (!IsIdentifierStart(b[j]))
+					{
+						body += b[j++];
+						continue;
+					}
+					auto wb = j;
+					while (j < b.size() && IsIdentifierChar(b[j]))
+						j++;
+					auto word = b.substr(wb, j - wb);
+					auto p = std::find(macro.params.begin(), macro.params.end(), word);
+					if (p != macro.params.end() && static_cast<size_t>(p - macro.params.begin()) < args.size())
+						body += args[p - macro.params.begin()];
+					else
+						body += word;
+				}
+				disabled.insert(name);
+				out += Expand(body, disabled, depth + 1);
+				disabled.erase(name);
+				i = end + 1;
+			}
+			return out;
+		}
+	};
+
+	GLenum TypeOf(const std::string& name)
+	{
+		static const std::map<std::string, GLenum> types = {
+			{ "float", GL_FLOAT },
+			{ "vec2", GL_FLOAT_VEC2 },
+			{ "vec3", GL_FLOAT_VEC3 },
+			{ "vec4", GL_FLOAT_VEC4 },
+			{ "int", GL_INT },
+			{ "ivec2", GL_INT_VEC2 },
+			{ "ivec3", GL_INT_VEC3 },
+			{ "ivec4", GL_INT_VEC4 },
+			{ "uint", GL_UNSIGNED_INT },
+			{ "uvec2", GL_UNSIGNED_INT_VEC2 },
+			{ "uvec3", GL_UNSIGNED_INT_VEC3 },
+			{ "uvec4", GL_UNSIGNED_INT_VEC4 },
+			{ "bool", GL_BOOL },
+			{ "bvec2", GL_BOOL_VEC2 },
+			{ "bvec3", GL_BOOL_VEC3 },
+			{ "bvec4", GL_BOOL_VEC4 },
+			{ "mat2", GL_FLOAT_MAT2 },
+			{ "mat3", GL_FLOAT_MAT3 },
+			{ "mat4", GL_FLOAT_MAT4 },
+			{ "mat3x4", GL_FLOAT_MAT3x4 },
+			{ "mat4x3", GL_FLOAT_MAT4x3 },
+			{ "sampler2D", GL_SAMPLER_2D },
+			{ "sampler3D", GL_SAMPLER_3D },
+			{ "samplerCube", GL_SAMPLER_CUBE },
+			{ "sampler2DArray", GL_SAMPLER_2D_ARRAY },
+			{ "sampler2DShadow", GL_SAMPLER_2D_SHADOW },
+			{ "sampler2DArrayShadow", GL_SAMPLER_2D_ARRAY_SHADOW },
+			{ "samplerCubeShadow", GL_SAMPLER_CUBE_SHADOW },
+		};
+		auto it = types.find(name);
+		return it == types.end() ? 0 : it->second;
+	}
+
+	std::vector<std::string> Tokenize(const std::string& text)
+	{
+		std::vector<std::string> tokens;
+		for (size_t i = 0; i < text.size(); )
+		{
+			char c = text[i];
+			if (std::isspace(static_cast<unsigned char>(c)))
+			{
+				i++;
+			}
+			else if (IsIdentifierChar(c))
+			{
+				auto begin = i;
+				while (i < text.size() && (IsIdentifierChar(text[i]) || text[i] == '.'))
+					i++;
+				tokens.push_back(text.substr(begin, i - begin));
+			}
+			else
+			{
+				tokens.push_back(std::string(1, c));
+				i++;
+			}
+		}
+		return tokens;
+	}
+
+	const std::set<std::string> s_qualifiers = {
+		"uniform", "in", "out", "inout", "attribute", "varying", "const", "flat", "smooth", "noperspective",
+		"centroid", "invariant", "highp", "mediump", "lowp", "precise",
+	};
+
+	// A declaration: [layout(...)] qualifiers type name[N] (, name[N])*
+	// Returns the variables, and the qualifiers in qualifiers.
+	std::vector<ShaderReflection::Variable> ParseDeclaration(
+		const std::vector<std::string>& tokens,
+		std::set<std::string>& qualifiers)
+	{
+		std::vector<ShaderReflection::Variable> variables;
+		int location = -1;
+		size_t i = 0;
+		while (i < tokens.size())
+		{
+			if (tokens[i] == "layout" && i + 1 < tokens.size() && tokens[i + 1] == "(")
+			{
+				for (i += 2; i < tokens.size() && tokens[i] != ")"; ++i)
+				{
+					if (tokens[i] == "location" && i + 2 < tokens.size() && tokens[i + 1] == "=")
+					{
+						long long value = -1;
+						if (ExpressionParser(tokens[i + 2]).Evaluate(value))
+							location = static_cast<int>(value);
+					}
+				}
+				i++;
+			}
+			else if (s_qualifiers.count(tokens[i]))
+			{
+				qualifiers.insert(tokens[i++]);
+			}
+			else
+			{
+				break;
+			}
+		}
+		if (i >= tokens.size())
+			return variables;
+		auto typeName = tokens[i++];
+
+		while (i < tokens.size())
+		{
+			ShaderReflection::Variable v;
+			v.typeName = typeName;
+			v.type = TypeOf(typeName);
+			v.name = tokens[i++];
+			v.location = location;
+			if (!IsIdentifierStart(v.name[0]))
+				break;
+			if (i < tokens.size() && tokens[i] == "[")
+			{
+				std::string size;
+				for (i++; i < tokens.size() && tokens[i] != "]"; ++i)
+					size += tokens[i] + " ";
+				i++;
+				long long value = 0;
+				if (ExpressionParser(size).Evaluate(value))
+					v.arraySize = static_cast<int>(value);
+			}
+			variables.push_back(std::move(v));
+			// initializer
+			int level = 0;
+			for (; i < tokens.size(); ++i)
+			{
+				auto const & t = tokens[i];
+				if (t == "(" || t == "[" || t == "{") level++;
+				else if (t == ")" || t == "]" || t == "}") level--;
+				else if (t == "," && level == 0) break;
+			}
+			i++;
+		}
+		return variables;
+	}
+
+	std::string Declaration(const ShaderReflection::Variable& v)
+	{
+		auto s = v.typeName + " " + v.name;
+		if (v.arraySize > 0)
+			s += "[" + std::to_string(v.arraySize) + "]";
+		if (v.location >= 0)
+			s += " (location " + std::to_string(v.location) + ")";
+		return s;
+	}
+}
+
+
+namespace FishEngine
+{
+	ShaderReflection ShaderReflection::Reflect(const std::string& source, ShaderType stage)
+	{
+		ShaderReflection reflection;
+		Preprocessor preprocessor;
+		auto tokens = Tokenize(preprocessor.Run(source));
+		reflection.errors = std::move(preprocessor.errors);
+
+		// declarations at global scope
+		std::vector<std::string> statement;
+		for (size_t i = 0; i < tokens.size(); ++i)
+		{
+			auto const & t = tokens[i];
+			if (t != ";" && t != "{")
+			{
+				statement.push_back(t);
+				continue;
+			}
+
+			bool isUniform = std::find(statement.begin(), statement.end(), "uniform") != statement.end();
+			if (t == "{")
+			{
+				// uniform block, or a function / struct: skipped
+				auto bodyBegin = i + 1;
+				int level = 1;
+				for (i++; i < tokens.size() && level > 0; ++i)
+				{
+					if (tokens[i] == "{") level++;
+					else if (tokens[i] == "}") level--;
+				}
+				i--;	// '}'
+				if (isUniform && !statement.empty())
+				{
+					Block block;
+					block.name = statement.back();
+					std::vector<std::string> member;
+					for (auto j = bodyBegin; j < i; ++j)
+					{
+						if (tokens[j] != ";")
+						{
+							member.push_back(tokens[j]);
+							continue;
+						}
+						std::set<std::string> qualifiers;
+						for (auto & v : ParseDeclaration(member, qualifiers))
+							block.members.push_back(std::move(v));
+						member.clear();
+					}
+					reflection.blocks.push_back(std::move(block));
+					// instance name
+					while (i + 1 < tokens.size() && tokens[i + 1] != ";")
+						i++;
+					i++;
+				}
+				statement.clear();
+				continue;
+			}
+
+			std::set<std::string> qualifiers;
+			auto variables = ParseDeclaration(statement, qualifiers);
+			statement.clear();
+			if (qualifiers.count("uniform"))
+			{
+				for (auto & v : variables)
+					reflection.uniforms.push_back(std::move(v));
+			}
+			else if (stage == ShaderType::VertexShader && (qualifiers.count("in") || qualifiers.count("attribute")))
+			{
+				for (auto & v : variables)
+					reflection.attributes.push_back(std::move(v));
+			}
+		}
+		return reflection;
+	}
+
+	void ShaderReflection::Merge(const ShaderReflection& other)
+	{
+		for (auto const & u : other.uniforms)
+		{
+			auto it = std::find_if(uniforms.begin(), uniforms.end(), [&u](const Variable& v) { return v.name == u.name; });
+			if (it == uniforms.end())
+				uniforms.push_back(u);
+		}
+		for (auto const & b : other.blocks)
+		{
+			auto it = std::find_if(blocks.begin(), blocks.end(), [&b](const Block& v) { return v.name == b.name; });
+			if (it == blocks.end())
+				blocks.push_back(b);
+		}
+		for (auto const & a : other.attributes)
+		{
+			auto it = std::find_if(attributes.begin(), attributes.end(), [&a](const Variable& v) { return v.name == a.name; });
+			if (it == attributes.end())
+				attributes.push_back(a);
+		}
+		errors.insert(errors.end(), other.errors.begin(), other.errors.end());
+	}
+
+	std::string ShaderReflection::ToString() const
+	{
+		std::vector<std::string> lines;
+		for (auto const & a : attributes)
+			lines.push_back("in " + Declaration(a));
+		for (auto const & u : uniforms)
+			lines.push_back("uniform " + Declaration(u));
+		for (auto const & b : blocks)
+		{
+			std::string line = "block " + b.name + " {";
+			for (auto const & m : b.members)
+				line += " " + Declaration(m) + ";";
+			lines.push_back(line + " }");
+		}
+		std::sort(lines.begin(), lines.end());
+		std::string text;
+		for (auto const & l : lines)
+			text += l + "\n";
+		return text;
+	}
+}
@@ -0,0 +1,223 @@
+#include <FishEngine/ShaderVariantCollection.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/algorithm/string.hpp>
+
+#include <FishEngine/Application.hpp>
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/GLEnvironment.hpp>
+
+namespace FishEngine
+{
+	bool ShaderVariantCollection::s_recording = false;
+	ShaderVariantCollection ShaderVariantCollection::s_recorded;
+
+	uint32_t ShaderVariantCollection::Merge(ShaderVariantCollection const & other)
+	{
+		auto before = m_variants.size();
+		m_variants.insert(other.m_variants.begin(), other.m_variants.end());
+		return static_cast<uint32_t>(m_variants.size() - before);
+	}
+
+	void ShaderVariantCollection::Parse(std::string const & text)
+	{
+		auto const & defines = ShaderCompiler::KeywordDefines();
+		std::istringstream is(text);
+		std::string line;
+		while (std::getline(is, line))
+		{
+			boost::trim(line);
+			if (line.empty() || line[0] == '#')
+				continue;
+			std::vector<std::string> fields;
+			boost::split(fields, line, boost::is_any_of("\t"), boost::token_compress_on);
+			ShaderKeywords keywords = 0;
+			bool known = true;
+			for (size_t i = 1; i < fields.size() && known; ++i)
+			{
+				auto it = std::find_if(defines.begin(), defines.end(), [&fields, i](auto const & d) { return d.second == fields[i]; });
+				if (it == defines.end())
+				{
+					LogWarning(Format("Unknown shader keyword %1%, variant %2% skipped", fields[i], fields[0]));
+					known = false;
+				}
+				else
+				{
+					keywords |= static_cast<ShaderKeywords>(it->first);
+				}
+			}
+			if (known)
+				Add(fields[0], keywords);
+		}
+	}
+
+	std::string ShaderVariantCollection::ToString() const
+	{
+		auto const & defines = ShaderCompiler::KeywordDefines();
+		std::ostringstream os;
+		os << "# shader\tkeywords...\n";
+		for (auto const & v : m_variants)
+		{
+			os << v.shader;
+			for (auto const & d : defines)
+			{
+				if (v.keywords & static_cast<ShaderKeywords>(d.first))
+					os << '\t' << d.second;
+			}
+			os << '\n';
+		}
+		return os.str();
+	}
+
+	bool ShaderVariantCollection::Load(Path const & path)
+	{
+		std::ifstream fin(path.string());
+		if (!fin)
+			return false;
+		std::stringstream buffer;
+		buffer << fin.rdbuf();
+		Parse(buffer.str());
+		return true;
+	}
+
+	bool ShaderVariantCollection::Save(Path const & path) const
+	{
+		std::ofstream fout(path.string());
+		if (!fout)
+		{
+			LogWarning(Format("Can not write %1%", path.string()));
+			return false;
+		}
+		fout << ToString();
+		return true;
+	}
+
+	Path ShaderVariantCollection::ProjectCollectionPath()
+	{
+		return Application::dataPath() / "ShaderVariants.shadervariants";
+	}
+
+	void ShaderVariantCollection::StartRecording()
+	{
+		s_recorded.Clear();
+		s_recording = true;
+	}
+
+	void ShaderVariantCollection::StopRecording()
+	{
+		s_recording = false;
+	}
+
+
+	ShaderWarmUp::ShaderWarmUp(ShaderVariantCollection const & collection)
+	{
+		std::vector<ShaderPtr> shaders;
+		Object::FindObjectsOfType<Shader>(shaders);
+		std::map<std::string, ShaderPtr> byName;
+		for (auto & s : shaders)
+			byName.emplace(s->name(), s);
+
+		for (auto const & v : collection.variants())
+		{
+			auto it = byName.find(v.shader);
+			if (it == byName.end())
+			{
+				LogWarning(Format("ShaderWarmUp: shader %1% not found", v.shader));
+				m_missing++;
+				continue;
+			}
+			m_jobs.push_back({ it->second, v.keywords });
+		}
+
+		m_parallel = parallelCompileSupported();
+		if (m_parallel)
+		{
+			for (auto & job : m_jobs)
+			{
+				// compiled already, or failed
+				if (!job.shader->StartCompileVariant(job.keywords))
+					Finish(job);
+			}
+		}
+	}
+
+	void ShaderWarmUp::Finish(Job & job)
+	{
+		if (!job.shader->FinishCompileVariant(job.keywords))
+			m_failed++;
+		job.finished = true;
+		m_finished++;
+	}
+
+	bool ShaderWarmUp::Update(float maxMilliseconds)
+	{
+		using clock = std::chrono::high_resolution_clock;
+		auto start = clock::now();
+		auto elapsed = [start]() {
+			return std::chrono::duration<float, std::milli>(clock::now() - start).count();
+		};
+
+		if (m_parallel)
+		{
+			// collecting a program which is ready does not wait for the driver
+			for (auto & job : m_jobs)
+			{
+				if (elapsed() >= maxMilliseconds)
+					break;
+				if (!job.finished && job.shader->IsVariantReady(job.keywords))
+					Finish(job);
+			}
+		}
+		else
+		{
+			do
+			{
+				if (m_next >= m_jobs.size())
+					break;
+				auto & job = m_jobs[m_next++];
+				job.shader->StartCompileVariant(job.keywords);
+				Finish(job);
+			} while (elapsed() < maxMilliseconds);
+		}
+		return done();
+	}
+
+	void ShaderWarmUp::Finish()
+	{
+		for (auto & job : m_jobs)
+		{
+			if (!job.finished)
+			{
+				if (!m_parallel)
+					job.shader->StartCompileVariant(job.keywords);
+				Finish(job);
+			}
+		}
+		m_next = m_jobs.size();
+	}
+
+	bool ShaderWarmUp::parallelCompileSupported()
+	{
+		static int supported = -1;
+		if (supported < 0)
+		{
+			supported = 0;
+			GLint count = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+			for (GLint i = 0; i < count && supported == 0; ++i)
+			{
+				auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+				if (name != nullptr && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0 || std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0))
+					supported = 1;
+			}
+		}
+		return supported == 1;
+	}
+}
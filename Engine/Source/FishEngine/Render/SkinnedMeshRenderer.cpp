@@ -107,7 +107,8 @@ namespace FishEngine
 		shader->Use();
 		shader->PreRender();
 		shader->CheckStatus();
-		m_sharedMesh->RenderSkinned();
+		auto mesh = m_activeLOD > 0 && m_activeLOD < m_sharedMesh->lodCount() ? m_sharedMesh->lod(m_activeLOD) : m_sharedMesh;
+		mesh->RenderSkinned();
 		shader->PostRender();
 		glCheckError();
 	}
@@ -0,0 +1,232 @@
+#include <FishEngine/StaticBatchingUtility.hpp>
+
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/Graphics.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/MeshRenderer.hpp>
+#include <FishEngine/GeometryUtility.hpp>
+
+#include <deque>
+#include <unordered_map>
+
+namespace
+{
+	using namespace FishEngine;
+
+	std::vector<StaticBatch> s_batches;
+}
+
+namespace FishEngine
+{
+	int StaticBatch::Draw(MaterialPtr const & material, const Vector4* planes, bool shadowCasters /*= false*/) const
+	{
+		auto visible = VisibleRanges(planes, shadowCasters);
+		if (!visible.empty())
+			Graphics::DrawMesh(mesh, material, visible);
+		return static_cast<int>(visible.size());
+	}
+
+	std::vector<IndexRange> StaticBatch::VisibleRanges(const Vector4* planes, bool shadowCasters /*= false*/) const
+	{
+		std::vector<IndexRange> visible;
+		visible.reserve(ranges.size());
+		for (auto const & r : ranges)
+		{
+			auto const & renderer = r.renderer;
+			if (!renderer->enabled())
+				continue;
+			if (shadowCasters && renderer->shadowCastingMode() == ShadowCastingMode::Off)
+				continue;
+			auto go = renderer->gameObject();
+			if (go == nullptr || !go->activeInHierarchy())
+				continue;
+			if (planes != nullptr && !GeometryUtility::TestPlanesAABB(planes, r.bounds))
+				continue;
+
+			// the ranges of a batch are contiguous in the order they were appended
+			if (!visible.empty() && visible.back().start + visible.back().count == r.indices.start)
+				visible.back().count += r.indices.count;
+			else
+				visible.push_back(r.indices);
+		}
+		return visible;
+	}
+
+
+	void StaticBatchingUtility::Combine(GameObjectPtr const & staticBatchRoot /*= nullptr*/)
+	{
+		std::deque<GameObjectPtr> todo;
+		if (staticBatchRoot == nullptr)
+			todo.insert(todo.end(), Scene::GameObjects().begin(), Scene::GameObjects().end());
+		else
+			todo.push_back(staticBatchRoot);
+
+		struct Item
+		{
+			MeshRendererPtr	renderer;
+			MeshPtr			mesh;
+			int				subMesh;	// -1: the whole mesh
+		};
+		// by material, in the order of the scene
+		std::vector<MaterialPtr> materials;
+		std::unordered_map<Material*, std::vector<Item>> items;
+		std::vector<MeshPtr> readBackMeshes;
+		int rendererCount = 0;
+		int drawCount = 0;
+
+		while (!todo.empty())
+		{
+			auto go = todo.front();
+			todo.pop_front();
+			for (auto && child : go->transform()->children())
+				todo.push_back(child->gameObject());
+
+			if (!go->isStatic() || !go->activeInHierarchy())
+				continue;
+			auto renderer = go->GetComponent<MeshRenderer>();
+			auto meshFilter = go->GetComponent<MeshFilter>();
+			if (renderer == nullptr || renderer->isPartOfStaticBatch() || meshFilter == nullptr)
+				continue;
+			auto mesh = meshFilter->mesh();
+			if (mesh == nullptr || mesh->m_skinned)
+				continue;
+			auto & rendererMaterials = renderer->materials();
+			if (rendererMaterials.empty())
+				continue;
+			const int subMeshCount = static_cast<int>(mesh->subMeshCount());
+			if (subMeshCount > 1 && static_cast<int>(rendererMaterials.size()) > subMeshCount)
+				continue;
+			if (go->transform()->localToWorldMatrix().determinant() < 0)
+				continue;
+			bool transparent = false;
+			for (auto & m : rendererMaterials)
+			{
+				if (m != nullptr && m->shader()->IsTransparent())
+					transparent = true;
+			}
+			if (transparent)
+				continue;
+
+			if (!mesh->isReadable() && mesh->m_vertices.empty())
+			{
+				if (!mesh->ReadBackMeshData())
+					continue;
+				readBackMeshes.push_back(mesh);
+			}
+
+			rendererCount++;
+			for (int i = 0; i < static_cast<int>(rendererMaterials.size()); ++i)
+			{
+				auto & m = rendererMaterials[i];
+				if (m == nullptr)
+					continue;
+				drawCount++;
+				auto & list = items[m.get()];
+				if (list.empty())
+					materials.push_back(m);
+				list.push_back({ renderer, mesh, subMeshCount == 1 ? -1 : i });
+			}
+		}
+
+		for (auto & material : materials)
+		{
+			auto batchMesh = std::make_shared<Mesh>();
+			StaticBatch batch;
+			batch.material = material;
+			for (auto & item : items[material.get()])
+			{
+				auto const & source = *item.mesh;
+				IndexRange indices;
+				if (item.subMesh < 0)
+					indices = { 0, static_cast<uint32_t>(source.m_triangles.size()) };
+				else
+					indices = { source.GetIndexStart(item.subMesh), source.GetIndexCount(item.subMesh) };
+				auto range = Append(*batchMesh, source, indices, item.renderer->transform()->localToWorldMatrix());
+				range.renderer = item.renderer;
+				batch.ranges.push_back(range);
+				item.renderer->m_isPartOfStaticBatch = true;
+			}
+			batchMesh->m_vertexCount = static_cast<uint32_t>(batchMesh->m_vertices.size());
+			batchMesh->m_triangleCount = static_cast<uint32_t>(batchMesh->m_triangles.size() / 3);
+			batchMesh->m_subMeshIndexOffset.push_back(0);
+			batchMesh->RecalculateBounds();
+			batchMesh->setName("Combined Mesh (" + material->name() + ")");
+			batchMesh->UploadMeshData();
+			batch.mesh = batchMesh;
+			s_batches.push_back(std::move(batch));
+		}
+
+		// the meshes read back for the combine do not keep their copy
+		for (auto & mesh : readBackMeshes)
+			mesh->Clear();
+
+		LogInfo(Format("Static batching: %1% renderers, %2% draws -> %3% batches", rendererCount, drawCount, materials.size()));
+	}
+
+
+	void StaticBatchingUtility::Clear()
+	{
+		for (auto & batch : s_batches)
+		{
+			for (auto & r : batch.ranges)
+				r.renderer->m_isPartOfStaticBatch = false;
+		}
+		s_batches.clear();
+	}
+
+
+	std::vector<StaticBatch> const & StaticBatchingUtility::batches()
+	{
+		return s_batches;
+	}
+
+
+	StaticBatchRange StaticBatchingUtility::Append(Mesh & destination, Mesh const & source, IndexRange indices, const Matrix4x4& localToWorld)
+	{
+		auto normalMatrix = localToWorld.inverse().transpose();
+		const bool hasNormals = !source.m_normals.empty();
+		const bool hasUV = !source.m_uv.empty();
+		const bool hasTangents = !source.m_tangents.empty();
+
+		auto & d = destination;
+		StaticBatchRange range;
+		range.indices.start = static_cast<uint32_t>(d.m_triangles.size());
+		range.indices.count = indices.count;
+
+		Vector3 bmin(Mathf::Infinity, Mathf::Infinity, Mathf::Infinity);
+		Vector3 bmax(Mathf::NegativeInfinity, Mathf::NegativeInfinity, Mathf::NegativeInfinity);
+
+		// source vertex -> destination vertex, only the vertices used by the range are copied
+		std::unordered_map<uint32_t, uint32_t> remap;
+		d.m_triangles.reserve(d.m_triangles.size() + indices.count);
+		for (uint32_t i = indices.start; i < indices.start + indices.count; ++i)
+		{
+			const uint32_t v = source.m_triangles[i];
+			auto it = remap.find(v);
+			if (it != remap.end())
+			{
+				d.m_triangles.push_back(it->second);
+				continue;
+			}
+			const uint32_t index = static_cast<uint32_t>(d.m_vertices.size());
+			remap[v] = index;
+			d.m_triangles.push_back(index);
+
+			auto p = localToWorld.MultiplyPoint(source.m_vertices[v]);
+			bmin = Vector3::Min(bmin, p);
+			bmax = Vector3::Max(bmax, p);
+			d.m_vertices.push_back(p);
+			d.m_normals.push_back(hasNormals ? normalMatrix.MultiplyVector(source.m_normals[v]).normalized() : Vector3::zero);
+			d.m_uv.push_back(hasUV ? source.m_uv[v] : Vector2::zero);
+			d.m_tangents.push_back(hasTangents ? localToWorld.MultiplyVector(source.m_tangents[v]).normalized() : Vector3::zero);
+		}
+		if (!remap.empty())
+			range.bounds.SetMinMax(bmin, bmax);
+		return range;
+	}
+}
@@ -31,11 +31,30 @@ namespace FishEngine
 	}
 
 
+	Texture2D::~Texture2D()
+	{
+		// the name of whiteTexture(), drawn in place of the texture
+		if (m_uploadQueued)
+			m_GLNativeTexture = 0;
+	}
+
 	void Texture2D::UploadToGPU()
 	{
 		if (m_uploaded)
 			return;
+		if (m_uploadQueued)
+		{
+			m_GLNativeTexture = whiteTexture()->GetNativeTexturePtr();
+			return;
+		}
+		CreateNativeTexture(m_data.data());
+		m_uploaded = true;
+		m_data.clear();
+		m_data.shrink_to_fit();
+	}
 
+	void Texture2D::CreateNativeTexture(const void* pixels)
+	{
 		GLenum internal_format = GL_RGBA8;
 		GLenum format = GL_RGBA;
 		GLenum type = GL_UNSIGNED_INT;
@@ -53,7 +72,7 @@ namespace FishEngine
 		glCheckError();
 		glTexStorage2D(GL_TEXTURE_2D, max_mipmap_level_count, internal_format, m_width, m_height);
 		glCheckError();
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, format, type, m_data.data());
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, format, type, pixels);
 #else
 		glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, data);
 #endif
@@ -68,9 +87,6 @@ namespace FishEngine
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glCheckError();
 		glBindTexture(GL_TEXTURE_2D, 0);
-		m_uploaded = true;
-		m_data.clear();
-		m_data.shrink_to_fit();
 		glCheckError();
 	}
 
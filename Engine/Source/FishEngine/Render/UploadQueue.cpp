@@ -0,0 +1,329 @@
+#include <FishEngine/UploadQueue.hpp>
+#include <FishEngine/GLEnvironment.hpp>
+#include <FishEngine/Texture2D.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/GeometryPool.hpp>
+#include <FishEngine/Debug.hpp>
+
+#include <cstring>
+#include <mutex>
+
+namespace FishEngine
+{
+	constexpr uint32_t StagingRing::InvalidOffset;
+
+	StagingRing::StagingRing(uint32_t capacity)
+		: m_capacity(capacity)
+	{
+	}
+
+	StagingRing::Allocation StagingRing::Allocate(uint32_t size, uint32_t alignment)
+	{
+		assert(size > 0);
+		Allocation allocation;
+		if (size > m_capacity)
+			return allocation;
+		uint64_t start = m_head;
+		uint64_t offset = (start + alignment - 1) & ~uint64_t(alignment - 1);
+		if (offset + size > m_capacity)
+			offset = 0;
+		uint64_t end = offset + size;
+		uint64_t needed = offset >= start ? end - start : m_capacity - start + end;
+		if (m_used + needed > m_capacity)
+			return allocation;
+
+		m_blocks.push_back({ m_head, static_cast<uint32_t>(needed), 0, false });
+		m_used += static_cast<uint32_t>(needed);
+		m_head = end == m_capacity ? 0 : static_cast<uint32_t>(end);
+		allocation.offset = static_cast<uint32_t>(offset);
+		allocation.id = m_firstId + m_blocks.size() - 1;
+		return allocation;
+	}
+
+	void StagingRing::Retire(uint64_t id, uint64_t fence)
+	{
+		assert(id >= m_firstId && id - m_firstId < m_blocks.size());
+		auto & block = m_blocks[static_cast<size_t>(id - m_firstId)];
+		block.fence = fence;
+		block.retired = true;
+	}
+
+	void StagingRing::Release(uint64_t completedFence)
+	{
+		while (!m_blocks.empty() && m_blocks.front().retired && m_blocks.front().fence <= completedFence)
+		{
+			m_used -= m_blocks.front().size;
+			m_blocks.pop_front();
+			m_firstId++;
+		}
+		// empty: the next block does not need to skip the end of the ring
+		if (m_blocks.empty())
+			m_head = 0;
+	}
+
+
+	constexpr uint32_t UploadQueue::RingCapacity;
+	constexpr uint32_t UploadQueue::DefaultBytesPerFrame;
+	constexpr uint32_t UploadQueue::Alignment;
+
+	namespace
+	{
+		struct Command
+		{
+			Texture2DPtr				texture;
+			MeshPtr						mesh;
+			StagingRing::Allocation		allocation;
+			uint32_t					size = 0;
+			uint32_t					vertexBytes = 0;	// mesh: the indices follow the vertices
+		};
+
+		struct Fence
+		{
+			uint64_t	id;
+			GLsync		sync;
+		};
+
+		std::mutex					s_mutex;		// s_ring, s_commands, the queued flags
+		StagingRing					s_ring;
+		std::deque<Command>			s_commands;
+
+		uint8_t*					s_memory = nullptr;	// the mapped buffer, or s_systemMemory
+		std::vector<uint8_t>		s_systemMemory;
+		GLuint						s_buffer = 0;		// 0: system memory
+		std::deque<Fence>			s_fences;
+		uint64_t					s_nextFence = 1;
+		uint64_t					s_completedFence = 0;
+		uint32_t					s_bytesPerFrame = UploadQueue::DefaultBytesPerFrame;
+
+		// Stages size bytes written by write(pointer). Returns false if the ring is full or not initialized.
+		template<typename Write>
+		bool Stage(Command & command, uint32_t size, Write write)
+		{
+			{
+				std::lock_guard<std::mutex> lock(s_mutex);
+				if (s_memory == nullptr)
+					return false;
+				command.allocation = s_ring.Allocate(size, UploadQueue::Alignment);
+				if (command.allocation.offset == StagingRing::InvalidOffset)
+					return false;
+			}
+			// the block is not read before its command is queued
+			write(s_memory + command.allocation.offset);
+			command.size = size;
+			return true;
+		}
+	}
+
+	void UploadQueue::Init()
+	{
+		if (s_memory != nullptr)
+			return;
+#ifdef GL_MAP_PERSISTENT_BIT
+		if (persistentMappingSupported())
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glGenBuffers(1, &s_buffer);
+			glBindBuffer(GL_COPY_READ_BUFFER, s_buffer);
+			glBufferStorage(GL_COPY_READ_BUFFER, RingCapacity, nullptr, flags);
+			s_memory = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, RingCapacity, flags));
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			glCheckError();
+			if (s_memory == nullptr)
+			{
+				LogWarning("UploadQueue: the staging buffer can not be mapped, staging in system memory");
+				glDeleteBuffers(1, &s_buffer);
+				s_buffer = 0;
+			}
+		}
+#endif
+		if (s_memory == nullptr)
+		{
+			s_systemMemory.resize(RingCapacity);
+			s_memory = s_systemMemory.data();
+		}
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_ring = StagingRing(RingCapacity);
+	}
+
+	bool UploadQueue::Enqueue(Texture2DPtr const & texture)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			if (texture->m_uploaded || texture->m_uploadQueued || texture->m_data.empty())
+				return false;
+			texture->m_uploadQueued = true;
+		}
+		Command command;
+		command.texture = texture;
+		auto const & data = texture->m_data;
+		if (!Stage(command, static_cast<uint32_t>(data.size()), [&data](uint8_t* out) { std::memcpy(out, data.data(), data.size()); }))
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			texture->m_uploadQueued = false;
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_commands.push_back(std::move(command));
+		return true;
+	}
+
+	bool UploadQueue::Enqueue(MeshPtr const & mesh)
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			if (mesh->m_uploaded || mesh->m_uploadQueued || mesh->m_skinned || mesh->m_vertices.empty() || mesh->m_triangles.empty())
+				return false;
+			mesh->m_uploadQueued = true;
+		}
+		Command command;
+		command.mesh = mesh;
+		auto layout = GeometryPool::LayoutOf(*mesh);
+		command.vertexBytes = static_cast<uint32_t>(mesh->m_vertices.size()) * GeometryPool::Stride(layout);
+		auto indexBytes = static_cast<uint32_t>(mesh->m_triangles.size() * sizeof(uint32_t));
+		auto write = [&mesh, &command, layout](uint8_t* out)
+		{
+			GeometryPool::Interleave(*mesh, layout, out);
+			std::memcpy(out + command.vertexBytes, mesh->m_triangles.data(), mesh->m_triangles.size() * sizeof(uint32_t));
+		};
+		if (!Stage(command, command.vertexBytes + indexBytes, write))
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			mesh->m_uploadQueued = false;
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(s_mutex);
+		s_commands.push_back(std::move(command));
+		return true;
+	}
+
+	void UploadQueue::Update()
+	{
+		Issue(s_bytesPerFrame);
+	}
+
+	void UploadQueue::Flush()
+	{
+		Issue(UINT64_MAX);
+	}
+
+	void UploadQueue::Issue(uint64_t maxBytes)
+	{
+		while (!s_fences.empty())
+		{
+			auto status = glClientWaitSync(s_fences.front().sync, 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				break;
+			s_completedFence = s_fences.front().id;
+			glDeleteSync(s_fences.front().sync);
+			s_fences.pop_front();
+		}
+
+		std::deque<Command> commands;
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			s_ring.Release(s_completedFence);
+			uint64_t bytes = 0;
+			while (!s_commands.empty() && (commands.empty() || bytes + s_commands.front().size <= maxBytes))
+			{
+				bytes += s_commands.front().size;
+				commands.push_back(std::move(s_commands.front()));
+				s_commands.pop_front();
+			}
+		}
+		if (commands.empty())
+			return;
+
+		if (s_buffer != 0)
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_buffer);
+		for (auto const & command : commands)
+		{
+			auto offset = command.allocation.offset;
+			if (command.texture != nullptr)
+			{
+				auto const & texture = command.texture;
+				// drawn as whiteTexture() so far: the name is not the texture's
+				texture->m_GLNativeTexture = 0;
+				if (s_buffer != 0)
+					texture->CreateNativeTexture(reinterpret_cast<const void*>(static_cast<uintptr_t>(offset)));
+				else
+					texture->CreateNativeTexture(s_memory + offset);
+				texture->m_uploaded = true;
+				texture->m_uploadQueued = false;
+				texture->m_data.clear();
+				texture->m_data.shrink_to_fit();
+			}
+			else
+			{
+				auto const & mesh = command.mesh;
+				auto & pool = GeometryPool::Get(GeometryPool::LayoutOf(*mesh));
+				auto handle = pool.Allocate(static_cast<uint32_t>(mesh->m_vertices.size()), static_cast<uint32_t>(mesh->m_triangles.size()));
+				if (s_buffer != 0)
+					pool.Copy(handle, s_buffer, offset, offset + command.vertexBytes);
+				else
+					pool.Write(handle, s_memory + offset, s_memory + offset + command.vertexBytes);
+				mesh->m_pool = &pool;
+				mesh->m_poolBlock = handle;
+				mesh->m_isReadable = false;
+				mesh->Clear();
+				mesh->m_uploaded = true;
+				mesh->m_uploadQueued = false;
+			}
+		}
+		// the other uploads of textures read system memory
+		if (s_buffer != 0)
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glCheckError();
+
+		uint64_t fence = 0;
+		if (s_buffer != 0)
+		{
+			fence = s_nextFence++;
+			s_fences.push_back({ fence, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+		}
+		std::lock_guard<std::mutex> lock(s_mutex);
+		for (auto const & command : commands)
+			s_ring.Retire(command.allocation.id, fence);
+		// without fence the driver has copied the data already
+		if (s_buffer == 0)
+			s_ring.Release(s_completedFence);
+	}
+
+	uint32_t UploadQueue::bytesPerFrame()
+	{
+		return s_bytesPerFrame;
+	}
+
+	void UploadQueue::setBytesPerFrame(uint32_t bytes)
+	{
+		s_bytesPerFrame = bytes;
+	}
+
+	uint32_t UploadQueue::queuedCount()
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		return static_cast<uint32_t>(s_commands.size());
+	}
+
+	bool UploadQueue::persistentMappingSupported()
+	{
+		static int supported = -1;
+		if (supported < 0)
+		{
+			supported = 0;
+			GLint major = 0, minor = 0;
+			glGetIntegerv(GL_MAJOR_VERSION, &major);
+			glGetIntegerv(GL_MINOR_VERSION, &minor);
+			if (major > 4 || (major == 4 && minor >= 4))
+				supported = 1;
+			GLint count = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+			for (GLint i = 0; i < count && supported == 0; ++i)
+			{
+				auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+				if (name != nullptr && std::strcmp(name, "GL_ARB_buffer_storage") == 0)
+					supported = 1;
+			}
+		}
+		return supported == 1;
+	}
+}
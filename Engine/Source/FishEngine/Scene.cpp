@@ -14,12 +14,30 @@
 #include <FishEngine/Gizmos.hpp>
 #include <FishEngine/Shader.hpp>
 #include <FishEngine/QualitySettings.hpp>
+#include <FishEngine/StaticBatchingUtility.hpp>
+#include <FishEngine/ShadowCascadeUtility.hpp>
+#include <FishEngine/DepthOnlyRenderer.hpp>
+#include <FishEngine/GeometryUtility.hpp>
 //#include "Serialization.hpp"
 //#include "Serialization/archives/yaml.hpp"
 #include <FishEngine/Camera.hpp>
 #include <FishEngine/AudioListener.hpp>
 #include <FishEngine/GLEnvironment.hpp>
 #include <FishEngine/Graphics.hpp>
+#include <FishEngine/Script.hpp>
+#include <FishEngine/JobSystem.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	void UpdateMatrixRecursively(FishEngine::TransformPtr const & t)
+	{
+		t->UpdateMatrix();
+		for (auto const & child : t->children())
+			UpdateMatrixRecursively(child);
+	}
+}
 
 namespace FishEngine
 {
@@ -27,18 +45,59 @@ namespace FishEngine
 	std::vector<GameObjectPtr>    Scene::m_gameObjectsToBeDestroyed;
 	std::vector<ComponentPtr>     Scene::m_componentsToBeDestroyed;
 	Bounds                      Scene::m_bounds;
+	std::vector<Component*>     Scene::s_updatePhases[static_cast<int>(UpdatePhase::Count)];
+	std::vector<std::pair<int, HierarchyListener>> Scene::s_hierarchyListeners;
+	int                         Scene::s_nextHierarchyListenerID = 0;
+	int                         Scene::s_hierarchyNotificationBlock = 0;
 	//SceneOctree                 Scene::m_octree(Bounds(), 16);
 
 	GameObjectPtr Scene::CreateGameObject(const std::string& name)
 	{
 		//auto go = std::make_shared<GameObject>(name);
 		auto go = GameObject::Create();
+		// not in the scene yet: reported once, as Created
+		s_hierarchyNotificationBlock++;
 		go->setName(name);
+		s_hierarchyNotificationBlock--;
 		go->transform()->m_gameObject = go;
 		m_gameObjects.push_back(go);
+		NotifyHierarchyChanged(HierarchyChange::Created, go.get());
 		return go;
 	}
 
+	void Scene::AddGameObject(GameObjectPtr const & go)
+	{
+		m_gameObjects.push_back(go);
+		NotifyHierarchyChanged(HierarchyChange::Created, go.get());
+	}
+
+	int Scene::AddHierarchyListener(HierarchyListener const & listener)
+	{
+		int id = s_nextHierarchyListenerID++;
+		s_hierarchyListeners.emplace_back(id, listener);
+		return id;
+	}
+
+	void Scene::RemoveHierarchyListener(int id)
+	{
+		s_hierarchyListeners.erase(std::remove_if(s_hierarchyListeners.begin(), s_hierarchyListeners.end(),
+			[id](std::pair<int, HierarchyListener> const & l) { return l.first == id; }), s_hierarchyListeners.end());
+	}
+
+	void Scene::NotifyHierarchyChanged(HierarchyChange change, GameObject* go)
+	{
+		// Object::totalDirtyCount, which views of the whole scene compare
+		go->SetDirty();
+		if (s_hierarchyNotificationBlock > 0)
+			return;
+		// a copy: a listener may add or remove listeners (e.g. a view created or closed by the change)
+		auto listeners = s_hierarchyListeners;
+		for (auto const & l : listeners)
+		{
+			l.second(change, go);
+		}
+	}
+
 	GameObjectPtr Scene::CreateCamera()
 	{
 		auto camera_go = Scene::CreateGameObject("Camera");
@@ -82,16 +141,85 @@ namespace FishEngine
 		}
 		m_gameObjectsToBeDestroyed.clear(); // release (the last) strong refs, game objects should be destroyed automatically.
 
+		// Start new components, in hierarchy order, and sort all components into their update phase.
+		for (auto & phase : s_updatePhases)
+			phase.clear();
 		for (auto& go : m_gameObjects)
 		{
 			if (!go->activeInHierarchy()) continue;
-			go->Update();
+			go->StartComponents();
+			for (auto & c : go->m_components)
+			{
+				s_updatePhases[static_cast<int>(c->updatePhase())].push_back(c.get());
+				if (IsScript(c->ClassID()))
+					s_updatePhases[static_cast<int>(UpdatePhase::LateUpdate)].push_back(c.get());
+			}
+		}
+
+		for (int phase = 0; phase < static_cast<int>(UpdatePhase::Count); ++phase)
+		{
+			UpdatePhaseComponents(static_cast<UpdatePhase>(phase), s_updatePhases[phase]);
 		}
 		
 		//UpdateBounds();
 	}
 
-	void Scene::RenderShadow(LightPtr const & light)
+	void Scene::UpdatePhaseComponents(UpdatePhase phase, std::vector<Component*> & components)
+	{
+		if (components.empty())
+			return;
+
+		// batches of the same type; stable, so the order inside a batch is the hierarchy order
+		std::stable_sort(components.begin(), components.end(), [](Component* a, Component* b) {
+			return a->ClassID() < b->ClassID();
+		});
+
+		auto update = [phase](Component* c) {
+			if (phase == UpdatePhase::LateUpdate)
+				static_cast<Script*>(c)->LateUpdate();
+			else
+				c->Update();
+		};
+
+		bool transformsFlushed = false;
+		size_t begin = 0;
+		while (begin < components.size())
+		{
+			int classID = components[begin]->ClassID();
+			size_t end = begin + 1;
+			while (end < components.size() && components[end]->ClassID() == classID)
+				++end;
+
+			if (phase != UpdatePhase::LateUpdate && components[begin]->isUpdateThreadSafe())
+			{
+				// world matrices are computed lazily; compute them here so that parallel readers do not write shared parents
+				if (!transformsFlushed)
+				{
+					for (auto & go : m_gameObjects)
+					{
+						auto const & t = go->transform();
+						if (t->parent() == nullptr)
+							UpdateMatrixRecursively(t);
+					}
+					transformsFlushed = true;
+				}
+				Component** batch = components.data() + begin;
+				JobSystem::ParallelFor(end - begin, 8, [batch, &update](size_t first, size_t last) {
+					for (size_t i = first; i < last; ++i)
+						update(batch[i]);
+				});
+			}
+			else
+			{
+				// scripts and other components stay on the main thread
+				for (size_t i = begin; i < end; ++i)
+					update(components[i]);
+			}
+			begin = end;
+		}
+	}
+
+	void Scene::RenderShadow(LightPtr const & light, CameraPtr const & camera, int cascadeCount)
 	{
 		if (light == nullptr)
 		{
@@ -100,7 +228,6 @@ namespace FishEngine
 		
 
 #define DEBUG_SHADOW 1
-		auto    camera = Camera::main();
 		auto    camera_to_world = camera->transform()->localToWorldMatrix();
 		float   near = camera->nearClipPlane();
 		//float   far = camera->farClipPlane();
@@ -108,29 +235,101 @@ namespace FishEngine
 
 		Vector3 light_dir = light->transform()->forward();
 		Frustum total_frustum = camera->frustum();
+		auto world_to_light = ShadowCascadeUtility::WorldToLight(light_dir);
 
-		constexpr float splits[] = { 0, 1.0f / 15.0f, 3.0f / 15.0f, 7.0f / 15.0f, 1 };
+		// the casters, and the bounds of the receivers the camera sees
+		struct Caster
+		{
+			RendererPtr	renderer;
+			MeshPtr		mesh;
+		};
+		std::vector<Caster> casters;
+		std::vector<Bounds> caster_bounds;		// light space
+		std::vector<Bounds> receiver_bounds;	// world space
+		Vector4 frustum_planes[6];
+		GeometryUtility::CalculateFrustumPlanes(camera->projectionMatrix() * camera->worldToCameraMatrix(), frustum_planes);
+		auto add_bounds = [&](Renderer const & renderer, Bounds const & bounds)
+		{
+			if (renderer.shadowCastingMode() != ShadowCastingMode::Off)
+				caster_bounds.push_back(ShadowCascadeUtility::TransformBounds(world_to_light, bounds));
+			if (renderer.receiveShadows() && GeometryUtility::TestPlanesAABB(frustum_planes, bounds))
+				receiver_bounds.push_back(bounds);
+		};
 
-		for (int i = 0; i < 4; ++i)
+		auto gameObjects = m_gameObjects;
+		while (!gameObjects.empty())
 		{
-#if 0
-			// From GPU Gem 3. Chap 10 "Practical Split Scheme".
-			const float split_lambda = 0.5f;
-			float split_near = near;
-			if (i > 0)
-				split_near = Mathf::Lerp(near + i / 4.0f * (far - near), near * Mathf::Pow(far / near, i / 4.0f), split_lambda);
-			float split_far = far;
-			if (i < 4 - 1)
-				split_far = Mathf::Lerp(near + (i + 1) / 4.0f * (far - near), near*Mathf::Pow(far / near, (i + 1) / 4.0f), split_lambda);
-#else
-			// From Unity
-			// 0:    0 ~ 1/15,  1/15
-			// 1: 1/15 ~ 3/15,  2/15
-			// 2: 3/15 ~ 7/15,  4/15
-			// 3: 7/15 ~ 1,     8/15
-			float split_near = Mathf::Lerp(near, far, splits[i]);
-			float split_far = Mathf::Lerp(near, far, splits[i+1]);
-#endif
+			auto go = gameObjects.front();
+			gameObjects.pop_front();
+			
+			if (!go->activeInHierarchy())
+				continue;
+			
+			for (auto & child : go->transform()->children())
+			{
+				gameObjects.push_back(child->gameObject());
+			}
+
+			RendererPtr renderer = go->GetComponent<Renderer>();
+			if (renderer == nullptr || !renderer->enabled() || renderer->isPartOfStaticBatch())
+				continue;
+
+			MeshPtr mesh;
+			if (renderer->ClassID() == ClassID<SkinnedMeshRenderer>())
+			{
+				mesh = As<SkinnedMeshRenderer>(renderer)->sharedMesh();
+			}
+			else
+			{
+				auto meshFilter = go->GetComponent<MeshFilter>();
+				if (meshFilter != nullptr)
+					mesh = meshFilter->mesh();
+			}
+
+			if (mesh == nullptr)
+				continue;
+			add_bounds(*renderer, renderer->bounds());
+			if (renderer->shadowCastingMode() != ShadowCastingMode::Off)
+				casters.push_back({ renderer, mesh });
+		}
+
+		for (auto & batch : StaticBatchingUtility::batches())
+		{
+			for (auto const & range : batch.ranges)
+			{
+				auto const & renderer = range.renderer;
+				auto go = renderer->gameObject();
+				if (renderer->enabled() && go != nullptr && go->activeInHierarchy())
+					add_bounds(*renderer, range.bounds);
+			}
+		}
+
+		// the splits divide the depth range of the receivers
+		float min_depth, max_depth;
+		if (ShadowCascadeUtility::VisibleDepthRange(camera->worldToCameraMatrix(), receiver_bounds, near, far, min_depth, max_depth))
+		{
+			max_depth = std::max(max_depth, min_depth + ShadowCascadeUtility::MinDepthRange);
+		}
+		else
+		{
+			min_depth = near;
+			max_depth = far;
+		}
+		std::vector<Bounds> receivers;		// light space
+		receivers.reserve(receiver_bounds.size());
+		for (auto const & b : receiver_bounds)
+			receivers.push_back(ShadowCascadeUtility::TransformBounds(world_to_light, b));
+
+		cascadeCount = Mathf::Clamp(cascadeCount, 1, 4);
+		float splits[5];
+		ShadowCascadeUtility::ComputeSplits(min_depth, max_depth, cascadeCount, ShadowCascadeUtility::SplitLambda, splits);
+		splits[0] = near;	// nothing to shadow in front of the receivers, but the first cascade is selected from the near plane
+
+		const int resolution = light->m_shadowMap->width();
+		for (int i = 0; i < cascadeCount; ++i)
+		{
+			float split_near = splits[i];
+			float split_far = splits[i+1];
 
 			Frustum frustum = total_frustum;
 			frustum.minRange = split_near;
@@ -149,106 +348,33 @@ namespace FishEngine
 				world_corners[i] = camera_to_world.MultiplyPoint(view_corners[i]);
 			}
 
-			Vector3 split_centroid(0, 0, 0);
-			for (auto& c : world_corners)
-			{
-				split_centroid += c;
-			}
-			split_centroid /= 8.0f;
-
-			float dist = Mathf::Max(split_far - split_near, Vector3::Distance(world_corners[4], world_corners[5]));
-			auto eye_pos = split_centroid - light_dir * dist;
-			Gizmos::DrawWireSphere(eye_pos, 0.5f);
-			Matrix4x4 world_to_light = Matrix4x4::LookAt(eye_pos, split_centroid, Vector3::up);
-
-			Bounds aabb;    // the bounding box of view frustum in light's local space
-			for (int i = 0; i < 8; ++i)
-			{
-				view_corners[i] = world_to_light.MultiplyPoint(world_corners[i]);
-				aabb.Encapsulate(view_corners[i]);
-			}
-
-#define CSM_SPLIT_SPHERE
-#ifdef CSM_SPLIT_SPHERE
-			float sphereRadius = 0.0f;
-			for (auto& c : world_corners)
-			{
-				float dist = Vector3::Distance(c, split_centroid);
-				sphereRadius = std::max(sphereRadius, dist);
-			}
-
-			sphereRadius = std::ceil(sphereRadius * 16.0f) / 16.0f;
-			Vector3 maxExtents(sphereRadius, sphereRadius, sphereRadius);
-			Vector3 minExtents = -maxExtents;
-			Vector3 cascadeExtents = maxExtents - minExtents;
-#endif
-			constexpr float near_offset = 10.0f;
-			constexpr float far_offset = 20.0f;
-			auto min_p = aabb.min();
-			auto max_p = aabb.max();
+			auto cascade = ShadowCascadeUtility::FitCascade(world_to_light, world_corners, receivers, caster_bounds, resolution);
 
 			Gizmos::setColor(Color::red * (i / 3.0f));
 			Gizmos::setMatrix(world_to_light.inverse());
-			Gizmos::DrawWireCube(aabb.center(), aabb.size());
+			Vector3 box_min(cascade.min.x, cascade.min.y, cascade.near);
+			Vector3 box_max(cascade.max.x, cascade.max.y, cascade.far);
+			Gizmos::DrawWireCube((box_min + box_max) * 0.5f, box_max - box_min);
 			Gizmos::setMatrix(Matrix4x4::identity);
 
-			float z_near = min_p.z;
-			float z_far = max_p.z;
-			light->m_cascadesNear[i] = z_near - near_offset;
-			light->m_cascadesFar[i] = z_far + far_offset;
-
-#if 0
-			light->m_projectMatrixForShadowMap[i] = Matrix4x4::Ortho(min_p.x, max_p.x, min_p.y, max_p.y, z_near, z_far);
-			light->m_viewMatrixForShadowMap[i] = world_to_light;
-#elif 0
-			float scaleX = 2.0f / (max_p.x - min_p.x);
-			float scaleY = 2.0f / (max_p.y - min_p.y);
-			constexpr float scaleQuantizer = 64.0f;
-			scaleX = 1.0f / std::ceilf(1.0f / scaleX * scaleQuantizer) * scaleQuantizer;
-			scaleY = 1.0f / std::ceilf(1.0f / scaleY * scaleQuantizer) * scaleQuantizer;
-			float offsetX = -0.5f * (max_p.x + min_p.x) * scaleX;
-			float offsetY = -0.5f * (max_p.y + min_p.y) * scaleY;
-			const float halfTextureSize = 0.5f * light->m_shadowMap->width();
-			offsetX = std::ceilf(offsetX * halfTextureSize) / halfTextureSize;
-			offsetY = std::ceilf(offsetY * halfTextureSize) / halfTextureSize;
-			auto& forward = light_dir; // +z
-			auto right = Vector3::Cross(Vector3(0, 1, 0), forward); // +x
-			auto up = Vector3::Cross(forward, right); // +y
-			eye_pos += right * offsetX + up * offsetY;
-			split_centroid += right * offsetX + up * offsetY;
-			//Gizmos::DrawWireSphere(eye_pos, 0.5f);
-			world_to_light = Matrix4x4::LookAt(eye_pos, split_centroid, Vector3::up);
-			light->m_projectMatrixForShadowMap[i] = Matrix4x4::Ortho(min_p.x, max_p.x, min_p.y, max_p.y, z_near, z_far);
-			light->m_viewMatrixForShadowMap[i] = world_to_light;
-#else
-			//Debug::Log("sphereRadius: %lf", sphereRadius);
-			auto shadowCameraPos = -light_dir * sphereRadius + split_centroid;
-			auto shadowView = Matrix4x4::LookAt(shadowCameraPos, split_centroid, Vector3::up);
-			auto shadowProj = Matrix4x4::Ortho(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, 0, cascadeExtents.z);
-
-			const float halfShadowMapSize = 0.5f * light->m_shadowMap->width();
-			auto shadowMatrix = shadowProj * shadowView;
-			Vector3 shadowOrigin = shadowMatrix.MultiplyPoint3x4(Vector3::zero);
-			shadowOrigin *= halfShadowMapSize;
-			Vector3 roundedOrigin{ std::round(shadowOrigin.x), std::round(shadowOrigin.y), std::round(shadowOrigin.z) };
-			Vector3 roundOffset = roundedOrigin - shadowOrigin;
-			roundOffset /= halfShadowMapSize;
-			roundOffset.z = 0.0f;
-
-			shadowProj[0][3] += roundOffset.x;
-			shadowProj[1][3] += roundOffset.y;
-
-			light->m_projectMatrixForShadowMap[i] = shadowProj;
-			light->m_viewMatrixForShadowMap[i] = shadowView;
-#endif
-
+			light->m_cascadesNear[i] = cascade.near;
+			light->m_cascadesFar[i] = cascade.far;
+			light->m_projectMatrixForShadowMap[i] = cascade.projection;
+			light->m_viewMatrixForShadowMap[i] = cascade.view;
 			light->m_cascadesSplitPlaneNear[i] = split_near;
 			light->m_cascadesSplitPlaneFar[i] = split_far;
 		}
 
+		// unused cascades: empty range, no pixel selects them and CascadedShadowMap does not rasterize them
+		for (int i = cascadeCount; i < 4; ++i)
+		{
+			light->m_cascadesSplitPlaneNear[i] = Mathf::Infinity;
+			light->m_cascadesSplitPlaneFar[i] = Mathf::Infinity;
+		}
+
 		auto shadow_map_material = Material::builtinMaterial("CascadedShadowMap");
 
-		Pipeline::BindLight(light);
+		Pipeline::BindLight(light, camera);
 
 		auto shadowMap = light->m_shadowMap;
 		Pipeline::PushRenderTarget(light->m_renderTarget);
@@ -263,85 +389,36 @@ namespace FishEngine
 		//shader->BindUniformMat4("TestMat", Matrix4x4::identity);
 
 #if 1
-		auto gameObjects = m_gameObjects;
-		
-		while (!gameObjects.empty())
+		// depth only, instanced; the meshes not in a GeometryPool (skinned) are drawn one by one with CascadedShadowMap
+		static DepthOnlyRenderer depthOnly;
+		for (auto const & caster : casters)
 		{
-			auto go = gameObjects.front();
-			gameObjects.pop_front();
-			
-			if (!go->activeInHierarchy())
-				continue;
-			
-			for (auto & child : go->transform()->children())
-			{
-				gameObjects.push_back(child->gameObject());
-			}
-
-			RendererPtr renderer = go->GetComponent<Renderer>();
-			if (renderer == nullptr || !renderer->enabled() || renderer->shadowCastingMode() == ShadowCastingMode::Off)
-				continue;
-
-			MeshPtr mesh;
-			if (renderer->ClassID() == ClassID<SkinnedMeshRenderer>())
-			{
-				mesh = As<SkinnedMeshRenderer>(renderer)->sharedMesh();
-			}
-			else
-			{
-				auto meshFilter = go->GetComponent<MeshFilter>();
-				if (meshFilter != nullptr)
-					mesh = meshFilter->mesh();
-			}
+			auto const & renderer = caster.renderer;
+			auto mesh = caster.mesh;
+			// the level chosen for the camera, skinned meshes are animated at this level only
+			if (renderer->activeLOD() > 0 && renderer->activeLOD() < mesh->lodCount())
+				mesh = mesh->lod(renderer->activeLOD());
 
-			if (mesh == nullptr)
-				continue;
-
-			//renderer->PreRender();
 			auto model = renderer->transform()->localToWorldMatrix();
+			if (depthOnly.Add(mesh, model, renderer->materials()))
+				continue;
 			Pipeline::UpdatePerDrawUniforms(model);
 			Graphics::DrawMesh(mesh, shadow_map_material);
+		}
 
-			//auto mesh_renderer = go->GetComponent<MeshRenderer>();
-			//if (mesh_renderer != nullptr)
-			//{
-			//	if (mesh_renderer->shadowCastingMode() != ShadowCastingMode::Off)
-			//	{
-			//		auto meshFilter = go->GetComponent<MeshFilter>();
-			//		if (meshFilter != nullptr)
-			//		{
-			//			mesh = meshFilter->mesh();
-			//		}
-			//	}
-			//}
-			//else
-			//{
-			//	auto renderer = go->GetComponent<SkinnedMeshRenderer>();
-			//	if (renderer != nullptr && renderer->shadowCastingMode() != ShadowCastingMode::Off)
-			//	{
-			//		mesh = renderer->sharedMesh();
-			//		if (renderer->m_avatar != nullptr)
-			//		{
-			//			shadow_map_material->EnableKeyword(ShaderKeyword::SkinnedAnimation);
-			//			is_skinned = true;
-			//			Pipeline::UpdateBonesUniforms(renderer->matrixPalette());
-			//		}
-			//	}
-			//}
-			//
-			//if (!is_skinned)
-			//{
-			//	shadow_map_material->DisableKeyword(ShaderKeyword::SkinnedAnimation);
-			//}
-
-			//if (mesh != nullptr)
-			//{
-			//	Pipeline::UpdatePerDrawUniforms(go->transform()->localToWorldMatrix());
-			//	//shader->BindUniformMat4("ObjectToWorld", go->transform()->localToWorldMatrix());
-			//	shader->CheckStatus();
-			//	mesh->Render();
-			//}
+		// static batches: in world space, not culled (the cascades cover more than the camera frustum)
+		for (auto & batch : StaticBatchingUtility::batches())
+		{
+			auto visible = batch.VisibleRanges(nullptr, true);
+			if (visible.empty() || depthOnly.Add(batch.mesh, visible))
+				continue;
+			Pipeline::UpdatePerDrawUniforms(Matrix4x4::identity);
+			Graphics::DrawMesh(batch.mesh, shadow_map_material, visible);
 		}
+
+		// the pooled meshes without normals have no normal offset (CascadedShadowMap): a slope scaled offset instead, 1 for
+		// the default normal bias
+		depthOnly.Draw(light->m_shadowNormalBias * 2.5f);
 		
 #else
 		for (auto& go : m_gameObjects)
@@ -415,6 +492,8 @@ namespace FishEngine
 
 	void Scene::DestroyImmediate(GameObjectPtr g)
 	{
+		NotifyHierarchyChanged(HierarchyChange::Destroyed, g.get());
+		s_hierarchyNotificationBlock++;
 		auto t = g->transform();
 		// remove children
 		while (!t->m_children.empty())
@@ -427,6 +506,7 @@ namespace FishEngine
 		t->m_gameObjectStrongRef = nullptr;
 		g->m_transform = nullptr;
 		m_gameObjects.remove(g);
+		s_hierarchyNotificationBlock--;
 	}
 
 	void Scene::DestroyImmediate(ComponentPtr c)
@@ -0,0 +1,119 @@
+#include <FishEngine/ShadowCascadeUtility.hpp>
+#include <FishEngine/Mathf.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace FishEngine
+{
+	constexpr float ShadowCascadeUtility::SplitLambda;
+	constexpr float ShadowCascadeUtility::MinDepthRange;
+	constexpr float ShadowCascadeUtility::SizeStepsPerOctave;
+
+	void ShadowCascadeUtility::ComputeSplits(float near, float far, int cascadeCount, float lambda, float splits[5])
+	{
+		// GPU Gems 3, chapter 10: "practical split scheme"
+		splits[0] = near;
+		for (int i = 1; i < cascadeCount; ++i)
+		{
+			float t = static_cast<float>(i) / cascadeCount;
+			float uniform = near + (far - near) * t;
+			float logarithmic = near * std::pow(far / near, t);
+			splits[i] = Mathf::Lerp(uniform, logarithmic, lambda);
+		}
+		splits[cascadeCount] = far;
+	}
+
+	Matrix4x4 ShadowCascadeUtility::WorldToLight(Vector3 const & direction)
+	{
+		auto up = std::abs(direction.y) > 0.999f ? Vector3::forward : Vector3::up;
+		return Matrix4x4::LookAt(Vector3::zero, direction, up);
+	}
+
+	Bounds ShadowCascadeUtility::TransformBounds(Matrix4x4 const & matrix, Bounds const & bounds)
+	{
+		if (!bounds.IsValid())
+			return bounds;
+		auto center = matrix.MultiplyPoint(bounds.center());
+		auto e = bounds.extents();
+		Vector3 extents;
+		for (int i = 0; i < 3; ++i)
+			extents[i] = std::abs(matrix.m[i][0]) * e.x + std::abs(matrix.m[i][1]) * e.y + std::abs(matrix.m[i][2]) * e.z;
+		return Bounds(center, extents * 2.0f);
+	}
+
+	bool ShadowCascadeUtility::VisibleDepthRange(Matrix4x4 const & worldToCamera, std::vector<Bounds> const & receivers,
+		float near, float far, float & minDepth, float & maxDepth)
+	{
+		minDepth = far;
+		maxDepth = near;
+		for (auto const & r : receivers)
+		{
+			auto b = TransformBounds(worldToCamera, r);
+			float zmin = b.min().z;
+			float zmax = b.max().z;
+			if (zmax < near || zmin > far)
+				continue;
+			minDepth = std::min(minDepth, std::max(zmin, near));
+			maxDepth = std::max(maxDepth, std::min(zmax, far));
+		}
+		return minDepth <= maxDepth;
+	}
+
+	float ShadowCascadeUtility::QuantizeSize(float size)
+	{
+		size = std::max(size, 1e-3f);
+		return std::exp2(std::ceil(std::log2(size) * SizeStepsPerOctave) / SizeStepsPerOctave);
+	}
+
+	ShadowCascadeUtility::Cascade ShadowCascadeUtility::FitCascade(Matrix4x4 const & worldToLight, const Vector3 corners[8],
+		std::vector<Bounds> const & receivers, std::vector<Bounds> const & casters, int resolution)
+	{
+		Bounds split;
+		for (int i = 0; i < 8; ++i)
+			split.Encapsulate(worldToLight.MultiplyPoint(corners[i]));
+		auto smin = split.min();
+		auto smax = split.max();
+
+		// the receivers, clipped to the split
+		Bounds fitted;
+		for (auto const & r : receivers)
+		{
+			auto rmin = Vector3::Max(r.min(), smin);
+			auto rmax = Vector3::Min(r.max(), smax);
+			if (rmin.x > rmax.x || rmin.y > rmax.y || rmin.z > rmax.z)
+				continue;
+			Bounds clipped;
+			clipped.SetMinMax(rmin, rmax);
+			fitted.Encapsulate(clipped);
+		}
+		if (!fitted.IsValid())
+			fitted = split;
+		auto fmin = fitted.min();
+		auto fmax = fitted.max();
+
+		// square texels; snapped to the texels from a size large enough to cover the rectangle once moved by one texel
+		Cascade cascade;
+		float size = QuantizeSize(std::max(fmax.x - fmin.x, fmax.y - fmin.y) * resolution / (resolution - 1));
+		float texel = size / resolution;
+		cascade.min = Vector2(std::floor(fmin.x / texel) * texel, std::floor(fmin.y / texel) * texel);
+		cascade.max = cascade.min + Vector2(size, size);
+
+		// from the casters in front of the receivers, over the rectangle, to the farthest receiver
+		cascade.near = fmin.z;
+		cascade.far = fmax.z;
+		for (auto const & c : casters)
+		{
+			auto cmin = c.min();
+			auto cmax = c.max();
+			if (cmax.x < cascade.min.x || cmin.x > cascade.max.x || cmax.y < cascade.min.y || cmin.y > cascade.max.y || cmin.z > cascade.far)
+				continue;
+			cascade.near = std::min(cascade.near, cmin.z);
+		}
+		cascade.far = std::max(cascade.far, cascade.near + MinDepthRange);
+
+		cascade.view = worldToLight;
+		cascade.projection = Matrix4x4::Ortho(cascade.min.x, cascade.max.x, cascade.min.y, cascade.max.y, cascade.near, cascade.far);
+		return cascade;
+	}
+}
@@ -13,13 +13,16 @@
 #include <FishEngine/Scene.hpp>
 #include <FishEngine/Camera.hpp>
 #include <FishEngine/PhysicsSystem.hpp>
+#include <FishEngine/AudioSystem.hpp>
 #include <FishEngine/RenderTarget.hpp>
 #include <FishEngine/Pipeline.hpp>
 #include <FishEngine/Material.hpp>
 #include <FishEngine/Graphics.hpp>
 #include <FishEngine/Shader.hpp>
 #include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/ShaderVariantCollection.hpp>
 #include <FishEngine/Mesh.hpp>
+#include <FishEngine/FrameRecorder.hpp>
 
 using namespace std;
 using namespace FishEngine;
@@ -28,6 +31,9 @@ using namespace FishEngine;
 GLFWwindow* GameApp::m_window = nullptr;
 int GameApp::m_windowWidth = 640;
 int GameApp::m_windowHeight = 480;
+double GameApp::m_cursorX = 0;
+double GameApp::m_cursorY = 0;
+bool GameApp::m_cursorValid = false;
 
 int GameApp::Run()
 {
@@ -48,7 +54,7 @@ int GameApp::Run()
 	glCheckError();
 
 	glfwSetKeyCallback(m_window, GameApp::KeyCallBack);
-	//glfwSetCursorPosCallback(m_window, GameApp::MouseCallback);
+	glfwSetCursorPosCallback(m_window, GameApp::MouseCallback);
 	glfwSetScrollCallback(m_window, GameApp::MouseScrollCallback);
 	//glfwSetCharCallback(m_window, GameApp::CharacterCallback);
 	glfwSetWindowSizeCallback(m_window, GameApp::WindowSizeCallback);
@@ -95,39 +101,44 @@ int GameApp::Run()
 #endif
 	
 	//Resources::Init();
-	Input::Init();
 	RenderSystem::Init();
 	//WindowSizeCallback(m_window, m_windowWidth, m_windowHeight);
 
-	Init();
-	Scene::Init();
-	PhysicsSystem::Init();
+	if (!m_recordingPath.empty() && !FrameRecorder::StartRecording(m_recordingPath))
+	{
+		glfwTerminate();
+		return 1;
+	}
+	AudioSystem::Init();
+	StartScene();
 
-	Scene::Start();
-	//PhysicsSystem::Start();
-	
-	Init();
+	WarmUpShaders();
+	// what loading the scene drew is not the first frame's
+	Shader::ResetDrawTimeCompileStatistics();
+	bool firstFrame = true;
 
 	constexpr int report_frames = 1000;
 	int frames = 0;
 	int fps = 30;
 	//float time_stamp = static_cast<float>(glfwGetTime());
 	auto time_stamp = std::chrono::high_resolution_clock::now();
+	auto frame_time_stamp = time_stamp;
 	
 	/* Loop until the user closes the window */
 	while (!glfwWindowShouldClose(m_window))
 	{
-		/* Poll for and process events */
+		/* Poll for and process events, the callbacks feed Input's event queue */
 		Input::Update();
+		ApplyCursorLock();
 		glfwPollEvents();
-		double xpos, ypos;
-		glfwGetCursorPos(m_window, &xpos, &ypos);
-		float x = static_cast<float>(xpos);
-		float y = static_cast<float>(ypos);
-		Input::UpdateMousePosition(x / m_windowWidth, 1.0f - y / m_windowHeight);
 
-		Scene::Update();
-		PhysicsSystem::FixedUpdate();
+		auto now = std::chrono::high_resolution_clock::now();
+		float deltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(now - frame_time_stamp).count();
+		frame_time_stamp = now;
+		if (!SimulateFrame(deltaTime))
+			break;
+		// the 3D attributes of the sources moved by this frame
+		AudioSystem::Update();
 
 		glViewport(0, 0, Screen::width(), Screen::height());
 		RenderSystem::Render();
@@ -148,12 +159,121 @@ int GameApp::Run()
 
 		/* Swap front and back buffers */
 		glfwSwapBuffers(m_window);
+
+		if (firstFrame)
+		{
+			// the variants missing from the collection made the first frame wait for the driver
+			LogInfo(Format("First frame: %1% shader variants compiled at draw time, %2% ms", Shader::drawTimeCompileCount(), Shader::drawTimeCompileMilliseconds()));
+			firstFrame = false;
+		}
 	}
 
+	AudioSystem::Stop();
+	FrameRecorder::Stop();
 	glfwTerminate();
 	return 0;
 }
 
+int GameApp::Run(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if ((arg == "--record" || arg == "--replay") && i + 1 < argc)
+		{
+			string path = argv[++i];
+			if (arg == "--replay")
+				return RunReplay(path);
+			m_recordingPath = path;
+		}
+		// the others are ignored: the platform may pass its own (-psn_ of the macOS app bundles)
+	}
+	return Run();
+}
+
+void GameApp::StartScene()
+{
+	Input::Init();
+
+	Init();
+	Scene::Init();
+	PhysicsSystem::Init();
+
+	Scene::Start();
+	//PhysicsSystem::Start();
+
+	Init();
+}
+
+bool GameApp::SimulateFrame(float deltaTime)
+{
+	if (!FrameRecorder::BeginFrame(deltaTime))
+		return false;
+	Scene::Update();
+	PhysicsSystem::FixedUpdate();
+	FrameRecorder::EndFrame();
+	return true;
+}
+
+void GameApp::WarmUpShaders()
+{
+	ShaderVariantCollection variants;
+	if (!variants.Load(ShaderVariantCollection::ProjectCollectionPath()))
+		return;
+	auto start = std::chrono::high_resolution_clock::now();
+	ShaderWarmUp warmUp(variants);
+
+	// the loading screen: a progress bar drawn with scissored clears, between two slices of compilation
+	int w = Screen::width();
+	int h = Screen::height();
+	while (!warmUp.Update(8) && !glfwWindowShouldClose(m_window))
+	{
+		glViewport(0, 0, w, h);
+		glDisable(GL_SCISSOR_TEST);
+		glClearColor(0.1f, 0.1f, 0.1f, 1);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(w / 10, h / 2 - h / 80, static_cast<int>(w * 0.8f * warmUp.progress()), h / 40);
+		glClearColor(0.8f, 0.8f, 0.8f, 1);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glDisable(GL_SCISSOR_TEST);
+		glfwSwapBuffers(m_window);
+		glfwPollEvents();
+	}
+	warmUp.Finish();
+
+	auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	LogInfo(Format("Shader warm-up: %1% variants in %2% ms (%3% failed, %4% missing, parallel compile: %5%)",
+		warmUp.variantCount(), elapsed, warmUp.failedCount(), warmUp.missingCount(), ShaderWarmUp::parallelCompileSupported()));
+}
+
+int GameApp::RunReplay(std::string const & recordingPath)
+{
+	Debug::Init();
+
+	// no window and no rendering: only the simulation is replayed
+	if (!FrameRecorder::StartReplay(recordingPath))
+		return 1;
+	StartScene();
+
+	while (true)
+	{
+		Input::Update();
+		if (!SimulateFrame(0))
+			break;
+	}
+
+	PhysicsSystem::Clean();
+	int divergentFrame = FrameRecorder::firstDivergentFrame();
+	if (divergentFrame >= 0)
+	{
+		LogError(Format("Replay diverged at frame %1%", divergentFrame));
+		return 2;
+	}
+	LogInfo(Format("Replayed %1% frames", FrameRecorder::frameIndex()));
+	return 0;
+}
+
 int KeyCodeFromGLFWKey(int key)
 {
 	if (key >= GLFW_KEY_A && key <= GLFW_KEY_Z)
@@ -250,9 +370,44 @@ void GameApp::WindowSizeCallback(GLFWwindow* window, int width, int height)
 	}
 }
 
-//void GameApp::MouseCallback(GLFWwindow* window, double xpos, double ypos)
-//{
-//}
+void GameApp::ApplyCursorLock()
+{
+	bool locked = glfwGetInputMode(m_window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED;
+	if (locked == Input::cursorLocked())
+		return;
+	glfwSetInputMode(m_window, GLFW_CURSOR, Input::cursorLocked() ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+#ifdef GLFW_RAW_MOUSE_MOTION
+	// unaccelerated motion while the cursor is disabled (GLFW 3.3.0 and later)
+	if (Input::cursorLocked() && glfwRawMouseMotionSupported())
+		glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+#endif
+	// the virtual position of a disabled cursor does not continue the one of the visible cursor
+	m_cursorValid = false;
+}
+
+void GameApp::MouseCallback(GLFWwindow* window, double xpos, double ypos)
+{
+	if (glfwGetInputMode(window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED)
+	{
+		// a disabled cursor has an unbounded virtual position, moved by the raw motion where it is enabled:
+		// its movement is the delta. The first position after the lock only seeds the last one.
+		if (m_cursorValid)
+		{
+			float dx = static_cast<float>((xpos - m_cursorX) / m_windowWidth);
+			float dy = static_cast<float>((m_cursorY - ypos) / m_windowHeight);
+			Input::UpdateMouseDelta(dx, dy);
+		}
+		m_cursorX = xpos;
+		m_cursorY = ypos;
+		m_cursorValid = true;
+		return;
+	}
+
+	// the visible cursor: Input derives the delta from the positions
+	float x = static_cast<float>(xpos);
+	float y = static_cast<float>(ypos);
+	Input::UpdateMousePosition(x / m_windowWidth, 1.0f - y / m_windowHeight);
+}
 
 //void GameApp::CharacterCallback(GLFWwindow* window, unsigned int codepoint)
 //{
@@ -0,0 +1,92 @@
+// 5000 looping 3D emitters scattered around the listener, half of them moving every frame, on FMOD's no-sound
+// output: the time of AudioSystem::Update with distance culling, then with everything audible (threshold 0).
+
+#include <FishEngine/AudioClip.hpp>
+#include <FishEngine/AudioListener.hpp>
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/AudioSystem.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Internal/FMODPlugin.hpp>
+
+#include <random>
+#include <string>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	constexpr int Emitters = 5000;
+	constexpr int Frames = 300;
+
+	void Run(std::vector<std::shared_ptr<AudioSource>> const & sources, float threshold)
+	{
+		AudioSystem::setAudibilityThreshold(threshold);
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> step(-1, 1);
+		double culled = 0;
+		Test::Stopwatch watch;
+		double updateMilliseconds = 0;
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			for (size_t i = 0; i < sources.size(); i += 2)
+			{
+				auto t = sources[i]->transform();
+				t->setPosition(t->position() + Vector3(step(random), 0, step(random)));
+			}
+			watch.Restart();
+			AudioSystem::Update();
+			updateMilliseconds += watch.milliseconds();
+			culled += AudioSystem::culledSourceCount();
+		}
+
+		int playing = 0, real = 0;
+		FMODPlugin::GetInstance().system()->getChannelsPlaying(&playing, &real);
+		std::string name = std::to_string(Emitters) + " emitters, threshold " + std::to_string(threshold);
+		Test::PrintMeasurement((name + ": AudioSystem::Update").c_str(), updateMilliseconds / Frames, "ms");
+		Test::PrintMeasurement((name + ": culled sources").c_str(), culled / Frames, "");
+		Test::PrintMeasurement((name + ": real voices").c_str(), real, "");
+	}
+}
+
+int main()
+{
+	AudioSystem::setNoSoundOutput(true);
+	AudioSystem::setMaxVirtualVoices(Emitters + 64);
+	AudioSystem::Init();
+	auto listener = Scene::CreateGameObject("Listener")->AddComponent<AudioListener>();
+	listener->Start();
+
+	auto clip = AudioClip::Create("Noise", 44100, 1, 44100);
+	std::vector<float> samples(44100);
+	std::mt19937 random(0);
+	std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+	for (auto & sample : samples)
+		sample = noise(random);
+	clip->SetData(samples.data(), static_cast<int>(samples.size()), 0);
+
+	// in a 2 km square: most emitters are beyond the maxDistance of 500
+	std::uniform_real_distribution<float> position(-1000, 1000);
+	std::vector<std::shared_ptr<AudioSource>> sources;
+	for (int i = 0; i < Emitters; ++i)
+	{
+		auto go = Scene::CreateGameObject("Emitter");
+		go->transform()->setPosition(position(random), 0, position(random));
+		auto source = go->AddComponent<AudioSource>();
+		source->setClip(clip);
+		source->setLoop(true);
+		source->setSpatialBlend(1);
+		source->setPlayOnAwake(false);
+		source->Start();
+		source->Play();
+		sources.push_back(source);
+	}
+
+	Run(sources, AudioSystem::audibilityThreshold());
+	Run(sources, 0);
+	AudioSystem::Stop();
+	return 0;
+}
@@ -0,0 +1,260 @@
+// AudioSystem: the audibility estimate that decides which 3D sources are culled, and the clamping of the
+// AudioSource settings; then on FMOD's no-sound output: the one-shot voice pool and its stealing, the real voice
+// limit, distance culling and the 3D attributes pushed by Update.
+
+#include <FishEngine/AudioClip.hpp>
+#include <FishEngine/AudioListener.hpp>
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/AudioSystem.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Internal/FMODPlugin.hpp>
+
+#include <TestUtility.hpp>
+
+#include <algorithm>
+
+using namespace FishEngine;
+
+namespace
+{
+	// FMOD_3D_INVERSETAPEREDROLLOFF: the inverse curve, faded to 0 at maxDistance by the linear squared curve.
+	float InverseTaperedRolloff(float distance, float minDistance, float maxDistance)
+	{
+		if (distance <= minDistance)
+			return 1;
+		if (distance >= maxDistance)
+			return 0;
+		float inverse = minDistance / distance;
+		float t = 1 - (distance - minDistance) / (maxDistance - minDistance);
+		return std::min(inverse, t * t);
+	}
+
+	void TestEstimateAudibility()
+	{
+		const Vector3 listener(1, 2, 3);
+		const float minDistance = 2;
+		const float maxDistance = 50;
+		const float volume = 0.8f;
+
+		// inside minDistance: the full volume
+		TEST_CHECK_NEAR(AudioSystem::EstimateAudibility(listener, listener, volume, minDistance, maxDistance), volume, 1e-6f);
+		TEST_CHECK_NEAR(AudioSystem::EstimateAudibility(listener + Vector3(0, 2, 0), listener, volume, minDistance, maxDistance), volume, 1e-6f);
+
+		// silent from maxDistance
+		TEST_CHECK(AudioSystem::EstimateAudibility(listener + Vector3(50, 0, 0), listener, volume, minDistance, maxDistance) == 0);
+		TEST_CHECK(AudioSystem::EstimateAudibility(listener + Vector3(0, 0, -80), listener, volume, minDistance, maxDistance) == 0);
+
+		// in between: never increasing with the distance, and never below what FMOD plays (culling is conservative)
+		float previous = volume;
+		for (float d = minDistance; d < maxDistance + 5; d += 0.25f)
+		{
+			auto direction = Vector3(1, -2, 0.5f).normalized();
+			float a = AudioSystem::EstimateAudibility(listener + direction * d, listener, volume, minDistance, maxDistance);
+			TEST_CHECK(a <= previous + 1e-6f);
+			TEST_CHECK(a + 1e-5f >= volume * InverseTaperedRolloff(d, minDistance, maxDistance));
+			previous = a;
+		}
+		TEST_CHECK_NEAR(AudioSystem::EstimateAudibility(listener + Vector3(8, 0, 0), listener, volume, minDistance, maxDistance),
+			volume * minDistance / 8, 1e-6f);
+
+		// a muted source is inaudible everywhere
+		TEST_CHECK(AudioSystem::EstimateAudibility(listener, listener, 0, minDistance, maxDistance) == 0);
+	}
+
+	void TestCullingThreshold()
+	{
+		// with the defaults of AudioSource (1, 500) a source is audible up to maxDistance
+		const float threshold = AudioSystem::audibilityThreshold();
+		TEST_CHECK(AudioSystem::EstimateAudibility(Vector3(499, 0, 0), Vector3::zero, 1, 1, 500) >= threshold);
+		TEST_CHECK(AudioSystem::EstimateAudibility(Vector3(500, 0, 0), Vector3::zero, 1, 1, 500) < threshold);
+
+		// a quiet source is culled earlier: 0.01 * 1 / d < 0.001 from d = 10
+		TEST_CHECK(AudioSystem::EstimateAudibility(Vector3(9, 0, 0), Vector3::zero, 0.01f, 1, 500) >= threshold);
+		TEST_CHECK(AudioSystem::EstimateAudibility(Vector3(11, 0, 0), Vector3::zero, 0.01f, 1, 500) < threshold);
+
+		AudioSystem::setAudibilityThreshold(0.1f);
+		TEST_CHECK(AudioSystem::EstimateAudibility(Vector3(11, 0, 0), Vector3::zero, 1, 1, 500) < AudioSystem::audibilityThreshold());
+		AudioSystem::setAudibilityThreshold(threshold);
+	}
+
+	void TestSourceSettings()
+	{
+		auto source = std::make_shared<AudioSource>();
+		TEST_CHECK(!source->isPlaying());
+		TEST_CHECK(!source->isVirtual());
+
+		source->setVolume(1.5f);
+		TEST_CHECK(source->volume() == 1);
+		source->setVolume(-1);
+		TEST_CHECK(source->volume() == 0);
+		source->setVolume(0.25f);
+		TEST_CHECK(source->volume() == 0.25f);
+
+		source->setSpatialBlend(2);
+		TEST_CHECK(source->spatialBlend() == 1);
+		source->setSpatialBlend(-0.5f);
+		TEST_CHECK(source->spatialBlend() == 0);
+
+		source->setPriority(300);
+		TEST_CHECK(source->priority() == 256);
+		source->setPriority(-3);
+		TEST_CHECK(source->priority() == 0);
+
+		source->setMinDistance(3);
+		source->setMaxDistance(30);
+		TEST_CHECK(source->minDistance() == 3);
+		TEST_CHECK(source->maxDistance() == 30);
+	}
+
+	constexpr int MaxRealVoices = 4;
+
+	// one second of a 440 Hz tone
+	AudioClipPtr MakeClip()
+	{
+		auto clip = AudioClip::Create("Tone", 44100, 1, 44100);
+		std::vector<float> samples(44100);
+		for (size_t i = 0; i < samples.size(); ++i)
+			samples[i] = 0.5f * std::sin(i * 440 * 2 * Mathf::PI / 44100);
+		TEST_CHECK(clip->SetData(samples.data(), static_cast<int>(samples.size()), 0));
+		TEST_CHECK(!clip->SetData(samples.data(), 10, 44095));
+		return clip;
+	}
+
+	std::shared_ptr<AudioSource> MakeSource(AudioClipPtr const & clip, Vector3 const & position)
+	{
+		auto go = Scene::CreateGameObject("Source");
+		go->transform()->setPosition(position);
+		auto source = go->AddComponent<AudioSource>();
+		source->setClip(clip);
+		source->setLoop(true);
+		source->setSpatialBlend(1);
+		source->setPlayOnAwake(false);
+		source->Start();
+		return source;
+	}
+
+	// the channels playing at position
+	int ChannelsAt(Vector3 const & position)
+	{
+		int count = 0;
+		for (int i = 0; i < AudioSystem::maxVirtualVoices(); ++i)
+		{
+			FMOD::Channel * channel = nullptr;
+			bool playing = false;
+			if (FMODPlugin::GetInstance().system()->getChannel(i, &channel) != FMOD_OK || channel->isPlaying(&playing) != FMOD_OK || !playing)
+				continue;
+			FMOD_VECTOR p;
+			channel->get3DAttributes(&p, nullptr);
+			count += Vector3(p.x, p.y, p.z) == position;
+		}
+		return count;
+	}
+
+	void TestOneShotPool(AudioClipPtr const & clip)
+	{
+		// the listener is at the origin
+		const int poolSize = 64;
+		for (int i = 0; i < poolSize; ++i)
+			AudioSource::PlayClipAtPoint(clip, Vector3(10, 0, 0));
+		AudioSystem::Update();
+		TEST_CHECK(AudioSystem::oneShotVoiceCount() == poolSize);
+		TEST_CHECK(ChannelsAt(Vector3(10, 0, 0)) == poolSize);
+
+		// full: a quieter one is dropped, a louder one steals the quietest voice
+		AudioSource::PlayClipAtPoint(clip, Vector3(100, 0, 0));
+		TEST_CHECK(ChannelsAt(Vector3(100, 0, 0)) == 0);
+		AudioSource::PlayClipAtPoint(clip, Vector3(2, 0, 0));
+		TEST_CHECK(ChannelsAt(Vector3(2, 0, 0)) == 1);
+		TEST_CHECK(ChannelsAt(Vector3(10, 0, 0)) == poolSize - 1);
+		TEST_CHECK(AudioSystem::oneShotVoiceCount() == poolSize);
+
+		// nobody can hear it: not even started
+		AudioSource::PlayClipAtPoint(clip, Vector3(1000, 0, 0));
+		TEST_CHECK(ChannelsAt(Vector3(1000, 0, 0)) == 0);
+
+		AudioSystem::Stop();
+		AudioSystem::Update();
+		TEST_CHECK(AudioSystem::oneShotVoiceCount() == 0);
+	}
+
+	void TestVoices(AudioClipPtr const & clip)
+	{
+		// twice the real voices, all audible, the nearest ones loudest
+		std::vector<std::shared_ptr<AudioSource>> sources;
+		for (int i = 0; i < 2 * MaxRealVoices; ++i)
+		{
+			sources.push_back(MakeSource(clip, Vector3(0, 0, 2.0f + 4 * i)));
+			sources.back()->Play();
+		}
+		AudioSystem::Update();
+		int playing = 0, real = 0;
+		FMODPlugin::GetInstance().system()->getChannelsPlaying(&playing, &real);
+		TEST_CHECK(playing == 2 * MaxRealVoices);
+		TEST_CHECK(real == MaxRealVoices);
+		for (int i = 0; i < 2 * MaxRealVoices; ++i)
+		{
+			TEST_CHECK(sources[i]->isPlaying());
+			TEST_CHECK(sources[i]->isVirtual() == (i >= MaxRealVoices));
+		}
+
+		// beyond maxDistance: culled, and its 3D attributes are no longer pushed
+		auto far = sources.front();
+		far->transform()->setPosition(0, 0, 600);
+		AudioSystem::Update();
+		TEST_CHECK(AudioSystem::culledSourceCount() == 1);
+		TEST_CHECK(far->isVirtual());
+		TEST_CHECK(ChannelsAt(Vector3(0, 0, 2)) == 1);
+		far->transform()->setPosition(0, 0, 700);
+		AudioSystem::Update();
+		TEST_CHECK(ChannelsAt(Vector3(0, 0, 2)) == 1);
+
+		// back in range: updated again, and real again
+		far->transform()->setPosition(0, 0, 1);
+		AudioSystem::Update();
+		TEST_CHECK(AudioSystem::culledSourceCount() == 0);
+		TEST_CHECK(ChannelsAt(Vector3(0, 0, 1)) == 1);
+		TEST_CHECK(!far->isVirtual());
+
+		// moving sources are pushed in the same Update
+		for (int i = 1; i < 2 * MaxRealVoices; ++i)
+			sources[i]->transform()->setPosition(static_cast<float>(i), 0, 0);
+		AudioSystem::Update();
+		for (int i = 1; i < 2 * MaxRealVoices; ++i)
+			TEST_CHECK(ChannelsAt(Vector3(static_cast<float>(i), 0, 0)) == 1);
+
+		for (auto & source : sources)
+		{
+			source->Stop();
+			Scene::DestroyImmediate(source->gameObject());
+		}
+		sources.clear();
+		AudioSystem::Update();
+		TEST_CHECK(AudioSystem::sourceCount() == 0);
+	}
+
+	void TestPlayback()
+	{
+		AudioSystem::setNoSoundOutput(true);
+		AudioSystem::setMaxRealVoices(MaxRealVoices);
+		AudioSystem::Init();
+		auto listenerGO = Scene::CreateGameObject("Listener");
+		auto listener = listenerGO->AddComponent<AudioListener>();
+		listener->Start();
+
+		auto clip = MakeClip();
+		TestOneShotPool(clip);
+		TestVoices(clip);
+		Scene::DestroyImmediate(listenerGO);
+	}
+}
+
+int main()
+{
+	TestEstimateAudibility();
+	TestCullingThreshold();
+	TestSourceSettings();
+	TestPlayback();
+	return FishEngine::Test::Report("AudioTest");
+}
@@ -0,0 +1,50 @@
+#ifndef BenchmarkUtility_hpp
+#define BenchmarkUtility_hpp
+
+// Measurements of the benchmarks under Source/Test. Each benchmark is an executable run by hand: it prints one
+// measurement per line, to compare before and after a change on the same machine.
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+namespace FishEngine
+{
+	namespace Test
+	{
+		// Wall clock time since construction or Restart.
+		class Stopwatch
+		{
+		public:
+			Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+			void Restart()
+			{
+				m_start = std::chrono::steady_clock::now();
+			}
+
+			double milliseconds() const
+			{
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+			}
+
+		private:
+			std::chrono::steady_clock::time_point m_start;
+		};
+
+		// The CPU time used by the process, all threads, in milliseconds (wall clock time on Windows, where clock()
+		// measures that).
+		inline double ProcessCPUTime()
+		{
+			return 1000.0 * std::clock() / CLOCKS_PER_SEC;
+		}
+
+		// name: what was measured, with its conditions.
+		inline void PrintMeasurement(const char* name, double value, const char* unit)
+		{
+			std::printf("%-60s %12.3f %s\n", name, value, unit);
+		}
+	}
+}
+
+#endif // BenchmarkUtility_hpp
@@ -0,0 +1,69 @@
+// DepthOnlyRenderer::Add: the meshes of the GeometryPools are taken by both overloads, the others are rejected (drawn
+// by the caller), and the meshes in the UploadQueue are skipped without being uploaded or rejected.
+
+#include <FishEngine/DepthOnlyRenderer.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/UploadQueue.hpp>
+
+#include <GLTestContext.hpp>
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	MeshPtr MakeMesh()
+	{
+		std::vector<Vector3> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+		std::vector<Vector3> normals(3, Vector3(0, 0, 1));
+		std::vector<uint32_t> triangles = { 0, 1, 2 };
+		return std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::vector<Vector2>(), std::vector<Vector3>(), std::move(triangles));
+	}
+
+	void TestAdd()
+	{
+		DepthOnlyRenderer renderer;
+		std::vector<IndexRange> ranges = { { 0, 3 } };
+		auto rejected = DepthOnlyRenderer::statistics().rejected;
+
+		// uploaded by Add
+		auto mesh = MakeMesh();
+		TEST_CHECK(renderer.Add(mesh, Matrix4x4::identity, {}));
+		TEST_CHECK(renderer.Add(mesh, ranges));
+		TEST_CHECK(DepthOnlyRenderer::statistics().rejected == rejected);
+
+		// not in a pool
+		auto empty = std::make_shared<Mesh>();
+		TEST_CHECK(!renderer.Add(empty, Matrix4x4::identity, {}));
+		TEST_CHECK(!renderer.Add(empty, ranges));
+		TEST_CHECK(DepthOnlyRenderer::statistics().rejected == rejected + 2);
+		TEST_CHECK(!renderer.Add(nullptr, ranges));
+		TEST_CHECK(DepthOnlyRenderer::statistics().rejected == rejected + 2);
+
+		// queued: left to the UploadQueue, by both overloads
+		UploadQueue::Init();
+		auto queued = MakeMesh();
+		TEST_CHECK(UploadQueue::Enqueue(queued));
+		TEST_CHECK(renderer.Add(queued, Matrix4x4::identity, {}));
+		TEST_CHECK(renderer.Add(queued, ranges));
+		TEST_CHECK(DepthOnlyRenderer::statistics().rejected == rejected + 2);
+		TEST_CHECK(UploadQueue::queuedCount() == 1);
+		TEST_CHECK(!queued->vertices().empty());	// not uploaded
+
+		UploadQueue::Flush();
+		TEST_CHECK(queued->vertices().empty());
+		TEST_CHECK(renderer.Add(queued, Matrix4x4::identity, {}));
+		TEST_CHECK(renderer.Add(queued, ranges));
+		TEST_CHECK(DepthOnlyRenderer::statistics().rejected == rejected + 2);
+		TEST_CHECK(glGetError() == GL_NO_ERROR);
+	}
+}
+
+int main()
+{
+	if (FishEngine::Test::CreateGLContext())
+		TestAdd();
+	else
+		FishEngine::Test::Skip("DepthOnlyRendererTest");
+	return FishEngine::Test::Report("DepthOnlyRendererTest");
+}
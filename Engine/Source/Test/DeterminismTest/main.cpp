@@ -0,0 +1,176 @@
+// FrameRecorder and GameApp: frames recorded without a window, then replayed by RunReplay in a new process, as with
+// --record and --replay. The scene moves with the recorded input (CameraController) and with PhysX (a box falling
+// on the ground); the transform hashes of the frames are compared with the recording.
+// Runs itself: without arguments it starts the recordings and the replays as child processes.
+
+#include <FishGame/GameApp.hpp>
+#include <FishEngine/BoxCollider.hpp>
+#include <FishEngine/CameraController.hpp>
+#include <FishEngine/Debug.hpp>
+#include <FishEngine/FrameRecorder.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Input.hpp>
+#include <FishEngine/PhysicsSystem.hpp>
+#include <FishEngine/Rigidbody.hpp>
+#include <FishEngine/Scene.hpp>
+
+#include <cstdlib>
+#include <string>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	constexpr int Frames = 120;
+
+	void Post(InputEventType type, int code = 0, float x = 0, float y = 0)
+	{
+		Input::PostEvent(InputEvent{ type, Input::Now(), code, x, y });
+	}
+
+	// The input of frame: rotate with the right button, then zoom with the wheel.
+	void PostInput(int frame)
+	{
+		if (frame == 10)
+			Post(InputEventType::MouseButtonDown, 1);
+		if (frame > 10 && frame < 60)
+			Post(InputEventType::MouseDelta, 0, 0.002f * (frame % 7), -0.001f * (frame % 5));
+		if (frame == 60)
+			Post(InputEventType::MouseButtonUp, 1);
+		if (frame >= 80 && frame % 4 == 0)
+			Post(InputEventType::Scroll, 0, 0, 1);
+	}
+
+	// not constant: the replay must take the delta times of the log
+	float DeltaTime(int frame)
+	{
+		return 1.0f / 60 + 0.002f * (frame % 3);
+	}
+
+	class DeterminismApp : public GameApp
+	{
+	public:
+		// a different scene: its replays must diverge
+		bool m_perturbed = false;
+
+		virtual void Init() override
+		{
+			// called twice by StartScene
+			if (Scene::Find("Controller") != nullptr)
+				return;
+
+			auto controller = Scene::CreateGameObject("Controller");
+			controller->transform()->setLocalPosition(0, 1, -10);
+			controller->AddComponent<CameraController>();
+
+			auto ground = Scene::CreateGameObject("Ground");
+			ground->AddComponent(std::make_shared<BoxCollider>(Vector3::zero, Vector3(10, 0.1f, 10)));
+
+			auto box = Scene::CreateGameObject("Box");
+			box->transform()->setLocalPosition(0, m_perturbed ? 3.01f : 3.0f, 0);
+			box->transform()->setLocalEulerAngles(30, 45, 10);
+			box->AddComponent(std::make_shared<BoxCollider>(Vector3::zero, Vector3::one));
+			box->AddComponent<Rigidbody>();
+		}
+
+		virtual void Update() override
+		{
+		}
+
+		// The frames of Run, without the window and the rendering.
+		int Record(std::string const & path)
+		{
+			Debug::Init();
+			if (!FrameRecorder::StartRecording(path))
+				return 1;
+			StartScene();
+			for (int frame = 0; frame < Frames; ++frame)
+			{
+				Input::Update();
+				PostInput(frame);
+				SimulateFrame(DeltaTime(frame));
+			}
+			FrameRecorder::Stop();
+			PhysicsSystem::Clean();
+			return 0;
+		}
+	};
+
+	// More events than an uint16 can count in one frame: all of them are replayed, and the next frame still reads.
+	void TestManyEvents()
+	{
+		const std::string path = "DeterminismTest_events.rec";
+		const int count = 70000;
+		Input::Init();
+		TEST_CHECK(FrameRecorder::StartRecording(path));
+		for (int i = 0; i < count; ++i)
+			Post(InputEventType::Scroll, 0, 0, 1);
+		FrameRecorder::BeginFrame(DeltaTime(0));
+		FrameRecorder::EndFrame();
+		Input::Update();
+		Post(InputEventType::KeyDown, (int)KeyCode::W);
+		FrameRecorder::BeginFrame(DeltaTime(1));
+		FrameRecorder::EndFrame();
+		FrameRecorder::Stop();
+
+		Input::Init();
+		TEST_CHECK(FrameRecorder::StartReplay(path));
+		TEST_CHECK(FrameRecorder::BeginFrame(0));
+		TEST_CHECK(Input::frameEvents().size() == count);
+		TEST_CHECK(Input::GetAxis(Axis::MouseScrollWheel) == count);
+		FrameRecorder::EndFrame();
+		Input::Update();
+		TEST_CHECK(FrameRecorder::BeginFrame(0));
+		TEST_CHECK(Input::GetKeyDown(KeyCode::W));
+		FrameRecorder::EndFrame();
+		TEST_CHECK(!FrameRecorder::BeginFrame(0));
+		TEST_CHECK(FrameRecorder::firstDivergentFrame() == -1);
+		Input::Init();
+	}
+
+	int RunChild(std::string const & exe, std::string const & arguments)
+	{
+		auto command = "\"" + exe + "\" " + arguments;
+		return std::system(command.c_str());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	DeterminismApp app;
+	std::string option = argc > 1 ? argv[1] : "";
+	if (option == "--perturb")
+	{
+		app.m_perturbed = true;
+		argc--;
+		argv++;
+		option = argc > 1 ? argv[1] : "";
+	}
+	if (option == "--record-test" && argc > 2)
+		return app.Record(argv[2]);
+	if (option == "--replay")
+		return app.Run(argc, argv);
+
+	TestManyEvents();
+
+	std::string exe = argv[0];
+	const std::string first = "DeterminismTest_first.rec";
+	const std::string second = "DeterminismTest_second.rec";
+	const std::string perturbed = "DeterminismTest_perturbed.rec";
+	TEST_CHECK(RunChild(exe, "--record-test " + first) == 0);
+	TEST_CHECK(RunChild(exe, "--record-test " + second) == 0);
+	TEST_CHECK(RunChild(exe, "--perturb --record-test " + perturbed) == 0);
+
+	// two runs with the same input and delta times: the same transforms in every frame (the random seeds differ)
+	TEST_CHECK(FrameRecorder::FindFirstDivergence(first, second) == -1);
+	// the box starts elsewhere
+	TEST_CHECK(FrameRecorder::FindFirstDivergence(first, perturbed) == 0);
+
+	// RunReplay compares the hashes of every frame with the recording
+	TEST_CHECK(RunChild(exe, "--replay " + first) == 0);
+	TEST_CHECK(RunChild(exe, "--replay " + perturbed) != 0);
+	TEST_CHECK(RunChild(exe, "--perturb --replay " + perturbed) == 0);
+	return FishEngine::Test::Report("DeterminismTest");
+}
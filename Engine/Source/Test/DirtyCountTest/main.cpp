@@ -0,0 +1,110 @@
+// Object::dirtyCount, which the Inspector compares to redraw only the sections that changed: bumped by the setters
+// and the changes of the component list, not by the getters nor by the setters that change nothing; the edits made
+// by scripts during Scene::Update count as well.
+
+#include <FishEngine/CameraController.hpp>
+#include <FishEngine/Component.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <memory>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	// the dirty count of object changes during change()
+	template<typename Change>
+	bool Dirties(Object const & object, Change change)
+	{
+		auto before = object.dirtyCount();
+		change();
+		return object.dirtyCount() != before;
+	}
+
+	void TestGameObject()
+	{
+		auto go = Scene::CreateGameObject("A");
+		auto & g = *go;
+		TEST_CHECK(Dirties(g, [&]() { go->setName("B"); }));
+		TEST_CHECK(!Dirties(g, [&]() { go->setName("B"); }));
+		TEST_CHECK(Dirties(g, [&]() { go->SetActive(false); }));
+		TEST_CHECK(!Dirties(g, [&]() { go->SetActive(false); }));
+		TEST_CHECK(Dirties(g, [&]() { go->setLayer(4); }));
+		TEST_CHECK(!Dirties(g, [&]() { go->setLayer(4); }));
+		TEST_CHECK(!Dirties(g, [&]() { go->name(); go->activeSelf(); go->layer(); }));
+
+		// a new section in the Inspector
+		std::shared_ptr<CameraController> controller;
+		TEST_CHECK(Dirties(g, [&]() { controller = go->AddComponent<CameraController>(); }));
+		TEST_CHECK(Dirties(g, [&]() { go->RemoveComponent(controller); }));
+		Scene::DestroyImmediate(go);
+	}
+
+	void TestTransform()
+	{
+		auto parent = Scene::CreateGameObject("Parent");
+		auto child = Scene::CreateGameObject("Child");
+		auto const & t = *parent->transform();
+		TEST_CHECK(Dirties(t, [&]() { parent->transform()->setLocalPosition(1, 2, 3); }));
+		TEST_CHECK(Dirties(t, [&]() { parent->transform()->setLocalEulerAngles(0, 90, 0); }));
+		TEST_CHECK(Dirties(t, [&]() { parent->transform()->setLocalScale(2, 2, 2); }));
+		TEST_CHECK(Dirties(t, [&]() { parent->transform()->Translate(1, 0, 0); }));
+		TEST_CHECK(!Dirties(t, [&]() { parent->transform()->position(); parent->transform()->localToWorldMatrix(); }));
+
+		// not the GameObject: only the Transform section is redrawn
+		TEST_CHECK(!Dirties(*parent, [&]() { parent->transform()->setLocalPosition(0, 0, 0); }));
+
+		child->transform()->SetParent(parent->transform());
+		TEST_CHECK(Dirties(*child->transform(), [&]() { parent->transform()->setLocalPosition(5, 0, 0); }));
+		Scene::DestroyImmediate(parent);
+	}
+
+	void TestBehaviour()
+	{
+		auto go = Scene::CreateGameObject("Controller");
+		auto controller = go->AddComponent<CameraController>();
+		TEST_CHECK(Dirties(*controller, [&]() { controller->setEnabled(false); }));
+		TEST_CHECK(!Dirties(*controller, [&]() { controller->enabled(); }));
+		// the other objects are not touched
+		TEST_CHECK(!Dirties(*go, [&]() { controller->setEnabled(true); }));
+		TEST_CHECK(!Dirties(*go->transform(), [&]() { controller->setEnabled(false); }));
+		Scene::DestroyImmediate(go);
+	}
+
+	// A script that moves its game object in Update, as a gameplay script would while the editor plays.
+	class Mover : public Component
+	{
+	public:
+		virtual int ClassID() const override { return 100001; }
+
+		virtual void Update() override
+		{
+			transform()->Translate(1, 0, 0);
+		}
+	};
+
+	void TestScriptEdit()
+	{
+		// the edits of the scripts reach the Inspector through the same counts as the edits of the user
+		auto go = Scene::CreateGameObject("Scripted");
+		// AddComponent(ComponentPtr): ClassID<T> only exists for the reflected engine classes
+		go->AddComponent(std::make_shared<Mover>());
+		TEST_CHECK(Dirties(*go->transform(), [&]() { Scene::Update(); }));
+		TEST_CHECK(Dirties(*go->transform(), [&]() { Scene::Update(); }));
+		TEST_CHECK(!Dirties(*go, [&]() { Scene::Update(); }));
+		Scene::DestroyImmediate(go);
+	}
+}
+
+int main()
+{
+	TestGameObject();
+	TestTransform();
+	TestBehaviour();
+	TestScriptEdit();
+	return FishEngine::Test::Report("DirtyCountTest");
+}
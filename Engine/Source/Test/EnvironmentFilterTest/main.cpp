@@ -0,0 +1,173 @@
+// EnvironmentFilter, the image based lighting computed at import time: cubemap texel geometry, the equirectangular
+// conversion, and the irradiance and prefiltered specular mips compared to brute force integrals of the source.
+
+#include <FishEngine/Mathf.hpp>
+#include <FishEngine/Render/EnvironmentFilter.hpp>
+
+#include <random>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	// sky gradient, a broad warm lobe and a small bright sun
+	Vector3 Environment(Vector3 const & d)
+	{
+		Vector3 sun = Vector3(0.3f, 0.8f, 0.5f).normalized();
+		float c = Vector3::Dot(d, sun);
+		float lobe = std::pow(std::max(c, 0.f), 4.f);
+		float spot = std::pow(std::max(c, 0.f), 200.f) * 20;
+		float sky = 0.5f + 0.5f * d.y;
+		return Vector3(0.2f + sky * 0.3f + lobe * 1.5f + spot, 0.3f + sky * 0.5f + lobe + spot, 0.5f + sky * 0.8f + lobe * 0.5f + spot);
+	}
+
+	template<typename Function>
+	void ForEachTexel(int size, Function f)
+	{
+		for (int face = 0; face < 6; ++face)
+			for (int y = 0; y < size; ++y)
+				for (int x = 0; x < size; ++x)
+					f(face, x, y);
+	}
+
+	CubemapImage MakeEnvironment(int size)
+	{
+		CubemapImage image;
+		image.Resize(size);
+		ForEachTexel(size, [&](int face, int x, int y) {
+			image.at(face, x, y) = Environment(EnvironmentFilter::TexelDirection(face, size, x + 0.5f, y + 0.5f));
+		});
+		return image;
+	}
+
+	std::vector<Vector3> RandomDirections(int count)
+	{
+		std::mt19937 rng(1);
+		std::normal_distribution<float> normal;
+		std::vector<Vector3> directions;
+		for (int i = 0; i < count; ++i)
+			directions.push_back(Vector3(normal(rng), normal(rng), normal(rng)).normalized());
+		return directions;
+	}
+
+	void TestTexels()
+	{
+		const int size = 64;
+		double total = 0;
+		ForEachTexel(size, [&](int, int x, int y) { total += EnvironmentFilter::TexelSolidAngle(size, x, y); });
+		TEST_CHECK_NEAR(total, 4 * Mathf::PI, 1e-3);
+
+		// Sample at the center of a texel gives the texel
+		auto image = MakeEnvironment(size);
+		float maxError = 0;
+		ForEachTexel(size, [&](int face, int x, int y) {
+			auto d = EnvironmentFilter::TexelDirection(face, size, x + 0.5f, y + 0.5f);
+			maxError = std::max(maxError, (image.Sample(d) - image.at(face, x, y)).magnitude());
+		});
+		TEST_CHECK(maxError < 1e-5f);
+	}
+
+	void TestEquirectangular()
+	{
+		// a smooth environment, mapped like SkyBox-Panorama: u = atan(x, -z) / 2pi + 0.5, v = acos(y) / pi
+		auto gradient = [](Vector3 const & d) { return Vector3(0.5f + 0.5f * d.x, 0.5f + 0.5f * d.y, 0.5f + 0.5f * d.z); };
+		const int width = 512, height = 256;
+		std::vector<Vector3> pixels(width * height);
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				float phi = ((x + 0.5f) / width - 0.5f) * 2 * Mathf::PI;
+				float theta = (y + 0.5f) / height * Mathf::PI;
+				Vector3 d(std::sin(theta) * std::sin(phi), std::cos(theta), -std::sin(theta) * std::cos(phi));
+				pixels[x + y * width] = gradient(d);
+			}
+		}
+		const int size = 64;
+		auto image = EnvironmentFilter::FromEquirectangular(pixels.data(), width, height, size);
+		TEST_CHECK(image.size == size);
+		float maxError = 0;
+		ForEachTexel(size, [&](int face, int x, int y) {
+			auto d = EnvironmentFilter::TexelDirection(face, size, x + 0.5f, y + 0.5f);
+			maxError = std::max(maxError, (image.at(face, x, y) - gradient(d)).magnitude());
+		});
+		TEST_CHECK(maxError < 1e-3f);
+	}
+
+	void TestIrradiance()
+	{
+		const int size = 64;
+		auto image = MakeEnvironment(size);
+		auto sh = EnvironmentFilter::ProjectIrradiance(image);
+		float maxError = 0;
+		for (auto const & n : RandomDirections(32))
+		{
+			// E(n) / pi
+			Vector3 reference = Vector3::zero;
+			ForEachTexel(size, [&](int face, int x, int y) {
+				auto w = EnvironmentFilter::TexelDirection(face, size, x + 0.5f, y + 0.5f);
+				float c = Vector3::Dot(n, w);
+				if (c > 0)
+					reference += image.at(face, x, y) * (c * EnvironmentFilter::TexelSolidAngle(size, x, y));
+			});
+			reference /= Mathf::PI;
+			maxError = std::max(maxError, (sh.Evaluate(n) - reference).magnitude() / reference.magnitude());
+		}
+		// L2 spherical harmonics: a few percent at most for a smooth lobe
+		TEST_CHECK(maxError < 0.05f);
+	}
+
+	void TestPrefilterSpecular()
+	{
+		const int size = 64;
+		auto image = MakeEnvironment(size);
+		auto mips = EnvironmentFilter::PrefilterSpecular(image, 256);
+		TEST_CHECK(static_cast<int>(mips.size()) == EnvironmentFilter::PrefilteredMipCount(size));
+		TEST_CHECK(mips.size() == 5);
+		TEST_CHECK(EnvironmentFilter::MipRoughness(0, 5) == 0);
+		TEST_CHECK(EnvironmentFilter::MipRoughness(4, 5) == 1);
+		for (size_t m = 0; m < mips.size(); ++m)
+			TEST_CHECK(mips[m].size == (size >> m));
+
+		auto directions = RandomDirections(32);
+		for (size_t m = 1; m < mips.size(); ++m)
+		{
+			// the GGX lobe (N = V = R) weighted by N.L, over the source
+			float roughness = EnvironmentFilter::MipRoughness(static_cast<int>(m), static_cast<int>(mips.size()));
+			float alpha = roughness * roughness;
+			float alpha2 = alpha * alpha;
+			float maxError = 0;
+			for (auto const & n : directions)
+			{
+				Vector3 sum = Vector3::zero;
+				double weight = 0;
+				ForEachTexel(size, [&](int face, int x, int y) {
+					auto l = EnvironmentFilter::TexelDirection(face, size, x + 0.5f, y + 0.5f);
+					float NoL = Vector3::Dot(n, l);
+					if (NoL <= 0)
+						return;
+					float NoH = Vector3::Dot(n, (n + l).normalized());
+					float d = (NoH * alpha2 - NoH) * NoH + 1;
+					float w = alpha2 / (Mathf::PI * d * d) * NoL * EnvironmentFilter::TexelSolidAngle(size, x, y);
+					sum += image.at(face, x, y) * w;
+					weight += w;
+				});
+				auto reference = sum / static_cast<float>(weight);
+				maxError = std::max(maxError, (mips[m].Sample(n) - reference).magnitude() / reference.magnitude());
+			}
+			// the 4x4 mip of roughness 1 is the coarsest
+			TEST_CHECK(maxError < 0.1f);
+		}
+	}
+}
+
+int main()
+{
+	TestTexels();
+	TestEquirectangular();
+	TestIrradiance();
+	TestPrefilterSpecular();
+	return FishEngine::Test::Report("EnvironmentFilterTest");
+}
@@ -0,0 +1,150 @@
+// FileInfo: the directory listing behind the background rescans of the project browser. A rescan adds the new
+// entries, detaches the missing ones and keeps the order of the others.
+
+#include <FileInfo.hpp>
+
+#include <fstream>
+#include <memory>
+
+#include <TestUtility.hpp>
+
+using namespace FishEditor;
+namespace fs = boost::filesystem;
+
+namespace
+{
+	void Touch(fs::path const & path)
+	{
+		std::ofstream(path.string()) << "x";
+	}
+
+	FileInfo::Entry const * FindEntry(std::vector<FileInfo::Entry> const & entries, std::string const & name)
+	{
+		for (auto const & e : entries)
+		{
+			if (e.path.filename() == name)
+				return &e;
+		}
+		return nullptr;
+	}
+
+	std::vector<std::string> ChildNames(FileInfo const & node)
+	{
+		std::vector<std::string> names;
+		for (int i = 0; i < static_cast<int>(node.childCount()); ++i)
+			names.push_back(node.childAt(i)->fileName());
+		return names;
+	}
+
+	void TestScanDirectory(fs::path const & dir)
+	{
+		fs::create_directory(dir / "Textures");
+		Touch(dir / "a.txt");
+		Touch(dir / "b.png");
+		Touch(dir / "b.png.meta");
+		Touch(dir / "Textures.meta");
+
+		auto entries = FileInfo::ScanDirectory(dir);
+		TEST_CHECK(entries.size() == 3);
+		auto textures = FindEntry(entries, "Textures");
+		TEST_CHECK(textures != nullptr && textures->isDirectory);
+		auto a = FindEntry(entries, "a.txt");
+		TEST_CHECK(a != nullptr && !a->isDirectory);
+		TEST_CHECK(FindEntry(entries, "b.png") != nullptr);
+		TEST_CHECK(FindEntry(entries, "b.png.meta") == nullptr);
+
+		// a folder deleted before its scan runs
+		TEST_CHECK(FileInfo::ScanDirectory(dir / "Missing").empty());
+	}
+
+	void TestUpdateChildren(fs::path const & dir)
+	{
+		// the root has an empty path: its children are relative to the current directory, dir
+		FileInfo root;
+		TEST_CHECK(root.UpdateChildren(FileInfo::ScanDirectory(dir)));
+		TEST_CHECK(root.listed());
+		TEST_CHECK(root.childCount() == 3);
+		TEST_CHECK(root.subDirCount() == 1);
+		auto textures = root.subDirAt(0);
+		TEST_CHECK(textures->fileName() == "Textures");
+		TEST_CHECK(textures->isDir());
+		TEST_CHECK(textures->parent() == &root);
+		// listed when opened
+		TEST_CHECK(!textures->listed());
+		TEST_CHECK(FileInfo::find((dir / "Textures").string()) == textures);
+		TEST_CHECK(FileInfo::find((dir / "a.txt").string()) == nullptr);	// only directories
+
+		// nothing changed on disk
+		TEST_CHECK(!root.UpdateChildren(FileInfo::ScanDirectory(dir)));
+		TEST_CHECK(root.childCount() == 3);
+
+		// one file removed, one added: the others keep their place, the new one goes last
+		auto names = ChildNames(root);
+		auto a = root.childAt(1);
+		TEST_CHECK(a->fileName() == names[1]);
+		fs::remove(dir / names[1]);
+		Touch(dir / "c.mat");
+		std::vector<std::unique_ptr<FileInfo>> removed;
+		TEST_CHECK(root.UpdateChildren(FileInfo::ScanDirectory(dir), &removed));
+		TEST_CHECK(ChildNames(root) == (std::vector<std::string>{ "Textures", names[2], "c.mat" }));
+		// handed over detached, for the views to let go of it before it is deleted
+		TEST_CHECK(removed.size() == 1 && removed[0].get() == a);
+		TEST_CHECK(a->parent() == nullptr);
+		removed.clear();
+
+		// a file replaced by a folder of the same name
+		fs::remove(dir / "c.mat");
+		fs::create_directory(dir / "c.mat");
+		TEST_CHECK(root.UpdateChildren(FileInfo::ScanDirectory(dir)));
+		TEST_CHECK(root.childCount() == 3);
+		TEST_CHECK(root.subDirCount() == 2);
+		TEST_CHECK(root.subDirAt(1)->fileName() == "c.mat");
+
+		// the content of a sub folder
+		Touch(dir / "Textures" / "t.png");
+		TEST_CHECK(textures->UpdateChildren(FileInfo::ScanDirectory(dir / "Textures")));
+		TEST_CHECK(textures->listed());
+		TEST_CHECK(textures->childCount() == 1);
+		TEST_CHECK(textures->childAt(0)->path() == fs::path("Textures") / "t.png");
+
+		// a folder deleted on disk, with a sub folder: the nodes go, and their paths are forgotten
+		fs::create_directory(dir / "Textures" / "Sub");
+		TEST_CHECK(textures->UpdateChildren(FileInfo::ScanDirectory(dir / "Textures")));
+		TEST_CHECK(FileInfo::find((dir / "Textures" / "Sub").string()) != nullptr);
+		fs::remove_all(dir / "Textures");
+		TEST_CHECK(root.UpdateChildren(FileInfo::ScanDirectory(dir)));
+		TEST_CHECK(root.subDirCount() == 1);
+		TEST_CHECK(FileInfo::find((dir / "Textures").string()) == nullptr);
+		TEST_CHECK(FileInfo::find((dir / "Textures" / "Sub").string()) == nullptr);
+
+		// a folder replaced by a file of the same name, and back
+		fs::remove(dir / "c.mat");
+		Touch(dir / "c.mat");
+		TEST_CHECK(root.UpdateChildren(FileInfo::ScanDirectory(dir)));
+		TEST_CHECK(FileInfo::find((dir / "c.mat").string()) == nullptr);
+		fs::remove(dir / "c.mat");
+		fs::create_directory(dir / "c.mat");
+		TEST_CHECK(root.UpdateChildren(FileInfo::ScanDirectory(dir), &removed));
+		auto folder = FileInfo::find((dir / "c.mat").string());
+		TEST_CHECK(folder != nullptr && folder->isDir());
+		// the file node deleted after the new folder was added
+		removed.clear();
+		TEST_CHECK(FileInfo::find((dir / "c.mat").string()) == folder);
+	}
+}
+
+int main()
+{
+	auto dir = fs::temp_directory_path() / fs::unique_path("FileInfoTest-%%%%-%%%%-%%%%");
+	fs::create_directories(dir);
+	auto cwd = fs::current_path();
+	fs::current_path(dir);
+	dir = fs::current_path();	// canonical, as returned by absolute()
+
+	TestScanDirectory(dir);
+	TestUpdateChildren(dir);
+
+	fs::current_path(cwd);
+	fs::remove_all(dir);
+	return FishEngine::Test::Report("FileInfoTest");
+}
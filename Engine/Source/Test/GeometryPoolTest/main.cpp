@@ -0,0 +1,274 @@
+// GeometryPool: the free list of the blocks (RangeAllocator), the interleaved layouts, and with a GL context the
+// meshes of a pool read back intact after the pool grew and was compacted, drawn without binding anything.
+
+#include <FishEngine/GeometryPool.hpp>
+#include <FishEngine/Mesh.hpp>
+
+#include <random>
+
+#include <GLTestContext.hpp>
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	void TestBestFit()
+	{
+		RangeAllocator a(100);
+		auto x = a.Allocate(10), y = a.Allocate(20), z = a.Allocate(30);
+		TEST_CHECK(x == 0 && y == 10 && z == 30);
+		TEST_CHECK(a.used() == 60);
+		a.Free(y);
+		TEST_CHECK(a.Allocate(20) == 10);
+		a.Free(x);
+		// the 10 free units at 0, not the 40 at the end
+		TEST_CHECK(a.Allocate(8) == 0);
+		TEST_CHECK(a.freeBlockCount() == 2);
+		TEST_CHECK(a.largestFreeBlock() == 40);
+		TEST_CHECK(a.Allocate(41) == RangeAllocator::InvalidOffset);
+		TEST_CHECK(a.allocations().size() == 3 && a.allocations().at(30) == 30);
+	}
+
+	void TestMergeAndGrow()
+	{
+		// freed in any order, the free blocks merge back into one
+		RangeAllocator a(1000);
+		std::vector<uint32_t> offsets;
+		for (int i = 0; i < 10; ++i)
+			offsets.push_back(a.Allocate(100));
+		TEST_CHECK(a.Allocate(1) == RangeAllocator::InvalidOffset);
+		TEST_CHECK(a.freeBlockCount() == 0);
+		for (int i = 0; i < 10; i += 2)
+			a.Free(offsets[i]);
+		// 500 free, in holes of 100
+		TEST_CHECK(a.freeBlockCount() == 5);
+		TEST_CHECK(a.largestFreeBlock() == 100);
+		TEST_CHECK(a.fragmentedSize() == 400);
+		TEST_CHECK(a.Allocate(101) == RangeAllocator::InvalidOffset);
+
+		// the allocations are kept, the new space is at the end
+		a.Grow(1200);
+		TEST_CHECK(a.capacity() == 1200);
+		TEST_CHECK(a.Allocate(101) == 1000);
+		TEST_CHECK(a.largestFreeBlock() == 100);
+
+		for (int i : { 3, 5, 1, 9, 7 })
+			a.Free(offsets[i]);
+		a.Free(1000);
+		TEST_CHECK(a.freeBlockCount() == 1);
+		TEST_CHECK(a.largestFreeBlock() == 1200 && a.used() == 0 && a.fragmentedSize() == 0);
+
+		// growing extends a free block at the end
+		RangeAllocator b(10);
+		b.Allocate(5);
+		b.Grow(20);
+		TEST_CHECK(b.freeBlockCount() == 1 && b.largestFreeBlock() == 15);
+	}
+
+	// random allocations and releases against a map of the units
+	void TestRandom()
+	{
+		std::mt19937 random(1);
+		const uint32_t capacity = 1 << 14;
+		RangeAllocator a(capacity);
+		std::vector<char> used(capacity, 0);
+		std::vector<std::pair<uint32_t, uint32_t>> live;
+		uint32_t overlaps = 0, wrongFailures = 0;
+		for (int step = 0; step < 20000; ++step)
+		{
+			if (live.empty() || random() % 100 < 52)
+			{
+				uint32_t size = 1 + random() % 300;
+				auto offset = a.Allocate(size);
+				if (offset == RangeAllocator::InvalidOffset)
+				{
+					if (a.largestFreeBlock() >= size)
+						wrongFailures++;
+					continue;
+				}
+				for (uint32_t i = offset; i < offset + size; ++i)
+				{
+					overlaps += used[i];
+					used[i] = 1;
+				}
+				live.emplace_back(offset, size);
+			}
+			else
+			{
+				auto k = random() % live.size();
+				a.Free(live[k].first);
+				std::fill(used.begin() + live[k].first, used.begin() + live[k].first + live[k].second, 0);
+				live[k] = live.back();
+				live.pop_back();
+			}
+		}
+		TEST_CHECK(overlaps == 0);
+		TEST_CHECK(wrongFailures == 0);
+		// the free blocks are maximal: one per run of free units
+		uint32_t usedCount = 0, runs = 0;
+		for (uint32_t i = 0; i < capacity; ++i)
+		{
+			usedCount += used[i];
+			if (!used[i] && (i == 0 || used[i - 1]))
+				runs++;
+		}
+		TEST_CHECK(usedCount == a.used());
+		TEST_CHECK(runs == a.freeBlockCount());
+	}
+
+	MeshPtr MakeMesh(std::mt19937 & random, uint32_t vertexCount, uint32_t triangleCount, bool withUV = true)
+	{
+		std::vector<Vector3> vertices(vertexCount), normals(vertexCount), tangents(vertexCount, Vector3(1, 0, 0));
+		std::vector<Vector2> uv(withUV ? vertexCount : 0);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			vertices[i] = Vector3(float(random() % 1000), float(random() % 1000), float(random() % 1000));
+			normals[i] = Vector3(0, 1, float(i));
+			if (withUV)
+				uv[i] = Vector2(float(i), 0.5f);
+		}
+		std::vector<uint32_t> triangles(triangleCount * 3);
+		for (auto & i : triangles)
+			i = random() % vertexCount;
+		return std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::move(uv), std::move(tangents), std::move(triangles));
+	}
+
+	void TestLayout()
+	{
+		std::mt19937 random(3);
+		auto mesh = MakeMesh(random, 2, 1);
+		const uint32_t all = GeometryPool::NormalAttribute | GeometryPool::UVAttribute | GeometryPool::TangentAttribute;
+		TEST_CHECK(GeometryPool::LayoutOf(*mesh) == all);
+		TEST_CHECK(GeometryPool::LayoutOf(*MakeMesh(random, 2, 1, false)) == (GeometryPool::NormalAttribute | GeometryPool::TangentAttribute));
+		TEST_CHECK(GeometryPool::Stride(0) == 12);
+		TEST_CHECK(GeometryPool::Stride(all) == 44);
+
+		// position, normal, uv, tangent
+		float interleaved[22];
+		GeometryPool::Interleave(*mesh, all, interleaved);
+		auto const & p = mesh->vertices()[1];
+		TEST_CHECK(interleaved[11] == p.x && interleaved[12] == p.y && interleaved[13] == p.z);
+		TEST_CHECK(interleaved[14] == 0 && interleaved[15] == 1 && interleaved[16] == 1);
+		TEST_CHECK(interleaved[17] == 1 && interleaved[18] == 0.5f);
+		TEST_CHECK(interleaved[19] == 1 && interleaved[20] == 0 && interleaved[21] == 0);
+
+		// the attributes outside the layout are left out
+		float positions[6];
+		GeometryPool::Interleave(*mesh, 0, positions);
+		TEST_CHECK(positions[3] == p.x && positions[5] == p.z);
+	}
+
+	bool SameGeometry(Mesh const & mesh, std::vector<Vector3> const & corners)
+	{
+		auto const & triangles = mesh.triangles();
+		if (triangles.size() != corners.size() || mesh.normals().size() != mesh.vertices().size())
+			return false;
+		for (size_t i = 0; i < corners.size(); ++i)
+		{
+			auto v = triangles[i];
+			if (v >= mesh.vertices().size() || !(mesh.vertices()[v] == corners[i]) || mesh.normals()[v].z != float(v))
+				return false;
+		}
+		return true;
+	}
+
+	void TestPool()
+	{
+		std::mt19937 random(2);
+		std::vector<MeshPtr> meshes;
+		std::vector<std::vector<Vector3>> corners;
+		const uint32_t all = GeometryPool::NormalAttribute | GeometryPool::UVAttribute | GeometryPool::TangentAttribute;
+		auto & pool = GeometryPool::Get(all);
+		auto statistics = GeometryPool::statistics();
+
+		// more than the initial capacity: the pool grows
+		for (int i = 0; i < 120; ++i)
+		{
+			auto mesh = MakeMesh(random, 200 + random() % 1000, 100 + random() % 1500);
+			std::vector<Vector3> c;
+			for (auto v : mesh->triangles())
+				c.push_back(mesh->vertices()[v]);
+			mesh->UploadMeshData();
+			TEST_CHECK(mesh->vertices().empty());
+			meshes.push_back(mesh);
+			corners.push_back(c);
+		}
+		TEST_CHECK(pool.vertexAllocator().capacity() > GeometryPool::InitialVertexCapacity);
+		TEST_CHECK(pool.indexAllocator().capacity() > GeometryPool::InitialIndexCapacity);
+		TEST_CHECK(GeometryPool::statistics().reallocations > statistics.reallocations);
+
+		// released: the holes are compacted
+		for (size_t i = 0; i < meshes.size(); i += 2)
+			meshes[i].reset();
+		TEST_CHECK(GeometryPool::statistics().defragmentations > statistics.defragmentations);
+		TEST_CHECK(pool.vertexAllocator().fragmentedSize() <= GeometryPool::DefragmentThreshold * pool.vertexAllocator().capacity());
+		bool intact = true;
+		for (size_t i = 1; i < meshes.size(); i += 2)
+			intact = intact && meshes[i]->ReadBackMeshData() && SameGeometry(*meshes[i], corners[i]);
+		TEST_CHECK(intact);
+		TEST_CHECK(meshes[1]->uv()[3].x == 3 && meshes[1]->uv()[3].y == 0.5f);
+
+		// another layout, another pool
+		auto small = MakeMesh(random, 3, 1, false);
+		auto smallCorners = std::vector<Vector3>{ small->vertices()[small->triangles()[0]], small->vertices()[small->triangles()[1]], small->vertices()[small->triangles()[2]] };
+		small->UploadMeshData();
+		TEST_CHECK(small->ReadBackMeshData() && SameGeometry(*small, smallCorners) && small->uv().empty());
+		TEST_CHECK(GeometryPool::Get(GeometryPool::NormalAttribute | GeometryPool::TangentAttribute).vertexAllocator().used() == 3);
+
+		TEST_CHECK(glGetError() == GL_NO_ERROR);
+
+		// two passes over the meshes of a pool: one bind, the VAO and its buffers stay bound (no program: only the
+		// binds are counted)
+		GeometryPool::InvalidateBinding();
+		statistics = GeometryPool::statistics();
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			for (auto & m : meshes)
+			{
+				if (m != nullptr)
+					m->Render(-1);
+			}
+		}
+		TEST_CHECK(GeometryPool::statistics().vertexArrayBinds - statistics.vertexArrayBinds == 1);
+		TEST_CHECK(GeometryPool::statistics().bufferBinds == statistics.bufferBinds);
+	}
+
+	// a mesh outside the pools (no triangles) deleted with its VAO bound: the next VAO may get the same name, binding
+	// it must not be skipped
+	void TestDeletedVertexArray()
+	{
+		std::mt19937 random(4);
+		auto mesh = MakeMesh(random, 3, 0);
+		// drawn: its VAO stays bound
+		mesh->Render(-1);
+		GLint bound = 0;
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &bound);
+		TEST_CHECK(bound != 0);
+		mesh.reset();
+
+		GLuint vao = 0;
+		glGenVertexArrays(1, &vao);
+		GeometryPool::BindVertexArray(vao);
+		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &bound);
+		TEST_CHECK(bound == static_cast<GLint>(vao));
+		GeometryPool::InvalidateBinding();
+		glDeleteVertexArrays(1, &vao);
+	}
+}
+
+int main()
+{
+	TestBestFit();
+	TestMergeAndGrow();
+	TestRandom();
+	TestLayout();
+	if (FishEngine::Test::CreateGLContext())
+	{
+		TestPool();
+		TestDeletedVertexArray();
+	}
+	else
+		FishEngine::Test::Skip("GeometryPoolTest");
+	return FishEngine::Test::Report("GeometryPoolTest");
+}
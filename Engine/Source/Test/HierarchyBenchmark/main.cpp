@@ -0,0 +1,80 @@
+// The hierarchy view of a 50k object scene: the CPU used by the idle editor (the event loop with the view shown and
+// nothing changing, which used to re-walk the scene 10 times a second), and the cost of a change notification.
+// Offscreen Qt: no window is shown.
+
+#include <HierarchyModel.hpp>
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <QApplication>
+#include <QTimer>
+#include <QTreeView>
+
+#include <string>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEngine::Test;
+
+namespace
+{
+	// CPU milliseconds per second of the event loop, run for seconds.
+	double IdleCPU(QApplication & app, double seconds)
+	{
+		QTimer::singleShot(static_cast<int>(seconds * 1000), &app, &QApplication::quit);
+		double cpu = ProcessCPUTime();
+		app.exec();
+		return (ProcessCPUTime() - cpu) / seconds;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+
+	// 500 roots of 99 children each
+	const int roots = 500;
+	const int children = 99;
+	Stopwatch stopwatch;
+	for (int r = 0; r < roots; ++r)
+	{
+		auto root = Scene::CreateGameObject("Root" + std::to_string(r));
+		for (int c = 0; c < children; ++c)
+			Scene::CreateGameObject("Child" + std::to_string(c))->transform()->SetParent(root->transform());
+	}
+	PrintMeasurement("create 50k objects, no view", stopwatch.milliseconds(), "ms");
+
+	HierarchyModel model;
+	QTreeView view;
+	view.setModel(&model);
+	view.resize(300, 800);
+	view.show();
+	// the first roots expanded, as a user would
+	for (int r = 0; r < 20; ++r)
+		view.expand(model.index(r, 0));
+	app.processEvents();
+
+	PrintMeasurement("idle, 50k objects, view shown", IdleCPU(app, 5), "ms CPU/s");
+
+	auto target = Scene::Find("Root3");
+	stopwatch.Restart();
+	const int renames = 1000;
+	for (int i = 0; i < renames; ++i)
+		target->setName("Renamed" + std::to_string(i));
+	app.processEvents();
+	PrintMeasurement("rename a visible root (notification and repaint)", stopwatch.milliseconds() / renames, "ms");
+
+	auto child = Scene::Find("Child5")->transform();
+	TransformPtr parents[2] = { Scene::Find("Root1")->transform(), Scene::Find("Root2")->transform() };
+	stopwatch.Restart();
+	const int moves = 1000;
+	for (int i = 0; i < moves; ++i)
+		child->SetParent(parents[i % 2]);
+	app.processEvents();
+	PrintMeasurement("reparent between two expanded roots", stopwatch.milliseconds() / moves, "ms");
+	return 0;
+}
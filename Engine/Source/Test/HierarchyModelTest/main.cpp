@@ -0,0 +1,181 @@
+// HierarchyModel, the model of the hierarchy view: kept in sync with the scene by the hierarchy notifications only.
+// Random edits (create, destroy, reparent, rename, activate) on a partly fetched model; after each one the fetched
+// rows must be the children of the scene, in order, with consistent indices.
+
+#include <HierarchyModel.hpp>
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <QGuiApplication>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	std::vector<TransformPtr> SceneRoots()
+	{
+		std::vector<TransformPtr> roots;
+		for (auto const & go : Scene::GameObjects())
+		{
+			if (go->transform()->parent() == nullptr)
+				roots.push_back(go->transform());
+		}
+		return roots;
+	}
+
+	// The rows under parent, and under the fetched rows below it, are the expected transforms.
+	bool Consistent(HierarchyModel & model, QModelIndex const & parent, std::vector<TransformPtr> const & expected)
+	{
+		// not fetched: nothing to compare, only whether it says it has children
+		if (model.canFetchMore(parent))
+			return !expected.empty() && model.rowCount(parent) == 0;
+		if (model.rowCount(parent) != static_cast<int>(expected.size()))
+			return false;
+		for (int row = 0; row < model.rowCount(parent); ++row)
+		{
+			auto index = model.index(row, 0, parent);
+			auto const & t = expected[row];
+			if (!index.isValid() || index.row() != row || model.parent(index) != parent || model.transform(index) != t)
+				return false;
+			if (model.data(index).toString().toStdString() != t->gameObject()->name())
+				return false;
+			std::vector<TransformPtr> children(t->children().begin(), t->children().end());
+			if (!Consistent(model, index, children))
+				return false;
+		}
+		return true;
+	}
+
+	bool Consistent(HierarchyModel & model)
+	{
+		return Consistent(model, QModelIndex(), SceneRoots());
+	}
+
+	bool IsInSubtree(TransformPtr t, TransformPtr const & root)
+	{
+		for (; t != nullptr; t = t->parent())
+		{
+			if (t == root)
+				return true;
+		}
+		return false;
+	}
+
+	std::vector<GameObjectPtr> AllGameObjects()
+	{
+		return std::vector<GameObjectPtr>(Scene::GameObjects().begin(), Scene::GameObjects().end());
+	}
+
+	void TestRandomEdits(unsigned seed, bool fetchAll)
+	{
+		HierarchyModel model;
+		std::mt19937 random(seed);
+		auto pick = [&random](std::vector<GameObjectPtr> const & objects) {
+			return objects[std::uniform_int_distribution<size_t>(0, objects.size() - 1)(random)];
+		};
+		int created = 0;
+		int failures = 0;
+		for (int edit = 0; edit < 2000; ++edit)
+		{
+			auto objects = AllGameObjects();
+			int action = objects.size() < 10 ? 0 : std::uniform_int_distribution<int>(0, 6)(random);
+			switch (action)
+			{
+			case 0:	// a new root
+				Scene::CreateGameObject("GameObject" + std::to_string(created++));
+				break;
+			case 1:	// a new child
+			{
+				auto child = Scene::CreateGameObject("GameObject" + std::to_string(created++));
+				child->transform()->SetParent(pick(objects)->transform());
+				break;
+			}
+			case 2:	// a subtree
+				if (objects.size() > 40)
+					Scene::DestroyImmediate(pick(objects));
+				break;
+			case 3:	// another parent, not in its subtree
+			{
+				auto t = pick(objects)->transform();
+				auto parent = pick(objects)->transform();
+				if (!IsInSubtree(parent, t))
+					t->SetParent(parent);
+				break;
+			}
+			case 4:
+				pick(objects)->transform()->SetParent(nullptr);
+				break;
+			case 5:
+				pick(objects)->setName("Renamed" + std::to_string(edit));
+				break;
+			case 6:
+			{
+				auto go = pick(objects);
+				go->SetActive(!go->activeSelf());
+				break;
+			}
+			}
+
+			// the view expands some rows (or all of them) between the edits
+			if (fetchAll)
+			{
+				for (auto const & go : AllGameObjects())
+					model.FetchIndex(go->transform());
+			}
+			else if (edit % 7 == 0)
+			{
+				model.FetchIndex(pick(AllGameObjects())->transform());
+			}
+
+			if (!Consistent(model))
+				failures++;
+		}
+		TEST_CHECK(failures == 0);
+
+		for (auto const & root : SceneRoots())
+			Scene::DestroyImmediate(root->gameObject());
+		TEST_CHECK(model.rowCount() == 0);
+	}
+
+	void TestListenerAddedInNotification()
+	{
+		// a model created by a notification (e.g. a new hierarchy view) does not invalidate the listener loop
+		std::unique_ptr<HierarchyModel> late;
+		int id = Scene::AddHierarchyListener([&late](HierarchyChange, GameObject*) {
+			if (late == nullptr)
+				late.reset(new HierarchyModel);
+		});
+		auto go = Scene::CreateGameObject("A");
+		TEST_CHECK(late != nullptr);
+		// and it follows the next changes
+		late->fetchMore(QModelIndex());
+		auto b = Scene::CreateGameObject("B");
+		TEST_CHECK(Consistent(*late));
+		Scene::RemoveHierarchyListener(id);
+		late.reset();
+		Scene::DestroyImmediate(go);
+		Scene::DestroyImmediate(b);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// QBrush of data(); no window is shown
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QGuiApplication app(argc, argv);
+
+	TestRandomEdits(1, false);
+	TestRandomEdits(2, false);
+	TestRandomEdits(3, true);
+	TestListenerAddedInNotification();
+	return FishEngine::Test::Report("HierarchyModelTest");
+}
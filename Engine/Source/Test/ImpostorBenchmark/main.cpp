@@ -0,0 +1,115 @@
+// The draw calls and the CPU time of a frame of a forest, seen from its edge: every tree drawn as its mesh, then the
+// trees beyond 40 m drawn as their impostor (ImpostorBaker::BakeHierarchy), and the time of the bake.
+// The forest is the Forest scene of the editor: cones in a grid, 3600 of them or the number given as argument.
+// It needs a display.
+
+#include <FishEngine/Camera.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/GLEnvironment.hpp>
+#include <FishEngine/Graphics.hpp>
+#include <FishEngine/Impostor.hpp>
+#include <FishEngine/Light.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshRenderer.hpp>
+#include <FishEngine/RenderSystem.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Screen.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <BenchmarkUtility.hpp>
+#include <GLTestContext.hpp>
+
+using namespace FishEngine;
+using namespace FishEngine::Test;
+
+namespace
+{
+	GameObjectPtr CreateForest(int treeCount)
+	{
+		auto leaves = Material::InstantiateBuiltinMaterial("PBR");
+		leaves->SetVector3("BaseColor", Vector3(0.13f, 0.32f, 0.12f));
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> jitter(-2, 2);
+		std::uniform_real_distribution<float> size(1.5f, 2.5f);
+		const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(treeCount))));
+		auto forest = Scene::CreateGameObject("Forest");
+		for (int i = 0; i < treeCount; ++i)
+		{
+			auto tree = GameObject::CreatePrimitive(PrimitiveType::Cone);
+			tree->GetComponent<MeshRenderer>()->SetMaterial(leaves);
+			tree->transform()->SetParent(forest->transform());
+			float scale = size(random);
+			float x = (i % side - side / 2) * 5.0f + jitter(random);
+			float z = (i / side) * 5.0f + jitter(random);
+			tree->transform()->setLocalPosition(x, scale, z);
+			tree->transform()->setLocalScale(scale);
+		}
+		return forest;
+	}
+
+	void MeasureFrames(CameraPtr const & camera, std::string const & name)
+	{
+		// the first frame compiles the shaders
+		RenderSystem::Render(camera, RenderQuality::Full, Screen::width(), Screen::height());
+		glFinish();
+
+		const int frames = 100;
+		auto draws = Graphics::drawCallCount();
+		double cpu = ProcessCPUTime();
+		Stopwatch stopwatch;
+		for (int i = 0; i < frames; ++i)
+		{
+			RenderSystem::Render(camera, RenderQuality::Full, Screen::width(), Screen::height());
+			glFinish();
+		}
+		double wall = stopwatch.milliseconds();
+		PrintMeasurement((name + ", draw calls per frame").c_str(), static_cast<double>(Graphics::drawCallCount() - draws) / frames, "");
+		PrintMeasurement((name + ", CPU per frame").c_str(), (ProcessCPUTime() - cpu) / frames, "ms");
+		PrintMeasurement((name + ", frame time").c_str(), wall / frames, "ms");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const int treeCount = argc > 1 ? std::atoi(argv[1]) : 3600;
+	if (!CreateGLContext())
+	{
+		std::printf("no GL context, no forest\n");
+		return 0;
+	}
+
+	Path shaders = FISHENGINE_SHADER_DIR;
+	ShaderCompiler::setShaderIncludeDir((shaders / "include").string());
+	Shader::Init(shaders.string());
+	Mesh::Init(FISHENGINE_MODEL_DIR);
+	Screen::set(1280, 720);
+	RenderSystem::Init();
+
+	auto forest = CreateForest(treeCount);
+	auto camera = Scene::CreateCamera();
+	camera->transform()->setPosition(0, 12, -10);
+	camera->transform()->setLocalEulerAngles(10, 0, 0);
+	auto light = Scene::CreateGameObject("Directional Light");
+	light->transform()->setLocalEulerAngles(50, -30, 0);
+	light->AddComponent(Light::Create());
+
+	std::string name = std::to_string(treeCount) + " trees";
+	MeasureFrames(camera->GetComponent<Camera>(), name + ", meshes");
+
+	Stopwatch stopwatch;
+	int baked = ImpostorBaker::BakeHierarchy(forest, 40);
+	glFinish();
+	PrintMeasurement((name + ", BakeHierarchy").c_str(), stopwatch.milliseconds(), "ms");
+	PrintMeasurement((name + ", renderers with an impostor").c_str(), baked, "");
+	MeasureFrames(camera->GetComponent<Camera>(), name + ", impostors beyond 40 m");
+	return 0;
+}
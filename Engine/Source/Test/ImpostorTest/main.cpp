@@ -0,0 +1,251 @@
+// ImpostorUtility: the octahedral maps invert each other, the blend of the frames of a view direction points the same
+// way, and the cameras of the frames agree with FramePoint, ProjectToFrame and the atlas coordinates (as the shader).
+// With a GL context, ImpostorBaker: a hierarchy baked inside the frame of a camera, which is bound again after it.
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/GLEnvironment.hpp>
+#include <FishEngine/Impostor.hpp>
+#include <FishEngine/ImpostorUtility.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/MeshRenderer.hpp>
+#include <FishEngine/Pipeline.hpp>
+#include <FishEngine/RenderSystem.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Screen.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/Transform.hpp>
+#include <FishEngine/Vector4.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include <GLTestContext.hpp>
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	std::mt19937 s_random(1);
+	std::uniform_real_distribution<float> s_signed(-1, 1);
+
+	Vector3 RandomDirection()
+	{
+		Vector3 d;
+		do
+		{
+			d = Vector3(s_signed(s_random), s_signed(s_random), s_signed(s_random));
+		} while (d.magnitude() < 1e-3f || d.magnitude() > 1);
+		return d.normalized();
+	}
+
+	Vector3 Blended(ImpostorUtility::Layout const & layout, ImpostorUtility::FrameBlend const & blend)
+	{
+		Vector3 d = Vector3::zero;
+		for (int k = 0; k < 3; ++k)
+			d += ImpostorUtility::FrameDirection(layout, blend.x[k], blend.y[k]) * blend.weight[k];
+		return d;
+	}
+
+	void TestOctahedral()
+	{
+		float sphereError = 0, hemisphereError = 0, outside = 0;
+		for (int i = 0; i < 10000; ++i)
+		{
+			auto d = RandomDirection();
+			sphereError = std::max(sphereError, (ImpostorUtility::OctahedralDecode(ImpostorUtility::OctahedralEncode(d)) - d).magnitude());
+			d.y = std::abs(d.y);
+			auto p = ImpostorUtility::HemiOctahedralEncode(d);
+			hemisphereError = std::max(hemisphereError, (ImpostorUtility::HemiOctahedralDecode(p) - d).magnitude());
+			outside = std::max(outside, std::max(std::abs(p.x), std::abs(p.y)) - 1);
+		}
+		TEST_CHECK(sphereError < 1e-4f);
+		TEST_CHECK(hemisphereError < 1e-4f);
+		TEST_CHECK(outside < 1e-4f);
+
+		// y is the pole: the center of the maps
+		auto up = ImpostorUtility::OctahedralEncode(Vector3(0, 1, 0));
+		TEST_CHECK(up.x == 0 && up.y == 0);
+		auto hemiUp = ImpostorUtility::HemiOctahedralEncode(Vector3(0, 1, 0));
+		TEST_CHECK(hemiUp.x == 0 && hemiUp.y == 0);
+	}
+
+	void TestBlend()
+	{
+		for (bool hemisphere : { true, false })
+		{
+			ImpostorUtility::Layout layout;
+			layout.hemisphere = hemisphere;
+			int badFrames = 0, badWeights = 0;
+			float minDot = 1;
+			for (int i = 0; i < 5000; ++i)
+			{
+				auto d = RandomDirection();
+				auto blend = ImpostorUtility::BlendFrames(layout, d);
+				float sum = 0;
+				for (int k = 0; k < 3; ++k)
+				{
+					sum += blend.weight[k];
+					badWeights += blend.weight[k] < -1e-5f;
+					badFrames += blend.x[k] < 0 || blend.x[k] >= layout.framesPerSide || blend.y[k] < 0 || blend.y[k] >= layout.framesPerSide;
+				}
+				badWeights += std::abs(sum - 1) > 1e-4f;
+				// below the horizon: the frames of the horizon
+				if (hemisphere && d.y < 0)
+				{
+					d.y = 0;
+					d.Normalize();
+				}
+				minDot = std::min(minDot, Vector3::Dot(Blended(layout, blend).normalized(), d));
+			}
+			TEST_CHECK(badFrames == 0);
+			TEST_CHECK(badWeights == 0);
+			TEST_CHECK(minDot > 0.9f);
+
+			// the direction of a frame is drawn with that frame only
+			float frameError = 0, lengthError = 0;
+			for (int y = 0; y < layout.framesPerSide; ++y)
+			{
+				for (int x = 0; x < layout.framesPerSide; ++x)
+				{
+					auto d = ImpostorUtility::FrameDirection(layout, x, y);
+					lengthError = std::max(lengthError, std::abs(d.magnitude() - 1));
+					frameError = std::max(frameError, (Blended(layout, ImpostorUtility::BlendFrames(layout, d)) - d).magnitude());
+				}
+			}
+			TEST_CHECK(lengthError < 1e-4f);
+			TEST_CHECK(frameError < 1e-3f);
+		}
+	}
+
+	void TestFrames()
+	{
+		ImpostorUtility::Layout layout;
+		layout.hemisphere = false;
+		auto projection = ImpostorUtility::FrameProjectionMatrix();
+		float clipError = 0, projectError = 0;
+		int atlasErrors = 0;
+		for (int y = 0; y < layout.framesPerSide; ++y)
+		{
+			for (int x = 0; x < layout.framesPerSide; ++x)
+			{
+				auto d = ImpostorUtility::FrameDirection(layout, x, y);
+				auto viewProjection = projection * ImpostorUtility::FrameViewMatrix(d);
+				for (int k = 0; k < 20; ++k)
+				{
+					Vector2 uv((s_signed(s_random) + 1) / 2, (s_signed(s_random) + 1) / 2);
+					float depth = (s_signed(s_random) + 1) / 2;
+
+					// rendered by the camera of the frame at uv, with that depth
+					auto p = ImpostorUtility::FramePoint(d, uv, depth);
+					Vector4 c = viewProjection * Vector4(p.x, p.y, p.z, 1);
+					clipError = std::max(clipError, std::abs(c.x / c.w * 0.5f + 0.5f - uv.x));
+					clipError = std::max(clipError, std::abs(c.y / c.w * 0.5f + 0.5f - uv.y));
+					clipError = std::max(clipError, std::abs(c.z / c.w * 0.5f + 0.5f - depth));
+
+					// seen from any eye, a point of the plane is where it is
+					Vector3 eye(s_signed(s_random) * 5, s_signed(s_random) * 5 + 6, s_signed(s_random) * 5);
+					Vector2 projected;
+					if (ImpostorUtility::ProjectToFrame(d, eye, ImpostorUtility::FramePoint(d, uv, 0.5f), projected))
+						projectError = std::max(projectError, (projected - uv).magnitude());
+				}
+
+				// the frame is inside its viewport, half a texel in from its borders
+				int viewport[4];
+				ImpostorUtility::FrameViewport(layout, x, y, viewport);
+				float size = static_cast<float>(layout.atlasSize());
+				auto a0 = ImpostorUtility::AtlasUV(layout, x, y, Vector2(0, 0)) * size;
+				auto a1 = ImpostorUtility::AtlasUV(layout, x, y, Vector2(1, 1)) * size;
+				atlasErrors += viewport[2] != layout.frameResolution || viewport[3] != layout.frameResolution;
+				atlasErrors += std::abs(a0.x - viewport[0] - 0.5f) > 1e-2f || std::abs(a0.y - viewport[1] - 0.5f) > 1e-2f;
+				atlasErrors += std::abs(a1.x - (viewport[0] + viewport[2] - 0.5f)) > 1e-2f;
+				atlasErrors += std::abs(a1.y - (viewport[1] + viewport[3] - 0.5f)) > 1e-2f;
+			}
+		}
+		TEST_CHECK(clipError < 1e-3f);
+		TEST_CHECK(projectError < 1e-3f);
+		TEST_CHECK(atlasErrors == 0);
+
+		// a ray parallel to the plane of the frame
+		Vector3 right, up;
+		ImpostorUtility::FrameBasis(Vector3(0, 0, 1), right, up);
+		Vector2 projected;
+		TEST_CHECK(!ImpostorUtility::ProjectToFrame(Vector3(0, 0, 1), right * 3, Vector3::zero, projected));
+	}
+
+	// the camera uniforms bound for the shaders (Pipeline::BindCamera)
+	PerCameraUniforms BoundCamera()
+	{
+		GLint buffer = 0;
+		glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, Pipeline::PerCameraUBOBindingPoint, &buffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		PerCameraUniforms uniforms;
+		glGetBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(uniforms), &uniforms);
+		return uniforms;
+	}
+
+	void TestBake()
+	{
+		Path shaders = FISHENGINE_SHADER_DIR;
+		ShaderCompiler::setShaderIncludeDir((shaders / "include").string());
+		Shader::Init(shaders.string());
+		Screen::set(64, 64);
+		RenderSystem::Init();
+
+		// a tetrahedron, twice, and a renderer without a mesh
+		std::vector<Vector3> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+		std::vector<Vector3> normals(4, Vector3(0, 1, 0));
+		auto mesh = std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::vector<Vector2>(4),
+			std::vector<Vector3>(4, Vector3(1, 0, 0)), std::vector<uint32_t>{ 0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3 });
+		auto material = Material::InstantiateBuiltinMaterial("PBR");
+		material->SetVector3("BaseColor", Vector3(0.2f, 0.6f, 0.2f));
+		auto root = Scene::CreateGameObject("Root");
+		for (int i = 0; i < 3; ++i)
+		{
+			auto go = Scene::CreateGameObject("Child");
+			go->transform()->SetParent(root->transform());
+			if (i < 2)
+				go->AddComponent(std::make_shared<MeshFilter>(mesh));
+			go->AddComponent<MeshRenderer>()->SetMaterial(material);
+		}
+
+		auto view = Matrix4x4::LookAt(Vector3(0, 2, -10), Vector3::zero, Vector3::up);
+		auto projection = Matrix4x4::Perspective(60, 1, 0.3f, 1000);
+		Pipeline::BindCamera(projection, view, 0.3f, 1000);
+		glViewport(0, 0, 64, 64);
+
+		TEST_CHECK(ImpostorBaker::BakeHierarchy(root, 50) == 2);
+		auto renderers = root->GetComponentsInChildren<MeshRenderer>();
+		TEST_CHECK(renderers[0]->impostor() != nullptr && renderers[0]->impostorDistance() == 50);
+		// the same mesh and materials: baked once
+		TEST_CHECK(renderers[1]->impostor() == renderers[0]->impostor());
+		TEST_CHECK(renderers[2]->impostor() == nullptr);
+		TEST_CHECK(std::abs(renderers[0]->impostor()->radius() - std::sqrt(3.0f) / 2) < 1e-4f);
+
+		auto bound = BoundCamera();
+		TEST_CHECK(bound.MATRIX_V == view);
+		TEST_CHECK(bound.MATRIX_P == projection);
+		TEST_CHECK(bound.ProjectionParams.z == 1000);
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		TEST_CHECK(viewport[2] == 64 && viewport[3] == 64);
+
+		ImpostorBaker::ClearCache();
+		Scene::DestroyImmediate(root);
+	}
+}
+
+int main()
+{
+	TestOctahedral();
+	TestBlend();
+	TestFrames();
+	if (FishEngine::Test::CreateGLContext())
+		TestBake();
+	else
+		FishEngine::Test::Skip("ImpostorTest");
+	return FishEngine::Test::Report("ImpostorTest");
+}
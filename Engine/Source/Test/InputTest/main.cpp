@@ -0,0 +1,247 @@
+// Input: the per frame state derived from the posted events, and the replay of the events of a frame
+// (FrameRecorder). No window: the events are posted as by the callbacks of GameApp.
+
+#include <FishEngine/Input.hpp>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	void Post(InputEventType type, int code = 0, float x = 0, float y = 0)
+	{
+		Input::PostEvent(InputEvent{ type, Input::Now(), code, x, y });
+	}
+
+	void TestKeyTransitions()
+	{
+		Input::Init();
+		Post(InputEventType::KeyDown, (int)KeyCode::A);
+		TEST_CHECK(Input::GetKeyDown(KeyCode::A));
+		TEST_CHECK(Input::GetKey(KeyCode::A));
+		TEST_CHECK(!Input::GetKeyUp(KeyCode::A));
+		TEST_CHECK(!Input::GetKey(KeyCode::B));
+
+		// held on the next frames, down only on the first
+		Input::Update();
+		TEST_CHECK(!Input::GetKeyDown(KeyCode::A));
+		TEST_CHECK(Input::GetKey(KeyCode::A));
+
+		// key repeat is not a new press
+		Post(InputEventType::KeyDown, (int)KeyCode::A);
+		TEST_CHECK(!Input::GetKeyDown(KeyCode::A));
+		TEST_CHECK(Input::frameEvents().empty());
+
+		Input::Update();
+		Post(InputEventType::KeyUp, (int)KeyCode::A);
+		TEST_CHECK(Input::GetKeyUp(KeyCode::A));
+		TEST_CHECK(!Input::GetKey(KeyCode::A));
+		Input::Update();
+		TEST_CHECK(!Input::GetKeyUp(KeyCode::A));
+		TEST_CHECK(!Input::GetKey(KeyCode::A));
+	}
+
+	void TestPressAndReleaseInOneFrame()
+	{
+		Input::Init();
+		Post(InputEventType::KeyDown, (int)KeyCode::Space);
+		Post(InputEventType::KeyUp, (int)KeyCode::Space);
+		// not lost between two frames
+		TEST_CHECK(Input::GetKeyDown(KeyCode::Space));
+		TEST_CHECK(Input::GetKeyUp(KeyCode::Space));
+		TEST_CHECK(Input::GetKey(KeyCode::Space));
+		Input::Update();
+		TEST_CHECK(!Input::GetKeyDown(KeyCode::Space));
+		TEST_CHECK(!Input::GetKeyUp(KeyCode::Space));
+		TEST_CHECK(!Input::GetKey(KeyCode::Space));
+	}
+
+	void TestInvalidCodes()
+	{
+		Input::Init();
+		Post(InputEventType::KeyDown, -1);
+		Post(InputEventType::KeyDown, keyCount);
+		Post(InputEventType::MouseButtonDown, 3);
+		TEST_CHECK(Input::frameEvents().empty());
+		TEST_CHECK(!Input::GetKey(static_cast<KeyCode>(-1)));
+	}
+
+	void TestMouseButtons()
+	{
+		Input::Init();
+		Post(InputEventType::MouseButtonDown, 1);
+		TEST_CHECK(Input::GetMouseButtonDown(1));
+		TEST_CHECK(Input::GetMouseButton(1));
+		TEST_CHECK(!Input::GetMouseButton(0));
+		Input::Update();
+		TEST_CHECK(!Input::GetMouseButtonDown(1));
+		TEST_CHECK(Input::GetMouseButton(1));
+		Post(InputEventType::MouseButtonUp, 1);
+		TEST_CHECK(Input::GetMouseButtonUp(1));
+		TEST_CHECK(!Input::GetMouseButton(1));
+		Input::Update();
+		TEST_CHECK(!Input::GetMouseButtonUp(1));
+	}
+
+	void TestMouseMove()
+	{
+		// positions only (the editor): the delta is the movement of the position
+		Input::Init();
+		Post(InputEventType::MouseMove, 0, 0.5f, 0.5f);
+		Input::Update();
+		Post(InputEventType::MouseMove, 0, 0.6f, 0.5f);
+		Post(InputEventType::MouseMove, 0, 0.7f, 0.4f);
+		TEST_CHECK_NEAR(Input::mouseDelta().x, 0.2f, 1e-6f);
+		TEST_CHECK_NEAR(Input::mouseDelta().y, -0.1f, 1e-6f);
+		TEST_CHECK_NEAR(Input::GetAxis(Axis::MouseX), 0.2f, 1e-6f);
+		TEST_CHECK_NEAR(Input::GetAxis(Axis::MouseY), -0.1f, 1e-6f);
+		Input::Update();
+		TEST_CHECK(Input::mouseDelta().x == 0 && Input::mouseDelta().y == 0);
+		TEST_CHECK(Input::GetAxis(Axis::MouseX) == 0);
+	}
+
+	void TestMouseDelta()
+	{
+		// raw deltas and positions (GameApp): the movement is counted once, not clamped by the window
+		Input::Init();
+		Post(InputEventType::MouseMove, 0, 0.5f, 0.5f);
+		Input::Update();
+		Post(InputEventType::MouseDelta, 0, 0.25f, 0.125f);
+		Post(InputEventType::MouseMove, 0, 0.75f, 0.625f);
+		Post(InputEventType::MouseDelta, 0, 0.5f, 0);
+		Post(InputEventType::MouseMove, 0, 1.0f, 0.625f);     // at the edge of the window
+		TEST_CHECK_NEAR(Input::mouseDelta().x, 0.75f, 1e-6f);
+		TEST_CHECK_NEAR(Input::mouseDelta().y, 0.125f, 1e-6f);
+		TEST_CHECK_NEAR(Input::GetAxis(Axis::MouseX), 0.75f, 1e-6f);
+		TEST_CHECK_NEAR(Input::GetAxis(Axis::MouseY), 0.125f, 1e-6f);
+
+		// the cursor is unlocked: a frame without deltas falls back to the positions, from the first one
+		Input::Update();
+		Post(InputEventType::MouseDelta, 0, 0.5f, 0);
+		Input::Update();
+		Post(InputEventType::MouseMove, 0, 0.5f, 0.5f);
+		TEST_CHECK(Input::mouseDelta().x == 0 && Input::mouseDelta().y == 0);
+		Post(InputEventType::MouseMove, 0, 0.25f, 0.5f);
+		TEST_CHECK_NEAR(Input::mouseDelta().x, -0.25f, 1e-6f);
+	}
+
+	void TestFirstMouseMove()
+	{
+		// the first position is not a movement from (0, 0)
+		Input::Init();
+		Post(InputEventType::MouseMove, 0, 0.8f, 0.9f);
+		TEST_CHECK(Input::mouseDelta().x == 0 && Input::mouseDelta().y == 0);
+		TEST_CHECK(Input::GetAxis(Axis::MouseX) == 0);
+		Post(InputEventType::MouseMove, 0, 0.7f, 0.9f);
+		TEST_CHECK_NEAR(Input::mouseDelta().x, -0.1f, 1e-6f);
+
+		// nor after Init
+		Input::Init();
+		Post(InputEventType::MouseMove, 0, 0.2f, 0.2f);
+		TEST_CHECK(Input::mouseDelta().x == 0 && Input::mouseDelta().y == 0);
+	}
+
+	void TestTimestampOrder()
+	{
+		Input::Init();
+		Input::PostEvent(InputEvent{ InputEventType::KeyDown, 2.0, (int)KeyCode::A, 0, 0 });
+		Input::PostEvent(InputEvent{ InputEventType::KeyDown, 1.0, (int)KeyCode::B, 0, 0 });     // late
+		Input::PostEvent(InputEvent{ InputEventType::KeyUp, 3.0, (int)KeyCode::A, 0, 0 });
+		auto const & events = Input::frameEvents();
+		TEST_CHECK(events.size() == 3);
+		for (size_t i = 1; i < events.size(); ++i)
+			TEST_CHECK(events[i - 1].timestamp <= events[i].timestamp);
+		// kept in the order it was posted in, which the state was derived from
+		TEST_CHECK(events[1].code == (int)KeyCode::B && events[1].timestamp == 2.0);
+		TEST_CHECK(Input::GetKey(KeyCode::B));
+
+		// a new frame starts a new order
+		Input::Update();
+		Input::PostEvent(InputEvent{ InputEventType::KeyUp, 0.5, (int)KeyCode::B, 0, 0 });
+		TEST_CHECK(Input::frameEvents().front().timestamp == 0.5);
+	}
+
+	void TestScroll()
+	{
+		Input::Init();
+		Post(InputEventType::Scroll, 0, 0, 1);
+		Post(InputEventType::Scroll, 0, 0, 2);
+		TEST_CHECK(Input::GetAxis(Axis::MouseScrollWheel) == 3);
+		Input::Update();
+		TEST_CHECK(Input::GetAxis(Axis::MouseScrollWheel) == 0);
+	}
+
+	struct State
+	{
+		bool keyDown, keyUp, key, buttonDown, button;
+		float deltaX, deltaY, scroll;
+
+		static State Current()
+		{
+			return State{ Input::GetKeyDown(KeyCode::W), Input::GetKeyUp(KeyCode::S), Input::GetKey(KeyCode::W),
+				Input::GetMouseButtonDown(0), Input::GetMouseButton(0),
+				Input::mouseDelta().x, Input::mouseDelta().y, Input::GetAxis(Axis::MouseScrollWheel) };
+		}
+
+		bool operator==(State const & rhs) const
+		{
+			return keyDown == rhs.keyDown && keyUp == rhs.keyUp && key == rhs.key && buttonDown == rhs.buttonDown
+				&& button == rhs.button && deltaX == rhs.deltaX && deltaY == rhs.deltaY && scroll == rhs.scroll;
+		}
+	};
+
+	void TestReplay()
+	{
+		// the frames as recorded by FrameRecorder: the events of each frame, then replayed from Init
+		Input::Init();
+		std::vector<std::vector<InputEvent>> frames;
+		std::vector<State> states;
+		auto endFrame = [&]()
+		{
+			frames.push_back(Input::frameEvents());
+			states.push_back(State::Current());
+			Input::Update();
+		};
+		Post(InputEventType::KeyDown, (int)KeyCode::S);
+		Post(InputEventType::MouseMove, 0, 0.5f, 0.5f);
+		endFrame();
+		Post(InputEventType::KeyDown, (int)KeyCode::W);
+		Post(InputEventType::KeyDown, (int)KeyCode::W);     // repeat: not recorded
+		Post(InputEventType::KeyUp, (int)KeyCode::S);
+		Post(InputEventType::MouseButtonDown, 0);
+		Post(InputEventType::MouseMove, 0, 0.55f, 0.45f);
+		endFrame();
+		Post(InputEventType::MouseDelta, 0, 0.1f, 0.2f);
+		Post(InputEventType::MouseMove, 0, 0.65f, 0.65f);
+		Post(InputEventType::Scroll, 0, 0, -1);
+		endFrame();
+		endFrame();
+		TEST_CHECK(frames[1].size() == 4);
+
+		Input::Init();
+		for (size_t i = 0; i < frames.size(); ++i)
+		{
+			for (auto const & e : frames[i])
+				Input::PostEvent(e);
+			TEST_CHECK(State::Current() == states[i]);
+			TEST_CHECK(Input::frameEvents().size() == frames[i].size());
+			Input::Update();
+		}
+	}
+}
+
+int main()
+{
+	TestKeyTransitions();
+	TestPressAndReleaseInOneFrame();
+	TestInvalidCodes();
+	TestMouseButtons();
+	TestMouseMove();
+	TestMouseDelta();
+	TestFirstMouseMove();
+	TestTimestampOrder();
+	TestScroll();
+	TestReplay();
+	return FishEngine::Test::Report("InputTest");
+}
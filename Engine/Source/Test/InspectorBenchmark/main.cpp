@@ -0,0 +1,78 @@
+// The Inspector showing a 40 component game object: the CPU used by the idle editor (the scene view drawing its
+// frames, nothing changing, which used to rebuild the inspector 10 times a second), and with a script moving the
+// object every frame (only the Transform section is redrawn).
+
+#include <InspectorWidget.hpp>
+#include <Inspector.hpp>
+#include <MainEditor.hpp>
+#include <Selection.hpp>
+
+#include <FishEngine/Animation.hpp>
+#include <FishEngine/CameraController.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <QApplication>
+#include <QTimer>
+
+#include <memory>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEngine::Test;
+
+namespace
+{
+	// CPU milliseconds per second of the event loop, run for seconds while frames are drawn at 60 Hz; each frame
+	// runs onFrame, then notifies the views as MainEditor::Run does.
+	template<typename OnFrame>
+	double FrameLoopCPU(QApplication & app, double seconds, OnFrame onFrame)
+	{
+		QTimer frames;
+		QObject::connect(&frames, &QTimer::timeout, [&onFrame]() {
+			onFrame();
+			FishEditor::MainEditor::OnFrameDrawn();
+		});
+		frames.start(16);
+		QTimer::singleShot(static_cast<int>(seconds * 1000), &app, &QApplication::quit);
+		double cpu = ProcessCPUTime();
+		app.exec();
+		frames.stop();
+		return (ProcessCPUTime() - cpu) / seconds;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+
+	// the Transform and 39 components
+	auto go = Scene::CreateGameObject("Inspected");
+	for (int i = 0; i < 39; ++i)
+	{
+		if (i % 2 == 0)
+			go->AddComponent(std::make_shared<CameraController>());
+		else
+			go->AddComponent(std::make_shared<Animation>());
+	}
+
+	InspectorWidget widget;
+	FishEditor::Inspector::SetInsectorWidget(&widget);
+	widget.resize(300, 800);
+	widget.show();
+
+	Stopwatch stopwatch;
+	FishEditor::Selection::setTransforms({ go->transform() });
+	app.processEvents();
+	PrintMeasurement("select, first draw of 40 sections", stopwatch.milliseconds(), "ms");
+
+	PrintMeasurement("idle, 40 components shown, 60 frames/s", FrameLoopCPU(app, 5, []() {}), "ms CPU/s");
+
+	auto t = go->transform();
+	PrintMeasurement("script moving the object, 60 frames/s",
+		FrameLoopCPU(app, 5, [&t]() { t->Translate(0.01f, 0, 0); }), "ms CPU/s");
+	return 0;
+}
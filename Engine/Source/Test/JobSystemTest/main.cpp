@@ -0,0 +1,155 @@
+// JobSystem::ParallelFor: the chunks cover every index once, are cut at the multiples of the grain size, and loops
+// too small to split (or issued from inside a job) run serially on the calling thread.
+
+#include <FishEngine/JobSystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	struct Chunk
+	{
+		size_t begin;
+		size_t end;
+		std::thread::id thread;
+	};
+
+	std::vector<Chunk> RunChunks(size_t count, size_t grainSize, std::vector<int> & visits)
+	{
+		std::vector<Chunk> chunks;
+		std::mutex mutex;
+		visits.assign(count, 0);
+		JobSystem::ParallelFor(count, grainSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				visits[i]++;		// the chunks do not overlap
+			std::lock_guard<std::mutex> lock(mutex);
+			chunks.push_back({ begin, end, std::this_thread::get_id() });
+		});
+		std::sort(chunks.begin(), chunks.end(), [](Chunk const & a, Chunk const & b) { return a.begin < b.begin; });
+		return chunks;
+	}
+
+	void TestCoverageAndGrain()
+	{
+		for (size_t count : { 1, 7, 8, 9, 100, 1000, 4097 })
+		{
+			for (size_t grainSize : { 1, 3, 8, 64, 5000 })
+			{
+				std::vector<int> visits;
+				auto chunks = RunChunks(count, grainSize, visits);
+				TEST_CHECK(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+
+				// [0, grain), [grain, 2 grain), ... the last one cut at count; whole if there is no worker
+				if (JobSystem::threadCount() == 1)
+					grainSize = count;
+				TEST_CHECK(chunks.size() == (count + grainSize - 1) / grainSize);
+				for (size_t i = 0; i < chunks.size(); ++i)
+				{
+					TEST_CHECK(chunks[i].begin == i * grainSize);
+					TEST_CHECK(chunks[i].end == std::min(chunks[i].begin + grainSize, count));
+				}
+			}
+		}
+	}
+
+	void TestSerialLoops()
+	{
+		int calls = 0;
+		JobSystem::ParallelFor(0, 4, [&](size_t, size_t) { calls++; });
+		TEST_CHECK(calls == 0);
+
+		// not split: one call on this thread
+		std::vector<int> visits;
+		auto chunks = RunChunks(16, 16, visits);
+		TEST_CHECK(chunks.size() == 1);
+		TEST_CHECK(chunks[0].begin == 0 && chunks[0].end == 16);
+		TEST_CHECK(chunks[0].thread == std::this_thread::get_id());
+
+		// a grain size of 0 is 1
+		chunks = RunChunks(5, 0, visits);
+		TEST_CHECK(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+		if (JobSystem::threadCount() > 1)
+			TEST_CHECK(chunks.size() == 5);
+		else
+			TEST_CHECK(chunks.size() == 1);
+	}
+
+	void TestNestedLoops()
+	{
+		// the inner loops run whole on the thread of their outer chunk
+		std::atomic<int> innerCalls{ 0 };
+		std::atomic<int> foreignThreads{ 0 };
+		std::atomic<size_t> sum{ 0 };
+		JobSystem::ParallelFor(64, 4, [&](size_t begin, size_t end)
+		{
+			auto outerThread = std::this_thread::get_id();
+			for (size_t i = begin; i < end; ++i)
+			{
+				JobSystem::ParallelFor(100, 10, [&](size_t innerBegin, size_t innerEnd)
+				{
+					innerCalls++;
+					if (std::this_thread::get_id() != outerThread)
+						foreignThreads++;
+					TEST_CHECK(innerBegin == 0 && innerEnd == 100);
+					sum += innerEnd - innerBegin;
+				});
+			}
+		});
+		TEST_CHECK(innerCalls == 64);
+		TEST_CHECK(foreignThreads == 0);
+		TEST_CHECK(sum == 6400);
+	}
+
+	void TestLoopsFromSeveralThreads()
+	{
+		// one loop at a time in the pool: each gets all of its chunks
+		std::vector<std::thread> threads;
+		std::atomic<int> failures{ 0 };
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&failures, t]()
+			{
+				for (int run = 0; run < 50; ++run)
+				{
+					size_t count = 200 + 37 * t + run;
+					std::vector<std::atomic<int>> visits(count);
+					for (auto & v : visits)
+						v = 0;
+					JobSystem::ParallelFor(count, 16, [&](size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; ++i)
+							visits[i]++;
+					});
+					for (auto & v : visits)
+					{
+						if (v != 1)
+							failures++;
+					}
+				}
+			});
+		}
+		for (auto & thread : threads)
+			thread.join();
+		TEST_CHECK(failures == 0);
+	}
+}
+
+int main()
+{
+	TEST_CHECK(JobSystem::threadCount() >= 1);
+	TestCoverageAndGrain();
+	TestSerialLoops();
+	TestNestedLoops();
+	TestLoopsFromSeveralThreads();
+	return FishEngine::Test::Report("JobSystemTest");
+}
@@ -0,0 +1,112 @@
+// The console model with 1M messages: logging them, inserting them in the batches of the console's timer, and the
+// type filter, collapse mode and search over all of them. The messages are a few hundred repeated texts (a log spammed
+// every frame) mixed with unique ones (a frame number in the text).
+
+#include <LogViewModel.hpp>
+
+#include <QGuiApplication>
+
+#include <algorithm>
+#include <string>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEngine::Test;
+
+namespace
+{
+	constexpr int Messages = 1000000;
+	constexpr int Batch = 10000;	// the messages logged between two ticks of the console's timer
+
+	LogType TypeOf(int i)
+	{
+		return i % 10 == 0 ? LogType::Error : (i % 3 == 0 ? LogType::Warning : LogType::Log);
+	}
+
+	std::string TextOf(int i)
+	{
+		if (i % 4 == 0)
+			return "Frame " + std::to_string(i) + " took too long";
+		return "Texture missing: texture" + std::to_string(i % 300) + ".png";
+	}
+
+	// reads the rows a view of 40 rows shows at the top and at the bottom
+	void ReadVisibleRows(LogViewModel const & model)
+	{
+		int rows = model.rowCount();
+		for (int row = 0; row < 40 && row < rows; ++row)
+		{
+			model.data(model.index(row, LogViewModel::MessageColumn));
+			model.data(model.index(rows - 1 - row, LogViewModel::MessageColumn));
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QGuiApplication app(argc, argv);
+
+	auto & logger = SimpleLogger::GetInstance();
+	logger.Clear();
+	LogViewModel model;
+	model.SetTypeEnabled(LogType::Log, true);
+	model.SetTypeEnabled(LogType::Warning, true);
+	model.SetTypeEnabled(LogType::Error, true);
+
+	double logMilliseconds = 0;
+	double flushMilliseconds = 0;
+	double slowestFlush = 0;
+	Stopwatch stopwatch;
+	for (int first = 0; first < Messages; first += Batch)
+	{
+		stopwatch.Restart();
+		for (int i = first; i < first + Batch; ++i)
+			logger.Log(LogData{ TypeOf(i), TextOf(i), "", 0, "" });
+		logMilliseconds += stopwatch.milliseconds();
+
+		stopwatch.Restart();
+		model.Flush();
+		ReadVisibleRows(model);
+		double flush = stopwatch.milliseconds();
+		flushMilliseconds += flush;
+		slowestFlush = std::max(slowestFlush, flush);
+	}
+	PrintMeasurement("log 1M messages", logMilliseconds, "ms");
+	PrintMeasurement("insert 1M messages, batches of 10k, total", flushMilliseconds, "ms");
+	PrintMeasurement("insert a batch of 10k, slowest", slowestFlush, "ms");
+
+	stopwatch.Restart();
+	model.SetTypeEnabled(LogType::Log, false);
+	ReadVisibleRows(model);
+	PrintMeasurement("hide the Log type, 1M messages", stopwatch.milliseconds(), "ms");
+	stopwatch.Restart();
+	model.SetTypeEnabled(LogType::Log, true);
+	ReadVisibleRows(model);
+	PrintMeasurement("show the Log type again", stopwatch.milliseconds(), "ms");
+
+	stopwatch.Restart();
+	model.SetCollapsed(true);
+	ReadVisibleRows(model);
+	PrintMeasurement("collapse identical messages", stopwatch.milliseconds(), "ms");
+	stopwatch.Restart();
+	model.SetCollapsed(false);
+	ReadVisibleRows(model);
+	PrintMeasurement("expand again", stopwatch.milliseconds(), "ms");
+
+	// typed one key at a time, as in the search field
+	std::string search = "texture12";
+	stopwatch.Restart();
+	for (size_t length = 1; length <= search.size(); ++length)
+	{
+		model.SetSearchText(QString::fromStdString(search.substr(0, length)));
+		ReadVisibleRows(model);
+	}
+	PrintMeasurement("search \"texture12\", typed, per key", stopwatch.milliseconds() / search.size(), "ms");
+	stopwatch.Restart();
+	model.SetSearchText("");
+	ReadVisibleRows(model);
+	PrintMeasurement("clear the search", stopwatch.milliseconds(), "ms");
+	return 0;
+}
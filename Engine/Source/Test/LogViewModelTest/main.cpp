@@ -0,0 +1,175 @@
+// LogViewModel, the model of the console: the rows shown for the enabled log types, in collapse mode and for a
+// search text, as messages arrive in batches. The search of 3 characters or more goes through the trigram index.
+
+#include <LogViewModel.hpp>
+
+#include <QGuiApplication>
+
+#include <string>
+#include <vector>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	void Log(LogType type, std::string const & message)
+	{
+		SimpleLogger::GetInstance().Log(LogData{ type, message, "", 0, "" });
+	}
+
+	std::vector<std::string> Rows(LogViewModel const & model)
+	{
+		std::vector<std::string> rows;
+		for (int row = 0; row < model.rowCount(); ++row)
+			rows.push_back(model.data(model.index(row, LogViewModel::MessageColumn)).toString().toStdString());
+		return rows;
+	}
+
+	int Count(LogViewModel const & model, int row)
+	{
+		return model.data(model.index(row, LogViewModel::CountColumn)).toInt();
+	}
+
+	typedef std::vector<std::string> Strings;
+
+	void TestTypeFilter(LogViewModel & model)
+	{
+		Log(LogType::Log, "Loading scene");
+		Log(LogType::Warning, "Texture missing: rock.png");
+		Log(LogType::Error, "Shader compile failed: Water");
+		Log(LogType::Log, "Loading scene");
+		Log(LogType::Assert, "Assertion failed");
+		model.Flush();
+
+		// the types of the console, in the order of the log
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Texture missing: rock.png", "Shader compile failed: Water",
+			"Loading scene" }));
+
+		model.SetTypeEnabled(LogType::Warning, false);
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Shader compile failed: Water", "Loading scene" }));
+		model.SetTypeEnabled(LogType::Log, false);
+		TEST_CHECK(Rows(model) == Strings({ "Shader compile failed: Water" }));
+
+		// enabled again: merged back in order
+		model.SetTypeEnabled(LogType::Warning, true);
+		model.SetTypeEnabled(LogType::Log, true);
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Texture missing: rock.png", "Shader compile failed: Water",
+			"Loading scene" }));
+
+		// a new batch goes at the end, only for the enabled types
+		model.SetTypeEnabled(LogType::Error, false);
+		Log(LogType::Error, "Shader compile failed: Sky");
+		Log(LogType::Warning, "Texture missing: sand.png");
+		model.Flush();
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Texture missing: rock.png", "Loading scene",
+			"Texture missing: sand.png" }));
+		model.SetTypeEnabled(LogType::Error, true);
+		TEST_CHECK(Rows(model).size() == 6);
+	}
+
+	void TestCollapse(LogViewModel & model)
+	{
+		model.SetCollapsed(true);
+		TEST_CHECK(model.collapsed());
+		// one row per distinct message, in the order of their first occurrence
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Texture missing: rock.png", "Shader compile failed: Water",
+			"Shader compile failed: Sky", "Texture missing: sand.png" }));
+		TEST_CHECK(Count(model, 0) == 2);
+		TEST_CHECK(Count(model, 1) == 1);
+
+		// the same text with another type is another message
+		Log(LogType::Log, "Texture missing: rock.png");
+		Log(LogType::Log, "Loading scene");
+		model.Flush();
+		TEST_CHECK(Rows(model).size() == 6);
+		TEST_CHECK(Count(model, 0) == 3);
+		TEST_CHECK(Count(model, 1) == 1);
+		TEST_CHECK(Count(model, 5) == 1);
+
+		model.SetCollapsed(false);
+		TEST_CHECK(Rows(model).size() == 8);
+		// no count out of collapse mode
+		TEST_CHECK(!model.data(model.index(0, LogViewModel::CountColumn)).isValid());
+	}
+
+	void TestSearch(LogViewModel & model)
+	{
+		// case insensitive, through the trigram index
+		model.SetSearchText("TEXTURE missing");
+		TEST_CHECK(Rows(model) == Strings({ "Texture missing: rock.png", "Texture missing: sand.png",
+			"Texture missing: rock.png" }));
+
+		// shorter than a trigram
+		model.SetSearchText("sk");
+		TEST_CHECK(Rows(model) == Strings({ "Shader compile failed: Sky" }));
+
+		// a trigram found in no message
+		model.SetSearchText("xyz");
+		TEST_CHECK(Rows(model).empty());
+
+		// every trigram of the search text is in the message, but not the text
+		Log(LogType::Log, "abc bcd cde");
+		model.Flush();
+		model.SetSearchText("abcde");
+		TEST_CHECK(Rows(model).empty());
+		model.SetSearchText("bcd c");
+		TEST_CHECK(Rows(model) == Strings({ "abc bcd cde" }));
+
+		// new messages are indexed as they arrive
+		model.SetSearchText("scene");
+		TEST_CHECK(Rows(model).size() == 3);
+		Log(LogType::Warning, "Scene not saved");
+		Log(LogType::Log, "Frame time");
+		model.Flush();
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Loading scene", "Loading scene", "Scene not saved" }));
+
+		// with the type filter and collapse mode
+		model.SetTypeEnabled(LogType::Log, false);
+		TEST_CHECK(Rows(model) == Strings({ "Scene not saved" }));
+		model.SetTypeEnabled(LogType::Log, true);
+		model.SetCollapsed(true);
+		TEST_CHECK(Rows(model) == Strings({ "Loading scene", "Scene not saved" }));
+		TEST_CHECK(Count(model, 0) == 3);
+		model.SetCollapsed(false);
+
+		model.SetSearchText("");
+		TEST_CHECK(Rows(model).size() == 11);
+	}
+
+	void TestClear(LogViewModel & model)
+	{
+		model.Clear();
+		TEST_CHECK(model.rowCount() == 0);
+		TEST_CHECK(SimpleLogger::GetInstance().size() == 0);
+
+		// the entries after Clear start again from the first one
+		Log(LogType::Log, "After clear");
+		model.Flush();
+		TEST_CHECK(Rows(model) == Strings({ "After clear" }));
+		model.SetSearchText("clear");
+		TEST_CHECK(Rows(model).size() == 1);
+		model.SetSearchText("scene");
+		TEST_CHECK(Rows(model).empty());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// QIcon of data(); no window is shown
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QGuiApplication app(argc, argv);
+
+	SimpleLogger::GetInstance().Clear();
+	LogViewModel model;
+	model.SetTypeEnabled(LogType::Log, true);
+	model.SetTypeEnabled(LogType::Warning, true);
+	model.SetTypeEnabled(LogType::Error, true);
+
+	TestTypeFilter(model);
+	TestCollapse(model);
+	TestSearch(model);
+	TestClear(model);
+	return FishEngine::Test::Report("LogViewModelTest");
+}
@@ -0,0 +1,102 @@
+// The throughput of MeshLODGenerator on the models of the Example projects: the meshes of each model simplified to
+// 1/2, 1/4 and 1/8 of their triangles on the JobSystem, without the Library cache. The models are not in the
+// repository: the ones missing from the Example projects are skipped, other .fbx files can be given as arguments.
+
+#include <FBXImporter.hpp>
+#include <MeshLODGenerator.hpp>
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/JobSystem.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/Prefab.hpp>
+#include <FishEngine/SkinnedMeshRenderer.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+using namespace FishEngine::Test;
+
+namespace
+{
+	// The meshes of the model, each once.
+	std::vector<MeshPtr> LoadMeshes(Path const & path)
+	{
+		// no lodTargetRatios: Load does not simplify them
+		FBXImporter importer;
+		auto root = importer.Load(path)->rootGameObject();
+		std::set<MeshPtr> meshes;
+		for (auto const & filter : root->GetComponentsInChildren<MeshFilter>(true))
+			meshes.insert(filter->mesh());
+		for (auto const & renderer : root->GetComponentsInChildren<SkinnedMeshRenderer>(true))
+			meshes.insert(renderer->sharedMesh());
+		meshes.erase(nullptr);
+		return std::vector<MeshPtr>(meshes.begin(), meshes.end());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<Path> models;
+	for (int i = 1; i < argc; ++i)
+		models.push_back(argv[i]);
+	if (models.empty())
+	{
+		const Path example = FISHENGINE_EXAMPLE_DIR;
+		models = {
+			example / "Sponza/Assets/sponza.fbx",
+			example / "UnityChan/Assets/unitychan.fbx",
+			example / "UnityChan-crs/Assets/UnityChan/CandyRockStar/CandyRockStar.fbx",
+			example / "UnityChan-crs/Assets/UnityChanStage/Models/stage.fbx",
+		};
+	}
+	std::printf("%d threads\n", JobSystem::threadCount());
+
+	// not imported from a file of the project (no asset path): nothing is read from or written to the cache
+	FBXImporter generator;
+	generator.setLodTargetRatios({ 0.5f, 0.25f, 0.125f });
+
+	double totalTriangles = 0;
+	double totalSeconds = 0;
+	for (auto const & path : models)
+	{
+		auto name = path.filename().string();
+		if (!boost::filesystem::exists(path))
+		{
+			std::printf("%s: not found, skipped\n", path.string().c_str());
+			continue;
+		}
+		auto meshes = LoadMeshes(path);
+		double triangles = 0;
+		for (auto const & mesh : meshes)
+			triangles += mesh->triangles().size() / 3;
+
+		Stopwatch stopwatch;
+		MeshLODGenerator::Generate(generator, meshes);
+		double seconds = stopwatch.milliseconds() / 1000;
+		totalTriangles += triangles;
+		totalSeconds += seconds;
+
+		double lodTriangles = 0;
+		for (auto const & mesh : meshes)
+		{
+			for (int level = 1; level < mesh->lodCount(); ++level)
+				lodTriangles += mesh->lod(level)->triangles().size() / 3;
+		}
+		PrintMeasurement((name + ", meshes").c_str(), static_cast<double>(meshes.size()), "");
+		PrintMeasurement((name + ", source triangles").c_str(), triangles, "");
+		PrintMeasurement((name + ", LOD triangles").c_str(), lodTriangles, "");
+		PrintMeasurement((name + ", generation").c_str(), seconds * 1000, "ms");
+		PrintMeasurement((name + ", throughput").c_str(), triangles / seconds / 1000, "k source triangles/s");
+	}
+	if (totalSeconds > 0)
+		PrintMeasurement("all models, throughput", totalTriangles / totalSeconds / 1000, "k source triangles/s");
+	return 0;
+}
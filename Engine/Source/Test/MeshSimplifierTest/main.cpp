@@ -0,0 +1,356 @@
+// MeshSimplifier, the LODs generated at model import: the triangle budget, the geometric error, and what the
+// collapses must keep (uv seams, the boundaries between submeshes, open borders, bone weights, orientation).
+
+#include <FishEngine/Mathf.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshSimplifier.hpp>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	// unit sphere without its polar caps (open borders), the last column duplicates the first one: a uv seam
+	MeshGeometry Sphere(int segments, int rings)
+	{
+		MeshGeometry g;
+		for (int r = 0; r <= rings; ++r)
+		{
+			for (int s = 0; s <= segments; ++s)
+			{
+				float theta = Mathf::PI * (0.1f + 0.8f * r / rings);
+				float phi = 2 * Mathf::PI * (s % segments) / segments;
+				Vector3 p(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+				g.vertices.push_back(p);
+				g.normals.push_back(p);
+				g.uv.push_back(Vector2(float(s) / segments, float(r) / rings));
+				g.tangents.push_back(Vector3(1, 0, 0));
+			}
+		}
+		for (int r = 0; r < rings; ++r)
+		{
+			for (int s = 0; s < segments; ++s)
+			{
+				uint32_t a = r * (segments + 1) + s, b = a + 1, c = a + segments + 1, d = c + 1;
+				g.triangles.insert(g.triangles.end(), { a, c, b, b, c, d });
+			}
+		}
+		g.subMeshIndexOffset = { 0 };
+		return g;
+	}
+
+	// gently curved square in the xz plane, facing +y, open borders; one submesh per half (x < 0.5, x > 0.5)
+	MeshGeometry Grid(int n)
+	{
+		MeshGeometry g;
+		for (int y = 0; y <= n; ++y)
+		{
+			for (int x = 0; x <= n; ++x)
+			{
+				g.vertices.push_back(Vector3(float(x) / n, 0.05f * std::sin(x * 0.3f) * std::cos(y * 0.2f), float(y) / n));
+				g.normals.push_back(Vector3(0, 1, 0));
+				g.uv.push_back(Vector2(float(x) / n, float(y) / n));
+				g.tangents.push_back(Vector3(1, 0, 0));
+			}
+		}
+		std::vector<uint32_t> left, right;
+		for (int y = 0; y < n; ++y)
+		{
+			for (int x = 0; x < n; ++x)
+			{
+				uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+				auto & t = x < n / 2 ? left : right;
+				t.insert(t.end(), { a, c, b, b, c, d });
+			}
+		}
+		g.triangles = left;
+		g.triangles.insert(g.triangles.end(), right.begin(), right.end());
+		g.subMeshIndexOffset = { 0, static_cast<uint32_t>(left.size()) };
+		return g;
+	}
+
+	Vector3 Corner(MeshGeometry const & g, uint32_t triangle, int k)
+	{
+		return g.vertices[g.triangles[triangle * 3 + k]];
+	}
+
+	Vector3 FaceNormal(MeshGeometry const & g, uint32_t t)
+	{
+		return Vector3::Cross(Corner(g, t, 1) - Corner(g, t, 0), Corner(g, t, 2) - Corner(g, t, 0));
+	}
+
+	// the edges used by a single triangle, vertices matched by position: the seams are not open, cracks are
+	template<class IsBorder>
+	uint32_t OpenEdgesOffBorder(MeshGeometry const & g, IsBorder isBorder)
+	{
+		std::map<std::tuple<float, float, float>, uint32_t> points;
+		std::map<std::pair<uint32_t, uint32_t>, int> edges;
+		auto point = [&points](Vector3 const & p) {
+			return points.emplace(std::make_tuple(p.x, p.y, p.z), static_cast<uint32_t>(points.size())).first->second;
+		};
+		for (uint32_t t = 0; t < g.triangleCount(); ++t)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				uint32_t a = point(Corner(g, t, k)), b = point(Corner(g, t, (k + 1) % 3));
+				edges[std::make_pair(std::min(a, b), std::max(a, b))]++;
+			}
+		}
+		std::vector<Vector3> positions(points.size());
+		for (auto const & p : points)
+			positions[p.second] = Vector3(std::get<0>(p.first), std::get<1>(p.first), std::get<2>(p.first));
+		uint32_t count = 0;
+		for (auto const & e : edges)
+		{
+			if (e.second == 1 && !(isBorder(positions[e.first.first]) && isBorder(positions[e.first.second])))
+				count++;
+		}
+		return count;
+	}
+
+	void TestSphere()
+	{
+		auto sphere = Sphere(64, 32);
+		auto previous = sphere;
+		float previousError = 0;
+		// a LOD chain, each level from the previous one
+		for (uint32_t divisor : { 2u, 4u, 8u, 16u })
+		{
+			const uint32_t target = sphere.triangleCount() / divisor;
+			auto lod = MeshSimplifier::Simplify(previous, target);
+			TEST_CHECK(lod.triangleCount() <= target);
+			TEST_CHECK(lod.triangleCount() >= target * 9 / 10);
+			TEST_CHECK(lod.vertices.size() == lod.normals.size() && lod.vertices.size() == lod.uv.size());
+			TEST_CHECK(lod.vertices.size() < previous.vertices.size());
+			TEST_CHECK(lod.subMeshIndexOffset == std::vector<uint32_t>{ 0 });
+
+			// closer than the radius, and worse at each level
+			float error = MeshSimplifier::GeometricError(sphere, lod);
+			TEST_CHECK(error > previousError);
+			TEST_CHECK(error < 0.1f);
+			previousError = error;
+
+			uint32_t flipped = 0;
+			for (uint32_t t = 0; t < lod.triangleCount(); ++t)
+			{
+				// the winding of the source: every face normal points toward the center
+				auto center = (Corner(lod, t, 0) + Corner(lod, t, 1) + Corner(lod, t, 2)) / 3;
+				if (Vector3::Dot(FaceNormal(lod, t), center) > 0)
+					flipped++;
+			}
+			TEST_CHECK(flipped == 0);
+			previous = lod;
+		}
+
+		// the seam, down to as few triangles as the constraints allow
+		const float borderY = std::cos(0.1f * Mathf::PI);
+		const float uvWinding = -1;	// the sign of the uv area of the triangles of Sphere
+		for (uint32_t target : { sphere.triangleCount() / 4, 64u, 0u })
+		{
+			auto lod = MeshSimplifier::Simplify(sphere, target);
+			// a triangle across the seam would be mirrored in the texture, and stretched over all of it
+			uint32_t seamCrossing = 0;
+			for (uint32_t t = 0; t < lod.triangleCount(); ++t)
+			{
+				auto a = lod.uv[lod.triangles[t * 3]], b = lod.uv[lod.triangles[t * 3 + 1]], c = lod.uv[lod.triangles[t * 3 + 2]];
+				if (((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) * uvWinding < 0)
+					seamCrossing++;
+			}
+			TEST_CHECK(seamCrossing == 0);
+			// the wedges on both sides of the seam moved together: no crack
+			TEST_CHECK(OpenEdgesOffBorder(lod, [borderY](Vector3 const & p) { return Mathf::Abs(Mathf::Abs(p.y) - borderY) < 1e-5f; }) == 0);
+			// a tube: at least a prism
+			TEST_CHECK(lod.triangleCount() >= 6);
+		}
+
+		// already under the budget: unchanged
+		auto same = MeshSimplifier::Simplify(sphere, sphere.triangleCount());
+		TEST_CHECK(same.triangleCount() == sphere.triangleCount());
+		TEST_CHECK(MeshSimplifier::GeometricError(sphere, same) < 1e-5f);
+	}
+
+	void TestSubMeshesAndBorders()
+	{
+		auto grid = Grid(64);
+		auto lod = MeshSimplifier::Simplify(grid, grid.triangleCount() / 16);
+		TEST_CHECK(lod.triangleCount() <= grid.triangleCount() / 16);
+		TEST_CHECK(MeshSimplifier::GeometricError(grid, lod) < 0.02f);
+		Vector3 bmin(2, 2, 2), bmax(-2, -2, -2);
+		uint32_t flipped = 0;
+		for (uint32_t t = 0; t < lod.triangleCount(); ++t)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				bmin = Vector3::Min(bmin, Corner(lod, t, k));
+				bmax = Vector3::Max(bmax, Corner(lod, t, k));
+			}
+			if (FaceNormal(lod, t).y <= 0)
+				flipped++;
+		}
+		TEST_CHECK(flipped == 0);
+		// the corners are kept, the borders do not shrink
+		TEST_CHECK(bmin.x == 0 && bmin.z == 0 && bmax.x == 1 && bmax.z == 1);
+
+		// far enough for the constraints to matter: the cheap collapses are gone
+		for (uint32_t target : { grid.triangleCount() / 16, 32u, 8u })
+		{
+			lod = MeshSimplifier::Simplify(grid, target);
+			TEST_CHECK(lod.subMeshIndexOffset.size() == 2);
+			if (lod.subMeshIndexOffset.size() != 2)
+				return;
+			// each submesh stays on its side of the boundary
+			uint32_t split = lod.subMeshIndexOffset[1] / 3;
+			TEST_CHECK(split > 0 && split < lod.triangleCount());
+			uint32_t crossing = 0;
+			for (uint32_t t = 0; t < lod.triangleCount(); ++t)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					auto x = Corner(lod, t, k).x;
+					if (t < split ? x > 0.5f : x < 0.5f)
+						crossing++;
+				}
+			}
+			TEST_CHECK(crossing == 0);
+			// no crack between the submeshes, the borders only move along themselves
+			TEST_CHECK(OpenEdgesOffBorder(lod, [](Vector3 const & p) { return p.x == 0 || p.x == 1 || p.z == 0 || p.z == 1; }) == 0);
+		}
+	}
+
+	// flat fan around a center vertex, facing +y: collapsing the center is free, the rim is an open border
+	MeshGeometry Fan(int n, BoneWeight const & center, BoneWeight const & rim)
+	{
+		MeshGeometry g;
+		g.vertices.push_back(Vector3(0, 0, 0));
+		g.boneWeights.push_back(center);
+		for (int i = 0; i < n; ++i)
+		{
+			float angle = 2 * Mathf::PI * i / n;
+			g.vertices.push_back(Vector3(std::cos(angle), 0, std::sin(angle)));
+			g.boneWeights.push_back(rim);
+		}
+		for (int i = 0; i < n; ++i)
+			g.triangles.insert(g.triangles.end(), { 0u, static_cast<uint32_t>((i + 1) % n + 1), static_cast<uint32_t>(i + 1) });
+		g.subMeshIndexOffset = { 0 };
+		return g;
+	}
+
+	// the center of Fan
+	bool HasCenter(MeshGeometry const & g)
+	{
+		for (auto const & p : g.vertices)
+		{
+			if (p == Vector3(0, 0, 0))
+				return true;
+		}
+		return false;
+	}
+
+	void TestErrorBothWays()
+	{
+		// a flap folded up from the grid: every vertex of the grid is on the folded surface, but the flap is not
+		// on the grid
+		auto grid = Grid(16);
+		auto folded = grid;
+		uint32_t tip = static_cast<uint32_t>(folded.vertices.size());
+		folded.vertices.push_back(Vector3(0.5f, 0.5f, 0.5f));
+		folded.triangles.insert(folded.triangles.end(), { 0, 1, tip });
+		float error = MeshSimplifier::GeometricError(grid, folded);
+		TEST_CHECK(error > 0.4f);
+		TEST_CHECK_NEAR(error, MeshSimplifier::GeometricError(folded, grid), 1e-5f);
+	}
+
+	void TestBoneWeights()
+	{
+		BoneWeight bone0, bone1, mostlyBone0;
+		bone0.AddBoneData(0, 1.0f);
+		bone1.AddBoneData(1, 1.0f);
+		mostlyBone0.AddBoneData(0, 0.8f);
+		mostlyBone0.AddBoneData(1, 0.2f);
+
+		// one triangle less: the center would go first, but it is on another bone
+		auto lod = MeshSimplifier::Simplify(Fan(8, bone1, bone0), 7);
+		TEST_CHECK(lod.boneWeights.size() == lod.vertices.size());
+		TEST_CHECK(lod.triangleCount() <= 7);
+		TEST_CHECK(HasCenter(lod));
+
+		// similar enough weights (0.4 apart): it goes
+		lod = MeshSimplifier::Simplify(Fan(8, mostlyBone0, bone0), 7);
+		TEST_CHECK(lod.triangleCount() == 6);
+		TEST_CHECK(!HasCenter(lod));
+		for (auto const & w : lod.boneWeights)
+			TEST_CHECK(w.boneIndex[0] == 0 && w.weight[0] == 1.0f);
+	}
+
+	void TestSeamThroughVertex()
+	{
+		// every rim vertex on another bone than its neighbors (no collapse along the rim), the center on the bone of
+		// the rim at pi/2 and 3pi/2
+		BoneWeight bones[3];
+		for (int b = 0; b < 3; ++b)
+			bones[b].AddBoneData(b, 1.0f);
+		auto fan = Fan(8, bones[0], bones[2]);
+		fan.boneWeights[1] = fan.boneWeights[5] = bones[1];
+		fan.boneWeights[3] = fan.boneWeights[7] = bones[0];
+
+		// a uv seam from the rim at angle 0 to the rim at angle pi, through the center: split in two wedges
+		fan.uv.assign(fan.vertices.size(), Vector2(0, 0));
+		const uint32_t seam[] = { 0, 1, 5 };
+		for (uint32_t t = 4; t < 8; ++t)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				auto & corner = fan.triangles[t * 3 + k];
+				if (std::find(std::begin(seam), std::end(seam), corner) == std::end(seam))
+					continue;
+				fan.vertices.push_back(fan.vertices[corner]);
+				fan.boneWeights.push_back(fan.boneWeights[corner]);
+				fan.uv.push_back(Vector2(1, 0));
+				corner = static_cast<uint32_t>(fan.vertices.size() - 1);
+			}
+		}
+
+		// the center could only collapse across the seam, free on this flat fan: it stays
+		auto lod = MeshSimplifier::Simplify(fan, 7);
+		TEST_CHECK(lod.triangleCount() == 8);
+		TEST_CHECK(OpenEdgesOffBorder(lod, [](Vector3 const & p) { return Mathf::Abs(p.magnitude() - 1) < 1e-5f; }) == 0);
+	}
+
+	void TestMeshRoundTrip()
+	{
+		auto grid = Grid(8);
+		std::vector<Vector3> vertices = grid.vertices, normals = grid.normals, tangents = grid.tangents;
+		std::vector<Vector2> uv = grid.uv;
+		std::vector<uint32_t> triangles = grid.triangles;
+		Mesh source(std::move(vertices), std::move(normals), std::move(uv), std::move(tangents), std::move(triangles));
+
+		// one submesh
+		auto g = MeshGeometry::FromMesh(source);
+		TEST_CHECK(g.vertices.size() == grid.vertices.size());
+		TEST_CHECK(g.triangles == grid.triangles);
+		TEST_CHECK(g.subMeshIndexOffset == std::vector<uint32_t>{ 0 });
+		TEST_CHECK(g.boneWeights.empty());
+
+		// two submeshes
+		auto mesh = grid.ToMesh(source);
+		TEST_CHECK(mesh->subMeshCount() == 2);
+		TEST_CHECK(mesh->triangles() == grid.triangles);
+		TEST_CHECK(MeshGeometry::FromMesh(*mesh).subMeshIndexOffset == grid.subMeshIndexOffset);
+	}
+}
+
+int main()
+{
+	TestSphere();
+	TestSubMeshesAndBorders();
+	TestErrorBothWays();
+	TestBoneWeights();
+	TestSeamThroughVertex();
+	TestMeshRoundTrip();
+	return FishEngine::Test::Report("MeshSimplifierTest");
+}
@@ -0,0 +1,376 @@
+// MeshletUtility: the clusters cover the index buffer of each submesh, within the limits, and the culling is
+// conservative: a culled meshlet is outside one plane of the frustum, or all its triangles face away from the camera.
+
+#include <FishEngine/Camera.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/GeometryUtility.hpp>
+#include <FishEngine/Mathf.hpp>
+#include <FishEngine/MeshletUtility.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	struct Geometry
+	{
+		std::vector<Vector3>	vertices;
+		std::vector<Vector3>	normals;
+		std::vector<uint32_t>	triangles;
+	};
+
+	void AddSphere(Geometry & g, Vector3 const & center, float radius, int segments, int rings)
+	{
+		uint32_t base = static_cast<uint32_t>(g.vertices.size());
+		for (int r = 0; r <= rings; ++r)
+		{
+			for (int s = 0; s <= segments; ++s)
+			{
+				float theta = Mathf::PI * r / rings, phi = 2 * Mathf::PI * (s % segments) / segments;
+				Vector3 n(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+				g.vertices.push_back(center + n * radius);
+				g.normals.push_back(n);
+			}
+		}
+		for (int r = 0; r < rings; ++r)
+		{
+			for (int s = 0; s < segments; ++s)
+			{
+				uint32_t a = base + r * (segments + 1) + s, b = a + 1, c = a + segments + 1, d = c + 1;
+				g.triangles.insert(g.triangles.end(), { a, c, b, b, c, d });
+			}
+		}
+	}
+
+	// six n x n grids
+	void AddBox(Geometry & g, Vector3 const & center, Vector3 const & half, int n)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			for (int sign = -1; sign <= 1; sign += 2)
+			{
+				uint32_t base = static_cast<uint32_t>(g.vertices.size());
+				int u = (axis + 1) % 3, w = (axis + 2) % 3;
+				for (int j = 0; j <= n; ++j)
+				{
+					for (int i = 0; i <= n; ++i)
+					{
+						Vector3 p, normal;
+						p[axis] = static_cast<float>(sign);
+						p[u] = -1 + 2.0f * i / n;
+						p[w] = -1 + 2.0f * j / n;
+						normal[axis] = static_cast<float>(sign);
+						g.vertices.push_back(center + Vector3(p.x * half.x, p.y * half.y, p.z * half.z));
+						g.normals.push_back(normal);
+					}
+				}
+				for (int j = 0; j < n; ++j)
+				{
+					for (int i = 0; i < n; ++i)
+					{
+						uint32_t a = base + j * (n + 1) + i, b = a + 1, c = a + n + 1, d = c + 1;
+						g.triangles.insert(g.triangles.end(), { a, b, c, b, d, c });
+					}
+				}
+			}
+		}
+	}
+
+	// front faces: cross(p1 - p0, p2 - p0) along the normals
+	void Orient(Geometry & g)
+	{
+		auto & t = g.triangles;
+		for (size_t i = 0; i < t.size(); i += 3)
+		{
+			auto face = Vector3::Cross(g.vertices[t[i + 1]] - g.vertices[t[i]], g.vertices[t[i + 2]] - g.vertices[t[i]]);
+			if (Vector3::Dot(face, g.normals[t[i]] + g.normals[t[i + 1]] + g.normals[t[i + 2]]) < 0)
+				std::swap(t[i + 1], t[i + 2]);
+		}
+	}
+
+	typedef std::multiset<std::array<uint32_t, 3>> TriangleSet;
+
+	// the triangles of [begin, end), whatever their order and first corner
+	TriangleSet Triangles(std::vector<uint32_t> const & t, uint32_t begin, uint32_t end)
+	{
+		TriangleSet set;
+		for (uint32_t i = begin; i < end; i += 3)
+		{
+			std::array<uint32_t, 3> a = { t[i], t[i + 1], t[i + 2] };
+			std::rotate(a.begin(), std::min_element(a.begin(), a.end()), a.end());
+			set.insert(a);
+		}
+		return set;
+	}
+
+	// a street: boxes (first submesh) and spheres (second submesh)
+	Geometry Street(uint32_t & split)
+	{
+		Geometry g;
+		for (int i = 0; i < 4; ++i)
+			AddBox(g, Vector3(i * 12.0f, 5, 0), Vector3(4, 5.0f + i % 3, 4), 24);
+		split = static_cast<uint32_t>(g.triangles.size());
+		for (int i = 0; i < 4; ++i)
+			AddSphere(g, Vector3(i * 12.0f, 2, 10), 2, 64, 32);
+		Orient(g);
+		return g;
+	}
+
+	void TestBuild()
+	{
+		uint32_t split;
+		auto g = Street(split);
+		const auto original = g.triangles;
+		const uint32_t total = static_cast<uint32_t>(g.triangles.size());
+
+		std::vector<Meshlet> meshlets;
+		MeshletUtility::Build(g.vertices, g.triangles, { 0, split }, meshlets);
+		const size_t firstSphere = meshlets.size();
+		MeshletUtility::Build(g.vertices, g.triangles, { split, total - split }, meshlets);
+		TEST_CHECK(firstSphere > 0 && meshlets.size() > firstSphere);
+
+		uint32_t next = 0, triangles = 0, vertices = 0;
+		bool contiguous = true, limits = true, bounded = true, insideSubMesh = true;
+		for (size_t i = 0; i < meshlets.size(); ++i)
+		{
+			auto const & m = meshlets[i];
+			contiguous = contiguous && m.indices.start == next;
+			next = m.indices.start + m.indices.count;
+			std::set<uint32_t> used(g.triangles.begin() + m.indices.start, g.triangles.begin() + next);
+			limits = limits && m.indices.count > 0 && m.indices.count % 3 == 0 && m.indices.count / 3 <= MeshletUtility::MaxTriangles
+				&& used.size() == m.vertexCount && used.size() <= MeshletUtility::MaxVertices;
+			for (auto v : used)
+				bounded = bounded && (g.vertices[v] - m.center).magnitude() <= m.radius * 1.0001f + 1e-6f;
+			insideSubMesh = insideSubMesh && (i < firstSphere ? next <= split : m.indices.start >= split);
+			triangles += m.indices.count / 3;
+			vertices += m.vertexCount;
+		}
+		TEST_CHECK(contiguous && next == total);
+		TEST_CHECK(limits);
+		TEST_CHECK(bounded);
+		TEST_CHECK(insideSubMesh);
+		// the same triangles in each submesh, sorted by meshlet
+		TEST_CHECK(Triangles(g.triangles, 0, split) == Triangles(original, 0, split));
+		TEST_CHECK(Triangles(g.triangles, split, total) == Triangles(original, split, total));
+		TEST_CHECK(g.triangles != original);
+		// the clusters are compact: well filled, and most vertices shared by several triangles
+		TEST_CHECK(triangles > 60 * meshlets.size());
+		TEST_CHECK(vertices < triangles);
+	}
+
+	// every culled meshlet has all its vertices outside one plane, or all its triangles facing away
+	void TestCullingIsConservative()
+	{
+		uint32_t split;
+		auto g = Street(split);
+		std::vector<Meshlet> meshlets;
+		MeshletUtility::Build(g.vertices, g.triangles, { 0, split }, meshlets);
+		MeshletUtility::Build(g.vertices, g.triangles, { split, static_cast<uint32_t>(g.triangles.size()) - split }, meshlets);
+		const auto projection = Matrix4x4::Perspective(60, 16.0f / 9, 0.3f, 200);
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> uniform(-1, 1);
+		uint32_t wrongFrustum = 0, wrongCone = 0, wrongRanges = 0;
+		uint64_t submitted = 0, frustumCulled = 0, coneCulled = 0;
+		for (int i = 0; i < 50; ++i)
+		{
+			Vector3 eye(uniform(random) * 30 + 18, uniform(random) * 8 + 8, uniform(random) * 20 + 5);
+			Vector3 target(uniform(random) * 25 + 18, 4, 5);
+			MeshletUtility::View view;
+			GeometryUtility::CalculateFrustumPlanes(projection * Matrix4x4::LookAt(eye, target, Vector3::up), view.planes);
+			view.eye = eye;
+			view.coneCulling = true;
+
+			std::vector<IndexRange> visible;
+			uint32_t count = MeshletUtility::Cull(meshlets.data(), meshlets.data() + meshlets.size(), view, visible);
+			submitted += count;
+
+			// the ranges: sorted, merged, as many triangles as returned
+			uint32_t inRanges = 0;
+			for (size_t r = 0; r < visible.size(); ++r)
+			{
+				inRanges += visible[r].count / 3;
+				if (r > 0 && visible[r - 1].start + visible[r - 1].count >= visible[r].start)
+					wrongRanges++;
+			}
+			if (inRanges != count)
+				wrongRanges++;
+
+			for (auto const & m : meshlets)
+			{
+				if (!GeometryUtility::TestPlanesSphere(view.planes, m.center, m.radius))
+				{
+					frustumCulled += m.indices.count / 3;
+					bool outside = false;
+					for (int p = 0; p < 6 && !outside; ++p)
+					{
+						outside = true;
+						for (uint32_t k = m.indices.start; k < m.indices.start + m.indices.count && outside; ++k)
+						{
+							auto const & q = g.vertices[g.triangles[k]];
+							outside = view.planes[p].x * q.x + view.planes[p].y * q.y + view.planes[p].z * q.z + view.planes[p].w < 0;
+						}
+					}
+					if (!outside)
+						wrongFrustum++;
+				}
+				else if (MeshletUtility::IsBackfacing(m, view))
+				{
+					coneCulled += m.indices.count / 3;
+					for (uint32_t k = m.indices.start; k < m.indices.start + m.indices.count; k += 3)
+					{
+						auto const & p0 = g.vertices[g.triangles[k]];
+						auto face = Vector3::Cross(g.vertices[g.triangles[k + 1]] - p0, g.vertices[g.triangles[k + 2]] - p0);
+						if (Vector3::Dot(face, p0 - eye) < -1e-5f * face.magnitude())
+							wrongCone++;
+					}
+				}
+			}
+		}
+		TEST_CHECK(wrongFrustum == 0);
+		TEST_CHECK(wrongCone == 0);
+		TEST_CHECK(wrongRanges == 0);
+		// and useful: both tests cull a good part of the street
+		const uint64_t all = uint64_t(g.triangles.size() / 3) * 50;
+		TEST_CHECK(frustumCulled > all / 10);
+		TEST_CHECK(coneCulled > all / 5);
+		TEST_CHECK(submitted + frustumCulled + coneCulled == all);
+	}
+
+	void TestCones()
+	{
+		// the -x face of a box: a flat patch of 32 triangles
+		Geometry g;
+		AddBox(g, Vector3(0, 0, 0), Vector3(1, 1, 1), 4);
+		g.triangles.resize(32 * 3);
+		Orient(g);
+		std::vector<Meshlet> meshlets;
+		MeshletUtility::Build(g.vertices, g.triangles, { 0, 32 * 3 }, meshlets);
+		TEST_CHECK(meshlets.size() == 1);
+		if (meshlets.size() != 1)
+			return;
+		auto const & m = meshlets[0];
+		TEST_CHECK(m.coneAxis == Vector3(-1, 0, 0));
+		TEST_CHECK(m.coneCutoff < 1);
+
+		MeshletUtility::View view;
+		view.coneCulling = true;
+		view.eye = Vector3(-5, 0, 0);		// in front
+		TEST_CHECK(!MeshletUtility::IsBackfacing(m, view));
+		view.eye = Vector3(5, 0, 0);		// behind
+		TEST_CHECK(MeshletUtility::IsBackfacing(m, view));
+		view.eye = Vector3(-0.5f, 0, 10);	// behind at a grazing angle: kept, the test is conservative
+		TEST_CHECK(!MeshletUtility::IsBackfacing(m, view));
+		view.coneCulling = false;			// two sided material
+		view.eye = Vector3(5, 0, 0);
+		TEST_CHECK(!MeshletUtility::IsBackfacing(m, view));
+
+		view.coneCulling = true;
+		view.orthographic = true;
+		view.direction = Vector3(-1, 0, 0);
+		TEST_CHECK(MeshletUtility::IsBackfacing(m, view));
+		view.direction = Vector3(1, 0, 0);
+		TEST_CHECK(!MeshletUtility::IsBackfacing(m, view));
+
+		// a whole sphere in one meshlet: no cone
+		Geometry sphere;
+		AddSphere(sphere, Vector3(0, 0, 0), 1, 8, 4);
+		Orient(sphere);
+		meshlets.clear();
+		MeshletUtility::Build(sphere.vertices, sphere.triangles, { 0, static_cast<uint32_t>(sphere.triangles.size()) }, meshlets);
+		TEST_CHECK(meshlets.size() == 1 && meshlets[0].coneCutoff >= 1);
+		TEST_CHECK(!MeshletUtility::IsBackfacing(meshlets[0], view));
+	}
+
+	void TestMesh()
+	{
+		uint32_t split;
+		auto g = Street(split);
+		auto make = [&g](bool flipNormals) {
+			auto vertices = g.vertices;
+			auto normals = g.normals;
+			if (flipNormals)
+			{
+				for (auto & n : normals)
+					n = -n;
+			}
+			std::vector<Vector2> uv(vertices.size());
+			std::vector<Vector3> tangents(vertices.size(), Vector3(1, 0, 0));
+			auto triangles = g.triangles;
+			return std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::move(uv), std::move(tangents), std::move(triangles));
+		};
+
+		auto mesh = make(false);
+		TEST_CHECK(MeshletUtility::Build(*mesh));
+		TEST_CHECK(!mesh->meshlets().empty());
+		TEST_CHECK(mesh->meshletStart(0) == 0);
+		TEST_CHECK(mesh->meshletStart(1) == mesh->meshlets().size());
+
+		// the normals point the other way: so do the front faces, and the cones
+		auto flipped = make(true);
+		TEST_CHECK(MeshletUtility::Build(*flipped));
+		TEST_CHECK(flipped->meshlets().size() == mesh->meshlets().size());
+		bool opposite = true;
+		for (size_t i = 0; i < mesh->meshlets().size() && i < flipped->meshlets().size(); ++i)
+			opposite = opposite && mesh->meshlets()[i].coneAxis == -flipped->meshlets()[i].coneAxis;
+		TEST_CHECK(opposite);
+
+		// small meshes are drawn whole
+		Geometry small;
+		AddSphere(small, Vector3(0, 0, 0), 1, 16, 8);
+		std::vector<Vector2> uv(small.vertices.size());
+		std::vector<Vector3> tangents(small.vertices.size(), Vector3(1, 0, 0));
+		Mesh smallMesh(std::move(small.vertices), std::move(small.normals), std::move(uv), std::move(tangents), std::move(small.triangles));
+		TEST_CHECK(!MeshletUtility::Build(smallMesh));
+		TEST_CHECK(smallMesh.meshlets().empty());
+	}
+
+	void TestLocalView()
+	{
+		auto go = Scene::CreateGameObject("Camera");
+		auto camera = go->AddComponent<Camera>();
+		go->transform()->setPosition(0, 0, -10);
+		Vector4 planes[6];
+		planes[0] = Vector4(1, 0, 0, -3);		// world x >= 3
+
+		// translated by 5 in x: the eye, and the plane, in the local space
+		auto view = MeshletUtility::LocalView(planes, *camera, Matrix4x4::TRS(Vector3(5, 0, 0), Quaternion::identity, Vector3::one), true);
+		TEST_CHECK(view.coneCulling);
+		TEST_CHECK(view.eye == Vector3(-5, 0, -10));
+		TEST_CHECK(!view.orthographic);
+		auto const & p = view.planes[0];
+		TEST_CHECK(Mathf::Abs(p.x * -2 + p.w) < 1e-5f);		// local x = -2 is world x = 3
+
+		// rotated and uniformly scaled: the cones still hold
+		auto similarity = Matrix4x4::TRS(Vector3(1, 2, 3), Quaternion::Euler(30, 40, 50), Vector3(2, 2, 2));
+		TEST_CHECK(MeshletUtility::LocalView(planes, *camera, similarity, true).coneCulling);
+		// not with a two sided material, a non uniform scale or a mirror
+		TEST_CHECK(!MeshletUtility::LocalView(planes, *camera, similarity, false).coneCulling);
+		TEST_CHECK(!MeshletUtility::LocalView(planes, *camera, Matrix4x4::Scale(Vector3(1, 2, 1)), true).coneCulling);
+		TEST_CHECK(!MeshletUtility::LocalView(planes, *camera, Matrix4x4::Scale(Vector3(-1, 1, 1)), true).coneCulling);
+
+		camera->setOrthographic(true);
+		view = MeshletUtility::LocalView(planes, *camera, Matrix4x4::Scale(Vector3(2, 2, 2)), true);
+		TEST_CHECK(view.orthographic);
+		TEST_CHECK((view.direction - Vector3(0, 0, 1)).magnitude() < 1e-5f);
+		Scene::DestroyImmediate(go);
+	}
+}
+
+int main()
+{
+	TestBuild();
+	TestCullingIsConservative();
+	TestCones();
+	TestMesh();
+	TestLocalView();
+	return FishEngine::Test::Report("MeshletTest");
+}
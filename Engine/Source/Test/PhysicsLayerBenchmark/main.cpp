@@ -0,0 +1,85 @@
+// A dense pile of debris boxes on the ground, with the debris layer colliding with itself and then ignoring itself
+// (as debris usually does): simulation time per step and the contact pairs that reach narrowphase.
+
+#include <FishEngine/PhysicsSystem.hpp>
+
+#include <string>
+#include <vector>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace physx;
+
+extern physx::PxPhysics*	gPhysics;
+extern physx::PxScene*		gScene;
+extern physx::PxMaterial*	gMaterial;
+
+namespace
+{
+	constexpr int DebrisLayer = 10;
+	constexpr int Side = 20;		// boxes per row
+	constexpr int Height = 10;		// rows
+	constexpr int Steps = 120;
+
+	void SetLayer(PxRigidActor* actor, int layer)
+	{
+		PxShape* shape = nullptr;
+		actor->getShapes(&shape, 1);
+		shape->setSimulationFilterData(PhysicsSystem::LayerFilterData(layer));
+	}
+
+	void Run(bool ignoreDebris)
+	{
+		PhysicsSystem::IgnoreLayerCollision(DebrisLayer, DebrisLayer, ignoreDebris);
+
+		std::vector<PxRigidActor*> actors;
+		auto ground = PxCreateStatic(*gPhysics, PxTransform(PxVec3(0, -1, 0)), PxBoxGeometry(50, 1, 50), *gMaterial);
+		gScene->addActor(*ground);
+		actors.push_back(ground);
+		// 0.5 apart, 0.6 wide: every box overlaps its neighbours from the start
+		for (int y = 0; y < Height; ++y)
+		{
+			for (int z = 0; z < Side; ++z)
+			{
+				for (int x = 0; x < Side; ++x)
+				{
+					PxTransform pose(PxVec3(x * 0.5f, 0.5f + y * 0.5f, z * 0.5f));
+					auto box = PxCreateDynamic(*gPhysics, pose, PxBoxGeometry(0.3f, 0.3f, 0.3f), *gMaterial, 10);
+					SetLayer(box, DebrisLayer);
+					gScene->addActor(*box);
+					actors.push_back(box);
+				}
+			}
+		}
+
+		Test::Stopwatch watch;
+		double contactPairs = 0;
+		for (int i = 0; i < Steps; ++i)
+		{
+			PhysicsSystem::FixedUpdate();
+			PxSimulationStatistics statistics;
+			gScene->getSimulationStatistics(statistics);
+			contactPairs += statistics.nbDiscreteContactPairsTotal;
+		}
+		double milliseconds = watch.milliseconds();
+
+		std::string name = std::to_string(actors.size() - 1) + " debris, " + (ignoreDebris ? "ignoring" : "colliding with")
+			+ " each other";
+		Test::PrintMeasurement((name + ": step").c_str(), milliseconds / Steps, "ms");
+		Test::PrintMeasurement((name + ": contact pairs per step").c_str(), contactPairs / Steps, "");
+
+		for (auto actor : actors)
+			actor->release();
+		PhysicsSystem::IgnoreLayerCollision(DebrisLayer, DebrisLayer, false);
+	}
+}
+
+int main()
+{
+	PhysicsSystem::Init();
+	Run(false);
+	Run(true);
+	PhysicsSystem::Clean();
+	return 0;
+}
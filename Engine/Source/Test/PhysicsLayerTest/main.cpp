@@ -0,0 +1,190 @@
+// PhysicsSystem: the layer collision matrix and the filter shader built on it, as bit masks, then in a PhysX scene:
+// boxes fall through the ground of an ignored layer and land on the others.
+
+#include <FishEngine/PhysicsSystem.hpp>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+using namespace physx;
+
+extern physx::PxPhysics*	gPhysics;
+extern physx::PxScene*		gScene;
+extern physx::PxMaterial*	gMaterial;
+
+namespace
+{
+	void TestDefaultMatrix()
+	{
+		for (int i = 0; i < 32; ++i)
+		{
+			TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(i) == 0xffffffffu);
+			for (int j = 0; j < 32; ++j)
+				TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(i, j));
+		}
+	}
+
+	void TestIgnoreIsSymmetric()
+	{
+		PhysicsSystem::IgnoreLayerCollision(3, 5);
+		TEST_CHECK(PhysicsSystem::GetIgnoreLayerCollision(3, 5));
+		TEST_CHECK(PhysicsSystem::GetIgnoreLayerCollision(5, 3));
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(3, 3));
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(5, 5));
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(3, 4));
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(3) == ~(1u << 5));
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(5) == ~(1u << 3));
+
+		// a layer can ignore itself
+		PhysicsSystem::IgnoreLayerCollision(31, 31);
+		TEST_CHECK(PhysicsSystem::GetIgnoreLayerCollision(31, 31));
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(31) == 0x7fffffffu);
+
+		PhysicsSystem::IgnoreLayerCollision(3, 5, false);
+		PhysicsSystem::IgnoreLayerCollision(31, 31, false);
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(3, 5));
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(31, 31));
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(3) == 0xffffffffu);
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(31) == 0xffffffffu);
+	}
+
+	void TestInvalidLayers()
+	{
+		// logged and ignored
+		PhysicsSystem::IgnoreLayerCollision(-1, 2);
+		PhysicsSystem::IgnoreLayerCollision(2, 32);
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(2) == 0xffffffffu);
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(-1, 2));
+		TEST_CHECK(!PhysicsSystem::GetIgnoreLayerCollision(2, 32));
+		TEST_CHECK(PhysicsSystem::GetLayerCollisionMask(32) == 0xffffffffu);
+
+		auto data = PhysicsSystem::LayerFilterData(40);
+		TEST_CHECK(data.word0 == 0 && data.word1 == 0);
+	}
+
+	void TestShouldCollide()
+	{
+		PhysicsSystem::IgnoreLayerCollision(8, 9);
+		auto layer8 = PhysicsSystem::LayerFilterData(8);
+		auto layer9 = PhysicsSystem::LayerFilterData(9);
+		auto layer0 = PhysicsSystem::LayerFilterData(0);
+		TEST_CHECK(layer8.word0 == (1u << 8));
+		TEST_CHECK(layer8.word1 == ~(1u << 9));
+		TEST_CHECK(layer8.word2 == 8);
+
+		TEST_CHECK(!PhysicsSystem::ShouldCollide(layer8, layer9));
+		TEST_CHECK(!PhysicsSystem::ShouldCollide(layer9, layer8));
+		TEST_CHECK(PhysicsSystem::ShouldCollide(layer8, layer8));
+		TEST_CHECK(PhysicsSystem::ShouldCollide(layer8, layer0));
+		TEST_CHECK(PhysicsSystem::ShouldCollide(layer0, layer9));
+
+		// shapes without filter data collide with everything
+		PxFilterData none;
+		TEST_CHECK(PhysicsSystem::ShouldCollide(none, layer8));
+		TEST_CHECK(PhysicsSystem::ShouldCollide(layer9, none));
+
+		// both sides must accept the pair: stale filter data on one shape still kills it (RefreshFilterData rewrites them)
+		PhysicsSystem::IgnoreLayerCollision(8, 9, false);
+		auto fresh8 = PhysicsSystem::LayerFilterData(8);
+		TEST_CHECK(!PhysicsSystem::ShouldCollide(fresh8, layer9));
+		TEST_CHECK(PhysicsSystem::ShouldCollide(fresh8, PhysicsSystem::LayerFilterData(9)));
+	}
+
+	void TestFilterShader()
+	{
+		PhysicsSystem::IgnoreLayerCollision(1, 2);
+		auto layer1 = PhysicsSystem::LayerFilterData(1);
+		auto layer2 = PhysicsSystem::LayerFilterData(2);
+		auto layer3 = PhysicsSystem::LayerFilterData(3);
+		PxFilterObjectAttributes rigid = PxFilterObjectType::eRIGID_DYNAMIC;
+		PxFilterObjectAttributes trigger = PxFilterObjectType::eRIGID_STATIC | PxFilterObjectFlag::eTRIGGER;
+
+		PxPairFlags flags;
+		auto result = PhysicsSystem::SimulationFilterShader(rigid, layer1, rigid, layer2, flags, nullptr, 0);
+		TEST_CHECK(result == PxFilterFlag::eKILL);
+
+		// ignored layers are killed before triggers are considered
+		flags = PxPairFlags();
+		result = PhysicsSystem::SimulationFilterShader(trigger, layer1, rigid, layer2, flags, nullptr, 0);
+		TEST_CHECK(result == PxFilterFlag::eKILL);
+
+		flags = PxPairFlags();
+		result = PhysicsSystem::SimulationFilterShader(rigid, layer1, rigid, layer3, flags, nullptr, 0);
+		TEST_CHECK(result == PxFilterFlag::eDEFAULT);
+		TEST_CHECK(flags == PxPairFlag::eCONTACT_DEFAULT);
+
+		flags = PxPairFlags();
+		result = PhysicsSystem::SimulationFilterShader(rigid, layer3, trigger, layer1, flags, nullptr, 0);
+		TEST_CHECK(result == PxFilterFlag::eDEFAULT);
+		TEST_CHECK(flags == PxPairFlag::eTRIGGER_DEFAULT);
+
+		PhysicsSystem::IgnoreLayerCollision(1, 2, false);
+	}
+
+	void SetLayer(PxRigidActor* actor, int layer)
+	{
+		PxShape* shape = nullptr;
+		actor->getShapes(&shape, 1);
+		shape->setSimulationFilterData(PhysicsSystem::LayerFilterData(layer));
+	}
+
+	PxRigidDynamic* DropBox(float x, int layer)
+	{
+		auto box = PxCreateDynamic(*gPhysics, PxTransform(PxVec3(x, 2, 0)), PxBoxGeometry(0.5f, 0.5f, 0.5f), *gMaterial, 10);
+		SetLayer(box, layer);
+		gScene->addActor(*box);
+		return box;
+	}
+
+	void Simulate(int steps)
+	{
+		for (int i = 0; i < steps; ++i)
+			PhysicsSystem::FixedUpdate();
+	}
+
+	void TestScene()
+	{
+		PhysicsSystem::Init();
+		PhysicsSystem::IgnoreLayerCollision(8, 9);
+
+		// the top of the ground at y = 0
+		auto ground = PxCreateStatic(*gPhysics, PxTransform(PxVec3(0, -1, 0)), PxBoxGeometry(20, 1, 20), *gMaterial);
+		SetLayer(ground, 9);
+		gScene->addActor(*ground);
+		auto ignored = DropBox(-3, 8);
+		auto landed = DropBox(0, 0);
+		Simulate(60);
+		TEST_CHECK(ignored->getGlobalPose().p.y < -2);
+		TEST_CHECK_NEAR(landed->getGlobalPose().p.y, 0.5f, 0.05f);
+
+		// the matrix changed: the filter data of the shapes in the scene follow, by their layer
+		PhysicsSystem::IgnoreLayerCollision(8, 9, false);
+		PhysicsSystem::IgnoreLayerCollision(0, 9);
+		PxShape* shape = nullptr;
+		landed->getShapes(&shape, 1);
+		auto data = shape->getSimulationFilterData();
+		TEST_CHECK(data.word0 == 1u && data.word1 == PhysicsSystem::GetLayerCollisionMask(0) && data.word2 == 0);
+		ignored->getShapes(&shape, 1);
+		TEST_CHECK(shape->getSimulationFilterData().word1 == 0xffffffffu);
+
+		// the pair of the landed box is filtered again: it falls now, and a new box of layer 8 lands
+		auto second = DropBox(3, 8);
+		Simulate(60);
+		TEST_CHECK(landed->getGlobalPose().p.y < -2);
+		TEST_CHECK_NEAR(second->getGlobalPose().p.y, 0.5f, 0.05f);
+
+		PhysicsSystem::IgnoreLayerCollision(0, 9, false);
+		PhysicsSystem::Clean();
+	}
+}
+
+int main()
+{
+	TestDefaultMatrix();
+	TestIgnoreIsSymmetric();
+	TestInvalidLayers();
+	TestShouldCollide();
+	TestFilterShader();
+	TestScene();
+	return FishEngine::Test::Report("PhysicsLayerTest");
+}
@@ -0,0 +1,173 @@
+// ProjectViewFileModel, the files of the current folder of the project view, on a folder of 20k files: rows inserted
+// in batches, and rescans that delete files and folders, one of them shown or kept in a snapshot, while the rows are
+// read. Offscreen Qt: no window is shown.
+
+#include <FileInfo.hpp>
+#include <ProjectViewFileModel.hpp>
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include <TestUtility.hpp>
+
+using namespace FishEditor;
+namespace fs = boost::filesystem;
+
+namespace
+{
+	constexpr int Files = 20000;
+	constexpr int Folders = 10;
+
+	std::string FileName(int i)
+	{
+		return "File" + std::to_string(i) + ".txt";
+	}
+
+	std::string FolderName(int i)
+	{
+		return "Folder" + std::to_string(i);
+	}
+
+	// Runs the event loop (the batches, the end of the scans) until done, false after 20 s.
+	template<typename Done>
+	bool ProcessEventsUntil(Done done)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		while (!done())
+		{
+			if (timer.elapsed() > 20000)
+				return false;
+			QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+		}
+		return true;
+	}
+
+	// The names of the rows, read as the view does; every row must be a child of the shown folder.
+	std::multiset<std::string> RowNames(ProjectViewFileModel & model, bool & consistent)
+	{
+		std::multiset<std::string> names;
+		auto root = model.fileInfo(QModelIndex());
+		for (int row = 0; row < model.rowCount(); ++row)
+		{
+			auto index = model.index(row, 0);
+			auto info = model.fileInfo(index);
+			if (info == nullptr || info->parent() != root)
+				consistent = false;
+			names.insert(model.data(index).toString().toStdString());
+		}
+		return names;
+	}
+
+	std::multiset<std::string> Stems(fs::path const & dir)
+	{
+		std::multiset<std::string> stems;
+		for (auto const & e : FileInfo::ScanDirectory(dir))
+			stems.insert(e.isDirectory ? e.path.filename().string() : e.path.stem().string());
+		return stems;
+	}
+
+	void TestOpenLargeFolder(ProjectViewFileModel & model, fs::path const & assets)
+	{
+		int largestStep = 0;
+		int lastCount = 0;
+		model.setRootPath(QString::fromStdString(assets.string()));
+		bool inserted = ProcessEventsUntil([&]() {
+			largestStep = std::max(largestStep, model.rowCount() - lastCount);
+			lastCount = model.rowCount();
+			return model.rowCount() == Files + Folders;
+		});
+		TEST_CHECK(inserted);
+		// in batches: the first paint does not wait for all the rows
+		TEST_CHECK(largestStep < Files);
+
+		bool consistent = true;
+		TEST_CHECK(RowNames(model, consistent) == Stems(assets));
+		TEST_CHECK(consistent);
+		// the folders first
+		for (int row = 0; row < Folders; ++row)
+			TEST_CHECK(model.fileInfo(model.index(row, 0))->isDir());
+	}
+
+	void TestRescanRemoves(ProjectViewFileModel & model, fs::path const & assets)
+	{
+		// a folder opened before: its rows are kept in a snapshot
+		model.setRootPath(QString::fromStdString((assets / FolderName(3)).string()));
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.rowCount() == 1; }));
+		model.setRootPath(QString::fromStdString(assets.string()));
+
+		for (int i = 0; i < Files; i += 4)
+			fs::remove(assets / FileName(i));
+		fs::remove_all(assets / FolderName(3));
+		model.Rescan(QString::fromStdString(assets.string()));
+		int expected = Files - Files / 4 + Folders - 1;
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.rowCount() == expected; }));
+
+		bool consistent = true;
+		TEST_CHECK(RowNames(model, consistent) == Stems(assets));
+		TEST_CHECK(consistent);
+		TEST_CHECK(FileInfo::find((assets / FolderName(3)).string()) == nullptr);
+
+		// opened again once created again: listed from scratch, not from the freed snapshot
+		fs::create_directory(assets / FolderName(3));
+		model.Rescan(QString::fromStdString(assets.string()));
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.rowCount() == expected + 1; }));
+		model.setRootPath(QString::fromStdString((assets / FolderName(3)).string()));
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.fileInfo(QModelIndex())->listed(); }));
+		TEST_CHECK(model.rowCount() == 0);
+	}
+
+	void TestShownFolderRemoved(ProjectViewFileModel & model, fs::path const & assets)
+	{
+		model.setRootPath(QString::fromStdString((assets / FolderName(5)).string()));
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.rowCount() == 1; }));
+
+		// the view shows the folder that contained it
+		fs::remove_all(assets / FolderName(5));
+		model.Rescan(QString::fromStdString(assets.string()));
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.fileInfo(QModelIndex())->path() == assets; }));
+		TEST_CHECK(ProcessEventsUntil([&]() { return model.rowCount() == static_cast<int>(Stems(assets).size()); }));
+		bool consistent = true;
+		TEST_CHECK(RowNames(model, consistent) == Stems(assets));
+		TEST_CHECK(consistent);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	// QIcon of data(); no window is shown
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	QGuiApplication app(argc, argv);
+
+	auto dir = fs::temp_directory_path() / fs::unique_path("ProjectViewFileModelTest-%%%%-%%%%-%%%%");
+	fs::create_directories(dir / "Assets");
+	auto cwd = fs::current_path();
+	fs::current_path(dir);
+	auto assets = fs::path("Assets");
+	for (int i = 0; i < Files; ++i)
+		std::ofstream((assets / FileName(i)).string()) << "x";
+	for (int i = 0; i < Folders; ++i)
+	{
+		fs::create_directory(assets / FolderName(i));
+		std::ofstream((assets / FolderName(i) / "Inside.txt").string()) << "x";
+	}
+
+	{
+		// the project root, with an empty path: its children are relative to the current directory
+		FileInfo root;
+		root.UpdateChildren(FileInfo::ScanDirectory(fs::current_path()));
+		ProjectViewFileModel model;
+		TestOpenLargeFolder(model, assets);
+		TestRescanRemoves(model, assets);
+		TestShownFolderRemoved(model, assets);
+	}
+
+	fs::current_path(cwd);
+	fs::remove_all(dir);
+	return FishEngine::Test::Report("ProjectViewFileModelTest");
+}
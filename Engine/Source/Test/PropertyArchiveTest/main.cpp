@@ -0,0 +1,142 @@
+// PropertyArchive, as used by the script reload: the fields of an object captured and written back one by one,
+// references remapped to new objects, and the fields whose stored data no longer fits reported.
+
+#include <FishEngine/AudioClip.hpp>
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <PropertyArchive.hpp>
+
+#include <algorithm>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace
+{
+	PropertyValue * Find(PropertyValues & values, std::string const & name)
+	{
+		auto it = std::find_if(values.begin(), values.end(), [&name](PropertyValue const & v) { return v.name == name; });
+		return it == values.end() ? nullptr : &*it;
+	}
+
+	void TestRoundTrip()
+	{
+		auto go = Scene::CreateGameObject("Source");
+		auto t = go->transform();
+		t->setLocalPosition(1, 2, 3);
+		t->setLocalScale(4);
+		auto values = CaptureProperties(*t);
+		TEST_CHECK(Find(values, "m_localPosition") != nullptr);
+		TEST_CHECK(Find(values, "m_localScale") != nullptr);
+
+		t->setLocalPosition(0, 0, 0);
+		t->setLocalScale(1);
+		// the Inspector redraws the section of an object written this way
+		auto dirtyCount = t->dirtyCount();
+		TEST_CHECK(ApplyProperties(*t, values));
+		TEST_CHECK(t->dirtyCount() != dirtyCount);
+		TEST_CHECK(t->localPosition() == Vector3(1, 2, 3));
+		TEST_CHECK(t->localScale() == Vector3(4, 4, 4));
+
+		// only the given properties are written, the others keep their value
+		PropertyValues position = { *Find(values, "m_localPosition") };
+		t->setLocalPosition(5, 5, 5);
+		t->setLocalScale(2);
+		TEST_CHECK(ApplyProperties(*t, position));
+		TEST_CHECK(t->localPosition() == Vector3(1, 2, 3));
+		TEST_CHECK(t->localScale() == Vector3(2, 2, 2));
+
+		// the same fields give the same data
+		TEST_CHECK(CaptureProperties(*t) == CaptureProperties(*t));
+		Scene::DestroyImmediate(go);
+	}
+
+	void TestMismatched()
+	{
+		auto source = std::make_shared<AudioSource>();
+		source->setVolume(0.5f);
+		source->setPitch(2);
+		source->setPriority(7);
+		auto values = CaptureProperties(*source);
+		auto volume = Find(values, "m_volume");
+		auto pitch = Find(values, "m_pitch");
+		TEST_CHECK(volume != nullptr && pitch != nullptr);
+		if (volume == nullptr || pitch == nullptr)
+			return;
+
+		// stored narrower than the field (a float that became a double): the read fails
+		volume->data.resize(volume->data.size() / 2);
+		// stored wider than the field (a double that became a float): data is left
+		pitch->data.append(4, '\0');
+
+		auto target = std::make_shared<AudioSource>();
+		std::vector<std::string> mismatched;
+		TEST_CHECK(!ApplyProperties(*target, values, nullptr, &mismatched));
+		TEST_CHECK(mismatched.size() == 2);
+		TEST_CHECK(std::find(mismatched.begin(), mismatched.end(), "m_volume") != mismatched.end());
+		TEST_CHECK(std::find(mismatched.begin(), mismatched.end(), "m_pitch") != mismatched.end());
+
+		// the reload starts over without them: the other fields are restored, these keep their default
+		values.erase(std::remove_if(values.begin(), values.end(), [&mismatched](PropertyValue const & v) {
+			return std::find(mismatched.begin(), mismatched.end(), v.name) != mismatched.end();
+		}), values.end());
+		target = std::make_shared<AudioSource>();
+		TEST_CHECK(ApplyProperties(*target, values, nullptr, &mismatched));
+		TEST_CHECK(mismatched.empty());
+		TEST_CHECK(target->priority() == 7);
+		TEST_CHECK(target->volume() == 1);
+		TEST_CHECK(target->pitch() == 1);
+	}
+
+	void TestReferences()
+	{
+		auto oldClip = std::make_shared<AudioClip>();
+		auto newClip = std::make_shared<AudioClip>();
+		auto source = std::make_shared<AudioSource>();
+		source->setClip(oldClip);
+
+		auto values = CaptureProperties(*source);
+		auto clip = Find(values, "m_clip");
+		TEST_CHECK(clip != nullptr && clip->references.size() == 1 && clip->references[0] == oldClip);
+		if (clip == nullptr || clip->references.size() != 1)
+			return;
+
+		// remapped, as the references to replaced script instances
+		clip->references[0] = newClip;
+		TEST_CHECK(ApplyProperties(*source, { *clip }));
+		TEST_CHECK(source->clip() == newClip);
+
+		// objects of a subtree are referenced by their ordinal
+		LocalOrdinals ordinals = { { newClip->GetInstanceID(), 0 } };
+		values = CaptureProperties(*source, &ordinals);
+		clip = Find(values, "m_clip");
+		TEST_CHECK(clip != nullptr && clip->references.empty());
+		if (clip == nullptr)
+			return;
+		LocalObjects local = { oldClip };
+		TEST_CHECK(ApplyProperties(*source, { *clip }, &local));
+		TEST_CHECK(source->clip() == oldClip);
+
+		// an ordinal without its object
+		LocalObjects none;
+		TEST_CHECK(!ApplyProperties(*source, { *clip }, &none));
+
+		source->setClip(nullptr);
+		values = CaptureProperties(*source);
+		clip = Find(values, "m_clip");
+		TEST_CHECK(clip != nullptr && clip->references.empty());
+	}
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestMismatched();
+	TestReferences();
+	return FishEngine::Test::Report("PropertyArchiveTest");
+}
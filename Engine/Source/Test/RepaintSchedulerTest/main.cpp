@@ -0,0 +1,85 @@
+// RepaintScheduler (the on demand repaint of the scene view): the requests between two frames are coalesced into
+// one, the ones made while drawing are dropped, and continuous repaints nest.
+
+#include <RepaintScheduler.hpp>
+
+#include <TestUtility.hpp>
+
+using namespace FishEditor;
+
+namespace
+{
+	void TestCoalescing()
+	{
+		int scheduled = 0;
+		RepaintScheduler repaint([&scheduled]() { scheduled++; });
+		TEST_CHECK(repaint.frameCount() == 0);
+
+		// idle: nothing is scheduled
+		TEST_CHECK(scheduled == 0);
+
+		// a burst of requests (mouse moves, selection, hierarchy notifications): one frame
+		for (int i = 0; i < 10; ++i)
+			repaint.Request();
+		TEST_CHECK(scheduled == 1);
+
+		repaint.BeginFrame();
+		TEST_CHECK(repaint.frameCount() == 1);
+		// made while drawing: already in this frame
+		repaint.Request();
+		repaint.Request();
+		repaint.EndFrame();
+		TEST_CHECK(scheduled == 1);
+
+		// after the frame, a new request schedules a new frame
+		repaint.Request();
+		TEST_CHECK(scheduled == 2);
+		repaint.Request();
+		TEST_CHECK(scheduled == 2);
+		repaint.BeginFrame();
+		repaint.EndFrame();
+		TEST_CHECK(repaint.frameCount() == 2);
+
+		// a frame drawn without a request (resize, expose) leaves nothing pending
+		repaint.BeginFrame();
+		repaint.EndFrame();
+		repaint.Request();
+		TEST_CHECK(scheduled == 3);
+	}
+
+	void TestContinuous()
+	{
+		int scheduled = 0;
+		RepaintScheduler repaint([&scheduled]() { scheduled++; });
+		TEST_CHECK(!repaint.continuous());
+
+		repaint.BeginContinuous();
+		TEST_CHECK(repaint.continuous());
+		TEST_CHECK(scheduled == 1);	// the first frame is requested, the frame timer takes over
+
+		// nested: no new request
+		repaint.BeginContinuous();
+		TEST_CHECK(scheduled == 1);
+		repaint.EndContinuous();
+		TEST_CHECK(repaint.continuous());
+		repaint.EndContinuous();
+		TEST_CHECK(!repaint.continuous());
+
+		// still pending: the frame requested by BeginContinuous has not been drawn
+		repaint.BeginContinuous();
+		TEST_CHECK(scheduled == 1);
+		repaint.BeginFrame();
+		repaint.EndFrame();
+		repaint.EndContinuous();
+		repaint.BeginContinuous();
+		TEST_CHECK(scheduled == 2);
+		repaint.EndContinuous();
+	}
+}
+
+int main()
+{
+	TestCoalescing();
+	TestContinuous();
+	return FishEngine::Test::Report("RepaintSchedulerTest");
+}
@@ -0,0 +1,133 @@
+// Scene's hierarchy notifications (the hierarchy view of the editor): one notification per change, in the order of
+// the changes, and one for a destroyed subtree.
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <vector>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	struct Notification
+	{
+		HierarchyChange change;
+		GameObject* go;
+
+		bool operator==(Notification const & rhs) const
+		{
+			return change == rhs.change && go == rhs.go;
+		}
+	};
+
+	std::vector<Notification> s_notifications;
+
+	bool Received(std::vector<Notification> const & expected)
+	{
+		bool same = s_notifications == expected;
+		s_notifications.clear();
+		return same;
+	}
+
+	void TestCreateRenameActivate()
+	{
+		auto a = Scene::CreateGameObject("A");
+		TEST_CHECK(Received({ { HierarchyChange::Created, a.get() } }));
+		TEST_CHECK(Scene::Find("A") == a);
+
+		a->setName("B");
+		TEST_CHECK(Received({ { HierarchyChange::Renamed, a.get() } }));
+		a->setName("B");
+		TEST_CHECK(Received({}));
+
+		a->SetActive(false);
+		TEST_CHECK(Received({ { HierarchyChange::ActiveChanged, a.get() } }));
+		a->SetActive(false);
+		TEST_CHECK(Received({}));
+		a->SetActive(true);
+		TEST_CHECK(Received({ { HierarchyChange::ActiveChanged, a.get() } }));
+
+		Scene::DestroyImmediate(a);
+		TEST_CHECK(Received({ { HierarchyChange::Destroyed, a.get() } }));
+	}
+
+	void TestReparent()
+	{
+		auto parent = Scene::CreateGameObject("Parent");
+		auto child = Scene::CreateGameObject("Child");
+		s_notifications.clear();
+
+		child->transform()->SetParent(parent->transform());
+		TEST_CHECK(Received({ { HierarchyChange::Reparented, child.get() } }));
+		TEST_CHECK(child->transform()->parent() == parent->transform());
+		child->transform()->SetParent(parent->transform());
+		TEST_CHECK(Received({}));
+
+		// a parent can not become the child of its child
+		parent->transform()->SetParent(child->transform());
+		TEST_CHECK(Received({}));
+		TEST_CHECK(parent->transform()->parent() == nullptr);
+
+		child->transform()->SetParent(nullptr);
+		TEST_CHECK(Received({ { HierarchyChange::Reparented, child.get() } }));
+
+		Scene::DestroyImmediate(parent);
+		Scene::DestroyImmediate(child);
+		s_notifications.clear();
+	}
+
+	void TestDestroySubtree()
+	{
+		auto root = Scene::CreateGameObject("Root");
+		auto child = Scene::CreateGameObject("Child");
+		auto grandChild = Scene::CreateGameObject("GrandChild");
+		child->transform()->SetParent(root->transform());
+		grandChild->transform()->SetParent(child->transform());
+		s_notifications.clear();
+
+		// once, for the root: the children are removed with it
+		auto count = Scene::GameObjects().size();
+		Scene::DestroyImmediate(root);
+		TEST_CHECK(Received({ { HierarchyChange::Destroyed, root.get() } }));
+		TEST_CHECK(Scene::GameObjects().size() == count - 3);
+		TEST_CHECK(Scene::Find("GrandChild") == nullptr);
+
+		// notifications resume after it
+		auto other = Scene::CreateGameObject("Other");
+		TEST_CHECK(Received({ { HierarchyChange::Created, other.get() } }));
+		Scene::DestroyImmediate(other);
+		s_notifications.clear();
+	}
+
+	void TestRemoveListener()
+	{
+		int calls = 0;
+		int id = Scene::AddHierarchyListener([&calls](HierarchyChange, GameObject*) { calls++; });
+		auto go = Scene::CreateGameObject("Listened");
+		TEST_CHECK(calls == 1);
+		Scene::RemoveHierarchyListener(id);
+		go->setName("NotListened");
+		TEST_CHECK(calls == 1);
+		// the first listener is still there
+		TEST_CHECK(s_notifications.size() == 2);
+		Scene::DestroyImmediate(go);
+		s_notifications.clear();
+	}
+}
+
+int main()
+{
+	Scene::AddHierarchyListener([](HierarchyChange change, GameObject* go)
+	{
+		s_notifications.push_back({ change, go });
+	});
+	TestCreateRenameActivate();
+	TestReparent();
+	TestDestroySubtree();
+	TestRemoveListener();
+	return FishEngine::Test::Report("SceneHierarchyTest");
+}
@@ -0,0 +1,104 @@
+// The frame time of the scene view with a camera and 2,000 objects selected: the camera preview (re-rendered only
+// when the scene changed) and the selection outline (its draw list kept until the selection changes), against the
+// same scene with nothing selected, and with an object moving every frame (the preview is re-rendered).
+// It needs a display with OpenGL 4.1, and runs from the editor's directory (its Resources and Shaders).
+
+#include <FishEngine/GLEnvironment.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/PrimitiveType.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <GLWidget.hpp>
+#include <MainEditor.hpp>
+#include <SceneViewCache.hpp>
+#include <Selection.hpp>
+
+#include <QApplication>
+#include <QSurfaceFormat>
+#include <QTimer>
+
+#include <list>
+#include <string>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+using namespace FishEngine::Test;
+
+namespace
+{
+	// Frames drawn continuously for seconds: prints the CPU milliseconds per frame and the frames per second.
+	void MeasureFrames(QApplication & app, double seconds, std::string const & name)
+	{
+		MainEditor::BeginContinuousRepaint();
+		QTimer::singleShot(static_cast<int>(seconds * 1000), &app, &QApplication::quit);
+		auto frames = MainEditor::repaintCount();
+		double cpu = ProcessCPUTime();
+		Stopwatch stopwatch;
+		app.exec();
+		double wall = stopwatch.milliseconds();
+		auto drawn = static_cast<double>(MainEditor::repaintCount() - frames);
+		MainEditor::EndContinuousRepaint();
+		PrintMeasurement((name + ", CPU per frame").c_str(), (ProcessCPUTime() - cpu) / drawn, "ms");
+		PrintMeasurement((name + ", frame time").c_str(), wall / drawn, "ms");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	QApplication app(argc, argv);
+	// as the editor's main
+	QSurfaceFormat format;
+	format.setDepthBufferSize(24);
+	format.setStencilBufferSize(8);
+	format.setVersion(4, 1);
+	format.setProfile(QSurfaceFormat::CoreProfile);
+	QSurfaceFormat::setDefaultFormat(format);
+
+	GLWidget view;
+	view.resize(1280, 720);
+	view.show();
+	// initializeGL and the first frames
+	QTimer::singleShot(1000, &app, &QApplication::quit);
+	app.exec();
+
+	// 2,000 cubes on a grid in front of a camera
+	view.makeCurrent();
+	auto camera = Scene::CreateCamera();
+	camera->transform()->setLocalPosition(0, 20, -60);
+	camera->transform()->LookAt(Vector3(0, 0, 0));
+	std::list<std::weak_ptr<Transform>> selection = { camera->transform() };
+	const int count = 2000;
+	for (int i = 0; i < count; ++i)
+	{
+		auto cube = GameObject::CreatePrimitive(PrimitiveType::Cube);
+		cube->transform()->setLocalPosition(static_cast<float>(i % 50) * 2 - 50, 0, static_cast<float>(i / 50) * 2 - 40);
+		selection.push_back(cube->transform());
+	}
+	auto moving = selection.back().lock();
+
+	MeasureFrames(app, 10, "2000 cubes, nothing selected");
+
+	// the camera first: the active object, its preview is drawn
+	Selection::setTransforms(selection);
+	MeasureFrames(app, 10, "camera and 2000 cubes selected, scene unchanged");
+
+	bool move = true;
+	MainEditor::OnFrameDrawn += [&move, &moving]() {
+		if (move)
+			moving->setLocalEulerAngles(0, moving->localEulerAngles().y + 1, 0);
+	};
+	MeasureFrames(app, 10, "camera and 2000 cubes selected, a cube rotating");
+	move = false;
+
+	// what the preview compares every frame
+	Stopwatch stopwatch;
+	const int calls = 100000;
+	volatile uint64_t version = 0;
+	for (int i = 0; i < calls; ++i)
+		version = SceneContentVersion();
+	PrintMeasurement("SceneContentVersion, 2000 objects", stopwatch.milliseconds() * 1000000 / calls, "ns");
+	return 0;
+}
@@ -0,0 +1,121 @@
+// Scene::Update: every new component is started, in hierarchy order, before the first update of the frame; the
+// thread-safe batches run on the JobSystem, and the dirty marks they make on shared objects are all counted.
+
+#include <FishEngine/Component.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/JobSystem.hpp>
+#include <FishEngine/Scene.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	std::vector<std::string> s_log;
+
+	// AddComponent(ComponentPtr): ClassID<T> only exists for the reflected engine classes
+
+	// Logs its Start and Update calls; the first one also adds a component to another game object.
+	class Recorder : public Component
+	{
+	public:
+		GameObjectPtr m_addTo;
+
+		virtual int ClassID() const override { return 100001; }
+
+		virtual void Start() override
+		{
+			s_log.push_back("start " + gameObject()->name());
+		}
+
+		virtual void Update() override
+		{
+			s_log.push_back("update " + gameObject()->name());
+			if (m_addTo != nullptr)
+			{
+				m_addTo->AddComponent(std::make_shared<Recorder>());
+				m_addTo = nullptr;
+			}
+		}
+	};
+
+	// Marks a shared object many times from the parallel Animation batch, as the bones of Animation do.
+	class ParallelMarker : public Component
+	{
+	public:
+		static constexpr int Marks = 1000;
+		Object const * m_target = nullptr;
+
+		virtual int ClassID() const override { return 100002; }
+		virtual UpdatePhase updatePhase() const override { return UpdatePhase::Animation; }
+		virtual bool isUpdateThreadSafe() const override { return true; }
+
+		virtual void Update() override
+		{
+			for (int i = 0; i < Marks; ++i)
+				m_target->SetDirty();
+		}
+	};
+
+	void TestStartOrder()
+	{
+		s_log.clear();
+		auto a = Scene::CreateGameObject("A");
+		auto b = Scene::CreateGameObject("B");
+		auto c = Scene::CreateGameObject("C");
+		auto first = std::make_shared<Recorder>();
+		first->m_addTo = c;
+		a->AddComponent(first);
+		b->AddComponent(std::make_shared<Recorder>());
+
+		// all the starts, then all the updates: B is started before A is updated
+		Scene::Update();
+		std::vector<std::string> expected = { "start A", "start B", "update A", "update B" };
+		TEST_CHECK(s_log == expected);
+
+		// added during the update of A: started on the next frame, before any update
+		s_log.clear();
+		Scene::Update();
+		expected = { "start C", "update A", "update B", "update C" };
+		TEST_CHECK(s_log == expected);
+
+		Scene::DestroyImmediate(a);
+		Scene::DestroyImmediate(b);
+		Scene::DestroyImmediate(c);
+	}
+
+	void TestParallelDirtyMarks()
+	{
+		auto target = Scene::CreateGameObject("Target");
+		std::vector<GameObjectPtr> markers;
+		const int count = 64;
+		for (int i = 0; i < count; ++i)
+		{
+			auto go = Scene::CreateGameObject("Marker");
+			auto marker = std::make_shared<ParallelMarker>();
+			marker->m_target = target.get();
+			go->AddComponent(marker);
+			markers.push_back(go);
+		}
+		auto before = target->dirtyCount();
+		Scene::Update();
+		TEST_CHECK(target->dirtyCount() - before == count * ParallelMarker::Marks);
+		for (auto & go : markers)
+			Scene::DestroyImmediate(go);
+		Scene::DestroyImmediate(target);
+	}
+}
+
+int main()
+{
+	TestStartOrder();
+	if (JobSystem::threadCount() == 1)
+		printf("SceneUpdateTest: one thread, the marks are not concurrent\n");
+	TestParallelDirtyMarks();
+	return FishEngine::Test::Report("SceneUpdateTest");
+}
@@ -0,0 +1,56 @@
+// The scene view of the editor left alone: the CPU used and the frames drawn per second of the event loop, idle (the
+// frames are drawn on demand, it used to redraw at 30 Hz forever) and in the continuous mode of the animated previews.
+// It needs a display with OpenGL 4.1, and runs from the editor's directory (its Resources and Shaders).
+
+#include <FishEngine/GLEnvironment.hpp>
+#include <GLWidget.hpp>
+#include <MainEditor.hpp>
+
+#include <QApplication>
+#include <QSurfaceFormat>
+#include <QTimer>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEditor;
+using namespace FishEngine::Test;
+
+namespace
+{
+	// CPU milliseconds and frames per second of the event loop, run for seconds.
+	void Measure(QApplication & app, double seconds, const char* cpuName, const char* framesName)
+	{
+		QTimer::singleShot(static_cast<int>(seconds * 1000), &app, &QApplication::quit);
+		auto frames = MainEditor::repaintCount();
+		double cpu = ProcessCPUTime();
+		app.exec();
+		PrintMeasurement(cpuName, (ProcessCPUTime() - cpu) / seconds, "ms CPU/s");
+		PrintMeasurement(framesName, (MainEditor::repaintCount() - frames) / seconds, "frames/s");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	QApplication app(argc, argv);
+	// as the editor's main
+	QSurfaceFormat format;
+	format.setDepthBufferSize(24);
+	format.setStencilBufferSize(8);
+	format.setVersion(4, 1);
+	format.setProfile(QSurfaceFormat::CoreProfile);
+	QSurfaceFormat::setDefaultFormat(format);
+
+	GLWidget view;
+	view.resize(1280, 720);
+	view.show();
+	// initializeGL and the first frames
+	QTimer::singleShot(1000, &app, &QApplication::quit);
+	app.exec();
+
+	Measure(app, 10, "idle scene view, CPU", "idle scene view, frames drawn");
+
+	MainEditor::BeginContinuousRepaint();
+	Measure(app, 10, "continuous repaint (animated preview), CPU", "continuous repaint, frames drawn");
+	MainEditor::EndContinuousRepaint();
+	return 0;
+}
@@ -0,0 +1,146 @@
+// The caches of the scene view: the scene content version the camera preview is re-rendered on, and the draw list
+// of the selection outline, rebuilt only when the meshes under the selection may have changed.
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/MeshFilter.hpp>
+#include <FishEngine/MeshRenderer.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/SkinnedMeshRenderer.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <SceneViewCache.hpp>
+
+#include <algorithm>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace
+{
+	// Mesh::~Mesh deletes its GL buffers and there is no GL context here: the meshes are never destroyed
+	MeshPtr NewMesh()
+	{
+		static auto meshes = new std::vector<MeshPtr>();
+		meshes->push_back(std::make_shared<Mesh>());
+		return meshes->back();
+	}
+
+	// the versions seen so far: a version never comes back (a sum of the dirty counts of the scene could, the
+	// preview then showed a stale picture)
+	std::vector<uint64_t> s_versions;
+
+	template<typename Change>
+	bool ChangesVersion(Change change)
+	{
+		auto before = SceneContentVersion();
+		change();
+		auto after = SceneContentVersion();
+		TEST_CHECK(std::find(s_versions.begin(), s_versions.end(), after) == s_versions.end() || after == before);
+		s_versions.push_back(after);
+		return after != before;
+	}
+
+	void TestContentVersion()
+	{
+		auto go = Scene::CreateGameObject("Preview");
+		TEST_CHECK(!ChangesVersion([]() {}));
+		TEST_CHECK(ChangesVersion([&]() { go->setName("Renamed"); }));
+		TEST_CHECK(ChangesVersion([&]() { go->transform()->setLocalPosition(1, 2, 3); }));
+
+		// the children too
+		auto child = Scene::CreateGameObject("Child");
+		child->transform()->SetParent(go->transform(), false);
+		TEST_CHECK(ChangesVersion([&]() { child->transform()->setLocalScale(2); }));
+
+		std::shared_ptr<MeshRenderer> renderer;
+		TEST_CHECK(ChangesVersion([&]() { renderer = child->AddComponent<MeshRenderer>(); }));
+		auto material = std::make_shared<Material>();
+		TEST_CHECK(ChangesVersion([&]() { renderer->SetMaterial(material); }));
+		TEST_CHECK(ChangesVersion([&]() { material->SetDirty(); }));
+
+		// created with the dirty counts of the removed one: still a change
+		std::shared_ptr<GameObject> added;
+		TEST_CHECK(ChangesVersion([&]() { added = Scene::CreateGameObject("Added"); }));
+		TEST_CHECK(ChangesVersion([&]() { Scene::DestroyImmediate(added); }));
+		TEST_CHECK(ChangesVersion([&]() { Scene::DestroyImmediate(go); }));
+
+		// as many changes on a new object as on a destroyed one
+		auto a = Scene::CreateGameObject("A");
+		a->transform()->setLocalPosition(1, 0, 0);
+		TEST_CHECK(ChangesVersion([&]() { Scene::DestroyImmediate(a); }));
+		auto b = Scene::CreateGameObject("B");
+		TEST_CHECK(ChangesVersion([&]() { b->transform()->setLocalPosition(1, 0, 0); }));
+		Scene::DestroyImmediate(b);
+	}
+
+	void TestOutlineDrawList()
+	{
+		auto root = Scene::CreateGameObject("Root");
+		auto child = Scene::CreateGameObject("Child");
+		child->transform()->SetParent(root->transform(), false);
+		auto childMesh = NewMesh();
+		auto filter = child->AddComponent<MeshFilter>();
+		filter->SetMesh(childMesh);
+		auto grandChild = Scene::CreateGameObject("GrandChild");
+		grandChild->transform()->SetParent(child->transform(), false);
+		auto skinnedMesh = NewMesh();
+		grandChild->AddComponent<SkinnedMeshRenderer>()->setSharedMesh(skinnedMesh);
+		auto other = Scene::CreateGameObject("Other");
+		other->AddComponent<MeshFilter>()->SetMesh(NewMesh());
+
+		std::list<std::weak_ptr<Transform>> selection = { root->transform() };
+		OutlineDrawList list;
+		TEST_CHECK(list.Update(selection));
+		// the selected objects and their children, not the others
+		TEST_CHECK(list.items().size() == 2);
+		if (list.items().size() == 2)
+		{
+			TEST_CHECK(list.items()[0].mesh == childMesh && list.items()[0].transform.lock() == child->transform());
+			TEST_CHECK(list.items()[1].mesh == skinnedMesh);
+		}
+
+		// kept while nothing changes, and while the objects move
+		TEST_CHECK(!list.Update(selection));
+		root->transform()->setLocalPosition(1, 0, 0);
+		child->transform()->setLocalEulerAngles(0, 90, 0);
+		TEST_CHECK(!list.Update(selection));
+
+		// a mesh assigned, a component added
+		auto newMesh = NewMesh();
+		filter->SetMesh(newMesh);
+		TEST_CHECK(list.Update(selection));
+		TEST_CHECK(!list.items().empty() && list.items()[0].mesh == newMesh);
+		root->AddComponent<MeshFilter>()->SetMesh(NewMesh());
+		TEST_CHECK(list.Update(selection));
+		TEST_CHECK(list.items().size() == 3);
+
+		// an object destroyed: notified, or gone with its last reference
+		Scene::DestroyImmediate(grandChild);
+		grandChild.reset();
+		TEST_CHECK(list.Update(selection));
+		TEST_CHECK(list.items().size() == 2);
+
+		// the selection and the hierarchy changes are notified (Selection::selectionChanged, hierarchy listeners)
+		TEST_CHECK(!list.Update({ other->transform() }));
+		list.Invalidate();
+		TEST_CHECK(list.Update({ other->transform() }));
+		TEST_CHECK(list.items().size() == 1);
+		list.Invalidate();
+		TEST_CHECK(list.Update({}));
+		TEST_CHECK(list.items().empty());
+
+		Scene::DestroyImmediate(root);
+		Scene::DestroyImmediate(other);
+	}
+}
+
+int main()
+{
+	TestContentVersion();
+	TestOutlineDrawList();
+	return FishEngine::Test::Report("SceneViewCacheTest");
+}
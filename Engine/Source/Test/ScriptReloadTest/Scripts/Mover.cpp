@@ -0,0 +1,40 @@
+#include "Mover.hpp"
+
+#include <FishEngine/Serialization/Archive.hpp>
+
+#include <boost/config.hpp> // for BOOST_SYMBOL_EXPORT
+
+// as generated by BuildProject.py
+#define API extern "C" BOOST_SYMBOL_EXPORT
+
+void Mover::Serialize(FishEngine::OutputArchive & archive) const
+{
+	FishEngine::Script::Serialize(archive);
+	archive << FishEngine::make_nvp("m_speed", m_speed); // float
+	archive << FishEngine::make_nvp("m_count", m_count); // int
+	archive << FishEngine::make_nvp("m_label", m_label); // std::string
+	archive << FishEngine::make_nvp("m_target", m_target); // GameObjectPtr
+	archive << FishEngine::make_nvp("m_follow", m_follow); // std::shared_ptr<Mover>
+}
+
+void Mover::Deserialize(FishEngine::InputArchive & archive)
+{
+	FishEngine::Script::Deserialize(archive);
+	archive >> FishEngine::make_nvp("m_speed", m_speed); // float
+	archive >> FishEngine::make_nvp("m_count", m_count); // int
+	archive >> FishEngine::make_nvp("m_label", m_label); // std::string
+	archive >> FishEngine::make_nvp("m_target", m_target); // GameObjectPtr
+	archive >> FishEngine::make_nvp("m_follow", m_follow); // std::shared_ptr<Mover>
+}
+
+API FishEngine::Script* CreateCustomScript(const char* className)
+{
+	if (std::string(className) == "Mover")
+		return new Mover();
+	return nullptr;
+}
+
+API void DestroyCustomScript(FishEngine::Script * script)
+{
+	delete script;
+}
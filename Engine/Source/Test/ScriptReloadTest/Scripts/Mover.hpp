@@ -0,0 +1,22 @@
+#pragma once
+
+#include <FishEngine/Script.hpp>
+#include <FishEngine/GameObject.hpp>
+
+// The script of ScriptReloadTest, built into its own library as the scripts of a project are.
+// The test reads the fields directly: it includes this header, the class comes from the library.
+class Mover : public FishEngine::Script
+{
+public:
+	static constexpr const char * StaticClassName() { return "Mover"; }
+	virtual const std::string ClassName() const override { return StaticClassName(); }
+
+	virtual void Serialize(FishEngine::OutputArchive & archive) const override;
+	virtual void Deserialize(FishEngine::InputArchive & archive) override;
+
+	float						m_speed = 1;
+	int							m_count = 0;
+	std::string					m_label;
+	FishEngine::GameObjectPtr	m_target;
+	std::shared_ptr<Mover>		m_follow;
+};
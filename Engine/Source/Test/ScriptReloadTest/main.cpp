@@ -0,0 +1,150 @@
+// ScriptManager::Reload with the library of Scripts/Mover.cpp in place of the build of a project: the live scripts
+// are replaced by instances of the reloaded library, twice, and keep their fields (values, a reference to a
+// GameObject, and a reference to another script, which follows it to its new instance). The copy of a library is
+// unloaded and removed with its last instance; a failed build keeps the loaded scripts.
+
+#include <ScriptManager.hpp>
+#include <PropertyArchive.hpp>
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include "Scripts/Mover.hpp"
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace
+{
+	int s_builds = 0;
+	bool s_buildFails = false;
+	Path s_library;		// where ScriptManager loads the library of the project from
+
+	bool Build(Path const & library)
+	{
+		s_builds++;
+		s_library = library;
+		if (s_buildFails)
+			return false;
+		boost::filesystem::create_directories(library.parent_path());
+		boost::filesystem::remove(library);
+		boost::filesystem::copy_file(SCRIPTS_LIBRARY, library);
+		return true;
+	}
+
+	std::shared_ptr<Mover> FindMover(GameObjectPtr const & go)
+	{
+		for (auto const & c : go->Components())
+		{
+			if (c->ClassName() == Mover::StaticClassName())
+				return std::static_pointer_cast<Mover>(c);
+		}
+		return nullptr;
+	}
+
+	// The copy of the library loaded the version-th time, next to the built one.
+	Path LoadedLibrary(int version)
+	{
+		auto name = s_library.stem().string() + "." + std::to_string(version) + s_library.extension().string();
+		return s_library.parent_path() / "HotReload" / name;
+	}
+
+	void TestReload()
+	{
+		auto & manager = ScriptManager::GetInstance();
+		TEST_CHECK(s_builds == 1);
+		TEST_CHECK(manager.libraryVersion() == 1);
+
+		auto player = Scene::CreateGameObject("Player");
+		auto target = Scene::CreateGameObject("Target");
+		auto a = std::static_pointer_cast<Mover>(manager.CreateScript("Mover"));
+		auto b = std::static_pointer_cast<Mover>(manager.CreateScript("Mover"));
+		TEST_CHECK(a != nullptr && b != nullptr);
+		if (a == nullptr || b == nullptr)
+			return;
+		player->AddComponent(a);
+		target->AddComponent(b);
+		a->m_speed = 2.5f;
+		a->m_count = 7;
+		a->m_label = "first";
+		a->m_target = target;
+		a->m_follow = b;
+		b->m_speed = 4;
+		// the values only: a reference to b would keep the old instance, and its library, alive
+		auto fields = CaptureProperties(*a);
+		for (auto & v : fields)
+			v.references.clear();
+		std::weak_ptr<Mover> old = a;
+		a.reset();
+		b.reset();
+
+		for (int reload = 1; reload <= 2; ++reload)
+		{
+			manager.Reload();
+			TEST_CHECK(s_builds == reload + 1);
+			TEST_CHECK(manager.libraryVersion() == reload + 1);
+
+			a = FindMover(player);
+			b = FindMover(target);
+			TEST_CHECK(a != nullptr && b != nullptr);
+			if (a == nullptr || b == nullptr)
+				return;
+			// a new instance, the old one and its library are gone
+			TEST_CHECK(old.expired());
+			TEST_CHECK(!boost::filesystem::exists(LoadedLibrary(reload)));
+			TEST_CHECK(boost::filesystem::exists(LoadedLibrary(reload + 1)));
+
+			TEST_CHECK(a->m_speed == 2.5f);
+			TEST_CHECK(a->m_count == 7);
+			TEST_CHECK(a->m_label == "first");
+			TEST_CHECK(a->m_target == target);
+			TEST_CHECK(a->m_follow == b);
+			TEST_CHECK(b->m_speed == 4);
+			// all the fields, references to the replaced scripts aside
+			auto reloaded = CaptureProperties(*a);
+			TEST_CHECK(reloaded.size() == fields.size());
+			for (size_t i = 0; i < fields.size() && i < reloaded.size(); ++i)
+				TEST_CHECK(reloaded[i].name == fields[i].name && reloaded[i].data == fields[i].data);
+
+			old = a;
+			a.reset();
+			b.reset();
+		}
+
+		// the build failed: the scripts and their library stay
+		s_buildFails = true;
+		manager.Reload();
+		s_buildFails = false;
+		TEST_CHECK(manager.libraryVersion() == 3);
+		TEST_CHECK(!old.expired());
+		TEST_CHECK(FindMover(player) == old.lock());
+
+		// destroyed with their GameObjects
+		Scene::DestroyImmediate(player);
+		Scene::DestroyImmediate(target);
+		player.reset();
+		target.reset();
+		TEST_CHECK(old.expired());
+	}
+}
+
+int main()
+{
+	// Application::dataPath is only set by the project dialog: empty here, the library of the project is looked
+	// for relative to the working directory, <project>/Assets.
+	auto project = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("ScriptReloadTest-%%%%%%%%");
+	boost::filesystem::create_directories(project / "Assets");
+	boost::filesystem::current_path(project / "Assets");
+
+	ScriptManager::SetBuildFunction(Build);
+	TestReload();
+
+	boost::filesystem::current_path(project.parent_path());
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(project, ec);
+	return FishEngine::Test::Report("ScriptReloadTest");
+}
@@ -0,0 +1,126 @@
+// SearchIndex with 200k entries (150k asset objects in 15k assets, 50k GameObjects): the latency of each keystroke
+// of queries typed one character at a time in an object picker, and the cost of keeping the index up to date.
+
+#include <FishEngine/AnimationClip.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+
+#include <Asset.hpp>
+#include <SearchIndex.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <BenchmarkUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEngine::Test;
+using namespace FishEditor;
+
+namespace
+{
+	const char* const Words[] = { "rock", "tree", "grass", "wall", "door", "lamp", "crate", "barrel", "fence", "roof",
+		"stone", "wood", "metal", "brick", "sand", "water", "cliff", "bush", "flower", "table" };
+	const char* const Suffixes[] = { "diffuse", "normal", "large", "small", "broken", "old", "lod0", "lod1", "run",
+		"idle", "walk", "open", "close", "a", "b" };
+
+	template<size_t N>
+	std::string Pick(std::mt19937 & random, const char* const (&words)[N])
+	{
+		return words[std::uniform_int_distribution<size_t>(0, N - 1)(random)];
+	}
+
+	std::string RandomName(std::mt19937 & random, int i)
+	{
+		return Pick(random, Words) + "_" + Pick(random, Suffixes) + "_" + std::to_string(i);
+	}
+
+	// Types the query one character at a time; prints the mean and the slowest keystroke.
+	void Type(std::string const & query, int classID = SearchIndex::AnyClass)
+	{
+		double total = 0;
+		double slowest = 0;
+		size_t results = 0;
+		Stopwatch stopwatch;
+		for (size_t length = 1; length <= query.size(); ++length)
+		{
+			stopwatch.Restart();
+			results = SearchIndex::Search(query.substr(0, length), classID).size();
+			double milliseconds = stopwatch.milliseconds();
+			total += milliseconds;
+			slowest = std::max(slowest, milliseconds);
+		}
+		std::string name = "type \"" + query + "\"" + (classID == SearchIndex::AnyClass ? "" : " (picker filter)") +
+			", " + std::to_string(results) + " results";
+		PrintMeasurement((name + ", mean per key").c_str(), total / query.size(), "ms");
+		PrintMeasurement((name + ", slowest key").c_str(), slowest, "ms");
+	}
+}
+
+int main()
+{
+	std::mt19937 random(1);
+	SearchIndex::Init();
+
+	Stopwatch stopwatch;
+	for (int i = 0; i < 50000; ++i)
+		Scene::CreateGameObject(RandomName(random, i));
+	PrintMeasurement("create 50k GameObjects, indexed as created", stopwatch.milliseconds(), "ms");
+
+	// the index only keeps weak references: the assets are held as the AssetDatabase would
+	std::vector<AssetPtr> assets;
+	stopwatch.Restart();
+	for (int a = 0; a < 15000; ++a)
+	{
+		auto asset = std::make_shared<Asset>();
+		assets.push_back(asset);
+		for (int i = 0; i < 10; ++i)
+		{
+			auto clip = std::make_shared<AnimationClip>();
+			clip->setName(RandomName(random, a * 10 + i));
+			asset->Add(clip);
+		}
+		SearchIndex::AddAsset(asset, "Assets/" + Pick(random, Words) + "/" + std::to_string(a) + ".fbx");
+	}
+	PrintMeasurement("index 150k asset objects (15k imports)", stopwatch.milliseconds(), "ms");
+	PrintMeasurement("entries", static_cast<double>(SearchIndex::entryCount()), "");
+
+	Type("barrel_broken");
+	Type("brl");				// short terms: name prefixes only
+	Type("barel brokn");		// typos, through the trigrams
+	Type("lamp t:AnimationClip");
+	Type("crate_lod1", ClassID<GameObject>());
+	Type("zzzz");				// no match
+
+	// half of the assets unloaded: their entries expire, and the next search drops the ones it meets
+	assets.resize(assets.size() / 2);
+	stopwatch.Restart();
+	SearchIndex::Search("rock");
+	PrintMeasurement("first search after 7500 assets unloaded", stopwatch.milliseconds(), "ms");
+	PrintMeasurement("entries", static_cast<double>(SearchIndex::entryCount()), "");
+
+	// kept up to date while the scene is edited
+	auto go = Scene::Find("rock_large_7");
+	if (go == nullptr)
+		go = Scene::CreateGameObject("rock_large_7");
+	stopwatch.Restart();
+	const int renames = 10000;
+	for (int i = 0; i < renames; ++i)
+		go->setName(RandomName(random, i));
+	PrintMeasurement("rename an indexed GameObject", stopwatch.milliseconds() * 1000 / renames, "us");
+
+	stopwatch.Restart();
+	auto reimported = std::make_shared<Asset>();
+	for (int i = 0; i < 10; ++i)
+	{
+		auto clip = std::make_shared<AnimationClip>();
+		clip->setName(RandomName(random, i));
+		reimported->Add(clip);
+	}
+	SearchIndex::AddAsset(reimported, "Assets/rock/7.fbx");
+	assets.push_back(reimported);
+	PrintMeasurement("reimport an asset of 10 objects", stopwatch.milliseconds(), "ms");
+	return 0;
+}
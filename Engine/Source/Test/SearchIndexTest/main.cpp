@@ -0,0 +1,152 @@
+// SearchIndex: the index follows the scene (created, renamed, destroyed GameObjects) and the reimported assets;
+// queries rank exact > prefix > word prefix > substring > path > typo, and filter by type.
+
+#include <FishEngine/AnimationClip.hpp>
+#include <FishEngine/AudioClip.hpp>
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+
+#include <Asset.hpp>
+#include <SearchIndex.hpp>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace
+{
+	std::vector<std::string> Names(std::vector<SearchIndex::Result> const & results)
+	{
+		std::vector<std::string> names;
+		for (auto const & r : results)
+			names.push_back(r.object->name());
+		return names;
+	}
+
+	typedef std::vector<std::string> Strings;
+
+	void TestRanking()
+	{
+		// indexed by Init (they exist before) or by the Created notifications
+		auto camera = Scene::CreateGameObject("Main Camera");
+		SearchIndex::Init();
+		Scene::CreateGameObject("Rock01");
+		Scene::CreateGameObject("RockLarge");
+		Scene::CreateGameObject("LargeRock");
+		Scene::CreateGameObject("Bedrock");
+		TEST_CHECK(SearchIndex::entryCount() == 5);
+
+		// prefix (the shortest first), word prefix, substring
+		TEST_CHECK(Names(SearchIndex::Search("rock")) == (Strings{ "Rock01", "RockLarge", "LargeRock", "Bedrock" }));
+		// LargeRock has 5 of the 7 trigrams: a typo
+		TEST_CHECK(Names(SearchIndex::Search("ROCKLARGE")) == (Strings{ "RockLarge", "LargeRock" }));
+		auto exact = SearchIndex::Search("rocklarge");
+		TEST_CHECK(exact.size() == 2 && exact[0].score == 1000 && exact[0].isSceneObject && exact[1].score < 200);
+
+		// all terms must match; quotes make one term
+		TEST_CHECK(Names(SearchIndex::Search("main camera")) == (Strings{ "Main Camera" }));
+		TEST_CHECK(Names(SearchIndex::Search("\"main camera\"")) == (Strings{ "Main Camera" }));
+		auto reversed = SearchIndex::Search("\"camera main\"");
+		TEST_CHECK(reversed.size() == 1 && reversed[0].score < 200);	// only as a typo
+		TEST_CHECK(SearchIndex::Search("main rock").empty());
+
+		// a typo: 3 of the 4 trigrams
+		TEST_CHECK(Names(SearchIndex::Search("camerz")) == (Strings{ "Main Camera" }));
+		TEST_CHECK(SearchIndex::Search("cxmxrx").empty());
+
+		// short terms only match the beginning of names
+		TEST_CHECK(Names(SearchIndex::Search("ma")) == (Strings{ "Main Camera" }));
+		TEST_CHECK(SearchIndex::Search("ca").empty());
+
+		// at most limit results, the best ones
+		TEST_CHECK(Names(SearchIndex::Search("rock", SearchIndex::AnyClass, 2)) == (Strings{ "Rock01", "RockLarge" }));
+		TEST_CHECK(SearchIndex::Search("").size() == 5);
+	}
+
+	void TestSceneChanges()
+	{
+		auto tree = Scene::CreateGameObject("Tree");
+		TEST_CHECK(Names(SearchIndex::Search("tree")) == (Strings{ "Tree" }));
+		auto count = SearchIndex::entryCount();
+
+		tree->setName("Oak");
+		TEST_CHECK(SearchIndex::Search("tree").empty());
+		TEST_CHECK(Names(SearchIndex::Search("oak")) == (Strings{ "Oak" }));
+		TEST_CHECK(SearchIndex::entryCount() == count);
+
+		// with its children
+		auto branch = Scene::CreateGameObject("Oak Branch");
+		branch->transform()->SetParent(tree->transform());
+		TEST_CHECK(SearchIndex::Search("oak").size() == 2);
+		Scene::DestroyImmediate(tree);
+		TEST_CHECK(SearchIndex::Search("oak").empty());
+		TEST_CHECK(SearchIndex::entryCount() == count - 1);
+	}
+
+	void TestTypes()
+	{
+		auto speaker = Scene::CreateGameObject("Speaker");
+		speaker->AddComponent<AudioSource>();
+
+		// components added after the GameObject was indexed
+		TEST_CHECK(Names(SearchIndex::Search("t:AudioSource")) == (Strings{ "Speaker" }));
+		TEST_CHECK(Names(SearchIndex::Search("spea t:audiosource")) == (Strings{ "Speaker" }));
+		TEST_CHECK(SearchIndex::Search("rock t:AudioSource").empty());
+		// every GameObject has a Transform
+		TEST_CHECK(SearchIndex::Search("t:Transform").size() == SearchIndex::entryCount());
+		TEST_CHECK(SearchIndex::Search("t:NoSuchClass").empty());
+
+		TEST_CHECK(Names(SearchIndex::Search("speaker", ClassID<GameObject>())) == (Strings{ "Speaker" }));
+		TEST_CHECK(SearchIndex::Search("speaker", ClassID<AudioClip>()).empty());
+		Scene::DestroyImmediate(speaker);
+	}
+
+	void TestAssets()
+	{
+		auto count = SearchIndex::entryCount();
+		auto asset = std::make_shared<Asset>();
+		auto clip = std::make_shared<AudioClip>();
+		clip->setName("Explosion");
+		auto animation = std::make_shared<AnimationClip>();
+		animation->setName("Explode");
+		asset->Add(clip);
+		asset->Add(animation);
+		SearchIndex::AddAsset(asset, "Sounds/Boom.wav");
+		TEST_CHECK(SearchIndex::entryCount() == count + 2);
+
+		TEST_CHECK(Names(SearchIndex::Search("expl")) == (Strings{ "Explode", "Explosion" }));
+		TEST_CHECK(Names(SearchIndex::Search("expl t:AudioClip")) == (Strings{ "Explosion" }));
+		TEST_CHECK(Names(SearchIndex::Search("expl", ClassID<AnimationClip>())) == (Strings{ "Explode" }));
+		TEST_CHECK(Names(SearchIndex::Search("", ClassID<Motion>())) == (Strings{ "Explode" }));
+		// by path, below the names
+		auto byPath = SearchIndex::Search("sounds");
+		TEST_CHECK(byPath.size() == 2 && byPath[0].score == 200 && !byPath[0].isSceneObject);
+
+		// reimported: the old objects are replaced
+		auto reimported = std::make_shared<Asset>();
+		auto newClip = std::make_shared<AudioClip>();
+		newClip->setName("Blast");
+		reimported->Add(newClip);
+		SearchIndex::AddAsset(reimported, "Sounds/Boom.wav");
+		TEST_CHECK(SearchIndex::entryCount() == count + 1);
+		TEST_CHECK(SearchIndex::Search("expl").empty());
+		TEST_CHECK(Names(SearchIndex::Search("blast")) == (Strings{ "Blast" }));
+
+		// unloaded without a notification: dropped by the next query that meets it
+		reimported.reset();
+		newClip.reset();
+		TEST_CHECK(SearchIndex::Search("blast").empty());
+		TEST_CHECK(SearchIndex::entryCount() == count);
+	}
+}
+
+int main()
+{
+	TestRanking();
+	TestSceneChanges();
+	TestTypes();
+	TestAssets();
+	return FishEngine::Test::Report("SearchIndexTest");
+}
@@ -0,0 +1,296 @@
+// The offline shader check: ShaderReflection (the GLSL preprocessor and the declarations it collects), the stage
+// sources of the keyword variants, and the compiler messages located back in the original files. Every stage of
+// every keyword variant of the built-in shaders (Engine/Shaders) is reflected without errors.
+
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/Render/Shader/ShaderReflection.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+namespace fs = boost::filesystem;
+
+namespace
+{
+	ShaderReflection::Variable const * Find(std::vector<ShaderReflection::Variable> const & variables, std::string const & name)
+	{
+		auto it = std::find_if(variables.begin(), variables.end(),
+			[&name](ShaderReflection::Variable const & v) { return v.name == name; });
+		return it == variables.end() ? nullptr : &*it;
+	}
+
+	void TestDeclarations()
+	{
+		auto source =
+			"#version 410 core\n"
+			"#define VERTEX_SHADER\n"
+			"#define MAX_BONES (16 * 4)\n"
+			"#define DECLARE_COLOR(name) uniform vec4 name\n"
+			"layout(location = 0) in vec3 InputPosition;\n"
+			"layout(location = 2) in vec2 InputUV;\n"
+			"uniform mat4 MATRIX_MVP, MATRIX_M;  // two in one declaration\n"
+			"uniform mat4 BoneTransformations[MAX_BONES];\n"
+			"DECLARE_COLOR(_Color);\n"
+			"uniform float _Cutoff = 0.5;\n"
+			"/* uniform float Commented; */\n"
+			"#if MAX_BONES > 100\n"
+			"uniform float Inactive;\n"
+			"#elif defined(VERTEX_SHADER) && !defined(FRAGMENT_SHADER)\n"
+			"uniform float Active;\n"
+			"#endif\n"
+			"layout(std140) uniform PerDraw\n"
+			"{\n"
+			"	mat4 MATRIX_V;\n"
+			"	vec4 LightPos[2];\n"
+			"} perDraw;\n"
+			"struct Light { vec3 color; };\n"
+			"uniform Light MainLight;\n"
+			"out vec2 uv;\n"
+			"void main() { float local = 1.0; uv = InputUV; gl_Position = MATRIX_MVP * vec4(InputPosition, local); }\n";
+		auto r = ShaderReflection::Reflect(source, ShaderType::VertexShader);
+		TEST_CHECK(r.errors.empty());
+
+		TEST_CHECK(r.attributes.size() == 2);
+		auto position = Find(r.attributes, "InputPosition");
+		TEST_CHECK(position != nullptr && position->type == GL_FLOAT_VEC3 && position->location == 0);
+		auto uv = Find(r.attributes, "InputUV");
+		TEST_CHECK(uv != nullptr && uv->location == 2);
+		TEST_CHECK(Find(r.attributes, "uv") == nullptr);	// an output
+
+		TEST_CHECK(Find(r.uniforms, "MATRIX_MVP") != nullptr && Find(r.uniforms, "MATRIX_M") != nullptr);
+		auto bones = Find(r.uniforms, "BoneTransformations");
+		TEST_CHECK(bones != nullptr && bones->type == GL_FLOAT_MAT4 && bones->arraySize == 64);
+		auto color = Find(r.uniforms, "_Color");
+		TEST_CHECK(color != nullptr && color->type == GL_FLOAT_VEC4);
+		TEST_CHECK(Find(r.uniforms, "_Cutoff") != nullptr);
+		TEST_CHECK(Find(r.uniforms, "Commented") == nullptr);
+		TEST_CHECK(Find(r.uniforms, "Inactive") == nullptr);
+		TEST_CHECK(Find(r.uniforms, "Active") != nullptr);
+		TEST_CHECK(Find(r.uniforms, "local") == nullptr);
+		auto light = Find(r.uniforms, "MainLight");
+		TEST_CHECK(light != nullptr && light->type == 0 && light->typeName == "Light");
+		TEST_CHECK(r.uniforms.size() == 7);
+
+		TEST_CHECK(r.blocks.size() == 1);
+		if (r.blocks.size() == 1)
+		{
+			TEST_CHECK(r.blocks[0].name == "PerDraw");
+			TEST_CHECK(r.blocks[0].members.size() == 2);
+			auto lightPos = Find(r.blocks[0].members, "LightPos");
+			TEST_CHECK(lightPos != nullptr && lightPos->arraySize == 2);
+		}
+
+		// the inputs of the other stages are not vertex attributes
+		auto fragment = ShaderReflection::Reflect("in vec2 uv;\nuniform sampler2D _MainTex;\n", ShaderType::FragmentShader);
+		TEST_CHECK(fragment.attributes.empty());
+		TEST_CHECK(fragment.uniforms.size() == 1 && fragment.uniforms[0].type == GL_SAMPLER_2D);
+
+		// merged by name, one declaration per line, sorted
+		fragment.Merge(r);
+		TEST_CHECK(fragment.uniforms.size() == 8);
+		TEST_CHECK(fragment.attributes.size() == 2);
+		auto merged = ShaderReflection::Reflect("uniform vec4 _Color;\nuniform sampler2D _MainTex;\n", ShaderType::FragmentShader);
+		merged.Merge(ShaderReflection::Reflect("uniform vec4 _Color;\nin vec3 p;\n", ShaderType::VertexShader));
+		TEST_CHECK(merged.ToString() == "in vec3 p\nuniform sampler2D _MainTex\nuniform vec4 _Color\n");
+		TEST_CHECK(ShaderReflection::Reflect("layout(location = 1) in vec3 n;\n", ShaderType::VertexShader).ToString()
+			== "in vec3 n (location 1)\n");
+	}
+
+	void TestErrors()
+	{
+		// located with the #line directives
+		auto r = ShaderReflection::Reflect("#line 10\n#if 1\n#error too many lights\n#endif\n", ShaderType::FragmentShader);
+		TEST_CHECK(r.errors.size() == 1);
+		if (r.errors.size() == 1)
+		{
+			TEST_CHECK(r.errors[0].line == 11);
+			TEST_CHECK(r.errors[0].message == "#error too many lights");
+			TEST_CHECK(r.errors[0].file.empty());	// generated by the engine
+		}
+		// inactive
+		TEST_CHECK(ShaderReflection::Reflect("#ifdef NOT_DEFINED\n#error no\n#endif\n", ShaderType::VertexShader).errors.empty());
+
+		r = ShaderReflection::Reflect("#ifdef A\nuniform float a;\n", ShaderType::VertexShader);
+		TEST_CHECK(r.errors.size() == 1 && r.errors[0].message == "unterminated #if");
+		r = ShaderReflection::Reflect("#endif\n", ShaderType::VertexShader);
+		TEST_CHECK(r.errors.size() == 1 && r.errors[0].line == 1);
+	}
+
+	void TestKeywordVariants()
+	{
+		auto variants = ShaderCompiler::KeywordVariants();
+		auto all = static_cast<ShaderKeywords>(ShaderKeyword::All);
+		// every subset of ShaderKeyword::All, once
+		size_t count = 1;
+		for (auto bits = all; bits != 0; bits &= bits - 1)
+			count *= 2;
+		TEST_CHECK(variants.size() == count);
+		TEST_CHECK(std::find(variants.begin(), variants.end(), 0u) != variants.end());
+		TEST_CHECK(std::find(variants.begin(), variants.end(), all) != variants.end());
+		for (auto v : variants)
+		{
+			TEST_CHECK((v & ~all) == 0);
+			TEST_CHECK(std::count(variants.begin(), variants.end(), v) == 1);
+		}
+
+		// the stage and the keywords are macros, after #version
+		auto ibl = static_cast<ShaderKeywords>(ShaderKeyword::AmbientIBL);
+		auto source = ShaderCompiler::StageSource("uniform float x;\n", ShaderType::FragmentShader, ibl);
+		TEST_CHECK(source.compare(0, 18, "#version 410 core\n") == 0);
+		TEST_CHECK(source.find("#define FRAGMENT_SHADER\n") != std::string::npos);
+		TEST_CHECK(source.find("#define VERTEX_SHADER\n") == std::string::npos);
+		TEST_CHECK(source.find("#define _AMBIENT_IBL\n") != std::string::npos);
+		source = ShaderCompiler::StageSource("", ShaderType::GeometryShader, 0);
+		TEST_CHECK(source.find("#define GEOMETRY_SHADER\n") != std::string::npos);
+		TEST_CHECK(source.find("_AMBIENT_IBL") == std::string::npos);
+	}
+
+	void TestShaderFile(fs::path const & dir)
+	{
+		std::ofstream((dir / "Common.inc").string()) << "uniform vec4 CommonColor;\n";
+		std::ofstream((dir / "Test.shader").string()) <<
+			"@vertex\n"								// 1
+			"{\n"									// 2
+			"	#include \"Common.inc\"\n"			// 3
+			"	layout(location = 0) in vec3 InputPosition;\n"
+			"	void main() { gl_Position = vec4(InputPosition, 1); }\n"
+			"}\n"									// 6
+			"@fragment\n"							// 7
+			"{\n"									// 8
+			"	uniform vec4 _Color;\n"				// 9
+			"	#ifdef _AMBIENT_IBL\n"				// 10
+			"	uniform samplerCube AmbientCubemap;\n"
+			"	#error no IBL yet\n"				// 12
+			"	#endif\n"
+			"	out vec4 color;\n"
+			"	void main() { color = _Color; }\n"
+			"}\n";
+		ShaderCompiler compiler(dir / "Test.shader");
+		auto preprocessed = compiler.Preprocess();
+
+		auto vertex = ShaderReflection::Reflect(
+			ShaderCompiler::StageSource(preprocessed, ShaderType::VertexShader, 0), ShaderType::VertexShader);
+		TEST_CHECK(vertex.errors.empty());
+		TEST_CHECK(vertex.uniforms.size() == 1 && Find(vertex.uniforms, "CommonColor") != nullptr);
+		TEST_CHECK(vertex.attributes.size() == 1 && Find(vertex.attributes, "InputPosition") != nullptr);
+
+		auto fragment = ShaderReflection::Reflect(
+			ShaderCompiler::StageSource(preprocessed, ShaderType::FragmentShader, 0), ShaderType::FragmentShader);
+		TEST_CHECK(fragment.errors.empty());
+		TEST_CHECK(fragment.uniforms.size() == 1 && Find(fragment.uniforms, "_Color") != nullptr);
+
+		// the variant with the keyword: reported in the shader file, at its line
+		auto ibl = static_cast<ShaderKeywords>(ShaderKeyword::AmbientIBL);
+		fragment = ShaderReflection::Reflect(
+			ShaderCompiler::StageSource(preprocessed, ShaderType::FragmentShader, ibl), ShaderType::FragmentShader);
+		TEST_CHECK(fragment.uniforms.size() == 2 && Find(fragment.uniforms, "AmbientCubemap") != nullptr);
+		TEST_CHECK(fragment.errors.size() == 1);
+		if (fragment.errors.size() == 1)
+		{
+			TEST_CHECK(fragment.errors[0].file == fs::absolute(dir / "Test.shader"));
+			TEST_CHECK(fragment.errors[0].line == 12);
+		}
+
+		// a compiler log: the file index is the one of the #line directives
+		auto directive = preprocessed.find("#line 1 ");
+		TEST_CHECK(directive != std::string::npos);
+		if (directive == std::string::npos)
+			return;
+		auto index = std::stoi(preprocessed.substr(directive + 8));
+		auto log =
+			"ERROR: " + std::to_string(index) + ":9: 'x' : undeclared identifier\r\n"
+			"0:3(12): error: syntax error\n"
+			+ std::to_string(index) + "(15) : error C1008: undefined variable\n"
+			"\n"
+			"ERROR: 2 compilation errors.  No code generated.\n";
+		auto diagnostics = ShaderCompiler::MapDiagnostics(log);
+		TEST_CHECK(diagnostics.size() == 4);
+		if (diagnostics.size() != 4)
+			return;
+		TEST_CHECK(diagnostics[0].file == fs::absolute(dir / "Test.shader"));
+		TEST_CHECK(diagnostics[0].line == 9);
+		TEST_CHECK(diagnostics[0].message == "'x' : undeclared identifier");
+		TEST_CHECK(diagnostics[1].file.empty() && diagnostics[1].line == 3);	// generated by the engine
+		TEST_CHECK(diagnostics[2].file == diagnostics[0].file && diagnostics[2].line == 15);
+		TEST_CHECK(diagnostics[2].message == "error C1008: undefined variable");
+		TEST_CHECK(diagnostics[3].file.empty() && diagnostics[3].line == 0);	// not located, kept
+		TEST_CHECK(ShaderCompiler::SourcePath(1000).empty());
+	}
+
+	// The check, and the file it is about.
+	void CheckShader(bool passed, std::string const & message)
+	{
+		FishEngine::Test::Check(passed, message.c_str(), __FILE__, __LINE__);
+	}
+
+	// The runtime takes the uniforms of a program from the reflection (Shader.cpp): every built-in shader must go
+	// through it.
+	void TestBuiltinShaders(fs::path const & root)
+	{
+		ShaderCompiler::setShaderIncludeDir((root / "include").string());
+		std::vector<fs::path> files;
+		for (auto const & dir : { root, root / "Editor" })
+		{
+			for (auto & entry : fs::directory_iterator(dir))
+			{
+				auto ext = entry.path().extension();
+				if (ext == ".shader" || ext == ".surf")
+					files.push_back(entry.path());
+			}
+		}
+		std::sort(files.begin(), files.end());
+		TEST_CHECK(files.size() >= 30);
+
+		for (auto const & path : files)
+		{
+			std::string preprocessed;
+			bool hasGeometryShader = false;
+			try
+			{
+				ShaderCompiler compiler(path);
+				preprocessed = compiler.Preprocess();
+				hasGeometryShader = compiler.m_hasGeometryShader;
+			}
+			catch (std::exception const & e)
+			{
+				CheckShader(false, path.string() + ": " + e.what());
+				continue;
+			}
+
+			for (auto keywords : ShaderCompiler::KeywordVariants())
+			{
+				std::vector<ShaderType> stages = { ShaderType::VertexShader, ShaderType::FragmentShader };
+				if (hasGeometryShader)
+					stages.push_back(ShaderType::GeometryShader);
+				ShaderReflection program;
+				for (auto stage : stages)
+				{
+					auto r = ShaderReflection::Reflect(ShaderCompiler::StageSource(preprocessed, stage, keywords), stage);
+					for (auto const & e : r.errors)
+						CheckShader(false, path.string() + ": " + e.message);
+					program.Merge(r);
+				}
+				CheckShader(!program.attributes.empty(), path.string() + ": no vertex input");
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestDeclarations();
+	TestErrors();
+	TestKeywordVariants();
+
+	auto dir = fs::temp_directory_path() / fs::unique_path("ShaderReflectionTest-%%%%-%%%%-%%%%");
+	fs::create_directories(dir);
+	TestShaderFile(dir);
+	fs::remove_all(dir);
+
+	TestBuiltinShaders(FISHENGINE_SHADER_DIR);
+	return FishEngine::Test::Report("ShaderReflectionTest");
+}
@@ -0,0 +1,177 @@
+// ShaderVariantCollection: the set of variants, its text file (keywords by their macro names, unknown ones
+// skipped), the recording gate, and with a GL context the warm up: variants whose shader is not loaded, and a
+// variant of SolidColor compiled before it is drawn, the draw-time compile counters.
+
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/ShaderVariantCollection.hpp>
+
+#include <GLTestContext.hpp>
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+namespace fs = boost::filesystem;
+
+namespace
+{
+	const ShaderKeywords IBL = static_cast<ShaderKeywords>(ShaderKeyword::AmbientIBL);
+
+	void TestSet()
+	{
+		ShaderVariantCollection c;
+		TEST_CHECK(c.Add("PBR", 0));
+		TEST_CHECK(!c.Add("PBR", 0));
+		TEST_CHECK(c.Add("PBR", IBL));
+		TEST_CHECK(c.Add("Diffuse", 0));
+		TEST_CHECK(c.size() == 3);
+		TEST_CHECK(c.Contains("PBR", IBL) && !c.Contains("Diffuse", IBL));
+		// sorted by shader, then keywords
+		TEST_CHECK(c.variants().begin()->shader == "Diffuse");
+		TEST_CHECK(std::prev(c.variants().end())->keywords == IBL);
+
+		ShaderVariantCollection d;
+		d.Add("PBR", IBL);
+		d.Add("Unlit", 0);
+		TEST_CHECK(c.Merge(d) == 1);
+		TEST_CHECK(c.size() == 4 && d.size() == 2);
+		TEST_CHECK(c.Merge(d) == 0);
+		c.Clear();
+		TEST_CHECK(c.size() == 0);
+	}
+
+	void TestText()
+	{
+		ShaderVariantCollection c;
+		c.Add("PBR", 0);
+		c.Add("PBR", IBL);
+		auto text = c.ToString();
+		TEST_CHECK(text.find("PBR\t_AMBIENT_IBL\n") != std::string::npos);
+		TEST_CHECK(text.find("PBR\n") != std::string::npos);
+
+		ShaderVariantCollection d;
+		d.Parse(text);
+		TEST_CHECK(d.variants() == c.variants());
+
+		// comments, blank lines and spaces around the fields; a keyword the engine no longer has drops the line
+		ShaderVariantCollection e;
+		e.Parse("# comment\n\n  Diffuse\t\t_AMBIENT_IBL  \r\nFoo\t_UNKNOWN\nFoo\t_AMBIENT_IBL\t_UNKNOWN\nBar\n");
+		TEST_CHECK(e.size() == 2);
+		TEST_CHECK(e.Contains("Diffuse", IBL) && e.Contains("Bar", 0));
+		TEST_CHECK(!e.Contains("Foo", 0) && !e.Contains("Foo", IBL));
+	}
+
+	void TestFile(fs::path const & dir)
+	{
+		ShaderVariantCollection c;
+		c.Add("PBR", IBL);
+		c.Add("Diffuse", 0);
+		TEST_CHECK(c.Save(dir / "a.shadervariants"));
+
+		// Load merges
+		ShaderVariantCollection d;
+		d.Add("Other", 0);
+		TEST_CHECK(d.Load(dir / "a.shadervariants"));
+		TEST_CHECK(d.size() == 3 && d.Contains("PBR", IBL) && d.Contains("Other", 0));
+		TEST_CHECK(!d.Load(dir / "missing.shadervariants"));
+		TEST_CHECK(d.size() == 3);
+		TEST_CHECK(!c.Save(dir / "missing" / "a.shadervariants"));
+	}
+
+	void TestRecording()
+	{
+		ShaderVariantCollection::Record("X", 0);
+		TEST_CHECK(!ShaderVariantCollection::isRecording());
+		TEST_CHECK(ShaderVariantCollection::recorded().size() == 0);
+
+		ShaderVariantCollection::StartRecording();
+		ShaderVariantCollection::Record("X", 0);
+		ShaderVariantCollection::Record("X", 0);
+		ShaderVariantCollection::Record("X", IBL);
+		ShaderVariantCollection::Record("", 0);		// a shader without a name can not be found again
+		ShaderVariantCollection::StopRecording();
+		ShaderVariantCollection::Record("Y", 0);
+		TEST_CHECK(ShaderVariantCollection::recorded().size() == 2);
+		TEST_CHECK(!ShaderVariantCollection::recorded().Contains("Y", 0));
+
+		// a new session starts empty
+		ShaderVariantCollection::StartRecording();
+		TEST_CHECK(ShaderVariantCollection::recorded().size() == 0);
+		ShaderVariantCollection::StopRecording();
+	}
+
+	void TestWarmUp()
+	{
+		ShaderVariantCollection empty;
+		ShaderWarmUp nothing(empty);
+		TEST_CHECK(nothing.done() && nothing.progress() == 1);
+		TEST_CHECK(nothing.Update(1));
+
+		// no shader is loaded: every variant is missing, nothing to compile
+		ShaderVariantCollection c;
+		c.Add("NotLoaded", 0);
+		c.Add("NotLoaded", IBL);
+		ShaderWarmUp warmUp(c);
+		TEST_CHECK(warmUp.missingCount() == 2);
+		TEST_CHECK(warmUp.variantCount() == 0);
+		TEST_CHECK(warmUp.Update(1));
+		warmUp.Finish();
+		TEST_CHECK(warmUp.failedCount() == 0);
+	}
+
+	// a warmed up variant is not compiled again when it is selected, one outside the collection is, once
+	void TestCompile()
+	{
+		Path shaders = FISHENGINE_SHADER_DIR;
+		ShaderCompiler::setShaderIncludeDir((shaders / "include").string());
+		auto shader = Shader::CreateFromFile(shaders / "SolidColor.shader");
+		TEST_CHECK(shader != nullptr);
+		shader->setName("SolidColor");
+
+		ShaderVariantCollection c;
+		c.Add("SolidColor", 0);
+		ShaderWarmUp warmUp(c);
+		TEST_CHECK(warmUp.variantCount() == 1 && warmUp.missingCount() == 0);
+		while (!warmUp.Update(8))
+		{
+		}
+		warmUp.Finish();
+		TEST_CHECK(warmUp.done() && warmUp.failedCount() == 0);
+		// kept: nothing to start again
+		TEST_CHECK(!shader->StartCompileVariant(0));
+		TEST_CHECK(shader->FinishCompileVariant(0));
+
+		Shader::ResetDrawTimeCompileStatistics();
+		shader->DisableLocalKeywords(IBL);
+		TEST_CHECK(Shader::drawTimeCompileCount() == 0);
+		shader->EnableLocalKeywords(IBL);
+		TEST_CHECK(Shader::drawTimeCompileCount() == 1);
+		TEST_CHECK(Shader::drawTimeCompileMilliseconds() > 0);
+		shader->DisableLocalKeywords(IBL);
+		shader->EnableLocalKeywords(IBL);
+		TEST_CHECK(Shader::drawTimeCompileCount() == 1);
+
+		Shader::ResetDrawTimeCompileStatistics();
+		TEST_CHECK(Shader::drawTimeCompileCount() == 0 && Shader::drawTimeCompileMilliseconds() == 0);
+	}
+}
+
+int main()
+{
+	TestSet();
+	TestText();
+	TestRecording();
+
+	auto dir = fs::temp_directory_path() / fs::unique_path("ShaderVariantCollectionTest-%%%%-%%%%-%%%%");
+	fs::create_directories(dir);
+	TestFile(dir);
+	fs::remove_all(dir);
+
+	if (FishEngine::Test::CreateGLContext())
+	{
+		TestWarmUp();
+		TestCompile();
+	}
+	else
+		FishEngine::Test::Skip("ShaderVariantCollectionTest");
+	return FishEngine::Test::Report("ShaderVariantCollectionTest");
+}
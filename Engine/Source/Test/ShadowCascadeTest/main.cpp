@@ -0,0 +1,221 @@
+// ShadowCascadeUtility: the splits, the light space, and the cascades fitted to the receivers of their split: they
+// cover them, reach the casters in front of them, and are snapped and quantized so that a moving camera only shifts
+// them by whole texels.
+
+#include <FishEngine/Mathf.hpp>
+#include <FishEngine/ShadowCascadeUtility.hpp>
+
+#include <random>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	// The corners of the split [near, far] of a camera at eye looking along +z, 90 degrees of field of view.
+	void SplitCorners(Vector3 const & eye, float near, float far, Vector3 corners[8])
+	{
+		int i = 0;
+		for (float z : { near, far })
+		{
+			for (float x : { -1.0f, 1.0f })
+			{
+				for (float y : { -1.0f, 1.0f })
+					corners[i++] = eye + Vector3(x * z, y * z, z);
+			}
+		}
+	}
+
+	bool Covers(ShadowCascadeUtility::Cascade const & c, Vector3 const & min, Vector3 const & max)
+	{
+		const float e = 1e-4f;
+		return c.min.x <= min.x + e && c.min.y <= min.y + e && c.max.x >= max.x - e && c.max.y >= max.y - e
+			&& c.near <= min.z + e && c.far >= max.z - e;
+	}
+
+	void TestSplits()
+	{
+		float splits[5];
+		ShadowCascadeUtility::ComputeSplits(1, 1000, 4, ShadowCascadeUtility::SplitLambda, splits);
+		TEST_CHECK(splits[0] == 1 && splits[4] == 1000);
+		TEST_CHECK(splits[0] < splits[1] && splits[1] < splits[2] && splits[2] < splits[3] && splits[3] < splits[4]);
+
+		ShadowCascadeUtility::ComputeSplits(1, 1000, 3, 0, splits);
+		TEST_CHECK_NEAR(splits[1], 334, 1e-2f);
+		TEST_CHECK_NEAR(splits[2], 667, 1e-2f);
+		TEST_CHECK(splits[3] == 1000);
+		ShadowCascadeUtility::ComputeSplits(1, 1000, 3, 1, splits);
+		TEST_CHECK_NEAR(splits[1], 10, 1e-3f);
+		TEST_CHECK_NEAR(splits[2], 100, 1e-2f);
+
+		ShadowCascadeUtility::ComputeSplits(2, 50, 1, 0.5f, splits);
+		TEST_CHECK(splits[0] == 2 && splits[1] == 50);
+	}
+
+	void TestLightSpace()
+	{
+		for (auto direction : { Vector3(1, -2, 0.5f), Vector3(0, -1, 0), Vector3(0, 1, 0), Vector3(0, 0, 1) })
+		{
+			direction.Normalize();
+			auto m = ShadowCascadeUtility::WorldToLight(direction);
+			auto z = m.MultiplyVector(direction);
+			TEST_CHECK((z - Vector3(0, 0, 1)).magnitude() < 1e-4f);
+			// a rotation, without translation
+			TEST_CHECK(m.MultiplyPoint(Vector3::zero).magnitude() < 1e-5f);
+			TEST_CHECK_NEAR(m.MultiplyVector(Vector3(3, 4, 12)).magnitude(), 13, 1e-4f);
+		}
+
+		// the box around the transformed corners, not larger
+		std::mt19937 random(4);
+		std::uniform_real_distribution<float> u(-5, 5);
+		auto m = Matrix4x4::TRS(Vector3(1, 2, 3), Quaternion::Euler(30, 150, 40), Vector3(1, 2, 0.5f));
+		int outside = 0;
+		float slack = 0;
+		for (int i = 0; i < 100; ++i)
+		{
+			Bounds b(Vector3(u(random), u(random), u(random)), Vector3(u(random) + 5, u(random) + 5, u(random) + 5));
+			auto t = ShadowCascadeUtility::TransformBounds(m, b);
+			Bounds corners;
+			for (int k = 0; k < 8; ++k)
+			{
+				Vector3 corner(k & 1 ? b.max().x : b.min().x, k & 2 ? b.max().y : b.min().y, k & 4 ? b.max().z : b.min().z);
+				auto p = m.MultiplyPoint(corner);
+				outside += (Vector3::Max(p, t.max()) - t.max()).magnitude() > 1e-3f || (t.min() - Vector3::Min(p, t.min())).magnitude() > 1e-3f;
+				corners.Encapsulate(p);
+			}
+			slack = std::max(slack, (corners.size() - t.size()).magnitude());
+		}
+		TEST_CHECK(outside == 0);
+		TEST_CHECK(slack < 1e-3f);
+		TEST_CHECK(!ShadowCascadeUtility::TransformBounds(m, Bounds()).IsValid());
+	}
+
+	void TestDepthRange()
+	{
+		// the camera at the origin, looking along +z
+		auto worldToCamera = Matrix4x4::identity;
+		std::vector<Bounds> receivers = { Bounds(Vector3(0, 0, 15), Vector3(2, 2, 10)), Bounds(Vector3(5, 0, 55), Vector3(2, 2, 10)) };
+		float minDepth, maxDepth;
+		TEST_CHECK(ShadowCascadeUtility::VisibleDepthRange(worldToCamera, receivers, 1, 100, minDepth, maxDepth));
+		TEST_CHECK_NEAR(minDepth, 10, 1e-4f);
+		TEST_CHECK_NEAR(maxDepth, 60, 1e-4f);
+
+		// clamped to the range of the camera
+		TEST_CHECK(ShadowCascadeUtility::VisibleDepthRange(worldToCamera, receivers, 12, 55, minDepth, maxDepth));
+		TEST_CHECK(minDepth == 12 && maxDepth == 55);
+
+		// behind the camera, beyond far
+		receivers = { Bounds(Vector3(0, 0, -10), Vector3(2, 2, 2)), Bounds(Vector3(0, 0, 500), Vector3(2, 2, 2)) };
+		TEST_CHECK(!ShadowCascadeUtility::VisibleDepthRange(worldToCamera, receivers, 1, 100, minDepth, maxDepth));
+		TEST_CHECK(!ShadowCascadeUtility::VisibleDepthRange(worldToCamera, {}, 1, 100, minDepth, maxDepth));
+	}
+
+	void TestQuantize()
+	{
+		const float step = std::exp2(1 / ShadowCascadeUtility::SizeStepsPerOctave);
+		float previous = 0;
+		int errors = 0;
+		for (float size = 0.1f; size < 1000; size *= 1.07f)
+		{
+			float q = ShadowCascadeUtility::QuantizeSize(size);
+			errors += q < size || q > size * step * 1.0001f;
+			errors += q < previous;
+			previous = q;
+		}
+		TEST_CHECK(errors == 0);
+		TEST_CHECK_NEAR(ShadowCascadeUtility::QuantizeSize(16), 16, 1e-4f);
+		TEST_CHECK(ShadowCascadeUtility::QuantizeSize(0) > 0);
+	}
+
+	void TestFit()
+	{
+		const int resolution = 1024;
+		auto worldToLight = Matrix4x4::identity;	// light along +z, as the camera
+		Vector3 corners[8];
+		SplitCorners(Vector3::zero, 10, 50, corners);
+
+		// one small receiver in the split: the cascade is fitted to it, not to the split (100 x 100). 4 is a size step:
+		// the cascade must still cover it once snapped
+		Bounds receiver(Vector3(3.001f, -2.001f, 30), Vector3(4, 4, 4));
+		auto c = ShadowCascadeUtility::FitCascade(worldToLight, corners, { receiver }, {}, resolution);
+		TEST_CHECK(Covers(c, receiver.min(), receiver.max()));
+		TEST_CHECK(c.max.x - c.min.x < 5 && c.max.x - c.min.x == c.max.y - c.min.y);
+		TEST_CHECK_NEAR(c.near, 28, 1e-4f);
+		TEST_CHECK_NEAR(c.far, 32, 1e-4f);
+		float texel = (c.max.x - c.min.x) / resolution;
+		TEST_CHECK_NEAR(c.min.x / texel, std::round(c.min.x / texel), 1e-2f);
+		TEST_CHECK_NEAR(c.min.y / texel, std::round(c.min.y / texel), 1e-2f);
+
+		// the projection maps the box of the cascade to the clip cube
+		auto p = c.projection.MultiplyPoint(Vector3(c.min.x, c.min.y, c.near));
+		auto q = c.projection.MultiplyPoint(Vector3(c.max.x, c.max.y, c.far));
+		TEST_CHECK((p - Vector3(-1, -1, -1)).magnitude() < 1e-4f && (q - Vector3(1, 1, 1)).magnitude() < 1e-4f);
+
+		// clipped to the split
+		Bounds large(Vector3(0, 0, 100), Vector3(10, 10, 200));
+		c = ShadowCascadeUtility::FitCascade(worldToLight, corners, { large }, {}, resolution);
+		TEST_CHECK(Covers(c, Vector3(-5, -5, 10), Vector3(5, 5, 50)));
+		TEST_CHECK(c.max.x - c.min.x < 12 && c.near >= 10 - 1e-4f && c.far <= 50 + 1e-4f);
+
+		// casters in front of the receiver over the rectangle; the others do not extend the range
+		std::vector<Bounds> casters = {
+			Bounds(Vector3(3, -2, 20), Vector3(1, 1, 2)),		// in front, over the receiver
+			Bounds(Vector3(40, 0, 0), Vector3(1, 1, 2)),		// beside the rectangle
+			Bounds(Vector3(-40, 0, 0), Vector3(1, 1, 2)),
+			Bounds(Vector3(3, 40, 0), Vector3(1, 1, 2)),
+			Bounds(Vector3(3, -40, 0), Vector3(1, 1, 2)),
+			Bounds(Vector3(3, -2, 45), Vector3(1, 1, 2)),		// behind the receiver
+		};
+		c = ShadowCascadeUtility::FitCascade(worldToLight, corners, { receiver }, casters, resolution);
+		TEST_CHECK_NEAR(c.near, 19, 1e-4f);
+		TEST_CHECK_NEAR(c.far, 32, 1e-4f);
+
+		// no receiver: the whole split
+		c = ShadowCascadeUtility::FitCascade(worldToLight, corners, {}, {}, resolution);
+		TEST_CHECK(Covers(c, Vector3(-50, -50, 10), Vector3(50, 50, 50)));
+
+		// a flat receiver still has a depth range
+		Bounds flat(Vector3(0, 0, 20), Vector3(4, 4, 0));
+		c = ShadowCascadeUtility::FitCascade(worldToLight, corners, { flat }, {}, resolution);
+		TEST_CHECK(c.far - c.near >= ShadowCascadeUtility::MinDepthRange - 1e-6f);
+	}
+
+	// the camera moves sideways over a receiver larger than the split: the size stays, the rectangle moves by texels
+	void TestStability()
+	{
+		const int resolution = 512;
+		auto worldToLight = ShadowCascadeUtility::WorldToLight(Vector3(0, 0, 1));
+		Bounds ground(Vector3(0, 0, 30), Vector3(1000, 1000, 40));
+		Vector3 corners[8];
+		SplitCorners(Vector3::zero, 5, 20, corners);
+		auto first = ShadowCascadeUtility::FitCascade(worldToLight, corners, { ground }, {}, resolution);
+		float size = first.max.x - first.min.x;
+		float texel = size / resolution;
+		int changed = 0, offTexel = 0;
+		for (int i = 1; i < 100; ++i)
+		{
+			Vector3 eye(i * 0.0137f, i * -0.0071f, 0);
+			SplitCorners(eye, 5, 20, corners);
+			auto c = ShadowCascadeUtility::FitCascade(worldToLight, corners, { ground }, {}, resolution);
+			changed += std::abs(c.max.x - c.min.x - size) > 1e-4f;
+			float dx = (c.min.x - first.min.x) / texel, dy = (c.min.y - first.min.y) / texel;
+			offTexel += std::abs(dx - std::round(dx)) > 1e-2f || std::abs(dy - std::round(dy)) > 1e-2f;
+			// the split, with the ground from z = 10
+			offTexel += !Covers(c, Vector3(corners[4].x, corners[4].y, 10), corners[7]);
+		}
+		TEST_CHECK(changed == 0);
+		TEST_CHECK(offTexel == 0);
+	}
+}
+
+int main()
+{
+	TestSplits();
+	TestLightSpace();
+	TestDepthRange();
+	TestQuantize();
+	TestFit();
+	TestStability();
+	return FishEngine::Test::Report("ShadowCascadeTest");
+}
@@ -0,0 +1,83 @@
+#ifndef SponzaScene_hpp
+#define SponzaScene_hpp
+
+// The Sponza scene of the Example project, for the benchmarks under Source/Test that measure the renderer on it:
+// the renderer initialized as the game does (GameApp), Example/Sponza/Assets/sponza.fbx imported and instantiated
+// with its hierarchy static, the camera and the light of MainEditor's Sponza scene.
+// The model is not in the repository, and it needs a display: without them there is no scene.
+// The benchmark defines FISHENGINE_EXAMPLE_DIR and FISHENGINE_SHADER_DIR, and is built with the editor (the FBX
+// importer).
+
+#include <FBXImporter.hpp>
+
+#include <FishEngine/Camera.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Light.hpp>
+#include <FishEngine/Prefab.hpp>
+#include <FishEngine/RenderSystem.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Screen.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+
+#include <GLTestContext.hpp>
+
+namespace FishEngine
+{
+	namespace Test
+	{
+		struct SponzaScene
+		{
+			GameObjectPtr	root;		// nullptr: no scene
+			CameraPtr		camera;
+			LightPtr		light;
+		};
+
+		// width, height: of the screen, the size of the render targets. Prints why there is no scene.
+		inline SponzaScene LoadSponza(int width = 1280, int height = 720)
+		{
+			SponzaScene scene;
+			Path model = Path(FISHENGINE_EXAMPLE_DIR) / "Sponza" / "Assets" / "sponza.fbx";
+			if (!boost::filesystem::exists(model))
+			{
+				std::printf("%s: not found, no Sponza scene\n", model.string().c_str());
+				return scene;
+			}
+			if (!CreateGLContext())
+			{
+				std::printf("no GL context, no Sponza scene\n");
+				return scene;
+			}
+
+			Path shaders = FISHENGINE_SHADER_DIR;
+			ShaderCompiler::setShaderIncludeDir((shaders / "include").string());
+			Shader::Init(shaders.string());
+			Screen::set(width, height);
+			RenderSystem::Init();
+
+			FishEditor::FBXImporter importer;
+			scene.root = Object::Instantiate(importer.Load(model)->rootGameObject());
+			for (auto & t : scene.root->GetComponentsInChildren<Transform>(true))
+				t->gameObject()->setIsStatic(true);
+
+			auto camera = Scene::CreateCamera();
+			camera->setTag("MainCamera");
+			camera->transform()->setPosition(5, 8, 0);
+			camera->transform()->setLocalEulerAngles(30, -90, 0);
+			scene.camera = camera->GetComponent<Camera>();
+
+			auto light = Scene::CreateGameObject("Directional Light");
+			light->transform()->setLocalEulerAngles(50, -30, 0);
+			scene.light = Light::Create();
+			light->AddComponent(scene.light);
+			return scene;
+		}
+	}
+}
+
+#endif // SponzaScene_hpp
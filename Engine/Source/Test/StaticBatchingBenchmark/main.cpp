@@ -0,0 +1,57 @@
+// The draw calls and the CPU time of a frame of Sponza, from the camera of its scene: every renderer drawn on its own,
+// then the static hierarchy combined by material (StaticBatchingUtility::Combine, as when entering play mode).
+// It needs the Sponza model of the Example project and a display (SponzaScene.hpp).
+
+#include <FishEngine/GLEnvironment.hpp>
+#include <FishEngine/Graphics.hpp>
+#include <FishEngine/Screen.hpp>
+#include <FishEngine/StaticBatchingUtility.hpp>
+
+#include <string>
+
+#include <BenchmarkUtility.hpp>
+#include <SponzaScene.hpp>
+
+using namespace FishEngine;
+using namespace FishEngine::Test;
+
+namespace
+{
+	void MeasureFrames(CameraPtr const & camera, std::string const & name)
+	{
+		// the first frame compiles the shaders
+		RenderSystem::Render(camera, RenderQuality::Full, Screen::width(), Screen::height());
+		glFinish();
+
+		const int frames = 100;
+		auto draws = Graphics::drawCallCount();
+		double cpu = ProcessCPUTime();
+		Stopwatch stopwatch;
+		for (int i = 0; i < frames; ++i)
+		{
+			RenderSystem::Render(camera, RenderQuality::Full, Screen::width(), Screen::height());
+			glFinish();
+		}
+		double wall = stopwatch.milliseconds();
+		PrintMeasurement((name + ", draw calls per frame").c_str(), static_cast<double>(Graphics::drawCallCount() - draws) / frames, "");
+		PrintMeasurement((name + ", CPU per frame").c_str(), (ProcessCPUTime() - cpu) / frames, "ms");
+		PrintMeasurement((name + ", frame time").c_str(), wall / frames, "ms");
+	}
+}
+
+int main()
+{
+	auto sponza = LoadSponza();
+	if (sponza.root == nullptr)
+		return 0;
+
+	MeasureFrames(sponza.camera, "Sponza, not batched");
+
+	Stopwatch stopwatch;
+	StaticBatchingUtility::Combine();
+	PrintMeasurement("Sponza, Combine", stopwatch.milliseconds(), "ms");
+	PrintMeasurement("Sponza, batches", static_cast<double>(StaticBatchingUtility::batches().size()), "");
+	MeasureFrames(sponza.camera, "Sponza, static batching");
+	StaticBatchingUtility::Clear();
+	return 0;
+}
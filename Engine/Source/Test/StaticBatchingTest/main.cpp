@@ -0,0 +1,168 @@
+// StaticBatchingUtility: the geometry of a renderer appended to a batch in world space, and the draw of a batch: its
+// ranges culled one by one and merged when adjacent so that the multi-draw gets as few ranges as possible.
+
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/GeometryUtility.hpp>
+#include <FishEngine/Material.hpp>
+#include <FishEngine/MeshRenderer.hpp>
+#include <FishEngine/Quaternion.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Shader.hpp>
+#include <FishEngine/ShaderCompiler.hpp>
+#include <FishEngine/StaticBatchingUtility.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <GLTestContext.hpp>
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	// a quad in the xy plane facing -z, one triangle per submesh
+	std::shared_ptr<Mesh> Quad()
+	{
+		std::vector<Vector3> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 } };
+		std::vector<Vector3> normals(4, Vector3(0, 0, -1));
+		std::vector<Vector2> uv = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+		std::vector<Vector3> tangents(4, Vector3(1, 0, 0));
+		std::vector<uint32_t> triangles = { 0, 1, 2, 0, 2, 3 };
+		return std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::move(uv), std::move(tangents), std::move(triangles));
+	}
+
+	bool Near(Vector3 const & a, Vector3 const & b)
+	{
+		return (a - b).magnitude() < 1e-4f;
+	}
+
+	void TestAppend()
+	{
+		auto quad = Quad();
+		Mesh batch;
+		// scaled by 2 along x, then turned by 90 degrees around y (x -> -z), then moved
+		auto localToWorld = Matrix4x4::TRS(Vector3(10, 0, 0), Quaternion::Euler(0, 90, 0), Vector3(2, 1, 1));
+		auto first = StaticBatchingUtility::Append(batch, *quad, { 0, 3 }, localToWorld);
+		auto second = StaticBatchingUtility::Append(batch, *quad, { 3, 3 }, Matrix4x4::identity);
+
+		TEST_CHECK(first.indices.start == 0 && first.indices.count == 3);
+		TEST_CHECK(second.indices.start == 3 && second.indices.count == 3);
+		// only the vertices used by the range: 3 + 3, vertex 0 and 2 are copied twice
+		TEST_CHECK(batch.vertices().size() == 6);
+		TEST_CHECK(batch.triangles() == (std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5 }));
+		TEST_CHECK(batch.normals().size() == 6 && batch.uv().size() == 6 && batch.tangents().size() == 6);
+
+		// in world space
+		TEST_CHECK(Near(batch.vertices()[0], Vector3(10, 0, 0)));
+		TEST_CHECK(Near(batch.vertices()[1], Vector3(10, 0, -2)));
+		TEST_CHECK(Near(batch.vertices()[2], Vector3(10, 1, -2)));
+		TEST_CHECK(Near(batch.vertices()[5], Vector3(0, 1, 0)));
+		TEST_CHECK(Near(batch.normals()[0], Vector3(-1, 0, 0)));
+		TEST_CHECK(Near(batch.tangents()[0], Vector3(0, 0, -1)));
+		TEST_CHECK(Near(batch.normals()[3], Vector3(0, 0, -1)));
+		auto uv = batch.uv()[2];	// Vector2::operator== is not const
+		TEST_CHECK(uv == Vector2(1, 1));
+
+		TEST_CHECK(Near(first.bounds.min(), Vector3(10, 0, -2)));
+		TEST_CHECK(Near(first.bounds.max(), Vector3(10, 1, 0)));
+		TEST_CHECK(Near(second.bounds.min(), Vector3(0, 0, 0)));
+		TEST_CHECK(Near(second.bounds.max(), Vector3(1, 1, 0)));
+
+		// vertices shared inside a range are copied once
+		Mesh whole;
+		auto range = StaticBatchingUtility::Append(whole, *quad, { 0, 6 }, Matrix4x4::identity);
+		TEST_CHECK(range.indices.count == 6);
+		TEST_CHECK(whole.vertices().size() == 4);
+		TEST_CHECK(whole.triangles() == quad->triangles());
+
+		// the normals follow the inverse transpose: a quad sheared by a non uniform scale
+		std::vector<Vector3> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+		std::vector<Vector3> normals(3, Vector3(1, 1, 0).normalized());
+		auto slanted = std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::vector<Vector2>(),
+			std::vector<Vector3>(), std::vector<uint32_t>{ 0, 1, 2 });
+		Mesh scaled;
+		StaticBatchingUtility::Append(scaled, *slanted, { 0, 3 }, Matrix4x4::Scale(2, 1, 1));
+		TEST_CHECK(Near(scaled.normals()[0], Vector3(1, 2, 0).normalized()));
+		// missing attributes are zero
+		uv = scaled.uv()[0];
+		TEST_CHECK(uv == Vector2::zero && scaled.tangents()[0] == Vector3::zero);
+	}
+
+	// with a GL context: Draw issues one multi-draw of the visible ranges, and returns their number
+	void TestDraw()
+	{
+		Path shaders = FISHENGINE_SHADER_DIR;
+		ShaderCompiler::setShaderIncludeDir((shaders / "include").string());
+		auto material = std::make_shared<Material>(Shader::CreateFromFile(shaders / "SolidColor.shader"));
+		material->SetVector4("Color", Vector4(1, 1, 1, 1));
+
+		// 4 quads, one per renderer, the third one far to the right
+		const float x[] = { 0, 2, 50, 4 };
+		std::vector<Vector3> vertices;
+		std::vector<uint32_t> triangles;
+		for (int i = 0; i < 4; ++i)
+		{
+			auto base = static_cast<uint32_t>(vertices.size());
+			for (auto const & v : Quad()->vertices())
+				vertices.push_back(v + Vector3(x[i], 0, 5));
+			for (auto t : Quad()->triangles())
+				triangles.push_back(base + t);
+		}
+		const auto vertexCount = vertices.size();
+		StaticBatch batch;
+		batch.material = material;
+		batch.mesh = std::make_shared<Mesh>(std::move(vertices), std::vector<Vector3>(vertexCount, Vector3(0, 0, -1)),
+			std::vector<Vector2>(vertexCount), std::vector<Vector3>(vertexCount, Vector3(1, 0, 0)), std::move(triangles));
+		batch.mesh->UploadMeshData();
+
+		std::vector<GameObjectPtr> objects;
+		std::vector<std::shared_ptr<MeshRenderer>> renderers;
+		for (int i = 0; i < 4; ++i)
+		{
+			auto go = Scene::CreateGameObject("Static " + std::to_string(i));
+			auto renderer = go->AddComponent<MeshRenderer>();
+			objects.push_back(go);
+			renderers.push_back(renderer);
+			StaticBatchRange range;
+			range.renderer = renderer;
+			range.indices = { static_cast<uint32_t>(i * 6), 6 };
+			range.bounds = Bounds(Vector3(x[i], 0, 5), Vector3(1, 1, 1));
+			batch.ranges.push_back(range);
+		}
+
+		// adjacent ranges are merged
+		TEST_CHECK(batch.Draw(material, nullptr) == 1);
+
+		// a view looking down +z (left handed, as Camera), 20 wide: the third quad is out, the others are split
+		Vector4 planes[6];
+		GeometryUtility::CalculateFrustumPlanes(Matrix4x4::Ortho(-10, 10, -10, 10, 0.1f, 100), planes);
+		TEST_CHECK(batch.Draw(material, planes) == 2);
+
+		// disabled renderers, inactive objects
+		renderers[1]->setEnabled(false);
+		objects[3]->SetActive(false);
+		TEST_CHECK(batch.Draw(material, planes) == 1);
+		renderers[0]->setEnabled(false);
+		TEST_CHECK(batch.Draw(material, planes) == 0);
+		renderers[0]->setEnabled(true);
+		renderers[1]->setEnabled(true);
+		objects[3]->SetActive(true);
+
+		// the shadow casters only
+		renderers[2]->setShadowCastingMode(ShadowCastingMode::Off);
+		TEST_CHECK(batch.Draw(material, nullptr, true) == 2);
+		TEST_CHECK(batch.Draw(material, nullptr, false) == 1);
+
+		for (auto & go : objects)
+			Scene::DestroyImmediate(go);
+	}
+}
+
+int main()
+{
+	TestAppend();
+	if (FishEngine::Test::CreateGLContext())
+		TestDraw();
+	else
+		FishEngine::Test::Skip("StaticBatchingTest");
+	return FishEngine::Test::Report("StaticBatchingTest");
+}
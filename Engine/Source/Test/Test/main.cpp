@@ -47,10 +47,9 @@ public:
 	}
 };
 
-int main()
+int main(int argc, char* argv[])
 {
 	TestApp app;
 	//app.Init();
-	app.Run();
-	return 0;
+	return app.Run(argc, argv);
 }
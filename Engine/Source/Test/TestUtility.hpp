@@ -0,0 +1,45 @@
+#ifndef TestUtility_hpp
+#define TestUtility_hpp
+
+// Checks of the tests under Source/Test. Each test is an executable run by ctest: it prints the failed checks and
+// returns non zero if any failed.
+
+#include <cmath>
+#include <cstdio>
+
+namespace FishEngine
+{
+	namespace Test
+	{
+		inline int & failureCount()
+		{
+			static int count = 0;
+			return count;
+		}
+
+		inline void Check(bool passed, const char* expression, const char* file, int line)
+		{
+			if (passed)
+				return;
+			failureCount()++;
+			std::printf("%s:%d: check failed: %s\n", file, line, expression);
+		}
+
+		// The exit code of main.
+		inline int Report(const char* name)
+		{
+			if (failureCount() == 0)
+				std::printf("%s: passed\n", name);
+			else
+				std::printf("%s: %d checks failed\n", name, failureCount());
+			return failureCount() == 0 ? 0 : 1;
+		}
+	}
+}
+
+#define TEST_CHECK(expression) FishEngine::Test::Check((expression), #expression, __FILE__, __LINE__)
+
+#define TEST_CHECK_NEAR(a, b, tolerance) \
+	FishEngine::Test::Check(std::abs((a) - (b)) <= (tolerance), #a " == " #b " +- " #tolerance, __FILE__, __LINE__)
+
+#endif // TestUtility_hpp
@@ -0,0 +1,493 @@
+// Undo: property diffs restored and reapplied through PropertyArchive, gesture merging, deleted subtrees and
+// components recreated with their values, reparenting, and the memory budget of the history. Random edit sequences,
+// undone and redone at random, must go back through the same scene states.
+
+#include <FishEngine/AudioSource.hpp>
+#include <FishEngine/GameObject.hpp>
+#include <FishEngine/Scene.hpp>
+#include <FishEngine/Transform.hpp>
+
+#include <Undo.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+using namespace FishEditor;
+
+namespace
+{
+	int s_performed = 0;
+
+	void TestPropertyRoundTrip()
+	{
+		Undo::ClearAll();
+		auto go = Scene::CreateGameObject("Moved");
+		auto t = go->transform();
+		t->setLocalPosition(1, 2, 3);
+
+		Undo::RecordObject(t, "Move");
+		Undo::RecordObject(t, "Move");	// once per group
+		t->setLocalPosition(4, 5, 6);
+		TEST_CHECK(Undo::canUndo());	// recorded, not flushed yet
+		Undo::FlushGesture();
+		TEST_CHECK(Undo::entryCount() == 1);
+		TEST_CHECK(!Undo::canRedo());
+
+		int performed = s_performed;
+		Undo::PerformUndo();
+		TEST_CHECK(s_performed == performed + 1);
+		TEST_CHECK(t->localPosition() == Vector3(1, 2, 3));
+		TEST_CHECK(!Undo::canUndo());
+		TEST_CHECK(Undo::canRedo());
+
+		Undo::PerformRedo();
+		TEST_CHECK(t->localPosition() == Vector3(4, 5, 6));
+		TEST_CHECK(Undo::canUndo());
+		TEST_CHECK(!Undo::canRedo());
+
+		// nothing changed: no entry
+		Undo::RecordObject(t, "Move");
+		Undo::FlushGesture();
+		TEST_CHECK(Undo::entryCount() == 1);
+
+		Scene::DestroyImmediate(go);
+	}
+
+	void TestRename()
+	{
+		Undo::ClearAll();
+		auto go = Scene::CreateGameObject("Before");
+		Undo::RecordObject(go, "Rename");
+		go->setName("After");
+		Undo::FlushGesture();
+
+		Undo::PerformUndo();
+		TEST_CHECK(go->name() == "Before");
+		TEST_CHECK(Scene::Find("Before") == go);
+		Undo::PerformRedo();
+		TEST_CHECK(go->name() == "After");
+		Scene::DestroyImmediate(go);
+	}
+
+	void TestMerge()
+	{
+		Undo::ClearAll();
+		auto go = Scene::CreateGameObject("Spin");
+		auto t = go->transform();
+
+		// spin box steps: the same property, in quick succession
+		for (int i = 1; i <= 5; ++i)
+		{
+			Undo::RecordObject(t, "Move");
+			t->setLocalPosition(static_cast<float>(i), 0, 0);
+			Undo::FlushGesture();
+		}
+		TEST_CHECK(Undo::entryCount() == 1);
+		Undo::PerformUndo();
+		TEST_CHECK(t->localPosition() == Vector3(0, 0, 0));
+		Undo::PerformRedo();
+		TEST_CHECK(t->localPosition() == Vector3(5, 0, 0));
+
+		// other properties, or another name: a new entry
+		Undo::RecordObject(t, "Move");
+		t->setLocalScale(2, 2, 2);
+		Undo::FlushGesture();
+		TEST_CHECK(Undo::entryCount() == 2);
+		Undo::RecordObject(t, "Nudge");
+		t->setLocalScale(3, 3, 3);
+		Undo::FlushGesture();
+		TEST_CHECK(Undo::entryCount() == 3);
+
+		// dragged back to where it started: the entry goes away
+		Undo::RecordObject(t, "Nudge");
+		t->setLocalScale(2, 2, 2);
+		Undo::FlushGesture();
+		TEST_CHECK(Undo::entryCount() == 2);
+		TEST_CHECK(t->localScale() == Vector3(2, 2, 2));
+
+		// a new change after an undo drops what could be redone
+		Undo::PerformUndo();
+		TEST_CHECK(t->localScale() == Vector3(1, 1, 1));
+		TEST_CHECK(Undo::canRedo());
+		Undo::RecordObject(go, "Rename");
+		go->setName("Spun");
+		Undo::FlushGesture();
+		TEST_CHECK(!Undo::canRedo());
+		TEST_CHECK(Undo::entryCount() == 2);
+
+		Scene::DestroyImmediate(go);
+	}
+
+	void TestDestroyAndRecreate()
+	{
+		Undo::ClearAll();
+		auto root = Scene::CreateGameObject("Root");
+		auto child = Scene::CreateGameObject("Child");
+		child->transform()->SetParent(root->transform(), false);
+		child->transform()->setLocalPosition(0, 7, 0);
+		auto source = child->AddComponent<AudioSource>();
+		source->setVolume(0.25f);
+		source->setLoop(true);
+		root->transform()->setLocalPosition(1, 0, 0);
+
+		// a diff recorded before the delete still applies to the recreated object
+		Undo::RecordObject(root->transform(), "Move");
+		root->transform()->setLocalPosition(2, 0, 0);
+		Undo::FlushGesture();
+
+		Undo::DestroyObjectImmediate(root);
+		Undo::FlushGesture();
+		TEST_CHECK(Scene::Find("Root") == nullptr);
+		TEST_CHECK(Scene::Find("Child") == nullptr);
+		TEST_CHECK(Undo::entryCount() == 2);
+
+		Undo::PerformUndo();
+		auto restored = Scene::Find("Root");
+		TEST_CHECK(restored != nullptr && restored != root);
+		if (restored == nullptr)
+			return;
+		TEST_CHECK(restored->transform()->localPosition() == Vector3(2, 0, 0));
+		TEST_CHECK(restored->transform()->childCount() == 1);
+		auto restoredChild = Scene::Find("Child");
+		TEST_CHECK(restoredChild != nullptr && restoredChild->transform()->parent() == restored->transform());
+		if (restoredChild == nullptr)
+			return;
+		TEST_CHECK(restoredChild->transform()->localPosition() == Vector3(0, 7, 0));
+		auto restoredSource = restoredChild->GetComponent<AudioSource>();
+		TEST_CHECK(restoredSource != nullptr);
+		if (restoredSource != nullptr)
+		{
+			TEST_CHECK(restoredSource->volume() == 0.25f);
+			TEST_CHECK(restoredSource->loop());
+		}
+
+		Undo::PerformUndo();
+		TEST_CHECK(restored->transform()->localPosition() == Vector3(1, 0, 0));
+
+		Undo::PerformRedo();
+		Undo::PerformRedo();
+		TEST_CHECK(Scene::Find("Root") == nullptr);
+
+		// and back again: the operations follow the objects through every recreation
+		Undo::PerformUndo();
+		Undo::PerformUndo();
+		auto again = Scene::Find("Root");
+		TEST_CHECK(again != nullptr);
+		if (again != nullptr)
+		{
+			TEST_CHECK(again->transform()->localPosition() == Vector3(1, 0, 0));
+			Scene::DestroyImmediate(again);
+		}
+	}
+
+	void TestComponent()
+	{
+		Undo::ClearAll();
+		auto go = Scene::CreateGameObject("Speaker");
+		auto source = go->AddComponent<AudioSource>();
+		source->setPitch(2);
+		Undo::DestroyObjectImmediate(source);
+		Undo::FlushGesture();
+		TEST_CHECK(go->GetComponent<AudioSource>() == nullptr);
+
+		Undo::PerformUndo();
+		auto restored = go->GetComponent<AudioSource>();
+		TEST_CHECK(restored != nullptr);
+		if (restored != nullptr)
+			TEST_CHECK(restored->pitch() == 2);
+		Undo::PerformRedo();
+		TEST_CHECK(go->GetComponent<AudioSource>() == nullptr);
+
+		// created: undo removes it
+		auto added = go->AddComponent<AudioSource>();
+		Undo::RegisterCreatedObjectUndo(added, "Add AudioSource");
+		Undo::FlushGesture();
+		Undo::PerformUndo();
+		TEST_CHECK(go->GetComponent<AudioSource>() == nullptr);
+		Undo::PerformRedo();
+		TEST_CHECK(go->GetComponent<AudioSource>() != nullptr);
+		Scene::DestroyImmediate(go);
+	}
+
+	void TestReparent()
+	{
+		Undo::ClearAll();
+		auto parent = Scene::CreateGameObject("Parent");
+		auto child = Scene::CreateGameObject("Orphan");
+		parent->transform()->setLocalPosition(10, 0, 0);
+
+		Undo::SetTransformParent(child->transform(), parent->transform(), "Parent");
+		Undo::FlushGesture();
+		TEST_CHECK(child->transform()->parent() == parent->transform());
+		TEST_CHECK(child->transform()->position() == Vector3(0, 0, 0));	// worldPositionStays
+
+		Undo::PerformUndo();
+		TEST_CHECK(child->transform()->parent() == nullptr);
+		TEST_CHECK(child->transform()->localPosition() == Vector3(0, 0, 0));
+		Undo::PerformRedo();
+		TEST_CHECK(child->transform()->parent() == parent->transform());
+
+		// a cycle is refused and not recorded
+		Undo::SetTransformParent(parent->transform(), child->transform(), "Parent");
+		Undo::FlushGesture();
+		TEST_CHECK(parent->transform()->parent() == nullptr);
+		TEST_CHECK(Undo::entryCount() == 1);
+
+		Scene::DestroyImmediate(parent);
+	}
+
+	void TestMemoryBudget()
+	{
+		Undo::ClearAll();
+		auto go = Scene::CreateGameObject("Budget");
+		for (int i = 0; i < 10; ++i)
+		{
+			// a new name each time: not merged
+			Undo::RecordObject(go, "Rename " + std::to_string(i));
+			go->setName("Budget " + std::to_string(i));
+			Undo::FlushGesture();
+		}
+		TEST_CHECK(Undo::entryCount() == 10);
+		size_t usage = Undo::memoryUsage();
+		TEST_CHECK(usage > 0);
+
+		// the oldest entries go first
+		Undo::setMemoryBudget(usage / 2);
+		TEST_CHECK(Undo::entryCount() < 10);
+		TEST_CHECK(Undo::entryCount() >= 1);
+		TEST_CHECK(Undo::memoryUsage() <= usage / 2);
+		while (Undo::canUndo())
+			Undo::PerformUndo();
+		int kept = static_cast<int>(Undo::entryCount());
+		TEST_CHECK(kept >= 2);
+		TEST_CHECK(go->name() == "Budget " + std::to_string(9 - kept));
+
+		// everything undone: the redo entries furthest from the current state go first
+		Undo::setMemoryBudget(1);
+		TEST_CHECK(Undo::entryCount() == 1);
+		Undo::PerformRedo();
+		TEST_CHECK(go->name() == "Budget " + std::to_string(10 - kept));
+		TEST_CHECK(!Undo::canRedo());
+
+		Undo::setMemoryBudget(32 * 1024 * 1024);
+		Undo::ClearAll();
+		for (int i = 0; i < 10; ++i)
+		{
+			Undo::RecordObject(go, "Rename " + std::to_string(i));
+			go->setName("Budget " + std::to_string(i));
+			Undo::FlushGesture();
+		}
+
+		// the newest entry is always kept
+		while (Undo::canRedo())
+			Undo::PerformRedo();
+		TEST_CHECK(go->name() == "Budget 9");
+		Undo::setMemoryBudget(1);
+		TEST_CHECK(Undo::entryCount() == 1);
+		Undo::PerformUndo();
+		TEST_CHECK(go->name() == "Budget 8");
+
+		Undo::setMemoryBudget(32 * 1024 * 1024);
+		Undo::ClearAll();
+		TEST_CHECK(Undo::memoryUsage() == 0);
+		TEST_CHECK(!Undo::canUndo() && !Undo::canRedo());
+		Scene::DestroyImmediate(go);
+	}
+
+	// The state of the scene, without the instance ids (recreated objects get new ones): per GameObject, sorted by
+	// name, its parent, position and components.
+	std::string SceneState()
+	{
+		std::vector<std::string> lines;
+		for (auto const & go : Scene::GameObjects())
+		{
+			auto t = go->transform();
+			auto p = t->localPosition();
+			std::string line = go->name() + " in " + (t->parent() == nullptr ? "-" : t->parent()->gameObject()->name()) +
+				" at " + std::to_string(p.x) + "," + std::to_string(p.y) + "," + std::to_string(p.z);
+			for (auto const & c : go->Components())
+				line += " " + c->ClassName();
+			lines.push_back(line);
+		}
+		std::sort(lines.begin(), lines.end());
+		std::string state;
+		for (auto const & line : lines)
+			state += line + "\n";
+		return state;
+	}
+
+	bool IsInSubtree(TransformPtr t, TransformPtr const & root)
+	{
+		for (; t != nullptr; t = t->parent())
+		{
+			if (t == root)
+				return true;
+		}
+		return false;
+	}
+
+	void TestRandomEdits(unsigned seed)
+	{
+		Undo::ClearAll();
+		std::mt19937 random(seed);
+		auto pick = [&random]() {
+			std::vector<GameObjectPtr> objects(Scene::GameObjects().begin(), Scene::GameObjects().end());
+			return objects[std::uniform_int_distribution<size_t>(0, objects.size() - 1)(random)];
+		};
+		for (int i = 0; i < 5; ++i)
+			Scene::CreateGameObject("Start " + std::to_string(i));
+
+		// states[i]: the scene with the first i entries applied
+		std::vector<std::string> states = { SceneState() };
+		size_t current = 0;
+		int failures = 0;
+		for (int edit = 0; edit < 500; ++edit)
+		{
+			// every edit has its own name and changes something: one entry each, never merged
+			auto name = "Edit " + std::to_string(edit);
+			int action = std::uniform_int_distribution<int>(0, 7)(random);
+			if (action == 6)
+			{
+				if (!Undo::canUndo())
+					continue;
+				Undo::PerformUndo();
+				current--;
+				failures += SceneState() != states[current];
+				continue;
+			}
+			if (action == 7)
+			{
+				if (!Undo::canRedo())
+					continue;
+				Undo::PerformRedo();
+				current++;
+				failures += SceneState() != states[current];
+				continue;
+			}
+
+			switch (action)
+			{
+			case 0:
+			{
+				auto parent = random() % 2 == 0 ? pick()->transform() : nullptr;
+				auto go = Scene::CreateGameObject("Created " + std::to_string(edit));
+				go->transform()->SetParent(parent, false);
+				Undo::RegisterCreatedObjectUndo(go, name);
+				break;
+			}
+			case 1:
+			{
+				auto t = pick()->transform();
+				Undo::RecordObject(t, name);
+				t->setLocalPosition(static_cast<float>(edit), static_cast<float>(edit % 7), 0);
+				break;
+			}
+			case 2:
+			{
+				auto go = pick();
+				Undo::RecordObject(go, name);
+				go->setName("Renamed " + std::to_string(edit));
+				break;
+			}
+			case 3:
+			{
+				auto t = pick()->transform();
+				auto parent = random() % 4 == 0 ? nullptr : pick()->transform();
+				if (t->parent() == parent || (parent != nullptr && IsInSubtree(parent, t)))
+					continue;
+				Undo::SetTransformParent(t, parent, name, false);
+				break;
+			}
+			case 4:
+				if (Scene::GameObjects().size() < 5)
+					continue;
+				Undo::DestroyObjectImmediate(pick());
+				break;
+			case 5:
+			{
+				auto go = pick();
+				auto source = std::make_shared<AudioSource>();
+				go->AddComponent(source);
+				Undo::RegisterCreatedObjectUndo(source, name);
+				break;
+			}
+			}
+			Undo::FlushGesture();
+			states.resize(current + 1);
+			states.push_back(SceneState());
+			current++;
+			failures += Undo::entryCount() != current;
+		}
+		TEST_CHECK(failures == 0);
+
+		// all the way back, and forward again
+		while (Undo::canUndo())
+		{
+			Undo::PerformUndo();
+			current--;
+			failures += SceneState() != states[current];
+		}
+		TEST_CHECK(current == 0);
+		while (Undo::canRedo())
+		{
+			Undo::PerformRedo();
+			current++;
+			failures += SceneState() != states[current];
+		}
+		TEST_CHECK(current == states.size() - 1);
+		TEST_CHECK(failures == 0);
+
+		Undo::ClearAll();
+		std::vector<GameObjectPtr> roots;
+		for (auto const & go : Scene::GameObjects())
+		{
+			if (go->transform()->parent() == nullptr)
+				roots.push_back(go);
+		}
+		for (auto const & go : roots)
+			Scene::DestroyImmediate(go);
+	}
+
+	void TestMemoryPerEntry()
+	{
+		// the typical entry: one property of one object (a move in the scene view)
+		Undo::ClearAll();
+		auto go = Scene::CreateGameObject("Moved");
+		const int entries = 1000;
+		for (int i = 0; i < entries; ++i)
+		{
+			Undo::RecordObject(go->transform(), "Move " + std::to_string(i));
+			go->transform()->setLocalPosition(static_cast<float>(i + 1), 0, 0);
+			Undo::FlushGesture();
+		}
+		TEST_CHECK(Undo::entryCount() == entries);
+		double perEntry = static_cast<double>(Undo::memoryUsage()) / entries;
+		std::printf("UndoTest: %.0f bytes per entry (a moved transform)\n", perEntry);
+		// a diff of one property, not a copy of the object
+		TEST_CHECK(perEntry < 512);
+		Undo::ClearAll();
+		Scene::DestroyImmediate(go);
+	}
+}
+
+int main()
+{
+	Undo::undoRedoPerformed += [] { s_performed++; };
+	TestPropertyRoundTrip();
+	TestRename();
+	TestMerge();
+	TestDestroyAndRecreate();
+	TestComponent();
+	TestReparent();
+	TestMemoryBudget();
+	TestRandomEdits(1);
+	TestRandomEdits(2);
+	TestMemoryPerEntry();
+	return FishEngine::Test::Report("UndoTest");
+}
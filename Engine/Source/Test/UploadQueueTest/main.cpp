@@ -0,0 +1,260 @@
+// UploadQueue: the staging ring (alignment, blocks held back by the unfinished ones, the end skipped when the ring
+// wraps around), and with a GL context textures and meshes streamed through more than the capacity of the ring,
+// within the budget of each frame, arriving intact.
+
+#include <FishEngine/Mesh.hpp>
+#include <FishEngine/Texture2D.hpp>
+#include <FishEngine/UploadQueue.hpp>
+
+#include <random>
+
+#include <GLTestContext.hpp>
+#include <TestUtility.hpp>
+
+using namespace FishEngine;
+
+namespace
+{
+	void TestRing()
+	{
+		StagingRing ring(100);
+		auto a = ring.Allocate(60, 1);
+		auto b = ring.Allocate(40, 1);
+		TEST_CHECK(a.offset == 0 && b.offset == 60);
+		TEST_CHECK(ring.Allocate(1, 1).offset == StagingRing::InvalidOffset);
+		TEST_CHECK(ring.Allocate(101, 1).offset == StagingRing::InvalidOffset);
+
+		// released in the order of allocation: b waits for a
+		ring.Retire(b.id, 1);
+		ring.Release(1);
+		TEST_CHECK(ring.used() == 100 && ring.blockCount() == 2);
+		ring.Retire(a.id, 2);
+		ring.Release(1);
+		TEST_CHECK(ring.used() == 100);
+		ring.Release(2);
+		TEST_CHECK(ring.used() == 0 && ring.blockCount() == 0);
+
+		// wraps around: the 10 bytes at the end are skipped, and released with the block
+		auto c = ring.Allocate(70, 1);
+		auto d = ring.Allocate(20, 1);
+		TEST_CHECK(c.offset == 0 && d.offset == 70);
+		ring.Retire(c.id, 0);
+		ring.Release(0);
+		auto e = ring.Allocate(20, 1);
+		TEST_CHECK(e.offset == 0);
+		TEST_CHECK(ring.used() == 20 + 10 + 20);
+		// between the head and the tail: 50 free, less after the alignment
+		TEST_CHECK(ring.Allocate(51, 1).offset == StagingRing::InvalidOffset);
+		TEST_CHECK(ring.Allocate(50, 16).offset == StagingRing::InvalidOffset);
+		auto f = ring.Allocate(38, 16);
+		TEST_CHECK(f.offset == 32 && ring.used() == 20 + 10 + 20 + 12 + 38);
+		ring.Retire(d.id, 0);
+		ring.Retire(e.id, 0);
+		ring.Retire(f.id, 0);
+		ring.Release(0);
+		TEST_CHECK(ring.used() == 0);
+
+		// empty: from the start again
+		TEST_CHECK(ring.Allocate(100, 4).offset == 0);
+	}
+
+	// random allocations, retired with fences, against the live blocks
+	void TestRandomRing()
+	{
+		std::mt19937 random(1);
+		int overlaps = 0, misaligned = 0, wrongCounts = 0, notEmpty = 0, rounds = 0;
+		for (; rounds < 100; ++rounds)
+		{
+			uint32_t capacity = 64 + random() % 4096;
+			StagingRing ring(capacity);
+			struct Live
+			{
+				uint32_t	offset;
+				uint32_t	size;
+				uint64_t	id;
+				uint64_t	fence;
+				bool		retired;
+			};
+			std::vector<Live> live;
+			uint64_t fence = 0, completed = 0;
+			for (int step = 0; step < 2000; ++step)
+			{
+				auto op = random() % 4;
+				if (op <= 1)
+				{
+					uint32_t size = 1 + random() % (capacity / 3);
+					uint32_t alignment = 1u << (random() % 5);
+					auto a = ring.Allocate(size, alignment);
+					if (a.offset == StagingRing::InvalidOffset)
+						continue;
+					misaligned += a.offset % alignment != 0 || a.offset + size > capacity;
+					for (auto const & l : live)
+						overlaps += a.offset < l.offset + l.size && l.offset < a.offset + size;
+					live.push_back({ a.offset, size, a.id, 0, false });
+				}
+				else if (op == 2)
+				{
+					// the copies of a frame: 0 when read already
+					for (auto & l : live)
+					{
+						if (!l.retired && random() % 2)
+						{
+							l.retired = true;
+							l.fence = random() % 3 ? fence + 1 : 0;
+							ring.Retire(l.id, l.fence);
+						}
+					}
+					fence++;
+				}
+				else
+				{
+					completed = std::min(fence, completed + random() % 3);
+					ring.Release(completed);
+					size_t released = 0;
+					while (released < live.size() && live[released].retired && live[released].fence <= completed)
+						released++;
+					live.erase(live.begin(), live.begin() + released);
+					wrongCounts += ring.blockCount() != live.size();
+				}
+			}
+			for (auto const & l : live)
+			{
+				if (!l.retired)
+					ring.Retire(l.id, 0);
+			}
+			ring.Release(UINT64_MAX);
+			notEmpty += ring.used() != 0 || ring.blockCount() != 0 || ring.Allocate(capacity, 1).offset != 0;
+		}
+		TEST_CHECK(overlaps == 0);
+		TEST_CHECK(misaligned == 0);
+		TEST_CHECK(wrongCounts == 0);
+		TEST_CHECK(notEmpty == 0);
+	}
+
+	std::vector<uint8_t> Pixels(int size, int seed)
+	{
+		std::vector<uint8_t> pixels(size * size * 4);
+		for (size_t i = 0; i < pixels.size(); ++i)
+			pixels[i] = static_cast<uint8_t>(seed * 31 + i * 7 + i / 4096);
+		return pixels;
+	}
+
+	MeshPtr MakeMesh(int seed)
+	{
+		std::vector<Vector3> vertices, normals;
+		std::vector<uint32_t> triangles;
+		for (int i = 0; i < 300; ++i)
+		{
+			vertices.emplace_back(float(i), float(seed), float(i * 3));
+			normals.emplace_back(0, 1, float(i));
+		}
+		for (int i = 0; i < 900; ++i)
+			triangles.push_back((i * 7 + seed) % 300);
+		return std::make_shared<Mesh>(std::move(vertices), std::move(normals), std::vector<Vector2>(), std::vector<Vector3>(), std::move(triangles));
+	}
+
+	// before Init, nothing is queued: uploaded when drawn
+	void TestNotInitialized()
+	{
+		auto pixels = Pixels(4, 0);
+		auto texture = std::make_shared<Texture2D>(4, 4, TextureFormat::RGBA32, pixels.data(), static_cast<int>(pixels.size()));
+		TEST_CHECK(!UploadQueue::Enqueue(texture));
+		TEST_CHECK(!UploadQueue::Enqueue(MakeMesh(0)));
+		TEST_CHECK(UploadQueue::queuedCount() == 0);
+	}
+
+	void TestQueue()
+	{
+		UploadQueue::Init();
+
+		// 100 textures of 1 MB through the 64 MB ring: enqueued while there is room, a frame when it is full
+		const int textureCount = 100, size = 512;
+		const uint32_t textureBytes = size * size * 4;
+		UploadQueue::setBytesPerFrame(3 * textureBytes);
+		std::vector<Texture2DPtr> textures;
+		for (int i = 0; i < textureCount; ++i)
+		{
+			auto pixels = Pixels(size, i);
+			textures.push_back(std::make_shared<Texture2D>(size, size, TextureFormat::RGBA32, pixels.data(), static_cast<int>(pixels.size())));
+		}
+		auto white = Texture2D::whiteTexture()->GetNativeTexturePtr();
+		TEST_CHECK(UploadQueue::Enqueue(textures[0]));
+		TEST_CHECK(!UploadQueue::Enqueue(textures[0]));
+		TEST_CHECK(textures[0]->GetNativeTexturePtr() == white);
+
+		int frames = 0, overBudget = 0, fullFrames = 0;
+		for (int next = 1; next < textureCount || UploadQueue::queuedCount() > 0; ++frames)
+		{
+			while (next < textureCount && UploadQueue::Enqueue(textures[next]))
+				next++;
+			fullFrames += next < textureCount;
+			auto queued = UploadQueue::queuedCount();
+			UploadQueue::Update();
+			overBudget += queued - UploadQueue::queuedCount() > 3;
+			// the GPU has done the copies of the frame
+			glFinish();
+			if (frames > 1000)
+				break;
+		}
+		TEST_CHECK(UploadQueue::queuedCount() == 0);
+		TEST_CHECK(overBudget == 0);
+		TEST_CHECK(fullFrames > 0);
+		TEST_CHECK(frames >= textureCount / 3);
+
+		int wrong = 0;
+		std::vector<uint8_t> pixels(textureBytes);
+		for (int i = 0; i < textureCount; ++i)
+		{
+			auto name = textures[i]->GetNativeTexturePtr();
+			if (name == white)
+			{
+				wrong++;
+				continue;
+			}
+			glBindTexture(GL_TEXTURE_2D, name);
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+			wrong += pixels != Pixels(size, i);
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+		TEST_CHECK(wrong == 0);
+
+		// meshes, into their GeometryPool
+		std::vector<MeshPtr> meshes;
+		for (int i = 0; i < 8; ++i)
+		{
+			meshes.push_back(MakeMesh(i));
+			TEST_CHECK(UploadQueue::Enqueue(meshes.back()));
+		}
+		TEST_CHECK(!UploadQueue::Enqueue(meshes[0]));
+		// queued: not uploaded by the draws in the meantime
+		meshes[0]->UploadMeshData();
+		TEST_CHECK(meshes[0]->vertices().size() == 300);
+		UploadQueue::Flush();
+		TEST_CHECK(UploadQueue::queuedCount() == 0);
+		for (int i = 0; i < 8; ++i)
+		{
+			auto expected = MakeMesh(i);
+			TEST_CHECK(meshes[i]->vertices().empty());
+			TEST_CHECK(meshes[i]->ReadBackMeshData());
+			TEST_CHECK(meshes[i]->vertices() == expected->vertices());
+			TEST_CHECK(meshes[i]->normals() == expected->normals());
+			TEST_CHECK(meshes[i]->triangles() == expected->triangles());
+		}
+		TEST_CHECK(glGetError() == GL_NO_ERROR);
+		UploadQueue::setBytesPerFrame(UploadQueue::DefaultBytesPerFrame);
+	}
+}
+
+int main()
+{
+	TestRing();
+	TestRandomRing();
+	if (FishEngine::Test::CreateGLContext())
+	{
+		TestNotInitialized();
+		TestQueue();
+	}
+	else
+		FishEngine::Test::Skip("UploadQueueTest");
+	return FishEngine::Test::Report("UploadQueueTest");
+}
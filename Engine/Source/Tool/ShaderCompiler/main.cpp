@@ -2,16 +2,26 @@
 #include <FishEngine/ShaderCompiler.hpp>
 #include <FishEngine/GLEnvironment.hpp>
 #include <FishEngine/Debug.hpp>
+#include <FishEngine/Render/Shader/ShaderReflection.hpp>
 #include <glfw/glfw3.h>
 
+#include <atomic>
+#include <boost/algorithm/string.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#if FISHENGINE_PLATFORM_WINDOWS
+	#define popen _popen
+	#define pclose _pclose
+#endif
+
 using namespace FishEngine;
 
-int main(int argc, char* argv[])
+// Compiles one shader with the OpenGL driver.
+int CompileWithGL(std::string const & path)
 {
-	//Debug::Init();
-	//Debug::setColorMode(false);
-	LogInfo("Compiling...");
-	
 	glfwInit();
 	// Set all the required options for GLFW
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -26,12 +36,250 @@ int main(int argc, char* argv[])
 	auto window = glfwCreateWindow(WIDTH, HEIGHT, "FishEngine", nullptr, nullptr);
 	glfwMakeContextCurrent(window);
 	glCheckError();
-	
+
 #if FISHENGINE_PLATFORM_WINDOWS
 	// Set this to true so GLEW knows to use a modern approach to retrieving function pointers and extensions
 	glewExperimental = GL_TRUE;
 	// Initialize GLEW to setup the OpenGL Function pointers
 	glewInit();
+#endif
+
+	auto shader = Shader::CreateFromFile(path);
+	if (shader == nullptr)
+		return 1;
+
+	shader->Use();
+	if (shader->IsValid())
+	{
+		LogInfo("OK");
+		return 0;
+	}
+	else
+	{
+		return 1;
+	}
+}
+
+
+// --offline: every keyword variant and stage of the shaders is checked without a GL context, on all the cores.
+// The stages are reflected (uniforms, blocks, vertex inputs) and compiled by glslangValidator, which is required
+// unless --reflect-only is given. Errors are reported in the original files.
+struct OfflineShader
+{
+	Path			path;
+	std::string		preprocessed;
+	bool			hasGeometryShader = false;
+};
+
+struct OfflineJob
+{
+	OfflineJob(size_t shader, ShaderKeywords keywords, ShaderType stage)
+		: shader(shader), keywords(keywords), stage(stage)
+	{
+	}
+
+	size_t			shader;
+	ShaderKeywords	keywords;
+	ShaderType		stage;
+
+	ShaderReflection				reflection;
+	std::vector<ShaderDiagnostic>	diagnostics;
+};
+
+const char* StageExtension(ShaderType stage)
+{
+	if (stage == ShaderType::VertexShader)
+		return "vert";
+	if (stage == ShaderType::FragmentShader)
+		return "frag";
+	return "geom";
+}
+
+Path FindGlslang()
+{
+#if FISHENGINE_PLATFORM_WINDOWS
+	const char* name = "glslangValidator.exe";
+	const char* separator = ";";
+#else
+	const char* name = "glslangValidator";
+	const char* separator = ":";
+#endif
+	auto env = std::getenv("PATH");
+	if (env == nullptr)
+		return Path();
+	std::vector<std::string> dirs;
+	boost::split(dirs, std::string(env), boost::is_any_of(separator));
+	for (auto const & d : dirs)
+	{
+		boost::system::error_code ec;
+		auto path = Path(d) / name;
+		if (!d.empty() && boost::filesystem::is_regular_file(path, ec))
+			return path;
+	}
+	return Path();
+}
+
+void RunGlslang(Path const & glslang, OfflineJob & job, std::string const & source)
+{
+	auto file = boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path(std::string("FishShader-%%%%-%%%%-%%%%.") + StageExtension(job.stage));
+	{
+		std::ofstream fout(file.string());
+		fout << source;
+	}
+	auto command = "\"" + glslang.string() + "\" \"" + file.string() + "\" 2>&1";
+#if FISHENGINE_PLATFORM_WINDOWS
+	command = "\"" + command + "\"";	// cmd.exe strips the outer quotes
+#endif
+	std::string log;
+	auto pipe = popen(command.c_str(), "r");
+	if (pipe == nullptr)
+	{
+		job.diagnostics.push_back({ Path(), 0, "can not run " + glslang.string() });
+		return;
+	}
+	char buffer[512];
+	while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr)
+		log += buffer;
+	int status = pclose(pipe);
+	boost::system::error_code ec;
+	boost::filesystem::remove(file, ec);
+	if (status == 0)
+		return;
+
+	// glslangValidator prints the name of the temporary file first, keep the located messages and the errors
+	for (auto & d : ShaderCompiler::MapDiagnostics(log))
+	{
+		bool summary = d.message.find("compilation errors") != std::string::npos;
+		if (!d.file.empty() || d.line > 0 || (boost::starts_with(d.message, "ERROR") && !summary))
+			job.diagnostics.push_back(std::move(d));
+	}
+	if (job.diagnostics.empty())
+		job.diagnostics.push_back({ Path(), 0, "compilation failed" });
+}
+
+std::string KeywordsToString(ShaderKeywords keywords)
+{
+	if (keywords & static_cast<ShaderKeywords>(ShaderKeyword::AmbientIBL))
+		return "_AMBIENT_IBL";
+	return "(none)";
+}
+
+int CompileOffline(std::vector<Path> const & inputs, Path const & glslang, Path const & outputDir)
+{
+	std::vector<Path> files;
+	for (auto const & input : inputs)
+	{
+		if (boost::filesystem::is_directory(input))
+		{
+			for (auto & entry : boost::filesystem::directory_iterator(input))
+			{
+				auto ext = entry.path().extension();
+				if (ext == ".shader" || ext == ".surf")
+					files.push_back(entry.path());
+			}
+		}
+		else
+		{
+			files.push_back(input);
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	int errorCount = 0;
+
+	// preprocessing shares the cache of the headers, it is cheap
+	std::vector<OfflineShader> shaders;
+	for (auto const & path : files)
+	{
+		try
+		{
+			ShaderCompiler compiler(path);
+			OfflineShader s;
+			s.path = path;
+			s.preprocessed = compiler.Preprocess();
+			s.hasGeometryShader = compiler.m_hasGeometryShader;
+			shaders.push_back(std::move(s));
+		}
+		catch (std::exception const & e)
+		{
+			std::cerr << path.string() << ": preprocessing failed: " << e.what() << std::endl;
+			errorCount++;
+		}
+	}
+
+	std::vector<OfflineJob> jobs;
+	auto variants = ShaderCompiler::KeywordVariants();
+	for (size_t i = 0; i < shaders.size(); ++i)
+	{
+		for (auto keywords : variants)
+		{
+			jobs.emplace_back(i, keywords, ShaderType::VertexShader);
+			jobs.emplace_back(i, keywords, ShaderType::FragmentShader);
+			if (shaders[i].hasGeometryShader)
+				jobs.emplace_back(i, keywords, ShaderType::GeometryShader);
+		}
+	}
+
+	std::atomic<size_t> next(0);
+	auto worker = [&]()
+	{
+		for (size_t j = next++; j < jobs.size(); j = next++)
+		{
+			auto & job = jobs[j];
+			auto source = ShaderCompiler::StageSource(shaders[job.shader].preprocessed, job.stage, job.keywords);
+			job.reflection = ShaderReflection::Reflect(source, job.stage);
+			job.diagnostics = job.reflection.errors;
+			if (!glslang.empty() && job.diagnostics.empty())
+				RunGlslang(glslang, job, source);
+		}
+	};
+	std::vector<std::thread> threads;
+	auto threadCount = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned i = 0; i < threadCount; ++i)
+		threads.emplace_back(worker);
+	for (auto & t : threads)
+		t.join();
+
+	std::vector<ShaderReflection> reflections(shaders.size());
+	for (auto const & job : jobs)
+	{
+		reflections[job.shader].Merge(job.reflection);
+		for (auto const & d : job.diagnostics)
+		{
+			errorCount++;
+			std::cerr << (d.file.empty() ? shaders[job.shader].path.string() : d.file.string());
+			if (d.line > 0)
+				std::cerr << '(' << d.line << ')';
+			std::cerr << ": " << d.message << " [" << shaders[job.shader].path.filename().string() << ", "
+				<< StageExtension(job.stage) << ", " << KeywordsToString(job.keywords) << "]" << std::endl;
+		}
+	}
+
+	if (!outputDir.empty())
+	{
+		boost::filesystem::create_directories(outputDir);
+		for (size_t i = 0; i < shaders.size(); ++i)
+		{
+			std::ofstream fout((outputDir / (shaders[i].path.stem().string() + ".reflection.txt")).string());
+			fout << reflections[i].ToString();
+		}
+	}
+
+	std::cout << Format("%1% shaders, %2% variants checked on %3% threads%4%, %5% errors",
+		shaders.size(), jobs.size(), threadCount, glslang.empty() ? " (reflection only, not compiled)" : "",
+		errorCount) << std::endl;
+	return errorCount == 0 ? 0 : 1;
+}
+
+
+int main(int argc, char* argv[])
+{
+	//Debug::Init();
+	//Debug::setColorMode(false);
+	LogInfo("Compiling...");
+
+#if FISHENGINE_PLATFORM_WINDOWS
 	std::string path = R"(D:\program\github\FishEngine\Example\UnityChan-crs\Assets\UnityChanStage\Effects\Shaders\Light Beam.shader)";
 	ShaderCompiler::setShaderIncludeDir(R"(D:\program\github\FishEngine\Engine\Shaders\include)");
 #else
@@ -39,7 +287,42 @@ int main(int argc, char* argv[])
 	ShaderCompiler::setShaderIncludeDir("/Users/yushroom/program/FishEngine/Engine/Shaders/include");
 #endif
 
-	
+	// ShaderCompiler --offline [--include dir] [--glslang path | --reflect-only] [--output dir] (shader|directory)...
+	if (argc >= 2 && std::string(argv[1]) == "--offline")
+	{
+		std::vector<Path> inputs;
+		Path glslang = FindGlslang();
+		Path outputDir;
+		bool reflectOnly = false;
+		for (int i = 2; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "--include" && i + 1 < argc)
+				ShaderCompiler::setShaderIncludeDir(argv[++i]);
+			else if (arg == "--glslang" && i + 1 < argc)
+				glslang = argv[++i];
+			else if (arg == "--reflect-only")
+				reflectOnly = true;
+			else if (arg == "--output" && i + 1 < argc)
+				outputDir = argv[++i];
+			else
+				inputs.push_back(arg);
+		}
+		// without glslangValidator only the declarations are checked: a shader that does not compile would pass
+		if (reflectOnly)
+		{
+			glslang.clear();
+		}
+		else if (glslang.empty() || !boost::filesystem::is_regular_file(glslang))
+		{
+			std::cerr << "error: glslangValidator " << (glslang.empty() ? std::string("not found in PATH") :
+				"not found: " + glslang.string()) << ", pass --glslang <path>, or --reflect-only to only reflect "
+				"the shaders" << std::endl;
+			return 2;
+		}
+		return CompileOffline(inputs, glslang, outputDir);
+	}
+
 	if (argc == 2)
 	{
 		path = argv[1];
@@ -51,19 +334,6 @@ int main(int argc, char* argv[])
 //        return 1;
 //    }
 //#endif
-	
-	auto shader = Shader::CreateFromFile(path);
-	if (shader == nullptr)
-		return 1;
 
-	shader->Use();
-	if (shader->IsValid())
-	{
-		LogInfo("OK");
-		return 0;
-	}
-	else
-	{
-		return 1;
-	}
+	return CompileWithGL(path);
 }
@@ -81,6 +81,7 @@ def UpdateFile(out_path, content):
 			f.write(content)
 	else:
 		print("no update", out_path)
+	return need_update
 
 def internal_prepareCMakeList_txt():
 	pass
@@ -109,16 +110,17 @@ def prepareProject(project_path):
 	CMakeLists_txt_tempalte += '\n'.join(['SET(HEADERS ${{HEADERS}} "{0}")'.format(h) for h in headers])
 	CMakeLists_txt_tempalte += '\n'.join(['SET(SRCS ${{SRCS}} {0})\n'.format(c) for c in sources])
 	CMakeLists_txt_tempalte += CMakeLists_txt_tempalte_str2
-	UpdateFile( os.path.join(project_path, 'CMakeLists.txt'), CMakeLists_txt_tempalte)
+	cmakelists_updated = UpdateFile( os.path.join(project_path, 'CMakeLists.txt'), CMakeLists_txt_tempalte)
 
 	# prepare project.gererate.cpp
 	project_generate_cpp_content = project_generate_cpp_template.render(headers=headers, classNames=classNames)
 	UpdateFile( os.path.join(project_path, 'project.generate.cpp'), project_generate_cpp_content )
+	return cmakelists_updated
 
 
 def buildProject(project_path, build_type, cmake_path):
 	print(os.getcwd())
-	prepareProject( project_path )
+	cmakelists_updated = prepareProject( project_path )
 
 	build_path = os.path.join( project_path, 'build' )
 	if not os.path.exists(build_path):
@@ -127,11 +129,17 @@ def buildProject(project_path, build_type, cmake_path):
 		generator = 'Xcode'
 		separator = '&&'
 	else:
-		gererator = 'Visual Studio 14 Win64'
+		generator = 'Visual Studio 14 Win64'
 		separator = '&'
-	cmd = 'cd {build_path} {separator} {cmake} --warn-uninitialized --warn-ununsed-vars -G "{generator}" ..'.format(build_path=build_path, separator=separator, cmake=cmake_path, generator=generator)
-	print(cmd)
-	result = os.system(cmd)
+	# the build tree is kept between builds, only the changed sources are recompiled.
+	# the project is generated again only if the list of sources changed
+	if cmakelists_updated or not os.path.exists(os.path.join(build_path, 'CMakeCache.txt')):
+		cmd = 'cd {build_path} {separator} {cmake} --warn-uninitialized --warn-ununsed-vars -G "{generator}" ..'.format(build_path=build_path, separator=separator, cmake=cmake_path, generator=generator)
+		print(cmd)
+		result = os.system(cmd)
+		if result != 0:
+			print('cmake failed')
+			return result
 	log_file_path = build_path + '/../build.log'
 	cmd = '{cmake} --build {build_path} --config {build_type} > {log_file_path}'
 	cmd = cmd.format(cmake=cmake_path, build_path=build_path, build_type=build_type, log_file_path=log_file_path)